@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Read only memory mapping of files on disk
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "MappedFile.h"
+
+#include "Asserts.h"
+
+#include <cstdint>
+
+#if _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile() noexcept
+    : mpData(nullptr)
+    , mSize(0)
+    #if _WIN32
+        , mFileHandle(nullptr)
+        , mMappingHandle(nullptr)
+    #endif
+{
+}
+
+MappedFile::~MappedFile() noexcept {
+    close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Maps the specified file into memory, closing any previously mapped file.
+// Returns 'false' on failure, which includes the file being empty (which can't be mapped).
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool MappedFile::open(const char* const filePath) noexcept {
+    ASSERT(filePath);
+    close();
+
+    #if _WIN32
+        const HANDLE fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (fileHandle == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize = {};
+
+        if ((!GetFileSizeEx(fileHandle, &fileSize)) || (fileSize.QuadPart <= 0) || ((uint64_t) fileSize.QuadPart > SIZE_MAX)) {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        const HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (!mappingHandle) {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        const void* const pData = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+        if (!pData) {
+            CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        mFileHandle = fileHandle;
+        mMappingHandle = mappingHandle;
+        mpData = (const std::byte*) pData;
+        mSize = (size_t) fileSize.QuadPart;
+    #else
+        const int fileDesc = ::open(filePath, O_RDONLY);
+
+        if (fileDesc < 0)
+            return false;
+
+        // Note: the mapping remains valid after the file descriptor is closed
+        struct stat fileStat = {};
+        const bool bStatOk = ((fstat(fileDesc, &fileStat) == 0) && (fileStat.st_size > 0) && ((uint64_t) fileStat.st_size <= SIZE_MAX));
+        void* const pData = (bStatOk) ? mmap(nullptr, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDesc, 0) : MAP_FAILED;
+        ::close(fileDesc);
+
+        if (pData == MAP_FAILED)
+            return false;
+
+        mpData = (const std::byte*) pData;
+        mSize = (size_t) fileStat.st_size;
+    #endif
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Unmaps the currently mapped file, if any
+//------------------------------------------------------------------------------------------------------------------------------------------
+void MappedFile::close() noexcept {
+    #if _WIN32
+        if (mpData) {
+            UnmapViewOfFile(mpData);
+        }
+
+        if (mMappingHandle) {
+            CloseHandle(mMappingHandle);
+        }
+
+        if (mFileHandle) {
+            CloseHandle(mFileHandle);
+        }
+
+        mFileHandle = nullptr;
+        mMappingHandle = nullptr;
+    #else
+        if (mpData) {
+            munmap((void*) mpData, mSize);
+        }
+    #endif
+
+    mpData = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstddef>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A read only memory mapping of a file on disk.
+// Pages of the file are only read in by the OS as they are accessed, so large files can be used without reading them in full up front.
+//------------------------------------------------------------------------------------------------------------------------------------------
+class MappedFile {
+public:
+    MappedFile() noexcept;
+    ~MappedFile() noexcept;
+
+    bool open(const char* const filePath) noexcept;
+    void close() noexcept;
+
+    inline bool isOpen() const noexcept { return (mpData != nullptr); }
+    inline const std::byte* getData() const noexcept { return mpData; }
+    inline size_t getSize() const noexcept { return mSize; }
+
+private:
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator = (const MappedFile& other) = delete;
+
+    const std::byte*    mpData;         // Start of the mapped file data, or 'nullptr' if no file is mapped
+    size_t              mSize;          // Size of the mapped file data
+
+    #if _WIN32
+        void*           mFileHandle;    // Windows handles for the file and the file mapping object
+        void*           mMappingHandle;
+    #endif
+};
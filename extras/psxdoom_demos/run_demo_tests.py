@@ -4,11 +4,16 @@
 #
 # Usage:
 #   python run_demo_tests.py <demoset|all> <psydoom_path> <demos_dir>
+#   python run_demo_tests.py <demoset|all> <psydoomsim_path> <demos_dir> --sim <num_threads>
+#
+# With '--sim' each demo set is run as a single batch by the 'PsyDoomSim' demo simulator on the given number of threads, which also plays
+# the batch again on a single thread and checks that every demo ends in exactly the same state.
 ############################################################################################################################################
 import multiprocessing
 import os
 import subprocess
 import sys
+import tempfile
 import time
 
 # These are the lists of demo sets and expected result files
@@ -98,11 +103,42 @@ def run_demo(psydoom_path, cue_file_path, demos_dir, demo_and_result):
         print("[TEST FAIL] Unexpected demo result!: {0:s}".format(demo_path))
         sys.exit(1)
 
+# This function runs all the demos in a demo set as a single multithreaded batch in the demo simulator.
+# Returns 'True' if all demos matched their expected results and ended in the same state as when played on a single thread.
+def run_demoset_in_sim(psydoomsim_path, cue_file_path, demos_dir, demoset, num_threads):
+    # Make the list of demos and their expected results for the batch
+    with tempfile.NamedTemporaryFile(mode="w", suffix=".txt", delete=False) as list_file:
+        for demo_and_result in demoset["tests"]:
+            demo_path = os.path.join(demos_dir, demo_and_result[0])
+            result_path = os.path.join(demos_dir, demo_and_result[1])
+            list_file.write("{0:s}|{1:s}\n".format(demo_path, result_path))
+
+    # Run the batch and show the simulator's report.
+    # The simulator will return '0' if all the demos were successful.
+    try:
+        result = subprocess.call(
+            [psydoomsim_path, "-cue", cue_file_path, "-batchdemos", list_file.name, "-threads", str(num_threads), "-checkserial"],
+            shell=False
+        )
+    finally:
+        os.remove(list_file.name)
+
+    if result != 0:
+        print("[TEST FAIL] Unexpected demo results or mismatches with serial playback for: {0:s}".format(cue_file_path))
+
+    return result == 0
+
 # High level script logic
 def main():
     # Verify program args
-    if len(sys.argv) != 4:
+    sim_threads = 0
+
+    if len(sys.argv) == 6 and sys.argv[4] == "--sim":
+        sim_threads = int(sys.argv[5])
+
+    if len(sys.argv) != 4 and sim_threads <= 0:
         print("Usage: python run_demo_tests.py <demoset|all> <psydoom_path> <demos_dir>")
+        print("       python run_demo_tests.py <demoset|all> <psydoomsim_path> <demos_dir> --sim <num_threads>")
         sys.exit(1)
 
     psydoom_path = sys.argv[2]
@@ -127,6 +163,11 @@ def main():
     jobs = []
 
     for demoset in run_demosets:
+        if sim_threads > 0:
+            if not run_demoset_in_sim(psydoom_path, demoset["cue_file"], demos_dir, demoset, sim_threads):
+                all_tests_passed = False
+            continue
+
         for demo_and_result in demoset["tests"]:
             job = multiprocessing.Process(
                 target=run_demo,
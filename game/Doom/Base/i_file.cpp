@@ -1,11 +1,12 @@
 #include "i_file.h"
 
 #include "i_main.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "SmallString.h"
 
 static constexpr int32_t MAX_OPEN_FILES = 4;
 
-static PsxCd_File gOpenPsxCdFiles[MAX_OPEN_FILES];
+static SIM_TLS PsxCd_File gOpenPsxCdFiles[MAX_OPEN_FILES];
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Initializes the open file records for the game.
@@ -14,14 +14,19 @@
 #include "i_texcache.h"
 #include "PsyDoom/Controls.h"
 #include "PsyDoom/DemoPlayer.h"
+#include "PsyDoom/FrameScheduler.h"
 #include "PsyDoom/Game.h"
 #include "PsyDoom/Input.h"
 #include "PsyDoom/MapHash.h"
+#include "PsyDoom/NetRelayClient.h"
+#include "PsyDoom/NetRollback.h"
 #include "PsyDoom/Network.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/PsxPadButtons.h"
 #include "PsyDoom/PsxVm.h"
+#include "PsyDoom/StateHash.h"
 #include "PsyDoom/Utils.h"
 #include "PsyDoom/Video.h"
 #include "PsyDoom/Vulkan/VDrawing.h"
@@ -41,12 +46,14 @@
 // Used for measuring the total vblanks elapsed since app start
 #if PSYDOOM_MODS
     static std::chrono::steady_clock::time_point gAppStartTime;
+
+    static std::chrono::steady_clock::time_point I_GetVBlankDeadline(const int32_t vblankIdx) noexcept;
 #endif
 
 // Video vblank timers: track the total amount, last total and current elapsed amount
-uint32_t gTotalVBlanks;
-uint32_t gLastTotalVBlanks;
-uint32_t gElapsedVBlanks;
+SIM_TLS uint32_t gTotalVBlanks;
+SIM_TLS uint32_t gLastTotalVBlanks;
+SIM_TLS uint32_t gElapsedVBlanks;
 
 // The index of the currently displaying framebuffer, 0 or 1
 uint32_t gCurDispBufferIdx;
@@ -62,12 +69,12 @@ DRAWENV gDrawEnvs[2];
 uint32_t gNumFramesDrawn;
 
 // The index of the user's player in the array of players: whether you are player 1 or 2 in other words
-int32_t gCurPlayerIndex;
+SIM_TLS int32_t gCurPlayerIndex;
 
 // Original PSX Doom: this player's control bindings.
 // This is only used for playback of original PSX Doom demos now, to translate PSX buttons into a 'TickInputs' structure.
 // PsyDoom has it's own more flexible configuration system that supercedes this mechanism. 
-padbuttons_t gCtrlBindings[NUM_CTRL_BINDS] = {
+SIM_TLS padbuttons_t gCtrlBindings[NUM_CTRL_BINDS] = {
     PAD_TRIANGLE | PSX_MOUSE_LEFT,
     PAD_CIRCLE,
     PAD_CROSS | PSX_MOUSE_RIGHT,
@@ -82,7 +89,7 @@ padbuttons_t gCtrlBindings[NUM_CTRL_BINDS] = {
 
 // Original PSX Doom: mouse sensitivity.
 // This is only used for playback of original PSX Doom demos now.
-int32_t gPsxMouseSensitivity = 50;
+SIM_TLS int32_t gPsxMouseSensitivity = 50;
 
 // Bit masks for each of the bindable buttons
 const padbuttons_t gBtnMasks[NUM_BINDABLE_BTNS] = {
@@ -100,7 +107,7 @@ const padbuttons_t gBtnMasks[NUM_BINDABLE_BTNS] = {
 
 // The main UI texture atlas for the game.
 // This is loaded into the 1st available texture page and kept loaded at all times after that.
-texture_t gTex_STATUS;
+SIM_TLS texture_t gTex_STATUS;
 
 // Loading, connecting, error etc. plaques
 texture_t gTex_PAUSE;
@@ -111,10 +118,10 @@ texture_t gTex_CONNECT;
 // PsyDoom: the temporary buffer can now be resized to any size.
 // Start off with a plentiful 1 MiB however...
 #if PSYDOOM_LIMIT_REMOVING
-    ResizableBuffer gTmpBuffer(1024 * 1024);
+    SIM_TLS ResizableBuffer gTmpBuffer(1024 * 1024);
 #else
     // A 64-KiB buffer used for WAD loading and other stuff
-    std::byte gTmpBuffer[TMP_BUFFER_SIZE];
+    SIM_TLS std::byte gTmpBuffer[TMP_BUFFER_SIZE];
 #endif
 
 #if PSYDOOM_MODS
@@ -123,7 +130,7 @@ texture_t gTex_CONNECT;
 
     // The current network protocol version.
     // Should be incremented whenever the data format being transmitted changes, or when updates might cause differences in game behavior.
-    static constexpr int32_t NET_PROTOCOL_VERSION = 29;
+    static constexpr int32_t NET_PROTOCOL_VERSION = 34;
 
     // Previous game error checking value when we last sent to the other player.
     // Have to store this because we always send 1 packet ahead for the next frame.
@@ -528,6 +535,10 @@ void I_IncDrawnFrameCount() noexcept {
 // Also does framerate limiting to 30 Hz and updates the elapsed vblank count, which feeds the game's timing system.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void I_DrawPresent() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("I_DrawPresent");
+    #endif
+
     // Finish up all in-flight drawing commands
     LIBGPU_DrawSync(0);
 
@@ -592,10 +603,11 @@ void I_DrawPresent() noexcept {
         if (gElapsedVBlanks >= 2)
             break;
 
-        // PsyDoom: do platform updates (sound, window etc.) and yield some cpu since we are waiting for a bit
+        // PsyDoom: do platform updates (sound, window etc.) and idle until the vblank we are waiting on, since we are waiting for a bit.
+        // Note that the frame scheduler sleeps for most of the wait, rather than spinning and pinning a CPU core at 100% usage.
         #if PSYDOOM_MODS
             Utils::doPlatformUpdates();
-            Utils::threadYield();
+            FrameScheduler::idleUntil(I_GetVBlankDeadline(gLastTotalVBlanks + 2));
         #endif
     }
 
@@ -604,10 +616,10 @@ void I_DrawPresent() noexcept {
     // Probably done so the simulation remains consistent!
     if (Game::gSettings.bUseDemoTimings) {
         while (gElapsedVBlanks < (uint32_t) demoTickVBlanks) {
-            // PsyDoom: do platform updates (sound, window etc.) and yield some cpu since we are waiting for a bit
+            // PsyDoom: do platform updates (sound, window etc.) and idle until the vblank we are waiting on, since we are waiting for a bit
             #if PSYDOOM_MODS
                 Utils::doPlatformUpdates();
-                Utils::threadYield();
+                FrameScheduler::idleUntil(I_GetVBlankDeadline(gLastTotalVBlanks + demoTickVBlanks));
             #endif
 
             // PsyDoom: use 'I_GetTotalVBlanks' because it can adjust time in networked games
@@ -623,6 +635,12 @@ void I_DrawPresent() noexcept {
         gElapsedVBlanks = demoTickVBlanks;
     }
 
+    // PsyDoom: record how late the tic deadline was met by for frame scheduler stats
+    #if PSYDOOM_MODS
+        const int32_t deadlineVBlanks = (Game::gSettings.bUseDemoTimings) ? demoTickVBlanks : 2;
+        FrameScheduler::onTicDeadline(I_GetVBlankDeadline(gLastTotalVBlanks + deadlineVBlanks), PlayerPrefs::gbUncapFramerate);
+    #endif
+
     // So we can compute the elapsed vblank amount next time round
     gLastTotalVBlanks = gTotalVBlanks;
 }
@@ -679,22 +697,26 @@ void I_NetSetup() noexcept {
     gNetPrevErrorCheck = {};
     gNetTimeAdjustMs = 0;
     gLastInputPacketDelayMs = 0;
-    gbNetIsGameBeingRecorded = ProgArgs::gbRecordDemos;
+    gbNetIsGameBeingRecorded = (ProgArgs::gbRecordDemos || NetRelayClient::isTapConnected());
 
     // Fill in the connect output packet; note that player 1 decides the game params, so theese are zeroed for player 2:
     NetPacket_Connect outPkt = {};
     outPkt.protocolVersion = NET_PROTOCOL_VERSION;
     outPkt.gameId = Game::gConstants.netGameId;
-    outPkt.bIsDemoRecording = ProgArgs::gbRecordDemos;
+    outPkt.bIsDemoRecording = (ProgArgs::gbRecordDemos || NetRelayClient::isTapConnected());
 
     if (gCurPlayerIndex == 0) {
         outPkt.startGameType = gStartGameType;
         outPkt.startGameSkill = gStartSkill;
         outPkt.startMap = (int16_t) gStartMapOrEpisode;
+        outPkt.bUseUdpTransport = ProgArgs::gbNetUseUdp;
+        outPkt.bUseRollback = ProgArgs::gbNetRollback;
     } else {
         outPkt.startGameType = {};
         outPkt.startGameSkill = {};
         outPkt.startMap = {};
+        outPkt.bUseUdpTransport = {};
+        outPkt.bUseRollback = {};
     }
 
     // Endian correct the output packet and send
@@ -747,6 +769,18 @@ void I_NetSetup() noexcept {
         Game::gSettings = settings;
     }
 
+    // Switch tick packets over to the UDP transport if the server wants to use that
+    const bool bUseUdpTransport = (gCurPlayerIndex == 0) ? ProgArgs::gbNetUseUdp : inPkt.bUseUdpTransport;
+
+    if (bUseUdpTransport) {
+        Network::enableUdpTransport();
+    }
+
+    // Use rollback netcode if the server wants to, unless the game is being demo recorded (demos record lockstep inputs).
+    // Note: both players know whether each other are demo recording, so they always agree on this.
+    const bool bUseRollback = (gCurPlayerIndex == 0) ? ProgArgs::gbNetRollback : inPkt.bUseRollback;
+    NetRollback::init(bUseRollback && (!gbNetIsGameBeingRecorded));
+
     // One last check to see if the network connection was killed.
     // This will happen if an error occurred, and if this is the case then we should abort the connection attempt:
     if (!Network::isConnected()) {
@@ -763,6 +797,58 @@ void I_NetSetup() noexcept {
     Network::requestTickPackets();
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom helper: shows the 'network error' message after a network update fails and resets the inputs for the other player.
+// This was originally inline logic in 'I_NetUpdate' but is now shared with the rollback netcode.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void I_NetShowErrorAndReset() noexcept {
+    // Uses the current image as the basis for the next frame; copy the presented framebuffer to the drawing framebuffer:
+    LIBGPU_DrawSync(0);
+    LIBGPU_MoveImage(
+        gDispEnvs[gCurDispBufferIdx].disp,
+        gDispEnvs[gCurDispBufferIdx ^ 1].disp.x,
+        gDispEnvs[gCurDispBufferIdx ^ 1].disp.y
+    );
+
+    // Show the 'Network error' plaque
+    #if PSYDOOM_MODS
+        Utils::onBeginUIDrawing();  // PsyDoom: UI drawing setup for the new Vulkan renderer
+    #endif
+
+    I_IncDrawnFrameCount();
+    I_CacheTex(gTex_NETERR);
+    I_DrawSprite(
+        gTex_NETERR.texPageId,
+        Game::getTexPalette_NETERR(),
+        84,
+        109,
+        gTex_NETERR.texPageCoordX,
+        gTex_NETERR.texPageCoordY,
+        gTex_NETERR.width,
+        gTex_NETERR.height
+    );
+
+    I_SubmitGpuCmds();
+    I_DrawPresent();
+
+    // Try and do a sync handshake between the players
+    I_NetHandshake();
+
+    // Clear all inputs
+    for (int32_t i = 1; i < MAXPLAYERS; ++i) {
+        gTickInputs[i] = {};
+        gOldTickInputs[i] = {};
+    }
+
+    gNextTickInputs = {};
+    gNextPlayerElapsedVBlanks = 0;
+
+    // PsyDoom: wait for 2 seconds so the network error can be displayed.
+    // When done clear the screen so the 'loading' message displays clearly and not overlapped with the 'network error' message:
+    Utils::waitForSeconds(2.0f);
+    I_DrawPresent();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Sends the packet for the current frame in a networked game and receives the packet from the other player.
 // Also does error checking, to make sure that the connection is still OK.
@@ -781,20 +867,23 @@ bool I_NetUpdate() noexcept {
         return (!DemoPlayer::readTickInputs());
     }
 
-    // Compute the value used for error checking.
+    // If using rollback netcode then that takes care of everything, apart from showing the network error message
+    if (NetRollback::isActive()) {
+        if (!NetRollback::update())
+            return false;
+
+        I_NetShowErrorAndReset();
+        return true;
+    }
+
+    // Compute the value used for error checking: a hash of the game state (covering all map objects, players and so on).
     // Only do this while we are in the level however...
     const bool bInGame = gbIsLevelDataCached;
     uint32_t errorCheck = 0;
 
     if (bInGame) {
-        for (int32_t i = 0; i < MAXPLAYERS; ++i) {
-            mobj_t& mobj = *gPlayers[i].mo;
-            errorCheck ^= mobj.x;
-            errorCheck ^= mobj.y;
-            errorCheck ^= mobj.z;
-            errorCheck ^= mobj.angle;
-            errorCheck ^= (uint32_t) MapHash::gWord1;   // Check both players are playing the same map
-        }
+        errorCheck = StateHash::compute().combined();
+        errorCheck ^= (uint32_t) MapHash::gWord1;   // Check both players are playing the same map
     }
 
     // If it's the very first network update for this session send a dummy packet with no inputs to the other player.
@@ -874,53 +963,7 @@ bool I_NetUpdate() noexcept {
     );
 
     if (bNetworkError) {
-        // Uses the current image as the basis for the next frame; copy the presented framebuffer to the drawing framebuffer:
-        LIBGPU_DrawSync(0);
-        LIBGPU_MoveImage(
-            gDispEnvs[gCurDispBufferIdx].disp,
-            gDispEnvs[gCurDispBufferIdx ^ 1].disp.x,
-            gDispEnvs[gCurDispBufferIdx ^ 1].disp.y
-        );
-
-        // Show the 'Network error' plaque
-        #if PSYDOOM_MODS
-            Utils::onBeginUIDrawing();  // PsyDoom: UI drawing setup for the new Vulkan renderer
-        #endif
-
-        I_IncDrawnFrameCount();
-        I_CacheTex(gTex_NETERR);
-        I_DrawSprite(
-            gTex_NETERR.texPageId,
-            Game::getTexPalette_NETERR(),
-            84,
-            109,
-            gTex_NETERR.texPageCoordX,
-            gTex_NETERR.texPageCoordY,
-            gTex_NETERR.width,
-            gTex_NETERR.height
-        );
-
-        I_SubmitGpuCmds();
-        I_DrawPresent();
-
-        // Try and do a sync handshake between the players
-        I_NetHandshake();
-
-        // Clear all inputs
-        for (int32_t i = 1; i < MAXPLAYERS; ++i) {
-            gTickInputs[i] = {};
-            gOldTickInputs[i] = {};
-        }
-
-        gNextTickInputs = {};
-        gNextPlayerElapsedVBlanks = 0;
-
-        // PsyDoom: wait for 2 seconds so the network error can be displayed.
-        // When done clear the screen so the 'loading' message displays clearly and not overlapped with the 'network error' message:
-        Utils::waitForSeconds(2.0f);
-        I_DrawPresent();
-
-        // There was a network error!
+        I_NetShowErrorAndReset();
         return true;
     }
 
@@ -949,7 +992,7 @@ bool I_NetUpdate() noexcept {
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Used to do a synchronization handshake between the two players over the serial cable.
-// Now does nothing since the underlying transport protocol (TCP) guarantees reliability and packet ordering.
+// Now does nothing since the underlying transport guarantees reliability and packet ordering (TCP, or UDP with acknowledgements and resends).
 // PsyDoom: this function has been rewritten, for the original version see the 'Old' folder.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void I_NetHandshake() noexcept {}
@@ -1001,4 +1044,13 @@ time_point_t I_GetVBlankTimepoint(const int32_t vblankIdx) noexcept {
         return gAppStartTime + std::chrono::nanoseconds((int64_t)((double) vblankIdx * nanosPerVblank));
     }
 }
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: gets the absolute time at which 'I_GetTotalVBlanks' will reach the specified vblank count.
+// Unlike 'I_GetVBlankTimepoint' this takes into account the current time adjustment in networked games.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static time_point_t I_GetVBlankDeadline(const int32_t vblankIdx) noexcept {
+    const duration_t netTimeAdjust = std::chrono::milliseconds((gNetGame != gt_single) ? gNetTimeAdjustMs : 0);
+    return I_GetVBlankTimepoint(vblankIdx) - netTimeAdjust;
+}
 #endif  // #if PSYDOOM_MODS
@@ -2,6 +2,7 @@
 
 #include "Doom/doomdef.h"
 #include "PsyDoom/ResizableBuffer.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "PsyQ/LIBGPU.h"
 
 #include <cstddef>
@@ -58,28 +59,28 @@ enum : int32_t {
 // Certain bits correspond to certain buttons on the PSX digital controller.
 typedef uint32_t padbuttons_t;
 
-extern uint32_t             gTotalVBlanks;
-extern uint32_t             gLastTotalVBlanks;
-extern uint32_t             gElapsedVBlanks;
-extern uint32_t             gCurDispBufferIdx;
-extern DISPENV              gDispEnvs[2];
-extern DRAWENV              gDrawEnvs[2];
-extern uint32_t             gNumFramesDrawn;
-extern int32_t              gCurPlayerIndex;
-extern padbuttons_t         gCtrlBindings[NUM_CTRL_BINDS];
-extern int32_t              gPsxMouseSensitivity;
-extern const padbuttons_t   gBtnMasks[NUM_BINDABLE_BTNS];
-extern texture_t            gTex_STATUS;
-extern texture_t            gTex_PAUSE;
-extern texture_t            gTex_LOADING;
-extern texture_t            gTex_NETERR;
-extern texture_t            gTex_CONNECT;
+extern SIM_TLS uint32_t             gTotalVBlanks;
+extern SIM_TLS uint32_t             gLastTotalVBlanks;
+extern SIM_TLS uint32_t             gElapsedVBlanks;
+extern uint32_t                     gCurDispBufferIdx;
+extern DISPENV                      gDispEnvs[2];
+extern DRAWENV                      gDrawEnvs[2];
+extern uint32_t                     gNumFramesDrawn;
+extern SIM_TLS int32_t              gCurPlayerIndex;
+extern SIM_TLS padbuttons_t         gCtrlBindings[NUM_CTRL_BINDS];
+extern SIM_TLS int32_t              gPsxMouseSensitivity;
+extern const padbuttons_t           gBtnMasks[NUM_BINDABLE_BTNS];
+extern SIM_TLS texture_t            gTex_STATUS;
+extern texture_t                    gTex_PAUSE;
+extern texture_t                    gTex_LOADING;
+extern texture_t                    gTex_NETERR;
+extern texture_t                    gTex_CONNECT;
 
 // PsyDoom: the temporary buffer can now be resized to any size
 #if PSYDOOM_LIMIT_REMOVING
-    extern ResizableBuffer gTmpBuffer;
+    extern SIM_TLS ResizableBuffer gTmpBuffer;
 #else
-    extern std::byte gTmpBuffer[TMP_BUFFER_SIZE];
+    extern SIM_TLS std::byte gTmpBuffer[TMP_BUFFER_SIZE];
 #endif
 
 // PsyDoom: networking related globals
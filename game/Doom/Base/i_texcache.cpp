@@ -55,6 +55,7 @@
 #include "i_drawcmds.h"
 #include "i_main.h"
 #include "PsyDoom/Config/Config.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/PsxVm.h"
 #include "PsyDoom/TexturePatcher.h"
 #include "PsyDoom/Video.h"
@@ -376,6 +377,10 @@ static texdata_t TC_CacheTexData(const texture_t& tex) {
 // The texture is uploaded to the specified page at the current fill location.
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void TC_UploadTexToVram(texture_t& tex, const texdata_t& texData, const tcachepage_t& texPage) {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("TC_UploadTexToVram");
+    #endif
+
     // How big is the texture data expected to be from the dimensions?
     // If the data stream is too small then do not upload and issue a warning.
     // 
@@ -435,6 +440,11 @@ static void TC_UploadTexToVram(texture_t& tex, const texdata_t& texData, const t
     // Get and save the texture page id.
     // Note that format '1' = '8 bpp (indexed)' and that transparency bits are added later during rendering.
     tex.texPageId = LIBGPU_GetTPage(1, 0, texPage.vramX, texPage.vramY);
+
+    // PsyDoom: the texture has new pixels in VRAM, so will need to be decoded again if using the Vulkan renderer's texture atlas
+    #if PSYDOOM_VULKAN_RENDERER
+        tex.bIsInVkTexAtlas = false;
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -604,6 +614,10 @@ void I_RemoveTexCacheEntry(texture_t& tex) noexcept {
     tex.texPageId = 0;
     tex.bIsCached = false;
     tex.ppTexCacheEntries = nullptr;
+
+    #if PSYDOOM_VULKAN_RENDERER
+        tex.bIsInVkTexAtlas = false;
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
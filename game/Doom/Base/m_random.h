@@ -1,10 +1,12 @@
 #pragma once
 
+#include "PsyDoom/Sim/SimTls.h"
+
 #include <cstdint>
 
 extern const uint8_t    gRndTable[256];
-extern uint32_t         gPRndIndex;
-extern uint32_t         gMRndIndex;
+extern SIM_TLS uint32_t gPRndIndex;
+extern SIM_TLS uint32_t gMRndIndex;
 
 int32_t P_Random() noexcept;
 int32_t P_SubRandom() noexcept;
@@ -10,13 +10,18 @@
 #include "i_main.h"
 #include "m_fixed.h"
 #include "PsyDoom/Config/Config.h"
+#include "PsyDoom/DemoPlayer.h"
 #include "PsyDoom/DiscInfo.h"
 #include "PsyDoom/Game.h"
 #include "PsyDoom/IsoFileSys.h"
+#include "PsyDoom/LcdCache.h"
 #include "PsyDoom/MapInfo/MapInfo.h"
 #include "PsyDoom/ModMgr.h"
+#include "PsyDoom/NetRollback.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/PsxVm.h"
+#include "PsyDoom/SeqAudioThread.h"
 #include "PsyDoom/Utils.h"
 #include "sounds.h"
 #include "Wess/lcdload.h"
@@ -31,6 +36,7 @@
 #include "Wess/wessarc.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <memory>
@@ -128,6 +134,13 @@ static bool gbDidLoadDoomSfxLcd;
 // Used to save the state of voices when pausing
 static SavedVoiceList gPausedMusVoiceState;
 
+// PsyDoom: how long the last load of map sound and music took, and how many of the LCD files it loaded were already in host RAM
+#if PSYDOOM_MODS
+    float       gSoundLoadUsec;
+    uint32_t    gSoundLoadNumLcds;
+    uint32_t    gSoundLoadNumCachedLcds;
+#endif
+
 // Unused tick count for how many sound 'updates' ticks were done.
 // PsyDoom: don't need this - remove.
 #if !PSYDOOM_MODS
@@ -229,6 +242,65 @@ CdFileId S_GetSoundLcdFileId(const int32_t num) noexcept {
     return lcdFileName;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom helper: returns the id of the LCD file containing the sound effects (i.e enemy sounds) for the given map number, or the finale.
+// Returns an empty file id if there is no such LCD file.
+//
+// Note that if 'ALLMAPS.LCD' is present in the user data dir (and we are not doing the finale) then that is returned instead with the
+// expectation that it will contain all enemy sounds in the game. We can just blank load everything and provide a master LCD with all
+// enemy sounds because of PsyDoom's greatly expanded sound RAM.
+//------------------------------------------------------------------------------------------------------------------------------------------
+CdFileId S_GetMapSoundLcdFileId(const int32_t mapNum) noexcept {
+    const bool bIsFinale = (mapNum > Game::getNumMaps());
+
+    if ((!bIsFinale) && (mapNum > 0) && ModMgr::areOverridesAvailableForFile("ALLMAPS.LCD"))
+        return "ALLMAPS.LCD";
+
+    if (bIsFinale) {
+        // Use the finale LCD, which is normally 'MAP60.LCD' for both Doom and Final Doom. This can now be flexibly specified in MAPINFO.
+        // N.B: need to use the 'gGameMap' field at this point to lookup the cluster because the map number passed in for the finale is NOT valid
+        const MapInfo::Map* const pGameEndMap = MapInfo::getMap(gGameMap);
+        const MapInfo::Cluster* const pCluster = (pGameEndMap) ? MapInfo::getCluster(pGameEndMap->cluster) : nullptr;
+        return (pCluster) ? pCluster->castLcdFile : CdFileId{};
+    }
+
+    return (mapNum > 0) ? S_GetSoundLcdFileId(mapNum) : CdFileId{};     // Normal map LCD
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: starts reading the LCD files needed by the given map number (or the finale) into host RAM in the background.
+// Called ahead of time (during the intermission) so that 'S_LoadMapSoundAndMusic' can just copy the sounds into SPU RAM.
+// Note: music sequences are small and are still loaded when the map sound and music is loaded.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void S_PreloadMapSoundAndMusic(const int32_t mapNum) noexcept {
+    if (ProgArgs::gbHeadlessMode || (gLoadedSoundAndMusMapNum == mapNum))
+        return;
+
+    // The main Doom SFX LCD, if it will need to be reloaded
+    const bool bIsFinale = (mapNum == Game::getNumMaps() + 1);
+
+    if ((!bIsFinale) && (!gbDidLoadDoomSfxLcd)) {
+        LcdCache::preload(CdFile::DOOMSFX_LCD);
+    }
+
+    // The music instruments LCD, if playing a music sequence
+    const MapInfo::Map* const pMap = MapInfo::getMap(mapNum);
+    const int32_t mapMusicTrack = (pMap) ? pMap->music : 0;
+    const bool bPlayCdMusic = (pMap) ? pMap->bPlayCdMusic : false;
+    const MapInfo::MusicTrack* const pMusicTrack = MapInfo::getMusicTrack(mapMusicTrack);
+
+    if (pMusicTrack && (pMusicTrack->sequenceNum != 0) && (!bPlayCdMusic)) {
+        LcdCache::preload(S_GetMusicLcdFileId(mapMusicTrack));
+    }
+
+    // The map sound effects LCD
+    const CdFileId mapSoundLcdFileId = S_GetMapSoundLcdFileId(mapNum);
+
+    if (mapSoundLcdFileId != CdFileId{}) {
+        LcdCache::preload(mapSoundLcdFileId);
+    }
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Stop the currently playing music track.
 // PsyDoom: this function has been rewritten. For the original version see the 'Old' folder.
@@ -297,6 +369,10 @@ void S_UnloadSampleBlock(SampleBlock& sampleBlock) noexcept {
 // PsyDoom: this function has been rewritten. For the original version see the 'Old' folder.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void S_LoadMapSoundAndMusic(const int32_t mapNum) noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("S_LoadMapSoundAndMusic");
+    #endif
+
     // PsyDoom: ignore this command in headless mode
     if (ProgArgs::gbHeadlessMode)
         return;
@@ -305,6 +381,15 @@ void S_LoadMapSoundAndMusic(const int32_t mapNum) noexcept {
     if (gLoadedSoundAndMusMapNum == mapNum)
         return;
 
+    // PsyDoom: if the sequencer is running on the audio thread then hand it back to this thread while loading.
+    // Also time how long the load takes and note how many LCD files were already in host RAM.
+    #if PSYDOOM_MODS
+        SeqAudioThread::SuspendScope suspendAudioThreadSeq;
+
+        const auto loadStartTime = std::chrono::steady_clock::now();
+        const LcdCache::Stats lcdStatsBefore = LcdCache::getStats();
+    #endif
+
     // Stop current map music, free all music sequences and unload map SFX
     if (gLoadedSoundAndMusMapNum != 0) {
         if (gCurMusicSeqIdx != 0) {
@@ -390,42 +475,35 @@ void S_LoadMapSoundAndMusic(const int32_t mapNum) noexcept {
     // Load the sound LCD file for the map (if we are on one).
     // Note that if we are doing the finale then load LCD number max(60, numMaps) because Final Doom still uses '60' for the finale LCD.
     //
-    // PsyDoom: if 'ALLMAPS.LCD' is present in the user data dir (and we are not doing the finale) then load that instead with the expectation
-    // that it will contain all enemy sounds in the game. We can just blank load everything and provide a master LCD with all enemy sounds
-    // because of PsyDoom's greatly expanded sound RAM.
+    // PsyDoom: which LCD file to load is now decided by 'S_GetMapSoundLcdFileId', which also handles the finale and 'ALLMAPS.LCD'.
+    // It's shared with the logic that preloads the sound for the next map.
     #if PSYDOOM_MODS
-        bool bLoadedMapSounds = false;
-
-        if ((!bIsFinale) && (mapNum > 0) && ModMgr::areOverridesAvailableForFile("ALLMAPS.LCD")) {
-            destSpuAddr += wess_dig_lcd_load("ALLMAPS.LCD", destSpuAddr, &gMapSndBlock, false);
-            bLoadedMapSounds = true;
-        }
+        const CdFileId mapSoundLcdFileId = S_GetMapSoundLcdFileId(mapNum);
     #else
-        constexpr bool bLoadedMapSounds = false;
-    #endif
-
-    if (!bLoadedMapSounds) {
         CdFileId mapSoundLcdFileId = {};
 
         if (mapNum > Game::getNumMaps()) {
-            // Load the finale LCD, which is normally 'MAP60.LCD' for both Doom and Final Doom.
-            // PsyDoom: this can now be flexibly specified in MAPINFO.
-            #if PSYDOOM_MODS
-                // N.B: need to use the 'gGameMap' field at this point to lookup the cluster because the map number passed in for the finale is NOT valid
-                const MapInfo::Map* const pGameEndMap = MapInfo::getMap(gGameMap);
-                const MapInfo::Cluster* const pCluster = (pGameEndMap) ? MapInfo::getCluster(pGameEndMap->cluster) : nullptr;
-                mapSoundLcdFileId = (pCluster) ? pCluster->castLcdFile : CdFileId{};
-            #else
-                mapSoundLcdFileId = S_GetSoundLcdFileId(std::max(60, Game::getNumMaps() + 1));
-            #endif
+            mapSoundLcdFileId = S_GetSoundLcdFileId(std::max(60, Game::getNumMaps() + 1));  // Finale LCD
         } else if (mapNum > 0) {
             mapSoundLcdFileId = S_GetSoundLcdFileId(mapNum);    // Normal map LCD
         }
+    #endif
 
-        if (mapSoundLcdFileId != CdFileId{}) {
-            wess_dig_lcd_load(mapSoundLcdFileId, destSpuAddr, &gMapSndBlock, false);
-        }
+    if (mapSoundLcdFileId != CdFileId{}) {
+        wess_dig_lcd_load(mapSoundLcdFileId, destSpuAddr, &gMapSndBlock, false);
     }
+
+    // PsyDoom: record the timing and cache stats for the load
+    #if PSYDOOM_MODS
+        const LcdCache::Stats lcdStatsAfter = LcdCache::getStats();
+        const uint32_t numCachedLcds = lcdStatsAfter.numHits - lcdStatsBefore.numHits;
+        const uint32_t numWaitedLcds = lcdStatsAfter.numWaits - lcdStatsBefore.numWaits;
+        const uint32_t numMissedLcds = lcdStatsAfter.numMisses - lcdStatsBefore.numMisses;
+
+        gSoundLoadUsec = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - loadStartTime).count();
+        gSoundLoadNumLcds = numCachedLcds + numWaitedLcds + numMissedLcds;
+        gSoundLoadNumCachedLcds = numCachedLcds;
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -488,8 +566,8 @@ static void I_StartSound(const queued_sound_t& sound) noexcept {
 // Queuing allows us to de-duplicate the same sound playing on the same frame multiple times.
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void I_QueueSound(mobj_t* const pOrigin, const sfxenum_t soundId) noexcept {
-    // Ignore this command in headless mode
-    if (ProgArgs::gbHeadlessMode)
+    // Ignore this command in headless mode, while fast forwarding demo playback or while re-simulating frames for rollback netcode
+    if (ProgArgs::gbHeadlessMode || DemoPlayer::isFastForwarding() || NetRollback::isResimulating())
         return;
 
     // Ignore the request if the sound sequence number is invalid
@@ -677,6 +755,10 @@ void S_StartSound(mobj_t* const pOrigin, const sfxenum_t soundId) noexcept {
 // PsyDoom: it now has a purpose, playing previously queued sounds!
 //------------------------------------------------------------------------------------------------------------------------------------------
 void S_UpdateSounds() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("S_UpdateSounds");
+    #endif
+
     // PsyDoom: removed this tick counter as it was not needed
     #if !PSYDOOM_MODS
         gNumSoundTics++;
@@ -705,6 +787,11 @@ void PsxSoundInit(const int32_t sfxVol, const int32_t musVol, void* const pTmpWm
         S_DetermineCDAudioTrackNumbers();
     #endif
 
+    // PsyDoom: if the sequencer is running on the audio thread then hand it back to this thread while initializing
+    #if PSYDOOM_MODS
+        SeqAudioThread::SuspendScope suspendAudioThreadSeq;
+    #endif
+
     // Initialize the WESS API and low level CDROM utilities
     wess_init();
     psxcd_init();
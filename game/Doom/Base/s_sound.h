@@ -43,6 +43,12 @@ extern uint32_t gCDTrackNum[NUM_CD_MUSIC_TRACKS];
 
 extern int32_t gCdMusicVol;
 
+#if PSYDOOM_MODS
+    extern float        gSoundLoadUsec;
+    extern uint32_t     gSoundLoadNumLcds;
+    extern uint32_t     gSoundLoadNumCachedLcds;
+#endif
+
 int32_t doomToWessVol(const int32_t doomVol) noexcept;
 int32_t doomToPsxSpuVol(const int32_t doomVol) noexcept;
 
@@ -52,6 +58,8 @@ void S_SetMusicVolume(const int32_t musVol) noexcept;
 #if PSYDOOM_MODS
     CdFileId S_GetMusicLcdFileId(const int32_t trackNum) noexcept;
     CdFileId S_GetSoundLcdFileId(const int32_t num) noexcept;
+    CdFileId S_GetMapSoundLcdFileId(const int32_t mapNum) noexcept;
+    void S_PreloadMapSoundAndMusic(const int32_t mapNum) noexcept;
 #endif
 
 void S_StopMusic() noexcept;
@@ -15,15 +15,15 @@
 // A flag set to true once data for the current map has been loaded.
 // Has very little purpose anymore in PsyDoom; was originally used to ensure the game was not loading resources on-the-fly off the CD-ROM.
 // In PsyDoom however on-the-fly resource loading is allowed, so this flag's purpose is diminished.
-bool gbIsLevelDataCached;
+SIM_TLS bool gbIsLevelDataCached;
 
 // A list of WAD files that are used to source all data for the game, except for map data which is found in individual map WAD files.
 // At a minimum this will contain just 'PSXDOOM.WAD' but may also include other user WADs.
-static WadList gMainWadList;
+static SIM_TLS WadList gMainWadList;
 
 // The currently open map WAD.
 // This is only used to load level data, and nothing else.
-static WadFile gMapWad;
+static SIM_TLS WadFile gMapWad;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Initializes the WAD file management system.
@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------------------------------------------------------------------
 #if PSYDOOM_MODS
 
+#include "PsyDoom/Sim/SimTls.h"
 #include "PsyDoom/WadUtils.h"
 
 // PsyDoom: 'CdFileId' has changed in format
@@ -18,7 +19,7 @@
 
 class WadFile;
 
-extern bool gbIsLevelDataCached;
+extern SIM_TLS bool gbIsLevelDataCached;
 
 void W_Init() noexcept;
 void W_Shutdown() noexcept;
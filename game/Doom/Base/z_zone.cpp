@@ -15,10 +15,10 @@ static constexpr int32_t MINFRAGMENT = 64;
 static constexpr size_t MEMZONE_HEADER_SIZE = offsetof(memzone_t, blocklist);
 
 // PsyDoom: the entire heap memory used by the game
-static std::unique_ptr<std::byte[]> gZoneHeap;
+static SIM_TLS std::unique_ptr<std::byte[]> gZoneHeap;
 
 // The main (and only) memory zone used by PSX DOOM
-memzone_t* gpMainMemZone;
+SIM_TLS memzone_t* gpMainMemZone;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Initializes the zone memory management system. DOOM doesn't use any PsyQ SDK allocation functions AT ALL (either directly or indirectly)
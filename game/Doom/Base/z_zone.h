@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PsyDoom/Sim/SimTls.h"
+
 #include <cstdint>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -36,7 +38,7 @@ struct memzone_t {
     memblock_t      blocklist;      // Start / end cap for linked list
 };
 
-extern memzone_t* gpMainMemZone;
+extern SIM_TLS memzone_t* gpMainMemZone;
 
 void Z_Init() noexcept;
 memzone_t* Z_InitZone(void* const pBase, const int32_t size) noexcept;
@@ -31,6 +31,8 @@
 #include "PsyDoom/Game.h"
 #include "PsyDoom/Input.h"
 #include "PsyDoom/MapInfo/MapInfo.h"
+#include "PsyDoom/NetRelayClient.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/SaveAndLoad.h"
 #include "PsyDoom/Utils.h"
@@ -38,60 +40,64 @@
 
 // Helper global holding the result of executing a gameloop via 'MiniLoop'.
 // Sometimes this is used in preference to the return action, and sometimes it is used temporarily to hold the return action.
-gameaction_t gGameAction;
+SIM_TLS gameaction_t gGameAction;
 
 // The current skill level. game type, game map, and the next/upcoming map
-skill_t     gGameSkill;
-gametype_t  gNetGame;
-int32_t     gGameMap;
-int32_t     gNextMap;
+SIM_TLS skill_t     gGameSkill;
+SIM_TLS gametype_t  gNetGame;
+SIM_TLS int32_t     gGameMap;
+SIM_TLS int32_t     gNextMap;
 
 // State for each player and whether they are in the game
-player_t gPlayers[MAXPLAYERS];
-bool gbPlayerInGame[MAXPLAYERS];
+SIM_TLS player_t gPlayers[MAXPLAYERS];
+SIM_TLS bool gbPlayerInGame[MAXPLAYERS];
 
 // Current and previous game tick count (15 Hz ticks)
-int32_t gGameTic;
-int32_t gPrevGameTic;
+SIM_TLS int32_t gGameTic;
+SIM_TLS int32_t gPrevGameTic;
 
 // The last tick count we wanted to be at (15 Hz ticks).
 // On the PSX if the game was running slow, then we might not have reached this amount.
-int32_t gLastTgtGameTicCount;
+SIM_TLS int32_t gLastTgtGameTicCount;
 
 // Player stats
-int32_t gTotalKills;
-int32_t gTotalItems;
-int32_t gTotalSecret;
+SIM_TLS int32_t gTotalKills;
+SIM_TLS int32_t gTotalItems;
+SIM_TLS int32_t gTotalSecret;
 
 // Are we playing back or recording a demo?
-bool gbDemoPlayback;
-bool gbDemoRecording;
+SIM_TLS bool gbDemoPlayback;
+SIM_TLS bool gbDemoRecording;
 
 // Is the level being restarted?
-bool gbIsLevelBeingRestarted;
+SIM_TLS bool gbIsLevelBeingRestarted;
 
 #if PSYDOOM_MODS
     // PsyDoom: whether to auto-save on starting the next level.
     // Set to true after the player successfully completes the previous level.
-    bool gbAutoSaveOnLevelStart;
+    SIM_TLS bool gbAutoSaveOnLevelStart;
 
     // PsyDoom: external camera for cutscenes showing doors opening etc.
     // How many tics it has left, the camera position and angle.
-    uint32_t    gExtCameraTicsLeft;
-    fixed_t     gExtCameraX;
-    fixed_t     gExtCameraY;
-    fixed_t     gExtCameraZ;
-    angle_t     gExtCameraAngle;
+    SIM_TLS uint32_t    gExtCameraTicsLeft;
+    SIM_TLS fixed_t     gExtCameraX;
+    SIM_TLS fixed_t     gExtCameraY;
+    SIM_TLS fixed_t     gExtCameraZ;
+    SIM_TLS angle_t     gExtCameraAngle;
 #endif
 
 // An empty map object initially assigned to players during network game setup, for net consistency checks.
 // This is all zeroed out initially.
-static mobj_t gEmptyMobj;
+static SIM_TLS mobj_t gEmptyMobj;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Displays a loading message then loads the current map
 //------------------------------------------------------------------------------------------------------------------------------------------
 void G_DoLoadLevel() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("G_DoLoadLevel");
+    #endif
+
     // Draw the loading plaque
     I_DrawLoadingPlaque(gTex_LOADING, 95, 109, Game::getTexPalette_LOADING());
 
@@ -549,10 +555,10 @@ void G_RunGame() noexcept {
 
         #if PSYDOOM_MODS
             if (gGameAction != ga_restart) {
-                if (ProgArgs::gbRecordDemos && (!bLoadedSaveGame)) {
+                if ((ProgArgs::gbRecordDemos || NetRelayClient::isTapConnected()) && (!bLoadedSaveGame)) {
                     DemoRecorder::begin();
                     gbDemoRecording = true;
-                    gStatusBar.message = "Recording started";
+                    gStatusBar.message = (ProgArgs::gbRecordDemos) ? "Recording started" : "Streaming started";
                     gStatusBar.messageTicsLeft = 30;
                 }
 
@@ -638,6 +644,18 @@ void G_RunGame() noexcept {
         // It can be inhibited if mapinfo says so, but only for the finale:
         gbIntermissionHideNextMap = (bDoFinale && pCluster && pCluster->bHideNextMapForFinale);
 
+        // PsyDoom: start reading the sound for whatever comes after the intermission in the background, so it's ready by the time it's needed.
+        // This is either the next map or the finale with the cast call (which has it's own sounds).
+        const bool bGoToNextMap = ((!bDoFinale) || (gNetGame == gt_deathmatch));
+
+        if (bGoToNextMap) {
+            if (bNextMapExists) {
+                S_PreloadMapSoundAndMusic(gNextMap);
+            }
+        } else if (pCluster && (!pCluster->bSkipFinale) && pCluster->bEnableCast) {
+            S_PreloadMapSoundAndMusic(Game::getNumMaps() + 1);
+        }
+
         // Do the intermission
         MiniLoop(IN_Start, IN_Stop, IN_Ticker, IN_Drawer);
 
@@ -1,31 +1,32 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
-extern gameaction_t     gGameAction;
-extern skill_t          gGameSkill;
-extern gametype_t       gNetGame;
-extern int32_t          gGameMap;
-extern int32_t          gNextMap;
-extern player_t         gPlayers[MAXPLAYERS];
-extern bool             gbPlayerInGame[MAXPLAYERS];
-extern int32_t          gGameTic;
-extern int32_t          gPrevGameTic;
-extern int32_t          gLastTgtGameTicCount;
-extern int32_t          gTotalKills;
-extern int32_t          gTotalItems;
-extern int32_t          gTotalSecret;
-extern bool             gbDemoPlayback;
-extern bool             gbDemoRecording;
-extern bool             gbIsLevelBeingRestarted;
+extern SIM_TLS gameaction_t     gGameAction;
+extern SIM_TLS skill_t          gGameSkill;
+extern SIM_TLS gametype_t       gNetGame;
+extern SIM_TLS int32_t          gGameMap;
+extern SIM_TLS int32_t          gNextMap;
+extern SIM_TLS player_t         gPlayers[MAXPLAYERS];
+extern SIM_TLS bool             gbPlayerInGame[MAXPLAYERS];
+extern SIM_TLS int32_t          gGameTic;
+extern SIM_TLS int32_t          gPrevGameTic;
+extern SIM_TLS int32_t          gLastTgtGameTicCount;
+extern SIM_TLS int32_t          gTotalKills;
+extern SIM_TLS int32_t          gTotalItems;
+extern SIM_TLS int32_t          gTotalSecret;
+extern SIM_TLS bool             gbDemoPlayback;
+extern SIM_TLS bool             gbDemoRecording;
+extern SIM_TLS bool             gbIsLevelBeingRestarted;
 
 #if PSYDOOM_MODS
-    extern bool         gbAutoSaveOnLevelStart;
-    extern uint32_t     gExtCameraTicsLeft;
-    extern fixed_t      gExtCameraX;
-    extern fixed_t      gExtCameraY;
-    extern fixed_t      gExtCameraZ;
-    extern angle_t      gExtCameraAngle;
+    extern SIM_TLS bool         gbAutoSaveOnLevelStart;
+    extern SIM_TLS uint32_t     gExtCameraTicsLeft;
+    extern SIM_TLS fixed_t      gExtCameraX;
+    extern SIM_TLS fixed_t      gExtCameraY;
+    extern SIM_TLS fixed_t      gExtCameraZ;
+    extern SIM_TLS angle_t      gExtCameraAngle;
 #endif
 
 void G_DoLoadLevel() noexcept;
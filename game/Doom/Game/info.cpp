@@ -4979,8 +4979,8 @@ const mobjinfo_t gBaseMobjInfo[BASE_NUM_MOBJ_TYPES] = {
 
 // Note: these are populated in 'p_info.cpp'
 #if PSYDOOM_MODS
-    state_t*        gStates;
-    int32_t         gNumStates;
-    mobjinfo_t*     gMobjInfo;
-    int32_t         gNumMobjInfo;
+    SIM_TLS state_t*        gStates;
+    SIM_TLS int32_t         gNumStates;
+    SIM_TLS mobjinfo_t*     gMobjInfo;
+    SIM_TLS int32_t         gNumMobjInfo;
 #endif
@@ -6,6 +6,7 @@
 // On PC this would be the same data that you would edit via 'DeHackEd' patches.
 //------------------------------------------------------------------------------------------------------------------------------------------
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "SmallString.h"
 
 #include <cstddef>
@@ -1432,10 +1433,10 @@ extern const state_t        gBaseStates[BASE_NUM_STATES];
 extern const mobjinfo_t     gBaseMobjInfo[BASE_NUM_MOBJ_TYPES];
 
 #if PSYDOOM_MODS
-    extern state_t*     gStates;
-    extern int32_t      gNumStates;
-    extern mobjinfo_t*  gMobjInfo;
-    extern int32_t      gNumMobjInfo;
+    extern SIM_TLS state_t*     gStates;
+    extern SIM_TLS int32_t      gNumStates;
+    extern SIM_TLS mobjinfo_t*  gMobjInfo;
+    extern SIM_TLS int32_t      gNumMobjInfo;
 #else
     #define gSprNames   gBaseSprNames
     #define gStates     gBaseStates
@@ -11,6 +11,7 @@
 #include "Doom/Renderer/r_main.h"
 #include "doomdata.h"
 #include "info.h"
+#include "p_blockthings.h"
 #include "p_enemy.h"
 #include "p_local.h"
 #include "p_maputl.h"
@@ -18,23 +19,25 @@
 #include "p_setup.h"
 #include "p_tick.h"
 #include "PsyDoom/Config/Config.h"
+#include "PsyDoom/Profiler.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <algorithm>
 
 static constexpr fixed_t STOPSPEED  = 0x1000;   // Speed under which to stop a thing fully
 static constexpr fixed_t FRICTION   = 0xD200;   // Friction amount to apply (note: 0xD240 in Jaguar Doom)
 
-static mobj_t*          gpBaseThing;        // The current thing that is doing collision testing against other stuff: used by various functions in the module
-static fixed_t          gTestX;             // The thing position to use for collision testing - X
-static fixed_t          gTestY;             // The thing position to use for collision testing - Y
-static fixed_t          gTestBBox[4];       // Bounding box for various collision tests
-static uint32_t         gTestFlags;         // Used in place of 'mobj_t' flags for various functions in this module
-static subsector_t*     gpTestSubSec;       // Current cached thing subsector: input and output for some functions in this module
-static mobj_t*          gpHitThing;         // The thing that was collided against during collision testing
-static line_t*          gpCeilingLine;      // Collision testing: the line for the lowest ceiling edge the collider is in contact with
-static fixed_t          gTestCeilingz;      // Collision testing: the Z value for the lowest ceiling the collider is in contact with
-static fixed_t          gTestFloorZ;        // Collision testing: the Z value for the highest floor the collider is in contact with
-static fixed_t          gTestDropoffZ;      // Collision testing: the Z value for the lowest floor the collider is in contact with. Used by monsters so they don't walk off cliffs.
+static SIM_TLS mobj_t*          gpBaseThing;        // The current thing that is doing collision testing against other stuff: used by various functions in the module
+static SIM_TLS fixed_t          gTestX;             // The thing position to use for collision testing - X
+static SIM_TLS fixed_t          gTestY;             // The thing position to use for collision testing - Y
+static SIM_TLS fixed_t          gTestBBox[4];       // Bounding box for various collision tests
+static SIM_TLS uint32_t         gTestFlags;         // Used in place of 'mobj_t' flags for various functions in this module
+static SIM_TLS subsector_t*     gpTestSubSec;       // Current cached thing subsector: input and output for some functions in this module
+static SIM_TLS mobj_t*          gpHitThing;         // The thing that was collided against during collision testing
+static SIM_TLS line_t*          gpCeilingLine;      // Collision testing: the line for the lowest ceiling edge the collider is in contact with
+static SIM_TLS fixed_t          gTestCeilingz;      // Collision testing: the Z value for the lowest ceiling the collider is in contact with
+static SIM_TLS fixed_t          gTestFloorZ;        // Collision testing: the Z value for the highest floor the collider is in contact with
+static SIM_TLS fixed_t          gTestDropoffZ;      // Collision testing: the Z value for the lowest floor the collider is in contact with. Used by monsters so they don't walk off cliffs.
 
 // Not required externally: making private to this module
 static bool PB_TryMove(const fixed_t tryX, const fixed_t tryY) noexcept;
@@ -48,6 +51,10 @@ static bool PB_BlockThingsIterator(const int32_t x, const int32_t y) noexcept;
 // Does movement and state ticking for all map objects except players
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_RunMobjBase() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_RunMobjBase");
+    #endif
+
     gpBaseThing = gMobjHead.next;
 
     // Run through all the map objects
@@ -386,6 +393,11 @@ static void PB_UnsetThingPosition(mobj_t& thing) noexcept {
 
     // Remove the thing from the blockmap, if it is added to the blockmap
     if ((gTestFlags & MF_NOBLOCKMAP) == 0) {
+        // PsyDoom: keep the compact arrays of things for each blockmap cell up to date
+        #if PSYDOOM_MODS
+            P_BlockThingsUnsetPosition(thing);
+        #endif
+
         if (thing.bnext) {
             thing.bnext->bprev = thing.bprev;
         }
@@ -440,7 +452,12 @@ static void PB_SetThingPosition(mobj_t& mobj) noexcept {
         const int32_t bmapY = d_rshift<MAPBLOCKSHIFT>(mobj.y - gBlockmapOriginY);
 
         if ((bmapX >= 0) && (bmapY >= 0) && (bmapX < gBlockmapWidth) && (bmapY < gBlockmapHeight)) {
-            // In range: link the thing into the blockmap list for this blockmap cell
+            // In range: link the thing into the blockmap list for this blockmap cell.
+            // PsyDoom: keep the compact arrays of things for each blockmap cell up to date also.
+            #if PSYDOOM_MODS
+                P_BlockThingsSetPosition(mobj, bmapX + bmapY * gBlockmapWidth);
+            #endif
+
             mobj_t*& blockmapList = gppBlockLinks[bmapX + bmapY * gBlockmapWidth];
             mobj_t* const pPrevListHead = blockmapList;
 
@@ -454,10 +471,20 @@ static void PB_SetThingPosition(mobj_t& mobj) noexcept {
             blockmapList = &mobj;
         } else {
             // Thing is outside the blockmap
+            #if PSYDOOM_MODS
+                P_BlockThingsSetPosition(mobj, -1);
+            #endif
+
             mobj.bprev = nullptr;
             mobj.bnext = nullptr;
         }
     }
+    #if PSYDOOM_MODS
+        else {
+            // PsyDoom: the thing might still be linked into the blockmap from before it's flags changed, keep it's position up to date
+            P_BlockThingsMobjMoved(mobj);
+        }
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -749,14 +776,20 @@ static bool PB_BlockLinesIterator(const int32_t x, const int32_t y) noexcept {
 // Stops when a collision is detected and returns 'false', otherwise returns 'true' for no collision.
 //------------------------------------------------------------------------------------------------------------------------------------------
 static bool PB_BlockThingsIterator(const int32_t x, const int32_t y) noexcept {
-    mobj_t* pmobj = gppBlockLinks[x + y * gBlockmapWidth];
+    // PsyDoom: use the compact arrays of things for each blockmap cell, which allow things that are out of range to be skipped without
+    // touching them. This gives the same results as the linked lists since 'PB_CheckThing' does nothing for things which are out of range.
+    #if PSYDOOM_MODS
+        return P_BlockThingsIterate<true>(x + y * gBlockmapWidth, gTestX, gTestY, gpBaseThing->radius, PB_CheckThing);
+    #else
+        mobj_t* pmobj = gppBlockLinks[x + y * gBlockmapWidth];
 
-    while (pmobj) {
-        if (!PB_CheckThing(*pmobj))
-            return false;
+        while (pmobj) {
+            if (!PB_CheckThing(*pmobj))
+                return false;
 
-        pmobj = pmobj->bnext;
-    }
+            pmobj = pmobj->bnext;
+        }
 
-    return true;
+        return true;
+    #endif
 }
@@ -0,0 +1,277 @@
+#include "p_blockthings.h"
+
+#if PSYDOOM_MODS
+
+#include "p_local.h"
+#include "p_setup.h"
+#include "p_tick.h"
+
+#include <algorithm>
+
+SIM_TLS std::vector<blockthingcell_t> gBlockThingCells;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the blockmap cell that the specified map object was last linked into, or 'nullptr' if it is not linked into any cell
+//------------------------------------------------------------------------------------------------------------------------------------------
+static blockthingcell_t* getLinkedCell(const mobj_t& mobj) noexcept {
+    const uint32_t cellNum = mobj.blockCellNum;
+    ASSERT(cellNum <= gBlockThingCells.size());
+    return (cellNum > 0) ? &gBlockThingCells[cellNum - 1] : nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Marks the specified cell as no longer mirroring its linked list of things; the linked list must be used for it until it is synced again
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void desyncCell(blockthingcell_t* const pCell) noexcept {
+    if (pCell) {
+        pCell->things.clear();
+        pCell->version++;
+        pCell->bInSync = false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Handles an update to the 'bnext' or 'bprev' link of a map object while linking or unlinking a thing in the specified cell.
+// If the map object belongs to a different cell then the update is not something that the arrays can mirror, so both cells go out of sync.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void onLinkUpdated(const mobj_t* const pMobj, blockthingcell_t* const pCell) noexcept {
+    if (!pMobj)
+        return;
+
+    blockthingcell_t* const pMobjCell = getLinkedCell(*pMobj);
+
+    if (pMobjCell != pCell) {
+        desyncCell(pMobjCell);
+        desyncCell(pCell);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Records that the specified map object is no longer linked into the cell it was last linked into
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void clearLinkedCell(mobj_t& mobj) noexcept {
+    blockthingcell_t* const pCell = getLinkedCell(mobj);
+
+    if (pCell) {
+        ASSERT(pCell->numLinked > 0);
+        pCell->numLinked--;
+        mobj.blockCellNum = 0;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes the blockmap thing arrays: should be called on level setup after the blockmap is loaded and before creating map objects
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_InitBlockThings() noexcept {
+    gBlockThingCells.clear();
+    gBlockThingCells.resize((size_t) gBlockmapWidth * (size_t) gBlockmapHeight);
+
+    for (blockthingcell_t& cell : gBlockThingCells) {
+        cell.version = 1;
+        cell.bInSync = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Frees the blockmap thing arrays: should be called on level teardown
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_ShutdownBlockThings() noexcept {
+    gBlockThingCells.clear();
+    gBlockThingCells.shrink_to_fit();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called by all code which links a map object into the blockmap, BEFORE it is linked into the specified cell's list.
+// The cell index should be '-1' if the thing is outside of the blockmap (in which case it's 'bnext' and 'bprev' links are cleared).
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_BlockThingsSetPosition(mobj_t& mobj, const int32_t cellIdx) noexcept {
+    if (gBlockThingCells.empty())
+        return;
+
+    // If the thing is still linked into some cell then it's links are about to be overwritten without it being unlinked first
+    if (mobj.blockCellNum != 0) {
+        desyncCell(getLinkedCell(mobj));
+        clearLinkedCell(mobj);
+    }
+
+    if (cellIdx < 0)
+        return;
+
+    // Link the thing into the cell, also checking that the current list head actually belongs to this cell
+    ASSERT((size_t) cellIdx < gBlockThingCells.size());
+    blockthingcell_t& cell = gBlockThingCells[cellIdx];
+    onLinkUpdated(gppBlockLinks[cellIdx], &cell);
+
+    if (cell.bInSync) {
+        cell.things.push_back({ &mobj, mobj.x, mobj.y, mobj.radius });
+    }
+
+    cell.version++;
+    cell.numLinked++;
+    mobj.blockCellNum = (uint32_t) cellIdx + 1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called by all code which unlinks a map object from the blockmap, BEFORE it is unlinked
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_BlockThingsUnsetPosition(mobj_t& mobj) noexcept {
+    if (gBlockThingCells.empty())
+        return;
+
+    blockthingcell_t* const pCell = getLinkedCell(mobj);
+
+    // Check the neighboring things in the list which will have their links updated
+    onLinkUpdated(mobj.bnext, pCell);
+
+    if (mobj.bprev) {
+        onLinkUpdated(mobj.bprev, pCell);
+    } else {
+        // The thing is (supposedly) the head of a list. Note that the list head to update is determined by the CURRENT position of the thing
+        // which might not match the cell it was linked into, if it was moved without being relinked. If that is the case then the head of
+        // an unrelated list gets overwritten and the head of the thing's actual list is left pointing to the thing.
+        const int32_t blockX = d_rshift<MAPBLOCKSHIFT>(mobj.x - gBlockmapOriginX);
+        const int32_t blockY = d_rshift<MAPBLOCKSHIFT>(mobj.y - gBlockmapOriginY);
+        const bool bHeadInBlockmap = ((blockX >= 0) && (blockY >= 0) && (blockX < gBlockmapWidth) && (blockY < gBlockmapHeight));
+        blockthingcell_t* const pHeadCell = (bHeadInBlockmap) ? &gBlockThingCells[blockY * gBlockmapWidth + blockX] : nullptr;
+
+        if (pHeadCell != pCell) {
+            desyncCell(pHeadCell);
+            desyncCell(pCell);
+        }
+    }
+
+    // Remove the thing from it's cell's array, preserving the order of everything else
+    if (pCell) {
+        if (pCell->bInSync) {
+            const auto thingIter = std::find_if(
+                pCell->things.rbegin(),
+                pCell->things.rend(),
+                [&](const blockthing_t& thing) noexcept { return (thing.pMobj == &mobj); }
+            );
+
+            if (thingIter != pCell->things.rend()) {
+                pCell->things.erase(std::next(thingIter).base());
+            } else {
+                ASSERT_FAIL("Thing not found in the array for it's blockmap cell!");
+                desyncCell(pCell);
+            }
+        }
+
+        pCell->version++;
+        clearLinkedCell(mobj);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called when a map object is about to be freed, after it has been unlinked from the blockmap (if applicable).
+// Handles things which were never unlinked from the blockmap because their flags changed to exclude them from the blockmap.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_BlockThingsRemoveMobj(mobj_t& mobj) noexcept {
+    if (gBlockThingCells.empty() || (mobj.blockCellNum == 0))
+        return;
+
+    desyncCell(getLinkedCell(mobj));
+    clearLinkedCell(mobj);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called whenever the position or radius of a map object is changed WITHOUT unlinking and relinking it in the blockmap
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_BlockThingsMobjMoved(const mobj_t& mobj) noexcept {
+    if (gBlockThingCells.empty())
+        return;
+
+    blockthingcell_t* const pCell = getLinkedCell(mobj);
+
+    if ((!pCell) || (!pCell->bInSync))
+        return;
+
+    for (blockthing_t& thing : pCell->things) {
+        if (thing.pMobj == &mobj) {
+            thing.x = mobj.x;
+            thing.y = mobj.y;
+            thing.radius = mobj.radius;
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tries to bring the array of things for an out of sync blockmap cell back into sync with the cell's linked list of things.
+// This is possible if the list contains exactly the things linked into the cell, with all 'bprev' links consistent with the list order.
+// Returns 'true' if the cell is now in sync.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool P_BlockThingsSyncCell(const int32_t cellIdx) noexcept {
+    ASSERT((cellIdx >= 0) && ((size_t) cellIdx < gBlockThingCells.size()));
+    blockthingcell_t& cell = gBlockThingCells[cellIdx];
+
+    if (cell.bInSync)
+        return true;
+
+    // Don't retry if nothing has changed since the last attempt failed
+    if (cell.failedSyncVersion == cell.version)
+        return false;
+
+    // Gather the things in the list and make sure they all belong to this cell.
+    // Note: limiting the number of things visited to the number linked into the cell also guards against cycles in corrupted lists.
+    const uint32_t cellNum = (uint32_t) cellIdx + 1;
+    uint32_t numThings = 0;
+    mobj_t* pPrevMobj = nullptr;
+    cell.things.clear();
+
+    for (mobj_t* pmobj = gppBlockLinks[cellIdx]; pmobj; pmobj = pmobj->bnext) {
+        const bool bBadThing = ((numThings >= cell.numLinked) || (pmobj->blockCellNum != cellNum) || (pmobj->bprev != pPrevMobj));
+
+        if (bBadThing) {
+            cell.things.clear();
+            cell.failedSyncVersion = cell.version;
+            return false;
+        }
+
+        cell.things.push_back({ pmobj, pmobj->x, pmobj->y, pmobj->radius });
+        pPrevMobj = pmobj;
+        numThings++;
+    }
+
+    // All things linked into the cell must be in the list also
+    if (numThings != cell.numLinked) {
+        cell.things.clear();
+        cell.failedSyncVersion = cell.version;
+        return false;
+    }
+
+    std::reverse(cell.things.begin(), cell.things.end());
+    cell.bInSync = true;
+    return true;
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Rebuilds the arrays of things for all blockmap cells from their linked lists.
+// Must be called after the blockmap thing lists and the 'blockCellNum' of all map objects are set directly, bypassing the functions above
+// (when restoring a snapshot for example). Cells whose linked lists are not well formed are left out of sync.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_BlockThingsRebuild() noexcept {
+    for (blockthingcell_t& cell : gBlockThingCells) {
+        cell.things.clear();
+        cell.version++;
+        cell.numLinked = 0;
+        cell.bInSync = false;
+    }
+
+    for (mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
+        blockthingcell_t* const pCell = getLinkedCell(*pMobj);
+
+        if (pCell) {
+            pCell->numLinked++;
+        }
+    }
+
+    const int32_t numCells = (int32_t) gBlockThingCells.size();
+
+    for (int32_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        P_BlockThingsSyncCell(cellIdx);
+    }
+}
+
+#endif  // #if PSYDOOM_MODS
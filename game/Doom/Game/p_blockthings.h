@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Asserts.h"
+#include "Doom/doomdef.h"
+#include "p_setup.h"
+#include "PsyDoom/Sim/SimTls.h"
+
+#include <cstdlib>
+#include <vector>
+
+#if PSYDOOM_MODS
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: a companion index to the blockmap thing lists ('gppBlockLinks').
+//
+// For each blockmap cell this stores a compact array of the things in the cell along with a copy of their position and radius, so that
+// collision checks can cull things which are out of range without having to touch the things themselves. The arrays are maintained
+// incrementally as things are linked and unlinked from the blockmap, and are iterated in exactly the same order as the linked lists.
+//
+// Every change to a thing's position or radius must be reported via 'P_BlockThingsMobjMoved'. As a safety net the cached values are checked
+// against the thing when iterating however, and the thing's real values are used if they differ.
+//
+// The original linked lists remain the authority on what is in each cell however. Unlinking a thing which is at the head of its list
+// uses the thing's CURRENT position to decide which list head to update, and since things are sometimes moved without being relinked
+// (missiles on spawning for example) this can corrupt the lists in ways that demos rely on. When an update to the lists is detected which
+// the arrays can't mirror, the affected cells are marked as out of sync and their linked lists are used instead. Out of sync cells are
+// re-synced from their linked lists whenever those lists are found to be well formed again.
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+// An entry for a thing in a blockmap cell
+struct blockthing_t {
+    mobj_t*     pMobj;
+    fixed_t     x;
+    fixed_t     y;
+    fixed_t     radius;
+};
+
+// Things in a blockmap cell
+struct blockthingcell_t {
+    std::vector<blockthing_t>   things;             // Things in the cell, in REVERSE linked list order (the list head is last) so that linking a thing is a 'push_back'
+    uint32_t                    version;            // Incremented whenever the things in the cell might have changed
+    uint32_t                    failedSyncVersion;  // The version of the cell when syncing it from the linked list last failed
+    uint32_t                    numLinked;          // The number of things whose 'blockCellNum' refers to this cell
+    bool                        bInSync;            // If 'true' then 'things' exactly mirrors the linked list for the cell
+};
+
+extern SIM_TLS std::vector<blockthingcell_t> gBlockThingCells;
+
+void P_InitBlockThings() noexcept;
+void P_ShutdownBlockThings() noexcept;
+void P_BlockThingsSetPosition(mobj_t& mobj, const int32_t cellIdx) noexcept;
+void P_BlockThingsUnsetPosition(mobj_t& mobj) noexcept;
+void P_BlockThingsRemoveMobj(mobj_t& mobj) noexcept;
+void P_BlockThingsMobjMoved(const mobj_t& mobj) noexcept;
+bool P_BlockThingsSyncCell(const int32_t cellIdx) noexcept;
+void P_BlockThingsRebuild() noexcept;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Calls the given function for all things in the specified blockmap cell, in the same order as the cell's linked list of things.
+// The function can abort iteration by returning 'false', in which case this function also returns 'false'.
+//
+// If 'bCullByDist' is set then things whose bounding box is not within 'testRadius' of ('testX', 'testY') on both axes are skipped.
+// This must only be used if the function would return 'true' for these things WITHOUT any other side effects.
+//
+// The function is allowed to link and unlink things and the results will be the same as iterating the linked list in that case.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <bool bCullByDist, class FuncT>
+inline bool P_BlockThingsIterate(
+    const int32_t cellIdx,
+    const fixed_t testX,
+    const fixed_t testY,
+    const fixed_t testRadius,
+    const FuncT& func
+) noexcept {
+    ASSERT((cellIdx >= 0) && ((size_t) cellIdx < gBlockThingCells.size()));
+    blockthingcell_t& cell = gBlockThingCells[cellIdx];
+
+    // Is a thing with the given position and radius out of range of the test area?
+    const auto isCulled = [=](const fixed_t x, const fixed_t y, const fixed_t radius) noexcept {
+        if constexpr (bCullByDist) {
+            const fixed_t totalRadius = radius + testRadius;
+            return ((std::abs(x - testX) >= totalRadius) || (std::abs(y - testY) >= totalRadius));
+        } else {
+            return false;
+        }
+    };
+
+    // Iterates the linked list of things for the cell, starting at the given thing
+    const auto iterateList = [&](mobj_t* const pStartMobj) noexcept {
+        for (mobj_t* pmobj = pStartMobj; pmobj; pmobj = pmobj->bnext) {
+            if (isCulled(pmobj->x, pmobj->y, pmobj->radius))
+                continue;
+
+            if (!func(*pmobj))
+                return false;
+        }
+
+        return true;
+    };
+
+    // Use the linked list if the cell is out of sync and can't be synced now
+    if ((!cell.bInSync) && (!P_BlockThingsSyncCell(cellIdx)))
+        return iterateList(gppBlockLinks[cellIdx]);
+
+    const uint32_t version = cell.version;
+
+    for (size_t i = cell.things.size(); i > 0;) {
+        --i;
+        blockthing_t& thing = cell.things[i];
+        mobj_t& mobj = *thing.pMobj;
+
+        // If the thing was moved or resized without calling 'P_BlockThingsMobjMoved' then its cached position and radius are out of date.
+        // This is a bug, but don't let it change the outcome of the game in release builds: fix up the cached values so that culling gives
+        // the same result as iterating the linked list would. Note: this reads each thing, but unlike following the linked list each read
+        // does not depend on the one before it.
+        if ((thing.x != mobj.x) || (thing.y != mobj.y) || (thing.radius != mobj.radius)) {
+            ASSERT_FAIL("The blockmap thing array is out of date! A thing was moved without calling 'P_BlockThingsMobjMoved'.");
+            thing.x = mobj.x;
+            thing.y = mobj.y;
+            thing.radius = mobj.radius;
+        }
+
+        if (isCulled(thing.x, thing.y, thing.radius))
+            continue;
+
+        if (!func(mobj))
+            return false;
+
+        // If the function changed the things in this cell then continue on via the linked list, exactly as the original code would
+        if (cell.version != version)
+            return iterateList(mobj.bnext);
+    }
+
+    return true;
+}
+
+#endif  // #if PSYDOOM_MODS
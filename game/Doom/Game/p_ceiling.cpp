@@ -18,9 +18,9 @@ static constexpr fixed_t CEILSPEED = FRACUNIT * 2;
 
 // The list of currently active ceilings (some slots may be empty)
 #if PSYDOOM_LIMIT_REMOVING
-    std::vector<ceiling_t*> gpActiveCeilings;
+    SIM_TLS std::vector<ceiling_t*> gpActiveCeilings;
 #else
-    ceiling_t* gpActiveCeilings[MAXCEILINGS];
+    SIM_TLS ceiling_t* gpActiveCeilings[MAXCEILINGS];
 #endif
 
 // Not required externally: making private to this module
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <vector>
 
@@ -55,10 +56,10 @@ struct ceiling_t {
 };
 
 #if PSYDOOM_LIMIT_REMOVING
-    extern std::vector<ceiling_t*> gpActiveCeilings;
+    extern SIM_TLS std::vector<ceiling_t*> gpActiveCeilings;
 #else
     static constexpr int32_t MAXCEILINGS = 30;          // Maximum number of ceiling movers there can be active at once
-    extern ceiling_t* gpActiveCeilings[MAXCEILINGS];
+    extern SIM_TLS ceiling_t* gpActiveCeilings[MAXCEILINGS];
 #endif
 
 // PsyDoom: definition for a custom ceiling/crusher.
@@ -9,6 +9,7 @@
 #include "Doom/UI/st_main.h"
 #include "g_game.h"
 #include "info.h"
+#include "p_blockthings.h"
 #include "p_inter.h"
 #include "p_map.h"
 #include "p_maputl.h"
@@ -17,12 +18,12 @@
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/Game.h"
 
-bool gbNofit;           // If 'true' then one or more things in the test sector undergoing height changes do not fit
-bool gbCrushChange;     // If 'true' then the current sector undergoing height changes should crush/damage things when they do not fit
+SIM_TLS bool gbNofit;           // If 'true' then one or more things in the test sector undergoing height changes do not fit
+SIM_TLS bool gbCrushChange;     // If 'true' then the current sector undergoing height changes should crush/damage things when they do not fit
 
 #if PSYDOOM_MODS
-    bool gbFloorIsInstantMoving;        // PsyDoom: a flag set if 'T_MovePlane' is moving a floor which instantly reaches its destination (instant floor)
-    bool gbCeilingIsInstantMoving;      // PsyDoom: a flag set if 'T_MovePlane' is moving a ceiling which instantly reaches its destination (instant ceiling)
+    SIM_TLS bool gbFloorIsInstantMoving;        // PsyDoom: a flag set if 'T_MovePlane' is moving a floor which instantly reaches its destination (instant floor)
+    SIM_TLS bool gbCeilingIsInstantMoving;      // PsyDoom: a flag set if 'T_MovePlane' is moving a ceiling which instantly reaches its destination (instant ceiling)
 #endif
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -122,6 +123,10 @@ bool PIT_ChangeSector(mobj_t& mobj) noexcept {
         mobj.height = 0;    // This prevents the height clip test from failing again and triggering more crushing
         mobj.radius = 0;
 
+        #if PSYDOOM_MODS
+            P_BlockThingsMobjMoved(mobj);   // PsyDoom: the radius changed without the thing being relinked in the blockmap
+        #endif
+
         // PsyDoom: fix a bug where gibs become blocking if the monster is crushed during it's death sequence 
         #if PSYDOOM_MODS
             if (Game::gSettings.bFixBlockingGibsBug) {
@@ -1,14 +1,16 @@
 #pragma once
 
+#include "PsyDoom/Sim/SimTls.h"
+
 struct mobj_t;
 struct sector_t;
 
-extern bool gbNofit;
-extern bool gbCrushChange;
+extern SIM_TLS bool gbNofit;
+extern SIM_TLS bool gbCrushChange;
 
 #if PSYDOOM_MODS
-    extern bool gbFloorIsInstantMoving;
-    extern bool gbCeilingIsInstantMoving;
+    extern SIM_TLS bool gbFloorIsInstantMoving;
+    extern SIM_TLS bool gbCeilingIsInstantMoving;
 #endif
 
 bool P_ThingHeightClip(mobj_t& mobj) noexcept;
@@ -10,6 +10,7 @@
 #include "Doom/Renderer/r_main.h"
 #include "g_game.h"
 #include "info.h"
+#include "p_blockthings.h"
 #include "p_doors.h"
 #include "p_floor.h"
 #include "p_inter.h"
@@ -26,6 +27,7 @@
 #include "p_tick.h"
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/Game.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "sprinfo.h"
 
 #include <algorithm>
@@ -63,19 +65,19 @@ constexpr static dirtype_t gDiagonalDirs[4] = {
 // PsyDoom: Arch-vile related globals
 #if PSYDOOM_MODS
     // The origin point from which the Arch-vile searches for nearby corpses: x
-    static fixed_t gVileTryX;
-    static fixed_t gVileTryY;
+    static SIM_TLS fixed_t gVileTryX;
+    static SIM_TLS fixed_t gVileTryY;
 
     // The current corpse found which can be raised by the Arch-vile
-    static mobj_t* gpVileCorpse;
+    static SIM_TLS mobj_t* gpVileCorpse;
 #endif
 
 // PsyDoom: Icon Of Sin related globals
 #if PSYDOOM_MODS
     static constexpr int32_t MAX_BRAIN_TARGETS = 64;        // Note: this is double the PC limit, should be more than enough...
 
-    static mobj_t*  gpBrainTargets[MAX_BRAIN_TARGETS];      // Target points for the Icon Of Sin spawner
-    static int32_t  gNumBrainTargets;                       // How many target points there are for the Icon Of Sin spawner
+    static SIM_TLS mobj_t*  gpBrainTargets[MAX_BRAIN_TARGETS];      // Target points for the Icon Of Sin spawner
+    static SIM_TLS int32_t  gNumBrainTargets;                       // How many target points there are for the Icon Of Sin spawner
 #endif
 
 #if PSYDOOM_MODS
@@ -874,6 +876,7 @@ void A_SkelMissile(mobj_t& actor) noexcept {
 
     #if PSYDOOM_MODS
         R_SnapMobjInterpolation(missile);   // PsyDoom: snap the motion we just added since the missile is just spawning
+        P_BlockThingsMobjMoved(missile);    // PsyDoom: moved without being relinked in the blockmap
     #endif
 }
 
@@ -1643,6 +1646,11 @@ void A_VileAttack(mobj_t& actor) noexcept {
     // Need to snap the flame motion since it's basically teleports around the map
     R_SnapMobjInterpolation(*pFire);
 
+    // PsyDoom: the fire was moved without being relinked in the blockmap
+    #if PSYDOOM_MODS
+        P_BlockThingsMobjMoved(*pFire);
+    #endif
+
     // Do the splash damage at the fire location
     P_RadiusAttack(*pFire, &actor, 70);
 }
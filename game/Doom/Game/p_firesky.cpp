@@ -5,12 +5,13 @@
 #include "Doom/Base/w_wad.h"
 #include "Doom/Renderer/r_data.h"
 #include "doomdata.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 // This wraps x coordinates to 64 px bounds
 static const uint8_t FIRESKY_X_WRAP_MASK = FIRESKY_W - 1;
 
 // This RNG seed is used exclusively for the fire sky
-static uint32_t gFireSkyRndIndex;
+static SIM_TLS uint32_t gFireSkyRndIndex;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Does one update round/iteration of the famous PlayStation Doom 'fire sky' effect.
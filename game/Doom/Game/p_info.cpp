@@ -6,6 +6,7 @@
 #include "Doom/Base/w_wad.h"
 #include "info.h"
 #include "PsyDoom/ParserTokenizer.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "sprinfo.h"
 
 #include <algorithm>
@@ -13,8 +14,8 @@
 #include <string>
 #include <vector>
 
-static std::vector<state_t>     gStateVec;          // All of the states defined by the game
-static std::vector<mobjinfo_t>  gMobjInfoVec;       // All of the map objects defined by the game
+static SIM_TLS std::vector<state_t>     gStateVec;          // All of the states defined by the game
+static SIM_TLS std::vector<mobjinfo_t>  gMobjInfoVec;       // All of the map objects defined by the game
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Checks to see if the specified DoomEd num is in use already
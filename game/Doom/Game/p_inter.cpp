@@ -38,10 +38,10 @@ const int32_t gClipAmmo[NUMAMMO] = {
 };
 
 // Next index in the dead player removal queue to use (this index is wrapped)
-uint32_t gDeadPlayerRemovalQueueIdx;
+SIM_TLS uint32_t gDeadPlayerRemovalQueueIdx;
 
 // A queue of player corpses that eventually get removed from the game when a new corpse uses an occupied queue slot
-mobj_t* gDeadPlayerMobjRemovalQueue[MAX_DEAD_PLAYERS];
+SIM_TLS mobj_t* gDeadPlayerMobjRemovalQueue[MAX_DEAD_PLAYERS];
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Try to give the specified player the specified number of ammo clips of the given type.
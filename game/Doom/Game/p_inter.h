@@ -1,14 +1,15 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 // Maximum number of dead player corpses to leave lying around (deathmatch)
 static constexpr uint32_t MAX_DEAD_PLAYERS = 32;
 
 extern const int32_t    gMaxAmmo[NUMAMMO];
 extern const int32_t    gClipAmmo[NUMAMMO];
-extern uint32_t         gDeadPlayerRemovalQueueIdx;
-extern mobj_t*          gDeadPlayerMobjRemovalQueue[MAX_DEAD_PLAYERS];
+extern SIM_TLS uint32_t gDeadPlayerRemovalQueueIdx;
+extern SIM_TLS mobj_t*  gDeadPlayerMobjRemovalQueue[MAX_DEAD_PLAYERS];
 
 bool P_GiveAmmo(player_t& player, const ammotype_t ammoType, const int32_t numClips) noexcept;
 bool P_GiveWeapon(player_t& player, const weapontype_t weapon, const bool bDropped) noexcept;
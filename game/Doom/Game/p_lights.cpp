@@ -1,5 +1,6 @@
 #include "p_lights.h"
 
+#include "Asserts.h"
 #include "Doom/Base/m_random.h"
 #include "Doom/Base/z_zone.h"
 #include "Doom/Renderer/r_local.h"
@@ -8,6 +9,7 @@
 #include "p_tick.h"
 
 #include <algorithm>
+#include <vector>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Thinker/update logic for a light that flickers like fire
@@ -300,3 +302,220 @@ void P_SpawnGlowingLight(sector_t& sector, const glowtype_e glowType) noexcept {
     // Remove any other sector specials like damage etc.
     sector.special = 0;
 }
+
+#if PSYDOOM_MODS
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: batched updating of light thinkers.
+//
+// Maps with lots of animated lights spend most of their thinker update time on indirect calls and list traversal for what is very simple
+// per-sector math. To speed this up, runs of consecutive light thinkers in the thinker list are gathered into per-type arrays of pointers
+// to the thinkers, which are then updated in loops with direct calls instead of calls through the thinker's function pointer. The light
+// state itself is NOT stored contiguously: it stays in the thinkers, which remain in the thinker list, so saving, loading, rewinding and
+// state hashing are unaffected. The runs are built once and then only extended as thinkers are added to the end of the thinker list; they
+// are only rebuilt from scratch when a light thinker is removed or the whole thinker list is replaced.
+//
+// The results are identical to updating the thinkers one at a time in list order because:
+//  (1) A run never contains more than one light for the same sector, so lights in a run never affect each other's sectors.
+//  (2) Glows and strobes don't use random numbers, and fire flickers and light flashes (which do) are always updated in list order.
+//      This keeps the order of 'P_Random()' calls exactly the same as before, including relative to other thinkers like crushers.
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+// A run of consecutive light thinkers in the thinker list and the range of each light type array that it uses
+struct lightrun_t {
+    thinker_t*  pFirst;
+    thinker_t*  pLast;
+    uint32_t    glowsBeg;
+    uint32_t    glowsEnd;
+    uint32_t    strobesBeg;
+    uint32_t    strobesEnd;
+    uint32_t    randomLightsBeg;
+    uint32_t    randomLightsEnd;
+};
+
+SIM_TLS thinker_t* gpNextLightThinkerRun;     // The first thinker in the next light run to be updated, or 'nullptr' if there are no more runs to update
+
+static SIM_TLS bool                     gbLightThinkerRunsValid;    // If 'false' then the thinker list has changed and the light runs must be rebuilt
+static SIM_TLS thinker_t*               gpFirstUnscannedThinker;    // The first thinker added since the light runs were built or extended (if any)
+static SIM_TLS uint32_t                 gNextLightThinkerRunIdx;    // Index of the next light run to be updated
+static SIM_TLS std::vector<lightrun_t>  gLightThinkerRuns;          // All light runs, in thinker list order
+static SIM_TLS std::vector<glow_t*>     gRunGlows;                  // Glowing lights in all runs
+static SIM_TLS std::vector<strobe_t*>   gRunStrobes;                // Strobe flashes in all runs
+static SIM_TLS std::vector<thinker_t*>  gRunRandomLights;           // Fire flickers and light flashes in all runs, in thinker list order
+static SIM_TLS std::vector<uint32_t>    gSectorLightRunNums;        // For each sector, the number (index + 1) of the light run last found to use the sector
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the sector that a light thinker affects, or 'nullptr' if the thinker is not a light thinker
+//------------------------------------------------------------------------------------------------------------------------------------------
+static sector_t* P_GetLightThinkerSector(thinker_t& thinker) noexcept {
+    if (thinker.function == (think_t) &T_Glow)
+        return ((glow_t&) thinker).sector;
+
+    if (thinker.function == (think_t) &T_StrobeFlash)
+        return ((strobe_t&) thinker).sector;
+
+    if (thinker.function == (think_t) &T_FireFlicker)
+        return ((fireflicker_t&) thinker).sector;
+
+    if (thinker.function == (think_t) &T_LightFlash)
+        return ((lightflash_t&) thinker).sector;
+
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gathers runs of consecutive light thinkers and the per-type arrays of lights for each run, from the given thinker to the end of the list.
+// If the thinker before the starting one ends the last run gathered so far, then that run is continued.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void P_ScanLightThinkerRuns(thinker_t* const pStartThinker) noexcept {
+    lightrun_t* pRun = nullptr;
+
+    if ((!gLightThinkerRuns.empty()) && (gLightThinkerRuns.back().pLast == pStartThinker->prev)) {
+        pRun = &gLightThinkerRuns.back();
+    }
+
+    for (thinker_t* pThinker = pStartThinker; pThinker != &gThinkerCap; pThinker = pThinker->next) {
+        sector_t* const pSector = P_GetLightThinkerSector(*pThinker);
+
+        // Non light thinkers end the current run
+        if (!pSector) {
+            pRun = nullptr;
+            continue;
+        }
+
+        // A light for a sector that is already used by the current run also ends the run, since the order of updates to the sector matters
+        const size_t sectorIdx = (size_t)(pSector - gpSectors);
+        ASSERT(sectorIdx < gSectorLightRunNums.size());
+
+        if (pRun && (gSectorLightRunNums[sectorIdx] == gLightThinkerRuns.size())) {
+            pRun = nullptr;
+        }
+
+        // Start a new run if required and add the light to it
+        if (!pRun) {
+            pRun = &gLightThinkerRuns.emplace_back();
+            pRun->pFirst = pThinker;
+            pRun->glowsBeg = (uint32_t) gRunGlows.size();
+            pRun->strobesBeg = (uint32_t) gRunStrobes.size();
+            pRun->randomLightsBeg = (uint32_t) gRunRandomLights.size();
+        }
+
+        if (pThinker->function == (think_t) &T_Glow) {
+            gRunGlows.push_back((glow_t*) pThinker);
+        } else if (pThinker->function == (think_t) &T_StrobeFlash) {
+            gRunStrobes.push_back((strobe_t*) pThinker);
+        } else {
+            gRunRandomLights.push_back(pThinker);
+        }
+
+        pRun->pLast = pThinker;
+        pRun->glowsEnd = (uint32_t) gRunGlows.size();
+        pRun->strobesEnd = (uint32_t) gRunStrobes.size();
+        pRun->randomLightsEnd = (uint32_t) gRunRandomLights.size();
+        gSectorLightRunNums[sectorIdx] = (uint32_t) gLightThinkerRuns.size();
+    }
+
+    gpFirstUnscannedThinker = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gathers all runs of consecutive light thinkers in the thinker list from scratch
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void P_BuildLightThinkerRuns() noexcept {
+    gLightThinkerRuns.clear();
+    gRunGlows.clear();
+    gRunStrobes.clear();
+    gRunRandomLights.clear();
+    gSectorLightRunNums.clear();
+    gSectorLightRunNums.resize((size_t) gNumSectors);
+
+    P_ScanLightThinkerRuns(gThinkerCap.next);
+    gbLightThinkerRunsValid = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called whenever light thinkers are removed from the thinker list, or when the entire thinker list is reset or replaced.
+// Stops any remaining light runs from being used by the current thinker update, and causes the runs to be rebuilt for the next update.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_InvalidateLightThinkerRuns() noexcept {
+    gbLightThinkerRunsValid = false;
+    gpNextLightThinkerRun = nullptr;
+    gpFirstUnscannedThinker = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called whenever a thinker is added to the end of the thinker list.
+// This does not affect any existing light runs, all of which come before the new thinker: it just needs to be scanned for new runs later.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_OnThinkerAdded(thinker_t& thinker) noexcept {
+    if (gbLightThinkerRunsValid && (!gpFirstUnscannedThinker)) {
+        gpFirstUnscannedThinker = &thinker;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called whenever a thinker is unlinked from the thinker list and freed.
+// Ensures a thinker added and then removed before it could be scanned for new light runs is not referenced afterwards.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_OnThinkerUnlinked(thinker_t& thinker) noexcept {
+    if (gpFirstUnscannedThinker == &thinker) {
+        gpFirstUnscannedThinker = (thinker.next != &gThinkerCap) ? thinker.next : nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called before updating the thinker list: rebuilds the light runs if required and starts updating runs from the first one
+//------------------------------------------------------------------------------------------------------------------------------------------
+void P_BeginLightThinkerRuns() noexcept {
+    if (!gbLightThinkerRunsValid) {
+        P_BuildLightThinkerRuns();
+    } else if (gpFirstUnscannedThinker) {
+        P_ScanLightThinkerRuns(gpFirstUnscannedThinker);
+    }
+
+    gNextLightThinkerRunIdx = 0;
+    gpNextLightThinkerRun = (!gLightThinkerRuns.empty()) ? gLightThinkerRuns[0].pFirst : nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Updates all of the lights in the next light run: should be called when the thinker list update reaches 'gpNextLightThinkerRun'.
+// Returns the last thinker in the run (where the thinker list update should continue on from) and the number of thinkers updated.
+//------------------------------------------------------------------------------------------------------------------------------------------
+thinker_t& P_RunNextLightThinkerRun(int32_t& numThinkersRun) noexcept {
+    ASSERT(gbLightThinkerRunsValid);
+    ASSERT(gNextLightThinkerRunIdx < gLightThinkerRuns.size());
+
+    const lightrun_t& run = gLightThinkerRuns[gNextLightThinkerRunIdx];
+    ASSERT(run.pFirst == gpNextLightThinkerRun);
+
+    // Update the lights which don't use random numbers, one type at a time
+    glow_t* const* const pGlows = gRunGlows.data();
+    strobe_t* const* const pStrobes = gRunStrobes.data();
+    thinker_t* const* const pRandomLights = gRunRandomLights.data();
+
+    for (uint32_t i = run.glowsBeg; i < run.glowsEnd; ++i) {
+        T_Glow(*pGlows[i]);
+    }
+
+    for (uint32_t i = run.strobesBeg; i < run.strobesEnd; ++i) {
+        T_StrobeFlash(*pStrobes[i]);
+    }
+
+    // Update the lights which use random numbers in the same order as the thinker list
+    for (uint32_t i = run.randomLightsBeg; i < run.randomLightsEnd; ++i) {
+        thinker_t& thinker = *pRandomLights[i];
+
+        if (thinker.function == (think_t) &T_FireFlicker) {
+            T_FireFlicker((fireflicker_t&) thinker);
+        } else {
+            ASSERT(thinker.function == (think_t) &T_LightFlash);
+            T_LightFlash((lightflash_t&) thinker);
+        }
+    }
+
+    // Move onto the next run
+    numThinkersRun = (int32_t)((run.glowsEnd - run.glowsBeg) + (run.strobesEnd - run.strobesBeg) + (run.randomLightsEnd - run.randomLightsBeg));
+    gNextLightThinkerRunIdx++;
+    gpNextLightThinkerRun = (gNextLightThinkerRunIdx < gLightThinkerRuns.size()) ? gLightThinkerRuns[gNextLightThinkerRunIdx].pFirst : nullptr;
+    return *run.pLast;
+}
+#endif  // #if PSYDOOM_MODS
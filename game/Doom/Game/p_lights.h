@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct line_t;
 struct sector_t;
@@ -70,3 +71,13 @@ void EV_TurnTagLightsOff(line_t& line) noexcept;
 void EV_LightTurnOn(line_t& line, const int32_t onLightLevel) noexcept;
 void T_Glow(glow_t& glow) noexcept;
 void P_SpawnGlowingLight(sector_t& sector, const glowtype_e glowType) noexcept;
+
+#if PSYDOOM_MODS
+    extern SIM_TLS thinker_t* gpNextLightThinkerRun;
+
+    void P_InvalidateLightThinkerRuns() noexcept;
+    void P_OnThinkerAdded(thinker_t& thinker) noexcept;
+    void P_OnThinkerUnlinked(thinker_t& thinker) noexcept;
+    void P_BeginLightThinkerRuns() noexcept;
+    thinker_t& P_RunNextLightThinkerRun(int32_t& numThinkersRun) noexcept;
+#endif
@@ -21,24 +21,24 @@
 
 #include <algorithm>
 
-mobj_t*     gpShooter;          // The map object currently taking a shot
-fixed_t     gAttackRange;       // Maximum attack range for an attacker
-angle_t     gAttackAngle;       // Angle of attack for an attacker
-fixed_t     gAimTopSlope;       // Maximum Z slope for shooting (defines Z range that stuff can be hit within)
-fixed_t     gAimBottomSlope;    // Minimum Z slope for shooting (defines Z range that stuff can be hit within)
-mobj_t*     gpLineTarget;       // The thing being shot at in 'P_AimLineAttack' and 'P_LineAttack'.
-mobj_t*     gpTryMoveThing;     // Try move: the thing being moved
-fixed_t     gTryMoveX;          // Try move: position we're attempting to move to (X)
-fixed_t     gTryMoveY;          // Try move: position we're attempting to move to (Y)
-bool        gbCheckPosOnly;     // Try move: if 'true' then check if the position is valid to move to only, don't actually move there
-
-static mobj_t*      gpBombSource;       // Radius attacks: the thing responsible for the explosion (player, monster)
-static mobj_t*      gpBombSpot;         // Radius attacks: the object exploding and it's position (barrel, missile etc.)
-static int32_t      gBombDamage;        // Radius attacks: how much damage the explosion does before falloff
-static divline_t    gUseLine;           // The 'use' line being cast from the player towards walls; we try to activate walls that it hits
-static fixed_t      gUseBBox[4];        // The bounding box for the 'use' line being cast from the player
-static line_t*      gpCloseLine;        // The closest wall line currently being used
-static fixed_t      gCloseDist;         // Fractional distance along the use line to the closest wall line being used
+SIM_TLS mobj_t*     gpShooter;          // The map object currently taking a shot
+SIM_TLS fixed_t     gAttackRange;       // Maximum attack range for an attacker
+SIM_TLS angle_t     gAttackAngle;       // Angle of attack for an attacker
+SIM_TLS fixed_t     gAimTopSlope;       // Maximum Z slope for shooting (defines Z range that stuff can be hit within)
+SIM_TLS fixed_t     gAimBottomSlope;    // Minimum Z slope for shooting (defines Z range that stuff can be hit within)
+SIM_TLS mobj_t*     gpLineTarget;       // The thing being shot at in 'P_AimLineAttack' and 'P_LineAttack'.
+SIM_TLS mobj_t*     gpTryMoveThing;     // Try move: the thing being moved
+SIM_TLS fixed_t     gTryMoveX;          // Try move: position we're attempting to move to (X)
+SIM_TLS fixed_t     gTryMoveY;          // Try move: position we're attempting to move to (Y)
+SIM_TLS bool        gbCheckPosOnly;     // Try move: if 'true' then check if the position is valid to move to only, don't actually move there
+
+static SIM_TLS mobj_t*      gpBombSource;       // Radius attacks: the thing responsible for the explosion (player, monster)
+static SIM_TLS mobj_t*      gpBombSpot;         // Radius attacks: the object exploding and it's position (barrel, missile etc.)
+static SIM_TLS int32_t      gBombDamage;        // Radius attacks: how much damage the explosion does before falloff
+static SIM_TLS divline_t    gUseLine;           // The 'use' line being cast from the player towards walls; we try to activate walls that it hits
+static SIM_TLS fixed_t      gUseBBox[4];        // The bounding box for the 'use' line being cast from the player
+static SIM_TLS line_t*      gpCloseLine;        // The closest wall line currently being used
+static SIM_TLS fixed_t      gCloseDist;         // Fractional distance along the use line to the closest wall line being used
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Test if the given x/y position can be moved to for the given map object and return 'true' if the move is allowed
@@ -1,19 +1,20 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct line_t;
 
-extern mobj_t*      gpShooter;
-extern fixed_t      gAttackRange;
-extern angle_t      gAttackAngle;
-extern fixed_t      gAimTopSlope;
-extern fixed_t      gAimBottomSlope;
-extern mobj_t*      gpLineTarget;
-extern mobj_t*      gpTryMoveThing;
-extern fixed_t      gTryMoveX;
-extern fixed_t      gTryMoveY;
-extern bool         gbCheckPosOnly;
+extern SIM_TLS mobj_t*      gpShooter;
+extern SIM_TLS fixed_t      gAttackRange;
+extern SIM_TLS angle_t      gAttackAngle;
+extern SIM_TLS fixed_t      gAimTopSlope;
+extern SIM_TLS fixed_t      gAimBottomSlope;
+extern SIM_TLS mobj_t*      gpLineTarget;
+extern SIM_TLS mobj_t*      gpTryMoveThing;
+extern SIM_TLS fixed_t      gTryMoveX;
+extern SIM_TLS fixed_t      gTryMoveY;
+extern SIM_TLS bool         gbCheckPosOnly;
 
 bool P_CheckPosition(mobj_t& mobj, const fixed_t x, const fixed_t y) noexcept;
 bool P_TryMove(mobj_t& mobj, const fixed_t x, const fixed_t y) noexcept;
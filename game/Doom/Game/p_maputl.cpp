@@ -4,15 +4,16 @@
 #include "Doom/Base/m_fixed.h"
 #include "Doom/Renderer/r_local.h"
 #include "Doom/Renderer/r_main.h"
+#include "p_blockthings.h"
 #include "p_local.h"
 #include "p_setup.h"
 
 #include <algorithm>
 
-fixed_t gOpenBottom;    // Line opening (floor/ceiling gap) info: bottom Z value of the opening
-fixed_t gOpenTop;       // Line opening (floor/ceiling gap) info: top Z value of the opening
-fixed_t gOpenRange;     // Line opening (floor/ceiling gap) info: Z size of the opening
-fixed_t gLowFloor;      // Line opening (floor/ceiling gap) info: the lowest (front/back sector) floor of the opening
+SIM_TLS fixed_t gOpenBottom;    // Line opening (floor/ceiling gap) info: bottom Z value of the opening
+SIM_TLS fixed_t gOpenTop;       // Line opening (floor/ceiling gap) info: top Z value of the opening
+SIM_TLS fixed_t gOpenRange;     // Line opening (floor/ceiling gap) info: Z size of the opening
+SIM_TLS fixed_t gLowFloor;      // Line opening (floor/ceiling gap) info: the lowest (front/back sector) floor of the opening
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Gives a cheap approximate/estimated length for the given vector
@@ -150,6 +151,11 @@ void P_UnsetThingPosition(mobj_t& thing) noexcept {
     // Does this thing get added to the blockmap?
     // If so remove it from the blockmap.
     if ((thing.flags & MF_NOBLOCKMAP) == 0) {
+        // PsyDoom: keep the compact arrays of things for each blockmap cell up to date
+        #if PSYDOOM_MODS
+            P_BlockThingsUnsetPosition(thing);
+        #endif
+
         if (thing.bnext) {
             thing.bnext->bprev = thing.bprev;
         }
@@ -207,6 +213,11 @@ void P_SetThingPosition(mobj_t& mobj) noexcept {
 
         // Make sure the thing is bounds for the blockmap: if not then just don't add it to the blockmap
         if ((blockX >= 0) && (blockY >= 0) && (blockX < gBlockmapWidth) && (blockY < gBlockmapHeight)) {
+            // PsyDoom: keep the compact arrays of things for each blockmap cell up to date
+            #if PSYDOOM_MODS
+                P_BlockThingsSetPosition(mobj, blockY * gBlockmapWidth + blockX);
+            #endif
+
             mobj_t*& blockList = gppBlockLinks[blockY * gBlockmapWidth + blockX];
             mobj.bprev = nullptr;
             mobj.bnext = blockList;
@@ -217,10 +228,20 @@ void P_SetThingPosition(mobj_t& mobj) noexcept {
 
             blockList = &mobj;
         } else {
+            #if PSYDOOM_MODS
+                P_BlockThingsSetPosition(mobj, -1);
+            #endif
+
             mobj.bprev = nullptr;
             mobj.bnext = nullptr;
         }
     }
+    #if PSYDOOM_MODS
+        else {
+            // PsyDoom: the thing might still be linked into the blockmap from before it's flags changed, keep it's position up to date
+            P_BlockThingsMobjMoved(mobj);
+        }
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -268,16 +289,21 @@ bool P_BlockThingsIterator(const int32_t x, const int32_t y, bool (*pFunc)(mobj_
     if ((x < 0) || (y < 0) || (x >= gBlockmapWidth) || (y >= gBlockmapHeight))
         return true;
 
-    // Visit all of the things in this blockmap cell unless the callee asks to quit
-    mobj_t* pmobj = gppBlockLinks[x + y * gBlockmapWidth];
+    // Visit all of the things in this blockmap cell unless the callee asks to quit.
+    // PsyDoom: use the compact arrays of things for each blockmap cell, these give the same results as the linked lists.
+    #if PSYDOOM_MODS
+        return P_BlockThingsIterate<false>(x + y * gBlockmapWidth, 0, 0, 0, pFunc);
+    #else
+        mobj_t* pmobj = gppBlockLinks[x + y * gBlockmapWidth];
 
-    while (pmobj) {
-        // Call the function and stop if requested
-        if (!pFunc(*pmobj))
-            return false;
+        while (pmobj) {
+            // Call the function and stop if requested
+            if (!pFunc(*pmobj))
+                return false;
 
-        pmobj = pmobj->bnext;
-    }
+            pmobj = pmobj->bnext;
+        }
 
-    return true;
+        return true;
+    #endif
 }
@@ -1,15 +1,16 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct divline_t;
 struct line_t;
 struct mobj_t;
 
-extern fixed_t gOpenBottom;
-extern fixed_t gOpenTop;
-extern fixed_t gOpenRange;
-extern fixed_t gLowFloor;
+extern SIM_TLS fixed_t gOpenBottom;
+extern SIM_TLS fixed_t gOpenTop;
+extern SIM_TLS fixed_t gOpenRange;
+extern SIM_TLS fixed_t gLowFloor;
 
 fixed_t P_AproxDistance(const fixed_t dx, const fixed_t dy) noexcept;
 int32_t P_PointOnLineSide(const fixed_t x, const fixed_t y, const line_t& line) noexcept;
@@ -14,6 +14,7 @@
 #include "doomdata.h"
 #include "g_game.h"
 #include "info.h"
+#include "p_blockthings.h"
 #include "p_local.h"
 #include "p_map.h"
 #include "p_maputl.h"
@@ -27,10 +28,10 @@
 #include <algorithm>
 #include <cstdio>
 
-int32_t         gItemRespawnQueueHead;              // Head of the circular queue
-int32_t         gItemRespawnQueueTail;              // Tail of the circular queue
-int32_t         gItemRespawnTime[ITEMQUESIZE];      // When each item in the respawn queue began the wait to respawn
-mapthing_t      gItemRespawnQueue[ITEMQUESIZE];     // Details for the things to be respawned
+SIM_TLS int32_t         gItemRespawnQueueHead;              // Head of the circular queue
+SIM_TLS int32_t         gItemRespawnQueueTail;              // Tail of the circular queue
+SIM_TLS int32_t         gItemRespawnTime[ITEMQUESIZE];      // When each item in the respawn queue began the wait to respawn
+SIM_TLS mapthing_t      gItemRespawnQueue[ITEMQUESIZE];     // Details for the things to be respawned
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Removes the given map object from the game
@@ -65,6 +66,7 @@ void P_RemoveMobj(mobj_t& mobj) noexcept {
     mobj.prev->next = mobj.next;
 
     #if PSYDOOM_MODS
+        P_BlockThingsRemoveMobj(mobj);      // PsyDoom: in case the object was never unlinked from the blockmap due to it's flags changing
         P_WeakReferencedDestroyed(mobj);    // PsyDoom: weak references to this object are now nulled
         mobj.~mobj_t();                     // PsyDoom: destroy C++ weak pointers
     #endif
@@ -591,6 +593,7 @@ void P_CheckMissileSpawn(mobj_t& mobj) noexcept {
 
                 #if PSYDOOM_MODS
                     R_SnapMobjInterpolation(mobj);  // PsyDoom: snap the motion we just added since the missile is just spawning
+                    P_BlockThingsMobjMoved(mobj);   // PsyDoom: moved without being relinked in the blockmap
                 #endif
 
                 P_ExplodeMissile(mobj);
@@ -605,6 +608,10 @@ void P_CheckMissileSpawn(mobj_t& mobj) noexcept {
     mobj.y += d_rshift<1>(mobj.momy);
     mobj.z += d_rshift<1>(mobj.momz);
 
+    #if PSYDOOM_MODS
+        P_BlockThingsMobjMoved(mobj);   // PsyDoom: moved without being relinked in the blockmap
+    #endif
+
     if (!P_TryMove(mobj, mobj.x, mobj.y)) {
         P_ExplodeMissile(mobj);
     }
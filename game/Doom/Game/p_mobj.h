@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 enum statenum_t : int32_t;
 struct mapthing_t;
@@ -9,10 +10,10 @@ struct mapthing_t;
 static constexpr int32_t ITEMQUESIZE = 64;
 static constexpr int32_t ITEMQUESIZE_MASK = ITEMQUESIZE - 1;    // Convenience constant for wrapping
 
-extern int32_t      gItemRespawnQueueHead;
-extern int32_t      gItemRespawnQueueTail;
-extern int32_t      gItemRespawnTime[ITEMQUESIZE];
-extern mapthing_t   gItemRespawnQueue[ITEMQUESIZE];
+extern SIM_TLS int32_t      gItemRespawnQueueHead;
+extern SIM_TLS int32_t      gItemRespawnQueueTail;
+extern SIM_TLS int32_t      gItemRespawnTime[ITEMQUESIZE];
+extern SIM_TLS mapthing_t   gItemRespawnQueue[ITEMQUESIZE];
 
 void P_RemoveMobj(mobj_t& mobj) noexcept;
 void P_RespawnSpecials() noexcept;
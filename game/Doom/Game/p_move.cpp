@@ -5,6 +5,7 @@
 #include "Doom/Renderer/r_main.h"
 #include "doomdata.h"
 #include "info.h"
+#include "p_blockthings.h"
 #include "p_inter.h"
 #include "p_local.h"
 #include "p_map.h"
@@ -22,27 +23,27 @@
     static constexpr int32_t MAX_CROSS_LINES = 8;
 #endif
 
-bool        gbTryMove2;     // Whether the move attempt by 'P_TryMove2' was successful or not ('true' if move allowed)
-mobj_t*     gpMoveThing;    // The thing collided with (for code doing interactions with the thing)
-line_t*     gpBlockLine;    // The line collided with
-fixed_t     gTmFloorZ;      // The Z value for the highest floor the collider is in contact with
-fixed_t     gTmCeilingZ;    // The Z value for the lowest ceiling the collider is in contact with
-fixed_t     gTmDropoffZ;    // The Z value for the lowest floor the collider is in contact with. Used by monsters so they don't walk off cliffs.
-bool        gbFloatOk;      // P_TryMove2: if 'true' the up/down movement by floating monsters is allowed (there is vertical space to move)
+SIM_TLS bool        gbTryMove2;     // Whether the move attempt by 'P_TryMove2' was successful or not ('true' if move allowed)
+SIM_TLS mobj_t*     gpMoveThing;    // The thing collided with (for code doing interactions with the thing)
+SIM_TLS line_t*     gpBlockLine;    // The line collided with
+SIM_TLS fixed_t     gTmFloorZ;      // The Z value for the highest floor the collider is in contact with
+SIM_TLS fixed_t     gTmCeilingZ;    // The Z value for the lowest ceiling the collider is in contact with
+SIM_TLS fixed_t     gTmDropoffZ;    // The Z value for the lowest floor the collider is in contact with. Used by monsters so they don't walk off cliffs.
+SIM_TLS bool        gbFloatOk;      // P_TryMove2: if 'true' the up/down movement by floating monsters is allowed (there is vertical space to move)
 
 // PsyDoom: allow the limit on the number of line specials crossed per tick to be removed at runtime
 #if PSYDOOM_MODS
-    std::vector<line_t*> gpCrossCheckLines;
+    SIM_TLS std::vector<line_t*> gpCrossCheckLines;
 #else
     int32_t         gNumCrossCheckLines;                    // How many lines to test for whether the thing crossed them or not: for determining when to trigger line specials
-    static line_t*  gpCrossCheckLines[MAX_CROSS_LINES];     // Lines to test for whether the thing crossed them or not: for determining when to trigger line specials
+    static SIM_TLS line_t*  gpCrossCheckLines[MAX_CROSS_LINES];     // Lines to test for whether the thing crossed them or not: for determining when to trigger line specials
 #endif
 
-static subsector_t*     gpNewSubsec;        // Destination subsector for the current move: set by 'PM_CheckPosition'
-static uint32_t         gTmFlags;           // Flags for the thing being moved
-static fixed_t          gTestTmBBox[4];     // Bounding box for the current thing being collision tested. Set in 'PM_CheckPosition'.
-static fixed_t          gOldX;              // P_TryMove2: position of the thing before it was moved: x
-static fixed_t          gOldY;              // P_TryMove2: position of the thing before it was moved: y
+static SIM_TLS subsector_t*     gpNewSubsec;        // Destination subsector for the current move: set by 'PM_CheckPosition'
+static SIM_TLS uint32_t         gTmFlags;           // Flags for the thing being moved
+static SIM_TLS fixed_t          gTestTmBBox[4];     // Bounding box for the current thing being collision tested. Set in 'PM_CheckPosition'.
+static SIM_TLS fixed_t          gOldX;              // P_TryMove2: position of the thing before it was moved: x
+static SIM_TLS fixed_t          gOldY;              // P_TryMove2: position of the thing before it was moved: y
 
 // Not required externally: making private to this module
 static void PM_UnsetThingPosition(mobj_t& thing) noexcept;
@@ -201,6 +202,11 @@ static void PM_UnsetThingPosition(mobj_t& thing) noexcept {
     // Does this thing get added to the blockmap?
     // If so remove it from the blockmap.
     if ((thing.flags & MF_NOBLOCKMAP) == 0) {
+        // PsyDoom: keep the compact arrays of things for each blockmap cell up to date
+        #if PSYDOOM_MODS
+            P_BlockThingsUnsetPosition(thing);
+        #endif
+
         if (thing.bnext) {
             thing.bnext->bprev = thing.bprev;
         }
@@ -258,6 +264,11 @@ static void PM_SetThingPosition(mobj_t& mobj) noexcept {
 
         // Make sure the thing is bounds for the blockmap: if not then just don't add it to the blockmap
         if ((blockX >= 0) && (blockY >= 0) && (blockX < gBlockmapWidth) && (blockY < gBlockmapHeight)) {
+            // PsyDoom: keep the compact arrays of things for each blockmap cell up to date
+            #if PSYDOOM_MODS
+                P_BlockThingsSetPosition(mobj, blockY * gBlockmapWidth + blockX);
+            #endif
+
             mobj_t*& blockList = gppBlockLinks[blockY * gBlockmapWidth + blockX];
             mobj.bprev = nullptr;
             mobj.bnext = blockList;
@@ -268,10 +279,20 @@ static void PM_SetThingPosition(mobj_t& mobj) noexcept {
 
             blockList = &mobj;
         } else {
+            #if PSYDOOM_MODS
+                P_BlockThingsSetPosition(mobj, -1);
+            #endif
+
             mobj.bprev = nullptr;
             mobj.bnext = nullptr;
         }
     }
+    #if PSYDOOM_MODS
+        else {
+            // PsyDoom: the thing might still be linked into the blockmap from before it's flags changed, keep it's position up to date
+            P_BlockThingsMobjMoved(mobj);
+        }
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -631,10 +652,16 @@ static bool PM_BlockLinesIterator(const int32_t x, const int32_t y) noexcept {
 // In some cases the thing collided with is saved in 'gpMoveThing' for futher interactions like pickups and damaging.
 //------------------------------------------------------------------------------------------------------------------------------------------
 static bool PM_BlockThingsIterator(const int32_t x, const int32_t y) noexcept {
-    for (mobj_t* pmobj = gppBlockLinks[x + y * gBlockmapWidth]; pmobj; pmobj = pmobj->bnext) {
-        if (!PIT_CheckThing(*pmobj))
-            return false;
-    }
+    // PsyDoom: use the compact arrays of things for each blockmap cell, which allow things that are out of range to be skipped without
+    // touching them. This gives the same results as the linked lists since 'PIT_CheckThing' does nothing for things which are out of range.
+    #if PSYDOOM_MODS
+        return P_BlockThingsIterate<true>(x + y * gBlockmapWidth, gTryMoveX, gTryMoveY, gpTryMoveThing->radius, PIT_CheckThing);
+    #else
+        for (mobj_t* pmobj = gppBlockLinks[x + y * gBlockmapWidth]; pmobj; pmobj = pmobj->bnext) {
+            if (!PIT_CheckThing(*pmobj))
+                return false;
+        }
 
-    return true;
+        return true;
+    #endif
 }
@@ -1,22 +1,23 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <vector>
 
 struct line_t;
 struct mobj_t;
 
-extern bool         gbTryMove2;
-extern mobj_t*      gpMoveThing;
-extern line_t*      gpBlockLine;
-extern fixed_t      gTmFloorZ;
-extern fixed_t      gTmCeilingZ;
-extern fixed_t      gTmDropoffZ;
-extern bool         gbFloatOk;
+extern SIM_TLS bool         gbTryMove2;
+extern SIM_TLS mobj_t*      gpMoveThing;
+extern SIM_TLS line_t*      gpBlockLine;
+extern SIM_TLS fixed_t      gTmFloorZ;
+extern SIM_TLS fixed_t      gTmCeilingZ;
+extern SIM_TLS fixed_t      gTmDropoffZ;
+extern SIM_TLS bool         gbFloatOk;
 
 #if PSYDOOM_MODS
-    extern std::vector<line_t*> gpCrossCheckLines;
+    extern SIM_TLS std::vector<line_t*> gpCrossCheckLines;
 #else
     extern int32_t gNumCrossCheckLines;
 #endif
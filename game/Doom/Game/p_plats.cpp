@@ -21,9 +21,9 @@ static constexpr int32_t PLATSPEED  = 2 * FRACUNIT;     // Standard platform spe
 
 // Contains all of the active platforms in the level (some slots may be empty)
 #if PSYDOOM_LIMIT_REMOVING
-    std::vector<plat_t*> gpActivePlats;
+    SIM_TLS std::vector<plat_t*> gpActivePlats;
 #else
-    plat_t* gpActivePlats[MAXPLATS];
+    SIM_TLS plat_t* gpActivePlats[MAXPLATS];
 #endif
 
 //------------------------------------------------------------------------------------------------------------------------------------------
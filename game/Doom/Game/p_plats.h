@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <vector>
 
@@ -63,10 +64,10 @@ struct plat_t {
 
 // PsyDoom: removing limits on the number of moving floors
 #if PSYDOOM_LIMIT_REMOVING
-    extern std::vector<plat_t*> gpActivePlats;
+    extern SIM_TLS std::vector<plat_t*> gpActivePlats;
 #else
     static constexpr int32_t MAXPLATS = 30;     // Maximum number of platforms there can be active at once
-    extern plat_t* gpActivePlats[MAXPLATS];
+    extern SIM_TLS plat_t* gpActivePlats[MAXPLATS];
 #endif
 
 // PsyDoom: definition for a custom platform/elevator.
@@ -103,11 +103,11 @@ static constexpr int32_t WEAPONX        = 1 * FRACUNIT;     // X offset for weap
 static constexpr int32_t WEAPONBOTTOM   = 96 * FRACUNIT;    // Y offset for weapons when they are lowered
 static constexpr int32_t WEAPONTOP      = 0 * FRACUNIT;     // Y offset for weapons when they are raised
 
-static mobj_t*  gpSoundTarget;                  // The current thing making noise
-static fixed_t  gBulletSlope;                   // Vertical aiming slope for shooting: computed by 'P_BulletSlope'
+static SIM_TLS mobj_t*  gpSoundTarget;          // The current thing making noise
+static SIM_TLS fixed_t  gBulletSlope;           // Vertical aiming slope for shooting: computed by 'P_BulletSlope'
 
 // How many unsimulated player sprite vblanks there are
-int32_t gTicRemainder[MAXPLAYERS];
+SIM_TLS int32_t gTicRemainder[MAXPLAYERS];
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Recursively flood fill sound starting from the given sector to other neighboring sectors considered valid for sound transfer.
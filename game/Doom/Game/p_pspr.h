@@ -1,8 +1,9 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
-extern int32_t gTicRemainder[MAXPLAYERS];
+extern SIM_TLS int32_t gTicRemainder[MAXPLAYERS];
 
 #if PSYDOOM_MODS
     void P_NoiseAlertToMobj(mobj_t& noiseMaker) noexcept;
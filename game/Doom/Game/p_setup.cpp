@@ -19,8 +19,10 @@
 #include "doomdata.h"
 #include "g_game.h"
 #include "info.h"
+#include "p_blockthings.h"
 #include "p_firesky.h"
 #include "p_inter.h"
+#include "p_lights.h"
 #include "p_local.h"
 #include "p_maputl.h"
 #include "p_mobj.h"
@@ -35,6 +37,7 @@
 #include "PsyDoom/MapPatcher/MapPatcher.h"
 #include "PsyDoom/MobjSpritePrecacher.h"
 #include "PsyDoom/ModMgr.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ScriptingEngine.h"
 
 #include <algorithm>
@@ -59,62 +62,62 @@ static constexpr const char* SKY_LUMP_NAME = "F_SKY";
 static constexpr int32_t SKY_LUMP_NAME_LEN = sizeof("F_SKY") - 1;   // -1 to discount null terminator
 
 // Map data
-uint16_t*       gpBlockmapLump;
-uint16_t*       gpBlockmap;
-int32_t         gBlockmapWidth;
-int32_t         gBlockmapHeight;
-fixed_t         gBlockmapOriginX;
-fixed_t         gBlockmapOriginY;
-mobj_t**        gppBlockLinks;
-int32_t         gNumVertexes;
-vertex_t*       gpVertexes;
-int32_t         gNumSectors;
-sector_t*       gpSectors;
-int32_t         gNumSides;
-side_t*         gpSides;
-int32_t         gNumLines;
-line_t*         gpLines;
-int32_t         gNumSubsectors;
-subsector_t*    gpSubsectors;
-int32_t         gNumBspNodes;
-node_t*         gpBspNodes;
-int32_t         gNumSegs;
-seg_t*          gpSegs;
-int32_t         gTotalNumLeafEdges;
-leafedge_t*     gpLeafEdges;
-uint8_t*        gpRejectMatrix;
-mapthing_t      gPlayerStarts[MAXPLAYERS];
-mapthing_t      gDeathmatchStarts[MAX_DEATHMATCH_STARTS];
-mapthing_t*     gpDeathmatchP;                                  // Points past the end of the deathmatch starts list
+SIM_TLS uint16_t*       gpBlockmapLump;
+SIM_TLS uint16_t*       gpBlockmap;
+SIM_TLS int32_t         gBlockmapWidth;
+SIM_TLS int32_t         gBlockmapHeight;
+SIM_TLS fixed_t         gBlockmapOriginX;
+SIM_TLS fixed_t         gBlockmapOriginY;
+SIM_TLS mobj_t**        gppBlockLinks;
+SIM_TLS int32_t         gNumVertexes;
+SIM_TLS vertex_t*       gpVertexes;
+SIM_TLS int32_t         gNumSectors;
+SIM_TLS sector_t*       gpSectors;
+SIM_TLS int32_t         gNumSides;
+SIM_TLS side_t*         gpSides;
+SIM_TLS int32_t         gNumLines;
+SIM_TLS line_t*         gpLines;
+SIM_TLS int32_t         gNumSubsectors;
+SIM_TLS subsector_t*    gpSubsectors;
+SIM_TLS int32_t         gNumBspNodes;
+SIM_TLS node_t*         gpBspNodes;
+SIM_TLS int32_t         gNumSegs;
+SIM_TLS seg_t*          gpSegs;
+SIM_TLS int32_t         gTotalNumLeafEdges;
+SIM_TLS leafedge_t*     gpLeafEdges;
+SIM_TLS uint8_t*        gpRejectMatrix;
+SIM_TLS mapthing_t      gPlayerStarts[MAXPLAYERS];
+SIM_TLS mapthing_t      gDeathmatchStarts[MAX_DEATHMATCH_STARTS];
+SIM_TLS mapthing_t*     gpDeathmatchP;                                  // Points past the end of the deathmatch starts list
 
 // PsyDoom: a list of all player starts for players 1 & 2, including duplicates that spawn so called 'Voodoo dolls'.
 // This list is used to add support for 'Voodoo dolls' to the PSX engine.
 #if PSYDOOM_MODS
-    static std::vector<mapthing_t> gAllPlayerStarts;
+    static SIM_TLS std::vector<mapthing_t> gAllPlayerStarts;
 #endif
 
 // PsyDoom: if not null then issue this warning after the level has started.
 // Can be used to issue non-fatal warnings about bad map conditions to WAD authors.
 #if PSYDOOM_MODS
-    char gLevelStartupWarning[64];
+    SIM_TLS char gLevelStartupWarning[64];
 #endif
 
 // PsyDoom: sets of texture and flat texture indexes to indicate what walls and flats are to be loaded & cached during level setup.
 // The new flexible texture mangement code first flags all the resources needed using these sets before actually sorting and loading the resources.
 #if PSYDOOM_LIMIT_REMOVING
-    FixedIndexSet gCacheTextureSet;
-    FixedIndexSet gCacheFlatTextureSet;
+    SIM_TLS FixedIndexSet gCacheTextureSet;
+    SIM_TLS FixedIndexSet gCacheFlatTextureSet;
 
     // A sorted list of textures to be loaded, produced from the indexes: re-use to avoid reallocations
-    static std::vector<texture_t*> gLoadTextureList;
+    static SIM_TLS std::vector<texture_t*> gLoadTextureList;
 #endif
 
 // Is the map being loaded a Final Doom format map?
-static bool gbLoadingFinalDoomMap;
+static SIM_TLS bool gbLoadingFinalDoomMap;
 
 // Function to update the fire sky.
 // Set when the map has a fire sky, otherwise null.
-void (*gUpdateFireSkyFunc)(texture_t& skyTex) = nullptr;
+SIM_TLS void (*gUpdateFireSkyFunc)(texture_t& skyTex) = nullptr;
 
 // Functions internal to this module
 #if PSYDOOM_LIMIT_REMOVING
@@ -914,6 +917,11 @@ static void P_LoadBlockMap(const int32_t lumpNum) noexcept {
     const int32_t blockLinksSize = blockmapHeader.width * blockmapHeader.height * (int32_t) sizeof(gppBlockLinks[0]);
     gppBlockLinks = (mobj_t**) Z_Malloc(*gpMainMemZone, blockLinksSize, PU_LEVEL, nullptr);
     D_memset(gppBlockLinks, std::byte(0), blockLinksSize);
+
+    // PsyDoom: initialize the compact arrays of things for each blockmap cell also
+    #if PSYDOOM_MODS
+        P_InitBlockThings();
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1484,6 +1492,10 @@ static void P_Init() noexcept {
 // Note: while most of the loading and setup is done here for the level, sound and music are handled eleswhere.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_SetupLevel(const int32_t mapNum, [[maybe_unused]] const skill_t skill) noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_SetupLevel");
+    #endif
+
     // Cleanup of memory and resetting the RNG before we start
     Z_FreeTags(*gpMainMemZone, PU_CACHE | PU_LEVSPEC| PU_LEVEL);
 
@@ -1538,6 +1550,10 @@ void P_SetupLevel(const int32_t mapNum, [[maybe_unused]] const skill_t skill) no
     gThinkerCap.prev = &gThinkerCap;
     gThinkerCap.next = &gThinkerCap;
 
+    #if PSYDOOM_MODS
+        P_InvalidateLightThinkerRuns();     // PsyDoom: any runs of light thinkers gathered for the previous map are no longer valid
+    #endif
+
     gMobjHead.next = &gMobjHead;
     gMobjHead.prev = &gMobjHead;
 
@@ -3,6 +3,7 @@
 #include "Doom/cdmaptbl.h"
 #include "Doom/doomdef.h"
 #include "PsyDoom/FixedIndexSet.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct leafedge_t;
 struct line_t;
@@ -16,44 +17,44 @@ struct vertex_t;
 // Maximum amount of deathmatch starts
 static constexpr uint32_t MAX_DEATHMATCH_STARTS = 10;
 
-extern uint16_t*        gpBlockmapLump;
-extern uint16_t*        gpBlockmap;
-extern int32_t          gBlockmapWidth;
-extern int32_t          gBlockmapHeight;
-extern fixed_t          gBlockmapOriginX;
-extern fixed_t          gBlockmapOriginY;
-extern mobj_t**         gppBlockLinks;
-extern int32_t          gNumVertexes;
-extern vertex_t*        gpVertexes;
-extern int32_t          gNumSectors;
-extern sector_t*        gpSectors;
-extern int32_t          gNumSides;
-extern side_t*          gpSides;
-extern int32_t          gNumLines;
-extern line_t*          gpLines;
-extern int32_t          gNumSubsectors;
-extern subsector_t*     gpSubsectors;
-extern int32_t          gNumBspNodes;
-extern node_t*          gpBspNodes;
-extern int32_t          gNumSegs;
-extern seg_t*           gpSegs;
-extern int32_t          gTotalNumLeafEdges;
-extern leafedge_t*      gpLeafEdges;
-extern uint8_t*         gpRejectMatrix;
-extern mapthing_t       gPlayerStarts[MAXPLAYERS];
-extern mapthing_t       gDeathmatchStarts[MAX_DEATHMATCH_STARTS];
-extern mapthing_t*      gpDeathmatchP;
+extern SIM_TLS uint16_t*        gpBlockmapLump;
+extern SIM_TLS uint16_t*        gpBlockmap;
+extern SIM_TLS int32_t          gBlockmapWidth;
+extern SIM_TLS int32_t          gBlockmapHeight;
+extern SIM_TLS fixed_t          gBlockmapOriginX;
+extern SIM_TLS fixed_t          gBlockmapOriginY;
+extern SIM_TLS mobj_t**         gppBlockLinks;
+extern SIM_TLS int32_t          gNumVertexes;
+extern SIM_TLS vertex_t*        gpVertexes;
+extern SIM_TLS int32_t          gNumSectors;
+extern SIM_TLS sector_t*        gpSectors;
+extern SIM_TLS int32_t          gNumSides;
+extern SIM_TLS side_t*          gpSides;
+extern SIM_TLS int32_t          gNumLines;
+extern SIM_TLS line_t*          gpLines;
+extern SIM_TLS int32_t          gNumSubsectors;
+extern SIM_TLS subsector_t*     gpSubsectors;
+extern SIM_TLS int32_t          gNumBspNodes;
+extern SIM_TLS node_t*          gpBspNodes;
+extern SIM_TLS int32_t          gNumSegs;
+extern SIM_TLS seg_t*           gpSegs;
+extern SIM_TLS int32_t          gTotalNumLeafEdges;
+extern SIM_TLS leafedge_t*      gpLeafEdges;
+extern SIM_TLS uint8_t*         gpRejectMatrix;
+extern SIM_TLS mapthing_t       gPlayerStarts[MAXPLAYERS];
+extern SIM_TLS mapthing_t       gDeathmatchStarts[MAX_DEATHMATCH_STARTS];
+extern SIM_TLS mapthing_t*      gpDeathmatchP;
 
 #if PSYDOOM_MODS
-    extern char gLevelStartupWarning[64];
+    extern SIM_TLS char gLevelStartupWarning[64];
 #endif
 
 #if PSYDOOM_LIMIT_REMOVING
-    extern FixedIndexSet gCacheTextureSet;
-    extern FixedIndexSet gCacheFlatTextureSet;
+    extern SIM_TLS FixedIndexSet gCacheTextureSet;
+    extern SIM_TLS FixedIndexSet gCacheFlatTextureSet;
 #endif
 
-extern void (*gUpdateFireSkyFunc)(texture_t& skyTex);
+extern SIM_TLS void (*gUpdateFireSkyFunc)(texture_t& skyTex);
 
 void P_SetupLevel(const int32_t mapNum, const skill_t skill) noexcept;
 
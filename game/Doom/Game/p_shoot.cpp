@@ -17,30 +17,30 @@ struct thingline_t {
     vertex_t    p2;
 };
 
-mobj_t*     gpShootMobj;        // The thing that is being shot (if hit a thing)
-line_t*     gpShootLine;        // The line that is being shot (if hit a line)
-fixed_t     gShootSlope;        // The Z slope for the line from the shooter origin to the hit point
-fixed_t     gShootX;            // The point in space (X) that was hit when shooting (used for puff, blood spawn)
-fixed_t     gShootY;            // The point in space (Y) that was hit when shooting (used for puff, blood spawn)
-fixed_t     gShootZ;            // The point in space (Z) that was hit when shooting (used for puff, blood spawn)
-
-static fixed_t      gAimMidSlope;           // The slope for the middle/center of the vertical aim range for the shooter: used to determine if we are hitting lower or upper walls
-static divline_t    gShootDiv;              // The start point and vector for shooting sight checking
-static fixed_t      gShootX2;               // End point for shooting sight checking: x
-static fixed_t      gShootY2;               // End point for shooting sight checking: y
-static int32_t      gSsx1;                  // Shooting sight line start, whole coords: x
-static int32_t      gSsy1;                  // Shooting sight line start, whole coords: y
-static int32_t      gSsx2;                  // Shooting sight line end, whole coords: x
-static int32_t      gSsy2;                  // Shooting sight line end, whole coords: y
-static void*        gpOldValue;             // Intercept testing: previous closest line or thing
-static fixed_t      gOldFrac;               // Intercept testing: previous closest hit fractional distance (along line of sight)
-static bool         gbOldIsLine;            // Intercept testing: previous closest hit - was the hit against a line? (Was a thing if 'false')
-static bool         gbShootDivPositive;     // True if the slope for the shooters shoot direction is positive
-static thingline_t  gThingLineVerts;        // The vertices for the shooters shoot line
-static fixed_t      gFirstLineFrac;         // Fractional distance along the shooting line of the first/closest wall hit
+SIM_TLS mobj_t*     gpShootMobj;        // The thing that is being shot (if hit a thing)
+SIM_TLS line_t*     gpShootLine;        // The line that is being shot (if hit a line)
+SIM_TLS fixed_t     gShootSlope;        // The Z slope for the line from the shooter origin to the hit point
+SIM_TLS fixed_t     gShootX;            // The point in space (X) that was hit when shooting (used for puff, blood spawn)
+SIM_TLS fixed_t     gShootY;            // The point in space (Y) that was hit when shooting (used for puff, blood spawn)
+SIM_TLS fixed_t     gShootZ;            // The point in space (Z) that was hit when shooting (used for puff, blood spawn)
+
+static SIM_TLS fixed_t      gAimMidSlope;           // The slope for the middle/center of the vertical aim range for the shooter: used to determine if we are hitting lower or upper walls
+static SIM_TLS divline_t    gShootDiv;              // The start point and vector for shooting sight checking
+static SIM_TLS fixed_t      gShootX2;               // End point for shooting sight checking: x
+static SIM_TLS fixed_t      gShootY2;               // End point for shooting sight checking: y
+static SIM_TLS int32_t      gSsx1;                  // Shooting sight line start, whole coords: x
+static SIM_TLS int32_t      gSsy1;                  // Shooting sight line start, whole coords: y
+static SIM_TLS int32_t      gSsx2;                  // Shooting sight line end, whole coords: x
+static SIM_TLS int32_t      gSsy2;                  // Shooting sight line end, whole coords: y
+static SIM_TLS void*        gpOldValue;             // Intercept testing: previous closest line or thing
+static SIM_TLS fixed_t      gOldFrac;               // Intercept testing: previous closest hit fractional distance (along line of sight)
+static SIM_TLS bool         gbOldIsLine;            // Intercept testing: previous closest hit - was the hit against a line? (Was a thing if 'false')
+static SIM_TLS bool         gbShootDivPositive;     // True if the slope for the shooters shoot direction is positive
+static SIM_TLS thingline_t  gThingLineVerts;        // The vertices for the shooters shoot line
+static SIM_TLS fixed_t      gFirstLineFrac;         // Fractional distance along the shooting line of the first/closest wall hit
 
 // A partially defined 'line_t' for the shooters line (just the two vertex pointer fields are used)
-static line_t gPartialThingLine { 
+static SIM_TLS line_t gPartialThingLine { 
     &gThingLineVerts.p1,
     &gThingLineVerts.p2
 };
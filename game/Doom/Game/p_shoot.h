@@ -1,16 +1,17 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct divline_t;
 struct line_t;
 
-extern mobj_t*      gpShootMobj;
-extern line_t*      gpShootLine;
-extern fixed_t      gShootSlope;
-extern fixed_t      gShootX;
-extern fixed_t      gShootY;
-extern fixed_t      gShootZ;
+extern SIM_TLS mobj_t*      gpShootMobj;
+extern SIM_TLS line_t*      gpShootLine;
+extern SIM_TLS fixed_t      gShootSlope;
+extern SIM_TLS fixed_t      gShootX;
+extern SIM_TLS fixed_t      gShootY;
+extern SIM_TLS fixed_t      gShootZ;
 
 void P_Shoot2() noexcept;
 bool PA_DoIntercept(void* const pObj, const bool bIsLine, const fixed_t hitFrac) noexcept;
@@ -11,24 +11,120 @@
 #include "p_shoot.h"
 #include "p_tick.h"
 #include "PsyDoom/Game.h"
+#include "PsyDoom/Profiler.h"
+#include "PsyDoom/ProgArgs.h"
+#include "PsyDoom/Sim/SimTls.h"
+#include "PsyDoom/WorkerThreads.h"
 
 #include <algorithm>
+#include <vector>
+
+// PsyDoom: the state for a single sight check.
+// This was originally a set of global variables, but is now held in a context so that sight checks can run concurrently on multiple threads.
+struct sightctx_t {
+    fixed_t     sightZStart;            // Z position of thing looking
+    fixed_t     topSlope;               // Maximum/top unblocked viewing slope (clipped against upper walls)
+    fixed_t     bottomSlope;            // Minimum/bottom unblocked viewing slope (clipped against lower walls)
+    divline_t   sTrace;                 // The start point and vector for sight checking
+    fixed_t     t2x;                    // End point for sight checking: x
+    fixed_t     t2y;                    // End point for sight checking: y
+    int32_t     t1xs;                   // Sight line start, whole coords: x
+    int32_t     t1ys;                   // Sight line start, whole coords: y
+    int32_t     t2xs;                   // Sight line end, whole coords: x
+    int32_t     t2ys;                   // Sight line end, whole coords: y
+    int32_t     validCount;             // Marker for lines which have already been checked during this sight check
+    int32_t*    pLineValidCounts;       // Per-thread line markers (indexed by line number), or 'nullptr' to use the shared 'validcount' field of each line
+};
+
+#if PSYDOOM_MODS
+    // How many sight checks are handed out to a thread at a time when checking sights in parallel, and the minimum number of sight
+    // checks in a tic before it is worth using multiple threads.
+    static constexpr uint32_t SIGHT_CHECKS_PER_JOB = 32;
+    static constexpr uint32_t MIN_PARALLEL_SIGHT_CHECKS = 128;
+
+    // Flags for the result of a sight check done in parallel
+    static constexpr uint8_t SIGHT_RESULT_VISIBLE = 0x1;    // The target is visible
+    static constexpr uint8_t SIGHT_RESULT_TRACED  = 0x2;    // The sight line was traced through the BSP tree (consuming a valid count)
+
+    // The things due a sight check this tic and the results of checking their sight in parallel
+    static SIM_TLS std::vector<mobj_t*>     gSightCheckMobjs;
+    static SIM_TLS std::vector<uint8_t>     gSightCheckResults;
+
+    // Per-thread line markers and the current marker value, used for parallel sight checks instead of the shared 'validcount' field of each line
+    static thread_local std::vector<int32_t>    tgLineValidCounts;
+    static thread_local int32_t                 tgLineValidCount;
+#endif
+
+static bool PS_CheckSight(sightctx_t& ctx, mobj_t& mobj1, mobj_t& mobj2) noexcept;
+
+#if PSYDOOM_MODS
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: checks sight for all of the things in 'gSightCheckMobjs' in parallel, then applies the results in list order.
+//
+// Each thread uses its own line markers while sight checking, so the shared 'gValidCount' and line 'validcount' fields are untouched during
+// the parallel phase. Afterwards 'gValidCount' is advanced by the number of sight lines traced, so it ends up with the same value as when
+// checking sights one after the other. The line markers themselves don't need to match: all other code which marks lines increments
+// 'gValidCount' before doing so, and since 'gValidCount' only ever increases no stale marker left behind by a sight check can match it.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void P_CheckSightsInParallel() noexcept {
+    const uint32_t numChecks = (uint32_t) gSightCheckMobjs.size();
+    const uint32_t numJobs = (numChecks + SIGHT_CHECKS_PER_JOB - 1) / SIGHT_CHECKS_PER_JOB;
+    gSightCheckResults.resize(numChecks);
+
+    WorkerThreads::runJobs(numJobs, [=](const uint32_t jobIdx) noexcept {
+        // Make sure this thread has a marker for every line
+        if (tgLineValidCounts.size() < (size_t) gNumLines) {
+            tgLineValidCounts.resize((size_t) gNumLines, 0);
+        }
+
+        sightctx_t ctx = {};
+        ctx.pLineValidCounts = tgLineValidCounts.data();
+
+        const uint32_t beginIdx = jobIdx * SIGHT_CHECKS_PER_JOB;
+        const uint32_t endIdx = std::min(beginIdx + SIGHT_CHECKS_PER_JOB, numChecks);
+
+        for (uint32_t checkIdx = beginIdx; checkIdx < endIdx; ++checkIdx) {
+            mobj_t& mobj = *gSightCheckMobjs[checkIdx];
+            ctx.validCount = 0;
+
+            const bool bVisible = (mobj.target && PS_CheckSight(ctx, mobj, *mobj.target));
+            const bool bTraced = (ctx.validCount != 0);
+            gSightCheckResults[checkIdx] = (bVisible ? SIGHT_RESULT_VISIBLE : 0) | (bTraced ? SIGHT_RESULT_TRACED : 0);
+        }
+    });
+
+    // Count how many sight lines were traced and apply the results in order
+    int32_t numTraced = 0;
+
+    for (uint32_t checkIdx = 0; checkIdx < numChecks; ++checkIdx) {
+        mobj_t& mobj = *gSightCheckMobjs[checkIdx];
+        const uint8_t result = gSightCheckResults[checkIdx];
 
-static fixed_t      gSightZStart;       // Z position of thing looking
-static fixed_t      gTopSlope;          // Maximum/top unblocked viewing slope (clipped against upper walls)
-static fixed_t      gBottomSlope;       // Minimum/bottom unblocked viewing slope (clipped against lower walls)
-static divline_t    gSTrace;            // The start point and vector for sight checking
-static fixed_t      gT2x;               // End point for sight checking: x
-static fixed_t      gT2y;               // End point for sight checking: y
-static int32_t      gT1xs;              // Sight line start, whole coords: x
-static int32_t      gT1ys;              // Sight line start, whole coords: y
-static int32_t      gT2xs;              // Sight line end, whole coords: x
-static int32_t      gT2ys;              // Sight line end, whole coords: y
+        if (result & SIGHT_RESULT_VISIBLE) {
+            mobj.flags |= MF_SEETARGET;
+        } else {
+            mobj.flags &= (~MF_SEETARGET);
+        }
+
+        if (result & SIGHT_RESULT_TRACED) {
+            numTraced++;
+        }
+    }
+
+    // Leave 'gValidCount' as it would have been had the checks been done one at a time
+    gValidCount += numTraced;
+}
+#endif  // #if PSYDOOM_MODS
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Updates target visibility checking for all map objects that are due an update
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_CheckSights() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_CheckSights");
+        gSightCheckMobjs.clear();
+    #endif
+
     for (mobj_t* pmobj = gMobjHead.next; pmobj != &gMobjHead; pmobj = pmobj->next) {
         // Must be killable (enemy) to do sight checking.
         //
@@ -47,6 +143,34 @@ void P_CheckSights() noexcept {
 
         // Must be about to change states for up-to-date sight info to be useful
         if (pmobj->tics == 1) {
+            // PsyDoom: gather up the things to check sight for, so the checks can potentially be done in parallel below
+            #if PSYDOOM_MODS
+                gSightCheckMobjs.push_back(pmobj);
+            #else
+                // See if we can see the target - if any.
+                // Add or remove the visibility flag based on this:
+                mobj_t* const pMobjTarget = pmobj->target;
+
+                if (pMobjTarget && P_CheckSight(*pmobj, *pMobjTarget)) {
+                    pmobj->flags |= MF_SEETARGET;
+                } else {
+                    pmobj->flags &= (~MF_SEETARGET);    // No longer can see target
+                }
+            #endif
+        }
+    }
+
+    // PsyDoom: check sight for all the things gathered above.
+    // If enabled and there are enough checks to make it worthwhile, then do them in parallel on multiple threads.
+    #if PSYDOOM_MODS
+        const uint32_t numChecks = (uint32_t) gSightCheckMobjs.size();
+
+        if (ProgArgs::gbParallelSightChecks && (numChecks >= MIN_PARALLEL_SIGHT_CHECKS) && (WorkerThreads::getNumThreads() > 1)) {
+            P_CheckSightsInParallel();
+            return;
+        }
+
+        for (mobj_t* const pmobj : gSightCheckMobjs) {
             // See if we can see the target - if any.
             // Add or remove the visibility flag based on this:
             mobj_t* const pMobjTarget = pmobj->target;
@@ -57,13 +181,23 @@ void P_CheckSights() noexcept {
                 pmobj->flags &= (~MF_SEETARGET);    // No longer can see target
             }
         }
-    }
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Tells if 'mobj1' can see 'mobj2'. Returns 'true' if that is the case.
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool P_CheckSight(mobj_t& mobj1, mobj_t& mobj2) noexcept {
+    // PsyDoom: sight checks now use a context for their state and this one uses the shared 'validcount' field of each line
+    sightctx_t ctx = {};
+    return PS_CheckSight(ctx, mobj1, mobj2);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: implementation of 'P_CheckSight' using the given context for the state of the sight check.
+// If the context has per-thread line markers then those are used instead of the shared 'validcount' field of each line.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool PS_CheckSight(sightctx_t& ctx, mobj_t& mobj1, mobj_t& mobj2) noexcept {
     // PsyDoom: if the target is a player, not a 'Voodoo doll' and has the 'notarget' cheat on then it cannot be seen.
     // PsyDoom: if the external camera is active then don't allow anything to be sighted.
     #if PSYDOOM_MODS
@@ -91,35 +225,40 @@ bool P_CheckSight(mobj_t& mobj1, mobj_t& mobj2) noexcept {
     // Note that the coordinates are truncated to be on odd integer coordinates.
     // Not sure why this is done, or what it's trying to avoid - it's in the 3DO and Jag Doom sources but not explained.
     const int32_t COORD_MASK = 0xFFFE0000;
-    gSTrace.x = (mobj1.x & COORD_MASK) | FRACUNIT;
-    gSTrace.y = (mobj1.y & COORD_MASK) | FRACUNIT;
-    gT2x = (mobj2.x & COORD_MASK) | FRACUNIT;
-    gT2y = (mobj2.y & COORD_MASK) | FRACUNIT;
+    ctx.sTrace.x = (mobj1.x & COORD_MASK) | FRACUNIT;
+    ctx.sTrace.y = (mobj1.y & COORD_MASK) | FRACUNIT;
+    ctx.t2x = (mobj2.x & COORD_MASK) | FRACUNIT;
+    ctx.t2y = (mobj2.y & COORD_MASK) | FRACUNIT;
 
     // Precalculate the vector for the sight line
-    gSTrace.dx = gT2x - gSTrace.x;
-    gSTrace.dy = gT2y - gSTrace.y;
+    ctx.sTrace.dx = ctx.t2x - ctx.sTrace.x;
+    ctx.sTrace.dy = ctx.t2y - ctx.sTrace.y;
 
     // Precalculate the truncated start and end points for the sight line for later use
-    gT1xs = d_fixed_to_int(gSTrace.x);
-    gT1ys = d_fixed_to_int(gSTrace.y);
-    gT2xs = d_fixed_to_int(gT2x);
-    gT2ys = d_fixed_to_int(gT2y);
+    ctx.t1xs = d_fixed_to_int(ctx.sTrace.x);
+    ctx.t1ys = d_fixed_to_int(ctx.sTrace.y);
+    ctx.t2xs = d_fixed_to_int(ctx.t2x);
+    ctx.t2ys = d_fixed_to_int(ctx.t2y);
 
     // This is how high the sight point is at (eyeball level -1/4 height down from the top)
     const fixed_t sightZStart = mobj1.z + mobj1.height - d_rshift<2>(mobj1.height);
-    gSightZStart = sightZStart;
+    ctx.sightZStart = sightZStart;
 
     // Figure out the initial top and bottom slopes for the the vertical sight range
-    gTopSlope = mobj2.z + mobj2.height - sightZStart;
-    gBottomSlope = mobj2.z - sightZStart;
+    ctx.topSlope = mobj2.z + mobj2.height - sightZStart;
+    ctx.bottomSlope = mobj2.z - sightZStart;
 
-    // Doing a new raycast so update the visitation mark which tells us if stuff has already been processed
-    gValidCount++;
+    // Doing a new raycast so update the visitation mark which tells us if stuff has already been processed.
+    // PsyDoom: use the per-thread marker instead if the context has per-thread line markers.
+    #if PSYDOOM_MODS
+        ctx.validCount = (ctx.pLineValidCounts) ? ++tgLineValidCount : ++gValidCount;
+    #else
+        ctx.validCount = ++gValidCount;
+    #endif
 
     // Do a raycast against the BSP tree and return if sight is unobstructed.
     // Also narrows the vertical sight range with each lower and upper wall encountered.
-    return PS_CrossBSPNode(gNumBspNodes - 1);
+    return PS_CrossBSPNode(ctx, gNumBspNodes - 1);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -127,16 +266,16 @@ bool P_CheckSight(mobj_t& mobj1, mobj_t& mobj2) noexcept {
 // When the intersect ratio is > 0.0 and < 1.0 then there is a valid intersection with the sight line, otherwise there is no
 // intersection or the intersection occurs beyond the range of the line.
 //------------------------------------------------------------------------------------------------------------------------------------------
-static fixed_t PS_SightCrossLine(line_t& line) noexcept {
+static fixed_t PS_SightCrossLine(const sightctx_t& ctx, line_t& line) noexcept {
     // Get the integer coordinates of the line and the sight line
     const int32_t lineX1 = d_fixed_to_int(line.vertex1->x);
     const int32_t lineY1 = d_fixed_to_int(line.vertex1->y);
     const int32_t lineX2 = d_fixed_to_int(line.vertex2->x);
     const int32_t lineY2 = d_fixed_to_int(line.vertex2->y);
-    const int32_t sightX1 = gT1xs;
-    const int32_t sightY1 = gT1ys;
-    const int32_t sightX2 = gT2xs;
-    const int32_t sightY2 = gT2ys;
+    const int32_t sightX1 = ctx.t1xs;
+    const int32_t sightY1 = ctx.t1ys;
+    const int32_t sightX2 = ctx.t2xs;
+    const int32_t sightY2 = ctx.t2ys;
 
     // Compute which sides of the sight line the line points are on.
     // Use the same cross product trick found in 'PA_DivlineSide' and 'R_PointOnSide'.
@@ -172,7 +311,7 @@ static fixed_t PS_SightCrossLine(line_t& line) noexcept {
 // Returns 'true' if the sight line is unobstructed, returns 'false' otherwise.
 // This function also updates/narrows the allowed vertical view range.
 //------------------------------------------------------------------------------------------------------------------------------------------
-static bool PS_CrossSubsector(subsector_t& subsec) noexcept {
+static bool PS_CrossSubsector(sightctx_t& ctx, subsector_t& subsec) noexcept {
     // Check the sight line against the lines for all segs in the subsector
     const int32_t numSegs = subsec.numsegs;
     seg_t* const pSegs = &gpSegs[subsec.firstseg];
@@ -182,16 +321,23 @@ static bool PS_CrossSubsector(subsector_t& subsec) noexcept {
         line_t& line = *seg.linedef;
 
         // Skip past this seg's line if we've already done it this sight check.
-        // Multiple segs might reference the same line, so this saves redundant work:
-        if (line.validcount == gValidCount)
+        // Multiple segs might reference the same line, so this saves redundant work.
+        // PsyDoom: use the per-thread line markers instead if the context has them.
+        #if PSYDOOM_MODS
+            int32_t& lineValidCount = (ctx.pLineValidCounts) ? ctx.pLineValidCounts[&line - gpLines] : line.validcount;
+        #else
+            int32_t& lineValidCount = line.validcount;
+        #endif
+
+        if (lineValidCount == ctx.validCount)
             continue;
 
         // Don't check the line again until the next sight check
-        line.validcount = gValidCount;
+        lineValidCount = ctx.validCount;
 
         // If the sight line does not intersect along the actual line points then ignore.
         // Not sure where the magics here came from, probably through hacking/experimentation?
-        const fixed_t intersectFrac = PS_SightCrossLine(line);
+        const fixed_t intersectFrac = PS_SightCrossLine(ctx, line);
 
         if ((intersectFrac < 4) || (intersectFrac > FRACUNIT))
             continue;
@@ -224,7 +370,7 @@ static bool PS_CrossSubsector(subsector_t& subsec) noexcept {
 
         // Narrow the allowed vertical sight range: against bottom wall
         if (fsec.floorheight != bsec.floorheight) {
-            const fixed_t dz = highestFloor - gSightZStart;
+            const fixed_t dz = highestFloor - ctx.sightZStart;
 
             // PsyDoom: use 64-bit ops to avoid overflows in the line of sight calculations, if enabled
             int32_t slope;
@@ -236,14 +382,14 @@ static bool PS_CrossSubsector(subsector_t& subsec) noexcept {
                 slope = d_lshift<8>(d_lshift<6>(dz) / d_rshift<2>(intersectFrac));
             }
 
-            if (slope > gBottomSlope) {
-                gBottomSlope = slope;
+            if (slope > ctx.bottomSlope) {
+                ctx.bottomSlope = slope;
             }
         }
 
         // Narrow the allowed vertical sight range: against top wall
         if (fsec.ceilingheight != bsec.ceilingheight) {
-            const fixed_t dz = lowestCeil - gSightZStart;
+            const fixed_t dz = lowestCeil - ctx.sightZStart;
 
             // PsyDoom: use 64-bit ops to avoid overflows in the line of sight calculations, if enabled
             int32_t slope;
@@ -255,13 +401,13 @@ static bool PS_CrossSubsector(subsector_t& subsec) noexcept {
                 slope = d_lshift<8>(d_lshift<6>(dz) / d_rshift<2>(intersectFrac));
             }
 
-            if (slope < gTopSlope) {
-                gTopSlope = slope;
+            if (slope < ctx.topSlope) {
+                ctx.topSlope = slope;
             }
         }
 
         // If the allowed vertical sight range has become completely closed then sight is blocked
-        if (gTopSlope <= gBottomSlope)
+        if (ctx.topSlope <= ctx.bottomSlope)
             return false;
     }
 
@@ -270,16 +416,16 @@ static bool PS_CrossSubsector(subsector_t& subsec) noexcept {
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Recursive sight checking: tells if the 'gSTrace' line is blocked by the BSP tree halfspace represented by the given node.
+// Recursive sight checking: tells if the context's sight line is blocked by the BSP tree halfspace represented by the given node.
 // Returns 'true' if the sight line is unobstructed.
 //------------------------------------------------------------------------------------------------------------------------------------------
-bool PS_CrossBSPNode(const int32_t nodeNum) noexcept {
+bool PS_CrossBSPNode(sightctx_t& ctx, const int32_t nodeNum) noexcept {
     // Is this bsp node actually a subsector? (leaf node) If so then do sight checks against that:
     if (nodeNum & NF_SUBSECTOR) {
         const int32_t subsecNum = nodeNum & (~NF_SUBSECTOR);
 
         if (subsecNum < gNumSubsectors) {
-            return PS_CrossSubsector(gpSubsectors[subsecNum]);
+            return PS_CrossSubsector(ctx, gpSubsectors[subsecNum]);
         } else {
             I_Error("PS_CrossSubsector: ss %i with numss = %i", subsecNum, gNumSubsectors);     // Bad subsector number!
             return false;
@@ -288,17 +434,17 @@ bool PS_CrossBSPNode(const int32_t nodeNum) noexcept {
 
     // See what side of the bsp split the point is on: will check to see if the sight line is blocked by that half-space first
     node_t& bspNode = gpBspNodes[nodeNum];
-    const int32_t sideNum = PA_DivlineSide(gSTrace.x, gSTrace.y, bspNode.line);
+    const int32_t sideNum = PA_DivlineSide(ctx.sTrace.x, ctx.sTrace.y, bspNode.line);
 
     // If the sight line cannot cross the closest half-space then we are done: sight is obstructed
-    if (!PS_CrossBSPNode(bspNode.children[sideNum]))
+    if (!PS_CrossBSPNode(ctx, bspNode.children[sideNum]))
         return false;
 
     // Check to see what side of the bsp split the end point for sight checking is on.
     // If it's in the same half-space we just raycasted against then we are done - sight is unobstructed.
-    if (sideNum == PA_DivlineSide(gT2x, gT2y, bspNode.line))
+    if (sideNum == PA_DivlineSide(ctx.t2x, ctx.t2y, bspNode.line))
         return true;
 
     // Failing that recurse into the opposite side of the BSP split and raycast against that, returning the result
-    return PS_CrossBSPNode(bspNode.children[sideNum ^ 1]);
+    return PS_CrossBSPNode(ctx, bspNode.children[sideNum ^ 1]);
 }
@@ -16,33 +16,33 @@ static constexpr int32_t SIDE_FRONT = +1;   // Return code for side checking: po
 static constexpr int32_t SIDE_ON    =  0;   // Return code for side checking: point is on the line
 static constexpr int32_t SIDE_BACK  = -1;   // Return code for side checking: point is on the back side of the line
 
-mobj_t*     gpSlideThing;       // The thing being moved
-fixed_t     gSlideX;            // Where the player move is starting from: x
-fixed_t     gSlideY;            // Where the player move is starting from: y
+SIM_TLS mobj_t*     gpSlideThing;       // The thing being moved
+SIM_TLS fixed_t     gSlideX;            // Where the player move is starting from: x
+SIM_TLS fixed_t     gSlideY;            // Where the player move is starting from: y
 
 // PsyDoom: more than one special line can now be crossed per frame (depending on game settings)
 #if PSYDOOM_MODS
-    std::vector<line_t*> gpSpecialLines;    // The special lines that would be crossed by player movement
+    SIM_TLS std::vector<line_t*> gpSpecialLines;    // The special lines that would be crossed by player movement
 #else
     line_t* gpSpecialLine;                  // The special line that would be crossed by player movement
 #endif
 
-static fixed_t  gSlideDx;       // How much the player is wanting to move: x
-static fixed_t  gSlideDy;       // How much the player is wanting to move: y
-static fixed_t  gEndBox[4];     // Bounding box for the proposed movement
-static fixed_t  gBlockFrac;     // Percentage of the current move allowed
-static fixed_t  gBlockNvx;      // The vector to slide along for the line collided with: x
-static fixed_t  gBlockNvy;      // The vector to slide along for the line collided with: y
-static fixed_t  gNvx;           // Line being collided against, normalized normal: x
-static fixed_t  gNvy;           // Line being collided against, normalized normal: y
-static fixed_t  gP1x;           // Line being collided against, p1: x
-static fixed_t  gP1y;           // Line being collided against, p1: y
-static fixed_t  gP2x;           // Line being collided against, p2: x
-static fixed_t  gP2y;           // Line being collided against, p2: y
-static fixed_t  gP3x;           // Movement line, p1: x
-static fixed_t  gP3y;           // Movement line, p1: y
-static fixed_t  gP4x;           // Movement line, p2: x
-static fixed_t  gP4y;           // Movement line, p2: y
+static SIM_TLS fixed_t  gSlideDx;       // How much the player is wanting to move: x
+static SIM_TLS fixed_t  gSlideDy;       // How much the player is wanting to move: y
+static SIM_TLS fixed_t  gEndBox[4];     // Bounding box for the proposed movement
+static SIM_TLS fixed_t  gBlockFrac;     // Percentage of the current move allowed
+static SIM_TLS fixed_t  gBlockNvx;      // The vector to slide along for the line collided with: x
+static SIM_TLS fixed_t  gBlockNvy;      // The vector to slide along for the line collided with: y
+static SIM_TLS fixed_t  gNvx;           // Line being collided against, normalized normal: x
+static SIM_TLS fixed_t  gNvy;           // Line being collided against, normalized normal: y
+static SIM_TLS fixed_t  gP1x;           // Line being collided against, p1: x
+static SIM_TLS fixed_t  gP1y;           // Line being collided against, p1: y
+static SIM_TLS fixed_t  gP2x;           // Line being collided against, p2: x
+static SIM_TLS fixed_t  gP2y;           // Line being collided against, p2: y
+static SIM_TLS fixed_t  gP3x;           // Movement line, p1: x
+static SIM_TLS fixed_t  gP3y;           // Movement line, p1: y
+static SIM_TLS fixed_t  gP4x;           // Movement line, p2: x
+static SIM_TLS fixed_t  gP4y;           // Movement line, p2: y
 
 // Not required externally: making private to this module
 static fixed_t P_CompletableFrac(const fixed_t dx, const fixed_t dy) noexcept;
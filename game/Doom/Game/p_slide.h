@@ -1,12 +1,13 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct line_t;
 
-extern mobj_t*  gpSlideThing;
-extern fixed_t  gSlideX;
-extern fixed_t  gSlideY;
+extern SIM_TLS mobj_t*  gpSlideThing;
+extern SIM_TLS fixed_t  gSlideX;
+extern SIM_TLS fixed_t  gSlideY;
 
 // PsyDoom: more than one special line can now be crossed per frame (depending on game settings)
 #if PSYDOOM_MODS
@@ -28,6 +28,8 @@
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/Game.h"
 #include "PsyDoom/ParserTokenizer.h"
+#include "PsyDoom/Profiler.h"
+#include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/ScriptingEngine.h"
 
 #include <cstdlib>
@@ -74,35 +76,35 @@ static const animdef_t gBaseAnimDefs[BASE_NUM_ANIMS_FDOOM] = {
 // PsyDoom: anim definitions for the current game and user mod.
 // The list is now built dynamically at runtime.
 #if PSYDOOM_MODS
-    static std::vector<animdef_t> gAnimDefs;
+    static SIM_TLS std::vector<animdef_t> gAnimDefs;
 #else
     #define gAnimDefs gBaseAnimDefs
 #endif
 
-card_t      gMapBlueKeyType;        // What type of blue key the map uses (if map has a blue key)
-card_t      gMapRedKeyType;         // What type of red key the map uses (if map has a red key)
-card_t      gMapYellowKeyType;      // What type of yellow key the map uses (if map has a yellow key)
-int32_t     gMapBossSpecialFlags;   // PSX addition: What types of boss specials (triggers) are active on the current map
+SIM_TLS card_t      gMapBlueKeyType;        // What type of blue key the map uses (if map has a blue key)
+SIM_TLS card_t      gMapRedKeyType;         // What type of red key the map uses (if map has a red key)
+SIM_TLS card_t      gMapYellowKeyType;      // What type of yellow key the map uses (if map has a yellow key)
+SIM_TLS int32_t     gMapBossSpecialFlags;   // PSX addition: What types of boss specials (triggers) are active on the current map
 
 // The list of animated textures.
 // PsyDoom: this list is now allocated dynamically at runtime.
 #if PSYDOOM_MODS
-    static std::vector<anim_t> gAnims;
+    static SIM_TLS std::vector<anim_t> gAnims;
 #else
-    static anim_t gAnims[BASE_NUM_ANIMS_FDOOM];
+    static SIM_TLS anim_t gAnims[BASE_NUM_ANIMS_FDOOM];
 #endif
 
 // Points to the end of the list of animated textures
-static anim_t* gpLastAnim;
+static SIM_TLS anim_t* gpLastAnim;
 
 // PsyDoom: can now have as many scrolling lines as we want
 #if PSYDOOM_LIMIT_REMOVING
-    static std::vector<line_t*> gpLineSpecialList;      // A list of scrolling lines for the level
+    static SIM_TLS std::vector<line_t*> gpLineSpecialList;      // A list of scrolling lines for the level
 #else
     static constexpr int32_t MAXLINEANIMS = 32;         // Maximum number of line animations allowed
 
-    static line_t*  gpLineSpecialList[MAXLINEANIMS];    // A list of scrolling lines for the level
-    static int32_t  gNumLinespecials;                   // The number of scrolling lines in the level
+    static SIM_TLS line_t*  gpLineSpecialList[MAXLINEANIMS];    // A list of scrolling lines for the level
+    static SIM_TLS int32_t  gNumLinespecials;                   // The number of scrolling lines in the level
 #endif
 
 #if PSYDOOM_MODS
@@ -1288,6 +1290,10 @@ void P_PlayerInSpecialSector(player_t& player) noexcept {
 // PSX: also animates the fire sky if the level has that.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_UpdateSpecials() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_UpdateSpecials");
+    #endif
+
     // Animate flats and wall textures
     for (anim_t* pAnim = &gAnims[0]; pAnim < gpLastAnim; ++pAnim) {
         // Skip over this entry if it isn't time to advance the animation
@@ -1303,12 +1309,21 @@ void P_UpdateSpecials() noexcept {
 
         // Update the texture translation table and mark the texture as needing uploading to the cache.
         // For animated flats and walls only the current frame is kept in VRAM, to save on precious VRAM space.
+        // PsyDoom: if using the Vulkan renderer's texture atlas then the frame must also be decoded again, since other frames share its VRAM.
         if (pAnim->istexture) {
             gpTextureTranslation[pAnim->basepic] = pAnim->current;
             gpTextures[pAnim->current].uploadFrameNum = TEX_INVALID_UPLOAD_FRAME_NUM;
+
+            #if PSYDOOM_VULKAN_RENDERER
+                gpTextures[pAnim->current].bIsInVkTexAtlas = false;
+            #endif
         } else {
             gpFlatTranslation[pAnim->basepic] = pAnim->current;
             gpFlatTextures[pAnim->current].uploadFrameNum = TEX_INVALID_UPLOAD_FRAME_NUM;
+
+            #if PSYDOOM_VULKAN_RENDERER
+                gpFlatTextures[pAnim->current].bIsInVkTexAtlas = false;
+            #endif
         }
     }
 
@@ -1575,8 +1590,21 @@ void P_SpawnSpecials() noexcept {
     for (int32_t sectorIdx = 0; sectorIdx < gNumSectors; ++sectorIdx) {
         sector_t& sector = gpSectors[sectorIdx];
 
-        if (!sector.special)
+        if (!sector.special) {
+            // PsyDoom: if benchmarking light thinkers then give every sector without a special an animated light, cycling through each type
+            #if PSYDOOM_MODS
+                if (ProgArgs::gbLightBenchmark) {
+                    switch (sectorIdx % 4) {
+                        case 0:     P_SpawnFireFlicker(sector);                     break;
+                        case 1:     P_SpawnLightFlash(sector);                      break;
+                        case 2:     P_SpawnStrobeFlash(sector, FASTDARK, false);    break;
+                        default:    P_SpawnGlowingLight(sector, glowtolower);       break;
+                    }
+                }
+            #endif
+
             continue;
+        }
 
         switch (sector.special) {
             case 1:     P_SpawnLightFlash(sector);                      break;  // Flickering lights
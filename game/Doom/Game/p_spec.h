@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct line_t;
 struct side_t;
@@ -31,10 +32,10 @@ struct delayaction_t {
     delayed_actionfn_t  actionfunc;     // The action to perform after the delay
 };
 
-extern card_t   gMapBlueKeyType;
-extern card_t   gMapRedKeyType;
-extern card_t   gMapYellowKeyType;
-extern int32_t  gMapBossSpecialFlags;
+extern SIM_TLS card_t   gMapBlueKeyType;
+extern SIM_TLS card_t   gMapRedKeyType;
+extern SIM_TLS card_t   gMapYellowKeyType;
+extern SIM_TLS int32_t  gMapBossSpecialFlags;
 
 #if PSYDOOM_MODS
     void P_InitAnimDefs() noexcept;
@@ -89,7 +89,7 @@ static constexpr int32_t BASE_NUM_SWITCHES = C_ARRAY_SIZE(gBaseAlphSwitchList);
 // PsyDoom: switch definitions for the current game and user mod.
 // The list is now built dynamically at runtime.
 #if PSYDOOM_MODS
-    static std::vector<switchlist_t> gAlphSwitchList;
+    static SIM_TLS std::vector<switchlist_t> gAlphSwitchList;
 #else
     #define gAlphSwitchList gBaseAlphSwitchList
 #endif
@@ -100,17 +100,17 @@ static constexpr int32_t BUTTONTIME = 1 * TICRATE;
 // The list of currently active buttons/switches.
 // PsyDoom limit removing: std::vector all the things! :D
 #if PSYDOOM_LIMIT_REMOVING
-    std::vector<button_t> gButtonList;
+    SIM_TLS std::vector<button_t> gButtonList;
 #else
-    button_t gButtonList[MAXBUTTONS];
+    SIM_TLS button_t gButtonList[MAXBUTTONS];
 #endif
 
 // The 2 lumps for each switch texture in the game.
 // PsyDoom: this list is now built dynamically based on built-in and user switch definitions.
 #if PSYDOOM_MODS
-    static std::vector<int32_t> gSwitchList;
+    static SIM_TLS std::vector<int32_t> gSwitchList;
 #else
-    static int32_t gSwitchList[BASE_NUM_SWITCHES * 2];
+    static SIM_TLS int32_t gSwitchList[BASE_NUM_SWITCHES * 2];
 #endif
 
 #if PSYDOOM_MODS
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <vector>
 
@@ -24,13 +25,13 @@ struct button_t {
 };
 
 #if PSYDOOM_LIMIT_REMOVING
-    extern std::vector<button_t> gButtonList;
+    extern SIM_TLS std::vector<button_t> gButtonList;
 #else
     // How many buttons can be active at a time (to be switched back to their original state).
     // This limit was inherited from PC DOOM where the thinking was that 4x buttons for 4x players was more than enough.
     static constexpr int32_t MAXBUTTONS = 16;
 
-    extern button_t gButtonList[MAXBUTTONS];
+    extern SIM_TLS button_t gButtonList[MAXBUTTONS];
 #endif
 
 #if PSYDOOM_MODS
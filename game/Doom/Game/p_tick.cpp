@@ -20,6 +20,8 @@
 #include "g_game.h"
 #include "info.h"
 #include "p_base.h"
+#include "p_blockthings.h"
+#include "p_lights.h"
 #include "p_local.h"
 #include "p_mobj.h"
 #include "p_sight.h"
@@ -33,9 +35,12 @@
 #include "PsyDoom/DevMapAutoReloader.h"
 #include "PsyDoom/Game.h"
 #include "PsyDoom/MapInfo/MapInfo.h"
+#include "PsyDoom/NetRollback.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/PsxPadButtons.h"
+#include "PsyDoom/Rewind.h"
 #include "PsyDoom/SaveAndLoad.h"
 #include "PsyDoom/ScriptingEngine.h"
 #include "PsyDoom/Video.h"
@@ -76,34 +81,35 @@ static constexpr CheatSequence CHEAT_SEQUENCES[] = {
 
 static_assert(NUM_CHEAT_SEQ == C_ARRAY_SIZE(CHEAT_SEQUENCES));
 
-int32_t     gVBlanksUntilMenuMove[MAXPLAYERS];      // How many 1 vblank ticks until we can move the cursor on the menu (one slot for each player)
-bool        gbGamePaused;                           // Whether the game is currently paused by either player
-int32_t     gPlayerNum;                             // Current player number being updated/processed
-int32_t     gMapNumToCheatWarpTo;                   // What map the player currently has selected for cheat warp
-int32_t     gVramViewerTexPage;                     // What page of texture memory to display in the VRAM viewer
-thinker_t   gThinkerCap;                            // Dummy thinker which serves as both the head and tail of the thinkers list.
-mobj_t      gMobjHead;                              // Dummy map object which serves as both the head and tail of the map objects linked list.
-int32_t     gCurCheatBtnSequenceIdx;                // What button press in the cheat sequence we are currently on
-int32_t     gTicConOnPause;                         // What 1 vblank tick we paused on, used to discount paused time on unpause
+SIM_TLS int32_t     gVBlanksUntilMenuMove[MAXPLAYERS];      // How many 1 vblank ticks until we can move the cursor on the menu (one slot for each player)
+SIM_TLS bool        gbGamePaused;                           // Whether the game is currently paused by either player
+SIM_TLS int32_t     gPlayerNum;                             // Current player number being updated/processed
+SIM_TLS int32_t     gMapNumToCheatWarpTo;                   // What map the player currently has selected for cheat warp
+SIM_TLS int32_t     gVramViewerTexPage;                     // What page of texture memory to display in the VRAM viewer
+SIM_TLS thinker_t   gThinkerCap;                            // Dummy thinker which serves as both the head and tail of the thinkers list.
+SIM_TLS mobj_t      gMobjHead;                              // Dummy map object which serves as both the head and tail of the map objects linked list.
+SIM_TLS int32_t     gCurCheatBtnSequenceIdx;                // What button press in the cheat sequence we are currently on
+SIM_TLS int32_t     gTicConOnPause;                         // What 1 vblank tick we paused on, used to discount paused time on unpause
 
 // PsyDoom: PSX gamepad button presses are now confined to just this player, and are just used for entering the original cheat sequences.
 // For a networked game we use the tick inputs sent across with each packet.
 #if PSYDOOM_MODS
-    TickInputs  gTickInputs[MAXPLAYERS];        // Current tick inputs for the current 30 Hz tick
-    TickInputs  gOldTickInputs[MAXPLAYERS];     // Previous tick inputs for the last 30 Hz tick
-    TickInputs  gNextTickInputs;                // Network games only: what inputs we told the other player we will use next; sent ahead of time to reduce lag
-    uint32_t    gTicButtons;                    // Currently PSX pad buttons for this player
-    uint32_t    gOldTicButtons;                 // Previously pressed PSX buttons for this player
-    bool        gbIgnoreCurrentAttack;          // A flag set to prevent accidental firing on returning to the game - causes attack to be ignored until the key is released
-    bool        gbDoQuicksave;                  // A flag set to perform a quicksave at the next available opportunity (15 Hz tick)
-    bool        gbDoQuickload;                  // A flag set to perform a quicksave at the next available opportunity (15 Hz tick)
+    SIM_TLS TickInputs  gTickInputs[MAXPLAYERS];        // Current tick inputs for the current 30 Hz tick
+    SIM_TLS TickInputs  gOldTickInputs[MAXPLAYERS];     // Previous tick inputs for the last 30 Hz tick
+    SIM_TLS TickInputs  gNextTickInputs;                // Network games only: what inputs we told the other player we will use next; sent ahead of time to reduce lag
+    SIM_TLS uint32_t    gTicButtons;                    // Currently PSX pad buttons for this player
+    SIM_TLS uint32_t    gOldTicButtons;                 // Previously pressed PSX buttons for this player
+    SIM_TLS bool        gbIgnoreCurrentAttack;          // A flag set to prevent accidental firing on returning to the game - causes attack to be ignored until the key is released
+    SIM_TLS bool        gbDoQuicksave;                  // A flag set to perform a quicksave at the next available opportunity (15 Hz tick)
+    SIM_TLS bool        gbDoQuickload;                  // A flag set to perform a quicksave at the next available opportunity (15 Hz tick)
+    SIM_TLS bool        gbDoRewind;                     // A flag set to rewind the game state at the next available opportunity (15 Hz tick)
 #else
-    uint32_t    gTicButtons[MAXPLAYERS];        // Currently pressed buttons by all players
-    uint32_t    gOldTicButtons[MAXPLAYERS];     // Previously pressed buttons by all players
+    SIM_TLS uint32_t    gTicButtons[MAXPLAYERS];        // Currently pressed buttons by all players
+    SIM_TLS uint32_t    gOldTicButtons[MAXPLAYERS];     // Previously pressed buttons by all players
 #endif
 
-static uint16_t     gCheatSequenceBtns[CHEAT_SEQ_LEN];      // Cheat sequence buttons inputted by the player
-static int32_t      gNumActiveThinkers;                     // Stat tracking count, no use other than that
+static SIM_TLS uint16_t     gCheatSequenceBtns[CHEAT_SEQ_LEN];      // Cheat sequence buttons inputted by the player
+static SIM_TLS int32_t      gNumActiveThinkers;                     // Stat tracking count, no use other than that
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Add a thinker to the linked list of thinkers
@@ -113,6 +119,11 @@ void P_AddThinker(thinker_t& thinker) noexcept {
     thinker.next = &gThinkerCap;
     thinker.prev = gThinkerCap.prev;
     gThinkerCap.prev = &thinker;
+
+    // PsyDoom: the new thinker might be a light thinker (its function may not be set yet), so it needs to be scanned for new light runs
+    #if PSYDOOM_MODS
+        P_OnThinkerAdded(thinker);
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -120,6 +131,20 @@ void P_AddThinker(thinker_t& thinker) noexcept {
 // The removal happens later, during updates.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_RemoveThinker(thinker_t& thinker) noexcept {
+    // PsyDoom: if a light thinker is being removed then the runs of light thinkers must be rebuilt
+    #if PSYDOOM_MODS
+        const bool bIsLightThinker = (
+            (thinker.function == (think_t) &T_FireFlicker) ||
+            (thinker.function == (think_t) &T_LightFlash) ||
+            (thinker.function == (think_t) &T_StrobeFlash) ||
+            (thinker.function == (think_t) &T_Glow)
+        );
+
+        if (bIsLightThinker) {
+            P_InvalidateLightThinkerRuns();
+        }
+    #endif
+
     thinker.function = (think_t)(intptr_t) -1;
 }
 
@@ -127,13 +152,36 @@ void P_RemoveThinker(thinker_t& thinker) noexcept {
 // Execute think logic for all thinkers
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_RunThinkers() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_RunThinkers");
+    #endif
+
     gNumActiveThinkers = 0;
 
+    // PsyDoom: runs of consecutive light thinkers are updated in batches, which gives the same results as updating them one at a time
+    #if PSYDOOM_MODS
+        P_BeginLightThinkerRuns();
+    #endif
+
     for (thinker_t* pThinker = gThinkerCap.next; pThinker != &gThinkerCap; pThinker = pThinker->next) {
+        #if PSYDOOM_MODS
+            if (pThinker == gpNextLightThinkerRun) {
+                int32_t numThinkersRun = 0;
+                pThinker = &P_RunNextLightThinkerRun(numThinkersRun);
+                gNumActiveThinkers += numThinkersRun;
+                continue;
+            }
+        #endif
+
         if ((intptr_t) pThinker->function == (intptr_t) -1) {
             // Time to remove this thinker, it's function has been zapped
             pThinker->next->prev = pThinker->prev;
             pThinker->prev->next = pThinker->next;
+
+            #if PSYDOOM_MODS
+                P_OnThinkerUnlinked(*pThinker);
+            #endif
+
             Z_Free2(*gpMainMemZone, pThinker);
         } else {
             // Run the thinker if it has a think function and increment the active count stat
@@ -150,6 +198,10 @@ void P_RunThinkers() noexcept {
 // Execute the 'late call' update function for all map objects
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_RunMobjLate() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_RunMobjLate");
+    #endif
+
     for (mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
         if (pMobj->latecall) {
             pMobj->latecall(*pMobj);
@@ -647,6 +699,10 @@ void P_CheckCheats() noexcept {
 // High level tick/update logic for main gameplay
 //------------------------------------------------------------------------------------------------------------------------------------------
 gameaction_t P_Ticker() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_Ticker");
+    #endif
+
     gGameAction = ga_nothing;
 
     #if PSYDOOM_MODS
@@ -661,8 +717,8 @@ gameaction_t P_Ticker() noexcept {
             return gGameAction;
         }
 
-        // PsyDoom: check for uncapped framerate toggle
-        if (Controls::isJustPressed(Controls::Binding::Toggle_UncappedFps)) {
+        // PsyDoom: check for uncapped framerate toggle (ignored when re-simulating frames for rollback netcode)
+        if (Controls::isJustPressed(Controls::Binding::Toggle_UncappedFps) && (!NetRollback::isResimulating())) {
             PlayerPrefs::gbUncapFramerate = (!PlayerPrefs::gbUncapFramerate);
             gStatusBar.message = (PlayerPrefs::gbUncapFramerate) ? "Uncapped FPS" : "Original FPS";
             gStatusBar.messageTicsLeft = 30;
@@ -781,6 +837,23 @@ gameaction_t P_Ticker() noexcept {
             gbDoQuicksave = false;
             gbDoQuickload = false;
         }
+
+        // PsyDoom: rewind if requested, otherwise take a snapshot for rewinding if it's time.
+        // Nothing is done if the level is being exited. If rewinding fails midway through restoring the game state then restart the
+        // current map to try and recover.
+        if ((gNetGame == gt_single) && (gGameTic > gPrevGameTic)) {
+            if (gGameAction == ga_nothing) {
+                if (gbDoRewind) {
+                    if (!Rewind::rewind()) {
+                        gGameAction = ga_restart;
+                    }
+                } else if (!gbGamePaused) {
+                    Rewind::update();
+                }
+            }
+
+            gbDoRewind = false;
+        }
     #endif
 
     return gGameAction;
@@ -790,6 +863,10 @@ gameaction_t P_Ticker() noexcept {
 // Does all drawing for main gameplay
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_Drawer() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("P_Drawer");
+    #endif
+
     // PsyDoom: no drawing in headless mode, but do advance the elapsed time.
     // Keep the framerate at the appropriate amount (for PAL or NTSC mode) for consistent demo playback.
     #if PSYDOOM_MODS
@@ -801,6 +878,17 @@ void P_Drawer() noexcept {
             gElapsedVBlanks = demoTickVBlanks;
             return;
         }
+
+        // PsyDoom: skip drawing most frames while fast forwarding demo playback so the simulation runs uncapped.
+        // Keep the vblank counters in sync with real time however, so normal frame pacing resumes smoothly afterwards.
+        if (DemoPlayer::shouldSkipDrawing()) {
+            const int32_t demoTickVBlanks = (Game::gSettings.bUsePalTimings) ? 3 : VBLANKS_PER_TIC;
+
+            gTotalVBlanks = I_GetTotalVBlanks();
+            gLastTotalVBlanks = gTotalVBlanks;
+            gElapsedVBlanks = demoTickVBlanks;
+            return;
+        }
     #endif
 
     I_IncDrawnFrameCount();
@@ -906,6 +994,10 @@ void P_Start() noexcept {
             gbAutoSaveOnLevelStart = false;
             SaveGameForSlot(SaveFileSlot::AUTOSAVE, SaveGameContext::Autosave);
         }
+
+        // PsyDoom: take the initial snapshot for rewinding (if enabled) and allow rollback netcode to predict frames
+        Rewind::onLevelStart();
+        NetRollback::onLevelStart();
     #endif
 }
 
@@ -913,16 +1005,21 @@ void P_Start() noexcept {
 // Shuts down main gameplay
 //------------------------------------------------------------------------------------------------------------------------------------------
 void P_Stop([[maybe_unused]] const gameaction_t exitAction) noexcept {
-    // PsyDoom: end the level timer
+    // PsyDoom: end the level timer and discard all rewind snapshots
     #if PSYDOOM_MODS
         Game::stopLevelTimer();
+        Rewind::onLevelEnd();
     #endif
 
     // Finish up any GPU related work
     LIBGPU_DrawSync(0);
 
-    // PsyDoom: save/check demo result if requested
+    // PsyDoom: record the final game state of demo playback and save/check the demo result if requested
     #if PSYDOOM_MODS
+        if (gbDemoPlayback) {
+            DemoPlayer::onBeforeMapUnload();
+        }
+
         if (gbDemoPlayback || gbDemoRecording) {
             if (ProgArgs::gSaveDemoResultFilePath[0]) {
                 DemoResult::saveToJsonFile(ProgArgs::gSaveDemoResultFilePath);
@@ -966,7 +1063,7 @@ void P_Stop([[maybe_unused]] const gameaction_t exitAction) noexcept {
         DevMapAutoReloader::shutdown();
     #endif
 
-    // PsyDoom: shut down the map object weak referencing system.
+    // PsyDoom: shut down the map object weak referencing system and the compact arrays of things for each blockmap cell.
     // Also cleanup all map objects to remove all usage of weak reference counts before we shutdown the system.
     #if PSYDOOM_MODS
         if (gMobjHead.next) {
@@ -976,6 +1073,7 @@ void P_Stop([[maybe_unused]] const gameaction_t exitAction) noexcept {
         }
 
         P_ShutdownWeakRefs();
+        P_ShutdownBlockThings();
     #endif
 }
 
@@ -1052,6 +1150,7 @@ void P_GatherTickInputs(TickInputs& inputs) noexcept {
     inputs.fDeletePasswordChar() = Controls::getBool(Controls::Binding::Menu_DeletePasswordChar);
     inputs.fQuicksave() = Controls::getBool(Controls::Binding::Quicksave);
     inputs.fQuickload() = Controls::getBool(Controls::Binding::Quickload);
+    inputs.fRewind() = Controls::getBool(Controls::Binding::Rewind);
 
     // Allow toggle of autorun if the right button is pressed
     if (Controls::isJustPressed(Controls::Binding::Toggle_Autorun)) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 typedef uint32_t padbuttons_t;
 
@@ -38,28 +39,29 @@ enum cheatseq_t : int32_t {
     NUM_CHEAT_SEQ
 };
 
-extern int32_t      gVBlanksUntilMenuMove[MAXPLAYERS];
-extern bool         gbGamePaused;
-extern int32_t      gPlayerNum;
-extern int32_t      gMapNumToCheatWarpTo;
-extern int32_t      gVramViewerTexPage;
-extern thinker_t    gThinkerCap;
-extern mobj_t       gMobjHead;
-extern int32_t      gCurCheatBtnSequenceIdx;
-extern int32_t      gTicConOnPause;
+extern SIM_TLS int32_t      gVBlanksUntilMenuMove[MAXPLAYERS];
+extern SIM_TLS bool         gbGamePaused;
+extern SIM_TLS int32_t      gPlayerNum;
+extern SIM_TLS int32_t      gMapNumToCheatWarpTo;
+extern SIM_TLS int32_t      gVramViewerTexPage;
+extern SIM_TLS thinker_t    gThinkerCap;
+extern SIM_TLS mobj_t       gMobjHead;
+extern SIM_TLS int32_t      gCurCheatBtnSequenceIdx;
+extern SIM_TLS int32_t      gTicConOnPause;
 
 #if PSYDOOM_MODS
-    extern TickInputs   gTickInputs[MAXPLAYERS];
-    extern TickInputs   gOldTickInputs[MAXPLAYERS];
-    extern TickInputs   gNextTickInputs;
-    extern uint32_t     gTicButtons;
-    extern uint32_t     gOldTicButtons;
-    extern bool         gbIgnoreCurrentAttack;
-    extern bool         gbDoQuicksave;
-    extern bool         gbDoQuickload;
+    extern SIM_TLS TickInputs   gTickInputs[MAXPLAYERS];
+    extern SIM_TLS TickInputs   gOldTickInputs[MAXPLAYERS];
+    extern SIM_TLS TickInputs   gNextTickInputs;
+    extern SIM_TLS uint32_t     gTicButtons;
+    extern SIM_TLS uint32_t     gOldTicButtons;
+    extern SIM_TLS bool         gbIgnoreCurrentAttack;
+    extern SIM_TLS bool         gbDoQuicksave;
+    extern SIM_TLS bool         gbDoQuickload;
+    extern SIM_TLS bool         gbDoRewind;
 #else
-    extern uint32_t     gTicButtons[MAXPLAYERS];
-    extern uint32_t     gOldTicButtons[MAXPLAYERS];
+    extern SIM_TLS uint32_t     gTicButtons[MAXPLAYERS];
+    extern SIM_TLS uint32_t     gOldTicButtons[MAXPLAYERS];
 #endif
 
 void P_AddThinker(thinker_t& thinker) noexcept;
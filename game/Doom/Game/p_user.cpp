@@ -69,7 +69,7 @@ static constexpr int32_t TURN_TO_ANGLE_SHIFT    = 17;
 static constexpr fixed_t MAXBOB                 = 16 * FRACUNIT;                    // Maximum amount of view bobbing per frame (16 pixels)
 
 // Flag set to true when the player is on the ground
-static bool gbOnGround;
+static SIM_TLS bool gbOnGround;
 
 #if PSYDOOM_MODS
     // Convenience typedef
@@ -78,15 +78,15 @@ static bool gbOnGround;
     // How much turning done which hasn't been merged into the player's map object.
     // This eventually gets rolled into the player's actual angle, but is used in the intermediate to update the renderer.
     // It basically allows for framerate uncapped turning movement with very little latency, outside of the 30 Hz update loop.
-    angle_t gPlayerUncommittedTurning;
+    SIM_TLS angle_t gPlayerUncommittedTurning;
 
     // Only used in network games: the view angle the player will use on the next frame.
     // Used in networked games to preserve any turning the user did, even though it won't be used until the next frame.
     // The view angle for rendering is allowed to be 1 frame ahead of where it actually is.
-    angle_t gPlayerNextTickViewAngle;
+    SIM_TLS angle_t gPlayerNextTickViewAngle;
 
     // When we last did framerate uncapped turning movements for the current player
-    static time_point_t gLastPlayerTurnTime;
+    static SIM_TLS time_point_t gLastPlayerTurnTime;
 #endif
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -893,7 +893,7 @@ void P_PlayerThink(player_t& player) noexcept {
         #endif
     }
 
-    // PsyDoom: check for quick save and load keys in singleplayer
+    // PsyDoom: check for quick save and load and rewind keys in singleplayer
     #if PSYDOOM_MODS
         if (gNetGame == gt_single) {
             if (inputs.fQuicksave() && (!oldInputs.fQuicksave())) {
@@ -907,6 +907,10 @@ void P_PlayerThink(player_t& player) noexcept {
             if (inputs.fQuickload() && (!oldInputs.fQuickload())) {
                 gbDoQuickload = true;
             }
+
+            if (inputs.fRewind() && (!oldInputs.fRewind())) {
+                gbDoRewind = true;
+            }
         }
     #endif
 
@@ -1071,6 +1075,21 @@ void P_PlayerThink(player_t& player) noexcept {
 }
 
 #if PSYDOOM_MODS
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: tells if the current player is allowed to do framerate uncapped turning.
+// Only allow this if the player is not dead, the game is active, and if we're not doing a demo.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool P_PlayerCanTurn() noexcept {
+    const player_t& player = gPlayers[gCurPlayerIndex];
+
+    return (
+        (!gbDemoPlayback) &&
+        (player.playerstate == PST_LIVE) &&
+        (player.mo && (player.mo->reactiontime <= 0)) &&    // Disallow turning for a little bit after teleporting (original movement code did this too)
+        (!gbGamePaused)
+    );
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // PsyDoom: initialize the new (framerate uncapped) turning system for the current player
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1089,21 +1108,14 @@ void P_PlayerDoTurning() noexcept {
     const player_t& player = gPlayers[gCurPlayerIndex];
     const bool bFinalDoomMovementMode = Game::gSettings.bUseFinalDoomPlayerMovement;
 
-    // Only do these turning updates if the player is not dead, the game is active, and if we're not doing a demo.
+    // Only do these turning updates if the player is allowed to turn.
     //
     // IMPORTANT: I previously had a call to 'Input::update()' here to get the very latest inputs but that caused bugs
     // and it should NOT be added back in. If inputs are updated here then any new events received might be consumed prior
     // to rendering, because we consume used input events once the game tick is processed. The rule of thumb is that no
     // event polling should be done WHILE game logic is being processed. Inputs should only be updated BEFORE the tick starts.
     //
-    const bool bCanTurn = (
-        (!gbDemoPlayback) &&
-        (player.playerstate == PST_LIVE) &&
-        (player.mo && (player.mo->reactiontime <= 0)) &&    // Disallow turning for a little bit after teleporting (original movement code did this too)
-        (!gbGamePaused)
-    );
-
-    if (bCanTurn) {
+    if (P_PlayerCanTurn()) {
         // Get how much time has elapsed in terms of 60 Hz ticks (NTSC vblanks).
         // Note that I'm deliberately NOT adjusting turn speed for PAL mode here, since turning is now independent of framerate anyway.
         // The 60 Hz reference point was just to scale the turn amount and treating PAL/NTSC the same keeps the turn speed consistent in both modes.
@@ -1186,6 +1198,25 @@ void P_PlayerDoTurning() noexcept {
     gLastPlayerTurnTime = now;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: returns extra turning for the current player's view from mouse movements which have been received since turning was last done.
+// Should be called immediately before the view angle is used for drawing, so the very latest mouse movements can be applied to the frame.
+//
+// Unlike 'P_PlayerDoTurning' this does NOT apply any input events to the input state and nothing is committed or consumed here: the same
+// mouse movements are applied as normal turning on the next 'P_PlayerDoTurning' call, in place of this turning.
+//------------------------------------------------------------------------------------------------------------------------------------------
+angle_t P_PlayerGetLateLatchTurning() noexcept {
+    if (!P_PlayerCanTurn())
+        return 0;
+
+    Input::pumpEvents();
+
+    const float axis = -Input::getPendingMouseXMovement();
+    const float turnSpeed = Config::gMouseTurnSpeed * PlayerPrefs::getTurnSpeedMultiplier();
+    const fixed_t turnAmt = (fixed_t)(turnSpeed * axis);
+    return (angle_t) d_lshift<TURN_TO_ANGLE_SHIFT>(turnAmt);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Called upon pausing the game; moves upcoming analog turning tick inputs back to being 'uncommitted' inputs.
 // Required to avoid the view snapping back when pausing while turning, because tick inputs are essentially discarded upon pause.
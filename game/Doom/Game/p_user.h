@@ -1,12 +1,13 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 struct player_t;
 
 #if PSYDOOM_MODS
-    extern angle_t gPlayerUncommittedTurning;
-    extern angle_t gPlayerNextTickViewAngle;
+    extern SIM_TLS angle_t gPlayerUncommittedTurning;
+    extern SIM_TLS angle_t gPlayerNextTickViewAngle;
 #endif
 
 void P_PlayerThink(player_t& player) noexcept;
@@ -14,5 +15,6 @@ void P_PlayerThink(player_t& player) noexcept;
 #if PSYDOOM_MODS
     void P_PlayerInitTurning() noexcept;
     void P_PlayerDoTurning() noexcept;
+    angle_t P_PlayerGetLateLatchTurning() noexcept;
     void P_UncommitTurningTickInputs() noexcept;
 #endif
@@ -3,6 +3,7 @@
 #if PSYDOOM_MODS
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <vector>
 
@@ -14,8 +15,8 @@ struct WeakCount {
     mobj_t*     pMobj;          // The object (weakly) pointed to
 };
 
-static std::vector<WeakCount>   gWeakCounts;            // Weak references to various map objects, some of these slots may be unused
-static std::vector<uint32_t>    gFreeWeakCountIdxs;     // Which weak count slots are currently free (by index)
+static SIM_TLS std::vector<WeakCount>   gWeakCounts;            // Weak references to various map objects, some of these slots may be unused
+static SIM_TLS std::vector<uint32_t>    gFreeWeakCountIdxs;     // Which weak count slots are currently free (by index)
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Tells if the specified weak count is still in use
@@ -17,20 +17,20 @@
 #include <unordered_map>
 #include <vector>
 
-const spritedef_t*  gSprites;       // Externally visible list of sprites in the game: just points to 'gSpriteDefs'
-int32_t             gNumSprites;    // Externally visible list of sprites in the game: gives the number of sprites in 'gSpriteDefs'
+SIM_TLS const spritedef_t*  gSprites;       // Externally visible list of sprites in the game: just points to 'gSpriteDefs'
+SIM_TLS int32_t             gNumSprites;    // Externally visible list of sprites in the game: gives the number of sprites in 'gSpriteDefs'
 
-static std::vector<spriteframe_t>                   gSpriteFrames;
-static std::vector<spritedef_t>                     gSpriteDefs;
-static std::unordered_map<uint32_t, spritedef_t*>   gSprNameToDef;      // LUT for accelerated lookup, use raw int as the key to avoid hashing difficulties
+static SIM_TLS std::vector<spriteframe_t>                   gSpriteFrames;
+static SIM_TLS std::vector<spritedef_t>                     gSpriteDefs;
+static SIM_TLS std::unordered_map<uint32_t, spritedef_t*>   gSprNameToDef;      // LUT for accelerated lookup, use raw int as the key to avoid hashing difficulties
 
 // PsyDoom: whether the sprites for certain enemies that are restored for PsyDoom are in the currently loaded wads.
 // These enemies were missing from PSX Doom vs the PC version of Doom II.
 #if PSYDOOM_MODS
-    bool gbHaveSprites_IconOfSin;
-    bool gbHaveSprites_ArchVile;
-    bool gbHaveSprites_Keen;
-    bool gbHaveSprites_WolfSS;
+    SIM_TLS bool gbHaveSprites_IconOfSin;
+    SIM_TLS bool gbHaveSprites_ArchVile;
+    SIM_TLS bool gbHaveSprites_Keen;
+    SIM_TLS bool gbHaveSprites_WolfSS;
 #endif
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "info.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 // Holds information for a sprite frame
 struct spriteframe_t {
@@ -23,18 +24,18 @@ struct spritedef_t {
 // The list of sprite sequences.
 // PsyDoom: the size of this list is now determined at runtime, and can expand depending on WADs loaded.
 #if PSYDOOM_MODS
-    extern const spritedef_t*   gSprites;
-    extern int32_t              gNumSprites;
+    extern SIM_TLS const spritedef_t*   gSprites;
+    extern SIM_TLS int32_t              gNumSprites;
 #else
-    extern const spritedef_t gSprites[BASE_NUM_SPRITES];
+    extern SIM_TLS const spritedef_t gSprites[BASE_NUM_SPRITES];
 #endif
 
 // Info on whether extended enemy sprites are present
 #if PSYDOOM_MODS
-    extern bool gbHaveSprites_IconOfSin;
-    extern bool gbHaveSprites_ArchVile;
-    extern bool gbHaveSprites_Keen;
-    extern bool gbHaveSprites_WolfSS;
+    extern SIM_TLS bool gbHaveSprites_IconOfSin;
+    extern SIM_TLS bool gbHaveSprites_ArchVile;
+    extern SIM_TLS bool gbHaveSprites_Keen;
+    extern SIM_TLS bool gbHaveSprites_WolfSS;
 #endif
 
 void P_InitSprites() noexcept;
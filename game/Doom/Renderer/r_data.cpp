@@ -11,34 +11,34 @@
 #include <memory>
 
 // Details about all of the textures in the game and the sky texture
-texture_t*  gpTextures;
-texture_t*  gpFlatTextures;
-texture_t*  gpSpriteTextures;
-texture_t*  gpSkyTexture;
+SIM_TLS texture_t*  gpTextures;
+SIM_TLS texture_t*  gpFlatTextures;
+SIM_TLS texture_t*  gpSpriteTextures;
+SIM_TLS texture_t*  gpSkyTexture;
 
 // Texture translation: converts from an input texture index to the actual texture index to render for that input index.
 // Used to implement animated textures whereby the translation is simply updated as the texture animates.
-int32_t*    gpTextureTranslation;
+SIM_TLS int32_t*    gpTextureTranslation;
 
 // Flat translation: similar function to texture translation except for flats rather than wall textures.
-int32_t*    gpFlatTranslation;
+SIM_TLS int32_t*    gpFlatTranslation;
 
 // The loaded lights lump
-light_t*    gpLightsLump;
+SIM_TLS light_t*    gpLightsLump;
 
 // Palette stuff
-uint16_t    gPaletteClutIds[MAXPALETTES];       // CLUT ids for all of the game's palettes. These are all held in VRAM.
-uint16_t    g3dViewPaletteClutId;               // Currently active in-game palette. Changes as effects are applied in the game.
+SIM_TLS uint16_t    gPaletteClutIds[MAXPALETTES];       // CLUT ids for all of the game's palettes. These are all held in VRAM.
+SIM_TLS uint16_t    g3dViewPaletteClutId;               // Currently active in-game palette. Changes as effects are applied in the game.
 
 // Lump counts
-int32_t     gNumTexLumps;
-int32_t     gNumFlatLumps;
-int32_t     gNumSpriteLumps;
+SIM_TLS int32_t     gNumTexLumps;
+SIM_TLS int32_t     gNumFlatLumps;
+SIM_TLS int32_t     gNumSpriteLumps;
 
 // PsyDoom: maps from main WAD lump indexes to a wall, flat or sprite texture
 #if PSYDOOM_MODS
-    static std::unique_ptr<texture_t*[]>    gpLumpToTex;
-    static int32_t                          gLumpToTexListSize;
+    static SIM_TLS std::unique_ptr<texture_t*[]>    gpLumpToTex;
+    static SIM_TLS int32_t                          gLumpToTexListSize;
 #endif
 
 // PsyDoom: texture, flat and sprite lists might no longer be a contiguous set of lumps
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PsyDoom/Sim/SimTls.h"
+
 #include <cstdint>
 #include <memory>
 
@@ -92,6 +94,14 @@ struct texture_t {
         uint32_t        uploadFrameNum;         // What frame the texture was added to the texture cache, used to detect texture cache overflows
     #endif
 
+    // PsyDoom: whether the texture has been decoded into the Vulkan renderer's texture atlas and the CLUT it was decoded with.
+    // This must be cleared whenever the texture's pixels in VRAM change or when it moves to a different location in VRAM.
+    #if PSYDOOM_VULKAN_RENDERER
+        bool        bIsInVkTexAtlas;
+        uint16_t    vkTexAtlasClutX;
+        uint16_t    vkTexAtlasClutY;
+    #endif
+
     // PsyDoom: helper that encapsulates/abstracts the logic for checking if a texture is in the cache.
     // This logic has changed slightly for PsyDoom, we no longer use the 'texPageId' field.
     bool isCached() const noexcept {
@@ -120,18 +130,18 @@ struct light_t {
     uint8_t     _pad;    // Does not appear to be used, always '0'
 };
 
-extern texture_t*   gpTextures;
-extern texture_t*   gpFlatTextures;
-extern texture_t*   gpSpriteTextures;
-extern texture_t*   gpSkyTexture;
-extern int32_t*     gpTextureTranslation;
-extern int32_t*     gpFlatTranslation;
-extern light_t*     gpLightsLump;
-extern uint16_t     gPaletteClutIds[MAXPALETTES];
-extern uint16_t     g3dViewPaletteClutId;
-extern int32_t      gNumTexLumps;
-extern int32_t      gNumFlatLumps;
-extern int32_t      gNumSpriteLumps;
+extern SIM_TLS texture_t*   gpTextures;
+extern SIM_TLS texture_t*   gpFlatTextures;
+extern SIM_TLS texture_t*   gpSpriteTextures;
+extern SIM_TLS texture_t*   gpSkyTexture;
+extern SIM_TLS int32_t*     gpTextureTranslation;
+extern SIM_TLS int32_t*     gpFlatTranslation;
+extern SIM_TLS light_t*     gpLightsLump;
+extern SIM_TLS uint16_t     gPaletteClutIds[MAXPALETTES];
+extern SIM_TLS uint16_t     g3dViewPaletteClutId;
+extern SIM_TLS int32_t      gNumTexLumps;
+extern SIM_TLS int32_t      gNumFlatLumps;
+extern SIM_TLS int32_t      gNumSpriteLumps;
 
 // PsyDoom: texture, flat and sprite lists might no longer be a contiguous set of lumps
 #if !PSYDOOM_MODS
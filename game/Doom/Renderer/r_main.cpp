@@ -12,6 +12,7 @@
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/Game.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyQ/LIBGPU.h"
 #include "PsyQ/LIBGTE.h"
 #include "r_bsp.h"
@@ -26,21 +27,21 @@
 #include <cmath>
 
 // Incremented whenever checks are made
-int32_t gValidCount = 1;
+SIM_TLS int32_t gValidCount = 1;
 
 // View properties
-player_t*   gpViewPlayer;
-fixed_t     gViewX;
-fixed_t     gViewY;
-fixed_t     gViewZ;
-angle_t     gViewAngle;
-fixed_t     gViewCos;
-fixed_t     gViewSin;
-bool        gbIsSkyVisible;
-MATRIX      gDrawMatrix;
+SIM_TLS player_t*   gpViewPlayer;
+SIM_TLS fixed_t     gViewX;
+SIM_TLS fixed_t     gViewY;
+SIM_TLS fixed_t     gViewZ;
+SIM_TLS angle_t     gViewAngle;
+SIM_TLS fixed_t     gViewCos;
+SIM_TLS fixed_t     gViewSin;
+SIM_TLS bool        gbIsSkyVisible;
+SIM_TLS MATRIX      gDrawMatrix;
 
 // Light properties
-bool gbDoViewLighting;
+SIM_TLS bool gbDoViewLighting;
 
 #if !PSYDOOM_MODS
     // PsyDoom: these are not used anymore with dual colored lighting.
@@ -53,43 +54,43 @@ bool gbDoViewLighting;
 
 // PsyDoom: the number of draw subsectors is now unlimited
 #if PSYDOOM_LIMIT_REMOVING
-    std::vector<subsector_t*> gpDrawSubsectors;
+    SIM_TLS std::vector<subsector_t*> gpDrawSubsectors;
 #else
     // The list of subsectors to draw and current position in the list.
     // The draw subsector count does not appear to be used for anything however... Maybe used in debug builds for stat tracking?
-    subsector_t*    gpDrawSubsectors[MAX_DRAW_SUBSECTORS];
+    SIM_TLS subsector_t*    gpDrawSubsectors[MAX_DRAW_SUBSECTORS];
     int32_t         gNumDrawSubsectors;
 #endif
 
-sector_t*       gpCurDrawSector;        // What sector is currently being drawn
-subsector_t**   gppEndDrawSubsector;    // Used to point to the last draw subsector in the list and iterate backwards
+SIM_TLS sector_t*       gpCurDrawSector;        // What sector is currently being drawn
+SIM_TLS subsector_t**   gppEndDrawSubsector;    // Used to point to the last draw subsector in the list and iterate backwards
 
 // PsyDoom: used for interpolation when the framerate is uncapped
 #if PSYDOOM_MODS
     typedef std::chrono::steady_clock frametimer_t;
 
-    static frametimer_t::time_point gCurPlayerFrameStartTime;   // When the current frame started for the player (30 Hz tics)
-    static frametimer_t::time_point gCurWorldFrameStartTime;    // When the current frame started for the world and mobjs (15 Hz tics)
+    static SIM_TLS frametimer_t::time_point gCurPlayerFrameStartTime;   // When the current frame started for the player (30 Hz tics)
+    static SIM_TLS frametimer_t::time_point gCurWorldFrameStartTime;    // When the current frame started for the world and mobjs (15 Hz tics)
 
-    fixed_t     gPlayerLerpFactor;      // 0-1 interpolation factor for the current draw frame (player only, 30 Hz tics)
-    fixed_t     gWorldLerpFactor;       // 0-1 interpolation factor for the current draw frame (world and mobj, 15 Hz tics)
-    fixed_t     gOldViewX;
-    fixed_t     gOldViewY;
-    fixed_t     gOldViewZ;
-    angle_t     gOldViewAngle;
-    fixed_t     gOldAutomapX;
-    fixed_t     gOldAutomapY;
-    fixed_t     gOldAutomapScale;
-    bool        gbSnapViewZInterpolation;
+    SIM_TLS fixed_t     gPlayerLerpFactor;      // 0-1 interpolation factor for the current draw frame (player only, 30 Hz tics)
+    SIM_TLS fixed_t     gWorldLerpFactor;       // 0-1 interpolation factor for the current draw frame (world and mobj, 15 Hz tics)
+    SIM_TLS fixed_t     gOldViewX;
+    SIM_TLS fixed_t     gOldViewY;
+    SIM_TLS fixed_t     gOldViewZ;
+    SIM_TLS angle_t     gOldViewAngle;
+    SIM_TLS fixed_t     gOldAutomapX;
+    SIM_TLS fixed_t     gOldAutomapY;
+    SIM_TLS fixed_t     gOldAutomapScale;
+    SIM_TLS bool        gbSnapViewZInterpolation;
 
     // How much of the current view 'z' value is due to the player being pushed by the world (lifts/crushers etc.).
     // We must interpolate this amount at a different rate for smooth motion because the world ticks at 15 Hz while the player ticks at 30 Hz.
-    fixed_t gViewPushedZ;
+    SIM_TLS fixed_t gViewPushedZ;
 
     // Whether the old view z value incorporates a component of motion from pushing by the world.
     // This affects how interpolation is calculated. On even 30 Hz player ticks it is 'false' and on odd ones it is 'true'.
     // It's basically 'false' for the frames where both the player AND the world tick.
-    bool gbOldViewZIsPushed;
+    SIM_TLS bool gbOldViewZIsPushed;
 #endif
 
 // PsyDoom: this is not declared in the 'i_main' header to avoid exposing the <chrono> library
@@ -131,6 +132,10 @@ void R_Init() noexcept {
 // Render the 3D view and also player weapons
 //------------------------------------------------------------------------------------------------------------------------------------------
 void R_RenderPlayerView() noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("R_RenderPlayerView");
+    #endif
+
     // If currently in fullbright mode (no lighting) then setup the light params now.
     // PsyDoom: we don't compute these globals anymore now that dual colored lighting can be used.
     #if !PSYDOOM_MODS
@@ -205,6 +210,9 @@ void R_RenderPlayerView() noexcept {
             } else {
                 gViewAngle = gPlayerNextTickViewAngle + gPlayerUncommittedTurning;
             }
+
+            // Also apply the very latest mouse movements received, which haven't been turned into player turning yet
+            gViewAngle += P_PlayerGetLateLatchTurning();
         } else {
             // User not currently in control: interpolate changes in player view angle
             gViewAngle = R_LerpAngle(gOldViewAngle, newViewAngle, lerp);
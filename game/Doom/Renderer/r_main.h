@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <vector>
 
@@ -23,17 +24,17 @@ struct node_t;
 struct side_t;
 struct subsector_t;
 
-extern int32_t          gValidCount;
-extern player_t*        gpViewPlayer;
-extern fixed_t          gViewX;
-extern fixed_t          gViewY;
-extern fixed_t          gViewZ;
-extern angle_t          gViewAngle;
-extern fixed_t          gViewCos;
-extern fixed_t          gViewSin;
-extern bool             gbIsSkyVisible;
-extern MATRIX           gDrawMatrix;
-extern bool             gbDoViewLighting;
+extern SIM_TLS int32_t          gValidCount;
+extern SIM_TLS player_t*        gpViewPlayer;
+extern SIM_TLS fixed_t          gViewX;
+extern SIM_TLS fixed_t          gViewY;
+extern SIM_TLS fixed_t          gViewZ;
+extern SIM_TLS angle_t          gViewAngle;
+extern SIM_TLS fixed_t          gViewCos;
+extern SIM_TLS fixed_t          gViewSin;
+extern SIM_TLS bool             gbIsSkyVisible;
+extern SIM_TLS MATRIX           gDrawMatrix;
+extern SIM_TLS bool             gbDoViewLighting;
 
 // PsyDoom: these are not used anymore with dual colored lighting.
 // They were only usable when sectors were guaranteed to have a single color.
@@ -46,28 +47,28 @@ extern bool             gbDoViewLighting;
 
 // PsyDoom: the number of draw subsectors is now unlimited
 #if PSYDOOM_LIMIT_REMOVING
-    extern std::vector<subsector_t*> gpDrawSubsectors;
+    extern SIM_TLS std::vector<subsector_t*> gpDrawSubsectors;
 #else
-    extern subsector_t*     gpDrawSubsectors[MAX_DRAW_SUBSECTORS];
+    extern SIM_TLS subsector_t*     gpDrawSubsectors[MAX_DRAW_SUBSECTORS];
     extern int32_t          gNumDrawSubsectors;
 #endif
 
-extern sector_t*        gpCurDrawSector;
-extern subsector_t**    gppEndDrawSubsector;
+extern SIM_TLS sector_t*        gpCurDrawSector;
+extern SIM_TLS subsector_t**    gppEndDrawSubsector;
 
 #if PSYDOOM_MODS
-    extern fixed_t      gPlayerLerpFactor;
-    extern fixed_t      gWorldLerpFactor;
-    extern fixed_t      gOldViewX;
-    extern fixed_t      gOldViewY;
-    extern fixed_t      gOldViewZ;
-    extern angle_t      gOldViewAngle;
-    extern fixed_t      gOldAutomapX;
-    extern fixed_t      gOldAutomapY;
-    extern fixed_t      gOldAutomapScale;
-    extern bool         gbSnapViewZInterpolation;
-    extern fixed_t      gViewPushedZ;
-    extern bool         gbOldViewZIsPushed;
+    extern SIM_TLS fixed_t      gPlayerLerpFactor;
+    extern SIM_TLS fixed_t      gWorldLerpFactor;
+    extern SIM_TLS fixed_t      gOldViewX;
+    extern SIM_TLS fixed_t      gOldViewY;
+    extern SIM_TLS fixed_t      gOldViewZ;
+    extern SIM_TLS angle_t      gOldViewAngle;
+    extern SIM_TLS fixed_t      gOldAutomapX;
+    extern SIM_TLS fixed_t      gOldAutomapY;
+    extern SIM_TLS fixed_t      gOldAutomapScale;
+    extern SIM_TLS bool         gbSnapViewZInterpolation;
+    extern SIM_TLS fixed_t      gViewPushedZ;
+    extern SIM_TLS bool         gbOldViewZIsPushed;
 #endif
 
 void R_Init() noexcept;
@@ -13,7 +13,7 @@
 #include <algorithm>
 
 // The CLUT to use for the sky
-uint16_t gPaletteClutId_CurMapSky;
+SIM_TLS uint16_t gPaletteClutId_CurMapSky;
 
 #if PSYDOOM_LIMIT_REMOVING
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PsyDoom/Sim/SimTls.h"
+
 #include <cstdint>
 
 struct leafedge_t;
@@ -8,7 +10,7 @@ struct subsector_t;
 // How many bits to chop off for viewing angles to get the X offset to apply to the sky
 static constexpr uint32_t ANGLETOSKYSHIFT = 22;
 
-extern uint16_t gPaletteClutId_CurMapSky;
+extern SIM_TLS uint16_t gPaletteClutId_CurMapSky;
 
 void R_DrawSky() noexcept;
 
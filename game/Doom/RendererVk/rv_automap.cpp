@@ -24,6 +24,7 @@
 #include "PsyDoom/Vulkan/VTypes.h"
 #include "rv_utils.h"
 
+#include <algorithm>
 #include <cmath>
 
 // The position and rotation to use for the player this frame on the automap, and the free camera position and camera zoom
@@ -34,6 +35,12 @@ static fixed_t gRvMap_AutomapX;
 static fixed_t gRvMap_AutomapY;
 static fixed_t gRvMap_AutomapScale;
 
+// The center of the automap view and how far the view extends from the center in map units (including a small margin), for culling
+static fixed_t gRvMap_ViewX;
+static fixed_t gRvMap_ViewY;
+static fixed_t gRvMap_HalfViewW;
+static fixed_t gRvMap_HalfViewH;
+
 // Automap colors to use if deliberately brightening automap lines for the Vulkan renderer.
 // The brightening is done to compensate for lines appearing dimmer, due to them being thinner at high resolutions.
 static constexpr uint32_t BRIGHT_AM_COLOR_RED       = 0xFF0000;
@@ -69,6 +76,44 @@ static void RV_CalcPlayerMapTransforms() noexcept {
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the area of the map that the automap view covers, for culling lines and things that are not visible
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void RV_CalcAutomapViewBounds() noexcept {
+    const player_t& player = gPlayers[gCurPlayerIndex];
+
+    if (player.automapflags & AF_FOLLOW) {
+        gRvMap_ViewX = gRvMap_AutomapX;
+        gRvMap_ViewY = gRvMap_AutomapY;
+    } else {
+        gRvMap_ViewX = gRvMap_PlayerX;
+        gRvMap_ViewY = gRvMap_PlayerY;
+    }
+
+    // Figure out the half size of the view in UI pixels: note that the view is centered at 128,100 (see the transform matrix) and can
+    // extend further to the left and right in widescreen mode.
+    const float xPadding = (Config::gbVulkanWidescreenEnabled) ? (VRenderer::gPsxCoordsFbX / VRenderer::gPsxCoordsFbW) * (float) SCREEN_W : 0.0f;
+    const float halfViewWPx = (float) HALF_SCREEN_W + xPadding + 8.0f;
+    const float halfViewHPx = (float) std::max(100, SCREEN_H - 100) + 8.0f;
+
+    // Convert to map units, saturating at small zoom levels
+    const double pxPerMapUnit = std::max((double) RV_FixedToFloat(gRvMap_AutomapScale) / (double) SCREEN_W, 1e-6);
+    gRvMap_HalfViewW = (fixed_t) std::min((double) halfViewWPx / pxPerMapUnit * (double) FRACUNIT, (double) INT32_MAX);
+    gRvMap_HalfViewH = (fixed_t) std::min((double) halfViewHPx / pxPerMapUnit * (double) FRACUNIT, (double) INT32_MAX);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if a thing at the given position is too far outside of the automap view to be visible
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool RV_IsAutomapThingCulled(const fixed_t x, const fixed_t y) noexcept {
+    const int64_t dx = (int64_t) x - gRvMap_ViewX;
+    const int64_t dy = (int64_t) y - gRvMap_ViewY;
+    const int64_t cullDistX = (int64_t) gRvMap_HalfViewW + AM_THING_TRI_SIZE * FRACUNIT;
+    const int64_t cullDistY = (int64_t) gRvMap_HalfViewH + AM_THING_TRI_SIZE * FRACUNIT;
+
+    return ((dx < -cullDistX) || (dx > cullDistX) || (dy < -cullDistY) || (dy > cullDistY));
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Sets the transform matrix for rendering the automap
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -125,16 +170,17 @@ static void RV_AddAutomapLine(const uint32_t color, const float x1, const float
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Draws all visible map lines
+// Draws all visible map lines.
+// Only lines in the cells of the automap grid which overlap the view are considered, and their cached coordinates are used.
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void RV_DrawMapLines() noexcept {
     const player_t& curPlayer = gPlayers[gCurPlayerIndex];
     const bool bBrightLines = Config::gbVulkanBrightenAutomap;
 
-    const int32_t numLines = gNumLines;
     const line_t* const pLines = gpLines;
+    const std::vector<int32_t>& linesInView = AM_GetLinesInView(gRvMap_ViewX, gRvMap_ViewY, gRvMap_HalfViewW, gRvMap_HalfViewH);
 
-    for (int32_t lineIdx = 0; lineIdx < numLines; ++lineIdx) {
+    for (const int32_t lineIdx : linesInView) {
         // See whether we should draw the automap line or not
         const line_t& line = pLines[lineIdx];
 
@@ -148,12 +194,7 @@ static void RV_DrawMapLines() noexcept {
             continue;
 
         // Get the line point coords in float format
-        const vertex_t& v1 = *line.vertex1;
-        const vertex_t& v2 = *line.vertex2;
-        const float x1 = RV_FixedToFloat(v1.x);
-        const float y1 = RV_FixedToFloat(v1.y);
-        const float x2 = RV_FixedToFloat(v2.x);
-        const float y2 = RV_FixedToFloat(v2.y);
+        const amlinecoords_t& coords = AM_GetLineCoords(lineIdx);
 
         // Decide on line color: start off with the normal two sided line color to begin with
         uint32_t color;
@@ -178,7 +219,7 @@ static void RV_DrawMapLines() noexcept {
             color = (bBrightLines) ? BRIGHT_AM_COLOR_BROWN : AM_COLOR_BROWN;
         }
 
-        RV_AddAutomapLine(color, x1, y1, x2, y2);
+        RV_AddAutomapLine(color, coords.x1, coords.y1, coords.x2, coords.y2);
     }
 }
 
@@ -190,13 +231,17 @@ static void RV_DrawAutomapShowAllThingsCheat() noexcept {
     const mobj_t& playerMobj = *curPlayer.mo;
 
     for (mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
-        // Ignore the player for this particular draw
+        // Ignore the player for this particular draw, and things outside of the view
         if (pMobj == &playerMobj)
             continue;
 
-        // Compute the the sine and cosines for the angles of the 3 points in the triangle
         mobj_t& mobj = *pMobj;
 
+        if (RV_IsAutomapThingCulled(mobj.x.renderValue(), mobj.y.renderValue()))
+            continue;
+
+        // Compute the the sine and cosines for the angles of the 3 points in the triangle
+
         const float ang1 = RV_AngleToFloat(mobj.angle);
         const float ang2 = RV_AngleToFloat(mobj.angle - ANG90 - ANG45);
         const float ang3 = RV_AngleToFloat(mobj.angle + ANG90 + ANG45);
@@ -296,6 +341,7 @@ void RV_DrawAutomap() noexcept {
 
     // Compute player map transforms, setup the draw transform matrix and switch to drawing lines
     RV_CalcPlayerMapTransforms();
+    RV_CalcAutomapViewBounds();
     RV_SetupAutomapTransformMatrix();
     VDrawing::setDrawPipeline(VPipelineType::Lines);
 
@@ -19,8 +19,10 @@
 
 #include <cmath>
 
-static int32_t gNextFloorDrawSubsecIdx;     // Index of the next draw subsector to have its floor drawn
-static int32_t gNextCeilDrawSubsecIdx;      // Index of the next draw subsector to have its ceiling drawn
+// Index of the next draw subsector to have its floor or ceiling drawn.
+// These are per thread since world geometry for different ranges of draw subsectors may be generated on different threads.
+static thread_local int32_t tgNextFloorDrawSubsecIdx;
+static thread_local int32_t tgNextCeilDrawSubsecIdx;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Figures out a 2D point (on the XZ plane) to act as the center of a triangle fan type arrangement for the subsector.
@@ -90,7 +92,7 @@ static void RV_DrawPlane(
     const VLightDimMode lightDimMode = (gbDoViewLighting) ? VLightDimMode::Flats : VLightDimMode::None;
 
     // Ensure we have the correct draw pipeline set
-    VDrawing::setDrawPipeline(gOpaqueGeomPipeline);
+    VDrawing::setDrawPipeline(RV_GetTexDrawPipeline(tex, gOpaqueGeomPipeline));
 
     // Do all the triangles for the plane.
     // Note that all draw calls assume that the correct pipeline has already been set beforehand.
@@ -168,14 +170,47 @@ static void RV_DrawFlat(const subsector_t& subsec, const bool bDrawFloor, const
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the floor or ceiling for a draw subsector can be batched together with the floor or ceiling of the draw subsector before it.
+// The previous draw subsector is the one at the next lowest index, which is drawn after the given subsector.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <bool IsFloor>
+static bool RV_CanBatchFlatWithPrevDrawSubsec(const int32_t drawSubsecIdx) noexcept {
+    ASSERT((drawSubsecIdx > 0) && (drawSubsecIdx < (int32_t) gRvDrawSubsecs.size()));
+
+    const subsector_t& subsec = *gRvDrawSubsecs[drawSubsecIdx];
+    const subsector_t& nextSubsec = *gRvDrawSubsecs[drawSubsecIdx - 1];
+    const sector_t& sector = *subsec.sector;
+    const sector_t& nextSector = *nextSubsec.sector;
+
+    // Stop if this subsector (or the next) is not batchable or if the plane height changes
+    const bool bAllowBatching = (subsec.bVkCanBatchFlats && nextSubsec.bVkCanBatchFlats);
+
+    if (!bAllowBatching)
+        return false;
+
+    const fixed_t planeH = (IsFloor) ? sector.floorDrawH : sector.ceilingDrawH;
+    const fixed_t nextPlaneH = (IsFloor) ? nextSector.floorDrawH : nextSector.ceilingDrawH;
+
+    if (nextPlaneH != planeH)
+        return false;
+
+    // Also break the batch if there is a change in sky status.
+    // If we don't do this then sky walls can sometimes bleed through to other neighboring flats:
+    const bool bIsSkyPlane = (IsFloor) ? (sector.floorpic == -1) : (sector.ceilingpic == -1);
+    const bool bIsNextSkyPlane = (IsFloor) ? (nextSector.floorpic == -1) : (nextSector.ceilingpic == -1);
+    return (bIsSkyPlane == bIsNextSkyPlane);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Must be called before drawing subsectors and their flats.
-// Initializes which subsector floor and ceiling is to be drawn next.
+// Initializes which subsector floor and ceiling is to be drawn next, given the index of the first draw subsector to be drawn.
+// If that draw subsector is in the middle of a batch of flats then the batch is skipped, since it is drawn along with the start of the batch.
 //------------------------------------------------------------------------------------------------------------------------------------------
-void RV_InitNextDrawFlats() noexcept {
-    const int32_t lastSubsecIdx = (int32_t) gRvDrawSubsecs.size() - 1;
-    gNextFloorDrawSubsecIdx = lastSubsecIdx;
-    gNextCeilDrawSubsecIdx = lastSubsecIdx;
+void RV_InitNextDrawFlats(const int32_t fromDrawSubsecIdx) noexcept {
+    const int32_t numDrawSubsecs = (int32_t) gRvDrawSubsecs.size();
+    tgNextFloorDrawSubsecIdx = RV_FindNextDrawBatchStart(fromDrawSubsecIdx, numDrawSubsecs, RV_CanBatchFlatWithPrevDrawSubsec<true>);
+    tgNextCeilDrawSubsecIdx = RV_FindNextDrawBatchStart(fromDrawSubsecIdx, numDrawSubsecs, RV_CanBatchFlatWithPrevDrawSubsec<false>);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -187,12 +222,12 @@ void RV_DrawSubsecFloors(const int32_t fromDrawSubsecIdx) noexcept {
     ASSERT((fromDrawSubsecIdx >= 0) && (fromDrawSubsecIdx < (int32_t) gRvDrawSubsecs.size()));
 
     // If we've already drawn the floors for this subsector then we are done
-    if (gNextFloorDrawSubsecIdx != fromDrawSubsecIdx)
+    if (tgNextFloorDrawSubsecIdx != fromDrawSubsecIdx)
         return;
 
     while (true) {
         // Get the light/color value for the sector
-        const subsector_t& subsec = *gRvDrawSubsecs[gNextFloorDrawSubsecIdx];
+        const subsector_t& subsec = *gRvDrawSubsecs[tgNextFloorDrawSubsecIdx];
         const sector_t& sector = *subsec.sector;
 
         uint8_t secR;
@@ -202,29 +237,11 @@ void RV_DrawSubsecFloors(const int32_t fromDrawSubsecIdx) noexcept {
 
         // Draw the floor
         RV_DrawFlat(subsec, true, secR, secG, secB);
-        gNextFloorDrawSubsecIdx--;
-
-        // Should we end the draw batch here?
-        // Stop if there is no next draw sector, if this subsector (or the next) is not batchable or if the floor height changes.
-        if (gNextFloorDrawSubsecIdx < 0)
-            break;
-
-        const subsector_t& nextSubsec = *gRvDrawSubsecs[gNextFloorDrawSubsecIdx];
-        const sector_t& nextSector = *nextSubsec.sector;
-        const bool bAllowBatching = (subsec.bVkCanBatchFlats && nextSubsec.bVkCanBatchFlats);
 
-        if (!bAllowBatching)
-            break;
+        // Should we end the draw batch here? Stop if there is no next draw sector or if the next floor can't be batched with this one.
+        const int32_t drawSubsecIdx = tgNextFloorDrawSubsecIdx--;
 
-        if (nextSector.floorDrawH != sector.floorDrawH)
-            break;
-
-        // Also break the batch if there is a change in sky floor status.
-        // If we don't do this then sky walls can sometimes bleed through to other neighboring floors:
-        const bool bIsSkyFloor = (sector.floorpic == -1);
-        const bool bIsNextSkyFloor = (nextSector.floorpic == -1);
-
-        if (bIsSkyFloor != bIsNextSkyFloor)
+        if ((drawSubsecIdx <= 0) || (!RV_CanBatchFlatWithPrevDrawSubsec<true>(drawSubsecIdx)))
             break;
     }
 }
@@ -238,12 +255,12 @@ void RV_DrawSubsecCeilings(const int32_t fromDrawSubsecIdx) noexcept {
     ASSERT((fromDrawSubsecIdx >= 0) && (fromDrawSubsecIdx < (int32_t) gRvDrawSubsecs.size()));
 
     // If we've already drawn the ceilings for this subsector then we are done
-    if (gNextCeilDrawSubsecIdx != fromDrawSubsecIdx)
+    if (tgNextCeilDrawSubsecIdx != fromDrawSubsecIdx)
         return;
 
     while (true) {
         // Get the light/color value for the sector
-        const subsector_t& subsec = *gRvDrawSubsecs[gNextCeilDrawSubsecIdx];
+        const subsector_t& subsec = *gRvDrawSubsecs[tgNextCeilDrawSubsecIdx];
         const sector_t& sector = *subsec.sector;
 
         uint8_t secR;
@@ -253,29 +270,11 @@ void RV_DrawSubsecCeilings(const int32_t fromDrawSubsecIdx) noexcept {
 
         // Draw the ceiling
         RV_DrawFlat(subsec, false, secR, secG, secB);
-        gNextCeilDrawSubsecIdx--;
-
-        // Should we end the draw batch here?
-        // Stop if there is no next draw sector, if this subsector (or the next) is not batchable or if the ceiling height changes.
-        if (gNextCeilDrawSubsecIdx < 0)
-            break;
-
-        const subsector_t& nextSubsec = *gRvDrawSubsecs[gNextCeilDrawSubsecIdx];
-        const sector_t& nextSector = *nextSubsec.sector;
-        const bool bAllowBatching = (subsec.bVkCanBatchFlats && nextSubsec.bVkCanBatchFlats);
-
-        if (!bAllowBatching)
-            break;
-
-        if (nextSector.ceilingDrawH != sector.ceilingDrawH)
-            break;
 
-        // Also break the batch if there is a change in sky ceiling status.
-        // If we don't do this then sky walls can sometimes bleed through to other neighboring ceilings:
-        const bool bIsSkyCeil = (sector.ceilingpic == -1);
-        const bool bIsNextSkyCeil = (nextSector.ceilingpic == -1);
+        // Should we end the draw batch here? Stop if there is no next draw sector or if the next ceiling can't be batched with this one.
+        const int32_t drawSubsecIdx = tgNextCeilDrawSubsecIdx--;
 
-        if (bIsSkyCeil != bIsNextSkyCeil)
+        if ((drawSubsecIdx <= 0) || (!RV_CanBatchFlatWithPrevDrawSubsec<false>(drawSubsecIdx)))
             break;
     }
 }
@@ -18,10 +18,14 @@
 #include "Doom/Renderer/r_things.h"
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/Utils.h"
 #include "PsyDoom/Vulkan/VDrawing.h"
+#include "PsyDoom/Vulkan/VGpuProfiler.h"
 #include "PsyDoom/Vulkan/VRenderer.h"
+#include "PsyDoom/Vulkan/VTexAtlas.h"
 #include "PsyDoom/Vulkan/VTypes.h"
+#include "PsyDoom/WorkerThreads.h"
 #include "PsyQ/LIBGPU.h"
 #include "rv_bsp.h"
 #include "rv_flats.h"
@@ -31,6 +35,9 @@
 #include "rv_utils.h"
 #include "rv_walls.h"
 
+#include <algorithm>
+#include <chrono>
+
 float           gViewXf, gViewYf, gViewZf;      // View position in floating point format
 float           gViewAnglef;                    // View angle in radians (float)
 float           gViewCosf, gViewSinf;           // Sin and cosine for view angle
@@ -38,6 +45,13 @@ uint16_t        gClutX, gClutY;                 // X and Y position in VRAM for
 Matrix4f        gSpriteBillboardMatrix;         // A transform matrix containing the axis vectors used for sprite billboarding
 Matrix4f        gViewProjMatrix;                // The combined view and projection transform matrix for the scene
 VPipelineType   gOpaqueGeomPipeline;            // The pipeline to use for drawing opaque geometry
+bool            gbRvDrawingInParallel;          // True while world geometry is being generated on multiple threads
+float           gRvGeomGenUsec;                 // How long it took to generate world geometry for the last frame, in microseconds
+uint32_t        gRvGeomGenNumThreads;           // How many threads were used to generate world geometry for the last frame
+
+// The minimum number of draw subsectors to give to each thread when generating world geometry in parallel.
+// Below this the overhead of waking up the worker threads and stitching together their output is not worth it.
+static constexpr int32_t MIN_DRAW_SUBSECS_PER_THREAD = 48;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Determine various parameters affecting the draw, including view position, projection matrix and so on
@@ -99,6 +113,9 @@ static void RV_DetermineDrawParams() noexcept {
             } else {
                 gViewAngle = gPlayerNextTickViewAngle + gPlayerUncommittedTurning;
             }
+
+            // Also apply the very latest mouse movements received, which haven't been turned into player turning yet
+            gViewAngle += P_PlayerGetLateLatchTurning();
         } else {
             // User not currently in control: interpolate changes in player view angle
             gViewAngle = R_LerpAngle(gOldViewAngle, newViewAngle, lerp);
@@ -138,8 +155,9 @@ static void RV_DetermineDrawParams() noexcept {
     // Compute the view projection matrix to use
     gViewProjMatrix = VDrawing::computeTransformMatrixFor3D(gViewXf, gViewZf, gViewYf, gViewAnglef);
 
-    // Save the VRAM coordinate of the current palette CLUT
+    // Save the VRAM coordinate of the current palette CLUT and let the texture atlas know which CLUT is in use
     RV_ClutIdToClutXy(g3dViewPaletteClutId, gClutX, gClutY);
+    VTexAtlas::setViewClut(gClutX, gClutY);
 
     // Determine the pipeline to use for drawing fully opaque geometry
     if (gpViewPlayer->cheats & CF_XRAYVISION) {
@@ -160,15 +178,108 @@ static void RV_SetShaderUniformsFor3D() noexcept {
     VDrawing::setDrawUniforms(uniforms);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Draws the walls, flats, sky walls and sprites for a range of draw subsectors.
+// The subsectors are drawn back to front, starting at the 'from' index and ending at the 'to' index (inclusive).
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void RV_DrawSubsecRange(const int32_t fromDrawSubsecIdx, const int32_t toDrawSubsecIdx) noexcept {
+    // Init which subsectors are to have flats and sky walls drawn next.
+    // We try and batch all those for performance reasons, and also to avoid visual artifacts with sprite clipping.
+    RV_InitNextDrawFlats(fromDrawSubsecIdx);
+    RV_InitNextDrawSkyWalls(fromDrawSubsecIdx);
+
+    for (int32_t drawSubsecIdx = fromDrawSubsecIdx; drawSubsecIdx >= toDrawSubsecIdx; --drawSubsecIdx) {
+        subsector_t& subsec = *gRvDrawSubsecs[drawSubsecIdx];
+
+        // Draw all subsector sky walls, blended and masked walls
+        RV_DrawSubsecSkyWalls(drawSubsecIdx);
+        RV_DrawSubsecBlendedWalls(subsec);
+
+        // Draw all subsector opaque elements and then sprites on top of that.
+        // Most of the time these should all be on the same draw pipeline, so we can do batching.
+        RV_DrawSubsecOpaqueWalls(subsec);
+        RV_DrawSubsecFloors(drawSubsecIdx);
+        RV_DrawSubsecCeilings(drawSubsecIdx);
+        RV_DrawSubsecSpriteFrags(drawSubsecIdx);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Draws all of the subsectors back to front.
+//
+// If there are enough subsectors then the work is split up across multiple threads, with each thread generating geometry for a contiguous
+// range of draw subsectors into a private sub-buffer. The sub-buffers are then appended to the frame in the original draw order, so the
+// result is exactly the same as drawing everything on the main thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void RV_DrawAllSubsecs() noexcept {
+    const int32_t numDrawSubsecs = (int32_t) gRvDrawSubsecs.size();
+
+    if (numDrawSubsecs <= 0) {
+        gRvGeomGenNumThreads = 0;
+        return;
+    }
+
+    // Make sure the shading params for all the sectors are up to date and mark visible lines as seen for the automap.
+    // These modify shared state, so do them first before any geometry is generated.
+    for (subsector_t* const pSubsec : gRvDrawSubsecs) {
+        R_UpdateShadingParams(*pSubsec->sector);
+        RV_MarkSubsecWallsMapped(*pSubsec);
+    }
+
+    // Decide how many threads to use
+    const int32_t maxThreads = (Config::gVulkanGeometryThreads > 0) ? Config::gVulkanGeometryThreads : INT32_MAX;
+    const int32_t numThreads = std::clamp(
+        std::min({ maxThreads, (int32_t) WorkerThreads::getNumThreads(), numDrawSubsecs / MIN_DRAW_SUBSECS_PER_THREAD }),
+        1,
+        numDrawSubsecs
+    );
+
+    gRvGeomGenNumThreads = (uint32_t) numThreads;
+
+    if (numThreads <= 1) {
+        RV_DrawSubsecRange(numDrawSubsecs - 1, 0);
+        return;
+    }
+
+    // Generate the geometry in parallel: the first thread gets the furthest away (highest index) draw subsectors
+    VDrawing::ensureNumSubBuffers((uint32_t) numThreads);
+    gbRvDrawingInParallel = true;
+
+    WorkerThreads::runJobs((uint32_t) numThreads, [=](const uint32_t jobIdx) noexcept {
+        const int32_t fromDrawSubsecIdx = numDrawSubsecs - 1 - (int32_t)(((int64_t) numDrawSubsecs * jobIdx) / numThreads);
+        const int32_t toDrawSubsecIdx = numDrawSubsecs - (int32_t)(((int64_t) numDrawSubsecs * (jobIdx + 1)) / numThreads);
+
+        VDrawing::beginSubBuffer(jobIdx);
+        RV_DrawSubsecRange(fromDrawSubsecIdx, toDrawSubsecIdx);
+        VDrawing::endSubBuffer();
+    });
+
+    gbRvDrawingInParallel = false;
+
+    // Stitch together the output of all the threads in order
+    VDrawing::appendSubBuffers((uint32_t) numThreads);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Renders the player's view.
 // Some of the high level logic here is copied from the original renderer's 'R_RenderPlayerView'.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void RV_RenderPlayerView() noexcept {
+    PROFILE_ZONE("RV_RenderPlayerView");
+
     // Do nothing if drawing is currently not allowed
     if (!VRenderer::isRendering())
         return;
 
+    // Used to time each stage of rendering on the CPU for the GPU profiler: ends the timing for the given stage and starts the next
+    auto stageStartTime = std::chrono::steady_clock::now();
+
+    const auto endCpuStage = [&](const VGpuProfiler::CpuStage stage) noexcept {
+        const auto stageEndTime = std::chrono::steady_clock::now();
+        VGpuProfiler::setCpuStageTime(stage, std::chrono::duration<float, std::micro>(stageEndTime - stageStartTime).count());
+        stageStartTime = stageEndTime;
+    };
+
     // Increment the marker used to determine when to update the 'draw height' for each sector
     gValidCount++;
 
@@ -177,20 +288,20 @@ void RV_RenderPlayerView() noexcept {
     RV_DetermineDrawParams();
     RV_ClearOcclussion();
     RV_BuildDrawSubsecList();
+    endCpuStage(VGpuProfiler::CpuStage::Setup);
 
     // Build the list of sprite fragments to be drawn for each subsector
     RV_BuildSpriteFragLists();
-
-    // Init which subsectors are to have flats and sky walls drawn next.
-    // We try and batch all those for performance reasons, and also to avoid visual artifacts with sprite clipping.
-    RV_InitNextDrawFlats();
-    RV_InitNextDrawSkyWalls();
+    endCpuStage(VGpuProfiler::CpuStage::SpriteFrags);
 
     // Upload a new sky texture for this frame if required.
     // Also draw the base (background) sky that is needed in some scenarios.
     if (gbIsSkyVisible) {
         RV_CacheSkyTex();
+        VDrawing::addGpuTimestamp(VGpuProfiler::Pass::Sky, false);
         RV_DrawBackgroundSky();
+        VDrawing::addGpuTimestamp(VGpuProfiler::Pass::Sky, true);
+        endCpuStage(VGpuProfiler::CpuStage::Sky);
     }
 
     // Finish UI drawing batches first (if some are still active) - so we don't disturb their current set of shader uniforms and transform matrix.
@@ -202,25 +313,16 @@ void RV_RenderPlayerView() noexcept {
     // Increment the marker used to determine when to update the shading params for each sector
     gValidCount++;
 
-    // Draw all of the subsectors back to front
-    const int32_t numDrawSubsecs = (int32_t) gRvDrawSubsecs.size();
-
-    for (int32_t drawSubsecIdx = numDrawSubsecs - 1; drawSubsecIdx >= 0; --drawSubsecIdx) {
-        // Make sure the shading params for the sector are up to date
-        subsector_t& subsec = *gRvDrawSubsecs[drawSubsecIdx];
-        sector_t& sector = *subsec.sector;
-        R_UpdateShadingParams(sector);
-
-        // Draw all subsector sky walls, blended and masked walls
-        RV_DrawSubsecSkyWalls(drawSubsecIdx);
-        RV_DrawSubsecBlendedWalls(subsec);
-
-        // Draw all subsector opaque elements and then sprites on top of that.
-        // Most of the time these should all be on the same draw pipeline, so we can do batching.
-        RV_DrawSubsecOpaqueWalls(subsec);
-        RV_DrawSubsecFloors(drawSubsecIdx);
-        RV_DrawSubsecCeilings(drawSubsecIdx);
-        RV_DrawSubsecSpriteFrags(drawSubsecIdx);
+    // Draw all of the subsectors back to front and time how long generating the geometry takes
+    {
+        VDrawing::addGpuTimestamp(VGpuProfiler::Pass::World, false);
+        const auto geomGenStartTime = std::chrono::steady_clock::now();
+        RV_DrawAllSubsecs();
+        const auto geomGenEndTime = std::chrono::steady_clock::now();
+        gRvGeomGenUsec = std::chrono::duration<float, std::micro>(geomGenEndTime - geomGenStartTime).count();
+        VDrawing::addGpuTimestamp(VGpuProfiler::Pass::World, true);
+        VGpuProfiler::setCpuStageTime(VGpuProfiler::CpuStage::Geom, gRvGeomGenUsec);
+        stageStartTime = geomGenEndTime;
     }
 
     // Cleanup after drawing the world: need to clear the draw order for each drawn subsector
@@ -234,6 +336,8 @@ void RV_RenderPlayerView() noexcept {
     if (gExtCameraTicsLeft <= 0) {
         RV_DrawWeapon();
     }
+
+    endCpuStage(VGpuProfiler::CpuStage::Weapon);
 }
 
 #endif  // #if PSYDOOM_VULKAN_RENDERER
@@ -19,6 +19,9 @@ extern uint16_t         gClutY;
 extern Matrix4f         gSpriteBillboardMatrix;
 extern Matrix4f         gViewProjMatrix;
 extern VPipelineType    gOpaqueGeomPipeline;
+extern bool             gbRvDrawingInParallel;
+extern float            gRvGeomGenUsec;
+extern uint32_t         gRvGeomGenNumThreads;
 
 void RV_RenderPlayerView() noexcept;
 
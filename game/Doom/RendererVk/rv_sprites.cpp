@@ -61,8 +61,8 @@ static std::vector<SpriteFrag> gRvSpriteFrags;
 static std::vector<int32_t> gRvDrawSubsecSprFrags;
 
 // Depth sorted sprite fragments to be drawn for the current draw subsector.
-// This temporary list is re-used for each subsector to avoid allocations.
-static std::vector<const SpriteFrag*> gRvSortedFrags;
+// This temporary list is re-used for each subsector to avoid allocations, and is per thread since world geometry may be generated in parallel.
+static thread_local std::vector<const SpriteFrag*> tgRvSortedFrags;
 
 // XYZ position for the current thing which is having sprite fragments generated
 static float gSpriteFragThingPos[3];
@@ -134,7 +134,7 @@ static void RV_InitSpriteFrag(
 
     // Make sure the sprite is resident in VRAM and get whether it is flipped
     bool bFlipSprite = {};
-    const texture_t& tex = RV_CacheThingSpriteFrame(thingX, thingY, thing.angle, frame, bFlipSprite);
+    texture_t& tex = RV_CacheThingSpriteFrame(thingX, thingY, thing.angle, frame, bFlipSprite);
 
     // Get the texture window params for the sprite
     uint16_t texWinX;
@@ -173,6 +173,9 @@ static void RV_InitSpriteFrag(
         stMulA = 64;
     }
 
+    // Use the texture atlas variant of the pipeline, if available for this sprite
+    drawPipeline = RV_GetTexDrawPipeline(tex, drawPipeline);
+
     // Aspect correction scaling value copied from 'R_DrawSubsectorSprites'.
     // See the comments there for more about this...
     constexpr float ASPECT_CORRECT = 4.0f / 5.0f;
@@ -601,7 +604,7 @@ void RV_BuildSpriteFragLists() noexcept {
     gRvDrawSubsecSprFrags.clear();
     gRvDrawSubsecSprFrags.reserve(4196);
     gRvDrawSubsecSprFrags.resize((size_t) numDrawSubsecs, -1);
-    gRvSortedFrags.reserve(256);
+    tgRvSortedFrags.reserve(256);
 
     // Run through all of the draw subsectors and build a list of sprite fragments for each
     for (int32_t drawSubsecIdx = 0; drawSubsecIdx < numDrawSubsecs; ++drawSubsecIdx) {
@@ -614,7 +617,7 @@ void RV_BuildSpriteFragLists() noexcept {
 //------------------------------------------------------------------------------------------------------------------------------------------
 void RV_DrawSubsecSpriteFrags(const int32_t drawSubsecIdx) noexcept {
     // Firstly gather all of the sprite fragments for this draw subsector
-    ASSERT(gRvSortedFrags.empty());
+    ASSERT(tgRvSortedFrags.empty());
     ASSERT((size_t) drawSubsecIdx < gRvDrawSubsecs.size());
 
     int32_t nextSprIdx = gRvDrawSubsecSprFrags[drawSubsecIdx];
@@ -623,25 +626,25 @@ void RV_DrawSubsecSpriteFrags(const int32_t drawSubsecIdx) noexcept {
     while (nextSprIdx >= 0) {
         ASSERT((size_t) nextSprIdx < gRvSpriteFrags.size());
         const SpriteFrag& sprFrag = pAllSprFrags[nextSprIdx];
-        gRvSortedFrags.emplace_back(&sprFrag);
+        tgRvSortedFrags.emplace_back(&sprFrag);
         nextSprIdx = sprFrag.nextSubsecFragIdx;
     }
 
     // Sort all of the sprite fragments back to front
     std::stable_sort(
-        gRvSortedFrags.begin(),
-        gRvSortedFrags.end(),
+        tgRvSortedFrags.begin(),
+        tgRvSortedFrags.end(),
         [](const SpriteFrag* const pFrag1, const SpriteFrag* const pFrag2) noexcept {
             return (pFrag1->depth > pFrag2->depth);
         }
     );
 
     // Draw all the sorted fragments and clear the temporary list to finish up
-    for (const SpriteFrag* const pSprFrag : gRvSortedFrags) {
+    for (const SpriteFrag* const pSprFrag : tgRvSortedFrags) {
         RV_DrawSpriteFrag(*pSprFrag);
     }
 
-    gRvSortedFrags.clear();
+    tgRvSortedFrags.clear();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -13,7 +13,9 @@
 #include "Doom/Renderer/r_local.h"
 #include "Doom/Renderer/r_main.h"
 #include "Gpu.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/Vulkan/VDrawing.h"
+#include "PsyDoom/Vulkan/VTexAtlas.h"
 #include "PsyDoom/Vulkan/VTypes.h"
 #include "PsyQ/LIBGPU.h"
 #include "rv_bsp.h"
@@ -22,6 +24,10 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <mutex>
+
+// Guards texture uploads while world geometry is being generated on multiple threads
+static std::mutex gUploadTexMutex;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Convert a 16.16 fixed point number to float
@@ -124,10 +130,19 @@ void RV_GetTexWinXyWh(const texture_t& tex, uint16_t& texWinX, uint16_t& texWinY
 // Used for updating animated floor, wall and sky textures.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void RV_UploadDirtyTex(texture_t& tex) noexcept {
+    // If world geometry is being generated on multiple threads then only one thread at a time may check for and do uploads
+    std::unique_lock<std::mutex> uploadLock(gUploadTexMutex, std::defer_lock);
+
+    if (gbRvDrawingInParallel) {
+        uploadLock.lock();
+    }
+
     // Is the texture already uploaded?
     if (tex.uploadFrameNum != TEX_INVALID_UPLOAD_FRAME_NUM)
         return;
 
+    PROFILE_ZONE("RV_UploadDirtyTex");
+
     // Decompress the lump data to the temporary buffer if required
     const std::byte* pLumpData;
 
@@ -160,6 +175,44 @@ void RV_UploadDirtyTex(texture_t& tex) noexcept {
     const SRECT vramRect = getTextureVramRect(tex);
     LIBGPU_LoadImage(vramRect, (uint16_t*)(pLumpData + sizeof(texlump_header_t)));
     tex.uploadFrameNum = gNumFramesDrawn;
+    tex.bIsInVkTexAtlas = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the pipeline to draw the given world texture with, given the world pipeline that would normally be used.
+// If the texture atlas is enabled then the texture is decoded into the atlas (if required) and the atlas variant of the pipeline returned.
+// The regular pipeline is returned if the atlas is disabled, or if the texture is not decoded and the 3D view palette is still changing.
+// Assumes the texture has already been uploaded to VRAM.
+//------------------------------------------------------------------------------------------------------------------------------------------
+VPipelineType RV_GetTexDrawPipeline(texture_t& tex, const VPipelineType pipelineType) noexcept {
+    if (!VTexAtlas::isEnabled())
+        return pipelineType;
+
+    // If world geometry is being generated on multiple threads then only one thread at a time may check for and do decoding
+    std::unique_lock<std::mutex> uploadLock(gUploadTexMutex, std::defer_lock);
+
+    if (gbRvDrawingInParallel) {
+        uploadLock.lock();
+    }
+
+    // Is the texture already decoded with the right CLUT? If not then decode it, if the CLUT has stopped changing:
+    const bool bIsDecoded = (tex.bIsInVkTexAtlas && (tex.vkTexAtlasClutX == gClutX) && (tex.vkTexAtlasClutY == gClutY));
+
+    if (!bIsDecoded) {
+        if (!VTexAtlas::isViewClutStable())
+            return pipelineType;
+
+        uint16_t texWinX, texWinY;
+        uint16_t texWinW, texWinH;
+        RV_GetTexWinXyWh(tex, texWinX, texWinY, texWinW, texWinH);
+        VTexAtlas::decodeTexels(texWinX, texWinY, texWinW, texWinH, gClutX, gClutY);
+
+        tex.bIsInVkTexAtlas = true;
+        tex.vkTexAtlasClutX = gClutX;
+        tex.vkTexAtlasClutY = gClutY;
+    }
+
+    return VTexAtlas::getAtlasPipelineType(pipelineType);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -265,6 +318,33 @@ bool RV_GetLineNdcBounds(
     return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Used to find where to start drawing batches of flats or sky walls which span multiple draw subsectors, when drawing starts from the given
+// draw subsector index and proceeds towards index '0'. The given function tells if the batch can continue on to the previous draw subsector.
+//
+// If the draw subsector is the start of a batch then its index is returned. Otherwise it is part of a batch that begins at a higher index,
+// which is drawn along with that draw subsector instead - in that case the index of the first draw subsector after that batch is returned.
+// The returned index might be '-1' if there are no more batches to draw.
+//------------------------------------------------------------------------------------------------------------------------------------------
+int32_t RV_FindNextDrawBatchStart(
+    const int32_t fromDrawSubsecIdx,
+    const int32_t numDrawSubsecs,
+    bool (* const canBatchWithPrevDrawSubsec)(const int32_t drawSubsecIdx) noexcept
+) noexcept {
+    ASSERT((fromDrawSubsecIdx >= 0) && (fromDrawSubsecIdx < numDrawSubsecs));
+
+    if ((fromDrawSubsecIdx + 1 >= numDrawSubsecs) || (!canBatchWithPrevDrawSubsec(fromDrawSubsecIdx + 1)))
+        return fromDrawSubsecIdx;
+
+    int32_t drawSubsecIdx = fromDrawSubsecIdx;
+
+    while ((drawSubsecIdx > 0) && canBatchWithPrevDrawSubsec(drawSubsecIdx)) {
+        drawSubsecIdx--;
+    }
+
+    return drawSubsecIdx - 1;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Clear the draw order field for each subsector drawn this frame.
 // This cleanup is required to be done after doing drawing each frame, so that each subsector is marked as initially not being drawn.
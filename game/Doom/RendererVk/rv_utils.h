@@ -12,6 +12,8 @@ namespace Gpu {
 struct seg_t;
 struct texture_t;
 
+enum class VPipelineType : uint8_t;
+
 // PI to 96 digits: define here because it's not available in standard C/C++ (sigh... it's 2021 and this is still a thing)
 template <class T> static constexpr T RV_PI = T(3.141592653589793238462643383279502884197169399375105820974944592307816406286208998628034825342117);
 
@@ -36,6 +38,7 @@ void RV_TexPageIdToTexParams(
 
 void RV_GetTexWinXyWh(const texture_t& tex, uint16_t& texWinX, uint16_t& texWinY, uint16_t& texWinW, uint16_t& texWinH) noexcept;
 void RV_UploadDirtyTex(texture_t& tex) noexcept;
+VPipelineType RV_GetTexDrawPipeline(texture_t& tex, const VPipelineType pipelineType) noexcept;
 
 bool RV_GetLineNdcBounds(
     const float p1x,
@@ -47,6 +50,12 @@ bool RV_GetLineNdcBounds(
     const float lrpCullAdjust = 1.0f    // Left/right plane angle adjustment for culling (1.0 = no change)
 ) noexcept;
 
+int32_t RV_FindNextDrawBatchStart(
+    const int32_t fromDrawSubsecIdx,
+    const int32_t numDrawSubsecs,
+    bool (* const canBatchWithPrevDrawSubsec)(const int32_t drawSubsecIdx) noexcept
+) noexcept;
+
 void RV_ClearSubsecDrawIndexes() noexcept;
 void RV_DrawWidescreenStatusBarLetterbox() noexcept;
 
@@ -20,7 +20,9 @@
 
 #include <cmath>
 
-static int32_t gNextSkyWallDrawSubsecIdx;       // Index of the next draw subsector to have its sky walls drawn
+// Index of the next draw subsector to have its sky walls drawn.
+// This is per thread since world geometry for different ranges of draw subsectors may be generated on different threads.
+static thread_local int32_t tgNextSkyWallDrawSubsecIdx;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Draw a wall (upper, mid, lower) for a seg
@@ -41,10 +43,12 @@ static void RV_DrawWall(
     // Sector, texture and shading details
     const sector_t& sector,
     texture_t& tex,
-    const bool bBlend
+    const bool bBlend,
+    const VPipelineType drawPipeline
 ) noexcept {
-    // Upload the texture to VRAM if required
+    // Upload the texture to VRAM if required and switch to the pipeline to draw it with
     RV_UploadDirtyTex(tex);
+    VDrawing::setDrawPipeline(RV_GetTexDrawPipeline(tex, drawPipeline));
 
     // Get the texture page location for this texture
     uint16_t texWinX, texWinY;
@@ -64,8 +68,7 @@ static void RV_DrawWall(
     R_GetSectorDrawColor(sector, yt, colR_t, colG_t, colB_t);
     R_GetSectorDrawColor(sector, yb, colR_b, colG_b, colB_b);
 
-    // Draw the wall triangles.
-    // Note: assuming the correct draw pipeline has been already set.
+    // Draw the wall triangles
     const uint8_t alpha = (bBlend) ? 64 : 128;
 
     VDrawing::addWorldQuad(
@@ -95,10 +98,9 @@ static void RV_DrawSegSolid(const rvseg_t& seg, const subsector_t& subsec) noexc
     if ((seg.flags & SGF_VISIBLE_COLS) == 0)
         return;
 
-    // This line is now viewed by the player: show in the automap if the line is viewable there
+    // Note: the line is marked as viewed for the automap beforehand by 'RV_MarkSubsecWallsMapped'
     side_t& side = *seg.sidedef;
-    line_t& line = *seg.linedef;
-    line.flags |= ML_MAPPED;
+    const line_t& line = *seg.linedef;
 
     // Get the xz positions of the seg endpoints and the seg length
     const float x1 = seg.v1x;
@@ -165,9 +167,8 @@ static void RV_DrawSegSolid(const rvseg_t& seg, const subsector_t& subsec) noexc
                 vb = vt + wallH;
             }
 
-            VDrawing::setDrawPipeline(gOpaqueGeomPipeline);
             texture_t& tex_u = gpTextures[gpTextureTranslation[side.toptexture]];
-            RV_DrawWall(x1, z1, x2, z2, fty, bty, u1, u2, vt, vb, frontSec, tex_u, bDrawTransparent);
+            RV_DrawWall(x1, z1, x2, z2, fty, bty, u1, u2, vt, vb, frontSec, tex_u, bDrawTransparent, gOpaqueGeomPipeline);
         }
 
         // Draw the lower wall if existing not a sky wall
@@ -188,9 +189,8 @@ static void RV_DrawSegSolid(const rvseg_t& seg, const subsector_t& subsec) noexc
                 vt = vb - wallH;
             }
 
-            VDrawing::setDrawPipeline(gOpaqueGeomPipeline);
             texture_t& tex_l = gpTextures[gpTextureTranslation[side.bottomtexture]];
-            RV_DrawWall(x1, z1, x2, z2, bby, fby, u1, u2, vt, vb, frontSec, tex_l, bDrawTransparent);
+            RV_DrawWall(x1, z1, x2, z2, bby, fby, u1, u2, vt, vb, frontSec, tex_l, bDrawTransparent, gOpaqueGeomPipeline);
         }
     }
 
@@ -219,9 +219,8 @@ static void RV_DrawSegSolid(const rvseg_t& seg, const subsector_t& subsec) noexc
         }
 
         // Draw the wall
-        VDrawing::setDrawPipeline(gOpaqueGeomPipeline);
         texture_t& tex_m = gpTextures[gpTextureTranslation[side.midtexture]];
-        RV_DrawWall(x1, z1, x2, z2, midTy, midBy, u1, u2, vt, vb, frontSec, tex_m, bDrawTransparent);
+        RV_DrawWall(x1, z1, x2, z2, midTy, midBy, u1, u2, vt, vb, frontSec, tex_m, bDrawTransparent, gOpaqueGeomPipeline);
     }
 }
 
@@ -326,9 +325,8 @@ static void RV_DrawSegBlended(const rvseg_t& seg, const subsector_t& subsec) noe
     // Should this wall be drawn with 50% alpha or not?
     const bool bBlend = (line.flags & ML_MIDTRANSLUCENT);
 
-    // Draw the wall and make sure we are on the correct alpha blended pipeline before we draw
-    VDrawing::setDrawPipeline(VPipelineType::World_GeomAlpha);
-    RV_DrawWall(x1, z1, x2, z2, midTy, midBy, u1, u2, vt, vb, frontSec, tex_m, bBlend);
+    // Draw the wall using the alpha blended pipeline
+    RV_DrawWall(x1, z1, x2, z2, midTy, midBy, u1, u2, vt, vb, frontSec, tex_m, bBlend, VPipelineType::World_GeomAlpha);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -430,12 +428,53 @@ static void RV_DrawSegSkyWalls(const rvseg_t& seg, const subsector_t& subsec) no
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the sky walls for a draw subsector can be batched together with the sky walls of the draw subsector before it.
+// The previous draw subsector is the one at the next lowest index, which is drawn after the given subsector.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool RV_CanBatchSkyWallsWithPrevDrawSubsec(const int32_t drawSubsecIdx) noexcept {
+    ASSERT((drawSubsecIdx > 0) && (drawSubsecIdx < (int32_t) gRvDrawSubsecs.size()));
+
+    const sector_t& sector = *gRvDrawSubsecs[drawSubsecIdx]->sector;
+    const sector_t& nextSector = *gRvDrawSubsecs[drawSubsecIdx - 1]->sector;
+
+    // Stop if the sky status or ceiling height changes
+    if (nextSector.ceilingDrawH != sector.ceilingDrawH)
+        return false;
+
+    const bool bHasSkyCeil = (sector.ceilingpic == -1);
+    const bool bHasSkyFloor = (sector.floorpic == -1);
+    const bool bNextHasSkyCeil = (nextSector.ceilingpic == -1);
+    const bool bNextHasSkyFloor = (nextSector.floorpic == -1);
+    return ((bHasSkyCeil == bNextHasSkyCeil) && (bHasSkyFloor == bNextHasSkyFloor));
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Must be called before drawing sky walls.
-// Initializes which subsector is to have sky walls drawn next.
+// Initializes which subsector is to have sky walls drawn next, given the index of the first draw subsector to be drawn.
 //------------------------------------------------------------------------------------------------------------------------------------------
-void RV_InitNextDrawSkyWalls() noexcept {
-    gNextSkyWallDrawSubsecIdx = (int32_t) gRvDrawSubsecs.size() - 1;
+void RV_InitNextDrawSkyWalls(const int32_t fromDrawSubsecIdx) noexcept {
+    const int32_t numDrawSubsecs = (int32_t) gRvDrawSubsecs.size();
+    tgNextSkyWallDrawSubsecIdx = RV_FindNextDrawBatchStart(fromDrawSubsecIdx, numDrawSubsecs, RV_CanBatchSkyWallsWithPrevDrawSubsec);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Marks all lines for visible, front facing segs in the subsector as seen for the purposes of the automap.
+// This is done separately to drawing so that the world geometry for different subsectors can be generated on multiple threads.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void RV_MarkSubsecWallsMapped(const subsector_t& subsec) noexcept {
+    const rvseg_t* const pBegSeg = gpRvSegs.get() + subsec.firstseg;
+    const rvseg_t* const pEndSeg = pBegSeg + subsec.numsegs;
+
+    for (const rvseg_t* pSeg = pBegSeg; pSeg < pEndSeg; ++pSeg) {
+        if (pSeg->flags & SGF_BACKFACING)
+            continue;
+
+        if ((pSeg->flags & SGF_VISIBLE_COLS) == 0)
+            continue;
+
+        pSeg->linedef->flags |= ML_MAPPED;
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -473,13 +512,12 @@ void RV_DrawSubsecSkyWalls(const int32_t fromDrawSubsecIdx) noexcept {
     ASSERT((fromDrawSubsecIdx >= 0) && (fromDrawSubsecIdx < (int32_t) gRvDrawSubsecs.size()));
 
     // If we've already drawn the sky walls for this subsector then we are done
-    if (gNextSkyWallDrawSubsecIdx != fromDrawSubsecIdx)
+    if (tgNextSkyWallDrawSubsecIdx != fromDrawSubsecIdx)
         return;
 
     while (true) {
         // Draw any sky walls required for all segs in this subsector
-        const subsector_t& subsec = *gRvDrawSubsecs[gNextSkyWallDrawSubsecIdx];
-        const sector_t& sector = *subsec.sector;
+        const subsector_t& subsec = *gRvDrawSubsecs[tgNextSkyWallDrawSubsecIdx];
 
         {
             const rvseg_t* const pBegSeg = gpRvSegs.get() + subsec.firstseg;
@@ -491,25 +529,9 @@ void RV_DrawSubsecSkyWalls(const int32_t fromDrawSubsecIdx) noexcept {
         }
 
         // Should we end the draw batch here? Stop if there is no next draw sector, or if the sky status or ceiling height changes
-        gNextSkyWallDrawSubsecIdx--;
-
-        if (gNextSkyWallDrawSubsecIdx < 0)
-            break;
-
-        const sector_t& nextSector = *gRvDrawSubsecs[gNextSkyWallDrawSubsecIdx]->sector;
-
-        if (nextSector.ceilingDrawH != sector.ceilingDrawH)
-            break;
-
-        const bool bHasSkyCeil = (sector.ceilingpic == -1);
-        const bool bHasSkyFloor = (sector.floorpic == -1);
-        const bool bNextHasSkyCeil = (nextSector.ceilingpic == -1);
-        const bool bNextHasSkyFloor = (nextSector.floorpic == -1);
-
-        if (bHasSkyCeil != bNextHasSkyCeil)
-            break;
+        const int32_t drawSubsecIdx = tgNextSkyWallDrawSubsecIdx--;
 
-        if (bHasSkyFloor != bNextHasSkyFloor)
+        if ((drawSubsecIdx <= 0) || (!RV_CanBatchSkyWallsWithPrevDrawSubsec(drawSubsecIdx)))
             break;
     }
 }
@@ -13,20 +13,23 @@
 #include "Doom/RendererVk/rv_automap.h"
 #include "PsyDoom/PlayerPrefs.h"
 #include "PsyDoom/PsxPadButtons.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "PsyDoom/Utils.h"
 #include "PsyDoom/Video.h"
 #include "PsyQ/LIBETC.h"
 #include "PsyQ/LIBGPU.h"
 
+#include <algorithm>
+
 static constexpr fixed_t MOVESTEP   = FRACUNIT * 128;   // Controls how fast manual automap movement happens
 static constexpr fixed_t SCALESTEP  = 2;                // How fast to scale in/out
 static constexpr int32_t MAXSCALE   = 64;               // Maximum map zoom
 static constexpr int32_t MINSCALE   = 8;                // Minimum map zoom
 
-static fixed_t  gAutomapXMin;
-static fixed_t  gAutomapXMax;
-static fixed_t  gAutomapYMin;
-static fixed_t  gAutomapYMax;
+static SIM_TLS fixed_t  gAutomapXMin;
+static SIM_TLS fixed_t  gAutomapXMax;
+static SIM_TLS fixed_t  gAutomapYMin;
+static SIM_TLS fixed_t  gAutomapYMax;
 
 // Internal module functions
 static void DrawLine(const uint32_t color, const int32_t x1, const int32_t y1, const int32_t x2, const int32_t y2) noexcept;
@@ -34,12 +37,12 @@ static void DrawLine(const uint32_t color, const int32_t x1, const int32_t y1, c
 #if PSYDOOM_MODS
 
 // The position and rotation to use for the player this frame on the automap, and the free camera position and camera zoom
-static fixed_t gAM_PlayerX;
-static fixed_t gAM_PlayerY;
-static angle_t gAM_PlayerAngle;
-static fixed_t gAM_AutomapX;
-static fixed_t gAM_AutomapY;
-static fixed_t gAM_AutomapScale;
+static SIM_TLS fixed_t gAM_PlayerX;
+static SIM_TLS fixed_t gAM_PlayerY;
+static SIM_TLS angle_t gAM_PlayerAngle;
+static SIM_TLS fixed_t gAM_AutomapX;
+static SIM_TLS fixed_t gAM_AutomapY;
+static SIM_TLS fixed_t gAM_AutomapScale;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Compute the position and rotation to use for the automap for the player, taking into account framerate independent movement.
@@ -69,6 +72,187 @@ static void AM_CalcPlayerMapTransforms() noexcept {
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: a coarse grid over the map which lists the lines overlapping each grid cell, used to cull automap lines outside of the view.
+// Map geometry never moves so the grid is built once per map. Whether lines are visible and what color they are is still decided when
+// drawing, since line flags and specials can be changed by many things (including map scripts).
+//------------------------------------------------------------------------------------------------------------------------------------------
+static constexpr int32_t AM_GRID_CELL_SHIFT = FRACBITS + 9;     // Automap grid cells are 512x512 map units
+
+static SIM_TLS const line_t*                    gpAMGridLines;          // The lines and line count the automap grid was built for
+static SIM_TLS int32_t                          gAMGridNumLines;
+static SIM_TLS int64_t                          gAMGridOriginX;         // Map coordinate of the bottom left corner of the grid
+static SIM_TLS int64_t                          gAMGridOriginY;
+static SIM_TLS int32_t                          gAMGridW;               // Size of the grid in cells
+static SIM_TLS int32_t                          gAMGridH;
+static SIM_TLS std::vector<uint32_t>            gAMGridCellLinesBeg;    // For each cell, where it's list of lines starts in 'gAMGridCellLines' (plus an end entry)
+static SIM_TLS std::vector<int32_t>             gAMGridCellLines;       // The line indexes for each grid cell
+static SIM_TLS std::vector<amlinecoords_t>      gAMLineCoords;          // The floating point coordinates for each line
+static SIM_TLS std::vector<uint64_t>            gAMLinesInViewBits;     // Bit set of the lines found when gathering the lines in view
+static SIM_TLS std::vector<int32_t>             gAMLinesInView;         // The result of the last query for lines in view, in line index order
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Builds the automap grid for the lines of the current map
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void AM_BuildLineGrid() noexcept {
+    const line_t* const pLines = gpLines;
+    const int32_t numLines = gNumLines;
+
+    gpAMGridLines = pLines;
+    gAMGridNumLines = numLines;
+
+    // Get the bounds of all lines to determine the grid size, and cache the floating point coordinates of each line
+    fixed_t minX = INT32_MAX;
+    fixed_t minY = INT32_MAX;
+    fixed_t maxX = INT32_MIN;
+    fixed_t maxY = INT32_MIN;
+
+    gAMLineCoords.resize((size_t) numLines);
+
+    for (int32_t lineIdx = 0; lineIdx < numLines; ++lineIdx) {
+        const line_t& line = pLines[lineIdx];
+        const vertex_t& v1 = *line.vertex1;
+        const vertex_t& v2 = *line.vertex2;
+
+        minX = std::min({ minX, v1.x, v2.x });
+        minY = std::min({ minY, v1.y, v2.y });
+        maxX = std::max({ maxX, v1.x, v2.x });
+        maxY = std::max({ maxY, v1.y, v2.y });
+
+        amlinecoords_t& coords = gAMLineCoords[lineIdx];
+        coords.x1 = (float)(v1.x * (1.0f / 65536.0f));
+        coords.y1 = (float)(v1.y * (1.0f / 65536.0f));
+        coords.x2 = (float)(v2.x * (1.0f / 65536.0f));
+        coords.y2 = (float)(v2.y * (1.0f / 65536.0f));
+    }
+
+    if (numLines <= 0) {
+        minX = minY = maxX = maxY = 0;
+    }
+
+    gAMGridOriginX = minX;
+    gAMGridOriginY = minY;
+    gAMGridW = (int32_t)(((int64_t) maxX - minX) >> AM_GRID_CELL_SHIFT) + 1;
+    gAMGridH = (int32_t)(((int64_t) maxY - minY) >> AM_GRID_CELL_SHIFT) + 1;
+
+    // Calls the given function for each grid cell overlapped by the bounding box of a line
+    const auto forEachLineCell = [](const line_t& line, const auto& func) noexcept {
+        const fixed_t x1 = line.vertex1->x;
+        const fixed_t y1 = line.vertex1->y;
+        const fixed_t x2 = line.vertex2->x;
+        const fixed_t y2 = line.vertex2->y;
+        const int32_t cellLx = (int32_t)((std::min<int64_t>(x1, x2) - gAMGridOriginX) >> AM_GRID_CELL_SHIFT);
+        const int32_t cellRx = (int32_t)((std::max<int64_t>(x1, x2) - gAMGridOriginX) >> AM_GRID_CELL_SHIFT);
+        const int32_t cellBy = (int32_t)((std::min<int64_t>(y1, y2) - gAMGridOriginY) >> AM_GRID_CELL_SHIFT);
+        const int32_t cellTy = (int32_t)((std::max<int64_t>(y1, y2) - gAMGridOriginY) >> AM_GRID_CELL_SHIFT);
+
+        for (int32_t cellY = cellBy; cellY <= cellTy; ++cellY) {
+            for (int32_t cellX = cellLx; cellX <= cellRx; ++cellX) {
+                func(cellY * gAMGridW + cellX);
+            }
+        }
+    };
+
+    // Count the lines in each cell, then figure out where each cell's list starts and fill in the lists
+    const size_t numCells = (size_t) gAMGridW * (size_t) gAMGridH;
+    gAMGridCellLinesBeg.clear();
+    gAMGridCellLinesBeg.resize(numCells + 1);
+
+    for (int32_t lineIdx = 0; lineIdx < numLines; ++lineIdx) {
+        forEachLineCell(pLines[lineIdx], [](const int32_t cellIdx) noexcept { gAMGridCellLinesBeg[cellIdx + 1]++; });
+    }
+
+    for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        gAMGridCellLinesBeg[cellIdx + 1] += gAMGridCellLinesBeg[cellIdx];
+    }
+
+    std::vector<uint32_t> cellFillCounts(numCells);
+    gAMGridCellLines.resize(gAMGridCellLinesBeg[numCells]);
+
+    for (int32_t lineIdx = 0; lineIdx < numLines; ++lineIdx) {
+        forEachLineCell(pLines[lineIdx], [&](const int32_t cellIdx) noexcept {
+            gAMGridCellLines[gAMGridCellLinesBeg[cellIdx] + cellFillCounts[cellIdx]] = lineIdx;
+            cellFillCounts[cellIdx]++;
+        });
+    }
+
+    gAMLinesInViewBits.clear();
+    gAMLinesInViewBits.resize(((size_t) numLines + 63) / 64);
+    gAMLinesInView.clear();
+    gAMLinesInView.reserve((size_t) numLines);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: returns the indexes of all lines which might be in the given view area of the automap (in line index order).
+// The view area is centered on the given point and has the given half width and height in map units.
+// Lines not returned are guaranteed to be completely outside of the view area. The returned list is valid until the next call.
+//------------------------------------------------------------------------------------------------------------------------------------------
+const std::vector<int32_t>& AM_GetLinesInView(const fixed_t viewX, const fixed_t viewY, const fixed_t halfViewW, const fixed_t halfViewH) noexcept {
+    // Build the grid if it's not built for the current map's lines
+    if ((gpAMGridLines != gpLines) || (gAMGridNumLines != gNumLines)) {
+        AM_BuildLineGrid();
+    }
+
+    gAMLinesInView.clear();
+
+    // Figure out the range of grid cells overlapped by the view, and stop if it's not overlapping the grid
+    const int64_t cellLx = std::max<int64_t>(((int64_t) viewX - halfViewW - gAMGridOriginX) >> AM_GRID_CELL_SHIFT, 0);
+    const int64_t cellRx = std::min<int64_t>(((int64_t) viewX + halfViewW - gAMGridOriginX) >> AM_GRID_CELL_SHIFT, gAMGridW - 1);
+    const int64_t cellBy = std::max<int64_t>(((int64_t) viewY - halfViewH - gAMGridOriginY) >> AM_GRID_CELL_SHIFT, 0);
+    const int64_t cellTy = std::min<int64_t>(((int64_t) viewY + halfViewH - gAMGridOriginY) >> AM_GRID_CELL_SHIFT, gAMGridH - 1);
+
+    if ((cellLx > cellRx) || (cellBy > cellTy))
+        return gAMLinesInView;
+
+    // Mark all of the lines in the cells and then gather them in order: this also removes duplicates for lines spanning multiple cells
+    uint64_t* const pLineBits = gAMLinesInViewBits.data();
+
+    for (int64_t cellY = cellBy; cellY <= cellTy; ++cellY) {
+        for (int64_t cellX = cellLx; cellX <= cellRx; ++cellX) {
+            const size_t cellIdx = (size_t)(cellY * gAMGridW + cellX);
+            const uint32_t linesEnd = gAMGridCellLinesBeg[cellIdx + 1];
+
+            for (uint32_t i = gAMGridCellLinesBeg[cellIdx]; i < linesEnd; ++i) {
+                const int32_t lineIdx = gAMGridCellLines[i];
+                pLineBits[lineIdx / 64] |= (uint64_t) 1 << (lineIdx % 64);
+            }
+        }
+    }
+
+    const size_t numWords = gAMLinesInViewBits.size();
+
+    for (size_t wordIdx = 0; wordIdx < numWords; ++wordIdx) {
+        uint64_t bits = pLineBits[wordIdx];
+        pLineBits[wordIdx] = 0;
+
+        for (uint32_t bitIdx = 0; bits != 0; ++bitIdx, bits >>= 1) {
+            if (bits & 1) {
+                gAMLinesInView.push_back((int32_t)(wordIdx * 64 + bitIdx));
+            }
+        }
+    }
+
+    return gAMLinesInView;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: returns the cached floating point coordinates for the specified line.
+// Only valid for line indexes returned by the last call to 'AM_GetLinesInView'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+const amlinecoords_t& AM_GetLineCoords(const int32_t lineIdx) noexcept {
+    return gAMLineCoords[lineIdx];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: returns the distance in map units (rounded up) that spans the given number of pixels on the classic renderer's automap.
+// Saturates instead of overflowing at small zoom levels.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static fixed_t AM_PixelsToMapDist(const int32_t numPixels, const fixed_t scale) noexcept {
+    // Line points are transformed to pixels via: d_fixed_to_int(FixedMul(mapDist / SCREEN_W, scale))
+    const int64_t mapDist = (((int64_t) numPixels * SCREEN_W) << (FRACBITS * 2)) / std::max<fixed_t>(scale, 1) + SCREEN_W;
+    return (fixed_t) std::min<int64_t>(mapDist, INT32_MAX);
+}
+
 #endif  // #if PSYDOOM_MODS
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -79,6 +263,11 @@ void AM_Start() noexcept {
     gAutomapYMin = gBlockmapOriginY;
     gAutomapXMax = d_lshift<MAPBLOCKSHIFT>(gBlockmapWidth) + gBlockmapOriginX;
     gAutomapYMax = d_lshift<MAPBLOCKSHIFT>(gBlockmapHeight) + gBlockmapOriginY;
+
+    // PsyDoom: build the grid used to cull automap lines up front, so there is no hitch when first opening the automap
+    #if PSYDOOM_MODS
+        AM_BuildLineGrid();
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -283,11 +472,26 @@ void AM_Drawer() noexcept {
         }
     #endif
 
-    // Draw all the map lines
+    // PsyDoom: figure out how far the view extends in map units, with a few pixels of margin, for culling lines and things.
+    // Anything outside of this area is guaranteed to be rejected by 'DrawLine' anyway.
+    #if PSYDOOM_MODS
+        const fixed_t halfViewW = AM_PixelsToMapDist(HALF_SCREEN_W + 8, scale);
+        const fixed_t halfViewH = AM_PixelsToMapDist(100 + 8, scale);
+    #endif
+
+    // Draw all the map lines.
+    // PsyDoom: only consider lines in automap grid cells overlapping the view, instead of every line in the map.
     {
-        const line_t* pLine = gpLines;
+        #if PSYDOOM_MODS
+            const std::vector<int32_t>& linesInView = AM_GetLinesInView(ox, oy, halfViewW, halfViewH);
+
+            for (const int32_t lineIdx : linesInView) {
+                const line_t* const pLine = &gpLines[lineIdx];
+        #else
+            const line_t* pLine = gpLines;
 
-        for (int32_t lineIdx = 0; lineIdx < gNumLines; ++lineIdx, ++pLine) {
+            for (int32_t lineIdx = 0; lineIdx < gNumLines; ++lineIdx, ++pLine) {
+        #endif
             // See whether we should draw the automap line or not
             const bool bHiddenLine = (pLine->flags & ML_DONTDRAW);
             const bool bLineSeen = ((pLine->flags & ML_MAPPED) && (!bHiddenLine));
@@ -351,6 +555,17 @@ void AM_Drawer() noexcept {
             if (pMobj == curPlayer.mo)
                 continue;
 
+            // PsyDoom: skip things that are too far outside of the view to be visible, before doing any other work
+            #if PSYDOOM_MODS
+                const int64_t thingViewDx = (int64_t) pMobj->x.renderValue() - ox;
+                const int64_t thingViewDy = (int64_t) pMobj->y.renderValue() - oy;
+                const int64_t thingCullDistX = (int64_t) halfViewW + AM_THING_TRI_SIZE * FRACUNIT;
+                const int64_t thingCullDistY = (int64_t) halfViewH + AM_THING_TRI_SIZE * FRACUNIT;
+
+                if ((thingViewDx < -thingCullDistX) || (thingViewDx > thingCullDistX) || (thingViewDy < -thingCullDistY) || (thingViewDy > thingCullDistY))
+                    continue;
+            #endif
+
             // Compute the the sine and cosines for the angles of the 3 points in the triangle
             const uint32_t fineAng1 = (pMobj->angle                ) >> ANGLETOFINESHIFT;
             const uint32_t fineAng2 = (pMobj->angle - ANG90 - ANG45) >> ANGLETOFINESHIFT;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Doom/doomdef.h"
+
 #include <cstdint>
+#include <vector>
 
 struct player_t;
 
@@ -15,6 +18,19 @@ static constexpr uint32_t AM_COLOR_YELLOW  = 0xCCCC00;
 static constexpr uint32_t AM_COLOR_GREY    = 0x808080;
 static constexpr uint32_t AM_COLOR_AQUA    = 0x0080FF;
 
+#if PSYDOOM_MODS
+    // PsyDoom: the map coordinates of an automap line in floating point format
+    struct amlinecoords_t {
+        float x1, y1;
+        float x2, y2;
+    };
+#endif
+
 void AM_Start() noexcept;
 void AM_Control(player_t& player) noexcept;
 void AM_Drawer() noexcept;
+
+#if PSYDOOM_MODS
+    const std::vector<int32_t>& AM_GetLinesInView(const fixed_t viewX, const fixed_t viewY, const fixed_t halfViewW, const fixed_t halfViewH) noexcept;
+    const amlinecoords_t& AM_GetLineCoords(const int32_t lineIdx) noexcept;
+#endif
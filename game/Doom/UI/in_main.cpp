@@ -151,7 +151,7 @@ static int32_t  gIntermissionStage;
 
 #if PSYDOOM_MODS
     // PsyDoom: a flag which allows hiding of the 'Entering <MAP_NAME>' message and the password
-    bool gbIntermissionHideNextMap;
+    SIM_TLS bool gbIntermissionHideNextMap;
 #endif
 
 //------------------------------------------------------------------------------------------------------------------------------------------
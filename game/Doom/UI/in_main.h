@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 // PsyDoom: these are now defined in the 'MapInfo' module and can be overriden for new user maps
 #if !PSYDOOM_MODS
@@ -9,7 +10,7 @@
 #endif
 
 #if PSYDOOM_MODS
-    extern bool gbIntermissionHideNextMap;
+    extern SIM_TLS bool gbIntermissionHideNextMap;
 #endif
 
 void IN_Start() noexcept;
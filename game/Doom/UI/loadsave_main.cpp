@@ -12,7 +12,6 @@
 #include "Doom/Base/i_texcache.h"
 #include "Doom/Base/s_sound.h"
 #include "Doom/Base/sounds.h"
-#include "Doom/Base/w_wad.h"
 #include "Doom/d_main.h"
 #include "Doom/Game/g_game.h"
 #include "Doom/Game/p_tick.h"
@@ -24,6 +23,7 @@
 #include "m_main.h"
 #include "o_main.h"
 #include "PsyDoom/Game.h"
+#include "PsyDoom/Rewind.h"
 #include "PsyDoom/SaveAndLoad.h"
 #include "PsyDoom/SaveDataTypes.h"
 #include "PsyDoom/Utils.h"
@@ -562,7 +562,9 @@ gameaction_t LoadGameForSlot(const SaveFileSlot slot, const LoadGameContext load
 
     // Do we need to switch map?
     // If that is the case we must warp to the next map and try to load the save on starting it.
-    const bool bIsMapLoaded = (gbIsLevelDataCached && (SaveAndLoad::getBufferedSaveMapNum() == gGameMap));
+    // Note: the map is also reloaded if the map data has changed since it was loaded (map hash mismatch), since it might have been
+    // edited on disk. The map hash will be verified again after it is reloaded.
+    const bool bIsMapLoaded = SaveAndLoad::isBufferedSaveForLoadedMap();
 
     if (!bIsMapLoaded) {
         gbLoadSaveOnLevelStart = true;
@@ -576,6 +578,10 @@ gameaction_t LoadGameForSlot(const SaveFileSlot slot, const LoadGameContext load
     const LoadSaveResult loadSaveResult = SaveAndLoad::load();
     SaveAndLoad::clearBufferedSave();
 
+    #if PSYDOOM_MODS
+        Rewind::reset();    // PsyDoom: the rewind history is for a different timeline now
+    #endif
+
     // If that failed then show an error menu
     switch (loadSaveResult) {
         case LoadSaveResult::OK:            break;
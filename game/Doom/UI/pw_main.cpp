@@ -31,9 +31,9 @@ const char gPasswordChars[NUM_PW_CHARS + 1] = "bcdfghjklmnpqrstvwxyz0123456789!"
 static uint32_t     gInvalidPasswordFlashTicsLeft;      // How many ticks left to flash 'invalid password' for after entering a wrong password
 static int32_t      gCurPasswordCharIdx;                // Which password character is currently selected/highlighted for input
 
-int32_t     gNumPasswordCharsEntered;               // How many characters have been input for the current password sequence
-uint8_t     gPasswordCharBuffer[PW_SEQ_LEN];        // The password input buffer
-bool        gbUsingAPassword;                       // True if a valid password is currently being used
+int32_t             gNumPasswordCharsEntered;           // How many characters have been input for the current password sequence
+uint8_t             gPasswordCharBuffer[PW_SEQ_LEN];    // The password input buffer
+SIM_TLS bool        gbUsingAPassword;                   // True if a valid password is currently being used
 
 #if PSYDOOM_MODS
 //------------------------------------------------------------------------------------------------------------------------------------------
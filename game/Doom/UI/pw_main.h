@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 // How many password characters are available for the password system
 static constexpr int32_t NUM_PW_CHARS = 32;
@@ -8,10 +9,10 @@ static constexpr int32_t NUM_PW_CHARS = 32;
 // The length of a password sequence
 static constexpr int32_t PW_SEQ_LEN = 10;
 
-extern const char   gPasswordChars[NUM_PW_CHARS + 1];
-extern int32_t      gNumPasswordCharsEntered;
-extern uint8_t      gPasswordCharBuffer[PW_SEQ_LEN];
-extern bool         gbUsingAPassword;
+extern const char           gPasswordChars[NUM_PW_CHARS + 1];
+extern int32_t              gNumPasswordCharsEntered;
+extern uint8_t              gPasswordCharBuffer[PW_SEQ_LEN];
+extern SIM_TLS bool         gbUsingAPassword;
 
 void START_PasswordScreen() noexcept;
 void STOP_PasswordScreen(const gameaction_t exitAction) noexcept;
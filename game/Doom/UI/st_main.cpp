@@ -89,17 +89,17 @@ const facesprite_t gFaceSprites[NUMFACES] = {
     { 114, 204, 204, 137, 28, 30 }      // STSPLAT4 - 46
 };
 
-sbflash_t   gFlashCards[NUMCARDS];      // State relating to flashing keycards on the status bar
-stbar_t     gStatusBar;                 // The main state for the status bar
+SIM_TLS sbflash_t   gFlashCards[NUMCARDS];      // State relating to flashing keycards on the status bar
+SIM_TLS stbar_t     gStatusBar;                 // The main state for the status bar
 
 // Face related state
-int32_t                 gFaceTics;              // Ticks left for current face
-bool                    gbDrawSBFace;           // Draw the face sprite?
-const facesprite_t*     gpCurSBFaceSprite;      // Which sprite to draw
-bool                    gbGibDraw;              // Are we animating the face being gibbed?
-bool                    gbDoSpclFace;           // Should we do a special face next?
-int32_t                 gNewFace;               // Which normal face to use next
-spclface_e              gSpclFaceType;          // Which special face to use next
+SIM_TLS int32_t                 gFaceTics;              // Ticks left for current face
+SIM_TLS bool                    gbDrawSBFace;           // Draw the face sprite?
+SIM_TLS const facesprite_t*     gpCurSBFaceSprite;      // Which sprite to draw
+SIM_TLS bool                    gbGibDraw;              // Are we animating the face being gibbed?
+SIM_TLS bool                    gbDoSpclFace;           // Should we do a special face next?
+SIM_TLS int32_t                 gNewFace;               // Which normal face to use next
+SIM_TLS spclface_e              gSpclFaceType;          // Which special face to use next
 
 #if PSYDOOM_MODS
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 // Describes 1 frame of a status bar face sprite
 struct facesprite_t {
@@ -62,16 +63,16 @@ static constexpr int32_t FIRSTSPLAT = 42;   // Gib frames
 // Which slot (by index) on the weapon micronumbers display each weapon maps to
 static constexpr int32_t WEAPON_MICRO_INDEXES[NUMWEAPONS] = { 0, 1, 2, 3, 4, 5, 6, 7, 0 };
 
-extern sbflash_t                gFlashCards[NUMCARDS];
-extern const facesprite_t       gFaceSprites[NUMFACES];
-extern stbar_t                  gStatusBar;
-extern int32_t                  gFaceTics;
-extern bool                     gbDrawSBFace;
-extern const facesprite_t*      gpCurSBFaceSprite;
-extern bool                     gbGibDraw;
-extern bool                     gbDoSpclFace;
-extern int32_t                  gNewFace;
-extern spclface_e               gSpclFaceType;
+extern SIM_TLS sbflash_t                gFlashCards[NUMCARDS];
+extern const facesprite_t               gFaceSprites[NUMFACES];
+extern SIM_TLS stbar_t                  gStatusBar;
+extern SIM_TLS int32_t                  gFaceTics;
+extern SIM_TLS bool                     gbDrawSBFace;
+extern SIM_TLS const facesprite_t*      gpCurSBFaceSprite;
+extern SIM_TLS bool                     gbGibDraw;
+extern SIM_TLS bool                     gbDoSpclFace;
+extern SIM_TLS int32_t                  gNewFace;
+extern SIM_TLS spclface_e               gSpclFaceType;
 
 void ST_Init() noexcept;
 void ST_InitEveryLevel() noexcept;
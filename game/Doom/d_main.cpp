@@ -12,13 +12,17 @@
 #include "FatalErrors.h"
 #include "FileUtils.h"
 #include "Finally.h"
+#include "MappedFile.h"
 #include "Game/g_game.h"
 #include "Game/p_info.h"
 #include "Game/p_spec.h"
 #include "Game/p_switch.h"
 #include "Game/p_tick.h"
 #include "Game/sprinfo.h"
+#include "psx_main.h"
 #include "PsyDoom/Config/Config.h"
+#include "PsyDoom/DemoBatch.h"
+#include "PsyDoom/DemoCompact.h"
 #include "PsyDoom/DemoPlayer.h"
 #include "PsyDoom/DemoRecorder.h"
 #include "PsyDoom/Game.h"
@@ -27,14 +31,19 @@
 #include "PsyDoom/IntroLogos.h"
 #include "PsyDoom/MapInfo/MapInfo.h"
 #include "PsyDoom/Movie/MoviePlayer.h"
+#include "PsyDoom/NetRelayClient.h"
+#include "PsyDoom/NetRollback.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/PsxPadButtons.h"
+#include "PsyDoom/StateHash.h"
 #include "PsyDoom/Utils.h"
 #include "PsyDoom/Video.h"
 #include "PsyQ/LIBGPU.h"
 #include "Renderer/r_data.h"
 #include "Renderer/r_main.h"
+#include "RendererVk/rv_main.h"
 #include "UI/cr_main.h"
 #include "UI/le_main.h"
 #include "UI/m_main.h"
@@ -43,9 +52,12 @@
 #include "UI/ti_main.h"
 
 #if PSYDOOM_VULKAN_RENDERER
+    #include "PsyDoom/Vulkan/VDrawing.h"
+    #include "PsyDoom/Vulkan/VGpuProfiler.h"
     #include "PsyDoom/Vulkan/VRenderer.h"
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <memory>
@@ -56,46 +68,46 @@
 #endif
 
 // The current number of 1 vblank ticks
-int32_t gTicCon;
+SIM_TLS int32_t gTicCon;
 
 // The number of elapsed vblanks for all players
-int32_t gPlayersElapsedVBlanks[MAXPLAYERS];
+SIM_TLS int32_t gPlayersElapsedVBlanks[MAXPLAYERS];
 
 // PsyDoom: networking - what amount of elapsed vblanks we told the other player we will simulate next
 #if PSYDOOM_MODS
-    int32_t gNextPlayerElapsedVBlanks;
+    SIM_TLS int32_t gNextPlayerElapsedVBlanks;
 #endif
 
 // Pointer to a buffer holding the demo and the current pointer within the buffer for playback/recording
-std::byte*  gpDemoBuffer;
-std::byte*  gpDemo_p;
+SIM_TLS std::byte*  gpDemoBuffer;
+SIM_TLS std::byte*  gpDemo_p;
 
 #if PSYDOOM_MODS
     // PsyDoom: info about the current classic demo being played (what game mode to use etc.)
-    ClassicDemoDef gCurClassicDemo;
+    SIM_TLS ClassicDemoDef gCurClassicDemo;
 #endif
 
 // Game start parameters
-skill_t     gStartSkill         = sk_medium;
-int32_t     gStartMapOrEpisode  = 1;
-gametype_t  gStartGameType      = gt_single;
+SIM_TLS skill_t     gStartSkill         = sk_medium;
+SIM_TLS int32_t     gStartMapOrEpisode  = 1;
+SIM_TLS gametype_t  gStartGameType      = gt_single;
 
 // Net games: set if a network game being started was aborted
-bool gbDidAbortGame = false;
+SIM_TLS bool gbDidAbortGame = false;
 
 #if PSYDOOM_MODS
-    bool        gbStartupWarpToMap = false;     // PsyDoom: warp straight to a map and bypass menus on starting a new game? (map development tool)
-    double      gPrevFrameDuration;             // How long the previous frame took: used to try and provide more accurate interpolation
-    float       gPerfAvgFps;                    // Performance counter: averaged FPS for the last few frames
-    float       gPerfAvgUsec;                   // Performance counter: averaged microseconds duration for the last few frames
-    bool        gbIsFirstTick;                  // Set to 'true' for the very first tick only, 'false' thereafter
-    bool        gbKeepInputEvents;              // Ticker request: if true then don't consume input events after invoking the current ticker in 'MiniLoop'
-    std::byte*  gpDemoBufferEnd;                // PsyDoom: save the end pointer for the buffer, so we know when to end the demo; do this instead of hardcoding the end
-    bool        gbDoInPlaceLevelReload;         // PsyDoom developer feature: reload the map but preserve player position and orientation? Allows for fast preview of changes.
-    fixed_t     gInPlaceReloadPlayerX;          // Where to position the player after doing the 'in place' level reload (x)
-    fixed_t     gInPlaceReloadPlayerY;          // Where to position the player after doing the 'in place' level reload (y)
-    fixed_t     gInPlaceReloadPlayerZ;          // Where to position the player after doing the 'in place' level reload (z)
-    angle_t     gInPlaceReloadPlayerAng;        // Angle of the player when doing an 'in place' level releoad
+    SIM_TLS bool        gbStartupWarpToMap = false;     // PsyDoom: warp straight to a map and bypass menus on starting a new game? (map development tool)
+    SIM_TLS double      gPrevFrameDuration;             // How long the previous frame took: used to try and provide more accurate interpolation
+    SIM_TLS float       gPerfAvgFps;                    // Performance counter: averaged FPS for the last few frames
+    SIM_TLS float       gPerfAvgUsec;                   // Performance counter: averaged microseconds duration for the last few frames
+    SIM_TLS bool        gbIsFirstTick;                  // Set to 'true' for the very first tick only, 'false' thereafter
+    SIM_TLS bool        gbKeepInputEvents;              // Ticker request: if true then don't consume input events after invoking the current ticker in 'MiniLoop'
+    SIM_TLS std::byte*  gpDemoBufferEnd;                // PsyDoom: save the end pointer for the buffer, so we know when to end the demo; do this instead of hardcoding the end
+    SIM_TLS bool        gbDoInPlaceLevelReload;         // PsyDoom developer feature: reload the map but preserve player position and orientation? Allows for fast preview of changes.
+    SIM_TLS fixed_t     gInPlaceReloadPlayerX;          // Where to position the player after doing the 'in place' level reload (x)
+    SIM_TLS fixed_t     gInPlaceReloadPlayerY;          // Where to position the player after doing the 'in place' level reload (y)
+    SIM_TLS fixed_t     gInPlaceReloadPlayerZ;          // Where to position the player after doing the 'in place' level reload (z)
+    SIM_TLS angle_t     gInPlaceReloadPlayerAng;        // Angle of the player when doing an 'in place' level releoad
 
     // When using PAL timings and NOT using demo timings this tells how many vblanks the current game/world tick will last for.
     // If 'true' then the current world tick will last for 4 vblanks, otherwise it will last for 2 vblanks.
@@ -113,12 +125,15 @@ bool gbDidAbortGame = false;
     //
     // Note also that we DON'T have to make this long vs short tick interpolation adjustment when we are using demo timings with PAL since
     // player ticks are perfectly synchronized (they fire at the same time) as world ticks in that situation.
-    bool gbIsLongGameTick;
+    SIM_TLS bool gbIsLongGameTick;
 #endif
 
 // Debug draw string position
-static int32_t gDebugDrawStringXPos;
-static int32_t gDebugDrawStringYPos;
+static SIM_TLS int32_t gDebugDrawStringXPos;
+static SIM_TLS int32_t gDebugDrawStringYPos;
+
+// PsyDoomSim: only plays demos and has its own entry point (see 'PsyDoom/Sim/SimMain.cpp'), so none of this is needed
+#if !PSYDOOM_SIM
 
 #if PSYDOOM_MODS
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -213,6 +228,8 @@ void D_DoomMain() noexcept {
     #if PSYDOOM_MODS
         // PsyDoom: new cleanup logic before we exit
         const auto dmainCleanup = finally([]() noexcept {
+            NetRelayClient::shutdown();
+            StateHash::shutdown();
             MapInfo::shutdown();
             W_Shutdown();
         });
@@ -227,7 +244,7 @@ void D_DoomMain() noexcept {
 
         // PsyDoom: play intro movies and logos unless disabled.
         // Note: also skip them if we are playing a demo file or warping directly to a map.
-        const bool bSkipIntros = (Config::gbSkipIntros || ProgArgs::gPlayDemoFilePath[0] || gbStartupWarpToMap);
+        const bool bSkipIntros = (Config::gbSkipIntros || ProgArgs::gPlayDemoFilePath[0] || gbStartupWarpToMap || ProgArgs::gbSpectate);
 
         if (!bSkipIntros) {
             D_PlayIntros();
@@ -270,6 +287,33 @@ void D_DoomMain() noexcept {
             return;
         }
 
+        // PsyDoom: play a batch of demo files and exit if commanded
+        if (ProgArgs::gBatchDemosListFilePath[0]) {
+            DemoBatch::run(ProgArgs::gBatchDemosListFilePath);
+            return;
+        }
+
+        // PsyDoom: convert a demo file to the compact demo format and exit if commanded.
+        // A failed conversion is reported via the program's return code, like a failed demo result check.
+        if (ProgArgs::gCompactDemoInFilePath[0]) {
+            if (!DemoCompact::convertDemoFile(ProgArgs::gCompactDemoInFilePath, ProgArgs::gCompactDemoOutFilePath)) {
+                gbCheckDemoResultFailed = true;
+            }
+
+            return;
+        }
+
+        // PsyDoom: watch a game streamed via a spectator relay and exit if commanded
+        if (ProgArgs::gbSpectate) {
+            NetRelayClient::runSpectatorSession();
+            return;
+        }
+
+        // PsyDoom: connect to a spectator relay to stream games to, if commanded
+        if (ProgArgs::gbRelayTap) {
+            NetRelayClient::connectTap();
+        }
+
         if (ProgArgs::gbHeadlessMode)
             return;
     #endif
@@ -376,6 +420,8 @@ gameaction_t RunTitle() noexcept {
     return MiniLoop(START_Title, STOP_Title, TIC_Title, DRAW_Title);
 }
 
+#endif  // #if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Load and run the specified (built-in) demo file
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -436,13 +482,20 @@ gameaction_t RunDemoAtPath(const char* const filePath) noexcept {
         I_LoadAndCacheTexLump(gTex_LOADING, "LOADING", 0);
     }
 
-    // Read the demo file into memory
-    const FileData fileData = FileUtils::getContentsOfFile(filePath);
+    // Memory map the demo file so that only the parts of it which are used get read in, which matters for long demos.
+    // If mapping fails for some reason then fallback to reading the entire file into memory.
+    MappedFile mappedFile;
+    const bool bMappedFile = mappedFile.open(filePath);
+    const FileData fileData = (bMappedFile) ? FileData() : FileUtils::getContentsOfFile(filePath);
 
-    if (!fileData.bytes) {
+    if ((!bMappedFile) && (!fileData.bytes)) {
         FatalErrors::raiseF("Unable to read demo file '%s'! Is the file path valid?", filePath);
     }
 
+    // Note: demo playback only reads from the demo buffer, so it's fine to point it at the read only file mapping
+    std::byte* const pDemoBytes = (bMappedFile) ? const_cast<std::byte*>(mappedFile.getData()) : fileData.bytes.get();
+    const size_t demoSize = (bMappedFile) ? mappedFile.getSize() : fileData.size;
+
     // Set the info for the current classic demo in case we are playing one of those.
     // Use the current game settings to determine the demo's game behavior and format.
     ClassicDemoDef& demoDef = gCurClassicDemo;
@@ -451,8 +504,8 @@ gameaction_t RunDemoAtPath(const char* const filePath) noexcept {
     demoDef.bPalDemo = (Game::gGameVariant == GameVariant::PAL);
 
     // Setup the demo buffers and play the demo file
-    gpDemoBuffer = fileData.bytes.get();
-    gpDemoBufferEnd = fileData.bytes.get() + fileData.size;
+    gpDemoBuffer = pDemoBytes;
+    gpDemoBufferEnd = pDemoBytes + demoSize;
 
     const gameaction_t exitAction = G_PlayDemoPtr();
 
@@ -550,7 +603,8 @@ void I_DebugDrawString(const char* const fmtMsg, ...) noexcept {
     gDebugDrawStringYPos += 8;
 }
 
-#if PSYDOOM_MODS
+// PsyDoomSim: never draws anything and has no renderer or sound stats to show, see 'PsyDoom/Sim/SimStubs.cpp' for the replacement
+#if PSYDOOM_MODS && !PSYDOOM_SIM
 //------------------------------------------------------------------------------------------------------------------------------------------
 // PsyDoom: draws frame performance counters (average frame duration and FPS) at the top left of the screen if they are enabled
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -587,8 +641,84 @@ void I_DrawEnabledPerfCounters() noexcept {
     // Show average FPS counter
     std::snprintf(msgBuffer, sizeof(msgBuffer), "FPS:  %.1f", gPerfAvgFps);
     I_DrawStringSmall(2 + widescreenAdjust, 10, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+
+    // Show how long the last load of map sound and music took and how many of the LCD files were already in host RAM
+    std::snprintf(msgBuffer, sizeof(msgBuffer), "SNDLOAD: %zu (%u/%u LCD)", (size_t)(gSoundLoadUsec + 0.5f), gSoundLoadNumCachedLcds, gSoundLoadNumLcds);
+    I_DrawStringSmall(2 + widescreenAdjust, 18, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+
+    // Where to show the most expensive profiler zones: after all the other counters
+    int32_t profilerZonesY = 26;
+
+    // Show pipeline binds, uniform pushes and draws for the last frame (before and after optimization) if using the Vulkan renderer
+    #if PSYDOOM_VULKAN_RENDERER
+        int32_t gpuTimingsY = 26;
+
+        if (Video::isUsingVulkanRenderPath()) {
+            VDrawing::DrawCmdStats statsBefore = {};
+            VDrawing::DrawCmdStats statsAfter = {};
+            VDrawing::getLastFrameDrawCmdStats(statsBefore, statsAfter);
+
+            std::snprintf(msgBuffer, sizeof(msgBuffer), "BINDS: %u/%u", statsBefore.numPipelineBinds, statsAfter.numPipelineBinds);
+            I_DrawStringSmall(2 + widescreenAdjust, 26, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+            std::snprintf(msgBuffer, sizeof(msgBuffer), "PUSHES: %u/%u", statsBefore.numUniformPushes, statsAfter.numUniformPushes);
+            I_DrawStringSmall(2 + widescreenAdjust, 34, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+            std::snprintf(msgBuffer, sizeof(msgBuffer), "DRAWS: %u/%u", statsBefore.numDraws, statsAfter.numDraws);
+            I_DrawStringSmall(2 + widescreenAdjust, 42, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+
+            // Show how long world geometry generation took and on how many threads
+            std::snprintf(msgBuffer, sizeof(msgBuffer), "GEOM: %zu (%u THR)", (size_t)(gRvGeomGenUsec + 0.5f), gRvGeomGenNumThreads);
+            I_DrawStringSmall(2 + widescreenAdjust, 50, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+            gpuTimingsY = 58;
+            profilerZonesY = 58;
+        }
+
+        // Show GPU timings for the frame, render path and the sky, world and UI (these are a couple of frames behind)
+        VGpuProfiler::FrameTimings gpuTimings = {};
+
+        if ((Video::gBackendType == Video::BackendType::Vulkan) && VGpuProfiler::getLastResolvedTimings(gpuTimings)) {
+            const auto usecToInt = [](const float usec) noexcept { return (size_t)(std::max(usec, 0.0f) + 0.5f); };
+
+            float pathUsec = 0.0f;
+
+            for (uint32_t passIdx = (uint32_t) VGpuProfiler::Pass::PathPsx; passIdx <= (uint32_t) VGpuProfiler::Pass::PathBlit; ++passIdx) {
+                pathUsec = std::max(pathUsec, gpuTimings.passUsec[passIdx]);
+            }
+
+            std::snprintf(
+                msgBuffer,
+                sizeof(msgBuffer),
+                "GPU: %zu (PATH %zu)",
+                usecToInt(gpuTimings.passUsec[(uint32_t) VGpuProfiler::Pass::Frame]),
+                usecToInt(pathUsec)
+            );
+
+            I_DrawStringSmall(2 + widescreenAdjust, gpuTimingsY, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+
+            std::snprintf(
+                msgBuffer,
+                sizeof(msgBuffer),
+                "GPU SKY/WLD/UI: %zu/%zu/%zu",
+                usecToInt(gpuTimings.passUsec[(uint32_t) VGpuProfiler::Pass::Sky]),
+                usecToInt(gpuTimings.passUsec[(uint32_t) VGpuProfiler::Pass::World]),
+                usecToInt(gpuTimings.uiUsec)
+            );
+
+            I_DrawStringSmall(2 + widescreenAdjust, gpuTimingsY + 8, msgBuffer, Game::getTexPalette_STATUS(), 128, 255, 255, false, false);
+            profilerZonesY = gpuTimingsY + 16;
+        }
+    #endif
+
+    // Show the profiler zones with the most time spent in them per frame (on all threads)
+    Profiler::ZoneSummary topZones[Profiler::MAX_TOP_ZONES];
+    const uint32_t numTopZones = Profiler::getTopZones(topZones);
+
+    for (uint32_t zoneIdx = 0; zoneIdx < numTopZones; ++zoneIdx) {
+        const Profiler::ZoneSummary& zone = topZones[zoneIdx];
+        std::snprintf(msgBuffer, sizeof(msgBuffer), "%.20s: %zu", zone.name, (size_t)(zone.usecPerFrame + 0.5f));
+        I_DrawStringSmall(2 + widescreenAdjust, profilerZonesY + (int32_t) zoneIdx * 8, msgBuffer, Game::getTexPalette_STATUS(), 255, 255, 128, false, false);
+    }
 }
-#endif  // #if PSYDOOM_MODS
+#endif  // #if PSYDOOM_MODS && !PSYDOOM_SIM
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Set a region of memory to a specified byte value.
@@ -727,6 +857,11 @@ gameaction_t MiniLoop(
         I_NetHandshake();
     }
 
+    // PsyDoom: begin a new sequence of frames for rollback netcode (if active)
+    #if PSYDOOM_MODS
+        const bool bNetRollbackLoop = NetRollback::beginLoop();
+    #endif
+
     // Init timers and exit action
     gGameAction = ga_nothing;
     gPrevGameTic = 0;
@@ -775,6 +910,11 @@ gameaction_t MiniLoop(
     gameaction_t exitAction = ga_nothing;
 
     while (true) {
+        // PsyDoom: time each iteration of the game loop with the profiler
+        #if PSYDOOM_MODS
+            PROFILE_ZONE("Frame");
+        #endif
+
         // PsyDoom: initially assume no elasped vblanks for all players until found otherwise.
         // For net games we should get some elapsed vblanks from the other player in their packet, if it's time to read a new packet.
         // It will be time to read a new packet if we update inputs and timing.
@@ -795,6 +935,10 @@ gameaction_t MiniLoop(
         #endif
 
         if (bUpdateInputsAndTiming) {
+            #if PSYDOOM_MODS
+                PROFILE_ZONE("Input");
+            #endif
+
             // Read pad inputs and save as the current pad buttons (note: overwritten if a demo); also save old inputs for button just pressed detection.
             // PsyDoom: read tick inputs in addition to raw gamepad inputs, this is now the primary input source.
             #if PSYDOOM_MODS
@@ -843,6 +987,13 @@ gameaction_t MiniLoop(
                 }
 
                 #if PSYDOOM_MODS
+                    // PsyDoom: rollback netcode may have found the game loop exited while re-simulating frames, in which case exit now
+                    if (NetRollback::getPendingExitAction() != ga_nothing) {
+                        exitAction = NetRollback::getPendingExitAction();
+                        gGameAction = exitAction;
+                        break;
+                    }
+
                     // PsyDoom: recording demo ticks for multiplayer mode
                     if (DemoRecorder::isRecording()) {
                         DemoRecorder::recordTick();
@@ -947,27 +1098,35 @@ gameaction_t MiniLoop(
                 #endif
             }
 
-            // Advance the number of 1 vblank ticks passed.
-            // N.B: the tick count used here is ALWAYS for player 1, this is how time is kept in sync for a network game.
-            gTicCon += gPlayersElapsedVBlanks[0];
+            // PsyDoom: save or verify the game state hash for the demo tick just read or recorded (if requested).
+            // Stop demo playback on the first tick which does not match the expected hash.
+            #if PSYDOOM_MODS
+                if ((gbDemoPlayback || gbDemoRecording) && StateHash::isTracing()) {
+                    if (!StateHash::traceDemoTick()) {
+                        gbCheckDemoResultFailed = true;
+                        exitAction = ga_exitdemo;
+                        gGameAction = ga_exitdemo;
+                        break;
+                    }
+                }
+            #endif
 
-            // Advance to the next game tick if it is time; video refreshes at 60 Hz (NTSC) but the game ticks at 15 Hz (NTSC).
-            // PsyDoom: some tweaks here also to make PAL mode gameplay behave the same as the original game.
+            // Advance the number of 1 vblank ticks passed and advance to the next game tick if it is time.
+            // PsyDoom: this logic is now in a helper function, since rollback netcode needs to re-run it when re-simulating frames.
             #if PSYDOOM_MODS
-                const int32_t tgtGameTicCount = (Game::gSettings.bUsePalTimings) ? gTicCon / 3 : d_rshift<VBLANK_TO_TIC_SHIFT>(gTicCon);
+                D_AdvanceTicCon();
             #else
-                const int32_t tgtGameTicCount = d_rshift<VBLANK_TO_TIC_SHIFT>(gTicCon);
-            #endif
+                // N.B: the tick count used here is ALWAYS for player 1, this is how time is kept in sync for a network game.
+                gTicCon += gPlayersElapsedVBlanks[0];
 
-            if (gLastTgtGameTicCount < tgtGameTicCount) {
-                gLastTgtGameTicCount = tgtGameTicCount;
-                gGameTic++;
+                // Advance to the next game tick if it is time; video refreshes at 60 Hz (NTSC) but the game ticks at 15 Hz (NTSC)
+                const int32_t tgtGameTicCount = d_rshift<VBLANK_TO_TIC_SHIFT>(gTicCon);
 
-                // PsyDoom: update the adjustments we make to interpolation for the PAL case (outside of demo timings)
-                #if PSYDOOM_MODS
-                    D_UpdateIsLongGameTick();
-                #endif
-            }
+                if (gLastTgtGameTicCount < tgtGameTicCount) {
+                    gLastTgtGameTicCount = tgtGameTicCount;
+                    gGameTic++;
+                }
+            #endif
         }
 
         // Call the ticker function to do updates for the frame.
@@ -975,6 +1134,14 @@ gameaction_t MiniLoop(
         // That allows for possible update logic which runs > 30 Hz in future, like framerate uncapped turning movement.
         exitAction = pTicker();
 
+        // PsyDoom: with rollback netcode the exit might have happened on a frame which used predicted inputs for the other player.
+        // Make sure the exit really happens with the other player's actual inputs, so that both players leave the loop together.
+        #if PSYDOOM_MODS
+            if (bNetRollbackLoop) {
+                exitAction = NetRollback::confirmGameAction(exitAction);
+            }
+        #endif
+
         if (exitAction != ga_nothing)
             break;
 
@@ -984,6 +1151,7 @@ gameaction_t MiniLoop(
         #if PSYDOOM_MODS
             if (!gbKeepInputEvents) {
                 Utils::checkForRendererToggleInput();
+                Utils::checkForProfilerCaptureToggleInput();
                 Input::consumeEvents();
             } else {
                 gbKeepInputEvents = false;  // Temporary request only!
@@ -1037,12 +1205,19 @@ gameaction_t MiniLoop(
                 profilerNumFramesElapsed = 0;
                 profilerStartTime = now;
             }
+
+            // PsyDoom: collect the profiler zones recorded by all threads during this frame
+            Profiler::endFrame();
         #endif
     }
 
-    // PsyDoom: one last sound update before we exit
+    // PsyDoom: one last sound update before we exit, and let the other player know this loop is done if using rollback netcode
     #if PSYDOOM_MODS
         S_UpdateSounds();
+
+        if (bNetRollbackLoop) {
+            NetRollback::endLoop(exitAction);
+        }
     #endif
 
     // Run cleanup logic for this game loop ending
@@ -1079,6 +1254,25 @@ bool D_GameTickDurationVaries() noexcept {
     return (Game::gSettings.bUsePalTimings && (!Game::gSettings.bUseDemoTimings));
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Advances the count of 1 vblank ticks passed by player 1's elapsed vblanks for this frame, and advances to the next game tick if it is time.
+// Video refreshes at 60 Hz (NTSC) but the game ticks at 15 Hz (NTSC). For PAL mode some tweaks are made so that gameplay behaves the
+// same as the original game.
+//
+// N.B: the tick count used here is ALWAYS for player 1, this is how time is kept in sync for a network game.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void D_AdvanceTicCon() noexcept {
+    gTicCon += gPlayersElapsedVBlanks[0];
+
+    const int32_t tgtGameTicCount = (Game::gSettings.bUsePalTimings) ? gTicCon / 3 : d_rshift<VBLANK_TO_TIC_SHIFT>(gTicCon);
+
+    if (gLastTgtGameTicCount < tgtGameTicCount) {
+        gLastTgtGameTicCount = tgtGameTicCount;
+        gGameTic++;
+        D_UpdateIsLongGameTick();   // Update the adjustments we make to interpolation for the PAL case (outside of demo timings)
+    }
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Updates whether the current game/world tick is a 'long' duration tick.
 // See the documentation of 'gbIsLongGameTick' for more details.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "doomdef.h"
+#include "PsyDoom/Sim/SimTls.h"
 
 #include <cstddef>
 #include <cstring>
@@ -13,39 +14,39 @@
     typedef int32_t CdFileId;
 #endif
 
-extern int32_t      gTicCon;
-extern int32_t      gPlayersElapsedVBlanks[MAXPLAYERS];
+extern SIM_TLS int32_t      gTicCon;
+extern SIM_TLS int32_t      gPlayersElapsedVBlanks[MAXPLAYERS];
 
 #if PSYDOOM_MODS
-    extern int32_t  gNextPlayerElapsedVBlanks;
+    extern SIM_TLS int32_t  gNextPlayerElapsedVBlanks;
 #endif
 
-extern std::byte*   gpDemoBuffer;
-extern std::byte*   gpDemo_p;
+extern SIM_TLS std::byte*   gpDemoBuffer;
+extern SIM_TLS std::byte*   gpDemo_p;
 
 #if PSYDOOM_MODS
-    extern struct ClassicDemoDef gCurClassicDemo;
+    extern SIM_TLS struct ClassicDemoDef gCurClassicDemo;
 #endif
 
-extern skill_t      gStartSkill;
-extern int32_t      gStartMapOrEpisode;
-extern gametype_t   gStartGameType;
-extern bool         gbDidAbortGame;
+extern SIM_TLS skill_t      gStartSkill;
+extern SIM_TLS int32_t      gStartMapOrEpisode;
+extern SIM_TLS gametype_t   gStartGameType;
+extern SIM_TLS bool         gbDidAbortGame;
 
 #if PSYDOOM_MODS
-    extern bool         gbStartupWarpToMap;
-    extern double       gPrevFrameDuration;
-    extern float        gPerfAvgFps;
-    extern float        gPerfAvgUsec;
-    extern bool         gbIsFirstTick;
-    extern bool         gbKeepInputEvents;
-    extern std::byte*   gpDemoBufferEnd;
-    extern bool         gbDoInPlaceLevelReload;
-    extern fixed_t      gInPlaceReloadPlayerX;
-    extern fixed_t      gInPlaceReloadPlayerY;
-    extern fixed_t      gInPlaceReloadPlayerZ;
-    extern angle_t      gInPlaceReloadPlayerAng;
-    extern bool         gbIsLongGameTick;
+    extern SIM_TLS bool         gbStartupWarpToMap;
+    extern SIM_TLS double       gPrevFrameDuration;
+    extern SIM_TLS float        gPerfAvgFps;
+    extern SIM_TLS float        gPerfAvgUsec;
+    extern SIM_TLS bool         gbIsFirstTick;
+    extern SIM_TLS bool         gbKeepInputEvents;
+    extern SIM_TLS std::byte*   gpDemoBufferEnd;
+    extern SIM_TLS bool         gbDoInPlaceLevelReload;
+    extern SIM_TLS fixed_t      gInPlaceReloadPlayerX;
+    extern SIM_TLS fixed_t      gInPlaceReloadPlayerY;
+    extern SIM_TLS fixed_t      gInPlaceReloadPlayerZ;
+    extern SIM_TLS angle_t      gInPlaceReloadPlayerAng;
+    extern SIM_TLS bool         gbIsLongGameTick;
 #endif
 
 void D_DoomMain() noexcept;
@@ -82,4 +83,5 @@ gameaction_t MiniLoop(
 #if PSYDOOM_MODS
     bool D_GameTickDurationVaries() noexcept;
     void D_UpdateIsLongGameTick() noexcept;
+    void D_AdvanceTicCon() noexcept;
 #endif
@@ -96,6 +96,8 @@ void NetPacket_Connect::byteSwap() noexcept {
     Endian::byteSwapEnumInPlace(startGameSkill);
     Endian::byteSwapInPlace(startMap);
     Endian::byteSwapInPlace(bIsDemoRecording);
+    Endian::byteSwapInPlace(bUseUdpTransport);
+    Endian::byteSwapInPlace(bUseRollback);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -115,6 +117,9 @@ void NetPacket_Tick::byteSwap() noexcept {
     Endian::byteSwapInPlace(elapsedVBlanks);
     Endian::byteSwapInPlace(lastPacketDelayMs);
     inputs.byteSwap();
+    Endian::byteSwapInPlace(frame);
+    Endian::byteSwapInPlace(frameAdvantage);
+    Endian::byteSwapInPlace(hashFrame);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
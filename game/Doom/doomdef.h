@@ -270,6 +270,7 @@ struct mobj_t {
 #if PSYDOOM_MODS
     MobjWeakPtr     tracer;             // Used by homing missiles
     uint32_t        weakCountIdx;       // PsyDoom: index of the weak reference counter allocated for this map object ('0' if there are no weak references to it)
+    uint32_t        blockCellNum;       // PsyDoom: index + 1 of the blockmap cell this map object was last linked into ('0' if not linked into a cell)
 #else
     mobj_t*         tracer;             // Used by homing missiles
 #endif
@@ -527,11 +528,12 @@ struct player_t {
         DEFINE_FLAGS_FIELD_MEMBER(_flags4, 6, fMenuBack)
         DEFINE_FLAGS_FIELD_MEMBER(_flags4, 7, fEnterPasswordChar)
 
-        // UI (continued) and quick save and load keys
+        // UI (continued), quick save and load keys and rewind
         Flags8 _flags5;
         DEFINE_FLAGS_FIELD_MEMBER(_flags5, 0, fDeletePasswordChar)
         DEFINE_FLAGS_FIELD_MEMBER(_flags5, 1, fQuicksave)
         DEFINE_FLAGS_FIELD_MEMBER(_flags5, 2, fQuickload)
+        DEFINE_FLAGS_FIELD_MEMBER(_flags5, 3, fRewind)
 
         // Playstation mouse input movement deltas: used for classic 'Final Doom' demo playback only.
         // These inputs should always be zeroed in all other cases.
@@ -557,13 +559,15 @@ struct player_t {
         skill_t     startGameSkill;     // Only sent by the server for the game: what skill level will be used
         int16_t     startMap;           // Only sent by the server for the game: what starting map will be used
         uint8_t     bIsDemoRecording;   // Whether this player is demo recording: affects whether pause can be used
+        uint8_t     bUseUdpTransport;   // Only sent by the server for the game: whether tick packets are sent over UDP instead of TCP
+        uint8_t     bUseRollback;       // Only sent by the server for the game: whether to use rollback netcode (predict and resimulate) instead of lockstep
 
         // Byte swapping for Endian correction
         void byteSwap() noexcept;
         void endianCorrect() noexcept;
     };
 
-    static_assert(sizeof(NetPacket_Connect) == 20);
+    static_assert(sizeof(NetPacket_Connect) == 24);
 
     // Packet sent/received by all players to share per-tick updates for a network game
     struct NetPacket_Tick {
@@ -571,11 +575,14 @@ struct player_t {
         int32_t     elapsedVBlanks;     // How many vblanks have elapsed for the player sending the update
         int32_t     lastPacketDelayMs;  // Message from this peer: how long the last packet received was delayed from when we expected it (MS). Used to adjust time.
         TickInputs  inputs;             // Inputs for the player sending this update
+        int32_t     frame;              // Rollback netcode only: index of the frame these inputs are for (or '-1' for a marker ending the current game loop)
+        int32_t     frameAdvantage;     // Rollback netcode only: how many frames the sender is ahead of the last frame it received from the receiver
+        int32_t     hashFrame;          // Rollback netcode only: the frame whose starting game state 'errorCheck' is a hash of ('-1' if none)
 
         // Byte swapping for Endian correction
         void byteSwap() noexcept;
         void endianCorrect() noexcept;
     };
 
-    static_assert(sizeof(NetPacket_Tick) == 24);
+    static_assert(sizeof(NetPacket_Tick) == 36);
 #endif
@@ -6,20 +6,26 @@
 #include "PsyDoom/Cheats.h"
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/Controls.h"
+#include "PsyDoom/FrameScheduler.h"
 #include "PsyDoom/Game.h"
 #include "PsyDoom/Input.h"
+#include "PsyDoom/InputLatencyProbe.h"
 #include "PsyDoom/IntroLogos.h"
+#include "PsyDoom/LcdCache.h"
 #include "PsyDoom/ModMgr.h"
+#include "PsyDoom/NetRelay.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/PsxVm.h"
 #include "PsyDoom/Utils.h"
 #include "PsyDoom/Video.h"
+#include "PsyDoom/WorkerThreads.h"
 
 #if PSYDOOM_MODS
     // PsyDoom: a flag set to 'true' if the result of demo playback is unexpected/wrong (when checking demo results).
     // This is used to set the exit code for the application accordingly ('1' if the demo result checks fail, '0' otherwise).
-    bool gbCheckDemoResultFailed = false;
+    SIM_TLS bool gbCheckDemoResultFailed = false;
 #endif
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -51,6 +57,14 @@ int psx_main(const int argc, const char* const* const argv) noexcept {
         Utils::installFatalErrorHandler();
         ProgArgs::init(argc, argv);
 
+        // If running a spectator relay (or a load test against one) then do only that: the game itself is not needed
+        if (ProgArgs::gbRunRelay || (ProgArgs::gRelayLoadTestClients > 0)) {
+            const int exitCode = (ProgArgs::gbRunRelay) ? NetRelay::runServer() : NetRelay::runLoadTest();
+            ProgArgs::shutdown();
+            Utils::uninstallFatalErrorHandler();
+            return exitCode;
+        }
+
         if (!Controls::didInit()) {
             Controls::init();
         }
@@ -61,6 +75,9 @@ int psx_main(const int argc, const char* const* const argv) noexcept {
 
         Input::init();
         PlayerPrefs::load();
+        Profiler::init();
+        FrameScheduler::init();
+        InputLatencyProbe::init();
 
         // Initialize the emulated PSX components using the PSX Doom disc (supplied as a .cue file).
         // This must be provided in order for the game to run.
@@ -84,11 +101,13 @@ int psx_main(const int argc, const char* const* const argv) noexcept {
         Game::determineGameTypeAndVariant();
         CdMapTbl_Init();
 
-        // Initialize the display, modding manager, cheats and intro logos
+        // Initialize the display, modding manager, cheats, intro logos, worker threads and the sound file cache
         Video::initVideo();
         ModMgr::init();
         Cheats::init();
         IntroLogos::init();
+        WorkerThreads::init();
+        LcdCache::init();
     #endif
 
     // Call the original PSX Doom 'main()' function
@@ -96,12 +115,17 @@ int psx_main(const int argc, const char* const* const argv) noexcept {
 
     // PsyDoom: cleanup logic after Doom itself is done and save player prefs (unless headless mode)
     #if PSYDOOM_MODS
-        const bool bIsCheckingADemoResult = (ProgArgs::gCheckDemoResultFilePath[0] != 0);
+        const bool bIsCheckingADemoResult = (ProgArgs::gCheckDemoResultFilePath[0] || ProgArgs::gCheckStateHashesFilePath[0] || ProgArgs::gbDemoSeekCheck || ProgArgs::gBatchDemosListFilePath[0] || ProgArgs::gCompactDemoInFilePath[0]);
 
         if (!ProgArgs::gbHeadlessMode) {
             PlayerPrefs::save();
         }
 
+        InputLatencyProbe::shutdown();
+        FrameScheduler::shutdown();
+        Profiler::shutdown();
+        LcdCache::shutdown();
+        WorkerThreads::shutdown();
         IntroLogos::shutdown();
         Video::shutdownVideo();
         PsxVm::shutdown();
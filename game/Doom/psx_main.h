@@ -1,7 +1,9 @@
 #pragma once
 
+#include "PsyDoom/Sim/SimTls.h"
+
 #if PSYDOOM_MODS
-    extern bool gbCheckDemoResultFailed;
+    extern SIM_TLS bool gbCheckDemoResultFailed;
 #endif
 
 int psx_main(const int argc, const char* const* const argv) noexcept;
@@ -52,6 +52,22 @@ void init(
     state.prevSampleGainDB = {};
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes the audio compressor state with the settings that PsyDoom uses for its own audio output
+//------------------------------------------------------------------------------------------------------------------------------------------
+void initWithGameSettings(State& state) noexcept {
+    init(
+        state,
+        -12.0f,             // thresholdDB
+        10.0f,              // kneeWidthDB
+        2.0f,               // compressionRatio
+        4.0f,               // postGainDB
+        0.150f,             // lpfResponseTime
+        0.002f,             // attackTime
+        0.005f              // releaseTime
+    );
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Perform dynamic range compression on a single audio sample.
 // 
@@ -30,6 +30,7 @@ void init(
     const float releaseTime
 ) noexcept;
 
+void initWithGameSettings(State& state) noexcept;
 void compress(State& state, float& sampleL, float& sampleR) noexcept;
 
 END_NAMESPACE(AudioCompressor)
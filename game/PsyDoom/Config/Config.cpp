@@ -30,6 +30,7 @@ bool            gbInterpolateMobj;
 bool            gbInterpolateMonsters;
 bool            gbInterpolateWeapon;
 int32_t         gMainMemoryHeapSize;
+int32_t         gRewindSnapshotInterval;
 bool            gbSkipIntros;
 bool            gbUseFastLoading;
 bool            gbEnableSinglePlayerLevelTimer;
@@ -81,7 +82,9 @@ int32_t         gBottomOverscanPixels;
 bool            gbFloorRenderGapFix;
 bool            gbSkyLeakFix;
 bool            gbVulkanBrightenAutomap;
+int32_t         gVulkanGeometryThreads;
 bool            gbUseVulkan32BitShading;
+bool            gbUseVulkanTextureAtlas;
 int32_t         gVramSizeInMegabytes;
 std::string     gVulkanPreferredDevicesRegex;
 
@@ -90,6 +93,7 @@ std::string     gVulkanPreferredDevicesRegex;
 //------------------------------------------------------------------------------------------------------------------------------------------
 int32_t     gAudioBufferSize;
 int32_t     gSpuRamSize;
+bool        gbSequencerOnAudioThread;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Input config settings
@@ -154,6 +158,9 @@ bool    gbNeedSave_Multiplayer;
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool gbDidInit;
 
+// PsyDoomSim: there is no video and so no dynamic defaults to determine for it
+#if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Determines dynamic defaults for Vulkan related config
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -225,6 +232,8 @@ static void determineVulkanDynamicConfigDefaults() noexcept {
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
 }
 
+#endif  // #if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Determines dynamic defaults for config values based on the host environment and hardware
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -233,9 +242,11 @@ static void determineDynamicConfigDefaults() noexcept {
     gDefaultVramSizeInMegabytes = -1;
 
     // Determine Vulkan defaults but skip if in headless mode - don't setup anything video related!
-    if (!ProgArgs::gbHeadlessMode) {
-        determineVulkanDynamicConfigDefaults();
-    }
+    #if !PSYDOOM_SIM
+        if (!ProgArgs::gbHeadlessMode) {
+            determineVulkanDynamicConfigDefaults();
+        }
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -249,8 +260,12 @@ void init() noexcept {
 
     // Read all config files.
     // Also, if any files need saving after default initializing new fields then do that now.
+    // PsyDoomSim only reads config, creating and updating config files is left to the game.
     ConfigSerialization::readAllConfigFiles();
-    ConfigSerialization::writeAllConfigFiles(false);
+
+    #if !PSYDOOM_SIM
+        ConfigSerialization::writeAllConfigFiles(false);
+    #endif
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
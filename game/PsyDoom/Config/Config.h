@@ -17,6 +17,7 @@ extern bool             gbInterpolateMobj;
 extern bool             gbInterpolateMonsters;
 extern bool             gbInterpolateWeapon;
 extern int32_t          gMainMemoryHeapSize;
+extern int32_t          gRewindSnapshotInterval;
 extern bool             gbSkipIntros;
 extern bool             gbUseFastLoading;
 extern bool             gbEnableSinglePlayerLevelTimer;
@@ -68,7 +69,9 @@ extern int32_t          gBottomOverscanPixels;
 extern bool             gbFloorRenderGapFix;
 extern bool             gbSkyLeakFix;
 extern bool             gbVulkanBrightenAutomap;
+extern int32_t          gVulkanGeometryThreads;
 extern bool             gbUseVulkan32BitShading;
+extern bool             gbUseVulkanTextureAtlas;
 extern int32_t          gVramSizeInMegabytes;
 extern std::string      gVulkanPreferredDevicesRegex;
 
@@ -77,6 +80,7 @@ extern std::string      gVulkanPreferredDevicesRegex;
 //------------------------------------------------------------------------------------------------------------------------------------------
 extern int32_t      gAudioBufferSize;
 extern int32_t      gSpuRamSize;
+extern bool         gbSequencerOnAudioThread;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Input settings
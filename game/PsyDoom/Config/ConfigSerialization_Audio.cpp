@@ -51,6 +51,19 @@ void initCfgSerialization_Audio() noexcept {
         gSpuRamSize,
         -1
     );
+
+    cfg.sequencerOnAudioThread = makeConfigField(
+        "SequencerOnAudioThread",
+        "If enabled then the music and sound sequencer is advanced on the audio thread while sound is being\n"
+        "generated, at exact 120 Hz intervals measured in output samples. This keeps music timing stable\n"
+        "even when the game experiences frame hitches, such as during level loads or slow frames.\n"
+        "Sound commands from the game are handed off to the audio thread through a lock-free queue.\n"
+        "\n"
+        "If disabled then the sequencer is advanced on the main game thread using a variable time step,\n"
+        "which was PsyDoom's original behavior.",
+        gbSequencerOnAudioThread,
+        false
+    );
 }
 
 END_NAMESPACE(ConfigSerialization)
@@ -12,6 +12,7 @@ BEGIN_NAMESPACE(ConfigSerialization)
 struct Config_Audio {
     ConfigField     audioBufferSize;
     ConfigField     spuRamSize;
+    ConfigField     sequencerOnAudioThread;
 
     inline ConfigFieldList getFieldList() noexcept {
         static_assert(sizeof(*this) % sizeof(ConfigField) == 0);
@@ -163,11 +163,15 @@ void initCfgSerialization_Controls() noexcept {
     cfg.toggle_autorun = CONTROL_FIELD(Toggle_Autorun, "CapsLock");
     cfg.quicksave = CONTROL_FIELD(Quicksave, "F5");
     cfg.quickload = CONTROL_FIELD(Quickload, "F9");
+    cfg.rewind = CONTROL_FIELD(Rewind, "Backspace");
 
     // Toggles
     cfg.toggle_pause = CONTROL_FIELD_WITH_DOC(
         "Toggle in-game pause, automap, uncapped framerate, and between the Classic and Vulkan renderer (if possible).\n"
-        "Also a control to toggle which player is viewed when playing back multiplayer demos.",
+        "Also a control to toggle which player is viewed when playing back multiplayer demos, and controls\n"
+        "to fast forward and seek during demo playback. Seeking backward is only possible for single player\n"
+        "demos and restores periodic snapshots taken while the demo plays. The profiler capture toggle starts\n"
+        "capturing a CPU profiler trace and when pressed again writes the trace to the user data folder.",
         Toggle_Pause,
         "Escape, P, Pause, Gamepad Start"
     );
@@ -176,6 +180,10 @@ void initCfgSerialization_Controls() noexcept {
     cfg.toggle_renderer = CONTROL_FIELD(Toggle_Renderer, "`");
     cfg.toggle_uncappedFps = CONTROL_FIELD(Toggle_UncappedFps, "");
     cfg.toggle_viewPlayer = CONTROL_FIELD(Toggle_ViewPlayer, "V");
+    cfg.demo_toggleFastForward = CONTROL_FIELD(Demo_ToggleFastForward, "F");
+    cfg.demo_seekBackward = CONTROL_FIELD(Demo_SeekBackward, "Left");
+    cfg.demo_seekForward = CONTROL_FIELD(Demo_SeekForward, "Right");
+    cfg.toggle_profilerCapture = CONTROL_FIELD(Toggle_ProfilerCapture, "F12");
 
     // Weapon switching
     cfg.weapon_scrollUp = CONTROL_FIELD_WITH_DOC(
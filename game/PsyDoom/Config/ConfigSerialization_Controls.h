@@ -32,11 +32,16 @@ struct Config_Controls {
     ConfigField     toggle_autorun;
     ConfigField     quicksave;
     ConfigField     quickload;
+    ConfigField     rewind;
     ConfigField     toggle_pause;
     ConfigField     toggle_map;
     ConfigField     toggle_renderer;
     ConfigField     toggle_uncappedFps;
     ConfigField     toggle_viewPlayer;
+    ConfigField     demo_toggleFastForward;
+    ConfigField     demo_seekBackward;
+    ConfigField     demo_seekForward;
+    ConfigField     toggle_profilerCapture;
     ConfigField     weapon_scrollUp;
     ConfigField     weapon_scrollDown;
     ConfigField     weapon_previous;
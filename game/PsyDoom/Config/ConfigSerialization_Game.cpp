@@ -93,6 +93,18 @@ void initCfgSerialization_Game() noexcept {
         -1
     );
 
+    cfg.rewindSnapshotInterval = makeConfigField(
+        "RewindSnapshotInterval",
+        "How often to take a snapshot of the game state for rewinding in single player, in game tics (15 per second).\n"
+        "Pressing the 'Rewind' control goes back to the newest snapshot which is at least 2 seconds old, and pressing\n"
+        "it repeatedly goes back further. Up to 2 minutes of history is kept for the current level, in compressed form.\n"
+        "If taking snapshots is too slow on average then the interval is automatically increased to compensate.\n"
+        "Rewinding is not available while recording or playing back demos.\n"
+        "Set to '0' to disable rewinding (the default), or to '15' for example to take a snapshot every second.",
+        gRewindSnapshotInterval,
+        0
+    );
+
     cfg.skipIntros = makeConfigField(
         "SkipIntros",
         "If enabled then all intro logos and movies will be skipped on game startup.",
@@ -17,6 +17,7 @@ struct Config_Game {
     ConfigField     interpolateMonsters;
     ConfigField     interpolateWeapon;
     ConfigField     mainMemoryHeapSize;
+    ConfigField     rewindSnapshotInterval;
     ConfigField     skipIntros;
     ConfigField     useFastLoading;
     ConfigField     enableSinglePlayerLevelTimer;
@@ -157,6 +157,21 @@ void initCfgSerialization_Graphics() noexcept {
         false
     );
 
+    cfg.useVulkanTextureAtlas = makeConfigField(
+        "UseVulkanTextureAtlas",
+        "Vulkan renderer only: whether to decode world textures into an atlas of ready-to-use colors.\n"
+        "\n"
+        "Normally the Vulkan renderer looks up the palette for every pixel of every wall, floor and sprite\n"
+        "drawn. With this enabled, textures are instead converted to colors once when they are loaded and\n"
+        "the palette lookup is skipped when drawing. This may improve frame rates on GPUs which struggle\n"
+        "at high resolutions or with high levels of anti-aliasing. The output is the same either way.\n"
+        "\n"
+        "The atlas uses twice as much video memory as the 'VramSizeInMegabytes' setting, and will not be\n"
+        "used if the GPU does not support a texture big enough to hold it.",
+        gbUseVulkanTextureAtlas,
+        false
+    );
+
     cfg.disableVulkanRenderer = makeConfigField(
         "DisableVulkanRenderer",
         "If enabled then the new Vulkan/hardware renderer will be completely disabled and the game will\n"
@@ -249,6 +264,20 @@ void initCfgSerialization_Graphics() noexcept {
         true
     );
 
+    cfg.vulkanGeometryThreads = makeConfigField(
+        "VulkanGeometryThreads",
+        "Vulkan renderer only: the maximum number of threads to use for generating the geometry of the 3D world.\n"
+        "On large, open maps the work of building walls, floors, ceilings and sprites can split across multiple\n"
+        "CPU cores, which may help increase frame rates. The output is the same regardless of this setting.\n"
+        "\n"
+        "Example values:\n"
+        "  1 = Generate world geometry on the main thread only (no multi-threading)\n"
+        "  4 = Use up to 4 threads\n"
+        " <= 0 = Use as many threads as are available",
+        gVulkanGeometryThreads,
+        0
+    );
+
     cfg.vramSizeInMegabytes = makeConfigField(
         "VramSizeInMegabytes",
         "Specifies how many megabytes of video RAM are available to hold sprites and textures in the game.\n"
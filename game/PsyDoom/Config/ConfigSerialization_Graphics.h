@@ -21,6 +21,7 @@ struct Config_Graphics {
     ConfigField     vulkanDrawExtendedStatusBar;
     ConfigField     vulkanWidescreenEnabled;
     ConfigField     useVulkan32BitShading;
+    ConfigField     useVulkanTextureAtlas;
     ConfigField     disableVulkanRenderer;
     ConfigField     logicalDisplayWidth;
     ConfigField     topOverscanPixels;
@@ -28,6 +29,7 @@ struct Config_Graphics {
     ConfigField     floorRenderGapFix;
     ConfigField     skyLeakFix;
     ConfigField     vulkanBrightenAutomap;
+    ConfigField     vulkanGeometryThreads;
     ConfigField     vramSizeInMegabytes;
     ConfigField     vulkanPreferredDevicesRegex;
 
@@ -83,8 +83,13 @@ enum class Binding : uint16_t {
     Toggle_Renderer,
     Toggle_UncappedFps,
     Toggle_ViewPlayer,      // Playback of multiplayer demos: toggle which player is being viewed
+    Demo_ToggleFastForward, // Demo playback: toggle fast forwarding (no drawing, uncapped simulation speed)
+    Demo_SeekBackward,      // Demo playback: seek backward by a fixed amount of ticks (via keyframes)
+    Demo_SeekForward,       // Demo playback: seek forward by a fixed amount of ticks
     Quicksave,
     Quickload,
+    Rewind,                 // Single player: restore the game state from a few seconds ago (if rewinding is enabled)
+    Toggle_ProfilerCapture, // Start or stop capturing a CPU profiler trace (written to the user data folder when stopped)
     // How many bindings there are
     NUM_BINDINGS
 };
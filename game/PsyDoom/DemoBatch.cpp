@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Demo batch runner: plays back a list of demos one after the other in the same process, for bulk regression testing and benchmarking.
+//
+// Running each demo with a separate invocation of the executable means paying for process startup, CD image parsing, WAD loading and
+// renderer setup every time, which for short demos can easily cost more than the simulation itself. Running the demos in a batch only
+// pays those costs once. Each demo can optionally be checked against an expected result .json file, and the time taken to play each demo
+// is reported along with overall throughput in demos and game tics per second. Best used in conjunction with headless mode.
+//
+// The list file has one demo per line, with the demo file path optionally followed by a '|' and the path of a result file to check against.
+// Empty lines and lines starting with '#' are ignored.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "DemoBatch.h"
+
+#include "Doom/d_main.h"
+#include "Doom/Game/g_game.h"
+#include "Doom/psx_main.h"
+#include "DemoPlayer.h"
+#include "FileUtils.h"
+#include "ProgArgs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+BEGIN_NAMESPACE(DemoBatch)
+
+typedef std::chrono::steady_clock batchclock_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Trims whitespace from both ends of the specified string
+//------------------------------------------------------------------------------------------------------------------------------------------
+static std::string trimmed(const std::string& str) noexcept {
+    const size_t beg = str.find_first_not_of(" \t\r\n");
+
+    if (beg == std::string::npos)
+        return {};
+
+    const size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(beg, end + 1 - beg);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the list of demos in the batch from the specified file.
+// Returns 'false' if the file could not be read.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool readBatchList(const char* const listFilePath, std::vector<BatchEntry>& entries) noexcept {
+    const FileData fileData = FileUtils::getContentsOfFile(listFilePath);
+
+    if (!fileData.bytes)
+        return false;
+
+    const char* const pText = (const char*) fileData.bytes.get();
+    size_t lineBeg = 0;
+
+    while (lineBeg < fileData.size) {
+        size_t lineEnd = lineBeg;
+
+        while ((lineEnd < fileData.size) && (pText[lineEnd] != '\n')) {
+            ++lineEnd;
+        }
+
+        const std::string line = trimmed(std::string(pText + lineBeg, lineEnd - lineBeg));
+        lineBeg = lineEnd + 1;
+
+        if (line.empty() || (line[0] == '#'))
+            continue;
+
+        const size_t separatorIdx = line.find('|');
+        BatchEntry& entry = entries.emplace_back();
+
+        if (separatorIdx != std::string::npos) {
+            entry.demoFilePath = trimmed(line.substr(0, separatorIdx));
+            entry.resultFilePath = trimmed(line.substr(separatorIdx + 1));
+        } else {
+            entry.demoFilePath = line;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Plays the specified demo in the batch, checking it against the expected result (if there is one) and timing it.
+// The demo result checking state is left modified, so callers are responsible for saving and restoring it.
+//------------------------------------------------------------------------------------------------------------------------------------------
+EntryResult playEntry(const BatchEntry& entry) noexcept {
+    // Skip demos that don't exist rather than aborting the whole batch (which is what demo playback does)
+    if (!FileUtils::fileExists(entry.demoFilePath.c_str()))
+        return EntryResult{ Outcome::Missing, 0, 0.0, 0 };
+
+    // Note: the result file to check against is supplied to the demo result checking in 'P_Stop' via the usual program argument
+    ProgArgs::gCheckDemoResultFilePath = entry.resultFilePath.c_str();
+    gbCheckDemoResultFailed = false;
+
+    const batchclock_t::time_point demoStartTime = batchclock_t::now();
+    RunDemoAtPath(entry.demoFilePath.c_str());
+    const double demoSecs = std::chrono::duration<double>(batchclock_t::now() - demoStartTime).count();
+
+    // Note: the game tic counter is reset when the demo's level starts, so it holds the number of tics the demo ran for
+    EntryResult result = {};
+    result.numTics = std::max(gGameTic, 0);
+    result.secs = demoSecs;
+    result.endStateHash = DemoPlayer::getEndStateHash();
+
+    if (entry.resultFilePath.empty()) {
+        result.outcome = Outcome::Played;
+    } else if (gbCheckDemoResultFailed) {
+        result.outcome = Outcome::Failed;
+    } else {
+        result.outcome = Outcome::Passed;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the name used to report the given outcome of playing a demo in the batch
+//------------------------------------------------------------------------------------------------------------------------------------------
+const char* getOutcomeName(const Outcome outcome) noexcept {
+    switch (outcome) {
+        case Outcome::Played:   return "PLAYED";
+        case Outcome::Passed:   return "PASSED";
+        case Outcome::Failed:   return "FAILED";
+        case Outcome::Missing:  return "MISSING";
+    }
+
+    return "UNKNOWN";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Plays all of the demos in the specified list file, printing the outcome of each demo and throughput stats to standard out.
+// Returns 'false' if the list could not be read or if any demo could not be played or did not produce the expected result.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool run(const char* const listFilePath) noexcept {
+    std::vector<BatchEntry> entries;
+
+    if (!readBatchList(listFilePath, entries)) {
+        std::printf("DemoBatch: unable to read the demo list file '%s'!\n", listFilePath);
+        gbCheckDemoResultFailed = true;
+        return false;
+    }
+
+    // Restore the original value of the demo result check program argument and failure flag once we are done
+    const char* const prevCheckResultFilePath = ProgArgs::gCheckDemoResultFilePath;
+    const bool bPrevCheckFailed = gbCheckDemoResultFailed;
+
+    uint32_t numPassed = 0;
+    uint32_t numFailed = 0;
+    uint32_t numUnchecked = 0;
+    uint64_t totalTics = 0;
+
+    const batchclock_t::time_point batchStartTime = batchclock_t::now();
+
+    for (const BatchEntry& entry : entries) {
+        const EntryResult result = playEntry(entry);
+
+        if (result.outcome == Outcome::Missing) {
+            std::printf("DemoBatch: MISSING %s\n", entry.demoFilePath.c_str());
+            numFailed++;
+            continue;
+        }
+
+        if (result.outcome == Outcome::Played) {
+            numUnchecked++;
+        } else if (result.outcome == Outcome::Failed) {
+            numFailed++;
+        } else {
+            numPassed++;
+        }
+
+        totalTics += (uint64_t) result.numTics;
+        std::printf("DemoBatch: %s %s (%d tics, %.3f secs)\n", getOutcomeName(result.outcome), entry.demoFilePath.c_str(), (int) result.numTics, result.secs);
+    }
+
+    const double batchSecs = std::chrono::duration<double>(batchclock_t::now() - batchStartTime).count();
+
+    ProgArgs::gCheckDemoResultFilePath = prevCheckResultFilePath;
+    gbCheckDemoResultFailed = (bPrevCheckFailed || (numFailed > 0));
+
+    std::printf(
+        "DemoBatch: %u demos (%u passed, %u failed, %u unchecked), %llu tics in %.3f secs: %.2f demos/sec, %.1f tics/sec\n",
+        (unsigned) entries.size(),
+        numPassed,
+        numFailed,
+        numUnchecked,
+        (unsigned long long) totalTics,
+        batchSecs,
+        (batchSecs > 0.0) ? (double) entries.size() / batchSecs : 0.0,
+        (batchSecs > 0.0) ? (double) totalTics / batchSecs : 0.0
+    );
+
+    return (numFailed == 0);
+}
+
+END_NAMESPACE(DemoBatch)
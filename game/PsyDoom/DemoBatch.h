@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+BEGIN_NAMESPACE(DemoBatch)
+
+// A demo to play in the batch and the (optional) result file to check it against
+struct BatchEntry {
+    std::string     demoFilePath;
+    std::string     resultFilePath;
+};
+
+// What happened when a demo in the batch was played
+enum class Outcome : uint8_t {
+    Played,     // The demo was played but there was no result file to check it against
+    Passed,     // The demo was played and matched the expected result
+    Failed,     // The demo was played and did not match the expected result
+    Missing,    // The demo file does not exist so it was not played
+};
+
+// The outcome of playing a demo in the batch, how many game tics it ran for, how long it took and the final game state hash
+struct EntryResult {
+    Outcome     outcome;
+    int32_t     numTics;
+    double      secs;
+    uint32_t    endStateHash;
+};
+
+bool readBatchList(const char* const listFilePath, std::vector<BatchEntry>& entries) noexcept;
+EntryResult playEntry(const BatchEntry& entry) noexcept;
+const char* getOutcomeName(const Outcome outcome) noexcept;
+bool run(const char* const listFilePath) noexcept;
+
+END_NAMESPACE(DemoBatch)
@@ -55,4 +55,22 @@ bool DemoTickInputs::equals(const DemoTickInputs& other) const noexcept {
     return (std::memcmp(this, &other, sizeof(*this)) == 0);
 }
 
+//--------------------------------------------------------------------------------------------------------------------------------------
+// Reverses the byte order of this data structure
+//--------------------------------------------------------------------------------------------------------------------------------------
+void DemoSnapshotHdr::byteSwap() noexcept {
+    Endian::byteSwapInPlace(tickIdx);
+    Endian::byteSwapInPlace(prevGameTic);
+    Endian::byteSwapInPlace(lastTgtGameTicCount);
+    Endian::byteSwapInPlace(bIsFirstTick);
+
+    for (DemoTickInputs& inputs : prevTickInputs) {
+        inputs.byteSwap();
+    }
+
+    for (DemoTickInputs& inputs : oldTickInputs) {
+        inputs.byteSwap();
+    }
+}
+
 END_NAMESPACE(DemoCommon)
@@ -2,6 +2,8 @@
 
 #include "Endian.h"
 
+#include <cstddef>
+
 struct TickInputs;
 
 BEGIN_NAMESPACE(DemoCommon)
@@ -46,4 +48,33 @@ struct DemoTickInputs {
 
 static_assert(sizeof(DemoTickInputs) == 8);
 
+//--------------------------------------------------------------------------------------------------------------------------------------
+// Returns the encoded size of a tick's inputs given the status byte which begins it (see 'DemoRecorder::recordTick').
+// The status byte is followed by new inputs for each player whose inputs have changed since the previous tick.
+//--------------------------------------------------------------------------------------------------------------------------------------
+inline constexpr size_t getEncodedTickSize(const uint8_t statusByte) noexcept {
+    size_t size = 1;
+    size += (statusByte & 0x80) ? sizeof(DemoTickInputs) : 0;
+    size += (statusByte & 0x40) ? sizeof(DemoTickInputs) : 0;
+    return size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+// Header for a snapshot of the game state, taken while recording before the inputs for a tick are encoded.
+// Snapshots allow playback of a live demo stream (e.g spectating via a relay) to begin part way through a map.
+// The header is followed by the game state, as serialized by 'SaveAndLoad::save' (including net state for multiplayer games).
+//--------------------------------------------------------------------------------------------------------------------------------------
+struct DemoSnapshotHdr {
+    uint32_t        tickIdx;                    // Which demo tick the snapshot was taken before recording
+    int32_t         prevGameTic;                // Timing state which is not saved with the game state
+    int32_t         lastTgtGameTicCount;
+    uint32_t        bIsFirstTick;
+    DemoTickInputs  prevTickInputs[2];          // The previous demo inputs of each player (used to decode repeats)
+    DemoTickInputs  oldTickInputs[2];           // The previous tick inputs of each player
+
+    void byteSwap() noexcept;
+};
+
+static_assert(sizeof(DemoSnapshotHdr) == 48);
+
 END_NAMESPACE(DemoCommon)
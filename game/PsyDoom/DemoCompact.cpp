@@ -0,0 +1,744 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Encoding and decoding for the compact demo format, which compresses the tick inputs of classic and PsyDoom format demos.
+// See 'DemoCompact.h' for details of the format.
+//
+// The entropy coder is a binary range coder with adaptive bit probabilities, in the style of the one used by LZMA.
+// Bytes are coded using a binary tree of bit probabilities per byte position in the tick record, so the statistics for each input
+// (buttons, analog turning etc.) are learned separately.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "DemoCompact.h"
+
+#include "Asserts.h"
+#include "ByteVecOutputStream.h"
+#include "DemoCommon.h"
+#include "Doom/Base/i_main.h"
+#include "Doom/doomdef.h"
+#include "Endian.h"
+#include "FileOutputStream.h"
+#include "FileUtils.h"
+#include "Game.h"
+#include "SaveDataTypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+BEGIN_NAMESPACE(DemoCompact)
+
+// Range coder constants: probabilities are 11-bit and adapt by 1/32 of the error on each coded bit
+static constexpr uint32_t   PROB_BITS           = 11;
+static constexpr uint16_t   PROB_ONE            = 1 << PROB_BITS;
+static constexpr uint16_t   PROB_INIT           = PROB_ONE / 2;
+static constexpr uint32_t   PROB_ADAPT_SHIFT    = 5;
+static constexpr uint32_t   RANGE_TOP           = 1u << 24;
+
+// Sizes of the fixed parts of the container
+static constexpr uint32_t   CONTAINER_HDR_SIZE  = 16;
+static constexpr uint32_t   BLOCK_HDR_SIZE      = 8;
+static constexpr uint32_t   INDEX_ENTRY_SIZE    = 8;
+static constexpr uint32_t   FOOTER_SIZE         = 16;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: reads a little endian 32-bit value from memory
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t readU32(const std::byte* const pSrc) noexcept {
+    uint32_t value;
+    std::memcpy(&value, pSrc, sizeof(value));
+    return Endian::littleToHost(value);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the size of a single tick record for the given tick format
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getTickRecordSize(const TickFormat format) noexcept {
+    switch (format) {
+        case TickFormat::Classic:   return sizeof(padbuttons_t);
+        case TickFormat::PsyDoom:   return 1 + 2 * sizeof(DemoCommon::DemoTickInputs);
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the given data is (or at least claims to be) a compact demo
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isCompactDemo(const std::byte* const pData, const size_t size) noexcept {
+    return ((size >= sizeof(int32_t)) && ((int32_t) readU32(pData) == COMPACT_DEMO_SIGNATURE));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Resets the model to it's initial state, as at the start of a block
+//------------------------------------------------------------------------------------------------------------------------------------------
+void TickModel::reset() noexcept {
+    std::fill_n(&tickChanged[0], C_ARRAY_SIZE(tickChanged), PROB_INIT);
+    std::fill_n(&byteChanged[0][0], C_ARRAY_SIZE(byteChanged) * C_ARRAY_SIZE(byteChanged[0]), PROB_INIT);
+    std::fill_n(&byteDelta[0][0], C_ARRAY_SIZE(byteDelta) * C_ARRAY_SIZE(byteDelta[0]), PROB_INIT);
+    std::memset(prevRecord, 0, sizeof(prevRecord));
+    std::memset(prevChangedBytes, 0, sizeof(prevChangedBytes));
+    bPrevTickChanged = false;
+}
+
+Encoder::Encoder() noexcept
+    : mTickRecordSize(0)
+    , mNumTicks(0)
+    , mNumBlockTicks(0)
+    , mNumBytesWritten(0)
+    , mModel()
+    , mBlockIndex()
+    , mBlockBytes()
+    , mLow(0)
+    , mRange(0xFFFFFFFFu)
+    , mCache(0)
+    , mCacheSize(1)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Begins writing a compact demo with the given tick format, starting with the container header and the original demo header
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::begin(OutputStream& out, const TickFormat format, const std::byte* const pHeader, const uint32_t headerSize) THROWS {
+    mTickRecordSize = getTickRecordSize(format);
+    mNumTicks = 0;
+    mNumBlockTicks = 0;
+    mNumBytesWritten = 0;
+    mModel.reset();
+    mBlockIndex.clear();
+    mBlockBytes.clear();
+    mLow = 0;
+    mRange = 0xFFFFFFFFu;
+    mCache = 0;
+    mCacheSize = 1;
+
+    ASSERT((mTickRecordSize > 0) && (mTickRecordSize <= MAX_TICK_RECORD_SIZE));
+    writeU32(out, (uint32_t) COMPACT_DEMO_SIGNATURE);
+    writeU32(out, COMPACT_DEMO_VERSION);
+    writeU32(out, (uint32_t) format);
+    writeU32(out, headerSize);
+    write(out, pHeader, headerSize);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Encodes the next tick record, writing out the current block if it is full
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::addTick(OutputStream& out, const std::byte* const pRecord) THROWS {
+    const uint8_t* const pBytes = (const uint8_t*) pRecord;
+    const bool bTickChanged = (std::memcmp(pBytes, mModel.prevRecord, mTickRecordSize) != 0);
+
+    encodeBit(mModel.tickChanged[mModel.bPrevTickChanged], bTickChanged);
+    mModel.bPrevTickChanged = bTickChanged;
+
+    if (bTickChanged) {
+        for (uint32_t byteIdx = 0; byteIdx < mTickRecordSize; ++byteIdx) {
+            const uint32_t delta = pBytes[byteIdx] ^ mModel.prevRecord[byteIdx];
+            const uint32_t bByteChanged = (delta != 0);
+            encodeBit(mModel.byteChanged[byteIdx][mModel.prevChangedBytes[byteIdx]], bByteChanged);
+            mModel.prevChangedBytes[byteIdx] = (uint8_t) bByteChanged;
+
+            if (bByteChanged) {
+                uint16_t* const pTreeProbs = mModel.byteDelta[byteIdx];
+                uint32_t treeNode = 1;
+
+                for (int32_t bitIdx = 7; bitIdx >= 0; --bitIdx) {
+                    const uint32_t bit = (delta >> bitIdx) & 1;
+                    encodeBit(pTreeProbs[treeNode], bit);
+                    treeNode = (treeNode << 1) | bit;
+                }
+            }
+        }
+
+        std::memcpy(mModel.prevRecord, pBytes, mTickRecordSize);
+    }
+
+    mNumTicks++;
+    mNumBlockTicks++;
+
+    if (mNumBlockTicks >= TICKS_PER_BLOCK) {
+        writeBlock(out);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Ends the current block early and writes it out (if it has any ticks), so that all ticks added so far are in the output
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::flushBlock(OutputStream& out) THROWS {
+    if (mNumBlockTicks > 0) {
+        writeBlock(out);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Finishes the demo: writes the last block (if any), the end of blocks marker, the block index and the footer
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::end(OutputStream& out) THROWS {
+    flushBlock(out);
+
+    writeU32(out, 0);
+    writeU32(out, 0);
+
+    const uint32_t indexOffset = (uint32_t) mNumBytesWritten;
+
+    for (const BlockIndexEntry& entry : mBlockIndex) {
+        writeU32(out, entry.firstTick);
+        writeU32(out, entry.offset);
+    }
+
+    writeU32(out, (uint32_t) mBlockIndex.size());
+    writeU32(out, mNumTicks);
+    writeU32(out, indexOffset);
+    writeU32(out, COMPACT_DEMO_FOOTER_MAGIC);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Encodes a single bit with the given probability (of the bit being '0') and adapts the probability
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::encodeBit(uint16_t& prob, const uint32_t bit) noexcept {
+    const uint32_t bound = (mRange >> PROB_BITS) * prob;
+
+    if (bit == 0) {
+        mRange = bound;
+        prob += (PROB_ONE - prob) >> PROB_ADAPT_SHIFT;
+    } else {
+        mLow += bound;
+        mRange -= bound;
+        prob -= prob >> PROB_ADAPT_SHIFT;
+    }
+
+    while (mRange < RANGE_TOP) {
+        mRange <<= 8;
+        shiftLow();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Outputs the top byte of the range coder's low value, handling carries into bytes that have not been output yet
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::shiftLow() noexcept {
+    if (((uint32_t) mLow < 0xFF000000u) || ((mLow >> 32) != 0)) {
+        const uint8_t carry = (uint8_t)(mLow >> 32);
+        uint8_t outByte = mCache;
+
+        do {
+            mBlockBytes.push_back((uint8_t)(outByte + carry));
+            outByte = 0xFF;
+        } while (--mCacheSize != 0);
+
+        mCache = (uint8_t)(mLow >> 24);
+    }
+
+    mCacheSize++;
+    mLow = (mLow & 0x00FFFFFFu) << 8;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Flushes the range coder and writes the current block, then resets the coder and model for the next block
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Encoder::writeBlock(OutputStream& out) THROWS {
+    for (int32_t i = 0; i < 5; ++i) {
+        shiftLow();
+    }
+
+    mBlockIndex.push_back({ mNumTicks - mNumBlockTicks, (uint32_t) mNumBytesWritten });
+    writeU32(out, mNumBlockTicks);
+    writeU32(out, (uint32_t) mBlockBytes.size());
+    write(out, mBlockBytes.data(), mBlockBytes.size());
+
+    mNumBlockTicks = 0;
+    mModel.reset();
+    mBlockBytes.clear();
+    mLow = 0;
+    mRange = 0xFFFFFFFFu;
+    mCache = 0;
+    mCacheSize = 1;
+}
+
+void Encoder::write(OutputStream& out, const void* const pBytes, const size_t numBytes) THROWS {
+    out.writeBytes(pBytes, numBytes);
+    mNumBytesWritten += numBytes;
+}
+
+void Encoder::writeU32(OutputStream& out, const uint32_t value) THROWS {
+    const uint32_t valueLE = Endian::hostToLittle(value);
+    write(out, &valueLE, sizeof(valueLE));
+}
+
+Decoder::Decoder() noexcept {
+    close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Opens the compact demo held in the given memory for decoding and prepares to read the first tick.
+// The block index at the end of the demo is used if it is present and valid, otherwise the blocks are scanned to build one.
+//------------------------------------------------------------------------------------------------------------------------------------------
+OpenResult Decoder::open(const std::byte* const pData, const size_t size) noexcept {
+    close();
+
+    if ((!isCompactDemo(pData, size)) || (size < CONTAINER_HDR_SIZE))
+        return OpenResult::BadData;
+
+    if (readU32(pData + 4) != COMPACT_DEMO_VERSION)
+        return OpenResult::BadVersion;
+
+    const TickFormat tickFormat = (TickFormat) readU32(pData + 8);
+    const uint32_t tickRecordSize = DemoCompact::getTickRecordSize(tickFormat);
+    const uint32_t headerSize = readU32(pData + 12);
+
+    if ((tickRecordSize == 0) || (headerSize > size - CONTAINER_HDR_SIZE))
+        return OpenResult::BadData;
+
+    mpData = pData;
+    mSize = size;
+    mTickFormat = tickFormat;
+    mTickRecordSize = tickRecordSize;
+    mpHeader = pData + CONTAINER_HDR_SIZE;
+    mHeaderSize = headerSize;
+    mBlocksOffset = CONTAINER_HDR_SIZE + (size_t) headerSize;
+
+    if (!readBlockIndex()) {
+        scanBlocks();
+    }
+
+    if (!mBlocks.empty()) {
+        beginBlock(0);
+    }
+
+    return OpenResult::OK;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Stops decoding the current demo (if any) and resets the decoder
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Decoder::close() noexcept {
+    mpData = nullptr;
+    mSize = 0;
+    mTickFormat = {};
+    mTickRecordSize = 0;
+    mpHeader = nullptr;
+    mHeaderSize = 0;
+    mBlocksOffset = 0;
+    mNumTicks = 0;
+    mBlocks.clear();
+    mCurTick = 0;
+    mCurBlockIdx = 0;
+    mNumBlockTicksLeft = 0;
+    mModel.reset();
+    mpBlockIter = nullptr;
+    mpBlockEnd = nullptr;
+    mRange = 0;
+    mCode = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Decodes the next tick record in the demo.
+// Returns 'false' if the end of the demo has been reached.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool Decoder::readTick(std::byte* const pRecord) noexcept {
+    if (mCurTick >= mNumTicks)
+        return false;
+
+    if (mNumBlockTicksLeft == 0) {
+        if (mCurBlockIdx + 1 >= mBlocks.size())
+            return false;
+
+        beginBlock(mCurBlockIdx + 1);
+    }
+
+    if (decodeBit(mModel.tickChanged[mModel.bPrevTickChanged])) {
+        mModel.bPrevTickChanged = true;
+
+        for (uint32_t byteIdx = 0; byteIdx < mTickRecordSize; ++byteIdx) {
+            const uint32_t bByteChanged = decodeBit(mModel.byteChanged[byteIdx][mModel.prevChangedBytes[byteIdx]]);
+            mModel.prevChangedBytes[byteIdx] = (uint8_t) bByteChanged;
+
+            if (bByteChanged) {
+                uint16_t* const pTreeProbs = mModel.byteDelta[byteIdx];
+                uint32_t treeNode = 1;
+
+                for (int32_t bitIdx = 7; bitIdx >= 0; --bitIdx) {
+                    treeNode = (treeNode << 1) | decodeBit(pTreeProbs[treeNode]);
+                }
+
+                mModel.prevRecord[byteIdx] ^= (uint8_t) treeNode;
+            }
+        }
+    } else {
+        mModel.bPrevTickChanged = false;
+    }
+
+    std::memcpy(pRecord, mModel.prevRecord, mTickRecordSize);
+    mCurTick++;
+    mNumBlockTicksLeft--;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Moves the decoder so that the specified tick is the next one read, by decoding from the start of the block containing the tick.
+// Returns 'false' if the tick is past the end of the demo.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool Decoder::seekToTick(const uint32_t tickIdx) noexcept {
+    if (tickIdx > mNumTicks)
+        return false;
+
+    if (tickIdx == mNumTicks) {
+        mCurTick = mNumTicks;
+        mCurBlockIdx = (uint32_t) mBlocks.size();
+        mNumBlockTicksLeft = 0;
+        return true;
+    }
+
+    const auto blockIter = std::upper_bound(
+        mBlocks.begin(),
+        mBlocks.end(),
+        tickIdx,
+        [](const uint32_t tick, const BlockInfo& block) noexcept { return (tick < block.firstTick); }
+    );
+
+    ASSERT(blockIter != mBlocks.begin());
+    beginBlock((uint32_t)(blockIter - mBlocks.begin() - 1));
+
+    std::byte record[MAX_TICK_RECORD_SIZE];
+
+    while (mCurTick < tickIdx) {
+        readTick(record);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the block index from the end of the demo and verifies it.
+// Returns 'false' if there is no valid index, as would be the case if recording the demo was interrupted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool Decoder::readBlockIndex() noexcept {
+    if (mSize < mBlocksOffset + BLOCK_HDR_SIZE + FOOTER_SIZE)
+        return false;
+
+    const std::byte* const pFooter = mpData + mSize - FOOTER_SIZE;
+    const uint32_t numBlocks = readU32(pFooter);
+    const uint32_t numTicks = readU32(pFooter + 4);
+    const uint32_t indexOffset = readU32(pFooter + 8);
+    const uint32_t footerMagic = readU32(pFooter + 12);
+
+    const bool bValidFooter = (
+        (footerMagic == COMPACT_DEMO_FOOTER_MAGIC) &&
+        (indexOffset >= mBlocksOffset + BLOCK_HDR_SIZE) &&
+        ((uint64_t) indexOffset + (uint64_t) numBlocks * INDEX_ENTRY_SIZE + FOOTER_SIZE == mSize)
+    );
+
+    if (!bValidFooter)
+        return false;
+
+    // Verify each block is where the index says and that the block ticks add up, stopping before the end of blocks marker
+    const size_t blocksEnd = indexOffset - BLOCK_HDR_SIZE;
+    uint32_t nextTick = 0;
+    mBlocks.clear();
+    mBlocks.reserve(numBlocks);
+
+    for (uint32_t blockIdx = 0; blockIdx < numBlocks; ++blockIdx) {
+        const std::byte* const pEntry = mpData + indexOffset + blockIdx * INDEX_ENTRY_SIZE;
+        const uint32_t firstTick = readU32(pEntry);
+        const uint32_t blockOffset = readU32(pEntry + 4);
+        uint32_t blockNumTicks = 0;
+        uint32_t blockDataSize = 0;
+
+        const bool bValidBlock = (
+            (firstTick == nextTick) &&
+            (blockOffset >= mBlocksOffset) &&
+            readBlockHeader(blockOffset, blockNumTicks, blockDataSize) &&
+            (blockNumTicks > 0) &&
+            (blockNumTicks <= TICKS_PER_BLOCK) &&
+            ((uint64_t) blockOffset + BLOCK_HDR_SIZE + blockDataSize <= blocksEnd)
+        );
+
+        if (!bValidBlock) {
+            mBlocks.clear();
+            return false;
+        }
+
+        mBlocks.push_back({ firstTick, blockNumTicks, blockOffset + BLOCK_HDR_SIZE, blockDataSize });
+        nextTick += blockNumTicks;
+    }
+
+    if (nextTick != numTicks) {
+        mBlocks.clear();
+        return false;
+    }
+
+    mNumTicks = numTicks;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Builds the list of blocks by reading them in order, as a streaming decoder would.
+// Stops at the end of blocks marker, or at the last complete and valid block if the demo is truncated or corrupted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool Decoder::scanBlocks() noexcept {
+    size_t offset = mBlocksOffset;
+    uint32_t nextTick = 0;
+    mBlocks.clear();
+
+    while (true) {
+        uint32_t blockNumTicks = 0;
+        uint32_t blockDataSize = 0;
+
+        if (!readBlockHeader(offset, blockNumTicks, blockDataSize))
+            break;
+
+        const bool bEndOfBlocks = (blockNumTicks == 0);
+        const bool bBadBlock = ((blockNumTicks > TICKS_PER_BLOCK) || (offset + BLOCK_HDR_SIZE + blockDataSize > mSize));
+
+        if (bEndOfBlocks || bBadBlock)
+            break;
+
+        mBlocks.push_back({ nextTick, blockNumTicks, offset + BLOCK_HDR_SIZE, blockDataSize });
+        nextTick += blockNumTicks;
+        offset += BLOCK_HDR_SIZE + blockDataSize;
+    }
+
+    mNumTicks = nextTick;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the header of the block at the given offset, returning 'false' if it is out of bounds
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool Decoder::readBlockHeader(const size_t offset, uint32_t& numTicks, uint32_t& dataSize) const noexcept {
+    if ((offset > mSize) || (mSize - offset < BLOCK_HDR_SIZE))
+        return false;
+
+    numTicks = readU32(mpData + offset);
+    dataSize = readU32(mpData + offset + 4);
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Resets the range decoder and model to start decoding the specified block
+//------------------------------------------------------------------------------------------------------------------------------------------
+void Decoder::beginBlock(const uint32_t blockIdx) noexcept {
+    ASSERT(blockIdx < mBlocks.size());
+    const BlockInfo& block = mBlocks[blockIdx];
+
+    mCurTick = block.firstTick;
+    mCurBlockIdx = blockIdx;
+    mNumBlockTicksLeft = block.numTicks;
+    mModel.reset();
+    mpBlockIter = (const uint8_t*)(mpData + block.dataOffset);
+    mpBlockEnd = mpBlockIter + block.dataSize;
+    mRange = 0xFFFFFFFFu;
+    mCode = 0;
+
+    for (int32_t i = 0; i < 5; ++i) {
+        mCode = (mCode << 8) | nextByte();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Decodes a single bit with the given probability (of the bit being '0') and adapts the probability
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t Decoder::decodeBit(uint16_t& prob) noexcept {
+    const uint32_t bound = (mRange >> PROB_BITS) * prob;
+    uint32_t bit;
+
+    if (mCode < bound) {
+        mRange = bound;
+        prob += (PROB_ONE - prob) >> PROB_ADAPT_SHIFT;
+        bit = 0;
+    } else {
+        mCode -= bound;
+        mRange -= bound;
+        prob -= prob >> PROB_ADAPT_SHIFT;
+        bit = 1;
+    }
+
+    while (mRange < RANGE_TOP) {
+        mRange <<= 8;
+        mCode = (mCode << 8) | nextByte();
+    }
+
+    return bit;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the next byte of encoded data for the current block, or '0' if a corrupted block tries to read past it's end
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint8_t Decoder::nextByte() noexcept {
+    return (mpBlockIter < mpBlockEnd) ? *mpBlockIter++ : 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Splits a classic or PsyDoom format demo in memory into it's header and a list of tick records.
+// The ticks extracted are exactly those which would be read when playing the demo.
+// Returns 'false' if the demo is not in a supported format.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool getDemoTickRecords(
+    const std::byte* const pData,
+    const size_t size,
+    TickFormat& tickFormat,
+    uint32_t& headerSize,
+    std::vector<std::byte>& records
+) noexcept {
+    using namespace DemoCommon;
+
+    if (size < sizeof(int32_t))
+        return false;
+
+    const std::byte* const pEnd = pData + size;
+    records.clear();
+
+    if ((int32_t) readU32(pData) != -1) {
+        // Classic demo: the header size depends on whether this is a Final Doom demo, which is decided by the current game (see 'RunDemoAtPath')
+        const bool bFinalDoomDemo = (Game::gGameType != GameType::Doom);
+        tickFormat = TickFormat::Classic;
+        headerSize = 8 + ((bFinalDoomDemo) ? NUM_BINDABLE_BTNS * 4 + 4 : 8 * 4);
+
+        if (headerSize > size)
+            return false;
+
+        const size_t numTicks = (size - headerSize) / sizeof(padbuttons_t);
+        records.assign(pData + headerSize, pData + headerSize + numTicks * sizeof(padbuttons_t));
+        return true;
+    }
+
+    // PsyDoom demo: only the current version can be played and the header size depends on the number of players
+    if ((size < 24) || (readU32(pData + 4) != DEMO_FILE_VERSION))
+        return false;
+
+    const gametype_t gameType = (gametype_t) readU32(pData + 16);
+    const uint32_t numPlayers = (gameType != gt_single) ? 2 : 1;
+    tickFormat = TickFormat::PsyDoom;
+    headerSize = (uint32_t)(24 + sizeof(GameSettings) + 16 + numPlayers * sizeof(SavedPlayerT));
+
+    if (headerSize > size)
+        return false;
+
+    // Expand the ticks (which only contain inputs that changed) into full records, using the same end of demo rule as playback
+    DemoTickInputs prevInputs[MAXPLAYERS] = {};
+    prevInputs[0].directSwitchToWeapon = wp_nochange;
+    prevInputs[1].directSwitchToWeapon = wp_nochange;
+
+    for (const std::byte* pTick = pData + headerSize; pEnd - pTick >= (ptrdiff_t) sizeof(DemoTickInputs);) {
+        const uint8_t statusByte = (uint8_t) *pTick;
+
+        if ((size_t)(pEnd - pTick) < getEncodedTickSize(statusByte))
+            break;
+
+        pTick++;
+
+        if (statusByte & 0x80) {
+            std::memcpy(&prevInputs[0], pTick, sizeof(DemoTickInputs));
+            pTick += sizeof(DemoTickInputs);
+        }
+
+        if (statusByte & 0x40) {
+            std::memcpy(&prevInputs[1], pTick, sizeof(DemoTickInputs));
+            pTick += sizeof(DemoTickInputs);
+        }
+
+        const std::byte* const pInputs = (const std::byte*) prevInputs;
+        records.push_back((std::byte)(statusByte & 0x3F));
+        records.insert(records.end(), pInputs, pInputs + sizeof(prevInputs));
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Converts a classic or PsyDoom format demo file to the compact demo format.
+// Verifies the result decodes back to the original ticks and prints the compression ratio and decode throughput to standard out.
+// Returns 'false' on failure.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool convertDemoFile(const char* const inFilePath, const char* const outFilePath) noexcept {
+    typedef std::chrono::steady_clock convclock_t;
+
+    const FileData inFile = FileUtils::getContentsOfFile(inFilePath);
+
+    if (!inFile.bytes) {
+        std::printf("DemoCompact: unable to read demo file '%s'!\n", inFilePath);
+        return false;
+    }
+
+    if (isCompactDemo(inFile.bytes.get(), inFile.size)) {
+        std::printf("DemoCompact: demo file '%s' is already in the compact format!\n", inFilePath);
+        return false;
+    }
+
+    // Extract the header and ticks from the demo
+    TickFormat tickFormat = {};
+    uint32_t headerSize = 0;
+    std::vector<std::byte> records;
+
+    if (!getDemoTickRecords(inFile.bytes.get(), inFile.size, tickFormat, headerSize, records)) {
+        std::printf("DemoCompact: demo file '%s' is not in a supported format!\n", inFilePath);
+        return false;
+    }
+
+    // Encode the demo
+    const uint32_t recordSize = DemoCompact::getTickRecordSize(tickFormat);
+    const uint32_t numTicks = (uint32_t)(records.size() / recordSize);
+    ByteVecOutputStream encoded;
+    Encoder encoder;
+
+    try {
+        encoder.begin(encoded, tickFormat, inFile.bytes.get(), headerSize);
+
+        for (uint32_t tickIdx = 0; tickIdx < numTicks; ++tickIdx) {
+            encoder.addTick(encoded, records.data() + (size_t) tickIdx * recordSize);
+        }
+
+        encoder.end(encoded);
+    }
+    catch (...) {
+        std::printf("DemoCompact: failed to encode demo file '%s'!\n", inFilePath);
+        return false;
+    }
+
+    // Verify the demo decodes back to the same ticks, and time how long decoding takes
+    const std::vector<std::byte>& encodedBytes = encoded.getBytes();
+    Decoder decoder;
+    bool bDecodedOk = ((decoder.open(encodedBytes.data(), encodedBytes.size()) == OpenResult::OK) && (decoder.getNumTicks() == numTicks));
+    std::byte record[MAX_TICK_RECORD_SIZE];
+
+    const convclock_t::time_point decodeStartTime = convclock_t::now();
+
+    for (uint32_t tickIdx = 0; bDecodedOk && (tickIdx < numTicks); ++tickIdx) {
+        bDecodedOk = (decoder.readTick(record) && (std::memcmp(record, records.data() + (size_t) tickIdx * recordSize, recordSize) == 0));
+    }
+
+    const double decodeSecs = std::chrono::duration<double>(convclock_t::now() - decodeStartTime).count();
+
+    if (!bDecodedOk) {
+        std::printf("DemoCompact: demo file '%s' did not decode back to the original ticks!\n", inFilePath);
+        return false;
+    }
+
+    // Save the compact demo
+    try {
+        FileOutputStream outFile(outFilePath, false);
+        outFile.writeBytes(encodedBytes.data(), encodedBytes.size());
+        outFile.flush();
+    }
+    catch (...) {
+        std::printf("DemoCompact: unable to write demo file '%s'!\n", outFilePath);
+        return false;
+    }
+
+    const size_t inTickBytes = inFile.size - headerSize;
+    const size_t outTickBytes = encodedBytes.size() - CONTAINER_HDR_SIZE - headerSize;
+
+    std::printf(
+        "DemoCompact: %s: %u ticks, tick data %zu -> %zu bytes (%.1fx), file %zu -> %zu bytes (%.1fx), decode %.1f M ticks/sec\n",
+        inFilePath,
+        numTicks,
+        inTickBytes,
+        outTickBytes,
+        (outTickBytes > 0) ? (double) inTickBytes / (double) outTickBytes : 0.0,
+        (size_t) inFile.size,
+        encodedBytes.size(),
+        (double) inFile.size / (double) encodedBytes.size(),
+        (decodeSecs > 0.0) ? (double) numTicks / decodeSecs / 1e6 : 0.0
+    );
+
+    return true;
+}
+
+END_NAMESPACE(DemoCompact)
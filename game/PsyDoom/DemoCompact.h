@@ -0,0 +1,178 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OutputStream;
+
+BEGIN_NAMESPACE(DemoCompact)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// The compact demo format: a container which wraps the header of a classic or PsyDoom format demo (stored verbatim) together with a
+// compressed version of the demo's tick inputs.
+//
+// Each tick is first expanded to a fixed size record holding all of the inputs for the tick, in the same byte order as the demo file:
+//  - Classic demos:    the 32-bit pad buttons for the tick.
+//  - PsyDoom demos:    the status byte (with the 'new inputs' bits cleared) followed by 'DemoTickInputs' for player 1 and then player 2.
+//
+// Records are then delta coded against the previous record, and the changes are entropy coded using an adaptive binary range coder.
+// Consecutive ticks are usually identical and cost only a small fraction of a bit each to encode.
+//
+// The ticks are split into blocks which can each be decoded independently, so that playback can be started at any block. The layout is:
+//
+//  int32       signature           Always 'COMPACT_DEMO_SIGNATURE': classic demos begin with the skill and PsyDoom demos with '-1'
+//  uint32      version             Always 'COMPACT_DEMO_VERSION'
+//  uint32      tickFormat          Format of the tick records, see 'TickFormat'
+//  uint32      headerSize          Size of the original demo header which follows
+//  bytes       header              The original demo header
+//  blocks...                       Each block is a 'uint32' tick count and byte count followed by the encoded ticks.
+//                                  The list of blocks is terminated by a block with no ticks and no bytes.
+//  index...                        For each block a 'uint32' for the first tick in the block and the offset of the block in the file
+//  uint32      numBlocks           Number of blocks in the index
+//  uint32      numTicks            Total number of ticks in the demo
+//  uint32      indexOffset         Offset of the block index in the file
+//  uint32      footerMagic         Always 'COMPACT_DEMO_FOOTER_MAGIC'
+//
+// All integers are little endian. Demos can be decoded in a streaming fashion by reading the blocks in order, without the index.
+// Note that the index and footer are only written once recording ends, so a demo where recording was interrupted is still playable
+// (up until the last complete block) via the streaming route. Blocks may hold fewer than 'TICKS_PER_BLOCK' ticks: recorders end
+// blocks early with 'Encoder::flushBlock' to limit how many ticks are lost if recording is interrupted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static constexpr int32_t    COMPACT_DEMO_SIGNATURE      = -2;
+static constexpr uint32_t   COMPACT_DEMO_VERSION        = 1;
+static constexpr uint32_t   COMPACT_DEMO_FOOTER_MAGIC   = 0x58444950;   // 'PIDX'
+static constexpr uint32_t   TICKS_PER_BLOCK             = 4096;
+static constexpr uint32_t   MAX_TICK_RECORD_SIZE        = 17;
+
+// What format the tick records in the demo are in
+enum class TickFormat : uint32_t {
+    Classic = 1,    // Classic PSX Doom and Final Doom demos
+    PsyDoom = 2     // PsyDoom's new demo format
+};
+
+// Result of opening a compact demo for decoding
+enum class OpenResult : uint8_t {
+    OK,
+    BadVersion,     // Not a version of the compact demo format that is supported
+    BadData         // Not a compact demo, or the container is malformed
+};
+
+uint32_t getTickRecordSize(const TickFormat format) noexcept;
+bool isCompactDemo(const std::byte* const pData, const size_t size) noexcept;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Adaptive probabilities used to code tick records, shared by the encoder and decoder
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct TickModel {
+    uint16_t    tickChanged[2];                                 // Did the tick change? Context: whether the previous tick changed.
+    uint16_t    byteChanged[MAX_TICK_RECORD_SIZE][2];           // Did each byte change? Context: whether it changed in the last changed tick.
+    uint16_t    byteDelta[MAX_TICK_RECORD_SIZE][256];           // Bit tree for the delta (XOR) of each changed byte
+    uint8_t     prevRecord[MAX_TICK_RECORD_SIZE];               // The previous tick record
+    uint8_t     prevChangedBytes[MAX_TICK_RECORD_SIZE];         // Which bytes changed in the last changed tick
+    bool        bPrevTickChanged;
+
+    void reset() noexcept;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Writes a compact demo to an output stream, one tick at a time
+//------------------------------------------------------------------------------------------------------------------------------------------
+class Encoder {
+public:
+    Encoder() noexcept;
+
+    void begin(OutputStream& out, const TickFormat format, const std::byte* const pHeader, const uint32_t headerSize) THROWS;
+    void addTick(OutputStream& out, const std::byte* const pRecord) THROWS;
+    void flushBlock(OutputStream& out) THROWS;
+    void end(OutputStream& out) THROWS;
+
+    inline uint32_t getNumTicks() const noexcept { return mNumTicks; }
+    inline uint64_t getNumBytesWritten() const noexcept { return mNumBytesWritten; }
+
+private:
+    struct BlockIndexEntry {
+        uint32_t    firstTick;
+        uint32_t    offset;
+    };
+
+    void encodeBit(uint16_t& prob, const uint32_t bit) noexcept;
+    void shiftLow() noexcept;
+    void writeBlock(OutputStream& out) THROWS;
+    void write(OutputStream& out, const void* const pBytes, const size_t numBytes) THROWS;
+    void writeU32(OutputStream& out, const uint32_t value) THROWS;
+
+    uint32_t                        mTickRecordSize;
+    uint32_t                        mNumTicks;
+    uint32_t                        mNumBlockTicks;
+    uint64_t                        mNumBytesWritten;
+    TickModel                       mModel;
+    std::vector<BlockIndexEntry>    mBlockIndex;
+    std::vector<uint8_t>            mBlockBytes;                // Encoded bytes for the current block
+    uint64_t                        mLow;                       // Range coder state
+    uint32_t                        mRange;
+    uint8_t                         mCache;
+    uint64_t                        mCacheSize;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the ticks of a compact demo held in memory (which can be a memory mapped file).
+// The demo data must remain valid for as long as the decoder is used.
+//------------------------------------------------------------------------------------------------------------------------------------------
+class Decoder {
+public:
+    Decoder() noexcept;
+
+    OpenResult open(const std::byte* const pData, const size_t size) noexcept;
+    void close() noexcept;
+    bool readTick(std::byte* const pRecord) noexcept;
+    bool seekToTick(const uint32_t tickIdx) noexcept;
+
+    inline bool isOpen() const noexcept { return (mpData != nullptr); }
+    inline TickFormat getTickFormat() const noexcept { return mTickFormat; }
+    inline uint32_t getTickRecordSize() const noexcept { return mTickRecordSize; }
+    inline const std::byte* getHeader() const noexcept { return mpHeader; }
+    inline uint32_t getHeaderSize() const noexcept { return mHeaderSize; }
+    inline uint32_t getNumTicks() const noexcept { return mNumTicks; }
+    inline uint32_t getCurTick() const noexcept { return mCurTick; }
+    inline bool hasReachedEnd() const noexcept { return (mCurTick >= mNumTicks); }
+
+private:
+    struct BlockInfo {
+        uint32_t    firstTick;
+        uint32_t    numTicks;
+        size_t      dataOffset;     // Offset of the encoded ticks for the block
+        uint32_t    dataSize;
+    };
+
+    bool readBlockIndex() noexcept;
+    bool scanBlocks() noexcept;
+    bool readBlockHeader(const size_t offset, uint32_t& numTicks, uint32_t& dataSize) const noexcept;
+    void beginBlock(const uint32_t blockIdx) noexcept;
+    uint32_t decodeBit(uint16_t& prob) noexcept;
+    uint8_t nextByte() noexcept;
+
+    const std::byte*        mpData;
+    size_t                  mSize;
+    TickFormat              mTickFormat;
+    uint32_t                mTickRecordSize;
+    const std::byte*        mpHeader;
+    uint32_t                mHeaderSize;
+    size_t                  mBlocksOffset;
+    uint32_t                mNumTicks;
+    std::vector<BlockInfo>  mBlocks;
+    uint32_t                mCurTick;
+    uint32_t                mCurBlockIdx;
+    uint32_t                mNumBlockTicksLeft;
+    TickModel               mModel;
+    const uint8_t*          mpBlockIter;                // Range decoder state
+    const uint8_t*          mpBlockEnd;
+    uint32_t                mRange;
+    uint32_t                mCode;
+};
+
+bool convertDemoFile(const char* const inFilePath, const char* const outFilePath) noexcept;
+
+END_NAMESPACE(DemoCompact)
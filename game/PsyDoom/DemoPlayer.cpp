@@ -1,30 +1,89 @@
 //------------------------------------------------------------------------------------------------------------------------------------------
 // A module responsible for much of the logic relating to demo playback.
 // This includes emulation of the original game's demo playback (classic demos) and also PsyDoom's new extended demo format.
+// Also handles fast forwarding and seeking during playback, with seeking being accelerated by periodic keyframes of the game state.
+// Live demo streams received from a spectator relay are also played here, optionally starting from a snapshot of the game state.
+// Either format of demo can also be wrapped in the compact demo format (see 'DemoCompact.h'), which compresses the tick inputs.
 //------------------------------------------------------------------------------------------------------------------------------------------
 #include "DemoPlayer.h"
 
+#include "ByteInputStream.h"
+#include "ByteVecOutputStream.h"
+#include "Controls.h"
 #include "DemoCommon.h"
+#include "DemoCompact.h"
 #include "Doom/Base/i_main.h"
 #include "Doom/d_main.h"
+#include "Doom/psx_main.h"
 #include "Doom/Game/g_game.h"
 #include "Doom/Game/p_tick.h"
 #include "Doom/UI/errormenu_main.h"
 #include "Game.h"
 #include "MapHash.h"
+#include "NetRelayClient.h"
+#include "ProgArgs.h"
+#include "SaveAndLoad.h"
 #include "SaveDataTypes.h"
+#include "Sim/SimTls.h"
+#include "StateHash.h"
 
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <vector>
 
 using namespace DemoCommon;
 
 BEGIN_NAMESPACE(DemoPlayer)
 
-static GameSettings     gPrevGameSettings;                          // The game settings used prior to demo playback (used to restore later)
-static padbuttons_t     gPrevPsxCtrlBindings[NUM_BINDABLE_BTNS];    // The previous original PSX gamepad control bindings (used to restore later)
-static int32_t          gPrevPsxMouseSensitivity;                   // The previous original PSX mouse sensitivity (used to restore later)
-static bool             gbUsingNewDemoFormat;                       // If 'true' then the new PsyDoom demo format is being played
-static DemoTickInputs   gPrevTickInputs[MAXPLAYERS];                // The previous inputs of each player: used to avoid encoding repeats
+static SIM_TLS GameSettings     gPrevGameSettings;                          // The game settings used prior to demo playback (used to restore later)
+static SIM_TLS padbuttons_t     gPrevPsxCtrlBindings[NUM_BINDABLE_BTNS];    // The previous original PSX gamepad control bindings (used to restore later)
+static SIM_TLS int32_t          gPrevPsxMouseSensitivity;                   // The previous original PSX mouse sensitivity (used to restore later)
+static SIM_TLS bool             gbUsingNewDemoFormat;                       // If 'true' then the new PsyDoom demo format is being played
+static SIM_TLS bool             gbUsingCompactDemo;                         // If 'true' then the demo is a compact demo and ticks are read via the decoder
+static SIM_TLS DemoCompact::Decoder gCompactDemoDecoder;                    // Decodes the ticks of a compact demo
+static SIM_TLS DemoTickInputs   gPrevTickInputs[MAXPLAYERS];                // The previous inputs of each player: used to avoid encoding repeats
+
+// How often (in demo ticks) to take a keyframe of the game state during playback, and how many ticks each seek control press moves by
+static constexpr uint32_t KEYFRAME_INTERVAL = 450;
+static constexpr uint32_t SEEK_STEP_TICKS = 150;
+
+// How often to draw a frame while fast forwarding, so that the window shows progress and remains responsive
+static constexpr std::chrono::milliseconds FAST_FORWARD_DRAW_INTERVAL = std::chrono::milliseconds(250);
+
+typedef std::chrono::steady_clock seektimer_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A snapshot of the game and demo playback state taken periodically during playback, used to speed up seeking.
+// The game state (including the RNG indexes) is serialized as a snapshot, which is a save file plus the exact order of the thinker and
+// thing lists. Keyframes are only used in single player.
+// Note: seeking is only bit exact because snapshots preserve that list order (see 'SavedListOrder'): a plain save file does not, so the
+// state hash is recorded with each keyframe and checked again after restoring it, in case anything is ever missed by snapshots.
+// The rest of the state is input related stuff which is not part of a save file but which is needed to resume playback exactly.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct Keyframe {
+    uint32_t                tickIdx;                            // Which demo tick this keyframe was taken before reading
+    size_t                  demoOffset;                         // Offset of the demo read pointer in the demo buffer
+    std::vector<std::byte>  gameState;                          // The game state, as serialized by 'SaveAndLoad::saveSnapshot'
+    DemoTickInputs          prevDemoTickInputs[MAXPLAYERS];     // The previous demo inputs of each player (used to decode repeats)
+    TickInputs              oldTickInputs[MAXPLAYERS];          // The previous tick inputs of each player
+    uint32_t                oldTicButtons;                      // The previous PSX pad buttons
+    uint32_t                elapsedVBlanks;                     // Elapsed vblank counts for the frame the keyframe was taken on
+    int32_t                 playersElapsedVBlanks[MAXPLAYERS];
+    StateHash::TickHash     stateHash;                          // The state hash when the keyframe was taken: verified after restoring
+};
+
+static SIM_TLS std::vector<Keyframe>    gKeyframes;                     // Keyframes taken so far during playback, in ascending tick order
+static SIM_TLS uint32_t                 gCurDemoTick;                   // Index of the next demo tick to be read
+static SIM_TLS bool                     gbFastForward;                  // If 'true' then the user has toggled on fast forwarding
+static SIM_TLS bool                     gbSeeking;                      // If 'true' then fast forwarding until the seek target tick is reached
+static SIM_TLS uint32_t                 gSeekTgtTick;                   // The demo tick being seeked to
+static SIM_TLS seektimer_t::time_point  gSeekStartTime;                 // When the current seek started (for measuring seek latency)
+static SIM_TLS seektimer_t::time_point  gLastFastForwardDrawTime;       // When a frame was last drawn while fast forwarding
+static SIM_TLS char                     gSeekMsg[64];                   // Status bar message for seeking: must remain valid while displayed
+static SIM_TLS uint32_t                 gSeekCheckTick;                 // '-demoseekcheck': the tick to verify the state at after seeking back (0 if none)
+static SIM_TLS StateHash::TickHash      gSeekCheckHash;                 // '-demoseekcheck': the state hash at that tick before seeking back
+static SIM_TLS uint32_t                 gEndStateHash;                  // The combined state hash when playback of the last demo ended (0 if none)
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Save game settings modified by demo playback (for later restoration)
@@ -186,6 +245,282 @@ static void initPrevTickInputs() noexcept {
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: shows a message on the status bar of the player being viewed
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void showPlaybackMessage(const char* const msg) noexcept {
+    gPlayers[gCurPlayerIndex].message = msg;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the total amount of memory used by all keyframes, in bytes
+//------------------------------------------------------------------------------------------------------------------------------------------
+static size_t getKeyframesMemUsage() noexcept {
+    size_t memUsage = gKeyframes.capacity() * sizeof(Keyframe);
+
+    for (const Keyframe& keyframe : gKeyframes) {
+        memUsage += keyframe.gameState.capacity();
+    }
+
+    return memUsage;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Resets all seeking and keyframe related state and frees the memory used by keyframes
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void resetSeekState() noexcept {
+    gKeyframes.clear();
+    gKeyframes.shrink_to_fit();
+    gCurDemoTick = 0;
+    gbFastForward = false;
+    gbSeeking = false;
+    gSeekTgtTick = 0;
+    gSeekStartTime = {};
+    gLastFastForwardDrawTime = {};
+    gSeekCheckTick = 0;
+    gSeekCheckHash = {};
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Takes a keyframe of the current game and playback state, prior to reading the inputs for the current demo tick.
+// Keyframes can only be taken in single player because that is all the save file format supports.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void takeKeyframe() noexcept {
+    ASSERT(gNetGame == gt_single);
+    ByteVecOutputStream gameState;
+
+    if (!SaveAndLoad::saveSnapshot(gameState, false))
+        return;
+
+    Keyframe& keyframe = gKeyframes.emplace_back();
+    keyframe.tickIdx = gCurDemoTick;
+    keyframe.demoOffset = (size_t)(gpDemo_p - gpDemoBuffer);
+    keyframe.gameState = std::move(gameState.getBytes());
+    keyframe.gameState.shrink_to_fit();
+    std::memcpy(keyframe.prevDemoTickInputs, gPrevTickInputs, sizeof(gPrevTickInputs));
+    std::memcpy(keyframe.oldTickInputs, gOldTickInputs, sizeof(gOldTickInputs));
+    keyframe.oldTicButtons = gOldTicButtons;
+    keyframe.elapsedVBlanks = gElapsedVBlanks;
+    std::memcpy(keyframe.playersElapsedVBlanks, gPlayersElapsedVBlanks, sizeof(gPlayersElapsedVBlanks));
+    keyframe.stateHash = StateHash::compute();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Restores the game and playback state to the given keyframe.
+// Returns 'false' on failure, in which case the game state is undefined and playback should be aborted.
+// This includes the case where the restored game state does not hash the same as when the keyframe was taken, since playing on from it
+// would silently diverge from the demo.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool restoreKeyframe(const Keyframe& keyframe) noexcept {
+    ByteInputStream gameState(keyframe.gameState.data(), keyframe.gameState.size());
+    const bool bReadOk = (SaveAndLoad::readSnapshot(gameState, false) == ReadSaveResult::OK);
+    const bool bLoadOk = (bReadOk && (SaveAndLoad::load() == LoadSaveResult::OK));
+    SaveAndLoad::clearBufferedSave();
+
+    if (!bLoadOk)
+        return false;
+
+    const StateHash::TickHash hash = StateHash::compute();
+    const StateHash::TickHash& expected = keyframe.stateHash;
+
+    if (hash != expected) {
+        std::printf(
+            "Demo keyframe at tick %u did not restore the same game state! Mismatched state:%s%s%s%s\n",
+            keyframe.tickIdx,
+            (hash.rng != expected.rng) ? " rng" : "",
+            (hash.players != expected.players) ? " players" : "",
+            (hash.mobjs != expected.mobjs) ? " mobjs" : "",
+            (hash.sectors != expected.sectors) ? " sectors" : ""
+        );
+
+        gbCheckDemoResultFailed = true;
+        return false;
+    }
+
+    gpDemo_p = gpDemoBuffer + keyframe.demoOffset;
+    gCurDemoTick = keyframe.tickIdx;
+
+    if (gbUsingCompactDemo && (!gCompactDemoDecoder.seekToTick(keyframe.tickIdx)))
+        return false;
+
+    std::memcpy(gPrevTickInputs, keyframe.prevDemoTickInputs, sizeof(gPrevTickInputs));
+    std::memcpy(gOldTickInputs, keyframe.oldTickInputs, sizeof(gOldTickInputs));
+    gOldTicButtons = keyframe.oldTicButtons;
+    gElapsedVBlanks = keyframe.elapsedVBlanks;
+    std::memcpy(gPlayersElapsedVBlanks, keyframe.playersElapsedVBlanks, sizeof(gPlayersElapsedVBlanks));
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Restores the game and playback state to a snapshot taken while recording a demo stream (see 'DemoSnapshotHdr').
+// Returns 'false' on failure, in which case the game state is undefined and playback should be aborted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool restoreSnapshot(const std::vector<std::byte>& snapshot) noexcept {
+    ByteInputStream snapshotIn(snapshot.data(), snapshot.size());
+    DemoSnapshotHdr snapshotHdr = {};
+
+    try {
+        snapshotIn.read(snapshotHdr);
+        DemoCommon::endianCorrect(snapshotHdr);
+    }
+    catch (...) {
+        return false;
+    }
+
+    const bool bReadOk = (SaveAndLoad::readSnapshot(snapshotIn, (gNetGame != gt_single)) == ReadSaveResult::OK);
+    const bool bLoadOk = (bReadOk && (SaveAndLoad::load() == LoadSaveResult::OK));
+    SaveAndLoad::clearBufferedSave();
+
+    if (!bLoadOk)
+        return false;
+
+    gCurDemoTick = snapshotHdr.tickIdx;
+    gPrevGameTic = snapshotHdr.prevGameTic;
+    gLastTgtGameTicCount = snapshotHdr.lastTgtGameTicCount;
+    gbIsFirstTick = (snapshotHdr.bIsFirstTick != 0);
+    std::memcpy(gPrevTickInputs, snapshotHdr.prevTickInputs, sizeof(snapshotHdr.prevTickInputs));
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        snapshotHdr.oldTickInputs[playerIdx].deserializeTo(gOldTickInputs[playerIdx]);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Begins seeking to the specified demo tick.
+// Restores the closest keyframe at or before the target tick if that is quicker than simulating forward from the current tick.
+// The rest of the way to the target tick is simulated by fast forwarding.
+// Returns 'false' if restoring a keyframe failed and playback should be aborted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool beginSeek(const uint32_t tgtTick) noexcept {
+    gSeekStartTime = seektimer_t::now();
+    gSeekTgtTick = tgtTick;
+    gbSeeking = true;
+
+    const Keyframe* pKeyframe = nullptr;
+
+    for (const Keyframe& keyframe : gKeyframes) {
+        if (keyframe.tickIdx > tgtTick)
+            break;
+
+        pKeyframe = &keyframe;
+    }
+
+    if (tgtTick < gCurDemoTick) {
+        // Seeking backward: this requires a keyframe
+        if (!pKeyframe) {
+            gbSeeking = false;
+            return true;
+        }
+
+        return restoreKeyframe(*pKeyframe);
+    }
+
+    // Seeking forward: skip ahead to a keyframe if there is one after the current tick
+    if (pKeyframe && (pKeyframe->tickIdx > gCurDemoTick))
+        return restoreKeyframe(*pKeyframe);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Finishes up the current seek and reports how long it took and how much memory keyframes are using
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void endSeek() noexcept {
+    gbSeeking = false;
+
+    const double seekMs = std::chrono::duration<double, std::milli>(seektimer_t::now() - gSeekStartTime).count();
+    const double keyframesMiB = (double) getKeyframesMemUsage() / (1024.0 * 1024.0);
+
+    std::printf(
+        "Demo seek to tick %u: %.1f ms (keyframes: %u, %.2f MiB)\n",
+        gCurDemoTick,
+        seekMs,
+        (uint32_t) gKeyframes.size(),
+        keyframesMiB
+    );
+
+    std::snprintf(gSeekMsg, sizeof(gSeekMsg), "Tick %u: %.0f ms, %.1f MiB", gCurDemoTick, seekMs, keyframesMiB);
+    showPlaybackMessage(gSeekMsg);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// For '-demoseekcheck': once playback has returned to the tick that was seeked back from, checks that the game state is the same as it
+// was before seeking. Returns 'false' and flags the demo result as failed if there is a mismatch.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool updateSeekCheck() noexcept {
+    if ((gSeekCheckTick == 0) || gbSeeking || (gCurDemoTick != gSeekCheckTick))
+        return true;
+
+    gSeekCheckTick = 0;
+    const StateHash::TickHash hash = StateHash::compute();
+
+    if (hash == gSeekCheckHash) {
+        std::printf("Demo seek check at tick %u: OK\n", gCurDemoTick);
+        return true;
+    }
+
+    std::printf(
+        "Demo seek check at tick %u: MISMATCH after seeking back! Mismatched state:%s%s%s%s\n",
+        gCurDemoTick,
+        (hash.rng != gSeekCheckHash.rng) ? " rng" : "",
+        (hash.players != gSeekCheckHash.players) ? " players" : "",
+        (hash.mobjs != gSeekCheckHash.mobjs) ? " mobjs" : "",
+        (hash.sectors != gSeekCheckHash.sectors) ? " sectors" : ""
+    );
+
+    gbCheckDemoResultFailed = true;
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Does updates for seeking and keyframes prior to reading the inputs for a demo tick: takes keyframes if it's time, finishes seeks
+// that have reached their target and handles the user's fast forward and seek controls.
+// Returns 'false' if playback should be aborted due to an error.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool updateSeekingAndKeyframes() noexcept {
+    // Keyframes are based on save files and only single player is supported by those.
+    // Without keyframes seeking backward is not possible but fast forwarding and seeking forward still work.
+    const bool bCanUseKeyframes = (gNetGame == gt_single);
+
+    if (gbSeeking && (gCurDemoTick >= gSeekTgtTick)) {
+        endSeek();
+    }
+
+    if (!updateSeekCheck())
+        return false;
+
+    if (bCanUseKeyframes && (gCurDemoTick % KEYFRAME_INTERVAL == 0)) {
+        if (gKeyframes.empty() || (gKeyframes.back().tickIdx < gCurDemoTick)) {
+            takeKeyframe();
+
+            // If requested, verify that seeking back and replaying up to this keyframe again reproduces the exact same game state
+            if (ProgArgs::gbDemoSeekCheck && (gKeyframes.size() >= 2) && (!gbSeeking)) {
+                gSeekCheckTick = gCurDemoTick;
+                gSeekCheckHash = StateHash::compute();
+                return beginSeek(gCurDemoTick - SEEK_STEP_TICKS);
+            }
+        }
+    }
+
+    if (Controls::isJustPressed(Controls::Binding::Demo_ToggleFastForward)) {
+        gbFastForward = (!gbFastForward);
+        showPlaybackMessage((gbFastForward) ? "Fast forward ON" : "Fast forward OFF");
+    }
+
+    // Note: consecutive seeks are relative to the target of the current seek, so that seeking can be done in bigger steps
+    const uint32_t seekFromTick = (gbSeeking) ? gSeekTgtTick : gCurDemoTick;
+
+    if (bCanUseKeyframes && Controls::isJustPressed(Controls::Binding::Demo_SeekBackward))
+        return beginSeek((seekFromTick > SEEK_STEP_TICKS) ? seekFromTick - SEEK_STEP_TICKS : 0);
+
+    if (Controls::isJustPressed(Controls::Binding::Demo_SeekForward))
+        return beginSeek(seekFromTick + SEEK_STEP_TICKS);
+
+    return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Does the logic for before map load for the new demo format.
 // Returns 'false' if the demo should not be played due to some kind of error.
@@ -349,6 +684,64 @@ static bool readTickInputs_oldDemoFormat() noexcept {
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the tick inputs for a compact demo, which contains the full inputs for every tick in either the new or old demo format.
+// Returns 'false' if the demo should not be played due to some kind of error.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool readTickInputs_compactDemo() noexcept {
+    std::byte record[DemoCompact::MAX_TICK_RECORD_SIZE];
+
+    if (!gCompactDemoDecoder.readTick(record)) {
+        RunDemoErrorMenu_UnexpectedEOF();
+        return false;
+    }
+
+    if (gbUsingNewDemoFormat) {
+        // The record is the status byte (minus the new inputs flags) followed by the inputs for player 1 and player 2
+        const uint8_t statusByte = (uint8_t) record[0];
+        gPlayersElapsedVBlanks[0] = (statusByte >> 3) & 0x7;
+        gPlayersElapsedVBlanks[1] = (statusByte >> 0) & 0x7;
+
+        for (uint32_t playerIdx = 0; playerIdx < 2; ++playerIdx) {
+            DemoTickInputs tickInputs;
+            std::memcpy(&tickInputs, record + 1 + playerIdx * sizeof(DemoTickInputs), sizeof(DemoTickInputs));
+            DemoCommon::endianCorrect(tickInputs);
+            tickInputs.deserializeTo(gTickInputs[playerIdx]);
+            gPrevTickInputs[playerIdx] = tickInputs;
+        }
+    } else {
+        // The record is just the pad buttons for the tick
+        padbuttons_t padBtns;
+        std::memcpy(&padBtns, record, sizeof(padBtns));
+        padBtns = Endian::littleToHost(padBtns);
+        gTicButtons = padBtns;
+        P_PsxButtonsToTickInputs(padBtns, gCtrlBindings, gTickInputs[gCurPlayerIndex]);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Opens the compact demo in the demo buffer for decoding and points the demo read pointer at the demo header wrapped inside it.
+// Returns 'false' if the demo should not be played due to some kind of error.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool openCompactDemo() noexcept {
+    const DemoCompact::OpenResult openResult = gCompactDemoDecoder.open(gpDemoBuffer, (size_t)(gpDemoBufferEnd - gpDemoBuffer));
+
+    if (openResult == DemoCompact::OpenResult::BadVersion) {
+        RunDemoErrorMenu_InvalidDemoVersion();
+        return false;
+    }
+
+    if (openResult != DemoCompact::OpenResult::OK) {
+        RunDemoErrorMenu_UnexpectedEOF();
+        return false;
+    }
+
+    gpDemo_p = gpDemoBuffer + (gCompactDemoDecoder.getHeader() - gpDemoBuffer);
+    return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // This should be called prior to loading the map.
 // Reads some demo header info and checks that its contents are valid.
@@ -358,12 +751,24 @@ bool onBeforeMapLoad() noexcept {
     // Remember modified settings for later restoration and setup the current demo buffer pointer
     saveModifiedGameSettings();
     gpDemo_p = gpDemoBuffer;
+    gEndStateHash = 0;
+    resetSeekState();
 
     // Which demo format are we dealing with?
-    // The first 32-bit integer in the stream tells us this:
+    // The first 32-bit integer in the stream tells us this, after unwrapping the demo header from a compact demo if required:
     try {
+        gbUsingCompactDemo = DemoCompact::isCompactDemo(gpDemoBuffer, (size_t)(gpDemoBufferEnd - gpDemoBuffer));
+
+        if (gbUsingCompactDemo && (!openCompactDemo()))
+            return false;
+
         gbUsingNewDemoFormat = (demo_peek<int32_t>() == -1);
 
+        if (gbUsingCompactDemo && (gbUsingNewDemoFormat != (gCompactDemoDecoder.getTickFormat() == DemoCompact::TickFormat::PsyDoom))) {
+            RunDemoErrorMenu_InvalidDemoVersion();
+            return false;
+        }
+
         if (gbUsingNewDemoFormat) {
             return onBeforeMapLoad_newDemoFormat();
         } else {
@@ -382,7 +787,12 @@ bool onBeforeMapLoad() noexcept {
 // Returns 'false' if the demo should not be played due to some kind of error.
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool onAfterMapLoad() noexcept {
-    // This only does stuff for the new demo format!
+    // If requested via the command line then fast forward to a specific tick at the start of playback
+    if (ProgArgs::gDemoSeekTick > 0) {
+        beginSeek((uint32_t) ProgArgs::gDemoSeekTick);
+    }
+
+    // The rest of this only does stuff for the new demo format!
     if (!gbUsingNewDemoFormat)
         return true;
 
@@ -417,6 +827,23 @@ bool onAfterMapLoad() noexcept {
         return false;
     }
 
+    // If spectating a game part way through the map then start from the snapshot of the game state sent by the relay (if any).
+    // Catch up to the rest of the ticks played since by seeking (fast forwarding) through them.
+    if (NetRelayClient::isSpectating()) {
+        const std::vector<std::byte>& snapshot = NetRelayClient::getJoinSnapshot();
+
+        if ((!snapshot.empty()) && (!restoreSnapshot(snapshot))) {
+            std::printf("Failed to restore the game state snapshot sent by the spectator relay!\n");
+            return false;
+        }
+
+        const uint32_t catchUpTick = NetRelayClient::getCatchUpTick();
+
+        if (catchUpTick > gCurDemoTick) {
+            beginSeek(catchUpTick);
+        }
+    }
+
     // Success if we get to here!
     return true;
 }
@@ -428,6 +855,13 @@ bool hasReachedDemoEnd() noexcept {
     if (!gpDemo_p)
         return true;
 
+    // When spectating, more of the demo stream may still be on the way
+    if (NetRelayClient::isSpectating())
+        return NetRelayClient::hasReachedStreamEnd();
+
+    if (gbUsingCompactDemo)
+        return gCompactDemoDecoder.hasReachedEnd();
+
     if (gbUsingNewDemoFormat) {
         return (!demo_canRead<DemoTickInputs>());
     } else {
@@ -454,13 +888,43 @@ bool isPlayingAClassicDemo() noexcept {
 // Returns 'false' if the demo should not be played due to some kind of error.
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool readTickInputs() noexcept {
-    if (gbUsingNewDemoFormat) {
+    if (!updateSeekingAndKeyframes())
+        return false;
+
+    // When spectating wait for the inputs for this tick to arrive (and for the spectator delay to pass) if they are not available yet
+    if (NetRelayClient::isSpectating() && (!NetRelayClient::waitForTickData()))
+        return false;
+
+    // When spectating verify the game state against the game being watched, if a hash of it was sent for this tick
+    if (NetRelayClient::isSpectating() && (!NetRelayClient::checkStateHash(gCurDemoTick)))
+        return false;
+
+    gCurDemoTick++;
+
+    if (gbUsingCompactDemo) {
+        return readTickInputs_compactDemo();
+    } else if (gbUsingNewDemoFormat) {
         return readTickInputs_newDemoFormat();
     } else {
         return readTickInputs_oldDemoFormat();
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Should be called when demo playback stops, before the map is unloaded: records the final game state hash for the demo
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onBeforeMapUnload() noexcept {
+    gEndStateHash = StateHash::compute().combined();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the combined game state hash when playback of the last demo stopped, or '0' if the demo's map was never loaded.
+// Used to check that playing the same demo in different ways (e.g on different threads) leaves the game in exactly the same state.
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getEndStateHash() noexcept {
+    return gEndStateHash;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Should be called when demo playback is done, or when it has been aborted due to an error
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -472,9 +936,44 @@ void onPlaybackDone() noexcept {
     // Cleanup all globals and reset them to a default state
     std::memset(gPrevTickInputs, 0, sizeof(gPrevTickInputs));
     gbUsingNewDemoFormat = false;
+    gbUsingCompactDemo = false;
+    gCompactDemoDecoder.close();
     gPrevPsxMouseSensitivity = {};
     std::memset(gPrevPsxCtrlBindings, 0, sizeof(gPrevPsxCtrlBindings));
     gPrevGameSettings = {};
+    resetSeekState();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if demo playback is being fast forwarded, either because the user requested it or because a seek is in progress.
+// Sounds are not played while fast forwarding, and most frames are not drawn.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isFastForwarding() noexcept {
+    return (gbDemoPlayback && (gbFastForward || gbSeeking));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if drawing should be skipped for this frame of demo playback, so that the simulation can run uncapped.
+// While fast forwarding, a frame is still drawn periodically so that the window shows progress and stays responsive.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool shouldSkipDrawing() noexcept {
+    if (!isFastForwarding())
+        return false;
+
+    const seektimer_t::time_point now = seektimer_t::now();
+
+    if (now - gLastFastForwardDrawTime < FAST_FORWARD_DRAW_INTERVAL)
+        return true;
+
+    gLastFastForwardDrawTime = now;
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns how many ticks of the current map's demo have been read so far
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getCurTick() noexcept {
+    return gCurDemoTick;
 }
 
 END_NAMESPACE(DemoPlayer)
@@ -2,6 +2,8 @@
 
 #include "Macros.h"
 
+#include <cstdint>
+
 BEGIN_NAMESPACE(DemoPlayer)
 
 bool onBeforeMapLoad() noexcept;
@@ -10,6 +12,11 @@ bool hasReachedDemoEnd() noexcept;
 bool isUsingNewDemoFormat() noexcept;
 bool isPlayingAClassicDemo() noexcept;
 bool readTickInputs() noexcept;
+void onBeforeMapUnload() noexcept;
+uint32_t getEndStateHash() noexcept;
 void onPlaybackDone() noexcept;
+bool isFastForwarding() noexcept;
+bool shouldSkipDrawing() noexcept;
+uint32_t getCurTick() noexcept;
 
 END_NAMESPACE(DemoPlayer)
@@ -2,10 +2,15 @@
 // A module responsible for most of the logic relating to demo recording.
 // The demos are recorded in a new format specific to PsyDoom that has greater capabilities than the original format.
 // Improvements include greater timing resolution (30Hz vs 15Hz ticks), analog movement and multiplayer support.
+// The demo can also be streamed live to a spectator relay, along with periodic snapshots of the game state for spectators joining late
+// and periodic hashes of the game state, which spectators use to verify they are in sync.
+// Demo files are saved in the compact demo format (see 'DemoCompact.h') while the relay is sent the regular uncompressed tick stream.
 //------------------------------------------------------------------------------------------------------------------------------------------
 #include "DemoRecorder.h"
 
+#include "ByteVecOutputStream.h"
 #include "DemoCommon.h"
+#include "DemoCompact.h"
 #include "Doom/Base/i_main.h"
 #include "Doom/d_main.h"
 #include "Doom/Game/g_game.h"
@@ -14,7 +19,11 @@
 #include "FileOutputStream.h"
 #include "Game.h"
 #include "MapHash.h"
+#include "NetRelayClient.h"
+#include "ProgArgs.h"
+#include "SaveAndLoad.h"
 #include "SaveDataTypes.h"
+#include "StateHash.h"
 #include "Utils.h"
 
 #include <algorithm>
@@ -25,9 +34,25 @@ BEGIN_NAMESPACE(DemoRecorder)
 
 typedef std::unique_ptr<FileOutputStream> DemoFilePtr;
 
-static std::string      gDemoFilePath;                  // Path of the demo file being recorded to
-static DemoFilePtr      gpDemoFile;                     // The demo file currently being recorded to
-static DemoTickInputs   gPrevTickInputs[MAXPLAYERS];    // The previous inputs of each player: used to avoid encoding repeats
+// How often (in demo ticks) to send the spectator relay a snapshot of the game state, for spectators joining part way through a map
+static constexpr uint32_t RELAY_SNAPSHOT_INTERVAL = 300;
+
+// How often (in demo ticks) to send the spectator relay a hash of the game state, for spectators to verify they are in sync.
+// Note: this divides the snapshot interval, so that a hash is always sent for the tick that a snapshot is taken before.
+static constexpr uint32_t RELAY_STATE_HASH_INTERVAL = 30;
+static_assert(RELAY_SNAPSHOT_INTERVAL % RELAY_STATE_HASH_INTERVAL == 0);
+
+// How often (in demo ticks) to end the current compact demo block and flush the demo file to disk.
+// Limits how much of the demo is lost if the game crashes, at a small cost in compression since each block starts with a fresh model.
+static constexpr uint32_t DEMO_FILE_FLUSH_INTERVAL = 300;
+
+static std::string          gDemoFilePath;                  // Path of the demo file being recorded to
+static DemoFilePtr          gpDemoFile;                     // The demo file currently being recorded to
+static DemoCompact::Encoder gDemoFileEncoder;               // Encodes the demo file in the compact demo format
+static bool                 gbStreamingToRelay;             // If 'true' then the demo is also being streamed to a spectator relay
+static uint32_t             gNumTicksRecorded;              // How many ticks have been recorded so far
+static ByteVecOutputStream  gEncodeBuffer;                  // Holds the encoded demo header or tick inputs before output
+static DemoTickInputs       gPrevTickInputs[MAXPLAYERS];    // The previous inputs of each player: used to avoid encoding repeats
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Returns the path of the demo file that will be recorded for the current map
@@ -58,35 +83,32 @@ static void closeDemoFile() noexcept {
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Writes the demo file header.
 // This includes all the information about the game and the starting state for all players.
-// Note: expects the demo file to be open for writing!
 //------------------------------------------------------------------------------------------------------------------------------------------
-static void writeDemoHeader() THROWS {
-    ASSERT(gpDemoFile);
-
+static void writeDemoHeader(OutputStream& out) THROWS {
     // Begin the demo with a 32-bit integer set to '-1'.
     // This is a signature to distinguish the new demo lump format from the old one.
     // In the old demo format this integer was the 'skill' field.
-    gpDemoFile->write<int32_t>(Endian::hostToLittle(-1));
+    out.write<int32_t>(Endian::hostToLittle(-1));
 
     // Record the current demo file version
-    gpDemoFile->write<uint32_t>(Endian::hostToLittle(DEMO_FILE_VERSION));
+    out.write<uint32_t>(Endian::hostToLittle(DEMO_FILE_VERSION));
 
     // Record the skill, map number, whether this is multiplayer and which player the demo is being played for
-    gpDemoFile->write<int32_t>(Endian::hostToLittle(gGameSkill));
-    gpDemoFile->write<int32_t>(Endian::hostToLittle(gGameMap));
-    gpDemoFile->write<int32_t>(Endian::hostToLittle(gNetGame));
-    gpDemoFile->write<int32_t>(Endian::hostToLittle(gCurPlayerIndex));
+    out.write<int32_t>(Endian::hostToLittle(gGameSkill));
+    out.write<int32_t>(Endian::hostToLittle(gGameMap));
+    out.write<int32_t>(Endian::hostToLittle(gNetGame));
+    out.write<int32_t>(Endian::hostToLittle(gCurPlayerIndex));
 
     // Record the game settings
     {
         GameSettings settings = Game::gSettings;
         settings.endianCorrect();
-        gpDemoFile->write(settings);
+        out.write(settings);
     }
 
     // Record the hash of the map being played so we can verify the same map is being played for the demo
-    gpDemoFile->write<uint64_t>(Endian::hostToLittle(MapHash::gWord1));
-    gpDemoFile->write<uint64_t>(Endian::hostToLittle(MapHash::gWord2));
+    out.write<uint64_t>(Endian::hostToLittle(MapHash::gWord1));
+    out.write<uint64_t>(Endian::hostToLittle(MapHash::gWord2));
 
     // Record details for all the players starting the game, including health and ammo etc.
     const int32_t numPlayers = (gNetGame != gt_single) ? 2 : 1;
@@ -96,25 +118,23 @@ static void writeDemoHeader() THROWS {
         SavedPlayerT player = {};
         player.serializeFrom(gPlayers[playerIdx]);
         DemoCommon::endianCorrect(player);
-        gpDemoFile->write(player);
+        out.write(player);
     }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Writes the specified 'DemoTickInputs' structure to the demo file
+// Writes the specified 'DemoTickInputs' structure to the given stream
 //------------------------------------------------------------------------------------------------------------------------------------------
-static void writeTickInputs(const DemoTickInputs& tickInputs) noexcept {
-    ASSERT(isRecording());
-
+static void writeTickInputs(OutputStream& out, const DemoTickInputs& tickInputs) THROWS {
     if constexpr (Endian::isLittle()) {
         // Little endian CPU: just write the inputs as-is
-        gpDemoFile->write(tickInputs);
+        out.write(tickInputs);
     }
     else {
         // Big endian CPU: have to convert the tick inputs to little endian before writing
         DemoTickInputs tickInputsLE = tickInputs;
         tickInputsLE.byteSwap();
-        gpDemoFile->write(tickInputsLE);
+        out.write(tickInputsLE);
     }
 }
 
@@ -142,17 +162,88 @@ static void handleDemoWriteError() noexcept {
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Begins the process of recording a demo.
-// If recording fails then a fatal error is issued.
+// Outputs the contents of the encode buffer to the spectator relay (if streaming to one), as a message of the given type
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendEncodeBufferToRelay(const NetRelayProtocol::MsgType relayMsgType) noexcept {
+    const std::vector<std::byte>& bytes = gEncodeBuffer.getBytes();
+
+    if (gbStreamingToRelay) {
+        NetRelayClient::sendTapMessage(relayMsgType, bytes.data(), (uint32_t) bytes.size());
+        gbStreamingToRelay = NetRelayClient::isTapConnected();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends a snapshot of the game state to the spectator relay, prior to recording the inputs for the current tick.
+// The relay gives the latest snapshot to spectators joining part way through the map, so they don't have to simulate from the start.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendRelaySnapshot() noexcept {
+    ByteVecOutputStream snapshot;
+
+    // Save the state needed to resume playback from this tick, which is not part of the game state
+    DemoSnapshotHdr snapshotHdr = {};
+    snapshotHdr.tickIdx = gNumTicksRecorded;
+    snapshotHdr.prevGameTic = gPrevGameTic;
+    snapshotHdr.lastTgtGameTicCount = gLastTgtGameTicCount;
+    snapshotHdr.bIsFirstTick = gbIsFirstTick;
+    std::memcpy(snapshotHdr.prevTickInputs, gPrevTickInputs, sizeof(snapshotHdr.prevTickInputs));
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        snapshotHdr.oldTickInputs[playerIdx].serializeFrom(gOldTickInputs[playerIdx]);
+    }
+
+    DemoCommon::endianCorrect(snapshotHdr);
+    snapshot.write(snapshotHdr);
+
+    // Save the game state itself: just skip the snapshot if that fails, late joining spectators will use an older one
+    if (!SaveAndLoad::saveSnapshot(snapshot, (gNetGame != gt_single)))
+        return;
+
+    const std::vector<std::byte>& bytes = snapshot.getBytes();
+    NetRelayClient::sendTapMessage(NetRelayProtocol::MsgType::Snapshot, bytes.data(), (uint32_t) bytes.size());
+    gbStreamingToRelay = NetRelayClient::isTapConnected();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends a hash of the game state to the spectator relay, prior to recording the inputs for the current tick.
+// Spectators compare this against their own game state when they reach the same tick.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendRelayStateHash() noexcept {
+    NetRelayProtocol::StateHashMsg msg = { gNumTicksRecorded, StateHash::compute() };
+
+    if constexpr (Endian::isBig()) {
+        msg.byteSwap();
+    }
+
+    NetRelayClient::sendTapMessage(NetRelayProtocol::MsgType::StateHash, &msg, sizeof(msg));
+    gbStreamingToRelay = NetRelayClient::isTapConnected();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Begins the process of recording a demo: to a demo file if demo recording is enabled, and to the spectator relay if connected to one.
+// If recording to a demo file fails then a fatal error is issued.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void begin() noexcept {
     try {
-        openDemoFile();
-        writeDemoHeader();
-        initPrevTickInputs();
+        if (ProgArgs::gbRecordDemos) {
+            openDemoFile();
+        }
+
+        gbStreamingToRelay = NetRelayClient::isTapConnected();
+        gEncodeBuffer.reset();
+        writeDemoHeader(gEncodeBuffer);
+
+        if (gpDemoFile) {
+            const std::vector<std::byte>& header = gEncodeBuffer.getBytes();
+            gDemoFileEncoder.begin(*gpDemoFile, DemoCompact::TickFormat::PsyDoom, header.data(), (uint32_t) header.size());
+        }
     } catch (...) {
         handleDemoWriteError();
     }
+
+    sendEncodeBufferToRelay(NetRelayProtocol::MsgType::MapBegin);
+    initPrevTickInputs();
+    gNumTicksRecorded = 0;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -162,11 +253,19 @@ void begin() noexcept {
 void end() noexcept {
     ASSERT(isRecording());
 
-    try {
-        gpDemoFile->flush();
-        closeDemoFile();
-    } catch (...) {
-        handleDemoWriteError();
+    if (gbStreamingToRelay) {
+        NetRelayClient::sendTapMessage(NetRelayProtocol::MsgType::MapEnd, nullptr, 0);
+        gbStreamingToRelay = false;
+    }
+
+    if (gpDemoFile) {
+        try {
+            gDemoFileEncoder.end(*gpDemoFile);
+            gpDemoFile->flush();
+            closeDemoFile();
+        } catch (...) {
+            handleDemoWriteError();
+        }
     }
 }
 
@@ -174,7 +273,7 @@ void end() noexcept {
 // Tells if the demo is currently recording
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool isRecording() noexcept {
-    return (gpDemoFile != nullptr);
+    return ((gpDemoFile != nullptr) || gbStreamingToRelay);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -184,6 +283,15 @@ bool isRecording() noexcept {
 void recordTick() noexcept {
     ASSERT(isRecording());
 
+    // Periodically give the spectator relay a snapshot of the game state before this tick
+    if (gbStreamingToRelay && (gNumTicksRecorded > 0) && (gNumTicksRecorded % RELAY_SNAPSHOT_INTERVAL == 0)) {
+        sendRelaySnapshot();
+    }
+
+    if (gbStreamingToRelay && (gNumTicksRecorded % RELAY_STATE_HASH_INTERVAL == 0)) {
+        sendRelayStateHash();
+    }
+
     // Get the inputs for player 1 and 2
     DemoTickInputs p1Inputs = {};
     DemoTickInputs p2Inputs = {};
@@ -211,25 +319,55 @@ void recordTick() noexcept {
     statusByte |= ((uint8_t) std::clamp(gPlayersElapsedVBlanks[0], 0, 7)) << 3;
     statusByte |= ((uint8_t) std::clamp(gPlayersElapsedVBlanks[1], 0, 7));
 
-    // Write the status byte followed by the inputs if they have changed
-    try {
-        gpDemoFile->write(statusByte);
+    // Save the full inputs for the tick to the demo file: the compact demo encoder takes care of compressing repeated inputs.
+    // The tick record is the status byte minus the new inputs flags, followed by the little endian inputs for both players.
+    if (gpDemoFile) {
+        DemoTickInputs inputsLE[2] = { p1Inputs, p2Inputs };
+        DemoCommon::endianCorrect(inputsLE[0]);
+        DemoCommon::endianCorrect(inputsLE[1]);
 
-        if (statusByte & 0x80) {
-            writeTickInputs(p1Inputs);
-        }
+        std::byte tickRecord[1 + sizeof(inputsLE)];
+        tickRecord[0] = (std::byte)(statusByte & 0x3F);
+        std::memcpy(tickRecord + 1, inputsLE, sizeof(inputsLE));
 
-        if (statusByte & 0x40) {
-            writeTickInputs(p2Inputs);
+        try {
+            gDemoFileEncoder.addTick(*gpDemoFile, tickRecord);
+
+            if (gDemoFileEncoder.getNumTicks() % DEMO_FILE_FLUSH_INTERVAL == 0) {
+                gDemoFileEncoder.flushBlock(*gpDemoFile);
+                gpDemoFile->flush();
+            }
+        }
+        catch (...) {
+            handleDemoWriteError();
         }
     }
-    catch (...) {
-        handleDemoWriteError();
+
+    // Encode the status byte followed by the inputs if they have changed, then send to the spectator relay
+    gEncodeBuffer.reset();
+    gEncodeBuffer.write(statusByte);
+
+    if (statusByte & 0x80) {
+        writeTickInputs(gEncodeBuffer, p1Inputs);
     }
 
+    if (statusByte & 0x40) {
+        writeTickInputs(gEncodeBuffer, p2Inputs);
+    }
+
+    sendEncodeBufferToRelay(NetRelayProtocol::MsgType::Ticks);
+
     // Remember the current inputs as the previous ones
     gPrevTickInputs[0] = p1Inputs;
     gPrevTickInputs[1] = p2Inputs;
+    gNumTicksRecorded++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns how many ticks have been recorded for the current map so far
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getNumTicksRecorded() noexcept {
+    return gNumTicksRecorded;
 }
 
 END_NAMESPACE(DemoRecorder)
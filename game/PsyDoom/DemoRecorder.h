@@ -2,11 +2,14 @@
 
 #include "Macros.h"
 
+#include <cstdint>
+
 BEGIN_NAMESPACE(DemoRecorder)
 
 void begin() noexcept;
 void end() noexcept;
 bool isRecording() noexcept;
 void recordTick() noexcept;
+uint32_t getNumTicksRecorded() noexcept;
 
 END_NAMESPACE(DemoRecorder)
@@ -0,0 +1,292 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Frame scheduler: waits for game tic and present deadlines without pinning a CPU core.
+//
+// The original game busy-waits on the vblank counter until enough vblanks have elapsed to run the next tic, and PsyDoom previously
+// emulated this by polling the vblank count in a loop with a thread yield. That keeps the game thread at 100% CPU usage even when the
+// game is idle at 30 Hz. Instead the scheduler sleeps on a high resolution timer until shortly before the deadline, and only spins
+// (while yielding) for the final fraction of a millisecond. How early to wake up is adapted to how much the OS tends to oversleep.
+//
+// On some systems (virtual machines in particular) the thread is often stalled for milliseconds shortly after waking from any sleep,
+// regardless of how early it wakes. If deadlines that were slept for are being missed too often then the scheduler falls back to the
+// old behavior of spinning the whole time, and tries sleeping again after a while.
+//
+// Note that the scheduler only decides how to wait: callers still poll the vblank counter as before and decide when to stop waiting.
+// This means game timing (and demo playback in particular) is exactly the same as before.
+//
+// Also gathers stats for how late tic deadlines were met and how much CPU time the game thread used, for capped and uncapped framerates.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "FrameScheduler.h"
+
+#include "ProgArgs.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <thread>
+
+#if _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+#endif
+
+BEGIN_NAMESPACE(FrameScheduler)
+
+// Never sleep longer than this in one go: callers of 'idleUntil' do periodic platform updates in between waits (input, sound etc.)
+static constexpr auto MAX_SLEEP_TIME = std::chrono::milliseconds(4);
+
+// Limits for how long before a deadline to stop sleeping and start spinning instead
+static constexpr auto MIN_SPIN_TIME = std::chrono::microseconds(200);
+static constexpr auto MAX_SPIN_TIME = std::chrono::milliseconds(4);
+
+// How quickly the estimate of OS oversleep decays (per sleep) after a large oversleep
+static constexpr double OVERSLEEP_DECAY = 0.98;
+
+// Sleeping is checked for deadline misses over windows of this many tic deadlines (3 seconds at 30 Hz).
+// If more deadlines than allowed were missed after sleeping then only spin for the next few windows before trying to sleep again.
+static constexpr uint32_t SLEEP_CHECK_WINDOW_TICS = 90;
+static constexpr uint32_t SLEEP_CHECK_MAX_MISSES = 1;
+static constexpr uint32_t SPIN_ONLY_WINDOWS = 20;
+
+// Buckets for the histogram of how late tic deadlines were met by, and their upper bounds in microseconds.
+// Anything at least 1 MS late is counted as a deadline miss. The last bucket (>= 1 NTSC vblank) has no upper bound.
+static constexpr uint32_t NUM_LATENESS_BUCKETS = 8;
+static constexpr int64_t LATENESS_BUCKET_USEC[NUM_LATENESS_BUCKETS - 1] = { 250, 500, 1000, 2000, 4000, 8000, 16667 };
+static constexpr int64_t DEADLINE_MISS_USEC = 1000;
+
+// Timing stats for either the capped or uncapped framerate mode
+struct ModeStats {
+    uint64_t    numTics;
+    uint64_t    numMisses;
+    double      wallSecs;                                   // Real time spent in this mode
+    double      cpuSecs;                                    // Game thread CPU time spent in this mode
+    uint64_t    latenessHistogram[NUM_LATENESS_BUCKETS];
+    uint64_t    numSpinOnlyTics;                            // How many tics were waited for by spinning only, due to misses after sleeping
+};
+
+static ModeStats            gModeStats[2];                  // Stats for the capped (index '0') and uncapped (index '1') framerate modes
+static timepoint_t          gLastSampleWallTime;            // When wall and CPU time were last sampled
+static double               gLastSampleCpuSecs;
+static std::chrono::nanoseconds gOversleepEstimate;         // Decaying estimate of the worst recent amount the OS overslept by
+static bool                 gbSleptForDeadline;             // Did the scheduler sleep while waiting for the current tic deadline?
+static uint32_t             gWindowTics;                    // Number of tic deadlines so far in the current sleep check window
+static uint32_t             gWindowSleepMisses;             // Number of deadlines missed after sleeping in the current sleep check window
+static uint32_t             gSpinOnlyWindowsLeft;           // If non zero then don't sleep: only spin until this many more windows have passed
+
+#if _WIN32
+    static HANDLE gWaitableTimer;                           // High resolution waitable timer, if supported by the OS
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the CPU time used so far by the calling thread, in seconds
+//------------------------------------------------------------------------------------------------------------------------------------------
+static double getThreadCpuSecs() noexcept {
+    #if _WIN32
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+
+        if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+            const uint64_t kernel100ns = ((uint64_t) kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+            const uint64_t user100ns = ((uint64_t) userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+            return (double)(kernel100ns + user100ns) * 1e-7;
+        }
+
+        return 0.0;
+    #elif defined(CLOCK_THREAD_CPUTIME_ID)
+        timespec cpuTime = {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+        return (double) cpuTime.tv_sec + (double) cpuTime.tv_nsec * 1e-9;
+    #else
+        return (double) std::clock() / (double) CLOCKS_PER_SEC;
+    #endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Puts the calling thread to sleep for the specified amount of time, using the highest resolution timer available
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sleepFor(const std::chrono::nanoseconds duration) noexcept {
+    #if _WIN32
+        if (gWaitableTimer) {
+            // Note: the due time is relative and in 100 nanosecond units, hence the negation
+            LARGE_INTEGER dueTime = {};
+            dueTime.QuadPart = -std::max<LONGLONG>(duration.count() / 100, 1);
+
+            if (SetWaitableTimer(gWaitableTimer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+                WaitForSingleObject(gWaitableTimer, INFINITE);
+                return;
+            }
+        }
+
+        std::this_thread::sleep_for(duration);
+    #elif __linux__
+        timespec sleepTime = {};
+        sleepTime.tv_sec = (time_t)(duration.count() / 1000000000);
+        sleepTime.tv_nsec = (long)(duration.count() % 1000000000);
+
+        // Retry the remaining time if interrupted by a signal
+        while (clock_nanosleep(CLOCK_MONOTONIC, 0, &sleepTime, &sleepTime) == EINTR) {}
+    #else
+        std::this_thread::sleep_for(duration);
+    #endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes the frame scheduler and starts gathering stats
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init() noexcept {
+    #if _WIN32
+        gWaitableTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    #endif
+
+    gModeStats[0] = {};
+    gModeStats[1] = {};
+    gLastSampleWallTime = schedclock_t::now();
+    gLastSampleCpuSecs = getThreadCpuSecs();
+    gOversleepEstimate = MIN_SPIN_TIME;
+    gbSleptForDeadline = false;
+    gWindowTics = 0;
+    gWindowSleepMisses = 0;
+    gSpinOnlyWindowsLeft = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Shuts down the frame scheduler, printing timing stats if requested via program arguments
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    if (ProgArgs::gbPrintFrameStats) {
+        printStats();
+    }
+
+    #if _WIN32
+        if (gWaitableTimer) {
+            CloseHandle(gWaitableTimer);
+            gWaitableTimer = nullptr;
+        }
+    #endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Idles the calling thread for some or all of the time remaining until the specified deadline.
+// Meant to be called repeatedly in a polling loop which does platform updates in between waits, since it may return well before the deadline.
+// Sleeps when the deadline is far enough away, otherwise just yields the remainder of the thread's time slice.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void idleUntil(const timepoint_t deadline) noexcept {
+    const timepoint_t now = schedclock_t::now();
+
+    if (now >= deadline)
+        return;
+
+    // Spin if the deadline is too close to risk sleeping past it
+    const std::chrono::nanoseconds spinTime = std::clamp<std::chrono::nanoseconds>(gOversleepEstimate + MIN_SPIN_TIME, MIN_SPIN_TIME, MAX_SPIN_TIME);
+    const std::chrono::nanoseconds timeLeft = deadline - now;
+
+    if ((timeLeft <= spinTime) || (gSpinOnlyWindowsLeft > 0)) {
+        std::this_thread::yield();
+        return;
+    }
+
+    // Otherwise sleep until the spin period and track how much the OS oversleeps, so we can wake up early enough next time
+    const std::chrono::nanoseconds sleepTime = std::min<std::chrono::nanoseconds>(timeLeft - spinTime, MAX_SLEEP_TIME);
+    sleepFor(sleepTime);
+    gbSleptForDeadline = true;
+
+    const std::chrono::nanoseconds oversleep = std::max<std::chrono::nanoseconds>(schedclock_t::now() - now - sleepTime, {});
+    const std::chrono::nanoseconds decayedEstimate = std::chrono::nanoseconds((int64_t)((double) gOversleepEstimate.count() * OVERSLEEP_DECAY));
+    gOversleepEstimate = std::max(oversleep, decayedEstimate);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Records stats for a tic deadline which has just been met, given the time the deadline was for and the current framerate mode
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onTicDeadline(const timepoint_t deadline, const bool bUncappedFramerate) noexcept {
+    const timepoint_t now = schedclock_t::now();
+    const double cpuSecs = getThreadCpuSecs();
+    ModeStats& stats = gModeStats[(bUncappedFramerate) ? 1 : 0];
+
+    // Attribute the wall and CPU time since the last tic to this mode
+    stats.wallSecs += std::chrono::duration<double>(now - gLastSampleWallTime).count();
+    stats.cpuSecs += cpuSecs - gLastSampleCpuSecs;
+    gLastSampleWallTime = now;
+    gLastSampleCpuSecs = cpuSecs;
+
+    // Add to the lateness histogram
+    const int64_t latenessUsec = std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count(), 0);
+    const auto bucketIter = std::upper_bound(std::begin(LATENESS_BUCKET_USEC), std::end(LATENESS_BUCKET_USEC), latenessUsec);
+    const uint32_t bucketIdx = (uint32_t)(bucketIter - std::begin(LATENESS_BUCKET_USEC));
+
+    stats.numTics++;
+    stats.latenessHistogram[bucketIdx]++;
+
+    if (latenessUsec >= DEADLINE_MISS_USEC) {
+        stats.numMisses++;
+
+        if (gbSleptForDeadline) {
+            gWindowSleepMisses++;
+        }
+    }
+
+    if (gSpinOnlyWindowsLeft > 0) {
+        stats.numSpinOnlyTics++;
+    }
+
+    gbSleptForDeadline = false;
+
+    // At the end of each sleep check window decide whether to only spin for a while, because sleeping is causing deadline misses
+    gWindowTics++;
+
+    if (gWindowTics >= SLEEP_CHECK_WINDOW_TICS) {
+        if (gSpinOnlyWindowsLeft > 0) {
+            gSpinOnlyWindowsLeft--;
+        } else if (gWindowSleepMisses > SLEEP_CHECK_MAX_MISSES) {
+            gSpinOnlyWindowsLeft = SPIN_ONLY_WINDOWS;
+        }
+
+        gWindowTics = 0;
+        gWindowSleepMisses = 0;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints game thread CPU utilization and tic deadline lateness histograms to standard out for the capped and uncapped framerate modes
+//------------------------------------------------------------------------------------------------------------------------------------------
+void printStats() noexcept {
+    for (uint32_t modeIdx = 0; modeIdx < 2; ++modeIdx) {
+        const ModeStats& stats = gModeStats[modeIdx];
+
+        if (stats.numTics == 0)
+            continue;
+
+        std::printf(
+            "PsyDoom: frame scheduler (%s framerate): %llu tics over %.1f secs, game thread CPU usage %.1f%%, %llu deadline misses (%.2f%%)\n",
+            (modeIdx == 0) ? "capped" : "uncapped",
+            (unsigned long long) stats.numTics,
+            stats.wallSecs,
+            (stats.wallSecs > 0.0) ? 100.0 * stats.cpuSecs / stats.wallSecs : 0.0,
+            (unsigned long long) stats.numMisses,
+            100.0 * (double) stats.numMisses / (double) stats.numTics
+        );
+
+        if (stats.numSpinOnlyTics > 0) {
+            std::printf(
+                "    spun without sleeping for %llu tics (%.2f%%) because of deadline misses after sleeping\n",
+                (unsigned long long) stats.numSpinOnlyTics,
+                100.0 * (double) stats.numSpinOnlyTics / (double) stats.numTics
+            );
+        }
+
+        for (uint32_t bucketIdx = 0; bucketIdx < NUM_LATENESS_BUCKETS; ++bucketIdx) {
+            const uint64_t count = stats.latenessHistogram[bucketIdx];
+            const double percent = 100.0 * (double) count / (double) stats.numTics;
+
+            if (bucketIdx + 1 < NUM_LATENESS_BUCKETS) {
+                std::printf("    late by < %6.2f MS: %8llu (%6.2f%%)\n", (double) LATENESS_BUCKET_USEC[bucketIdx] / 1000.0, (unsigned long long) count, percent);
+            } else {
+                std::printf("    late by >= %5.2f MS: %8llu (%6.2f%%)\n", (double) LATENESS_BUCKET_USEC[bucketIdx - 1] / 1000.0, (unsigned long long) count, percent);
+            }
+        }
+    }
+}
+
+END_NAMESPACE(FrameScheduler)
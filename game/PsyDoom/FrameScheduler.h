@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <chrono>
+
+BEGIN_NAMESPACE(FrameScheduler)
+
+typedef std::chrono::steady_clock   schedclock_t;
+typedef schedclock_t::time_point    timepoint_t;
+
+void init() noexcept;
+void shutdown() noexcept;
+void idleUntil(const timepoint_t deadline) noexcept;
+void onTicDeadline(const timepoint_t deadline, const bool bUncappedFramerate) noexcept;
+void printStats() noexcept;
+
+END_NAMESPACE(FrameScheduler)
@@ -72,19 +72,19 @@ static constexpr uint32_t SOUL_LIMIT_FINAL_DOOM = 16;
 static constexpr String32 UNKNOWN_EPISODE_NAME = "Unknown Episode";
 static constexpr String32 UNKNOWN_MAP_NAME = "Unknown Map";
 
-GameType        gGameType;              // The high level game type (Doom, Final Doom etc.)
-GameVariant     gGameVariant;           // Which region specific version of the game this is
-GameSettings    gSettings;              // Game rules to play with (unless overriden by demo playback or multiplayer)
-GameConstants   gConstants;             // Constants that vary by game type
-bool            gbIsDemoVersion;        // If the game type is 'Doom' this is set to 'true' if the one level demo disc is being played
-bool            gbIsPsxDoomForever;     // If the game type is 'Final Doom' this is set to 'true' if the 'PSX Doom Forever' ROM hack is being played
+GameType                gGameType;              // The high level game type (Doom, Final Doom etc.)
+GameVariant             gGameVariant;           // Which region specific version of the game this is
+SIM_TLS GameSettings    gSettings;              // Game rules to play with (unless overriden by demo playback or multiplayer)
+GameConstants           gConstants;             // Constants that vary by game type
+bool                    gbIsDemoVersion;        // If the game type is 'Doom' this is set to 'true' if the one level demo disc is being played
+bool                    gbIsPsxDoomForever;     // If the game type is 'Final Doom' this is set to 'true' if the 'PSX Doom Forever' ROM hack is being played
 
 // Level timer: start time
-static std::chrono::high_resolution_clock::time_point gLevelStartTime;
+static SIM_TLS std::chrono::high_resolution_clock::time_point gLevelStartTime;
 
 // Level timer: how many centiseconds (1/100 second units) were elapsed when the level was finished.
 // This value is only set once the end time is recorded.
-static int64_t gLevelFinishTimeCentisecs;
+static SIM_TLS int64_t gLevelFinishTimeCentisecs;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Helper: checks if a file on the game disc exists
@@ -2,6 +2,7 @@
 
 #include "GameConstants.h"
 #include "Macros.h"
+#include "Sim/SimTls.h"
 #include "SmallString.h"
 
 #include <cstdint>
@@ -76,12 +77,12 @@ struct String32;
 
 BEGIN_NAMESPACE(Game)
 
-extern GameType         gGameType;
-extern GameVariant      gGameVariant;
-extern GameSettings     gSettings;
-extern GameConstants    gConstants;
-extern bool             gbIsDemoVersion;
-extern bool             gbIsPsxDoomForever;
+extern GameType                 gGameType;
+extern GameVariant              gGameVariant;
+extern SIM_TLS GameSettings     gSettings;
+extern GameConstants            gConstants;
+extern bool                     gbIsDemoVersion;
+extern bool                     gbIsPsxDoomForever;
 
 void determineGameTypeAndVariant() noexcept;
 void getUserGameSettings(GameSettings& settings) noexcept;
@@ -4,17 +4,36 @@
 #include "Config/Config.h"
 #include "Doom/Game/p_tick.h"
 #include "FatalErrors.h"
+#include "InputLatencyProbe.h"
 #include "ProgArgs.h"
 #include "PsxVm.h"
 #include "Video.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <SDL.h>
 
 BEGIN_NAMESPACE(Input)
 
+typedef std::chrono::steady_clock::time_point timepoint_t;
+
+// How often 'pumpEvents' actually drains events from SDL: SDL event pumping is not free, and callers may be spinning
+static constexpr auto EVENT_PUMP_INTERVAL = std::chrono::milliseconds(1);
+
+// An event received from SDL and when it was received
+struct QueuedEvent {
+    timepoint_t     time;
+    SDL_Event       event;
+};
+
+// Events received from SDL but not yet applied to the input state.
+// Events are drained from SDL as often as possible, but only applied to the input state when 'update' is called before a tick.
+// Note: SDL requires events to be pumped on the thread which created the window, so this queue is only ever accessed by that thread.
+static std::vector<QueuedEvent>         gEventQueue;
+static timepoint_t                      gLastEventPumpTime;
+
 static bool                             gbIsQuitRequested;
 static const Uint8*                     gpKeyboardState;
 static int                              gNumKeyboardStateKeys;
@@ -49,6 +68,9 @@ static float gMouseMovementX;
 static float gMouseMovementY;
 static float gMouseWheelAxisMovements[NUM_MOUSE_WHEEL_AXES];
 
+// Whether the mouse movements this frame include an input latency probe event
+static bool gbMouseMovementHasProbe;
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Vector utility functions
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -214,13 +236,37 @@ static void updateJoystickHat(const JoyHat hat, const bool bPressed) noexcept {
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Handle events sent by SDL (keypresses and such)
+// Drain all events from SDL into the queue of events to be applied, timestamping them with the current time
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void pumpSdlEvents() noexcept {
+    const timepoint_t now = std::chrono::steady_clock::now();
+    gLastEventPumpTime = now;
+    SDL_PumpEvents();
+
+    QueuedEvent queuedEvent = {};
+    queuedEvent.time = now;
+
+    while (SDL_PeepEvents(&queuedEvent.event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT) > 0) {
+        const SDL_Event& sdlEvent = queuedEvent.event;
+
+        if ((sdlEvent.type == SDL_MOUSEMOTION) && (sdlEvent.motion.which == InputLatencyProbe::PROBE_MOUSE_ID)) {
+            InputLatencyProbe::onProbeQueued(now);
+        }
+
+        gEventQueue.push_back(queuedEvent);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Handle events sent by SDL (keypresses and such): applies all events received up until now to the input state
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void handleSdlEvents() noexcept {
-    SDL_Event sdlEvent;
+    pumpSdlEvents();
     bool bConsumeEvents = false;
 
-    while (SDL_PollEvent(&sdlEvent) != 0) {
+    for (const QueuedEvent& queuedEvent : gEventQueue) {
+        const SDL_Event& sdlEvent = queuedEvent.event;
+
         switch (sdlEvent.type) {
             case SDL_QUIT:
                 // The application is requesting to quit
@@ -314,6 +360,12 @@ static void handleSdlEvents() noexcept {
             } break;
 
             case SDL_MOUSEMOTION: {
+                // Input latency probe events contain no actual movement, just make a note that the current mouse movement includes one
+                if (sdlEvent.motion.which == InputLatencyProbe::PROBE_MOUSE_ID) {
+                    gbMouseMovementHasProbe = true;
+                    break;
+                }
+
                 // Only register movement if we have captured the mouse
                 if (SDL_GetRelativeMouseMode()) {
                     gMouseMovementX += (float) sdlEvent.motion.xrel;
@@ -461,6 +513,8 @@ static void handleSdlEvents() noexcept {
         }
     }
 
+    gEventQueue.clear();
+
     if (bConsumeEvents) {
         consumeEvents();
     }
@@ -477,6 +531,8 @@ void init() noexcept {
     SDL_GameControllerEventState(SDL_ENABLE);       // Want game controller events
 
     gbIsQuitRequested = false;
+    gEventQueue.reserve(256);
+    gLastEventPumpTime = {};
 
     gpKeyboardState = SDL_GetKeyboardState(&gNumKeyboardStateKeys);
     gKeyboardKeysJustPressed.reserve(32);
@@ -506,6 +562,7 @@ void init() noexcept {
 
     gMouseMovementX = 0.0f;
     gMouseMovementY = 0.0f;
+    gbMouseMovementHasProbe = false;
 
     rescanGameControllers();
 }
@@ -545,6 +602,7 @@ void shutdown() noexcept {
     emptyAndShrinkVector(gKeyboardKeysJustReleased);
     emptyAndShrinkVector(gKeyboardKeysJustPressed);
     emptyAndShrinkVector(gKeyboardKeysPressed);
+    emptyAndShrinkVector(gEventQueue);
 
     gpKeyboardState = nullptr;
     gbIsQuitRequested = false;
@@ -561,6 +619,20 @@ void update() noexcept {
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Receives new events from SDL without applying them to the input state yet, so they can be applied on the next call to 'update'.
+// Can be called at any time, including while game logic is running, and as frequently as desired.
+// Calling this frequently means events are timestamped more accurately, and are available sooner for 'getPendingMouseXMovement'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void pumpEvents() noexcept {
+    if (ProgArgs::gbHeadlessMode)
+        return;
+
+    if (std::chrono::steady_clock::now() - gLastEventPumpTime >= EVENT_PUMP_INTERVAL) {
+        pumpSdlEvents();
+    }
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Discards input events and movements.
 // Should be called whenever inputs have been processed for a frame.
@@ -605,6 +677,7 @@ void consumeTypedChars() noexcept {
 void consumeMouseMovements() noexcept {
     gMouseMovementX = 0;
     gMouseMovementY = 0;
+    gbMouseMovementHasProbe = false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -904,6 +977,12 @@ float getAdjustedJoystickAxisValue(const uint32_t axis, const float deadZone) no
 // Get the amount of mouse movement since events were last consumed (x-axis)
 //------------------------------------------------------------------------------------------------------------------------------------------
 float getMouseXMovement() noexcept {
+    // If the input latency probe is active then this is the point where its input is read by the game
+    if (gbMouseMovementHasProbe) {
+        InputLatencyProbe::onProbeLatched();
+        gbMouseMovementHasProbe = false;
+    }
+
     return gMouseMovementX;
 }
 
@@ -921,4 +1000,28 @@ float getMouseWheelAxisMovement(const uint8_t axis) noexcept {
     return (axis < 2) ? gMouseWheelAxisMovements[axis] : 0.0f;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Get the amount of mouse movement (x-axis) received from SDL via 'pumpEvents' but not yet applied to the input state.
+// Used to apply the very latest mouse movements to the view just before drawing, without affecting game logic.
+//------------------------------------------------------------------------------------------------------------------------------------------
+float getPendingMouseXMovement() noexcept {
+    float movement = 0.0f;
+    const bool bMouseCaptured = SDL_GetRelativeMouseMode();
+
+    for (const QueuedEvent& queuedEvent : gEventQueue) {
+        const SDL_Event& sdlEvent = queuedEvent.event;
+
+        if (sdlEvent.type != SDL_MOUSEMOTION)
+            continue;
+
+        if (sdlEvent.motion.which == InputLatencyProbe::PROBE_MOUSE_ID) {
+            InputLatencyProbe::onProbeLatched();
+        } else if (bMouseCaptured) {
+            movement += (float) sdlEvent.motion.xrel;
+        }
+    }
+
+    return movement;
+}
+
 END_NAMESPACE(Input)
@@ -64,6 +64,7 @@ struct JoystickAxis {
 void init() noexcept;
 void shutdown() noexcept;
 void update() noexcept;
+void pumpEvents() noexcept;
 void consumeEvents() noexcept;
 void consumeTypedChars() noexcept;
 void consumeMouseMovements() noexcept;
@@ -140,5 +141,6 @@ float getAdjustedJoystickAxisValue(const uint32_t axis, const float deadZone) no
 float getMouseXMovement() noexcept;
 float getMouseYMovement() noexcept;
 float getMouseWheelAxisMovement(const uint8_t axis) noexcept;
+float getPendingMouseXMovement() noexcept;
 
 END_NAMESPACE(Input)
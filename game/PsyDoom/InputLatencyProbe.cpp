@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Input latency probe: measures input-to-present latency by injecting synthetic input events.
+//
+// When enabled (via the '-inputlatency' program argument) a mouse motion event with no actual movement is periodically pushed onto the
+// SDL event queue, exactly as if it had come from the OS. The probe then follows the event through the input pipeline:
+//
+//  (1) Injected:   pushed onto the SDL event queue.
+//  (2) Queued:     drained from SDL into PsyDoom's timestamped input event queue.
+//  (3) Latched:    the mouse movement containing the event was read to determine the view angle for a frame.
+//  (4) Presented:  the frame using that view angle was handed over to the video backend for display.
+//
+// The time from injection to presentation is the latency recorded. Note that this does not include display scanout or any queueing done
+// by the graphics driver, so the true input-to-photon latency will be somewhat higher. Probes which are never latched (because the player
+// cannot turn at the time, for example) are discarded after a timeout.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "InputLatencyProbe.h"
+
+#include "ProgArgs.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <SDL.h>
+#include <vector>
+
+BEGIN_NAMESPACE(InputLatencyProbe)
+
+// The minimum time in between probes: a varying amount of extra time is added so probes don't phase lock with the frame rate
+static constexpr auto MIN_PROBE_INTERVAL = std::chrono::milliseconds(40);
+static constexpr uint32_t PROBE_INTERVAL_JITTER_MS = 23;
+
+// Probes that have not been presented after this amount of time are discarded
+static constexpr auto PROBE_TIMEOUT = std::chrono::milliseconds(500);
+
+// What stage the current probe is at
+enum class ProbeState : uint8_t {
+    Idle,
+    Injected,
+    Latched
+};
+
+static ProbeState           gProbeState;
+static timepoint_t          gProbeInjectTime;       // When the current probe was injected
+static timepoint_t          gProbeQueueTime;        // When the current probe was drained into PsyDoom's input event queue
+static timepoint_t          gNextProbeTime;         // When to inject the next probe
+static uint32_t             gProbeJitterSeed;       // Seed used to vary the interval between probes
+static uint32_t             gNumProbesDropped;      // Number of probes discarded due to not being latched or presented in time
+static std::vector<float>   gLatenciesMs;           // Injection to presentation latency for each probe
+static std::vector<float>   gQueueDelaysMs;         // Injection to queueing delay for each probe
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes the probe state, ready to start measuring latency
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init() noexcept {
+    gProbeState = ProbeState::Idle;
+    gProbeInjectTime = {};
+    gProbeQueueTime = {};
+    gNextProbeTime = std::chrono::steady_clock::now();
+    gProbeJitterSeed = 1;
+    gNumProbesDropped = 0;
+    gLatenciesMs.clear();
+    gQueueDelaysMs.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Shuts down the probe and prints the latency measured, if enabled via program arguments
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    if (ProgArgs::gbMeasureInputLatency) {
+        printStats();
+    }
+
+    gLatenciesMs.clear();
+    gLatenciesMs.shrink_to_fit();
+    gQueueDelaysMs.clear();
+    gQueueDelaysMs.shrink_to_fit();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Injects a new probe event if it is time to, or discards the current probe if it has timed out; should be called periodically
+//------------------------------------------------------------------------------------------------------------------------------------------
+void update() noexcept {
+    if (!ProgArgs::gbMeasureInputLatency)
+        return;
+
+    const timepoint_t now = std::chrono::steady_clock::now();
+
+    if (gProbeState != ProbeState::Idle) {
+        if (now - gProbeInjectTime >= PROBE_TIMEOUT) {
+            gProbeState = ProbeState::Idle;
+            gNumProbesDropped++;
+        }
+
+        return;
+    }
+
+    if (now < gNextProbeTime)
+        return;
+
+    // Push a mouse motion event with no movement, identified by its mouse id
+    SDL_Event sdlEvent = {};
+    sdlEvent.type = SDL_MOUSEMOTION;
+    sdlEvent.motion.timestamp = SDL_GetTicks();
+    sdlEvent.motion.which = PROBE_MOUSE_ID;
+
+    if (SDL_PushEvent(&sdlEvent) != 1)
+        return;
+
+    gProbeState = ProbeState::Injected;
+    gProbeInjectTime = now;
+    gProbeQueueTime = now;
+
+    // Schedule the next probe with a little pseudo random jitter
+    gProbeJitterSeed = gProbeJitterSeed * 1103515245u + 12345u;
+    gNextProbeTime = now + MIN_PROBE_INTERVAL + std::chrono::milliseconds((gProbeJitterSeed >> 16) % PROBE_INTERVAL_JITTER_MS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Notifies the probe that the probe event has been drained from SDL into the input event queue at the given time
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onProbeQueued(const timepoint_t queueTime) noexcept {
+    if (gProbeState == ProbeState::Injected) {
+        gProbeQueueTime = queueTime;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Notifies the probe that mouse movement including the probe event has been used to determine the view angle for a frame
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onProbeLatched() noexcept {
+    if (gProbeState == ProbeState::Injected) {
+        gProbeState = ProbeState::Latched;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Notifies the probe that a frame has just been presented: records the latency for the probe event if the frame used it
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onFramePresented() noexcept {
+    if (gProbeState != ProbeState::Latched)
+        return;
+
+    const timepoint_t now = std::chrono::steady_clock::now();
+    gLatenciesMs.push_back(std::chrono::duration<float, std::milli>(now - gProbeInjectTime).count());
+    gQueueDelaysMs.push_back(std::chrono::duration<float, std::milli>(gProbeQueueTime - gProbeInjectTime).count());
+    gProbeState = ProbeState::Idle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints a summary of the latencies measured so far to standard out
+//------------------------------------------------------------------------------------------------------------------------------------------
+void printStats() noexcept {
+    const size_t numSamples = gLatenciesMs.size();
+
+    if (numSamples == 0) {
+        std::printf("PsyDoom: input latency: no samples (%u probes dropped), turn with the mouse in game to measure.\n", gNumProbesDropped);
+        return;
+    }
+
+    std::vector<float> sortedLatencies = gLatenciesMs;
+    std::sort(sortedLatencies.begin(), sortedLatencies.end());
+
+    const auto getPercentile = [&](const float percentile) noexcept {
+        const size_t idx = std::min((size_t)(percentile * (float)(numSamples - 1) + 0.5f), numSamples - 1);
+        return sortedLatencies[idx];
+    };
+
+    double latencySum = 0.0;
+    double queueDelaySum = 0.0;
+
+    for (size_t i = 0; i < numSamples; ++i) {
+        latencySum += gLatenciesMs[i];
+        queueDelaySum += gQueueDelaysMs[i];
+    }
+
+    std::printf(
+        "PsyDoom: input latency (%zu samples, %u dropped): avg %.2f MS, p50 %.2f MS, p95 %.2f MS, p99 %.2f MS, max %.2f MS, avg queue delay %.2f MS\n",
+        numSamples,
+        gNumProbesDropped,
+        latencySum / (double) numSamples,
+        getPercentile(0.50f),
+        getPercentile(0.95f),
+        getPercentile(0.99f),
+        sortedLatencies.back(),
+        queueDelaySum / (double) numSamples
+    );
+}
+
+END_NAMESPACE(InputLatencyProbe)
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <chrono>
+#include <cstdint>
+
+BEGIN_NAMESPACE(InputLatencyProbe)
+
+typedef std::chrono::steady_clock::time_point timepoint_t;
+
+// The SDL mouse id used for synthetic probe events (mouse motion events with no actual movement)
+static constexpr uint32_t PROBE_MOUSE_ID = 0x50524F42u;
+
+void init() noexcept;
+void shutdown() noexcept;
+void update() noexcept;
+void onProbeQueued(const timepoint_t queueTime) noexcept;
+void onProbeLatched() noexcept;
+void onFramePresented() noexcept;
+void printStats() noexcept;
+
+END_NAMESPACE(InputLatencyProbe)
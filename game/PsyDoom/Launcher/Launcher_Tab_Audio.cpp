@@ -11,6 +11,7 @@
 
 BEGIN_DISABLE_HEADER_WARNINGS
     #include <FL/Fl_Box.H>
+    #include <FL/Fl_Check_Button.H>
     #include <FL/Fl_Group.H>
 END_DISABLE_HEADER_WARNINGS
 
@@ -22,7 +23,7 @@ BEGIN_NAMESPACE(Launcher)
 static void makeSettingSection(const int x, const int y) noexcept {
     // Container frame
     new Fl_Box(FL_NO_BOX, x, y, 300, 30, "Audio settings");
-    new Fl_Box(FL_THIN_DOWN_BOX, x, y + 30, 300, 100, "");
+    new Fl_Box(FL_THIN_DOWN_BOX, x, y + 30, 300, 130, "");
 
     // Audio buffer size
     {
@@ -51,6 +52,13 @@ static void makeSettingSection(const int x, const int y) noexcept {
             pInput->deactivate();
         #endif
     }
+
+    // Run the sequencer on the audio thread
+    {
+        const auto pCheck = makeFl_Check_Button(x + 20, y + 110, 200, 30, "  Sequencer on audio thread");
+        bindConfigField<Config::gbSequencerOnAudioThread, Config::gbNeedSave_Audio>(*pCheck);
+        pCheck->tooltip(ConfigSerialization::gConfig_Audio.sequencerOnAudioThread.comment);
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -177,7 +177,7 @@ static void makeDigitalMoveAndTurnSection(const int secLx, const int secRx, cons
 // Make the 'In-game actions & modifiers' controls section
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void makeInGameActionsAndModifiersSection(const int secLx, const int secRx, const int secY) noexcept {
-    makeSectionTitleAndBox("In-game actions & modifiers", secLx, secRx, secY, secY + 300);
+    makeSectionTitleAndBox("In-game actions & modifiers", secLx, secRx, secY, secY + 330);
 
     auto& cfg = ConfigSerialization::gConfig_Controls;
     const char* const tooltip = nullptr;
@@ -193,13 +193,14 @@ static void makeInGameActionsAndModifiersSection(const int secLx, const int secR
     makeBindingField("Toggle autorun", cfg.toggle_autorun, tooltip, fieldLx, fieldRx, fieldY + 150);
     makeBindingField("Quick save", cfg.quicksave, tooltip, fieldLx, fieldRx, fieldY + 180);
     makeBindingField("Quick load", cfg.quickload, tooltip, fieldLx, fieldRx, fieldY + 210);
+    makeBindingField("Rewind", cfg.rewind, tooltip, fieldLx, fieldRx, fieldY + 240);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Make the 'Miscellaneous toggles' controls section
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void makeMiscellaneousTogglesSection(const int secLx, const int secRx, const int secY) noexcept {
-    makeSectionTitleAndBox("Miscellaneous toggles", secLx, secRx, secY, secY + 210);
+    makeSectionTitleAndBox("Miscellaneous toggles", secLx, secRx, secY, secY + 330);
 
     auto& cfg = ConfigSerialization::gConfig_Controls;
     const char* const tooltip = cfg.toggle_pause.comment;
@@ -212,6 +213,10 @@ static void makeMiscellaneousTogglesSection(const int secLx, const int secRx, co
     makeBindingField("Toggle renderer", cfg.toggle_renderer, tooltip, fieldLx, fieldRx, fieldY + 60);
     makeBindingField("Toggle uncapped FPS", cfg.toggle_uncappedFps, tooltip, fieldLx, fieldRx, fieldY + 90);
     makeBindingField("Toggle demo player", cfg.toggle_viewPlayer, tooltip, fieldLx, fieldRx, fieldY + 120);
+    makeBindingField("Demo fast forward", cfg.demo_toggleFastForward, tooltip, fieldLx, fieldRx, fieldY + 150);
+    makeBindingField("Demo seek backward", cfg.demo_seekBackward, tooltip, fieldLx, fieldRx, fieldY + 180);
+    makeBindingField("Demo seek forward", cfg.demo_seekForward, tooltip, fieldLx, fieldRx, fieldY + 210);
+    makeBindingField("Profiler capture", cfg.toggle_profilerCapture, tooltip, fieldLx, fieldRx, fieldY + 240);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -330,14 +335,14 @@ void populateControlsTab(Context& ctx) noexcept {
     makeAnalogMoveAndTurnSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 20);
     makeDigitalMoveAndTurnSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 280);
     makeInGameActionsAndModifiersSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 540);
-    makeMiscellaneousTogglesSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 860);
-    makeWeaponSwitchingSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 1090);
-    makeMenuAndUIControlsSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 1530);
-    makeAutomapControlsSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 1880);
-    makePSXCheatCodeButtonsSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 2170);
+    makeMiscellaneousTogglesSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 890);
+    makeWeaponSwitchingSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 1240);
+    makeMenuAndUIControlsSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 1680);
+    makeAutomapControlsSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 2030);
+    makePSXCheatCodeButtonsSection(tabRect.lx + 20, tabRect.rx - 30, tabRect.ty + 2320);
     
     // Add a small bit of padding at the end and finish up making the scroll view
-    new Fl_Box(tabRect.lx + 20, tabRect.ty + 2590, 100, 20);
+    new Fl_Box(tabRect.lx + 20, tabRect.ty + 2740, 100, 20);
     pScroll->end();
 }
 
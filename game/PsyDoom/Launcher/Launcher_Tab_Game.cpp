@@ -76,7 +76,7 @@ static void makeCountersSection(const int x, const int y) noexcept {
 static void makeMiscellaneousSection(const int x, const int y) noexcept {
     // Container frame
     new Fl_Box(FL_NO_BOX, x, y, 200, 30, "Miscellaneous");
-    new Fl_Box(FL_THIN_DOWN_BOX, x, y + 30, 200, 120, "");
+    new Fl_Box(FL_THIN_DOWN_BOX, x, y + 30, 200, 150, "");
 
     // View bob strength
     {
@@ -105,6 +105,17 @@ static void makeMiscellaneousSection(const int x, const int y) noexcept {
             pInput->deactivate();
         #endif
     }
+
+    // Rewind snapshot interval
+    {
+        const auto pLabel = new Fl_Box(FL_NO_BOX, x + 10, y + 110, 80, 26, "Rewind tics");
+        pLabel->align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE);
+        pLabel->tooltip(ConfigSerialization::gConfig_Game.rewindSnapshotInterval.comment);
+
+        const auto pInput = new Fl_Int_Input(x + 100, y + 110, 80, 26);
+        bindConfigField<Config::gRewindSnapshotInterval, Config::gbNeedSave_Game>(*pInput);
+        pInput->tooltip(pLabel->tooltip());
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A host RAM cache for LCD (sound sample) files, with a background thread that can read files ahead of when they are needed.
+//
+// Reading the LCD files for a map is the slowest part of loading its sound and music, so the game asks for the files of the next map
+// to be preloaded during the intermission. When the level is then loaded the upload to SPU RAM is just a copy from memory.
+// Files stay cached (up to a memory budget) so that revisiting a map or reloading it after dying does not read the disc again.
+// Cache entries are only ever added to and evicted on the game thread; the loader thread just fills in entries it was given.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "LcdCache.h"
+
+#include "Doom/cdmaptbl.h"
+#include "Finally.h"
+#include "ModMgr.h"
+#include "Profiler.h"
+#include "ProgArgs.h"
+#include "SmallString.h"
+#include "Wess/psxcd.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+BEGIN_NAMESPACE(LcdCache)
+
+// How many bytes of LCD file data to keep cached before evicting the least recently used files
+static constexpr size_t MAX_CACHED_BYTES = 64 * 1024 * 1024;
+
+// An LCD file which is either cached or being loaded in the background
+struct Entry {
+    CdFileId                fileId;
+    std::vector<uint8_t>    data;           // The entire contents of the file (once loaded)
+    uint64_t                lastUseNum;     // Used to find the least recently used file for eviction
+    bool                    bLoading;       // True while the background loader is still reading the file
+    bool                    bLoadFailed;    // True if the background loader could not read the file
+};
+
+static std::vector<std::unique_ptr<Entry>>  gEntries;               // All cached or loading files
+static std::vector<Entry*>                  gLoadQueue;             // Files the background loader has yet to read, in order
+static std::mutex                           gMutex;                 // Guards all of the cache state
+static std::condition_variable              gLoadQueueCondVar;      // Signalled when files are added to the load queue or on shutdown
+static std::condition_variable              gLoadDoneCondVar;       // Signalled when the background loader finishes with a file
+static std::thread                          gLoaderThread;
+static bool                                 gbShutdown;
+static uint64_t                             gNextUseNum;
+static Stats                                gStats;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the entire contents of the specified file and returns 'true' on success
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool readFile(const CdFileId fileId, std::vector<uint8_t>& data) noexcept {
+    PROFILE_ZONE("LcdCache_ReadFile");
+
+    PsxCd_File* const pOpenedFile = psxcd_open(fileId);
+
+    if (!pOpenedFile)
+        return false;
+
+    // Note: copy the file struct since 'psxcd_open' only returns a temporary
+    PsxCd_File file = *pOpenedFile;
+
+    auto closeFileOnExit = finally([&]() noexcept {
+        psxcd_close(file);
+    });
+
+    data.resize((size_t) file.size);
+    return (psxcd_read(data.data(), file.size, file) == file.size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Main loop for the background loader thread: reads queued files until shutdown
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void loaderThreadMain() noexcept {
+    PROFILE_THREAD_NAME("LcdLoader");
+
+    std::unique_lock<std::mutex> lock(gMutex);
+
+    while (true) {
+        gLoadQueueCondVar.wait(lock, []() noexcept { return (gbShutdown || (!gLoadQueue.empty())); });
+
+        if (gbShutdown)
+            break;
+
+        Entry& entry = *gLoadQueue.front();
+        gLoadQueue.erase(gLoadQueue.begin());
+
+        // Do the read without holding the lock so the game thread is not blocked while the file is read
+        const CdFileId fileId = entry.fileId;
+        std::vector<uint8_t> data;
+
+        lock.unlock();
+        const bool bReadOk = readFile(fileId, data);
+        lock.lock();
+
+        entry.data = std::move(data);
+        entry.bLoading = false;
+        entry.bLoadFailed = (!bReadOk);
+        gLoadDoneCondVar.notify_all();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Finds the cache entry for the specified file, or returns 'null' if not found. Expects the cache to be locked.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static Entry* findEntry(const CdFileId fileId) noexcept {
+    for (const std::unique_ptr<Entry>& pEntry : gEntries) {
+        if (pEntry->fileId == fileId)
+            return pEntry.get();
+    }
+
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Evicts the least recently used loaded files until the cache is within its memory budget. Expects the cache to be locked.
+// The specified entry (the one most recently requested) is never evicted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void evictOldEntries(const Entry* const pKeepEntry) noexcept {
+    while (true) {
+        size_t numCachedBytes = 0;
+        auto lruIter = gEntries.end();
+
+        for (auto iter = gEntries.begin(); iter != gEntries.end(); ++iter) {
+            const Entry& entry = **iter;
+            numCachedBytes += entry.data.size();
+
+            if ((&entry == pKeepEntry) || entry.bLoading)
+                continue;
+
+            if ((lruIter == gEntries.end()) || (entry.lastUseNum < (*lruIter)->lastUseNum)) {
+                lruIter = iter;
+            }
+        }
+
+        if ((numCachedBytes <= MAX_CACHED_BYTES) || (lruIter == gEntries.end()))
+            break;
+
+        gEntries.erase(lruIter);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts up the background loader thread
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init() noexcept {
+    // No sound is loaded in headless mode, so there is no need for the loader
+    if (ProgArgs::gbHeadlessMode)
+        return;
+
+    gbShutdown = false;
+    gLoaderThread = std::thread(loaderThreadMain);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Stops the background loader thread and frees all cached files
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        gbShutdown = true;
+    }
+
+    gLoadQueueCondVar.notify_all();
+
+    if (gLoaderThread.joinable()) {
+        gLoaderThread.join();
+    }
+
+    gLoadQueue.clear();
+    gEntries.clear();
+    gEntries.shrink_to_fit();
+    gbShutdown = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Requests that the specified LCD file be read into the cache in the background, if it is not already cached.
+// Files which do not exist are ignored.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void preload(const CdFileId fileId) noexcept {
+    if (!gLoaderThread.joinable())
+        return;
+
+    // Don't preload files which don't exist, since trying to open them is a fatal error
+    const bool bFileExists = (ModMgr::areOverridesAvailableForFile(fileId) || (CdMapTbl_GetEntry(fileId) != PsxCd_MapTblEntry{}));
+
+    if (!bFileExists)
+        return;
+
+    std::lock_guard<std::mutex> lock(gMutex);
+
+    if (findEntry(fileId))
+        return;
+
+    std::unique_ptr<Entry>& pEntry = gEntries.emplace_back(std::make_unique<Entry>());
+    pEntry->fileId = fileId;
+    pEntry->lastUseNum = gNextUseNum++;
+    pEntry->bLoading = true;
+    pEntry->bLoadFailed = false;
+
+    gLoadQueue.push_back(pEntry.get());
+    gLoadQueueCondVar.notify_one();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the entire contents of the specified LCD file, or 'null' if the file could not be read.
+// If the file is still being preloaded then this waits for it, and if it is not cached then the file is read synchronously.
+// The returned data is only valid until the next call to 'preload' or 'getFileData'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+const std::vector<uint8_t>* getFileData(const CdFileId fileId) noexcept {
+    std::unique_lock<std::mutex> lock(gMutex);
+    Entry* pEntry = findEntry(fileId);
+
+    if (pEntry) {
+        // If the file is queued but the loader has not got to it yet then don't wait, just read it ourselves
+        const auto queueIter = std::find(gLoadQueue.begin(), gLoadQueue.end(), pEntry);
+
+        if (queueIter != gLoadQueue.end()) {
+            gLoadQueue.erase(queueIter);
+            gStats.numMisses++;
+
+            lock.unlock();
+            const bool bReadOk = readFile(fileId, pEntry->data);
+            lock.lock();
+
+            pEntry->bLoading = false;
+            pEntry->bLoadFailed = (!bReadOk);
+        }
+        else if (pEntry->bLoading) {
+            gStats.numWaits++;
+            gLoadDoneCondVar.wait(lock, [=]() noexcept { return (!pEntry->bLoading); });
+        }
+        else {
+            gStats.numHits++;
+        }
+    } else {
+        // Not cached: read the file synchronously and add it to the cache
+        gStats.numMisses++;
+        std::vector<uint8_t> data;
+
+        lock.unlock();
+        const bool bReadOk = readFile(fileId, data);
+        lock.lock();
+
+        pEntry = gEntries.emplace_back(std::make_unique<Entry>()).get();
+        pEntry->fileId = fileId;
+        pEntry->data = std::move(data);
+        pEntry->bLoading = false;
+        pEntry->bLoadFailed = (!bReadOk);
+    }
+
+    // Don't keep files around that failed to load, so that loading is retried the next time
+    if (pEntry->bLoadFailed) {
+        gEntries.erase(std::find_if(gEntries.begin(), gEntries.end(), [=](const auto& pOther) noexcept { return (pOther.get() == pEntry); }));
+        return nullptr;
+    }
+
+    pEntry->lastUseNum = gNextUseNum++;
+    evictOldEntries(pEntry);
+    return &pEntry->data;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the running totals of how LCD file requests were served
+//------------------------------------------------------------------------------------------------------------------------------------------
+Stats getStats() noexcept {
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gStats;
+}
+
+END_NAMESPACE(LcdCache)
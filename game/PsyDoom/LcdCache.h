@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+#include <vector>
+
+struct String16;
+typedef String16 CdFileId;
+
+BEGIN_NAMESPACE(LcdCache)
+
+// Counts of LCD file requests which were served from host RAM versus requests that had to wait for the file to be read
+struct Stats {
+    uint32_t    numHits;        // The file was already in host RAM
+    uint32_t    numWaits;       // The file was still being read by the background loader
+    uint32_t    numMisses;      // The file had to be read synchronously
+};
+
+void init() noexcept;
+void shutdown() noexcept;
+void preload(const CdFileId fileId) noexcept;
+const std::vector<uint8_t>* getFileData(const CdFileId fileId) noexcept;
+Stats getStats() noexcept;
+
+END_NAMESPACE(LcdCache)
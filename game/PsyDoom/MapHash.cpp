@@ -10,12 +10,12 @@
 
 BEGIN_NAMESPACE(MapHash)
 
-int32_t     gDataSize;      // Size of the map data being hashed
-uint64_t    gWord1;         // Computed hash (bytes 0-7)
-uint64_t    gWord2;         // Computed hash (bytes 8-15)
+SIM_TLS int32_t     gDataSize;      // Size of the map data being hashed
+SIM_TLS uint64_t    gWord1;         // Computed hash (bytes 0-7)
+SIM_TLS uint64_t    gWord2;         // Computed hash (bytes 8-15)
 
 // This holds the state of the MD5 hasher and allows us to retrieve the current hash
-static MD5 gMD5Hasher;
+static SIM_TLS MD5 gMD5Hasher;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Clears the map hash; should be called at the start of level loading
@@ -1,15 +1,16 @@
 #pragma once
 
 #include "Macros.h"
+#include "Sim/SimTls.h"
 
 #include <cstddef>
 #include <cstdint>
 
 BEGIN_NAMESPACE(MapHash)
 
-extern int32_t      gDataSize;
-extern uint64_t     gWord1;
-extern uint64_t     gWord2;
+extern SIM_TLS int32_t      gDataSize;
+extern SIM_TLS uint64_t     gWord1;
+extern SIM_TLS uint64_t     gWord2;
 
 void clear() noexcept;
 void addData(const void* const pData, const int32_t dataSize) noexcept;
@@ -16,6 +16,7 @@
 #include "MapInfo_Defaults.h"
 #include "MapInfo_Parse.h"
 #include "PsyDoom/Game.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "PsyQ/LIBSPU.h"
 
 #include <algorithm>
@@ -25,16 +26,16 @@
 BEGIN_NAMESPACE(MapInfo)
 
 // All of the main MAPINFO data structures
-static std::vector<MusicTrack>  gMusicTracks;
-static GameInfo                 gGameInfo;
-static std::vector<Episode>     gEpisodes;
-static std::vector<Cluster>     gClusters;
-static std::vector<Map>         gMaps;
+static SIM_TLS std::vector<MusicTrack>  gMusicTracks;
+static SIM_TLS GameInfo                 gGameInfo;
+static SIM_TLS std::vector<Episode>     gEpisodes;
+static SIM_TLS std::vector<Cluster>     gClusters;
+static SIM_TLS std::vector<Map>         gMaps;
 
 // Used to speed up repeated searches for the same 'Map' data structure.
 // Cache which map was queried and where it is in the maps array, so we can do O(1) lookup for repeat queries.
-static int32_t  gLastGetMap         = -1;
-static int32_t  gLastGetMapIndex    = -1;
+static SIM_TLS int32_t  gLastGetMap         = -1;
+static SIM_TLS int32_t  gLastGetMapIndex    = -1;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Initializes a cluster with default settings
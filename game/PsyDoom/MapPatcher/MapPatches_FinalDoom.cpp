@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------------------------------------------------------------------
 #include "MapPatches.h"
 
+#include "Doom/Game/p_blockthings.h"
 #include "Doom/Renderer/r_data.h"
 
 BEGIN_NAMESPACE(MapPatches)
@@ -86,6 +87,8 @@ static void patchMap_Ballistyx() noexcept {
                 } else if ((sectorIdx == 150) || (sectorIdx == 163) || (sectorIdx == 164)) {
                     mobj.y += 24 * FRACUNIT;
                 }
+
+                P_BlockThingsMobjMoved(mobj);   // Moved without being relinked in the blockmap
             }
         );
     }
@@ -8,6 +8,7 @@
 #include "IsoFileSys.h"
 #include "ProgArgs.h"
 #include "PsxVm.h"
+#include "Sim/SimTls.h"
 #include "WadList.h"
 
 #include <algorithm>
@@ -44,7 +45,7 @@ static std::unordered_set<CdFileId> gOverridenFileNames;
 
 // A list of currently open files.
 // Only a certain amount are allowed at a time:
-static std::FILE* gOpenFileSlots[MAX_OPEN_FILES] = {};
+static SIM_TLS std::FILE* gOpenFileSlots[MAX_OPEN_FILES] = {};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Get the path to a file in the data dir.
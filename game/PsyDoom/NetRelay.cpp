@@ -0,0 +1,960 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A headless relay server which fans out a game streamed to it by one of the players (the 'tap') to any number of spectators.
+// The relay does not run the game itself: it just forwards the stream and keeps enough of it to get late joining spectators started.
+// For late joiners it keeps the demo header for the current map, the latest snapshot of the game state and all ticks since then.
+//
+// All network IO is asynchronous and each spectator has a bounded queue of data waiting to be sent to it: data is shared between all the
+// spectators it is going to rather than being copied for each one. Spectators which can't keep up with the stream are dropped.
+//
+// Also contains a load test for the relay, which connects many dummy spectators to it and reports on the data they receive.
+// If no real game is being streamed, the load test also streams a synthetic game to the relay itself, so it can be run end to end.
+// For more details on the protocol used see 'NetRelayProtocol.h'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "NetRelay.h"
+
+#include "DemoCommon.h"
+#include "NetRelayProtocol.h"
+#include "ProgArgs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+
+// This prevents warnings in ASIO about the Windows SDK target version not being specified
+#if _WIN32
+    #include <sdkddkver.h>
+#endif
+
+BEGIN_DISABLE_HEADER_WARNINGS
+    #include <asio.hpp>
+END_DISABLE_HEADER_WARNINGS
+
+using namespace NetRelayProtocol;
+
+BEGIN_NAMESPACE(NetRelay)
+
+// Size of the chunks in which data is received from clients
+static constexpr size_t RECV_CHUNK_SIZE = 16 * 1024;
+
+// The most data that can be queued for a spectator before it is dropped for not keeping up with the stream.
+// Note: the data sent to a spectator upon joining is tracked separately and does not count towards this limit, since it may include a
+// large snapshot. Only the stream data queued behind it does.
+static constexpr size_t MAX_CLIENT_SEND_QUEUE = 4 * 1024 * 1024;
+
+// How often to print relay or load test stats
+static constexpr std::chrono::seconds RELAY_STATS_PERIOD = std::chrono::seconds(10);
+
+// How long to process network events for before checking whether to stop or print stats
+static constexpr std::chrono::milliseconds UPDATE_INTERVAL = std::chrono::milliseconds(100);
+
+// Load test: the synthetic game streamed to the relay. It runs at the game's tick rate and sends snapshots and state hashes as often as
+// 'DemoRecorder' does. Snapshots are as big as the spectator send queue limit: the worst case for spectators joining part way through.
+static constexpr uint32_t LOAD_TEST_TICKS_PER_SEC = 30;
+static constexpr uint32_t LOAD_TEST_SNAPSHOT_INTERVAL = 300;
+static constexpr uint32_t LOAD_TEST_STATE_HASH_INTERVAL = 30;
+static constexpr uint32_t LOAD_TEST_SNAPSHOT_SIZE = 4 * 1024 * 1024;
+
+typedef std::chrono::steady_clock relayclock_t;
+typedef std::shared_ptr<const std::vector<std::byte>> SharedMsg;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A message waiting to be sent to a client
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct QueuedMsg {
+    SharedMsg   pMsg;
+    bool        bIsJoinData;        // Is the message part of the data sent upon joining? If so then it's exempt from the queue size limit
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A client connected to the relay
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct Client {
+    asio::ip::tcp::socket   socket;
+    uint32_t                id;                     // Used to identify the client when logging
+    bool                    bIdentified;            // Has the client sent its hello yet?
+    bool                    bClosed;                // Has the connection to the client been closed?
+    ClientRole              role;                   // What the client is, once identified
+    std::vector<std::byte>  recvBuffer;             // Data received which has not been processed yet
+    std::byte               recvChunk[RECV_CHUNK_SIZE];
+    std::deque<QueuedMsg>   sendQueue;              // Messages waiting to be sent to the client
+    size_t                  sendQueueSize;          // Total size of the messages waiting to be sent, excluding join data
+    size_t                  joinQueueSize;          // Total size of the join data waiting to be sent
+    size_t                  numMsgsSending;         // How many messages at the front of the send queue are being sent by the current async write
+
+    Client(asio::io_context& ioContext) noexcept
+        : socket(ioContext)
+        , id(0)
+        , bIdentified(false)
+        , bClosed(false)
+        , role(ClientRole::Spectator)
+        , recvBuffer()
+        , recvChunk()
+        , sendQueue()
+        , sendQueueSize(0)
+        , joinQueueSize(0)
+        , numMsgsSending(0)
+    {
+    }
+};
+
+typedef std::shared_ptr<Client> ClientPtr;
+
+static std::unique_ptr<asio::io_context>        gpIoContext;
+static std::unique_ptr<asio::signal_set>        gpSignals;          // Used to stop gracefully on Ctrl+C etc.
+static std::unique_ptr<asio::ip::tcp::acceptor> gpAcceptor;
+static bool                                     gbStopRequested;
+static uint32_t                                 gNextClientId;
+static ClientPtr                                gpTap;              // The client streaming the game to the relay (if any)
+static std::vector<ClientPtr>                   gSpectators;
+
+// The state of the map being streamed, for spectators joining part way through it
+static bool                     gbMapActive;            // Is a map being streamed currently?
+static SharedMsg                gpMapBeginMsg;          // The message which began the map (contains the demo header)
+static SharedMsg                gpSnapshotMsg;          // The latest snapshot of the game state received from the tap (null if none)
+static std::vector<std::byte>   gTicksSinceSnapshot;    // All the tick inputs received since the latest snapshot (or map start)
+static SharedMsg                gpStateHashMsg;         // The latest game state hash received since the latest snapshot (null if none)
+
+// Stats for the current reporting period
+static relayclock_t::time_point     gStatsPeriodStartTime;
+static uint64_t                     gStatsBytesSent;
+static uint64_t                     gStatsBytesReceived;
+static uint32_t                     gStatsNumMsgsRelayed;
+static uint32_t                     gStatsNumJoins;
+static uint32_t                     gStatsNumLeaves;
+static uint32_t                     gStatsNumDropped;
+static size_t                       gStatsMaxSendQueueSize;
+
+static void startSend(const ClientPtr& pClient) noexcept;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Creates a message which can be shared between all the clients it is being sent to
+//------------------------------------------------------------------------------------------------------------------------------------------
+static SharedMsg makeSharedMsg(const MsgType type, const void* const pData, const uint32_t size) noexcept {
+    std::shared_ptr<std::vector<std::byte>> pMsg = std::make_shared<std::vector<std::byte>>();
+    pMsg->reserve(sizeof(MsgHeader) + size);
+    appendMessage(*pMsg, type, pData, size);
+    return pMsg;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Stats handling
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void resetStats() noexcept {
+    gStatsPeriodStartTime = relayclock_t::now();
+    gStatsBytesSent = 0;
+    gStatsBytesReceived = 0;
+    gStatsNumMsgsRelayed = 0;
+    gStatsNumJoins = 0;
+    gStatsNumLeaves = 0;
+    gStatsNumDropped = 0;
+    gStatsMaxSendQueueSize = 0;
+}
+
+static void printAndResetStats() noexcept {
+    const double periodSecs = std::chrono::duration<double>(relayclock_t::now() - gStatsPeriodStartTime).count();
+    const double toKiBPerSec = (periodSecs > 0) ? 1.0 / (1024.0 * periodSecs) : 0.0;
+
+    std::printf(
+        "Relay: %u spectators (%u joined, %u left, %u dropped), tap %s, %u msgs relayed, in %.1f KiB/s, out %.1f KiB/s, max queue %.1f KiB\n",
+        (uint32_t) gSpectators.size(),
+        gStatsNumJoins,
+        gStatsNumLeaves,
+        gStatsNumDropped,
+        (gpTap) ? "connected" : "not connected",
+        gStatsNumMsgsRelayed,
+        (double) gStatsBytesReceived * toKiBPerSec,
+        (double) gStatsBytesSent * toKiBPerSec,
+        (double) gStatsMaxSendQueueSize / 1024.0
+    );
+
+    resetStats();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Queues a message to be sent to the given spectator.
+// Join data is exempt from the queue size limit. For anything else, if the spectator is too far behind in receiving data then it is
+// dropped instead.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void closeClient(Client& client, const char* const reason) noexcept;
+
+static void queueSend(const ClientPtr& pClient, const SharedMsg& pMsg, const bool bIsJoinData) noexcept {
+    Client& client = *pClient;
+
+    if (client.bClosed)
+        return;
+
+    if (bIsJoinData) {
+        client.joinQueueSize += pMsg->size();
+    }
+    else {
+        if (client.sendQueueSize + pMsg->size() > MAX_CLIENT_SEND_QUEUE) {
+            gStatsNumDropped++;
+            closeClient(client, "dropped for not keeping up with the stream");
+            return;
+        }
+
+        client.sendQueueSize += pMsg->size();
+        gStatsMaxSendQueueSize = std::max(gStatsMaxSendQueueSize, client.sendQueueSize);
+    }
+
+    client.sendQueue.push_back({ pMsg, bIsJoinData });
+    startSend(pClient);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends a message to all spectators
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void broadcast(const SharedMsg& pMsg) noexcept {
+    for (const ClientPtr& pSpectator : gSpectators) {
+        queueSend(pSpectator, pMsg, false);
+    }
+
+    gStatsNumMsgsRelayed++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Ends the map being streamed (if any) and lets spectators know
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void endMap() noexcept {
+    if (!gbMapActive)
+        return;
+
+    broadcast(makeSharedMsg(MsgType::MapEnd, nullptr, 0));
+    gbMapActive = false;
+    gpMapBeginMsg.reset();
+    gpSnapshotMsg.reset();
+    gTicksSinceSnapshot.clear();
+    gpStateHashMsg.reset();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Closes the connection to a client and reports why
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void closeClient(Client& client, const char* const reason) noexcept {
+    if (client.bClosed)
+        return;
+
+    client.bClosed = true;
+    client.sendQueue.clear();
+    client.sendQueueSize = 0;
+    client.joinQueueSize = 0;
+
+    asio::error_code error;
+    client.socket.close(error);
+
+    if (gpTap.get() == &client) {
+        std::printf("Relay: tap (client %u) %s\n", client.id, reason);
+        gpTap.reset();
+        endMap();
+    }
+    else if (client.bIdentified && (client.role == ClientRole::Spectator)) {
+        gStatsNumLeaves++;
+    }
+    else {
+        std::printf("Relay: client %u %s\n", client.id, reason);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts sending everything queued for a spectator in one go, if not already sending
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startSend(const ClientPtr& pClient) noexcept {
+    Client& client = *pClient;
+
+    if (client.bClosed || (client.numMsgsSending > 0) || client.sendQueue.empty())
+        return;
+
+    std::vector<asio::const_buffer> buffers;
+    buffers.reserve(client.sendQueue.size());
+
+    for (const QueuedMsg& queuedMsg : client.sendQueue) {
+        buffers.push_back(asio::buffer(*queuedMsg.pMsg));
+    }
+
+    client.numMsgsSending = client.sendQueue.size();
+
+    asio::async_write(
+        client.socket,
+        buffers,
+        [pClient](const asio::error_code& error, const std::size_t numBytes) noexcept {
+            Client& client = *pClient;
+
+            if (client.bClosed)
+                return;
+
+            if (error) {
+                closeClient(client, "disconnected");
+                return;
+            }
+
+            gStatsBytesSent += numBytes;
+
+            for (size_t i = 0; i < client.numMsgsSending; ++i) {
+                const QueuedMsg& sentMsg = client.sendQueue.front();
+                size_t& queueSize = (sentMsg.bIsJoinData) ? client.joinQueueSize : client.sendQueueSize;
+                queueSize -= sentMsg.pMsg->size();
+                client.sendQueue.pop_front();
+            }
+
+            client.numMsgsSending = 0;
+            startSend(pClient);
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends a newly joined spectator what it needs to start watching the map currently being streamed (if any)
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendJoinState(const ClientPtr& pSpectator) noexcept {
+    if (!gbMapActive)
+        return;
+
+    queueSend(pSpectator, gpMapBeginMsg, true);
+
+    if (gpSnapshotMsg) {
+        queueSend(pSpectator, gpSnapshotMsg, true);
+    }
+
+    // Note: always send the backlog even if empty, so the spectator knows it has everything it needs to start
+    const SharedMsg pBacklogMsg = makeSharedMsg(MsgType::BacklogTicks, gTicksSinceSnapshot.data(), (uint32_t) gTicksSinceSnapshot.size());
+    queueSend(pSpectator, pBacklogMsg, true);
+
+    // Also send the latest state hash so the spectator can verify its game state once it has caught up with the backlog
+    if (gpStateHashMsg) {
+        queueSend(pSpectator, gpStateHashMsg, true);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Handles a message received from the tap; returns 'false' if the message is invalid
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool onTapMessage(const MsgType type, const std::byte* const pData, const uint32_t size) noexcept {
+    switch (type) {
+        case MsgType::MapBegin:
+            endMap();
+            gbMapActive = true;
+            gpMapBeginMsg = makeSharedMsg(type, pData, size);
+            broadcast(gpMapBeginMsg);
+            return true;
+
+        case MsgType::Ticks:
+            if (gbMapActive) {
+                gTicksSinceSnapshot.insert(gTicksSinceSnapshot.end(), pData, pData + size);
+                broadcast(makeSharedMsg(type, pData, size));
+            }
+            return true;
+
+        // Snapshots are only for spectators joining later on, existing spectators don't need them
+        case MsgType::Snapshot:
+            if (gbMapActive) {
+                gpSnapshotMsg = makeSharedMsg(type, pData, size);
+                gTicksSinceSnapshot.clear();
+                gpStateHashMsg.reset();
+            }
+            return true;
+
+        case MsgType::StateHash:
+            if (size != sizeof(StateHashMsg))
+                return false;
+
+            if (gbMapActive) {
+                gpStateHashMsg = makeSharedMsg(type, pData, size);
+                broadcast(gpStateHashMsg);
+            }
+            return true;
+
+        case MsgType::MapEnd:
+            endMap();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Handles the hello received from a newly connected client.
+// Returns 'false' if the client was rejected and disconnected.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool onClientHello(const ClientPtr& pClient, Hello hello) noexcept {
+    Client& client = *pClient;
+
+    if constexpr (Endian::isBig()) {
+        hello.byteSwap();
+    }
+
+    const bool bValidHello = (
+        (hello.helloId == HELLO_ID) &&
+        (hello.protocolVersion == PROTOCOL_VERSION) &&
+        (hello.demoFileVersion == DemoCommon::DEMO_FILE_VERSION) &&
+        ((hello.role == ClientRole::Tap) || (hello.role == ClientRole::Spectator))
+    );
+
+    if (!bValidHello) {
+        closeClient(client, "rejected: bad hello or mismatched game version");
+        return false;
+    }
+
+    if ((hello.role == ClientRole::Tap) && gpTap) {
+        closeClient(client, "rejected: there is already a tap connected");
+        return false;
+    }
+
+    client.bIdentified = true;
+    client.role = hello.role;
+
+    if (hello.role == ClientRole::Tap) {
+        gpTap = pClient;
+        std::printf("Relay: tap connected (client %u)\n", client.id);
+    } else {
+        gSpectators.push_back(pClient);
+        gStatsNumJoins++;
+        sendJoinState(pClient);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Handles data received from a client; returns 'false' if the client was disconnected
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool onClientDataReceived(const ClientPtr& pClient, const size_t numBytes) noexcept {
+    Client& client = *pClient;
+    gStatsBytesReceived += numBytes;
+
+    // Spectators have nothing else to say after the hello: ignore anything else they send
+    if (client.bIdentified && (client.role == ClientRole::Spectator))
+        return true;
+
+    client.recvBuffer.insert(client.recvBuffer.end(), client.recvChunk, client.recvChunk + numBytes);
+
+    if (!client.bIdentified) {
+        if (client.recvBuffer.size() < sizeof(Hello))
+            return true;
+
+        Hello hello;
+        std::memcpy(&hello, client.recvBuffer.data(), sizeof(Hello));
+        client.recvBuffer.erase(client.recvBuffer.begin(), client.recvBuffer.begin() + sizeof(Hello));
+
+        if (!onClientHello(pClient, hello))
+            return false;
+
+        if (client.role == ClientRole::Spectator) {
+            client.recvBuffer.clear();
+            return true;
+        }
+    }
+
+    if (!consumeMessages(client.recvBuffer, onTapMessage)) {
+        closeClient(client, "sent bad data");
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts receiving the next chunk of data from a client
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startReceive(const ClientPtr& pClient) noexcept {
+    pClient->socket.async_read_some(
+        asio::buffer(pClient->recvChunk, RECV_CHUNK_SIZE),
+        [pClient](const asio::error_code& error, const std::size_t numBytes) noexcept {
+            if (pClient->bClosed)
+                return;
+
+            if (error) {
+                closeClient(*pClient, "disconnected");
+                return;
+            }
+
+            if (onClientDataReceived(pClient, numBytes)) {
+                startReceive(pClient);
+            }
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts waiting for the next client to connect
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startAccept() noexcept {
+    const ClientPtr pClient = std::make_shared<Client>(*gpIoContext);
+
+    gpAcceptor->async_accept(
+        pClient->socket,
+        [pClient](const asio::error_code& error) noexcept {
+            if (!error) {
+                asio::error_code optionError;
+                pClient->socket.set_option(asio::ip::tcp::no_delay(true), optionError);
+                pClient->id = ++gNextClientId;
+                startReceive(pClient);
+            }
+
+            if (gpAcceptor && gpAcceptor->is_open()) {
+                startAccept();
+            }
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sets up the io context and a handler to request stopping upon Ctrl+C and so on
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void initIoContext() THROWS {
+    gbStopRequested = false;
+    gpIoContext.reset(new asio::io_context());
+    gpSignals.reset(new asio::signal_set(*gpIoContext, SIGINT, SIGTERM));
+
+    gpSignals->async_wait(
+        [](const asio::error_code& error, [[maybe_unused]] const int signalNum) noexcept {
+            if (!error) {
+                gbStopRequested = true;
+            }
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Processes network events until stopping is requested, printing stats periodically
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class UpdateFunc, class PrintStatsFunc>
+static void runUntilStopped(const UpdateFunc& update, const PrintStatsFunc& printStats) noexcept {
+    while (!gbStopRequested) {
+        try {
+            gpIoContext->restart();
+            gpIoContext->run_for(UPDATE_INTERVAL);
+        }
+        catch (...) {
+            // Shouldn't happen, but ignore and keep going if it does...
+        }
+
+        update();
+
+        if (relayclock_t::now() - gStatsPeriodStartTime >= RELAY_STATS_PERIOD) {
+            printStats();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Cleans up all relay or load test state
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void shutdown() noexcept {
+    for (const ClientPtr& pSpectator : gSpectators) {
+        closeClient(*pSpectator, "disconnected: relay shutting down");
+    }
+
+    if (gpTap) {
+        closeClient(*gpTap, "disconnected: relay shutting down");
+    }
+
+    gSpectators.clear();
+    gpAcceptor.reset();
+    gpSignals.reset();
+    gpIoContext.reset();
+    gbMapActive = false;
+    gpMapBeginMsg.reset();
+    gpSnapshotMsg.reset();
+    gTicksSinceSnapshot.clear();
+    gTicksSinceSnapshot.shrink_to_fit();
+    gpStateHashMsg.reset();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Runs the relay server until it is stopped via Ctrl+C or similar.
+// Returns the exit code for the application.
+//------------------------------------------------------------------------------------------------------------------------------------------
+int runServer() noexcept {
+    try {
+        initIoContext();
+        gpAcceptor.reset(new asio::ip::tcp::acceptor(*gpIoContext, asio::ip::tcp::endpoint(asio::ip::tcp::v6(), ProgArgs::gRelayPort)));
+    }
+    catch (...) {
+        std::printf("Relay: failed to listen for connections on port %u!\n", (unsigned) ProgArgs::gRelayPort);
+        shutdown();
+        return 1;
+    }
+
+    std::printf("Relay: listening for connections on port %u (Ctrl+C to stop)\n", (unsigned) ProgArgs::gRelayPort);
+    startAccept();
+    resetStats();
+
+    runUntilStopped(
+        []() noexcept {
+            // Forget about spectators which have disconnected or have been dropped
+            gSpectators.erase(
+                std::remove_if(gSpectators.begin(), gSpectators.end(), [](const ClientPtr& pSpectator) noexcept { return pSpectator->bClosed; }),
+                gSpectators.end()
+            );
+        },
+        []() noexcept {
+            // Always print stats while the relay is in use, otherwise only if requested
+            if (ProgArgs::gbPrintNetStats || gpTap || (!gSpectators.empty()) || (gStatsNumLeaves > 0)) {
+                printAndResetStats();
+            } else {
+                resetStats();
+            }
+        }
+    );
+
+    std::printf("Relay: shutting down\n");
+    shutdown();
+    return 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: a dummy spectator which consumes the stream from the relay
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct LoadTestClient {
+    asio::ip::tcp::socket   socket;
+    bool                    bConnected;
+    std::vector<std::byte>  recvBuffer;
+    std::byte               recvChunk[RECV_CHUNK_SIZE];
+
+    LoadTestClient(asio::io_context& ioContext) noexcept
+        : socket(ioContext)
+        , bConnected(false)
+        , recvBuffer()
+        , recvChunk()
+    {
+    }
+};
+
+typedef std::shared_ptr<LoadTestClient> LoadTestClientPtr;
+
+// Load test state and stats: the stats (apart from client counts) are for the current reporting period
+static asio::ip::tcp::resolver::results_type    gLoadTestEndpoints;
+static std::vector<LoadTestClientPtr>           gLoadTestClients;
+static uint32_t                                 gLoadTestNumConnected;
+static uint32_t                                 gLoadTestNumDisconnected;
+static uint32_t                                 gLoadTestNumFailed;
+static uint32_t                                 gLoadTestNumMapsBegun;
+static uint32_t                                 gLoadTestNumSnapshots;
+static uint64_t                                 gLoadTestNumTicks;
+
+// Load test: the synthetic game being streamed to the relay (if the relay accepted it as the tap)
+static LoadTestClientPtr                gpLoadTestTap;
+static bool                             gbLoadTestTapStreaming;     // Set once the tap connection is made and the synthetic map has begun
+static bool                             gbLoadTestTapSending;       // Is an async write to the relay in progress?
+static std::vector<std::byte>           gLoadTestTapSendBuffer;     // Data being written to the relay by the current async write
+static std::vector<std::byte>           gLoadTestTapPending;        // Data waiting for the current async write to finish
+static relayclock_t::time_point         gLoadTestTapStartTime;
+static uint32_t                         gLoadTestTapNumTicks;       // Number of synthetic ticks streamed so far
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: handles a message received by a dummy spectator
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool onLoadTestMessage(const MsgType type, const std::byte* const pData, const uint32_t size) noexcept {
+    if (type == MsgType::MapBegin) {
+        gLoadTestNumMapsBegun++;
+    }
+    else if (type == MsgType::Snapshot) {
+        gLoadTestNumSnapshots++;
+    }
+    else if ((type == MsgType::Ticks) || (type == MsgType::BacklogTicks)) {
+        for (size_t offset = 0; offset < size; offset += DemoCommon::getEncodedTickSize((uint8_t) pData[offset])) {
+            gLoadTestNumTicks++;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: a dummy spectator lost its connection, or failed to connect
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void onLoadTestClientClosed(LoadTestClient& client) noexcept {
+    if (client.bConnected) {
+        client.bConnected = false;
+        gLoadTestNumConnected--;
+        gLoadTestNumDisconnected++;
+    } else {
+        gLoadTestNumFailed++;
+    }
+
+    asio::error_code error;
+    client.socket.close(error);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: starts receiving the next chunk of data for a dummy spectator
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startLoadTestReceive(const LoadTestClientPtr& pClient) noexcept {
+    pClient->socket.async_read_some(
+        asio::buffer(pClient->recvChunk, RECV_CHUNK_SIZE),
+        [pClient](const asio::error_code& error, const std::size_t numBytes) noexcept {
+            LoadTestClient& client = *pClient;
+
+            if (error) {
+                onLoadTestClientClosed(client);
+                return;
+            }
+
+            gStatsBytesReceived += numBytes;
+            client.recvBuffer.insert(client.recvBuffer.end(), client.recvChunk, client.recvChunk + numBytes);
+
+            if (!consumeMessages(client.recvBuffer, onLoadTestMessage)) {
+                std::printf("Relay load test: received bad data from the relay!\n");
+                onLoadTestClientClosed(client);
+                return;
+            }
+
+            startLoadTestReceive(pClient);
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: prints stats for the current period and begins a new one
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void printAndResetLoadTestStats() noexcept {
+    const double periodSecs = std::chrono::duration<double>(relayclock_t::now() - gStatsPeriodStartTime).count();
+    const double ticksPerClientSec = ((periodSecs > 0) && (gLoadTestNumConnected > 0)) ?
+        (double) gLoadTestNumTicks / ((double) gLoadTestNumConnected * periodSecs) : 0.0;
+
+    std::printf(
+        "Relay load test: %u/%u connected (%u disconnected, %u failed), in %.1f KiB/s, %.1f ticks/s per client, %u maps begun, %u snapshots\n",
+        gLoadTestNumConnected,
+        (uint32_t) gLoadTestClients.size(),
+        gLoadTestNumDisconnected,
+        gLoadTestNumFailed,
+        (periodSecs > 0) ? (double) gStatsBytesReceived / (1024.0 * periodSecs) : 0.0,
+        ticksPerClientSec,
+        gLoadTestNumMapsBegun,
+        gLoadTestNumSnapshots
+    );
+
+    gLoadTestNumTicks = 0;
+    gLoadTestNumMapsBegun = 0;
+    gLoadTestNumSnapshots = 0;
+    resetStats();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: writes everything queued for the relay by the synthetic tap in one go, if not already writing
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startLoadTestTapSend() noexcept {
+    if ((!gpLoadTestTap) || gbLoadTestTapSending || gLoadTestTapPending.empty())
+        return;
+
+    gLoadTestTapSendBuffer.swap(gLoadTestTapPending);
+    gLoadTestTapPending.clear();
+    gbLoadTestTapSending = true;
+
+    asio::async_write(
+        gpLoadTestTap->socket,
+        asio::buffer(gLoadTestTapSendBuffer),
+        [](const asio::error_code& error, [[maybe_unused]] const std::size_t numBytes) noexcept {
+            gbLoadTestTapSending = false;
+
+            if (error) {
+                std::printf("Relay load test: synthetic game stream disconnected\n");
+                gpLoadTestTap.reset();
+                gbLoadTestTapStreaming = false;
+                return;
+            }
+
+            startLoadTestTapSend();
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: streams the synthetic ticks that are due, along with snapshots and state hashes when it is time for them.
+// The ticks are all the same: each has new inputs for one player. The snapshots and hashes are just filler.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void updateLoadTestTap() noexcept {
+    if (!gbLoadTestTapStreaming)
+        return;
+
+    const double elapsedSecs = std::chrono::duration<double>(relayclock_t::now() - gLoadTestTapStartTime).count();
+    const uint32_t numTicksDue = (uint32_t)(elapsedSecs * LOAD_TEST_TICKS_PER_SEC);
+
+    std::byte tick[1 + sizeof(DemoCommon::DemoTickInputs)] = {};
+    tick[0] = (std::byte) 0x80;
+    std::vector<std::byte> ticks;
+
+    while (gLoadTestTapNumTicks < numTicksDue) {
+        if (gLoadTestTapNumTicks % LOAD_TEST_STATE_HASH_INTERVAL == 0) {
+            // Send any ticks before this point first, so the hash and snapshot are for the right tick
+            if (!ticks.empty()) {
+                appendMessage(gLoadTestTapPending, MsgType::Ticks, ticks.data(), (uint32_t) ticks.size());
+                ticks.clear();
+            }
+
+            if (gLoadTestTapNumTicks % LOAD_TEST_SNAPSHOT_INTERVAL == 0) {
+                std::vector<std::byte> snapshot(LOAD_TEST_SNAPSHOT_SIZE);
+                DemoCommon::DemoSnapshotHdr snapshotHdr = {};
+                snapshotHdr.tickIdx = gLoadTestTapNumTicks;
+                DemoCommon::endianCorrect(snapshotHdr);
+                std::memcpy(snapshot.data(), &snapshotHdr, sizeof(snapshotHdr));
+                appendMessage(gLoadTestTapPending, MsgType::Snapshot, snapshot.data(), (uint32_t) snapshot.size());
+            }
+
+            StateHashMsg stateHashMsg = { gLoadTestTapNumTicks, {} };
+
+            if constexpr (Endian::isBig()) {
+                stateHashMsg.byteSwap();
+            }
+
+            appendMessage(gLoadTestTapPending, MsgType::StateHash, &stateHashMsg, sizeof(stateHashMsg));
+        }
+
+        ticks.insert(ticks.end(), tick, tick + sizeof(tick));
+        gLoadTestTapNumTicks++;
+    }
+
+    if (!ticks.empty()) {
+        appendMessage(gLoadTestTapPending, MsgType::Ticks, ticks.data(), (uint32_t) ticks.size());
+    }
+
+    startLoadTestTapSend();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: makes the hello sent by the dummy spectators and the synthetic tap, ready to send
+//------------------------------------------------------------------------------------------------------------------------------------------
+static Hello makeLoadTestHello(const ClientRole role) noexcept {
+    Hello hello = { HELLO_ID, PROTOCOL_VERSION, DemoCommon::DEMO_FILE_VERSION, role };
+
+    if constexpr (Endian::isBig()) {
+        hello.byteSwap();
+    }
+
+    return hello;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: connects a dummy spectator to the relay and starts it consuming the stream
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void connectLoadTestSpectator() noexcept {
+    static const Hello hello = makeLoadTestHello(ClientRole::Spectator);
+
+    const LoadTestClientPtr pClient = std::make_shared<LoadTestClient>(*gpIoContext);
+    gLoadTestClients.push_back(pClient);
+
+    asio::async_connect(
+        pClient->socket,
+        gLoadTestEndpoints,
+        [pClient](const asio::error_code& error, [[maybe_unused]] const asio::ip::tcp::endpoint& endpoint) noexcept {
+            if (error) {
+                onLoadTestClientClosed(*pClient);
+                return;
+            }
+
+            pClient->bConnected = true;
+            gLoadTestNumConnected++;
+
+            asio::async_write(
+                pClient->socket,
+                asio::buffer(&hello, sizeof(hello)),
+                [pClient](const asio::error_code& error, [[maybe_unused]] const std::size_t numBytes) noexcept {
+                    if (error) {
+                        onLoadTestClientClosed(*pClient);
+                    } else {
+                        startLoadTestReceive(pClient);
+                    }
+                }
+            );
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Load test: tries to connect to the relay as the tap and begin streaming a synthetic game.
+// If another tap is already streaming to the relay then the relay rejects this, and the load test uses the real game stream instead.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void connectLoadTestTap() noexcept {
+    gpLoadTestTap = std::make_shared<LoadTestClient>(*gpIoContext);
+
+    asio::async_connect(
+        gpLoadTestTap->socket,
+        gLoadTestEndpoints,
+        [](const asio::error_code& error, [[maybe_unused]] const asio::ip::tcp::endpoint& endpoint) noexcept {
+            if (error) {
+                std::printf("Relay load test: failed to connect the synthetic game stream\n");
+                gpLoadTestTap.reset();
+                return;
+            }
+
+            // Note: the map header contents don't matter to the relay or to the dummy spectators
+            const Hello hello = makeLoadTestHello(ClientRole::Tap);
+            const std::byte* const pHelloBytes = reinterpret_cast<const std::byte*>(&hello);
+            gLoadTestTapPending.assign(pHelloBytes, pHelloBytes + sizeof(hello));
+            appendMessage(gLoadTestTapPending, MsgType::MapBegin, nullptr, 0);
+
+            gLoadTestTapNumTicks = 0;
+            gLoadTestTapStartTime = relayclock_t::now();
+            gbLoadTestTapStreaming = true;
+            updateLoadTestTap();
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Runs a load test against the relay: connects many dummy spectators to it and reports on the data they receive.
+// Runs until stopped via Ctrl+C or similar and returns the exit code for the application.
+//------------------------------------------------------------------------------------------------------------------------------------------
+int runLoadTest() noexcept {
+    const uint32_t numClients = (uint32_t) ProgArgs::gRelayLoadTestClients;
+
+    try {
+        initIoContext();
+        asio::ip::tcp::resolver tcpResolver(*gpIoContext);
+        gLoadTestEndpoints = tcpResolver.resolve(ProgArgs::getRelayHost(), std::to_string(ProgArgs::gRelayPort));
+    }
+    catch (...) {
+        std::printf("Relay load test: failed to resolve relay host '%s'!\n", ProgArgs::getRelayHost());
+        shutdown();
+        return 1;
+    }
+
+    std::printf("Relay load test: connecting %u spectators to '%s' port %u (Ctrl+C to stop)\n", numClients, ProgArgs::getRelayHost(), (unsigned) ProgArgs::gRelayPort);
+
+    gLoadTestNumConnected = 0;
+    gLoadTestNumDisconnected = 0;
+    gLoadTestNumFailed = 0;
+    gLoadTestNumMapsBegun = 0;
+    gLoadTestNumSnapshots = 0;
+    gLoadTestNumTicks = 0;
+    gLoadTestClients.reserve(numClients);
+
+    // Start the synthetic game stream first, so that the spectators join part way through the map once it has a snapshot.
+    // Connect the spectators gradually over the first couple of seconds, like a crowd joining rather than all at the same instant.
+    connectLoadTestTap();
+    const relayclock_t::time_point startTime = relayclock_t::now();
+
+    resetStats();
+    runUntilStopped(
+        [=]() noexcept {
+            updateLoadTestTap();
+
+            const double elapsedSecs = std::chrono::duration<double>(relayclock_t::now() - startTime).count();
+            const double joinFraction = std::clamp((elapsedSecs - 1.0) / 2.0, 0.0, 1.0);
+            const uint32_t numClientsDue = (uint32_t)(joinFraction * numClients);
+
+            while (gLoadTestClients.size() < numClientsDue) {
+                connectLoadTestSpectator();
+            }
+        },
+        printAndResetLoadTestStats
+    );
+
+    printAndResetLoadTestStats();
+    gLoadTestClients.clear();
+    gpLoadTestTap.reset();
+    gbLoadTestTapStreaming = false;
+    gbLoadTestTapSending = false;
+    gLoadTestTapSendBuffer.clear();
+    gLoadTestTapPending.clear();
+    gLoadTestEndpoints = {};
+    shutdown();
+    return 0;
+}
+
+END_NAMESPACE(NetRelay)
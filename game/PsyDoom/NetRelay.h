@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Macros.h"
+
+BEGIN_NAMESPACE(NetRelay)
+
+int runServer() noexcept;
+int runLoadTest() noexcept;
+
+END_NAMESPACE(NetRelay)
@@ -0,0 +1,671 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Client side of the spectator relay.
+// Handles streaming the game to the relay as the 'tap' and watching a game streamed via the relay as a spectator.
+// Spectators play the stream back through the normal game simulation, exactly like a demo, a configurable delay behind the live game.
+// For more details on the protocol used see 'NetRelayProtocol.h'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "NetRelayClient.h"
+
+#include "DemoCommon.h"
+#include "Doom/Base/i_main.h"
+#include "Doom/d_main.h"
+#include "Doom/Game/g_game.h"
+#include "Doom/Game/p_tick.h"
+#include "Doom/Renderer/r_data.h"
+#include "Input.h"
+#include "ProgArgs.h"
+#include "StateHash.h"
+#include "Utils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
+
+// This prevents warnings in ASIO about the Windows SDK target version not being specified
+#if _WIN32
+    #include <sdkddkver.h>
+#endif
+
+BEGIN_DISABLE_HEADER_WARNINGS
+    #include <asio.hpp>
+END_DISABLE_HEADER_WARNINGS
+
+using namespace NetRelayProtocol;
+
+BEGIN_NAMESPACE(NetRelayClient)
+
+// The most data that can be waiting to be sent to the relay by the tap before giving up: the relay must be unreachable or too slow
+static constexpr size_t MAX_TAP_SEND_BUFFER = 16 * 1024 * 1024;
+
+// How long to wait for data being sent by the tap to go out when a map ends or the connection is shut down
+static constexpr std::chrono::milliseconds TAP_FLUSH_TIMEOUT = std::chrono::milliseconds(250);
+
+// Size of the chunks in which data is received from the relay
+static constexpr size_t RECV_CHUNK_SIZE = 64 * 1024;
+
+typedef std::chrono::steady_clock relayclock_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Marks the end of some data received for a map and when it can be played, given the spectator delay
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct ReleasePoint {
+    size_t                      endOffset;
+    relayclock_t::time_point    releaseTime;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Everything received by a spectator about a map being played, or which is waiting to be played
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct StreamedMap {
+    std::vector<std::byte>      demoData;           // The demo header followed by the encoded tick inputs received so far
+    size_t                      headerSize;         // Size of the demo header at the start of the demo data
+    size_t                      releasedSize;       // How much of the demo data can be played now, given the spectator delay
+    std::deque<ReleasePoint>    pendingReleases;    // Data received which is being held back due to the spectator delay
+    std::vector<std::byte>      snapshot;           // Snapshot of the game state to start from when joining part way through the map
+    uint32_t                    snapshotTick;       // Which demo tick the snapshot was taken before
+    uint32_t                    numBacklogTicks;    // How many ticks had been played since the snapshot (or map start) when joining
+    std::deque<StateHashMsg>    stateHashes;        // Hashes of the game state sent by the tap, for ticks not yet played
+    bool                        bReceivedTicks;     // True once any tick inputs have been received (including an empty backlog)
+    bool                        bEnded;             // True once the tap has finished with the map (or the relay connection was lost)
+};
+
+static std::unique_ptr<asio::io_context>        gpIoContext;
+static std::unique_ptr<asio::ip::tcp::socket>   gpSocket;
+static bool                                     gbConnected;            // Is there a connection to the relay which is still OK?
+static ClientRole                               gRole;                  // What this client is to the relay
+
+// Tap state
+static std::vector<std::byte>   gTapSendBuffer;             // Data waiting to be sent to the relay
+static std::vector<std::byte>   gTapSendInFlight;           // Data being sent to the relay by the current async write
+
+// Spectator state
+static bool                             gbSpectating;       // True while a spectator session is running
+static bool                             gbPlayingMap;       // True while the map at the front of the queue is being played
+static bool                             gbSkipToNextMap;    // If 'true' then ignore the rest of the map being streamed, it's no longer being played
+static std::deque<StreamedMap>          gMaps;              // Maps received: the front one is being played or is next to play
+static std::vector<std::byte>           gRecvBuffer;        // Data received from the relay which has not been processed yet
+static std::unique_ptr<std::byte[]>     gpRecvChunk;        // Buffer for receiving the next chunk of data from the relay
+static bool                             gbVerifiedJoin;     // True once the game state has been verified after starting to play a map
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Closes the connection to the relay (if still open) and reports why
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void disconnect(const char* const reason) noexcept {
+    if (!gbConnected)
+        return;
+
+    gbConnected = false;
+    std::printf("%s\n", reason);
+
+    asio::error_code error;
+    gpSocket->close(error);
+
+    // No more data will arrive for any of the maps being streamed
+    for (StreamedMap& map : gMaps) {
+        map.bEnded = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Process any network events for the relay connection
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void pollNetwork() noexcept {
+    if (gpIoContext) {
+        gpIoContext->restart();
+        gpIoContext->poll();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Checks for user input to cancel waiting on the relay
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool isCancelRequested() noexcept {
+    TickInputs inputs;
+    P_GatherTickInputs(inputs);
+    return inputs.fMenuBack();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Blocks until an asynchronous network operation completes or is aborted by the user; returns 'true' if the operation completed
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool waitForAsyncOp(bool& bFinishedFlag) noexcept {
+    while (!bFinishedFlag) {
+        if (Input::isQuitRequested())
+            return false;
+
+        pollNetwork();
+        Utils::doPlatformUpdates();
+
+        if (bFinishedFlag)
+            break;
+
+        if (isCancelRequested())
+            return false;
+
+        Utils::threadYield();
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Connects to the relay and introduces this client in the given role.
+// Updates the window while connecting and allows the connection attempt to be aborted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool connectToRelay(const ClientRole role) noexcept {
+    // Clean up any previous connection first
+    shutdown();
+    gRole = role;
+    bool bWasSuccessful = false;
+
+    try {
+        // Create the io context and socket
+        gpIoContext.reset(new asio::io_context());
+        gpSocket.reset(new asio::ip::tcp::socket(*gpIoContext));
+
+        // Resolve the relay host address
+        asio::ip::tcp::resolver tcpResolver(*gpIoContext);
+        asio::ip::tcp::resolver::results_type endpoints;
+        bool bDoneAsyncOp = false;
+
+        tcpResolver.async_resolve(
+            ProgArgs::getRelayHost(),
+            std::to_string(ProgArgs::gRelayPort),
+            [&](const asio::error_code& error, asio::ip::tcp::resolver::results_type results) noexcept {
+                bDoneAsyncOp = true;
+                bWasSuccessful = (!error);
+                endpoints = results;
+            }
+        );
+
+        // If that was successful then try connecting to one of the addresses
+        if (waitForAsyncOp(bDoneAsyncOp) && bWasSuccessful) {
+            bDoneAsyncOp = false;
+            bWasSuccessful = false;
+
+            asio::async_connect(
+                *gpSocket,
+                endpoints,
+                [&](const asio::error_code& error, [[maybe_unused]] const asio::ip::tcp::endpoint& endpoint) noexcept {
+                    bDoneAsyncOp = true;
+                    bWasSuccessful = (!error);
+                }
+            );
+
+            waitForAsyncOp(bDoneAsyncOp);
+        }
+
+        // Introduce ourselves to the relay
+        if (bWasSuccessful) {
+            gpSocket->set_option(asio::ip::tcp::no_delay(true));
+
+            Hello hello = { HELLO_ID, PROTOCOL_VERSION, DemoCommon::DEMO_FILE_VERSION, role };
+
+            if constexpr (Endian::isBig()) {
+                hello.byteSwap();
+            }
+
+            asio::write(*gpSocket, asio::buffer(&hello, sizeof(hello)));
+        }
+    }
+    catch (...) {
+        bWasSuccessful = false;
+    }
+
+    if (!bWasSuccessful) {
+        shutdown();
+        return false;
+    }
+
+    gbConnected = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tap: starts sending the data waiting to go to the relay, if not already sending
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startTapSend() noexcept {
+    if ((!gbConnected) || (!gTapSendInFlight.empty()) || gTapSendBuffer.empty())
+        return;
+
+    std::swap(gTapSendInFlight, gTapSendBuffer);
+
+    asio::async_write(
+        *gpSocket,
+        asio::buffer(gTapSendInFlight),
+        [](const asio::error_code& error, [[maybe_unused]] const std::size_t numBytes) noexcept {
+            gTapSendInFlight.clear();
+
+            if (error) {
+                disconnect("Lost connection to the spectator relay! Games will no longer be streamed.");
+            } else {
+                startTapSend();
+            }
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tap: waits a short while for all data queued for the relay to be sent
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void waitForTapSends() noexcept {
+    const relayclock_t::time_point endTime = relayclock_t::now() + TAP_FLUSH_TIMEOUT;
+
+    while (gbConnected && ((!gTapSendInFlight.empty()) || (!gTapSendBuffer.empty())) && (relayclock_t::now() < endTime)) {
+        startTapSend();
+        pollNetwork();
+        Utils::threadYield();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: counts how many whole ticks are contained in the given encoded tick inputs
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t countTicks(const std::byte* const pData, const uint32_t size) noexcept {
+    uint32_t numTicks = 0;
+
+    for (size_t offset = 0; offset < size; offset += DemoCommon::getEncodedTickSize((uint8_t) pData[offset])) {
+        numTicks++;
+    }
+
+    return numTicks;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: handles a message received from the relay; returns 'false' if the message is invalid
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool onSpectatorMessage(const MsgType type, const std::byte* const pData, const uint32_t size) noexcept {
+    // Data received can only be played once the spectator delay has passed
+    const relayclock_t::time_point releaseTime = relayclock_t::now() + std::chrono::duration_cast<relayclock_t::duration>(
+        std::chrono::duration<float>(ProgArgs::gSpectateDelay)
+    );
+
+    // A new map starting?
+    if (type == MsgType::MapBegin) {
+        gbSkipToNextMap = false;
+
+        StreamedMap& map = gMaps.emplace_back();
+        map.demoData.assign(pData, pData + size);
+        map.headerSize = size;
+        map.pendingReleases.push_back({ size, releaseTime });
+        return true;
+    }
+
+    // Otherwise the message relates to the last map begun: ignore it if that map is no longer being played
+    if (gbSkipToNextMap || gMaps.empty() || gMaps.back().bEnded)
+        return true;
+
+    StreamedMap& map = gMaps.back();
+
+    switch (type) {
+        case MsgType::Ticks:
+        case MsgType::BacklogTicks: {
+            if (type == MsgType::BacklogTicks) {
+                map.numBacklogTicks = countTicks(pData, size);
+            }
+
+            map.demoData.insert(map.demoData.end(), pData, pData + size);
+            map.pendingReleases.push_back({ map.demoData.size(), releaseTime });
+            map.bReceivedTicks = true;
+        }   return true;
+
+        case MsgType::Snapshot: {
+            if (size < sizeof(DemoCommon::DemoSnapshotHdr))
+                return false;
+
+            DemoCommon::DemoSnapshotHdr snapshotHdr;
+            std::memcpy(&snapshotHdr, pData, sizeof(snapshotHdr));
+            DemoCommon::endianCorrect(snapshotHdr);
+
+            map.snapshot.assign(pData, pData + size);
+            map.snapshotTick = snapshotHdr.tickIdx;
+        }   return true;
+
+        case MsgType::StateHash: {
+            if (size != sizeof(StateHashMsg))
+                return false;
+
+            StateHashMsg msg;
+            std::memcpy(&msg, pData, sizeof(msg));
+
+            if constexpr (Endian::isBig()) {
+                msg.byteSwap();
+            }
+
+            map.stateHashes.push_back(msg);
+        }   return true;
+
+        case MsgType::MapEnd:
+            map.bEnded = true;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: starts receiving the next chunk of data from the relay
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void startSpectatorReceive() noexcept {
+    gpSocket->async_read_some(
+        asio::buffer(gpRecvChunk.get(), RECV_CHUNK_SIZE),
+        [](const asio::error_code& error, const std::size_t numBytes) noexcept {
+            if (error) {
+                disconnect("Lost connection to the spectator relay!");
+                return;
+            }
+
+            gRecvBuffer.insert(gRecvBuffer.end(), gpRecvChunk.get(), gpRecvChunk.get() + numBytes);
+
+            if (!consumeMessages(gRecvBuffer, onSpectatorMessage)) {
+                disconnect("Received bad data from the spectator relay! Disconnecting from it.");
+                return;
+            }
+
+            startSpectatorReceive();
+        }
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: handles network events and releases data for playback once the spectator delay has passed.
+// If a map is being played then the demo buffer pointers are updated, since the demo buffer may be reallocated as data arrives.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void updateSpectator() noexcept {
+    const bool bHaveReadPos = (gbPlayingMap && gpDemo_p);
+    const size_t readOffset = (bHaveReadPos) ? (size_t)(gpDemo_p - gpDemoBuffer) : 0;
+
+    pollNetwork();
+
+    if (gMaps.empty())
+        return;
+
+    StreamedMap& map = gMaps.front();
+    const relayclock_t::time_point now = relayclock_t::now();
+
+    while ((!map.pendingReleases.empty()) && (map.pendingReleases.front().releaseTime <= now)) {
+        map.releasedSize = map.pendingReleases.front().endOffset;
+        map.pendingReleases.pop_front();
+    }
+
+    if (gbPlayingMap) {
+        gpDemoBuffer = map.demoData.data();
+        gpDemoBufferEnd = gpDemoBuffer + map.releasedSize;
+
+        if (bHaveReadPos) {
+            gpDemo_p = gpDemoBuffer + readOffset;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: tells if the inputs for the next tick of the map being played have been fully received and released for playback
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool isTickAvailable() noexcept {
+    if ((!gpDemo_p) || (gpDemo_p >= gpDemoBufferEnd))
+        return false;
+
+    const size_t tickSize = DemoCommon::getEncodedTickSize((uint8_t) *gpDemo_p);
+    return (gpDemo_p + tickSize <= gpDemoBufferEnd);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: waits until the next map is ready to start playing.
+// Returns 'false' if the session should end because the relay connection was lost or the user quit.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool waitForMapStart() noexcept {
+    while (true) {
+        updateSpectator();
+
+        if (!gMaps.empty()) {
+            // Note: wait for some tick data to arrive too, so that a backlog sent upon joining is known about before playback begins
+            const StreamedMap& map = gMaps.front();
+
+            if ((map.releasedSize >= map.headerSize) && (map.bReceivedTicks || map.bEnded))
+                return true;
+        }
+        else if (!gbConnected) {
+            return false;
+        }
+
+        if (Input::isQuitRequested() || isCancelRequested())
+            return false;
+
+        Utils::doPlatformUpdates();
+        Utils::threadYield();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Closes the connection to the relay (if any) and cleans up
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    // Give any data still waiting to be sent by the tap a brief chance to go out
+    if (gbConnected && (gRole == ClientRole::Tap)) {
+        waitForTapSends();
+    }
+
+    gpSocket.reset();
+    gpIoContext.reset();
+    gbConnected = false;
+
+    gTapSendBuffer.clear();
+    gTapSendInFlight.clear();
+
+    gbPlayingMap = false;
+    gbSkipToNextMap = false;
+    gMaps.clear();
+    gRecvBuffer.clear();
+    gpRecvChunk.reset();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Connects to the relay as the 'tap', which streams all games played to the relay for spectators to watch
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool connectTap() noexcept {
+    std::printf("Connecting to the spectator relay at '%s' port %u...\n", ProgArgs::getRelayHost(), (unsigned) ProgArgs::gRelayPort);
+
+    if (!connectToRelay(ClientRole::Tap)) {
+        std::printf("Failed to connect to the spectator relay! Games will not be streamed.\n");
+        return false;
+    }
+
+    std::printf("Connected to the spectator relay: games will be streamed to it.\n");
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if there is a connection to the relay as the 'tap'
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isTapConnected() noexcept {
+    return (gbConnected && (gRole == ClientRole::Tap));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tap: queues a message to be sent to the relay and does network updates.
+// If the relay falls too far behind in receiving data then the connection to it is dropped.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void sendTapMessage(const MsgType type, const void* const pData, const uint32_t size) noexcept {
+    if (!isTapConnected())
+        return;
+
+    appendMessage(gTapSendBuffer, type, pData, size);
+
+    if (gTapSendBuffer.size() > MAX_TAP_SEND_BUFFER) {
+        disconnect("The spectator relay is not keeping up with the game being streamed! Disconnecting from it.");
+        return;
+    }
+
+    startTapSend();
+    pollNetwork();
+
+    // Make sure the end of a map goes out promptly, since there may not be any more updates for a while after this (intermission etc.)
+    if (type == MsgType::MapEnd) {
+        waitForTapSends();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Connects to the relay as a spectator and plays the game being streamed via the relay, map by map.
+// Continues until the user quits playback, the relay connection is lost or the application is quit.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void runSpectatorSession() noexcept {
+    // Ensure this required graphic is loaded before starting playback
+    if (!gTex_LOADING.bIsCached) {
+        I_LoadAndCacheTexLump(gTex_LOADING, "LOADING", 0);
+    }
+
+    std::printf("Connecting to the spectator relay at '%s' port %u...\n", ProgArgs::getRelayHost(), (unsigned) ProgArgs::gRelayPort);
+
+    if (!connectToRelay(ClientRole::Spectator)) {
+        std::printf("Failed to connect to the spectator relay!\n");
+        return;
+    }
+
+    std::printf("Connected to the spectator relay: waiting for a game to watch...\n");
+    gbSpectating = true;
+    gpRecvChunk.reset(new std::byte[RECV_CHUNK_SIZE]);
+    startSpectatorReceive();
+
+    while (waitForMapStart()) {
+        // Play the map streamed like a demo: the demo player waits on data from the relay as needed
+        gbPlayingMap = true;
+        gbVerifiedJoin = false;
+        updateSpectator();
+        const gameaction_t exitAction = G_PlayDemoPtr();
+        gbPlayingMap = false;
+        gpDemoBuffer = nullptr;
+        gpDemoBufferEnd = nullptr;
+
+        // If the map finished playing before the tap ended it (e.g the level was completed) then skip the rest of the map's data
+        const bool bMapEnded = gMaps.front().bEnded;
+        gMaps.pop_front();
+
+        if (!bMapEnded) {
+            gbSkipToNextMap = true;
+        }
+
+        // Stop spectating if the user exited playback part way through the map or is quitting the app
+        const bool bUserExited = ((!bMapEnded) && ((exitAction == ga_exit) || (exitAction == ga_exitdemo)));
+
+        if (bUserExited || (exitAction == ga_quitapp) || Input::isQuitRequested())
+            break;
+    }
+
+    gbSpectating = false;
+    shutdown();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if a spectator session is running
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isSpectating() noexcept {
+    return gbSpectating;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: waits until the inputs for the next tick of the map being played are available.
+// Returns 'false' if there are no more ticks for the map, or if the user or app is quitting.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool waitForTickData() noexcept {
+    ASSERT(gbPlayingMap);
+
+    while (true) {
+        updateSpectator();
+
+        if (isTickAvailable())
+            return true;
+
+        const StreamedMap& map = gMaps.front();
+
+        if (map.bEnded && map.pendingReleases.empty())
+            return false;
+
+        if (Input::isQuitRequested() || isCancelRequested())
+            return false;
+
+        Utils::doPlatformUpdates();
+        Utils::threadYield();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: checks the game state before the given demo tick against the hash sent by the tap for that tick (if any).
+// The first check after starting a map verifies that restoring the join snapshot and catching up on the backlog gave the same state.
+// Returns 'false' if the game state does not match, in which case playback is out of sync with the game being watched.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool checkStateHash(const uint32_t tickIdx) noexcept {
+    if (!gbPlayingMap)
+        return true;
+
+    // Discard hashes for ticks already played (or skipped over by starting from a snapshot)
+    std::deque<StateHashMsg>& stateHashes = gMaps.front().stateHashes;
+
+    while ((!stateHashes.empty()) && (stateHashes.front().tickIdx < tickIdx)) {
+        stateHashes.pop_front();
+    }
+
+    if (stateHashes.empty() || (stateHashes.front().tickIdx != tickIdx))
+        return true;
+
+    const StateHash::TickHash expected = stateHashes.front().hash;
+    const StateHash::TickHash actual = StateHash::compute();
+    stateHashes.pop_front();
+
+    if (expected != actual) {
+        std::printf(
+            "Spectator game state does not match the game being watched at demo tick %u! Mismatched state:%s%s%s%s\n",
+            tickIdx,
+            (expected.rng != actual.rng) ? " rng" : "",
+            (expected.players != actual.players) ? " players" : "",
+            (expected.mobjs != actual.mobjs) ? " mobjs" : "",
+            (expected.sectors != actual.sectors) ? " sectors" : ""
+        );
+
+        return false;
+    }
+
+    if (!gbVerifiedJoin) {
+        gbVerifiedJoin = true;
+        std::printf("Spectator game state verified against the game being watched at demo tick %u.\n", tickIdx);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: tells if all the ticks streamed for the map being played have been played
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool hasReachedStreamEnd() noexcept {
+    if (!gbPlayingMap)
+        return true;
+
+    updateSpectator();
+    const StreamedMap& map = gMaps.front();
+    return (map.bEnded && map.pendingReleases.empty() && (!isTickAvailable()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: returns the snapshot of the game state to start the map being played from (empty if starting from the beginning)
+//------------------------------------------------------------------------------------------------------------------------------------------
+const std::vector<std::byte>& getJoinSnapshot() noexcept {
+    static const std::vector<std::byte> NO_SNAPSHOT;
+    return (gbPlayingMap) ? gMaps.front().snapshot : NO_SNAPSHOT;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Spectator: returns which demo tick playback should quickly catch up to when joining part way through the map being played.
+// This is the tick that the game had reached at the time of joining.
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getCatchUpTick() noexcept {
+    if (!gbPlayingMap)
+        return 0;
+
+    const StreamedMap& map = gMaps.front();
+    const uint32_t startTick = (!map.snapshot.empty()) ? map.snapshotTick : 0;
+    return startTick + map.numBacklogTicks;
+}
+
+END_NAMESPACE(NetRelayClient)
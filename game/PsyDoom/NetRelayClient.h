@@ -0,0 +1,25 @@
+#pragma once
+
+#include "NetRelayProtocol.h"
+
+#include <vector>
+
+BEGIN_NAMESPACE(NetRelayClient)
+
+void shutdown() noexcept;
+
+// Tap: streaming the game to a spectator relay
+bool connectTap() noexcept;
+bool isTapConnected() noexcept;
+void sendTapMessage(const NetRelayProtocol::MsgType type, const void* const pData, const uint32_t size) noexcept;
+
+// Spectator: watching a game streamed via a spectator relay
+void runSpectatorSession() noexcept;
+bool isSpectating() noexcept;
+bool waitForTickData() noexcept;
+bool checkStateHash(const uint32_t tickIdx) noexcept;
+bool hasReachedStreamEnd() noexcept;
+const std::vector<std::byte>& getJoinSnapshot() noexcept;
+uint32_t getCatchUpTick() noexcept;
+
+END_NAMESPACE(NetRelayClient)
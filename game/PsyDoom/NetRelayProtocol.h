@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Endian.h"
+#include "StateHash.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions for the protocol spoken between a spectator relay and the game instances which connect to it.
+//
+// One player of a game (the 'tap') streams the game to the relay in the same format that demos are recorded in: a demo header at the
+// start of each map, followed by the encoded inputs for each tick. Periodic snapshots of the game state are also sent by the tap, so that
+// spectators joining part way through a map can start from a recent point. The relay fans the stream out to any number of spectators,
+// which play it back through the normal game simulation just like a demo. The tap also periodically sends a hash of the game state, which
+// spectators check their own game state against (including right after joining) to detect any desync.
+//
+// After connecting, clients first send a 'Hello' to identify themselves. After that everything is sent as a sequence of messages, with
+// each message preceded by a message header giving its type and size. All values are little endian.
+//------------------------------------------------------------------------------------------------------------------------------------------
+BEGIN_NAMESPACE(NetRelayProtocol)
+
+static constexpr uint32_t HELLO_ID = 0x59414C52;        // 'RLAY'
+static constexpr uint32_t PROTOCOL_VERSION = 3;
+
+// The maximum size of a single message: generous, since snapshots of the game state for big maps can be large
+static constexpr uint32_t MAX_MSG_SIZE = 16 * 1024 * 1024;
+
+// What a client connecting to the relay is
+enum class ClientRole : uint32_t {
+    Tap,            // Streams a game to the relay (only 1 at a time)
+    Spectator       // Receives the game streamed by the tap
+};
+
+// The types of message sent after the initial hello
+enum class MsgType : uint32_t {
+    MapBegin,       // A new map is starting: the payload is the demo header
+    Ticks,          // Encoded demo inputs for one or more whole ticks
+    Snapshot,       // A snapshot of the game state: a 'DemoSnapshotHdr' followed by the serialized game state
+    BacklogTicks,   // Relay to spectator only: ticks since the snapshot (or map start) for a spectator joining part way through a map
+    MapEnd,         // The current map has ended: no more ticks will be sent for it
+    StateHash,      // A 'StateHashMsg' with the hash of the game state before a tick's inputs are applied
+    NUM_TYPES
+};
+
+// Sent by clients when first connecting to the relay
+struct Hello {
+    uint32_t    helloId;            // Should match 'HELLO_ID'
+    uint32_t    protocolVersion;    // Should match 'PROTOCOL_VERSION'
+    uint32_t    demoFileVersion;    // The demo format version being streamed: spectators must match the tap
+    ClientRole  role;
+
+    void byteSwap() noexcept {
+        Endian::byteSwapInPlace(helloId);
+        Endian::byteSwapInPlace(protocolVersion);
+        Endian::byteSwapInPlace(demoFileVersion);
+        Endian::byteSwapEnumInPlace(role);
+    }
+};
+
+static_assert(sizeof(Hello) == 16);
+
+// The payload for a 'StateHash' message
+struct StateHashMsg {
+    uint32_t                tickIdx;        // Which demo tick the game state was hashed before
+    StateHash::TickHash     hash;
+
+    void byteSwap() noexcept {
+        Endian::byteSwapInPlace(tickIdx);
+        hash.byteSwap();
+    }
+};
+
+static_assert(sizeof(StateHashMsg) == 20);
+
+// Precedes every message after the hello
+struct MsgHeader {
+    MsgType     type;
+    uint32_t    size;               // Size of the payload following the header
+
+    void byteSwap() noexcept {
+        Endian::byteSwapEnumInPlace(type);
+        Endian::byteSwapInPlace(size);
+    }
+};
+
+static_assert(sizeof(MsgHeader) == 8);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: appends a message with the given type and payload to the specified buffer of bytes to be sent
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline void appendMessage(std::vector<std::byte>& buffer, const MsgType type, const void* const pData, const uint32_t size) noexcept {
+    MsgHeader hdr = { type, size };
+
+    if constexpr (Endian::isBig()) {
+        hdr.byteSwap();
+    }
+
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(MsgHeader) + size);
+    std::memcpy(buffer.data() + offset, &hdr, sizeof(MsgHeader));
+
+    if (size > 0) {
+        std::memcpy(buffer.data() + offset + sizeof(MsgHeader), pData, size);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: consumes all the whole messages at the front of a buffer of received bytes, calling the given handler for each one.
+// The handler is called with the message type, payload pointer and payload size; it returns 'false' if the message is not acceptable.
+// Returns 'false' if a malformed or unacceptable message is encountered, in which case the connection should be dropped.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class MsgHandler>
+inline bool consumeMessages(std::vector<std::byte>& buffer, const MsgHandler& handler) noexcept {
+    size_t offset = 0;
+    bool bValidMessages = true;
+
+    while (buffer.size() - offset >= sizeof(MsgHeader)) {
+        MsgHeader hdr;
+        std::memcpy(&hdr, buffer.data() + offset, sizeof(MsgHeader));
+
+        if constexpr (Endian::isBig()) {
+            hdr.byteSwap();
+        }
+
+        if ((hdr.type >= MsgType::NUM_TYPES) || (hdr.size > MAX_MSG_SIZE)) {
+            bValidMessages = false;
+            break;
+        }
+
+        // Stop if the rest of the message has not arrived yet
+        if (buffer.size() - offset - sizeof(MsgHeader) < hdr.size)
+            break;
+
+        if (!handler(hdr.type, buffer.data() + offset + sizeof(MsgHeader), hdr.size)) {
+            bValidMessages = false;
+            break;
+        }
+
+        offset += sizeof(MsgHeader) + hdr.size;
+    }
+
+    buffer.erase(buffer.begin(), buffer.begin() + offset);
+    return bValidMessages;
+}
+
+END_NAMESPACE(NetRelayProtocol)
@@ -0,0 +1,784 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// An alternative to the original lockstep netcode for 2 player games which uses rollback (predict and resimulate).
+//
+// With lockstep each player cannot advance the game until the other player's inputs for the frame arrive, so network latency directly
+// adds to input latency. With rollback each player sends their inputs for every frame and then immediately simulates the frame using a
+// prediction for the other player's inputs (whatever they last sent). Before the game state is advanced speculatively like this a snapshot
+// of it is taken, using the same serialization as save files. When the other player's real inputs arrive and differ from the prediction,
+// the game state is restored from the snapshot for the earliest mispredicted frame and all frames since then are re-simulated.
+//
+// Notes:
+//  (1) Prediction is only done during level gameplay: menus, the intermission and finale screens simply wait for the other player's
+//      inputs for each frame. Each run of the game loop ('MiniLoop') numbers it's frames from zero, and when a game loop finishes an end
+//      marker is exchanged so that both players begin the next loop in sync.
+//  (2) The game can only exit the level loop on a frame where the other player's inputs are known. If an exit is triggered speculatively
+//      then the game waits for the other player to catch up and re-simulates if required, to confirm that the exit really happened.
+//  (3) Pausing and opening the options menu must never be predicted, since they run nested game loops and make changes which cannot be
+//      rolled back. During level gameplay these inputs take effect 'PAUSE_INPUT_DELAY' frames after being pressed, which is more than
+//      the maximum prediction window, so they are always known by both players in advance. Frames where they are used are never predicted.
+//  (4) Sounds are not played while re-simulating, so sounds from mispredicted frames are not undone.
+//  (5) To detect desyncs each player hashes the game state prior to each frame of level gameplay (see 'StateHash'). Once all inputs up
+//      to a frame are known its hash is final, and the latest final hash is sent along with each player's inputs to be checked by the
+//      other player. A mismatch is reported as a network error, the same way that lockstep reports one.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "NetRollback.h"
+
+#include "Asserts.h"
+#include "ByteInputStream.h"
+#include "ByteVecOutputStream.h"
+#include "Doom/Base/i_main.h"
+#include "Doom/Base/w_wad.h"
+#include "Doom/d_main.h"
+#include "Doom/Game/g_game.h"
+#include "Doom/Game/p_tick.h"
+#include "Doom/Game/p_user.h"
+#include "Game.h"
+#include "MapHash.h"
+#include "Network.h"
+#include "SaveAndLoad.h"
+#include "StateHash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+BEGIN_NAMESPACE(NetRollback)
+
+// The maximum number of frames that the game can be simulated ahead of the other player's last received inputs
+static constexpr int32_t MAX_PREDICTION_FRAMES = 8;
+
+// How many frames the 'pause' and 'menu back' inputs are delayed by during level gameplay: must exceed the prediction window
+static constexpr int32_t PAUSE_INPUT_DELAY = MAX_PREDICTION_FRAMES + 1;
+
+// How many frames of history are kept: must be enough to cover the prediction window and the delayed pause inputs
+static constexpr int32_t HISTORY_SIZE = 32;
+
+static_assert(HISTORY_SIZE > PAUSE_INPUT_DELAY + MAX_PREDICTION_FRAMES);
+
+// If this player is ahead of the other player by at least this many more frames than the other player is ahead of us, then the other
+// player is running behind and it's their job to speed up. Conversely if we are behind by this amount then we speed up our clock.
+static constexpr int32_t TIME_SYNC_THRESHOLD = 2;
+
+// Frame index used by an end marker packet, which is sent when a game loop finishes
+static constexpr int32_t END_MARKER_FRAME = -1;
+
+typedef std::chrono::steady_clock rollbackclock_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Everything recorded about a particular frame
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct FrameRecord {
+    int32_t             frame;                          // Which frame this record is for ('-1' if unused)
+    TickInputs          rawInputs[MAXPLAYERS];          // The inputs gathered by each player (only valid for the remote player once received)
+    int32_t             rawVBlanks[MAXPLAYERS];         // The elapsed vblanks for each player (only valid for the remote player once received)
+    TickInputs          usedInputs[MAXPLAYERS];         // The inputs the frame was last simulated with: the remote player's may be predicted
+    int32_t             usedVBlanks[MAXPLAYERS];        // The elapsed vblanks the frame was last simulated with: the remote player's may be predicted
+    bool                bRemoteReceived;                // Have the remote player's inputs for this frame arrived?
+    bool                bSimulated;                     // Has this frame been simulated? (with predicted or real inputs)
+    bool                bHasSnapshot;                   // Is 'snapshot' valid for this frame?
+    bool                bHasStateHash;                  // Is 'stateHash' valid for this frame?
+    uint32_t            stateHash;                      // Hash of the game state prior to this frame, as it was last simulated
+    bool                bIsFirstTick;                   // Timing related state prior to this frame which is not saved in snapshots
+    int32_t             prevGameTic;
+    int32_t             lastTgtGameTicCount;
+    ByteVecOutputStream snapshot;                       // The game state prior to this frame: only taken if the frame was predicted
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// State for a run of the game loop: game loops can be nested (e.g the options menu opened while paused) so these form a stack
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct LoopState {
+    int32_t         curFrame;                           // The frame currently being run ('-1' if none yet)
+    int32_t         numRemoteFrames;                    // How many frames of inputs have been received from the other player
+    int32_t         firstMispredictedFrame;             // The earliest frame which was simulated with the wrong inputs ('INT32_MAX' if none)
+    int32_t         remoteFrameAdvantage;               // Last reported by the other player: how far ahead of us they are
+    int32_t         lastFinalHashFrame;                 // The last frame whose state hash is final, since all inputs before it are known ('-1' if none)
+    int32_t         remoteHashFrame;                    // The frame of the last state hash received from the other player and not yet checked ('-1' if none)
+    uint32_t        remoteHash;                         // The last state hash received from the other player
+    bool            bCanPredict;                        // Can frames be simulated speculatively in this loop? (level gameplay only)
+    bool            bRemoteEnded;                       // Set when the end marker for this loop is received from the other player
+    bool            bStateLost;                         // Set if the game state could not be restored for re-simulation: the game has desynced
+    gameaction_t    pendingExitAction;                  // An exit action that was confirmed while re-simulating, to be actioned ASAP
+    FrameRecord     history[HISTORY_SIZE];
+};
+
+static bool                                     gbEnabled;          // Is rollback netcode being used for the current network game?
+static bool                                     gbResimulating;     // Are we currently re-simulating frames?
+static std::vector<std::unique_ptr<LoopState>>  gLoops;             // Stack of game loops currently running: the innermost loop is last
+
+// Stats for the current reporting period
+static uint32_t                     gStatsNumFrames;
+static uint32_t                     gStatsNumPredictedFrames;
+static uint32_t                     gStatsNumRollbacks;
+static uint32_t                     gStatsNumResimFrames;
+static uint32_t                     gStatsMaxRollbackFrames;
+static uint32_t                     gStatsNumPredictionStalls;
+static rollbackclock_t::duration    gStatsSnapshotTime;
+static rollbackclock_t::duration    gStatsResimTime;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Resets the stats for the current reporting period
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void resetStats() noexcept {
+    gStatsNumFrames = 0;
+    gStatsNumPredictedFrames = 0;
+    gStatsNumRollbacks = 0;
+    gStatsNumResimFrames = 0;
+    gStatsMaxRollbackFrames = 0;
+    gStatsNumPredictionStalls = 0;
+    gStatsSnapshotTime = {};
+    gStatsResimTime = {};
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helpers: get the state for the innermost game loop and the history record for a particular frame
+//------------------------------------------------------------------------------------------------------------------------------------------
+static LoopState& getLoop() noexcept {
+    ASSERT(!gLoops.empty());
+    return *gLoops.back();
+}
+
+static FrameRecord& getRecord(LoopState& loop, const int32_t frame) noexcept {
+    ASSERT(frame >= 0);
+    return loop.history[frame % HISTORY_SIZE];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gets the history record for the specified frame, clearing it out first if it was last used for a different frame
+//------------------------------------------------------------------------------------------------------------------------------------------
+static FrameRecord& claimRecord(LoopState& loop, const int32_t frame) noexcept {
+    FrameRecord& rec = getRecord(loop, frame);
+
+    if (rec.frame != frame) {
+        rec.frame = frame;
+        std::memset(rec.rawInputs, 0, sizeof(rec.rawInputs));
+        std::memset(rec.rawVBlanks, 0, sizeof(rec.rawVBlanks));
+        std::memset(rec.usedInputs, 0, sizeof(rec.usedInputs));
+        std::memset(rec.usedVBlanks, 0, sizeof(rec.usedVBlanks));
+        rec.bRemoteReceived = false;
+        rec.bSimulated = false;
+        rec.bHasSnapshot = false;
+        rec.bHasStateHash = false;
+    }
+
+    return rec;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gets the inputs for the given player on the given frame, as they should actually be applied to the game.
+// During level gameplay the 'pause' and 'menu back' inputs are delayed so that they are always known in advance by both players.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static TickInputs getEffectiveInputs(LoopState& loop, const int32_t frame, const int32_t playerIdx, const TickInputs& rawInputs) noexcept {
+    TickInputs inputs = rawInputs;
+
+    if (loop.bCanPredict) {
+        const int32_t delayedFrame = frame - PAUSE_INPUT_DELAY;
+
+        if (delayedFrame >= 0) {
+            const FrameRecord& delayedRec = getRecord(loop, delayedFrame);
+            ASSERT(delayedRec.frame == delayedFrame);
+            ASSERT((playerIdx == gCurPlayerIndex) || delayedRec.bRemoteReceived);
+            inputs.fTogglePause() = delayedRec.rawInputs[playerIdx].fTogglePause();
+            inputs.fMenuBack() = delayedRec.rawInputs[playerIdx].fMenuBack();
+        } else {
+            inputs.fTogglePause() = false;
+            inputs.fMenuBack() = false;
+        }
+    }
+
+    return inputs;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Works out the inputs and elapsed vblanks to simulate the given frame with and saves them as the 'used' values in the frame's record.
+// The other player's inputs are predicted to be the same as the last ones received if they have not arrived yet.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void decideFrameInputs(LoopState& loop, FrameRecord& rec) noexcept {
+    const int32_t localIdx = gCurPlayerIndex;
+    const int32_t remoteIdx = localIdx ^ 1;
+
+    TickInputs remoteInputs = {};
+    int32_t remoteVBlanks = rec.rawVBlanks[localIdx];
+
+    if (rec.bRemoteReceived) {
+        remoteInputs = rec.rawInputs[remoteIdx];
+        remoteVBlanks = rec.rawVBlanks[remoteIdx];
+    } else if (loop.numRemoteFrames > 0) {
+        const FrameRecord& lastRemoteRec = getRecord(loop, loop.numRemoteFrames - 1);
+        remoteInputs = lastRemoteRec.rawInputs[remoteIdx];
+        remoteVBlanks = lastRemoteRec.rawVBlanks[remoteIdx];
+    }
+
+    rec.usedInputs[localIdx] = getEffectiveInputs(loop, rec.frame, localIdx, rec.rawInputs[localIdx]);
+    rec.usedInputs[remoteIdx] = getEffectiveInputs(loop, rec.frame, remoteIdx, remoteInputs);
+    rec.usedVBlanks[localIdx] = rec.rawVBlanks[localIdx];
+    rec.usedVBlanks[remoteIdx] = remoteVBlanks;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sets the game's current and previous tick inputs and elapsed vblanks for the given frame, from the 'used' values in the history.
+// For the very first frame of the loop the previous inputs are the same as the current ones, so nothing registers as just pressed.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void applyFrameInputs(LoopState& loop, const FrameRecord& rec) noexcept {
+    const FrameRecord& prevRec = (rec.frame > 0) ? getRecord(loop, rec.frame - 1) : rec;
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        gTickInputs[playerIdx] = rec.usedInputs[playerIdx];
+        gOldTickInputs[playerIdx] = prevRec.usedInputs[playerIdx];
+        gPlayersElapsedVBlanks[playerIdx] = rec.usedVBlanks[playerIdx];
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends this player's inputs for the specified frame to the other player, or an end marker if the frame is 'END_MARKER_FRAME'
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendFrame(LoopState& loop, const int32_t frame) noexcept {
+    NetPacket_Tick pkt = {};
+    pkt.frame = frame;
+    pkt.hashFrame = -1;
+
+    if (frame != END_MARKER_FRAME) {
+        const FrameRecord& rec = getRecord(loop, frame);
+        pkt.inputs = rec.rawInputs[gCurPlayerIndex];
+        pkt.elapsedVBlanks = rec.rawVBlanks[gCurPlayerIndex];
+        pkt.frameAdvantage = frame - (loop.numRemoteFrames - 1);
+
+        // Include the latest final state hash for the other player to check
+        const int32_t hashFrame = loop.lastFinalHashFrame;
+
+        if (hashFrame >= 0) {
+            const FrameRecord& hashRec = getRecord(loop, hashFrame);
+
+            if ((hashRec.frame == hashFrame) && hashRec.bHasStateHash) {
+                pkt.hashFrame = hashFrame;
+                pkt.errorCheck = hashRec.stateHash;
+            }
+        }
+    }
+
+    pkt.endianCorrect();
+    Network::sendTickPacket(pkt);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Receives one packet from the other player, blocking until it arrives.
+// Records the inputs in the history and notes if any frame was simulated with the wrong inputs.
+// Returns 'false' on a network error or if the other player's frames are out of sequence.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool receiveFrame(LoopState& loop) noexcept {
+    NetPacket_Tick pkt;
+    std::chrono::system_clock::time_point recvTime;
+
+    if (!Network::recvTickPacket(pkt, recvTime))
+        return false;
+
+    Network::requestTickPackets();
+    pkt.endianCorrect();
+
+    // Has the other player finished this game loop?
+    if (pkt.frame == END_MARKER_FRAME) {
+        loop.bRemoteEnded = true;
+        return true;
+    }
+
+    // Frames must always arrive in order and must be within the window that we keep history for
+    if ((pkt.frame != loop.numRemoteFrames) || (pkt.frame > loop.curFrame + MAX_PREDICTION_FRAMES + 1)) {
+        std::printf("Net: rollback received frame %d out of sequence (expected frame %d)!\n", pkt.frame, loop.numRemoteFrames);
+        return false;
+    }
+
+    const int32_t remoteIdx = gCurPlayerIndex ^ 1;
+    FrameRecord& rec = claimRecord(loop, pkt.frame);
+    rec.rawInputs[remoteIdx] = pkt.inputs;
+    rec.rawVBlanks[remoteIdx] = pkt.elapsedVBlanks;
+    rec.bRemoteReceived = true;
+    loop.numRemoteFrames++;
+    loop.remoteFrameAdvantage = pkt.frameAdvantage;
+
+    // Hold onto the other player's state hash until it can be checked
+    if (pkt.hashFrame >= 0) {
+        loop.remoteHashFrame = pkt.hashFrame;
+        loop.remoteHash = pkt.errorCheck;
+    }
+
+    // If the frame was already simulated then check if the prediction was correct
+    if (rec.bSimulated) {
+        const TickInputs actualInputs = getEffectiveInputs(loop, rec.frame, remoteIdx, rec.rawInputs[remoteIdx]);
+        const bool bMispredicted = (
+            (std::memcmp(&actualInputs, &rec.usedInputs[remoteIdx], sizeof(TickInputs)) != 0) ||
+            (rec.rawVBlanks[remoteIdx] != rec.usedVBlanks[remoteIdx])
+        );
+
+        if (bMispredicted) {
+            loop.firstMispredictedFrame = std::min(loop.firstMispredictedFrame, rec.frame);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Receives all packets from the other player which have arrived without blocking.
+// Stops at the end marker for the loop, since anything after that is for the next game loop.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool receiveReadyFrames(LoopState& loop) noexcept {
+    while ((!loop.bRemoteEnded) && Network::isTickPacketReady()) {
+        if (!receiveFrame(loop))
+            return false;
+    }
+
+    return Network::isConnected();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Blocks until the other player's inputs for the given frame have been received.
+// Returns 'false' on a network error, or if the other player finished the game loop before reaching this frame (a desync).
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool waitForRemoteFrame(LoopState& loop, const int32_t frame) noexcept {
+    while (loop.numRemoteFrames <= frame) {
+        if (loop.bRemoteEnded) {
+            std::printf("Net: rollback expected frame %d but the other player ended the game loop!\n", frame);
+            return false;
+        }
+
+        if (!receiveFrame(loop))
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Hashes the game state prior to simulating the given frame, during level gameplay only.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void recordStateHash(const LoopState& loop, FrameRecord& rec) noexcept {
+    rec.bHasStateHash = (loop.bCanPredict && gbIsLevelDataCached);
+
+    if (rec.bHasStateHash) {
+        rec.stateHash = StateHash::compute().combined() ^ (uint32_t) MapHash::gWord1;   // Also check both players are playing the same map
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Checks the last state hash received from the other player against ours for the same frame, once our hash for the frame is final.
+// Returns 'false' if the hashes differ, meaning the game has desynced.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool checkRemoteStateHash(LoopState& loop) noexcept {
+    const int32_t hashFrame = loop.remoteHashFrame;
+
+    if ((hashFrame < 0) || (hashFrame > loop.lastFinalHashFrame))
+        return true;
+
+    loop.remoteHashFrame = -1;
+    const FrameRecord& rec = getRecord(loop, hashFrame);
+
+    if ((rec.frame != hashFrame) || (!rec.bHasStateHash) || (rec.stateHash == loop.remoteHash))
+        return true;
+
+    std::printf(
+        "Net: rollback desync detected! The game state hash for frame %d is 0x%08X but the other player's is 0x%08X.\n",
+        hashFrame,
+        rec.stateHash,
+        loop.remoteHash
+    );
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Takes a snapshot of the game state prior to simulating the given frame
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void takeSnapshot(FrameRecord& rec) noexcept {
+    const rollbackclock_t::time_point startTime = rollbackclock_t::now();
+
+    rec.snapshot.reset();
+    rec.bHasSnapshot = SaveAndLoad::saveSnapshot(rec.snapshot, true);
+    rec.bIsFirstTick = gbIsFirstTick;
+    rec.prevGameTic = gPrevGameTic;
+    rec.lastTgtGameTicCount = gLastTgtGameTicCount;
+
+    gStatsSnapshotTime += rollbackclock_t::now() - startTime;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Restores the game state to what it was prior to simulating the given frame.
+// Returns 'false' if this is not possible, which should never happen.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool restoreSnapshot(const FrameRecord& rec) noexcept {
+    if (!rec.bHasSnapshot)
+        return false;
+
+    const std::vector<std::byte>& snapshotBytes = rec.snapshot.getBytes();
+    ByteInputStream snapshotIn(snapshotBytes.data(), snapshotBytes.size());
+
+    const bool bReadOk = (SaveAndLoad::readSnapshot(snapshotIn, true) == ReadSaveResult::OK);
+    const bool bLoadOk = (bReadOk && (SaveAndLoad::load() == LoadSaveResult::OK));
+    SaveAndLoad::clearBufferedSave();
+
+    // Restore timing state which is not saved (or just defaulted) by the snapshot
+    gbIsFirstTick = rec.bIsFirstTick;
+    gPrevGameTic = rec.prevGameTic;
+    gLastTgtGameTicCount = rec.lastTgtGameTicCount;
+    return bLoadOk;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Restores the game state for the given start frame and re-simulates up to and including the given end frame.
+// Stops early if a frame causes the game loop to exit, in which case the exit action and the frame it happened on are returned.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static gameaction_t resimulate(LoopState& loop, const int32_t startFrame, const int32_t endFrame, int32_t& exitFrame) noexcept {
+    ASSERT(startFrame <= endFrame);
+    const rollbackclock_t::time_point startTime = rollbackclock_t::now();
+
+    // Loading the snapshot clobbers real time related state which must be preserved
+    const uint32_t totalVBlanks = gTotalVBlanks;
+    const uint32_t lastTotalVBlanks = gLastTotalVBlanks;
+    const uint32_t elapsedVBlanks = gElapsedVBlanks;
+    const int64_t levelElapsedTime = Game::getLevelElapsedTimeMicrosecs();
+
+    gbResimulating = true;
+    loop.firstMispredictedFrame = INT32_MAX;
+
+    gameaction_t exitAction = ga_nothing;
+    exitFrame = endFrame;
+
+    // If the game state can't be restored then re-simulating from it would only hide a desync: skip re-simulating and flag the
+    // game as desynced instead, so that the next network update ends the game with an error.
+    const bool bRestoredState = restoreSnapshot(getRecord(loop, startFrame));
+
+    if (!bRestoredState) {
+        std::printf("Net: rollback desync! Failed to restore the game state for frame %d.\n", startFrame);
+        loop.bStateLost = true;
+    }
+
+    for (int32_t frame = startFrame; bRestoredState && (frame <= endFrame); ++frame) {
+        FrameRecord& rec = getRecord(loop, frame);
+
+        // The snapshot and state hash for the first frame are still valid, but the others must be retaken
+        if (frame != startFrame) {
+            rec.bHasSnapshot = false;
+            recordStateHash(loop, rec);
+
+            if (!rec.bRemoteReceived) {
+                takeSnapshot(rec);
+            }
+        }
+
+        // Simulate the frame the same way that 'MiniLoop' does
+        decideFrameInputs(loop, rec);
+        applyFrameInputs(loop, rec);
+        rec.bSimulated = true;
+
+        gElapsedVBlanks = rec.rawVBlanks[gCurPlayerIndex];
+        gGameAction = ga_nothing;
+        D_AdvanceTicCon();
+        exitAction = P_Ticker();
+        gPrevGameTic = gGameTic;
+        gbIsFirstTick = false;
+        gStatsNumResimFrames++;
+
+        if (exitAction != ga_nothing) {
+            exitFrame = frame;
+            break;
+        }
+    }
+
+    gTotalVBlanks = totalVBlanks;
+    gLastTotalVBlanks = lastTotalVBlanks;
+    gElapsedVBlanks = elapsedVBlanks;
+    Game::setLevelElapsedTimeMicrosecs(levelElapsedTime);
+    gbResimulating = false;
+
+    // Update stats
+    const uint32_t numRollbackFrames = (uint32_t)(endFrame - startFrame + 1);
+    gStatsNumRollbacks++;
+    gStatsMaxRollbackFrames = std::max(gStatsMaxRollbackFrames, numRollbackFrames);
+    gStatsResimTime += rollbackclock_t::now() - startTime;
+    return exitAction;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Makes sure that an exit action triggered on the given frame also happens with the other player's real inputs.
+// Waits for the other player's inputs up to the frame and re-simulates (up to the given last frame) if there was a misprediction.
+// Returns the exit action that really happened, which may be 'ga_nothing'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static gameaction_t confirmExitAction(LoopState& loop, gameaction_t exitAction, int32_t exitFrame, const int32_t lastFrame) noexcept {
+    while (exitAction != ga_nothing) {
+        // If there is a network error then just allow the exit: the next network update will report the error
+        if (!waitForRemoteFrame(loop, exitFrame))
+            return exitAction;
+
+        if (loop.firstMispredictedFrame > exitFrame)
+            return exitAction;
+
+        exitAction = resimulate(loop, loop.firstMispredictedFrame, lastFrame, exitFrame);   // Note: no exit if the game state is lost
+    }
+
+    return ga_nothing;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the given frame must wait for the other player's inputs instead of being predicted.
+// This is the case outside of level gameplay, while paused and when the 'pause' or 'menu back' inputs are applied.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool mustWaitForFrame(LoopState& loop, const FrameRecord& rec) noexcept {
+    if ((!loop.bCanPredict) || gbGamePaused)
+        return true;
+
+    const int32_t delayedFrame = rec.frame - PAUSE_INPUT_DELAY;
+
+    if (delayedFrame < 0)
+        return false;
+
+    const FrameRecord& delayedRec = getRecord(loop, delayedFrame);
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        const TickInputs& inputs = delayedRec.rawInputs[playerIdx];
+
+        if (inputs.fTogglePause() || inputs.fMenuBack())
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes rollback for a new network game and sets whether it will be used
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init(const bool bEnable) noexcept {
+    gbEnabled = bEnable;
+    gbResimulating = false;
+    gLoops.clear();
+    resetStats();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if rollback netcode is being used for the current network game
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isEnabled() noexcept {
+    return gbEnabled;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if rollback netcode is being used right now: requires a network game that is not being played back from a demo
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isActive() noexcept {
+    return (gbEnabled && (gNetGame != gt_single) && (!gbDemoPlayback));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if frames are currently being re-simulated, in which case things like sounds and UI toggles should be ignored
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isResimulating() noexcept {
+    return gbResimulating;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called at the start of every game loop. Returns 'true' if rollback is active for the loop, in which case 'endLoop' must be
+// called when the loop finishes.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool beginLoop() noexcept {
+    if (!isActive())
+        return false;
+
+    std::unique_ptr<LoopState>& pLoop = gLoops.emplace_back(std::make_unique<LoopState>());
+    pLoop->curFrame = -1;
+    pLoop->numRemoteFrames = 0;
+    pLoop->firstMispredictedFrame = INT32_MAX;
+    pLoop->remoteFrameAdvantage = 0;
+    pLoop->lastFinalHashFrame = -1;
+    pLoop->remoteHashFrame = -1;
+    pLoop->remoteHash = 0;
+    pLoop->bCanPredict = false;
+    pLoop->bRemoteEnded = false;
+    pLoop->bStateLost = false;
+    pLoop->pendingExitAction = ga_nothing;
+
+    for (FrameRecord& rec : pLoop->history) {
+        rec.frame = -1;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called when a game loop that rollback was active for finishes.
+// Tells the other player that we are done and discards their inputs for the loop until they are also done.
+// If the loop is exiting due to a network error or the app quitting then this step is skipped.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void endLoop(const gameaction_t exitAction) noexcept {
+    if (gLoops.empty())
+        return;
+
+    LoopState& loop = getLoop();
+
+    if ((exitAction != ga_exitdemo) && (exitAction != ga_quitapp) && Network::isConnected()) {
+        sendFrame(loop, END_MARKER_FRAME);
+
+        while ((!loop.bRemoteEnded) && receiveFrame(loop)) {
+            // Discard any inputs the other player sent ahead for this loop, which will never be used now
+        }
+    }
+
+    gLoops.pop_back();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called when level gameplay starts: allows frames to be predicted for the current game loop
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onLevelStart() noexcept {
+    if (!gLoops.empty()) {
+        getLoop().bCanPredict = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Replaces 'I_NetUpdate' when rollback is active.
+// Expects this player's inputs and elapsed vblanks for the new frame to be in 'gTickInputs' and 'gPlayersElapsedVBlanks', and
+// replaces them with the inputs for both players that the frame should be simulated with.
+// Returns 'true' if a network error occurred.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool update() noexcept {
+    if (gLoops.empty())
+        return true;
+
+    LoopState& loop = getLoop();
+
+    // If the game state was lost while confirming an exit action then the game has desynced
+    if (loop.bStateLost)
+        return true;
+
+    const int32_t localIdx = gCurPlayerIndex;
+    const int32_t frame = ++loop.curFrame;
+
+    // Record this player's inputs for the frame and send them
+    FrameRecord& rec = claimRecord(loop, frame);
+    rec.rawInputs[localIdx] = gTickInputs[localIdx];
+    rec.rawVBlanks[localIdx] = gPlayersElapsedVBlanks[localIdx];
+    rec.bSimulated = false;
+    rec.bHasSnapshot = false;
+    sendFrame(loop, frame);
+
+    // Receive whatever has arrived from the other player, and wait for more if we are too far ahead or if the frame can't be predicted
+    if (!receiveReadyFrames(loop))
+        return true;
+
+    if (frame - loop.numRemoteFrames >= MAX_PREDICTION_FRAMES) {
+        gStatsNumPredictionStalls++;
+
+        if (!waitForRemoteFrame(loop, frame - MAX_PREDICTION_FRAMES))
+            return true;
+    }
+
+    if (mustWaitForFrame(loop, rec)) {
+        if (!waitForRemoteFrame(loop, frame))
+            return true;
+    }
+
+    // If there were any mispredictions then rewind and re-simulate up until this frame.
+    // If that causes the game loop to exit (once confirmed) then the exit must happen right away, without running this frame.
+    if (loop.firstMispredictedFrame < frame) {
+        int32_t exitFrame = {};
+        gameaction_t exitAction = resimulate(loop, loop.firstMispredictedFrame, frame - 1, exitFrame);
+        exitAction = confirmExitAction(loop, exitAction, exitFrame, frame - 1);
+
+        if (loop.bStateLost)
+            return true;
+
+        if (exitAction != ga_nothing) {
+            loop.pendingExitAction = exitAction;
+            return false;
+        }
+    }
+
+    // Hash the game state prior to this frame and check the other player's hash, if we now have the final hash for the same frame.
+    // All inputs prior to the last frame received from the other player are now known and have been simulated with.
+    recordStateHash(loop, rec);
+    loop.lastFinalHashFrame = std::min(loop.numRemoteFrames, frame);
+
+    if (!checkRemoteStateHash(loop))
+        return true;
+
+    // Decide on the inputs for this frame and snapshot the game state if they are predicted
+    decideFrameInputs(loop, rec);
+    applyFrameInputs(loop, rec);
+    rec.bSimulated = true;
+    gStatsNumFrames++;
+
+    if (!rec.bRemoteReceived) {
+        takeSnapshot(rec);
+        gStatsNumPredictedFrames++;
+    }
+
+    // The view angle to use for this player: note that unlike lockstep, inputs are not sent one frame ahead
+    if (gbIsLevelDataCached && gPlayers[localIdx].mo) {
+        gPlayerNextTickViewAngle = gPlayers[localIdx].mo->angle + gTickInputs[localIdx].getAnalogTurn();
+    }
+
+    // Time sync: if we are further ahead of the other player than they are of us, then they will speed up their clock.
+    // Conversely if we are further behind then speed up our own clock, gradually, in the same way that lockstep does.
+    const int32_t frameAdvantage = frame - (loop.numRemoteFrames - 1);
+
+    if (loop.remoteFrameAdvantage - frameAdvantage >= TIME_SYNC_THRESHOLD) {
+        gNetTimeAdjustMs += 1;
+    }
+
+    return (!Network::isConnected());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called when the game loop's ticker requests an exit. Makes sure the exit also happens with the other player's real inputs, so that
+// both players always leave the game loop on the same frame. Returns the exit action that really happened, which may be 'ga_nothing'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+gameaction_t confirmGameAction(const gameaction_t action) noexcept {
+    if (gLoops.empty() || gbResimulating || (action == ga_nothing))
+        return action;
+
+    LoopState& loop = getLoop();
+
+    if (loop.curFrame < 0)
+        return action;
+
+    return confirmExitAction(loop, action, loop.curFrame, loop.curFrame);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gets any exit action which was found to have happened when re-simulating frames, and which the game loop should exit with immediately
+//------------------------------------------------------------------------------------------------------------------------------------------
+gameaction_t getPendingExitAction() noexcept {
+    return (!gLoops.empty()) ? getLoop().pendingExitAction : ga_nothing;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints the rollback stats for the current reporting period and then resets them for the next period
+//------------------------------------------------------------------------------------------------------------------------------------------
+void printAndResetStats() noexcept {
+    const double snapshotMs = std::chrono::duration<double, std::milli>(gStatsSnapshotTime).count();
+    const double resimMs = std::chrono::duration<double, std::milli>(gStatsResimTime).count();
+    const double avgRollbackFrames = (gStatsNumRollbacks > 0) ? (double) gStatsNumResimFrames / gStatsNumRollbacks : 0.0;
+
+    std::printf(
+        "Net: rollback ran %u frames (%u predicted, %u stalls at the prediction limit), snapshots took %.1f ms\n",
+        gStatsNumFrames,
+        gStatsNumPredictedFrames,
+        gStatsNumPredictionStalls,
+        snapshotMs
+    );
+
+    std::printf(
+        "Net: rollback did %u rollbacks (%.1f frames on average, %u max), re-simulating %u frames took %.1f ms\n",
+        gStatsNumRollbacks,
+        avgRollbackFrames,
+        gStatsMaxRollbackFrames,
+        gStatsNumResimFrames,
+        resimMs
+    );
+
+    resetStats();
+}
+
+END_NAMESPACE(NetRollback)
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+
+enum gameaction_t : int32_t;
+
+BEGIN_NAMESPACE(NetRollback)
+
+void init(const bool bEnable) noexcept;
+bool isEnabled() noexcept;
+bool isActive() noexcept;
+bool isResimulating() noexcept;
+bool beginLoop() noexcept;
+void endLoop(const gameaction_t exitAction) noexcept;
+void onLevelStart() noexcept;
+bool update() noexcept;
+gameaction_t confirmGameAction(const gameaction_t action) noexcept;
+gameaction_t getPendingExitAction() noexcept;
+void printAndResetStats() noexcept;
+
+END_NAMESPACE(NetRollback)
@@ -0,0 +1,604 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// An alternative transport for network game tick packets which uses UDP instead of TCP.
+//
+// With TCP a single lost segment stalls the lockstep game for both players until it is retransmitted, due to head-of-line blocking.
+// This transport instead sends every tick packet which has not yet been acknowledged by the other player in each datagram (up to a limit).
+// Hence a lost datagram is normally covered by the next one, with no need to wait for a retransmit. If the transport is waiting on the
+// other player, or has unacknowledged packets, it also resends periodically so that progress is made if the last datagram was lost.
+//
+// A simple link simulator is also built in, which can add delay, jitter, loss and reordering to all outgoing datagrams.
+// This allows two local game instances to be soak tested under various network conditions.
+//
+// Notes:
+//  (1) The TCP connection is still used for the initial game setup and remains open for the duration of the game.
+//  (2) The server receives on the same port number as the TCP listen port, and learns the client's UDP endpoint from the first datagram.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "NetUdpTransport.h"
+
+#include "Doom/doomdef.h"
+#include "Endian.h"
+#include "Network.h"
+#include "ProgArgs.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+BEGIN_NAMESPACE(NetUdpTransport)
+
+// Identifies a datagram as a PsyDoom UDP tick datagram: 'PSDU'
+static constexpr uint32_t DATAGRAM_MAGIC = 0x55445350;
+
+// The maximum number of unacknowledged tick packets to send in each datagram, and how many can be outstanding before it's an error
+static constexpr uint32_t MAX_TICKS_PER_DATAGRAM = 8;
+static constexpr uint32_t MAX_UNACKED_TICKS = 256;
+
+// Size of the window of tick packets that can be received ahead of the next one to be consumed
+static constexpr uint32_t RECV_WINDOW_SIZE = 64;
+
+// How often to resend unacknowledged tick packets (or new acknowledgements) if nothing else has been sent.
+// Also how long to wait for a datagram from the other player before giving up and failing.
+static constexpr std::chrono::milliseconds RESEND_INTERVAL = std::chrono::milliseconds(15);
+static constexpr std::chrono::seconds RECV_TIMEOUT = std::chrono::seconds(30);
+
+typedef std::chrono::steady_clock udpclock_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A tick packet sent inside a datagram along with how long ago (in MS) it was first sent, and how many times it was sent before.
+// If the first copy of a tick packet to arrive is not the first one sent then earlier copies were lost (or overtaken), and the age is how
+// much extra latency that added.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct DatagramTick {
+    NetPacket_Tick  packet;         // Note: endian corrected by the user of the transport, not the transport itself
+    uint16_t        ageMs;
+    uint16_t        copyIdx;        // Which copy of the tick packet this is: '0' for the first one sent
+};
+
+static_assert(sizeof(DatagramTick) == 40);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Format for a datagram: only the used portion of the 'ticks' array is sent
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct Datagram {
+    uint32_t        magic;                              // Must be 'DATAGRAM_MAGIC'
+    uint32_t        firstSeq;                           // Sequence number of the first tick packet in this datagram (sequences start at '1')
+    uint32_t        ackSeq;                             // All tick packets up to and including this sequence number were received from the other player
+    uint32_t        timestampUs;                        // Sender's clock when sent (never '0'): echoed back to measure round trip time
+    uint32_t        echoTimestampUs;                    // The newest timestamp received from the other player, or '0' if none
+    uint32_t        echoHoldUs;                         // How long ago the echoed timestamp was received
+    uint16_t        numTicks;                           // How many tick packets are in this datagram
+    uint16_t        reserved;
+    DatagramTick    ticks[MAX_TICKS_PER_DATAGRAM];
+
+    void endianCorrect() noexcept {
+        if constexpr (Endian::isBig()) {
+            Endian::byteSwapInPlace(magic);
+            Endian::byteSwapInPlace(firstSeq);
+            Endian::byteSwapInPlace(ackSeq);
+            Endian::byteSwapInPlace(timestampUs);
+            Endian::byteSwapInPlace(echoTimestampUs);
+            Endian::byteSwapInPlace(echoHoldUs);
+            Endian::byteSwapInPlace(numTicks);
+        }
+    }
+};
+
+static constexpr size_t DATAGRAM_HDR_SIZE = offsetof(Datagram, ticks);
+
+// An outgoing tick packet that has not been acknowledged yet
+struct OutTick {
+    uint32_t                seq;
+    NetPacket_Tick          packet;
+    udpclock_t::time_point  firstSendTime;
+    uint32_t                numSends;
+};
+
+// An incoming tick packet that has been received: a sequence number of '0' means the slot is empty
+struct InTick {
+    uint32_t                                seq;
+    NetPacket_Tick                          packet;
+    std::chrono::system_clock::time_point   receiveTime;
+};
+
+// A datagram which is being held back by the link simulator
+struct SimDatagram {
+    udpclock_t::time_point  releaseTime;
+    uint32_t                size;
+    Datagram                datagram;
+};
+
+// Stats for the current reporting period
+struct Stats {
+    uint32_t    numDatagramsSent;
+    uint32_t    numResends;                 // Datagrams sent due to the resend timer while tick packets were unacknowledged
+    uint32_t    numSimDropped;              // Datagrams dropped by the link simulator
+    uint32_t    numSimReordered;            // Datagrams held back by the link simulator so that later ones overtake it
+    uint32_t    numDatagramsRecv;
+    uint32_t    numTicksRecv;
+    uint32_t    numDuplicateTicks;          // Redundant copies of tick packets already received
+    uint32_t    numRecoveredTicks;          // Tick packets received from a resent copy, because earlier copies were lost or overtaken
+    double      totalLatencyMs;             // Total estimated one way latency (first send to receive) for all tick packets received
+    double      totalLossDelayMs;           // Total latency added by having to wait for resent copies of tick packets
+    double      totalRttMs;
+    uint32_t    numRttSamples;
+};
+
+static std::unique_ptr<asio::ip::udp::socket>  gpSocket;
+static asio::ip::address                        gPeerAddress;               // Only datagrams from this address are accepted
+static asio::ip::udp::endpoint                  gPeerEndpoint;              // Where to send datagrams to
+static bool                                     gbHavePeerEndpoint;         // False until the server receives the first datagram from the client
+static asio::ip::udp::endpoint                  gRecvEndpoint;              // Where the datagram currently being received came from
+static Datagram                                 gRecvDatagram;              // The datagram currently being received
+static bool                                     gbError;
+static udpclock_t::time_point                   gInitTime;
+static udpclock_t::time_point                   gLastSendTime;
+static udpclock_t::time_point                   gLastRecvTime;
+static std::deque<OutTick>                      gUnackedTicks;              // Sent tick packets not yet acknowledged: oldest first
+static uint32_t                                 gNextSendSeq;               // Sequence number for the next tick packet sent
+static uint32_t                                 gLastSentAckSeq;            // The acknowledgement sent in the last datagram
+static InTick                                   gRecvTicks[RECV_WINDOW_SIZE];
+static uint32_t                                 gNextRecvSeq;               // Sequence number of the next tick packet to be consumed
+static uint32_t                                 gRecvContiguousSeq;         // All tick packets up to and including this one have been received
+static uint32_t                                 gPeerTimestampUs;           // Newest timestamp received from the other player ('0' if none)
+static udpclock_t::time_point                   gPeerTimestampRecvTime;     // When the newest timestamp was received
+static double                                   gSmoothedRttMs;
+static std::vector<SimDatagram>                 gSimQueue;
+static std::mt19937                             gSimRng;
+static Stats                                    gStats;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the timestamp to use in datagrams for the given time: this is never '0', which is reserved for 'no timestamp'
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t getTimestampUs(const udpclock_t::time_point time) noexcept {
+    const uint32_t timestamp = (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(time - gInitTime).count();
+    return std::max(timestamp, 1u);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Link simulator: tells if an event with the given percentage chance happens
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool simChance(const int32_t percent) noexcept {
+    return ((percent > 0) && ((int32_t)(gSimRng() % 100) < percent));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends the given datagram immediately; errors are ignored since delivery is not guaranteed anyway
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendDatagramNow(const Datagram& datagram, const uint32_t size) noexcept {
+    asio::error_code error;
+    gpSocket->send_to(asio::buffer(&datagram, size), gPeerEndpoint, 0, error);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Link simulator: drops the given datagram or queues it to be sent after a delay
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void simSendDatagram(const Datagram& datagram, const uint32_t size, const udpclock_t::time_point now) noexcept {
+    if (simChance(ProgArgs::gNetSimLossPercent)) {
+        gStats.numSimDropped++;
+        return;
+    }
+
+    int32_t delayUs = ProgArgs::gNetSimDelayMs * 1000;
+
+    if (ProgArgs::gNetSimJitterMs > 0) {
+        delayUs += std::uniform_int_distribution<int32_t>(-ProgArgs::gNetSimJitterMs * 1000, ProgArgs::gNetSimJitterMs * 1000)(gSimRng);
+    }
+
+    // Reordering: hold the datagram back long enough for the next datagram or two to overtake it
+    if (simChance(ProgArgs::gNetSimReorderPercent)) {
+        delayUs += std::uniform_int_distribution<int32_t>(10'000, 50'000)(gSimRng);
+        gStats.numSimReordered++;
+    }
+
+    SimDatagram& simDatagram = gSimQueue.emplace_back();
+    simDatagram.releaseTime = now + std::chrono::microseconds(std::max(delayUs, 0));
+    simDatagram.size = size;
+    std::memcpy(&simDatagram.datagram, &datagram, size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Link simulator: sends all datagrams which are due to be released, in order of release time
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void simFlushDatagrams(const udpclock_t::time_point now) noexcept {
+    if (gSimQueue.empty())
+        return;
+
+    std::stable_sort(
+        gSimQueue.begin(),
+        gSimQueue.end(),
+        [](const SimDatagram& d1, const SimDatagram& d2) noexcept { return (d1.releaseTime < d2.releaseTime); }
+    );
+
+    size_t numReleased = 0;
+
+    while ((numReleased < gSimQueue.size()) && (gSimQueue[numReleased].releaseTime <= now)) {
+        const SimDatagram& simDatagram = gSimQueue[numReleased];
+        sendDatagramNow(simDatagram.datagram, simDatagram.size);
+        ++numReleased;
+    }
+
+    gSimQueue.erase(gSimQueue.begin(), gSimQueue.begin() + numReleased);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends a datagram to the other player containing the oldest unacknowledged tick packets and the latest acknowledgement
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void sendDatagram() noexcept {
+    // Can't send anything until the other player's UDP endpoint is known
+    if (!gbHavePeerEndpoint)
+        return;
+
+    const udpclock_t::time_point now = udpclock_t::now();
+    const uint32_t numTicks = std::min((uint32_t) gUnackedTicks.size(), MAX_TICKS_PER_DATAGRAM);
+
+    Datagram datagram = {};
+    datagram.magic = DATAGRAM_MAGIC;
+    datagram.firstSeq = (gUnackedTicks.empty()) ? gNextSendSeq : gUnackedTicks.front().seq;
+    datagram.ackSeq = gRecvContiguousSeq;
+    datagram.timestampUs = getTimestampUs(now);
+    datagram.numTicks = (uint16_t) numTicks;
+
+    if (gPeerTimestampUs != 0) {
+        datagram.echoTimestampUs = gPeerTimestampUs;
+        datagram.echoHoldUs = (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(now - gPeerTimestampRecvTime).count();
+    }
+
+    for (uint32_t i = 0; i < numTicks; ++i) {
+        OutTick& outTick = gUnackedTicks[i];
+        const int64_t ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - outTick.firstSendTime).count();
+
+        datagram.ticks[i].packet = outTick.packet;
+        datagram.ticks[i].ageMs = Endian::hostToLittle((uint16_t) std::clamp<int64_t>(ageMs, 0, UINT16_MAX));
+        datagram.ticks[i].copyIdx = Endian::hostToLittle((uint16_t) std::min<uint32_t>(outTick.numSends, UINT16_MAX));
+        outTick.numSends++;
+    }
+
+    datagram.endianCorrect();
+
+    const uint32_t size = (uint32_t)(DATAGRAM_HDR_SIZE + numTicks * sizeof(DatagramTick));
+    gLastSendTime = now;
+    gLastSentAckSeq = gRecvContiguousSeq;
+    gStats.numDatagramsSent++;
+
+    if (ProgArgs::gbNetSimEnabled) {
+        simSendDatagram(datagram, size, now);
+    } else {
+        sendDatagramNow(datagram, size);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Processes the datagram which was just received into 'gRecvDatagram'
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void onDatagramReceived(const size_t size) noexcept {
+    // Validate the datagram and ignore it if it's not from the other player or if it's malformed
+    Datagram& datagram = gRecvDatagram;
+
+    if (size < DATAGRAM_HDR_SIZE)
+        return;
+
+    datagram.endianCorrect();
+
+    const bool bValidDatagram = (
+        (datagram.magic == DATAGRAM_MAGIC) &&
+        (datagram.numTicks <= MAX_TICKS_PER_DATAGRAM) &&
+        (size == DATAGRAM_HDR_SIZE + datagram.numTicks * sizeof(DatagramTick))
+    );
+
+    if (!bValidDatagram)
+        return;
+
+    if (!gbHavePeerEndpoint) {
+        if (gRecvEndpoint.address() != gPeerAddress)
+            return;
+
+        gPeerEndpoint = gRecvEndpoint;
+        gbHavePeerEndpoint = true;
+    }
+    else if (gRecvEndpoint != gPeerEndpoint) {
+        return;
+    }
+
+    const udpclock_t::time_point now = udpclock_t::now();
+    gLastRecvTime = now;
+    gStats.numDatagramsRecv++;
+
+    // Measure the round trip time if our timestamp was echoed back
+    if (datagram.echoTimestampUs != 0) {
+        const uint32_t rttUs = getTimestampUs(now) - datagram.echoTimestampUs - datagram.echoHoldUs;
+
+        if (rttUs < 10'000'000) {
+            const double rttMs = (double) rttUs / 1000.0;
+            gSmoothedRttMs = (gSmoothedRttMs > 0) ? gSmoothedRttMs * 0.875 + rttMs * 0.125 : rttMs;
+            gStats.totalRttMs += rttMs;
+            gStats.numRttSamples++;
+        }
+    }
+
+    gPeerTimestampUs = datagram.timestampUs;
+    gPeerTimestampRecvTime = now;
+
+    // Discard all of our tick packets acknowledged by the other player
+    while ((!gUnackedTicks.empty()) && (gUnackedTicks.front().seq <= datagram.ackSeq)) {
+        gUnackedTicks.pop_front();
+    }
+
+    // Save any new tick packets from the other player
+    const std::chrono::system_clock::time_point receiveTime = std::chrono::system_clock::now();
+
+    for (uint32_t i = 0; i < datagram.numTicks; ++i) {
+        const uint32_t seq = datagram.firstSeq + i;
+
+        if ((seq < gNextRecvSeq) || (seq >= gNextRecvSeq + RECV_WINDOW_SIZE)) {
+            gStats.numDuplicateTicks += (seq < gNextRecvSeq) ? 1 : 0;
+            continue;
+        }
+
+        InTick& inTick = gRecvTicks[seq % RECV_WINDOW_SIZE];
+
+        if (inTick.seq == seq) {
+            gStats.numDuplicateTicks++;
+            continue;
+        }
+
+        inTick.seq = seq;
+        inTick.packet = datagram.ticks[i].packet;
+        inTick.receiveTime = receiveTime;
+
+        // Estimated one way latency is half the round trip time plus how long ago the packet was first sent.
+        // If this is not the first copy sent then the earlier copies were lost or late, and the age is the latency that added.
+        const uint16_t ageMs = Endian::littleToHost(datagram.ticks[i].ageMs);
+        const bool bIsResentCopy = (Endian::littleToHost(datagram.ticks[i].copyIdx) > 0);
+        gStats.numTicksRecv++;
+        gStats.numRecoveredTicks += (bIsResentCopy) ? 1 : 0;
+        gStats.totalLatencyMs += gSmoothedRttMs * 0.5 + ageMs;
+        gStats.totalLossDelayMs += (bIsResentCopy) ? ageMs : 0;
+    }
+
+    while (gRecvTicks[(gRecvContiguousSeq + 1) % RECV_WINDOW_SIZE].seq == gRecvContiguousSeq + 1) {
+        gRecvContiguousSeq++;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Begins asynchronously receiving the next datagram
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void beginReceive() noexcept {
+    try {
+        gpSocket->async_receive_from(
+            asio::buffer(&gRecvDatagram, sizeof(gRecvDatagram)),
+            gRecvEndpoint,
+            [](const asio::error_code& error, const std::size_t bytesRead) noexcept {
+                // Stop if the socket was closed, otherwise ignore errors: some platforms report errors for earlier sends (ICMP port unreachable)
+                if ((error == asio::error::operation_aborted) || (!gpSocket))
+                    return;
+
+                if (!error) {
+                    onDatagramReceived(bytesRead);
+                }
+
+                beginReceive();
+            }
+        );
+    }
+    catch (...) {
+        gbError = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts up the UDP transport, after a TCP connection to the other player has been established.
+// The given IO context must be valid until the transport is shut down.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool init(asio::io_context& ioContext, const asio::ip::address& peerAddress, const bool bIsServer, const uint16_t serverPort) noexcept {
+    shutdown();
+
+    try {
+        if (bIsServer) {
+            // Server: listen on the same port number as the TCP connection and wait to hear from the client
+            gpSocket.reset(new asio::ip::udp::socket(ioContext));
+            gpSocket->open(asio::ip::udp::v6());
+
+            try {
+                gpSocket->set_option(asio::ip::v6_only(false));
+            } catch (...) {
+                // Ignore if not supported on this platform...
+            }
+
+            gpSocket->bind(asio::ip::udp::endpoint(asio::ip::udp::v6(), serverPort));
+            gbHavePeerEndpoint = false;
+        } else {
+            // Client: use any local port and send to the server
+            const asio::ip::udp protocol = (peerAddress.is_v6()) ? asio::ip::udp::v6() : asio::ip::udp::v4();
+            gpSocket.reset(new asio::ip::udp::socket(ioContext));
+            gpSocket->open(protocol);
+            gpSocket->bind(asio::ip::udp::endpoint(protocol, 0));
+            gPeerEndpoint = asio::ip::udp::endpoint(peerAddress, serverPort);
+            gbHavePeerEndpoint = true;
+        }
+    }
+    catch (...) {
+        shutdown();
+        return false;
+    }
+
+    gPeerAddress = peerAddress;
+    gbError = false;
+    gInitTime = udpclock_t::now();
+    gLastSendTime = gInitTime;
+    gLastRecvTime = gInitTime;
+    gNextSendSeq = 1;
+    gNextRecvSeq = 1;
+
+    if (ProgArgs::gbNetSimEnabled) {
+        gSimRng.seed(std::random_device()());
+        std::printf(
+            "Net: UDP link simulator enabled: delay %d ms, jitter %d ms, loss %d%%, reorder %d%%\n",
+            ProgArgs::gNetSimDelayMs,
+            ProgArgs::gNetSimJitterMs,
+            ProgArgs::gNetSimLossPercent,
+            ProgArgs::gNetSimReorderPercent
+        );
+    }
+
+    beginReceive();
+    return (!gbError);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Shuts down the UDP transport (if active) and discards all transport state
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    gpSocket.reset();
+    gPeerAddress = asio::ip::address();
+    gPeerEndpoint = {};
+    gbHavePeerEndpoint = false;
+    gRecvEndpoint = {};
+    gbError = false;
+    gUnackedTicks.clear();
+    gNextSendSeq = 0;
+    gLastSentAckSeq = 0;
+    gNextRecvSeq = 0;
+    gRecvContiguousSeq = 0;
+    gPeerTimestampUs = 0;
+    gSmoothedRttMs = 0;
+    gSimQueue.clear();
+    gStats = {};
+
+    for (InTick& inTick : gRecvTicks) {
+        inTick = {};
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the UDP transport is being used for tick packets
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isActive() noexcept {
+    return (gpSocket != nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Periodic updates for the transport: releases datagrams held back by the link simulator and resends unacknowledged tick packets (or new
+// acknowledgements) if nothing has been sent for a while. Should be called after the IO context has been polled.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void update() noexcept {
+    if (!gpSocket)
+        return;
+
+    const udpclock_t::time_point now = udpclock_t::now();
+
+    if (ProgArgs::gbNetSimEnabled) {
+        simFlushDatagrams(now);
+    }
+
+    const bool bHaveUnackedTicks = (!gUnackedTicks.empty());
+    const bool bHaveNewAck = (gLastSentAckSeq != gRecvContiguousSeq);
+
+    if ((bHaveUnackedTicks || bHaveNewAck) && (now - gLastSendTime >= RESEND_INTERVAL)) {
+        gStats.numResends += (bHaveUnackedTicks) ? 1 : 0;
+        sendDatagram();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sends a tick packet to the other player, along with all the previous tick packets which have not yet been acknowledged.
+// Returns 'false' on failure.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool sendTickPacket(const NetPacket_Tick& packet) noexcept {
+    if ((!gpSocket) || gbError)
+        return false;
+
+    // If the other player has stopped acknowledging packets altogether then the connection is broken
+    if (gUnackedTicks.size() >= MAX_UNACKED_TICKS) {
+        std::printf("Net: too many unacknowledged UDP tick packets, aborting!\n");
+        gbError = true;
+        return false;
+    }
+
+    OutTick& outTick = gUnackedTicks.emplace_back();
+    outTick.seq = gNextSendSeq++;
+    outTick.packet = packet;
+    outTick.firstSendTime = udpclock_t::now();
+    outTick.numSends = 0;
+    sendDatagram();
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the next tick packet from the other player, in order, and blocks until it is available or an error occurs.
+// While waiting, platform updates are done to keep the app responsive and network updates to keep the transport going.
+// Returns 'false' on failure or if nothing is received from the other player for too long.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool recvTickPacket(NetPacket_Tick& packet, std::chrono::system_clock::time_point& receiveTime) noexcept {
+    while (gpSocket && (!gbError)) {
+        InTick& inTick = gRecvTicks[gNextRecvSeq % RECV_WINDOW_SIZE];
+
+        if (inTick.seq == gNextRecvSeq) {
+            packet = inTick.packet;
+            receiveTime = inTick.receiveTime;
+            inTick = {};
+            gNextRecvSeq++;
+            return true;
+        }
+
+        if (udpclock_t::now() - gLastRecvTime > RECV_TIMEOUT) {
+            std::printf("Net: timed out waiting for UDP tick packets from the other player!\n");
+            gbError = true;
+            break;
+        }
+
+        Network::doUpdates();
+        Utils::doPlatformUpdates();
+        Utils::threadYield();
+    }
+
+    packet = {};
+    receiveTime = {};
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the next tick packet has arrived, so that 'recvTickPacket' can be called without blocking
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isTickPacketReady() noexcept {
+    return (gpSocket && (!gbError) && (gRecvTicks[gNextRecvSeq % RECV_WINDOW_SIZE].seq == gNextRecvSeq));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints stats specific to the UDP transport for the current reporting period and then resets them for the next period
+//------------------------------------------------------------------------------------------------------------------------------------------
+void printAndResetStats() noexcept {
+    const double avgRttMs = (gStats.numRttSamples > 0) ? gStats.totalRttMs / gStats.numRttSamples : 0.0;
+    const double avgLatencyMs = (gStats.numTicksRecv > 0) ? gStats.totalLatencyMs / gStats.numTicksRecv : 0.0;
+    const double avgLossDelayMs = (gStats.numTicksRecv > 0) ? gStats.totalLossDelayMs / gStats.numTicksRecv : 0.0;
+
+    std::printf(
+        "Net: UDP sent %u datagrams (%u resends, %u dropped + %u reordered by simulator), received %u datagrams\n",
+        gStats.numDatagramsSent,
+        gStats.numResends,
+        gStats.numSimDropped,
+        gStats.numSimReordered,
+        gStats.numDatagramsRecv
+    );
+
+    std::printf(
+        "Net: UDP received %u tick packets (%u redundant copies, %u from resent copies), avg RTT %.1f ms, "
+        "avg one way latency %.1f ms (%.1f ms added by loss)\n",
+        gStats.numTicksRecv,
+        gStats.numDuplicateTicks,
+        gStats.numRecoveredTicks,
+        avgRttMs,
+        avgLatencyMs,
+        avgLossDelayMs
+    );
+
+    gStats = {};
+}
+
+END_NAMESPACE(NetUdpTransport)
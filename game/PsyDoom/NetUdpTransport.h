@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Macros.h"
+
+// This prevents warnings in ASIO about the Windows SDK target version not being specified
+#if _WIN32
+    #include <sdkddkver.h>
+#endif
+
+#include <asio.hpp>
+#include <chrono>
+#include <cstdint>
+
+struct NetPacket_Tick;
+
+BEGIN_NAMESPACE(NetUdpTransport)
+
+bool init(asio::io_context& ioContext, const asio::ip::address& peerAddress, const bool bIsServer, const uint16_t serverPort) noexcept;
+void shutdown() noexcept;
+bool isActive() noexcept;
+void update() noexcept;
+bool sendTickPacket(const NetPacket_Tick& packet) noexcept;
+bool recvTickPacket(NetPacket_Tick& packet, std::chrono::system_clock::time_point& receiveTime) noexcept;
+bool isTickPacketReady() noexcept;
+void printAndResetStats() noexcept;
+
+END_NAMESPACE(NetUdpTransport)
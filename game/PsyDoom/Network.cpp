@@ -6,6 +6,8 @@
 #include "Input.h"
 #include "NetPacketReader.h"
 #include "NetPacketWriter.h"
+#include "NetRollback.h"
+#include "NetUdpTransport.h"
 #include "ProgArgs.h"
 #include "PsxPadButtons.h"
 #include "PsyQ/LIBETC.h"
@@ -35,6 +37,56 @@ static std::unique_ptr<NetPacketReader<NetPacket_Tick, MAX_TICK_PKTS>>      gTic
 static std::unique_ptr<NetPacketWriter<NetPacket_Tick, MAX_TICK_PKTS>>      gTickPacketWriter;
 static bool                                                                 gbWasWaitForAsyncNetOpAborted;
 
+// Network stats for the current reporting period (printed every so often if enabled)
+static constexpr std::chrono::seconds NET_STATS_PERIOD = std::chrono::seconds(60);
+
+typedef std::chrono::steady_clock netstatsclock_t;
+
+static netstatsclock_t::time_point  gStatsPeriodStartTime;
+static uint32_t                     gStatsNumTickPackets;
+static uint32_t                     gStatsNumStalls;
+static netstatsclock_t::duration    gStatsStallTime;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts a new period for network stats
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void resetStats() noexcept {
+    gStatsPeriodStartTime = netstatsclock_t::now();
+    gStatsNumTickPackets = 0;
+    gStatsNumStalls = 0;
+    gStatsStallTime = {};
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints the network stats for the current period and then starts a new one.
+// The stall time is how long the game was blocked waiting for tick packets from the other player, scaled to a per minute figure.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void printAndResetStats() noexcept {
+    const double periodSecs = std::chrono::duration<double>(netstatsclock_t::now() - gStatsPeriodStartTime).count();
+    const double stallMs = std::chrono::duration<double, std::milli>(gStatsStallTime).count();
+    const double stallMsPerMinute = (periodSecs > 0) ? stallMs * 60.0 / periodSecs : 0.0;
+
+    std::printf(
+        "Net: %s stats for the last %.1f seconds: %u tick packets received, stalled %.0f ms in %u stalls (%.0f ms per minute)\n",
+        (NetUdpTransport::isActive()) ? "UDP" : "TCP",
+        periodSecs,
+        gStatsNumTickPackets,
+        stallMs,
+        gStatsNumStalls,
+        stallMsPerMinute
+    );
+
+    if (NetUdpTransport::isActive()) {
+        NetUdpTransport::printAndResetStats();
+    }
+
+    if (NetRollback::isEnabled()) {
+        NetRollback::printAndResetStats();
+    }
+
+    resetStats();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Checks for user input to cancel an abortable network operation like establishing a connection
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -113,6 +165,7 @@ static void postConnectSetup(asio::ip::tcp::socket& socket) noexcept {
     // Setup the tick packet reader/writers
     gTickPacketReader.reset(new NetPacketReader<NetPacket_Tick, MAX_TICK_PKTS>(*gpSocket));
     gTickPacketWriter.reset(new NetPacketWriter<NetPacket_Tick, MAX_TICK_PKTS>(*gpSocket));
+    resetStats();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -234,6 +287,12 @@ bool initForClient() noexcept {
 // Closes up the current network connection (if any)
 //------------------------------------------------------------------------------------------------------------------------------------------
 void shutdown() noexcept {
+    // Print stats for whatever portion of the current reporting period has elapsed, if a game was played
+    if (ProgArgs::gbPrintNetStats && (gStatsNumTickPackets > 0)) {
+        printAndResetStats();
+    }
+
+    NetUdpTransport::shutdown();
     gpSocket.reset();
     gpIoContext.reset();
 }
@@ -259,6 +318,7 @@ void doUpdates() noexcept {
     if (gpIoContext) {
         gpIoContext->restart();
         gpIoContext->poll();
+        NetUdpTransport::update();
     }
 }
 
@@ -363,6 +423,15 @@ bool sendTickPacket(const NetPacket_Tick& packet) noexcept {
     if (!isConnected())
         return false;
 
+    if (NetUdpTransport::isActive()) {
+        if (!NetUdpTransport::sendTickPacket(packet)) {
+            shutdown();
+            return false;
+        }
+
+        return true;
+    }
+
     if (!gTickPacketWriter->writePacket(packet, nullptr)) {
         shutdown();
         return false;
@@ -373,11 +442,15 @@ bool sendTickPacket(const NetPacket_Tick& packet) noexcept {
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Request that the tick packet buffer be filled as much as possible and kick off as many packet reads as we can.
+// This is not needed for the UDP transport, which is always receiving.
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool requestTickPackets() noexcept {
     if (!isConnected())
         return false;
 
+    if (NetUdpTransport::isActive())
+        return true;
+
     if (!gTickPacketReader->asyncFillPacketBuffer()) {
         shutdown();
         return false;
@@ -394,12 +467,64 @@ bool recvTickPacket(NetPacket_Tick& packet, std::chrono::system_clock::time_poin
     if (!isConnected())
         return false;
 
-    if (!gTickPacketReader->popRequestedPacket(packet, receiveTime, nullptr)) {
+    // Receive the packet and measure how long we were stalled waiting for it
+    const netstatsclock_t::time_point waitStartTime = netstatsclock_t::now();
+    const bool bReceivedPacket = (NetUdpTransport::isActive()) ?
+        NetUdpTransport::recvTickPacket(packet, receiveTime) :
+        gTickPacketReader->popRequestedPacket(packet, receiveTime, nullptr);
+
+    if (!bReceivedPacket) {
         shutdown();
         return false;
     }
 
+    const netstatsclock_t::duration waitTime = netstatsclock_t::now() - waitStartTime;
+    gStatsNumTickPackets++;
+
+    if (waitTime >= std::chrono::milliseconds(1)) {
+        gStatsNumStalls++;
+        gStatsStallTime += waitTime;
+    }
+
+    if (ProgArgs::gbPrintNetStats && (netstatsclock_t::now() - gStatsPeriodStartTime >= NET_STATS_PERIOD)) {
+        printAndResetStats();
+    }
+
     return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if a tick packet from the other player is ready to be read without blocking.
+// Processes pending network events first so that the answer is as up to date as possible.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isTickPacketReady() noexcept {
+    if (!isConnected())
+        return false;
+
+    doUpdates();
+    return (NetUdpTransport::isActive()) ? NetUdpTransport::isTickPacketReady() : gTickPacketReader->hasPacketReady();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Switches over to sending and receiving tick packets via UDP instead of TCP, after the initial game setup has been done over TCP.
+// Both players must do this. If it fails then the connection is killed and 'false' is returned.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool enableUdpTransport() noexcept {
+    if (!isConnected())
+        return false;
+
+    try {
+        const asio::ip::address peerAddress = gpSocket->remote_endpoint().address();
+
+        if (NetUdpTransport::init(*gpIoContext, peerAddress, ProgArgs::gbIsNetServer, ProgArgs::gServerPort))
+            return true;
+    }
+    catch (...) {
+        // Failed to get the other player's address...
+    }
+
+    shutdown();
+    return false;
+}
+
 END_NAMESPACE(Network)
@@ -21,5 +21,7 @@ bool recvBytes(void* pBuffer, const int32_t numBytes) noexcept;
 bool sendTickPacket(const NetPacket_Tick& packet) noexcept;
 bool requestTickPackets() noexcept;
 bool recvTickPacket(NetPacket_Tick& packet, std::chrono::system_clock::time_point& receiveTime) noexcept;
+bool isTickPacketReady() noexcept;
+bool enableUdpTransport() noexcept;
 
 END_NAMESPACE(Network)
@@ -0,0 +1,435 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A low overhead CPU profiler which records named, nested zones on any thread.
+//
+// Code is instrumented with the 'PROFILE_ZONE' macro, which compiles to nothing if the profiler is not built into the engine. At runtime
+// zones are only recorded while the performance counters are being shown or while a trace is being captured, otherwise each zone costs
+// a single relaxed atomic load. Each thread writes the zones it completes to its own fixed size ring buffer without taking any locks,
+// and the game thread drains all of the ring buffers once per frame.
+//
+// Drained zones are used for two things:
+//  (1) An overlay of the most expensive zones (averaged over recent frames) which is shown with the performance counters.
+//  (2) Traces in the Chrome trace event JSON format, which can be viewed in 'chrome://tracing' or the Perfetto UI. A trace is captured
+//      over the whole run when the '-profiletrace' program argument is used, or on demand by using the 'Toggle_ProfilerCapture' control
+//      to start and stop capturing.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "Profiler.h"
+
+#include "Config/Config.h"
+#include "FileUtils.h"
+#include "ProgArgs.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+BEGIN_NAMESPACE(Profiler)
+
+#if PSYDOOM_PROFILER
+
+// How many completed zones each thread can buffer before the game thread next drains them.
+// Zones which do not fit are dropped (and counted).
+static constexpr uint32_t RING_SIZE = 8192;
+
+// The maximum number of zones held in a capture: limits memory usage if a capture is left running for a very long time
+static constexpr size_t MAX_CAPTURED_ZONES = 4 * 1024 * 1024;
+
+// How often (in seconds) the top zones shown in the overlay are updated
+static constexpr double TOP_ZONES_UPDATE_FREQ = 0.5;
+
+std::atomic<bool> gbZonesEnabled;
+
+// A zone which has completed
+struct ZoneEvent {
+    const char*     name;
+    uint64_t        beginNs;
+    uint64_t        endNs;
+};
+
+// A zone which has been captured for trace output, along with the index of the thread it happened on
+struct CapturedZone {
+    ZoneEvent       zone;
+    uint32_t        threadIdx;
+};
+
+// Holds the completed zones for one thread.
+// The thread that owns the buffer is the only writer and the game thread (in 'endFrame') is the only reader.
+struct ThreadBuffer {
+    std::atomic<const char*>    name;
+    std::atomic<uint32_t>       writeIdx;
+    std::atomic<uint32_t>       readIdx;
+    std::atomic<uint32_t>       numDropped;
+    ZoneEvent                   zones[RING_SIZE];
+};
+
+// Running totals for a zone over the current overlay update window
+struct ZoneTotals {
+    uint64_t    totalNs;
+    uint32_t    numCalls;
+};
+
+static std::mutex                                   gThreadBuffersMutex;    // Guards adding to and iterating the list of thread buffers
+static std::vector<std::unique_ptr<ThreadBuffer>>   gThreadBuffers;         // Buffers for all threads that have used the profiler
+static thread_local ThreadBuffer*                   tgpThreadBuffer;        // The buffer for the current thread (created on first use)
+static thread_local const char*                     tgThreadName;           // The name given to the current thread (if any)
+
+static bool                                     gbCapturing;            // True if a trace is being captured
+static uint64_t                                 gCaptureStartNs;        // When the current capture began
+static std::vector<CapturedZone>                gCapturedZones;         // Zones recorded for the current capture
+static uint64_t                                 gNumCaptureZonesLost;   // Zones that could not be captured due to buffers filling up
+
+static std::unordered_map<const char*, ZoneTotals>  gWindowZoneTotals;      // Zone totals for the current overlay update window
+static uint32_t                                     gWindowNumFrames;       // Frames elapsed in the current overlay update window
+static uint64_t                                     gWindowStartNs;         // When the current overlay update window began
+static ZoneSummary                                  gTopZones[MAX_TOP_ZONES];
+static uint32_t                                     gNumTopZones;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the current time in nanoseconds (from an arbitrary point)
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t getTimeNs() noexcept {
+    const auto timeSinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(timeSinceEpoch).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the zone buffer for the calling thread, creating it if it does not exist yet
+//------------------------------------------------------------------------------------------------------------------------------------------
+static ThreadBuffer& getThreadBuffer() noexcept {
+    if (!tgpThreadBuffer) {
+        std::unique_ptr<ThreadBuffer> pBuffer = std::make_unique<ThreadBuffer>();
+        pBuffer->name = tgThreadName;
+        pBuffer->writeIdx = 0;
+        pBuffer->readIdx = 0;
+        pBuffer->numDropped = 0;
+        tgpThreadBuffer = pBuffer.get();
+
+        std::lock_guard<std::mutex> lock(gThreadBuffersMutex);
+        gThreadBuffers.emplace_back(std::move(pBuffer));
+    }
+
+    return *tgpThreadBuffer;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Decides whether zones should be recorded, based on whether anything is using them
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void updateZonesEnabled() noexcept {
+    gbZonesEnabled.store((Config::gbShowPerfCounters || gbCapturing), std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Adds a drained zone to the overlay stats and to the current capture, if capturing
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void addDrainedZone(const ZoneEvent& zone, const uint32_t threadIdx) noexcept {
+    ZoneTotals& totals = gWindowZoneTotals[zone.name];
+    totals.totalNs += zone.endNs - zone.beginNs;
+    totals.numCalls++;
+
+    if (gbCapturing && (zone.beginNs >= gCaptureStartNs)) {
+        if (gCapturedZones.size() < MAX_CAPTURED_ZONES) {
+            gCapturedZones.push_back(CapturedZone{ zone, threadIdx });
+        } else {
+            gNumCaptureZonesLost++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Drains the completed zones of all threads
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void drainThreadBuffers() noexcept {
+    std::lock_guard<std::mutex> lock(gThreadBuffersMutex);
+
+    for (uint32_t threadIdx = 0; threadIdx < (uint32_t) gThreadBuffers.size(); ++threadIdx) {
+        ThreadBuffer& buffer = *gThreadBuffers[threadIdx];
+        const uint32_t writeIdx = buffer.writeIdx.load(std::memory_order_acquire);
+        uint32_t readIdx = buffer.readIdx.load(std::memory_order_relaxed);
+
+        for (; readIdx != writeIdx; ++readIdx) {
+            addDrainedZone(buffer.zones[readIdx % RING_SIZE], threadIdx);
+        }
+
+        buffer.readIdx.store(readIdx, std::memory_order_release);
+
+        if (gbCapturing) {
+            gNumCaptureZonesLost += buffer.numDropped.exchange(0, std::memory_order_relaxed);
+        } else {
+            buffer.numDropped.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Updates the top zones shown in the overlay if enough time has passed, and begins a new overlay update window
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void updateTopZones(const uint64_t nowNs) noexcept {
+    gWindowNumFrames++;
+    const double windowSecs = (double)(nowNs - gWindowStartNs) / 1e9;
+
+    if (windowSecs < TOP_ZONES_UPDATE_FREQ)
+        return;
+
+    // Sort all zones by the total time spent in them and save the most expensive ones
+    std::vector<std::pair<const char*, ZoneTotals>> zones(gWindowZoneTotals.begin(), gWindowZoneTotals.end());
+    std::sort(
+        zones.begin(),
+        zones.end(),
+        [](const auto& zone1, const auto& zone2) noexcept { return (zone1.second.totalNs > zone2.second.totalNs); }
+    );
+
+    gNumTopZones = std::min((uint32_t) zones.size(), MAX_TOP_ZONES);
+
+    for (uint32_t i = 0; i < gNumTopZones; ++i) {
+        ZoneSummary& summary = gTopZones[i];
+        summary.name = zones[i].first;
+        summary.usecPerFrame = (float)((double) zones[i].second.totalNs / 1000.0 / (double) gWindowNumFrames);
+        summary.callsPerFrame = (float)((double) zones[i].second.numCalls / (double) gWindowNumFrames);
+    }
+
+    // Start the next window
+    gWindowZoneTotals.clear();
+    gWindowNumFrames = 0;
+    gWindowStartNs = nowNs;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the path to write an on-demand trace capture to: the first 'PROFILE_TRACE_??.json' file in the user data folder not in use
+//------------------------------------------------------------------------------------------------------------------------------------------
+static std::string getOnDemandTraceFilePath() noexcept {
+    const std::string userDataFolder = Utils::getOrCreateUserDataFolder();
+    std::string filePath;
+
+    for (uint32_t fileNum = 0; fileNum < 100; ++fileNum) {
+        char fileName[64];
+        std::snprintf(fileName, C_ARRAY_SIZE(fileName), "PROFILE_TRACE_%02u.json", fileNum);
+        filePath = userDataFolder + fileName;
+
+        if (!FileUtils::fileExists(filePath.c_str()))
+            break;
+    }
+
+    return filePath;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Writes all of the captured zones to the specified file in the Chrome trace event JSON format
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void writeTraceFile(const char* const filePath) noexcept {
+    std::FILE* const pFile = std::fopen(filePath, "w");
+
+    if (!pFile) {
+        std::printf("Profiler: failed to open trace file '%s' for writing!\n", filePath);
+        return;
+    }
+
+    std::fprintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    // Name each thread (using metadata events) so they are easy to identify in the trace viewer
+    uint32_t numThreads;
+
+    {
+        std::lock_guard<std::mutex> lock(gThreadBuffersMutex);
+        numThreads = (uint32_t) gThreadBuffers.size();
+
+        for (uint32_t threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+            const char* const threadName = gThreadBuffers[threadIdx]->name.load(std::memory_order_relaxed);
+            std::fprintf(
+                pFile,
+                "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"%s (%u)\"}},\n",
+                threadIdx,
+                (threadName) ? threadName : "Thread",
+                threadIdx
+            );
+        }
+    }
+
+    // Write each zone as a complete event with a start time and duration in microseconds
+    for (const CapturedZone& captured : gCapturedZones) {
+        const ZoneEvent& zone = captured.zone;
+        std::fprintf(
+            pFile,
+            "{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f},\n",
+            captured.threadIdx,
+            zone.name,
+            (double)(zone.beginNs - gCaptureStartNs) / 1000.0,
+            (double)(zone.endNs - zone.beginNs) / 1000.0
+        );
+    }
+
+    // Finish up with a process name event, so there is no trailing comma to worry about
+    std::fprintf(pFile, "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"PsyDoom\"}}\n]}\n");
+    std::fclose(pFile);
+
+    std::printf(
+        "Profiler: wrote %zu zones on %u threads to '%s' (%llu zones lost due to full buffers)\n",
+        gCapturedZones.size(),
+        numThreads,
+        filePath,
+        (unsigned long long) gNumCaptureZonesLost
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts capturing zones for trace output
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void beginCapture() noexcept {
+    gbCapturing = true;
+    gCaptureStartNs = getTimeNs();
+    gCapturedZones.clear();
+    gNumCaptureZonesLost = 0;
+    updateZonesEnabled();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Stops capturing zones and writes the trace to the file given by the '-profiletrace' program argument, or to a new file otherwise
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void endCapture() noexcept {
+    drainThreadBuffers();
+
+    if (ProgArgs::gProfileTraceFilePath[0]) {
+        writeTraceFile(ProgArgs::gProfileTraceFilePath);
+    } else {
+        writeTraceFile(getOnDemandTraceFilePath().c_str());
+    }
+
+    gbCapturing = false;
+    gCapturedZones.clear();
+    gCapturedZones.shrink_to_fit();
+    updateZonesEnabled();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called when a zone begins: returns the start time of the zone
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t beginZone() noexcept {
+    return getTimeNs();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called when a zone ends: adds the completed zone to the calling thread's buffer, or drops it if the buffer is full
+//------------------------------------------------------------------------------------------------------------------------------------------
+void endZone(const char* const name, const uint64_t beginNs) noexcept {
+    const uint64_t endNs = getTimeNs();
+    ThreadBuffer& buffer = getThreadBuffer();
+    const uint32_t writeIdx = buffer.writeIdx.load(std::memory_order_relaxed);
+    const uint32_t readIdx = buffer.readIdx.load(std::memory_order_acquire);
+
+    if (writeIdx - readIdx >= RING_SIZE) {
+        buffer.numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.zones[writeIdx % RING_SIZE] = ZoneEvent{ name, beginNs, endNs };
+    buffer.writeIdx.store(writeIdx + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sets the name of the calling thread, as shown in trace output.
+// This is cheap and does not allocate the thread's zone buffer, so it can be called on threads which may never record any zones.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void setThreadName(const char* const name) noexcept {
+    tgThreadName = name;
+
+    if (tgpThreadBuffer) {
+        tgpThreadBuffer->name.store(name, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes the profiler and begins capturing a trace straight away if the '-profiletrace' program argument was given
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init() noexcept {
+    PROFILE_THREAD_NAME("Main");
+
+    gWindowZoneTotals.clear();
+    gWindowNumFrames = 0;
+    gWindowStartNs = getTimeNs();
+    gNumTopZones = 0;
+
+    if (ProgArgs::gProfileTraceFilePath[0]) {
+        beginCapture();
+    } else {
+        updateZonesEnabled();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Stops recording zones and writes out the trace being captured, if any.
+// Thread buffers are kept since other threads may still be running; they are reused if the profiler is initialized again.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    if (gbCapturing) {
+        endCapture();
+    }
+
+    gbZonesEnabled.store(false, std::memory_order_relaxed);
+    gWindowZoneTotals.clear();
+    gNumTopZones = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Must be called by the game thread once per frame: collects the zones completed by all threads and updates the overlay stats
+//------------------------------------------------------------------------------------------------------------------------------------------
+void endFrame() noexcept {
+    // Note: the zones enabled flag is refreshed every frame in case the performance counters were toggled
+    const bool bWereZonesEnabled = gbZonesEnabled.load(std::memory_order_relaxed);
+    updateZonesEnabled();
+
+    if (!bWereZonesEnabled) {
+        gNumTopZones = 0;
+        return;
+    }
+
+    drainThreadBuffers();
+    updateTopZones(getTimeNs());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if a trace is currently being captured
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isCapturing() noexcept {
+    return gbCapturing;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts capturing a trace, or stops the current capture and writes it out.
+// Returns 'true' if a capture was started.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool toggleCapture() noexcept {
+    if (gbCapturing) {
+        endCapture();
+        return false;
+    }
+
+    beginCapture();
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gets the zones with the most time spent in them per frame (most expensive first), averaged over recent frames.
+// Returns the number of zones output, which is '0' if zones are not being recorded.
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getTopZones(ZoneSummary (&zones)[MAX_TOP_ZONES]) noexcept {
+    std::copy(gTopZones, gTopZones + gNumTopZones, zones);
+    return gNumTopZones;
+}
+
+#else   // #if PSYDOOM_PROFILER
+
+// Profiler not built into the engine: these all do nothing
+void init() noexcept {}
+void shutdown() noexcept {}
+void endFrame() noexcept {}
+bool isCapturing() noexcept { return false; }
+bool toggleCapture() noexcept { return false; }
+uint32_t getTopZones([[maybe_unused]] ZoneSummary (&zones)[MAX_TOP_ZONES]) noexcept { return 0; }
+
+#endif  // #if PSYDOOM_PROFILER
+
+END_NAMESPACE(Profiler)
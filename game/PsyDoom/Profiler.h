@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <atomic>
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Macros for instrumenting code with profiler zones.
+// These compile to nothing if the profiler is not built into the engine (via the 'PSYDOOM_INCLUDE_PROFILER' CMake option).
+//
+//  PROFILE_ZONE("Name")            Times the rest of the enclosing scope as a zone with the given name (must be a string literal).
+//  PROFILE_THREAD_NAME("Name")     Names the calling thread in trace output (must be a string literal).
+//------------------------------------------------------------------------------------------------------------------------------------------
+#if PSYDOOM_PROFILER
+    #define PROFILER_CONCAT_IMPL(A, B) A##B
+    #define PROFILER_CONCAT(A, B) PROFILER_CONCAT_IMPL(A, B)
+    #define PROFILE_ZONE(NAME) const Profiler::ScopedZone PROFILER_CONCAT(profilerZone_, __LINE__)(NAME)
+    #define PROFILE_THREAD_NAME(NAME) Profiler::setThreadName(NAME)
+#else
+    #define PROFILE_ZONE(NAME)
+    #define PROFILE_THREAD_NAME(NAME)
+#endif
+
+BEGIN_NAMESPACE(Profiler)
+
+// The maximum number of zones shown in the on-screen overlay
+static constexpr uint32_t MAX_TOP_ZONES = 6;
+
+// Summary of the time spent in a zone, averaged over recent frames
+struct ZoneSummary {
+    const char*     name;
+    float           usecPerFrame;       // Average total time spent in the zone per frame (on all threads)
+    float           callsPerFrame;      // Average number of times the zone was entered per frame
+};
+
+#if PSYDOOM_PROFILER
+
+// Whether zones are currently being recorded: checked by every zone so must be cheap
+extern std::atomic<bool> gbZonesEnabled;
+
+uint64_t beginZone() noexcept;
+void endZone(const char* const name, const uint64_t beginNs) noexcept;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Records the time from construction to destruction as a zone, if zones are being recorded when the zone begins
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct ScopedZone {
+    const char* const   name;
+    uint64_t            beginNs;        // '0' if the zone is not being recorded
+
+    inline ScopedZone(const char* const zoneName) noexcept
+        : name(zoneName)
+        , beginNs(0)
+    {
+        if (gbZonesEnabled.load(std::memory_order_relaxed)) {
+            beginNs = beginZone();
+        }
+    }
+
+    inline ~ScopedZone() noexcept {
+        if (beginNs != 0) {
+            endZone(name, beginNs);
+        }
+    }
+
+    ScopedZone(const ScopedZone& other) = delete;
+    ScopedZone& operator = (const ScopedZone& other) = delete;
+};
+
+void setThreadName(const char* const name) noexcept;
+
+#endif  // #if PSYDOOM_PROFILER
+
+void init() noexcept;
+void shutdown() noexcept;
+void endFrame() noexcept;
+bool isCapturing() noexcept;
+bool toggleCapture() noexcept;
+uint32_t getTopZones(ZoneSummary (&zones)[MAX_TOP_ZONES]) noexcept;
+
+END_NAMESPACE(Profiler)
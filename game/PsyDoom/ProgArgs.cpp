@@ -7,6 +7,7 @@
 #include "WadList.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -21,6 +22,9 @@ BEGIN_NAMESPACE(ProgArgs)
     static constexpr uint16_t DEFAULT_NET_PORT = 1666;
 #endif
 
+// The default port for the spectator relay
+static constexpr uint16_t DEFAULT_RELAY_PORT = DEFAULT_NET_PORT + 1;
+
 // Override path for the game's .cue file; this takes precedence over the setting in the game's config .ini files
 const char* gCueFileOverride;
 
@@ -33,13 +37,38 @@ bool gbHeadlessMode = false;
 const char* gDataDirPath = "";
 
 const char* gPlayDemoFilePath = "";             // The demo file to play and exit
-const char* gSaveDemoResultFilePath = "";       // Path to a json file to save the demo result to
-const char* gCheckDemoResultFilePath = "";      // Path to a json file to read the demo result from and verify a match with
+const char* gBatchDemosListFilePath = "";       // A file listing demos (and optional result files to check) to play one after the other and exit
+const char* gCompactDemoInFilePath = "";        // A demo file to convert to the compact demo format and exit
+const char* gCompactDemoOutFilePath = "";       // Where to save the demo converted to the compact demo format
+SIM_TLS const char* gSaveDemoResultFilePath = "";       // Path to a json file to save the demo result to
+SIM_TLS const char* gCheckDemoResultFilePath = "";      // Path to a json file to read the demo result from and verify a match with
+const char* gSaveStateHashesFilePath = "";      // Path to a file to save the game state hash for each demo tick to
+const char* gCheckStateHashesFilePath = "";     // Path to a file of game state hashes for each demo tick to verify demo playback against
+int32_t     gDemoSeekTick = 0;                  // If non zero fast forward demo playback (with no drawing) to this demo tick
+bool        gbDemoSeekCheck = false;            // If true then seek back after each new demo keyframe and verify the replayed state matches
 bool        gbRecordDemos;                      // True if the game should record demos for every map played
 
 bool        gbIsNetServer   = false;                // True if this peer is a server in a networked game (player 1, waits for client connection)
 bool        gbIsNetClient   = false;                // True if this peer is a client in a networked game (player 2, connects to waiting server)
 uint16_t    gServerPort     = DEFAULT_NET_PORT;     // Port that the server listens on or that the client connects to
+bool        gbNetUseUdp     = false;                // Server only: if true then use UDP instead of TCP for game tick packets (the client follows suit)
+bool        gbNetRollback   = false;                // Server only: if true then use rollback netcode instead of lockstep (the client follows suit)
+bool        gbPrintNetStats = false;                // If true then print network stats for each minute of a networked game
+
+// Settings for spectating games via a relay, which fans out the game streamed to it by one of the players
+bool        gbRunRelay              = false;                // If true then run a headless spectator relay instead of the game
+uint16_t    gRelayPort              = DEFAULT_RELAY_PORT;   // Port that the relay listens on or that taps and spectators connect to
+bool        gbRelayTap              = false;                // If true then stream all games played to the relay
+bool        gbSpectate              = false;                // If true then watch the game being streamed to the relay and exit
+float       gSpectateDelay          = 2.0f;                 // How far behind the streamed game (in seconds) that spectators watch
+int32_t     gRelayLoadTestClients   = 0;                    // If non zero then connect this many dummy spectators to the relay and exit
+
+// Settings for the link simulator used to add delay, jitter, loss and reordering to outgoing UDP datagrams (for testing)
+bool        gbNetSimEnabled         = false;
+int32_t     gNetSimDelayMs          = 0;
+int32_t     gNetSimJitterMs         = 0;
+int32_t     gNetSimLossPercent      = 0;
+int32_t     gNetSimReorderPercent   = 0;
 
 // Cheat: if true then do not spawn any monsters
 bool gbNoMonsters = false;
@@ -56,9 +85,48 @@ bool gbTurboMode = false;
 int32_t gWarpMap = 0;
 skill_t gWarpSkill = sk_hard;
 
+// If true then print music sequencer timing jitter statistics on exit
+bool gbPrintSeqJitterStats = false;
+
+// If true then check sights for map objects in parallel on multiple threads when there are enough of them.
+// Off by default since it has not been shown to be faster than checking sights one after the other.
+bool gbParallelSightChecks = false;
+
+// If true then disable the Vulkan renderer's draw command optimizer (for comparing output and performance)
+bool gbNoDrawCmdOptimizer = false;
+
+// If true then time each Lua script action and print a report of the most expensive actions at the end of each level
+bool gbProfileScripts = false;
+
+// Path to a CSV file to output GPU pass timings and CPU render stage timings to for every frame, empty string if not outputting timings
+const char* gGpuProfileCsvFilePath = "";
+
+// Path to a Chrome trace event JSON file to capture CPU profiler zones to for the entire run, empty string if not capturing
+const char* gProfileTraceFilePath = "";
+
+// If true then print frame scheduler stats (game thread CPU usage and tic deadline lateness) on exit
+bool gbPrintFrameStats = false;
+
+// If true then periodically inject synthetic input events to measure input to present latency, and print the stats on exit
+bool gbMeasureInputLatency = false;
+
+// If true then spawn an animated light in every sector without a special, for benchmarking light thinker updates
+bool gbLightBenchmark = false;
+
+#if PSYDOOM_SIM
+    // PsyDoomSim: how many threads to simulate demos on at once, or '0' to use one thread per logical CPU
+    int32_t gNumSimThreads = 0;
+
+    // PsyDoomSim: if true then play the batch again on a single thread afterwards and check that every demo ends in the same state
+    bool gbSimCheckSerial = false;
+#endif
+
 // Host that the client connects to: private so we don't expose std::string everywhere
 static std::string gServerHost;
 
+// Host of the spectator relay that taps and spectators connect to
+static std::string gRelayHost;
+
 // A list of main IWAD files added by the user, in left to right order.
 // These can be used to modify/override lumps in the existing PSXDOOM.WAD without entirely replacing it.
 // Note that the '-datadir' option must be used to actually play new map files; map data in any main IWAD files added will be ignored.
@@ -105,6 +173,25 @@ static int parseArg_playdemo(const int argc, const char* const* const argv) {
     return 0;
 }
 
+static int parseArg_batchdemos(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-batchdemos") == 0)) {
+        gBatchDemosListFilePath = argv[1];
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_compactdemo(const int argc, const char* const* const argv) {
+    if ((argc >= 3) && (std::strcmp(argv[0], "-compactdemo") == 0)) {
+        gCompactDemoInFilePath = argv[1];
+        gCompactDemoOutFilePath = argv[2];
+        return 3;
+    }
+
+    return 0;
+}
+
 static int parseArg_saveresult(const int argc, const char* const* const argv) {
     if ((argc >= 2) && (std::strcmp(argv[0], "-saveresult") == 0)) {
         gSaveDemoResultFilePath = argv[1];
@@ -123,6 +210,42 @@ static int parseArg_checkresult(const int argc, const char* const* const argv) {
     return 0;
 }
 
+static int parseArg_savehashes(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-savehashes") == 0)) {
+        gSaveStateHashesFilePath = argv[1];
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_checkhashes(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-checkhashes") == 0)) {
+        gCheckStateHashesFilePath = argv[1];
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_demoseekcheck([[maybe_unused]] const int argc, const char* const* const argv) {
+    if (std::strcmp(argv[0], "-demoseekcheck") == 0) {
+        gbDemoSeekCheck = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_demoseek(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-demoseek") == 0)) {
+        gDemoSeekTick = std::max(std::atoi(argv[1]), 0);
+        return 2;
+    }
+
+    return 0;
+}
+
 static int parseArg_record([[maybe_unused]] const int argc, const char* const* const argv) {
     if (std::strcmp(argv[0], "-record") == 0) {
         gbRecordDemos = true;
@@ -227,6 +350,178 @@ static int parseArg_client([[maybe_unused]] const int argc, const char* const* c
     return 0;
 }
 
+static int parseArg_netudp(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-netudp") == 0)) {
+        gbNetUseUdp = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_netrollback(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-netrollback") == 0)) {
+        gbNetRollback = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_netstats(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-netstats") == 0)) {
+        gbPrintNetStats = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_netsim(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-netsim") == 0)) {
+        // Link simulator profiles: delay (MS), jitter (MS), loss (%) and reordering (%)
+        struct NetSimProfile {
+            const char* name;
+            int32_t     settings[4];
+        };
+
+        constexpr NetSimProfile PROFILES[] = {
+            { "lan",        { 1,   1,  0,  0  } },
+            { "broadband",  { 20,  5,  1,  1  } },
+            { "wifi",       { 10,  25, 3,  2  } },
+            { "mobile",     { 60,  40, 5,  5  } },
+            { "bad",        { 120, 60, 15, 10 } },
+        };
+
+        int32_t settings[4] = {};
+        bool bValidProfile = false;
+
+        for (const NetSimProfile& profile : PROFILES) {
+            if (std::strcmp(argv[1], profile.name) == 0) {
+                std::memcpy(settings, profile.settings, sizeof(settings));
+                bValidProfile = true;
+                break;
+            }
+        }
+
+        if (!bValidProfile) {
+            bValidProfile = (
+                (std::sscanf(argv[1], "%d,%d,%d,%d", &settings[0], &settings[1], &settings[2], &settings[3]) == 4) &&
+                (settings[0] >= 0) && (settings[1] >= 0) &&
+                (settings[2] >= 0) && (settings[2] <= 100) &&
+                (settings[3] >= 0) && (settings[3] <= 100)
+            );
+        }
+
+        if (bValidProfile) {
+            gbNetSimEnabled = true;
+            gNetSimDelayMs = settings[0];
+            gNetSimJitterMs = settings[1];
+            gNetSimLossPercent = settings[2];
+            gNetSimReorderPercent = settings[3];
+        } else {
+            std::printf("Bad network simulator profile '%s'! Arg will be ignored...\n", argv[1]);
+        }
+
+        return 2;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: parses a host and optional port number (separated by ':'), leaving the port unchanged if not specified or invalid
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void parseHostAndPort(const char* const arg, std::string& host, uint16_t& port) noexcept {
+    const char* const pFirstColon = std::strchr(arg, ':');
+
+    if (!pFirstColon) {
+        host = arg;
+        return;
+    }
+
+    host = std::string(arg, pFirstColon - arg);
+    bool bValidPort = false;
+
+    try {
+        const int portNum = std::stoi(pFirstColon + 1);
+
+        // Note: the '0' wildcard port is not valid when connecting: only valid for servers
+        if ((portNum >= 1) && (portNum <= UINT16_MAX)) {
+            port = (uint16_t) portNum;
+            bValidPort = true;
+        }
+    } catch (...) {
+        // Ignore..
+    }
+
+    if (!bValidPort) {
+        std::printf("Bad port number '%s'! Arg will be ignored...\n", pFirstColon + 1);
+    }
+}
+
+static int parseArg_relay(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-relay") == 0)) {
+        gbRunRelay = true;
+
+        // Is there a port number following?
+        if ((argc >= 2) && (argv[1][0] != '-')) {
+            const int port = std::atoi(argv[1]);
+
+            if ((port > 0) && (port <= UINT16_MAX)) {
+                gRelayPort = (uint16_t) port;
+            } else {
+                std::printf("Bad relay port number '%s'! Arg will be ignored...\n", argv[1]);
+            }
+
+            return 2;
+        }
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_relaytap(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-relaytap") == 0)) {
+        gbRelayTap = true;
+        parseHostAndPort(argv[1], gRelayHost, gRelayPort);
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_spectate(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-spectate") == 0)) {
+        gbSpectate = true;
+        parseHostAndPort(argv[1], gRelayHost, gRelayPort);
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_spectatedelay(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-spectatedelay") == 0)) {
+        gSpectateDelay = std::clamp((float) std::atof(argv[1]), 0.0f, 600.0f);
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_relayloadtest(const int argc, const char* const* const argv) {
+    if ((argc >= 3) && (std::strcmp(argv[0], "-relayloadtest") == 0)) {
+        gRelayLoadTestClients = std::max(std::atoi(argv[1]), 0);
+        parseHostAndPort(argv[2], gRelayHost, gRelayPort);
+        return 3;
+    }
+
+    return 0;
+}
+
 static int parseArg_file(const int argc, const char* const* const argv) {
     if ((argc >= 2) && (std::strcmp(argv[0], "-file") == 0)) {
         gUserWadFiles.push_back(argv[1]);
@@ -264,45 +559,225 @@ static int parseArg_skill(const int argc, const char* const* const argv) {
     return 0;
 }
 
+static int parseArg_seqjitter(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-seqjitter") == 0)) {
+        gbPrintSeqJitterStats = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_parallelsight(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-parallelsight") == 0)) {
+        gbParallelSightChecks = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_nodrawopt(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-nodrawopt") == 0)) {
+        gbNoDrawCmdOptimizer = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_scriptprofile(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-scriptprofile") == 0)) {
+        gbProfileScripts = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_gpuprofilecsv(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-gpuprofilecsv") == 0)) {
+        gGpuProfileCsvFilePath = argv[1];
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_profiletrace(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-profiletrace") == 0)) {
+        gProfileTraceFilePath = argv[1];
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_framestats(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-framestats") == 0)) {
+        gbPrintFrameStats = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_inputlatency(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-inputlatency") == 0)) {
+        gbMeasureInputLatency = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int parseArg_lightbench(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-lightbench") == 0)) {
+        gbLightBenchmark = true;
+        return 1;
+    }
+
+    return 0;
+}
+
+#if PSYDOOM_SIM
+static int parseArg_threads(const int argc, const char* const* const argv) {
+    if ((argc >= 2) && (std::strcmp(argv[0], "-threads") == 0)) {
+        gNumSimThreads = std::max(std::atoi(argv[1]), 0);
+        return 2;
+    }
+
+    return 0;
+}
+
+static int parseArg_checkserial(const int argc, const char* const* const argv) {
+    if ((argc >= 1) && (std::strcmp(argv[0], "-checkserial") == 0)) {
+        gbSimCheckSerial = true;
+        return 1;
+    }
+
+    return 0;
+}
+#endif
+
 // A list of all the argument parsing functions
 static constexpr ArgParser ARG_PARSERS[] = {
     parseArg_cue,
     parseArg_headless,
     parseArg_datadir,
     parseArg_playdemo,
+    parseArg_batchdemos,
+    parseArg_compactdemo,
     parseArg_saveresult,
     parseArg_checkresult,
+    parseArg_savehashes,
+    parseArg_checkhashes,
+    parseArg_demoseek,
+    parseArg_demoseekcheck,
     parseArg_record,
     parseArg_nomonsters,
     parseArg_pistolstart,
     parseArg_turbo,
     parseArg_server,
     parseArg_client,
+    parseArg_netudp,
+    parseArg_netrollback,
+    parseArg_netstats,
+    parseArg_netsim,
+    parseArg_relay,
+    parseArg_relaytap,
+    parseArg_spectate,
+    parseArg_spectatedelay,
+    parseArg_relayloadtest,
     parseArg_file,
     parseArg_nolauncher,
     parseArg_warp,
-    parseArg_skill
+    parseArg_skill,
+    parseArg_seqjitter,
+    parseArg_parallelsight,
+    parseArg_nodrawopt,
+    parseArg_scriptprofile,
+    parseArg_gpuprofilecsv,
+    parseArg_profiletrace,
+    parseArg_framestats,
+    parseArg_inputlatency,
+    parseArg_lightbench,
+#if PSYDOOM_SIM
+    parseArg_threads,
+    parseArg_checkserial,
+#endif
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Performs additional validation and sanity checks for program arguments to fix some unsupported/invalid combos
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void validateAndSanitizeArgs() noexcept {
-    if (gbHeadlessMode && (!gPlayDemoFilePath[0])) {
-        std::printf("The '-headless' switch can only be used in conjunction with '-playdemo'! Arg will be ignored...\n");
+    if (gBatchDemosListFilePath[0] && gPlayDemoFilePath[0]) {
+        std::printf("Can't use '-batchdemos' in conjunction with '-playdemo'! Arg will be ignored...\n");
+        gBatchDemosListFilePath = "";
+    }
+
+    if (gBatchDemosListFilePath[0] && (gSaveDemoResultFilePath[0] || gCheckDemoResultFilePath[0])) {
+        std::printf("Can't use '-saveresult' or '-checkresult' with '-batchdemos' (result files are specified per demo in the list)! Args will be ignored...\n");
+        gSaveDemoResultFilePath = "";
+        gCheckDemoResultFilePath = "";
+    }
+
+    if (gbHeadlessMode && (!gPlayDemoFilePath[0]) && (!gBatchDemosListFilePath[0]) && (!gCompactDemoInFilePath[0])) {
+        std::printf("The '-headless' switch can only be used in conjunction with '-playdemo', '-batchdemos' or '-compactdemo'! Arg will be ignored...\n");
         gbHeadlessMode = false;
     }
 
+    if ((gDemoSeekTick > 0) && (!gPlayDemoFilePath[0])) {
+        std::printf("The '-demoseek' argument can only be used in conjunction with '-playdemo'! Arg will be ignored...\n");
+        gDemoSeekTick = 0;
+    }
+
+    if (gbDemoSeekCheck && (!gPlayDemoFilePath[0])) {
+        std::printf("The '-demoseekcheck' switch can only be used in conjunction with '-playdemo'! Arg will be ignored...\n");
+        gbDemoSeekCheck = false;
+    }
+
     if (gbRecordDemos && gPlayDemoFilePath[0]) {
         std::printf("Can't use '-record' in conjunction with '-playdemo'! Arg will be ignored...\n");
         gbRecordDemos = false;
     }
 
+    if (gbRecordDemos && gBatchDemosListFilePath[0]) {
+        std::printf("Can't use '-record' in conjunction with '-batchdemos'! Arg will be ignored...\n");
+        gbRecordDemos = false;
+    }
+
     if (gbIsNetClient && gbIsNetServer) {
         std::printf("Can't use '-server' in conjunction with '-client'! Arg will be ignored...\n");
         gbIsNetServer = false;
     }
 
+    if (gbNetUseUdp && (!gbIsNetServer)) {
+        std::printf("The '-netudp' switch can only be used in conjunction with '-server' (the client follows the server)! Arg will be ignored...\n");
+        gbNetUseUdp = false;
+    }
+
+    if (gbNetRollback && (!gbIsNetServer)) {
+        std::printf("The '-netrollback' switch can only be used in conjunction with '-server' (the client follows the server)! Arg will be ignored...\n");
+        gbNetRollback = false;
+    }
+
+    if (gbRelayTap && gbSpectate) {
+        std::printf("Can't use '-relaytap' in conjunction with '-spectate'! Arg will be ignored...\n");
+        gbRelayTap = false;
+    }
+
+    if (gbSpectate && (gbIsNetServer || gbIsNetClient || gPlayDemoFilePath[0] || gBatchDemosListFilePath[0] || gbRecordDemos || (gWarpMap > 0))) {
+        std::printf("The '-spectate' argument can't be used when playing a game or demo! Arg will be ignored...\n");
+        gbSpectate = false;
+    }
+
+    // Stats are always wanted when simulating network conditions, since that is the point of the exercise
+    if (gbNetSimEnabled) {
+        gbPrintNetStats = true;
+    }
+
     if (gbRecordDemos && gSaveDemoResultFilePath[0]) {
         std::printf("Can't use '-saveresult' in conjunction with '-record'! Arg will be ignored...\n");
         gSaveDemoResultFilePath = "";
@@ -313,8 +788,18 @@ static void validateAndSanitizeArgs() noexcept {
         gCheckDemoResultFilePath = "";
     }
 
-    if ((gWarpMap > 0) && gPlayDemoFilePath[0]) {
-        std::printf("The '-warp' argument conflicts with '-playdemo'! Arg will be ignored...\n");
+    if (gSaveStateHashesFilePath[0] && (!gPlayDemoFilePath[0]) && (!gbRecordDemos)) {
+        std::printf("The '-savehashes' argument can only be used in conjunction with '-playdemo' or '-record'! Arg will be ignored...\n");
+        gSaveStateHashesFilePath = "";
+    }
+
+    if (gCheckStateHashesFilePath[0] && (!gPlayDemoFilePath[0])) {
+        std::printf("The '-checkhashes' argument can only be used in conjunction with '-playdemo'! Arg will be ignored...\n");
+        gCheckStateHashesFilePath = "";
+    }
+
+    if ((gWarpMap > 0) && (gPlayDemoFilePath[0] || gBatchDemosListFilePath[0])) {
+        std::printf("The '-warp' argument conflicts with '-playdemo' and '-batchdemos'! Arg will be ignored...\n");
         gWarpMap = 0;
     }
 }
@@ -364,21 +849,52 @@ void shutdown() noexcept {
     gbHeadlessMode = false;
     gDataDirPath = "";
     gPlayDemoFilePath = "";
+    gBatchDemosListFilePath = "";
+    gCompactDemoInFilePath = "";
+    gCompactDemoOutFilePath = "";
     gSaveDemoResultFilePath = "";
     gCheckDemoResultFilePath = "";
+    gSaveStateHashesFilePath = "";
+    gCheckStateHashesFilePath = "";
+    gDemoSeekTick = 0;
+    gbDemoSeekCheck = false;
     gbIsNetServer = false;
     gbIsNetClient = false;
     gServerPort = DEFAULT_NET_PORT;
+    gbNetUseUdp = false;
+    gbNetRollback = false;
+    gbPrintNetStats = false;
+    gbNetSimEnabled = false;
+    gNetSimDelayMs = 0;
+    gNetSimJitterMs = 0;
+    gNetSimLossPercent = 0;
+    gNetSimReorderPercent = 0;
+    gbRunRelay = false;
+    gRelayPort = DEFAULT_RELAY_PORT;
+    gbRelayTap = false;
+    gbSpectate = false;
+    gSpectateDelay = 2.0f;
+    gRelayLoadTestClients = 0;
+    gRelayHost.clear();
     gbNoMonsters = false;
     gbPistolStart = false;
     gbTurboMode = false;
     gUserWadFiles.clear();
+
+    #if PSYDOOM_SIM
+        gNumSimThreads = 0;
+        gbSimCheckSerial = false;
+    #endif
 }
 
 const char* getServerHost() noexcept {
     return gServerHost.c_str();
 }
 
+const char* getRelayHost() noexcept {
+    return gRelayHost.c_str();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Adds user WADs specified via the program argument list to the specified WAD list
 //------------------------------------------------------------------------------------------------------------------------------------------
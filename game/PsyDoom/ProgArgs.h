@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Macros.h"
+#include "Sim/SimTls.h"
 #include <cstdint>
 
 class WadList;
@@ -12,21 +13,57 @@ extern const char*  gCueFileOverride;
 extern bool         gbHeadlessMode;
 extern const char*  gDataDirPath;
 extern const char*  gPlayDemoFilePath;
-extern const char*  gSaveDemoResultFilePath;
-extern const char*  gCheckDemoResultFilePath;
+extern const char*  gBatchDemosListFilePath;
+extern const char*  gCompactDemoInFilePath;
+extern const char*  gCompactDemoOutFilePath;
+extern SIM_TLS const char*  gSaveDemoResultFilePath;
+extern SIM_TLS const char*  gCheckDemoResultFilePath;
+extern const char*  gSaveStateHashesFilePath;
+extern const char*  gCheckStateHashesFilePath;
+extern int32_t      gDemoSeekTick;
+extern bool         gbDemoSeekCheck;
 extern bool         gbRecordDemos;
 extern bool         gbIsNetServer;
 extern bool         gbIsNetClient;
 extern uint16_t     gServerPort;
+extern bool         gbNetUseUdp;
+extern bool         gbNetRollback;
+extern bool         gbPrintNetStats;
+extern bool         gbRunRelay;
+extern uint16_t     gRelayPort;
+extern bool         gbRelayTap;
+extern bool         gbSpectate;
+extern float        gSpectateDelay;
+extern int32_t      gRelayLoadTestClients;
+extern bool         gbNetSimEnabled;
+extern int32_t      gNetSimDelayMs;
+extern int32_t      gNetSimJitterMs;
+extern int32_t      gNetSimLossPercent;
+extern int32_t      gNetSimReorderPercent;
 extern bool         gbNoMonsters;
 extern bool         gbPistolStart;
 extern bool         gbTurboMode;
 extern int32_t      gWarpMap;
 extern skill_t      gWarpSkill;
+extern bool         gbPrintSeqJitterStats;
+extern bool         gbParallelSightChecks;
+extern bool         gbNoDrawCmdOptimizer;
+extern bool         gbProfileScripts;
+extern const char*  gGpuProfileCsvFilePath;
+extern const char*  gProfileTraceFilePath;
+extern bool         gbPrintFrameStats;
+extern bool         gbMeasureInputLatency;
+extern bool         gbLightBenchmark;
+
+#if PSYDOOM_SIM
+    extern int32_t  gNumSimThreads;
+    extern bool     gbSimCheckSerial;
+#endif
 
 void init(const int argc, const char* const* const argv) noexcept;
 void shutdown() noexcept;
 const char* getServerHost() noexcept;
+const char* getRelayHost() noexcept;
 void addWadArgsToList(WadList& wadList) noexcept;
 
 END_NAMESPACE(ProgArgs)
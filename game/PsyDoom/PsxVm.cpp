@@ -11,7 +11,9 @@
 #include "Gpu.h"
 #include "Input.h"
 #include "IsoFileSys.h"
+#include "Profiler.h"
 #include "ProgArgs.h"
+#include "SeqAudioThread.h"
 #include "Spu.h"
 
 #include <SDL.h>
@@ -24,8 +26,12 @@ IsoFileSys  gIsoFileSys;
 Gpu::Core   gGpu;
 Spu::Core   gSpu;
 
-static SDL_AudioDeviceID        gSdlAudioDeviceId;
-static std::recursive_mutex     gSpuMutex;
+static std::recursive_mutex gSpuMutex;
+
+// PsyDoomSim: there is no video, audio or input and only the game disc is used (see 'initDisc')
+#if !PSYDOOM_SIM
+
+static SDL_AudioDeviceID gSdlAudioDeviceId;
 
 // The audio compressor is only needed if we have a floating point SPU
 #if SIMPLE_SPU_FLOAT_SPU
@@ -36,6 +42,9 @@ static std::recursive_mutex     gSpuMutex;
 // A callback invoked by SDL to ask for audio from PsyDoom
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void SdlAudioCallback([[maybe_unused]] void* userData, Uint8* pOutput, int outputSize) noexcept {
+    PROFILE_THREAD_NAME("Audio");
+    PROFILE_ZONE("SdlAudioCallback");
+
     // Ignore invalid requests
     if (outputSize <= 0)
         return;
@@ -46,8 +55,12 @@ static void SdlAudioCallback([[maybe_unused]] void* userData, Uint8* pOutput, in
     // Lock the SPU and generate the requested number of samples
     float* pOutputF = reinterpret_cast<float*>(pOutput);
     PsxVm::LockSpu spuLock;
+    SeqAudioThread::beginAudioRender();
 
     for (uint32_t sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx) {
+        // If the sequencer is being driven by the audio thread then tick it (if it's time to) before generating this sample
+        SeqAudioThread::onOutputSample();
+
         // Get this sample in floating point format
         const Spu::StereoSample sample = Spu::stepCore(gSpu);
 
@@ -70,6 +83,8 @@ static void SdlAudioCallback([[maybe_unused]] void* userData, Uint8* pOutput, in
         pOutputF[1] = sampleR;
         pOutputF += 2;
     }
+
+    SeqAudioThread::endAudioRender(numSamples);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -103,6 +118,41 @@ static void getVramSize(uint16_t& vramW, uint16_t& vramH) noexcept {
     #endif
 }
 
+#endif  // #if !PSYDOOM_SIM
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads the game disc info from the given .cue file and builds up the ISO file system for the disc.
+// This is done as part of 'init' for the game; PsyDoomSim only needs the game disc and just calls this.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void initDisc(const char* const doomCdCuePath) noexcept {
+    // Parse the .cue info for the game disc
+    {
+        std::string parseErrorMsg;
+
+        if (!gDiscInfo.parseFromCueFile(doomCdCuePath, parseErrorMsg)) {
+            FatalErrors::raiseF(
+                "Couldn't open or failed to parse the game disc .cue file '%s'!\nError message: %s",
+                doomCdCuePath,
+                parseErrorMsg.c_str()
+            );
+        }
+    }
+
+    // Build up the ISO file system from the game disc
+    {
+        DiscReader discReader(gDiscInfo);
+
+        if (!gIsoFileSys.build(discReader)) {
+            FatalErrors::raise(
+                "Failed to extract the ISO 9960 filesystem records from the game's disc! "
+                "Is the disc in a strange format, or is the image corrupt?"
+            );
+        }
+    }
+}
+
+#if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Initialize emulated PlayStation system components and use the given .cue file for the game disc
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -132,42 +182,10 @@ bool init(const char* const doomCdCuePath) noexcept {
 
     // Init the audio compressor if using the float SPU (don't need it for the 16-bit SPU)
     #if SIMPLE_SPU_FLOAT_SPU
-        AudioCompressor::init(
-            gAudioCompState,
-            -12.0f,             // thresholdDB
-            10.0f,              // kneeWidthDB
-            2.0f,               // compressionRatio
-            4.0f,               // postGainDB
-            0.150f,             // lpfResponseTime
-            0.002f,             // attackTime
-            0.005f              // releaseTime
-        );
+        AudioCompressor::initWithGameSettings(gAudioCompState);
     #endif
 
-    // Parse the .cue info for the game disc
-    {
-        std::string parseErrorMsg;
-
-        if (!gDiscInfo.parseFromCueFile(doomCdCuePath, parseErrorMsg)) {
-            FatalErrors::raiseF(
-                "Couldn't open or failed to parse the game disc .cue file '%s'!\nError message: %s",
-                doomCdCuePath,
-                parseErrorMsg.c_str()
-            );
-        }
-    }
-
-    // Build up the ISO file system from the game disc
-    {
-        DiscReader discReader(gDiscInfo);
-
-        if (!gIsoFileSys.build(discReader)) {
-            FatalErrors::raise(
-                "Failed to extract the ISO 9960 filesystem records from the game's disc! "
-                "Is the disc in a strange format, or is the image corrupt?"
-            );
-        }
-    }
+    initDisc(doomCdCuePath);
 
     // Setup sound
     SDL_InitSubSystem(SDL_INIT_AUDIO);
@@ -191,6 +209,9 @@ bool init(const char* const doomCdCuePath) noexcept {
         SDL_AudioSpec gotFmt = {};
         gSdlAudioDeviceId = SDL_OpenAudioDevice(nullptr, false, &wantFmt, &gotFmt, false);
 
+        // Decide whether the sequencer is driven by the audio thread: only possible if we actually have an audio device
+        SeqAudioThread::init(Config::gbSequencerOnAudioThread && (gSdlAudioDeviceId != 0), wantFmt.freq);
+
         if (gSdlAudioDeviceId != 0) {
             SDL_PauseAudioDevice(gSdlAudioDeviceId, false);
         }
@@ -211,10 +232,14 @@ void shutdown() noexcept {
         gSdlAudioDeviceId = 0;
     }
 
+    SeqAudioThread::shutdown();
+
     Spu::destroyCore(gSpu);     // Note: no locking of the SPU here because all threads should be done with it at this point
     Gpu::destroyCore(gGpu);
 }
 
+#endif  // #if !PSYDOOM_SIM
+
 void lockSpu() noexcept {
     gSpuMutex.lock();
 }
@@ -26,6 +26,7 @@ extern Gpu::Core    gGpu;
 extern Spu::Core    gSpu;
 
 bool init(const char* const doomCdCuePath) noexcept;
+void initDisc(const char* const doomCdCuePath) noexcept;
 void shutdown() noexcept;
 
 // Fire timer (root counter) related events if appropriate.
@@ -0,0 +1,470 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A module which allows the player to rewind the game in single player, for practicing difficult sections of a map.
+// Keeps a rolling history of game state snapshots for the current level, taken every so many game tics.
+//
+// Snapshots are made using the same serialization as save files, hence only single player is supported.
+// To keep memory usage down, only the oldest snapshot in the history (initially the level's starting state) and the newest snapshot
+// are kept fully decoded. Every other snapshot is stored as a compact delta against the snapshot before it, which is normally very
+// small since most of the map (sectors, lines, sides, idle monsters) doesn't change over the course of a few game tics.
+// The time taken to make each snapshot is measured, and if the average cost per game tic exceeds a budget then snapshots are taken
+// less often to compensate.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "Rewind.h"
+
+#include "ByteInputStream.h"
+#include "ByteVecOutputStream.h"
+#include "Config/Config.h"
+#include "Doom/Base/i_main.h"
+#include "Doom/d_main.h"
+#include "Doom/Game/g_game.h"
+#include "Game.h"
+#include "SaveAndLoad.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+BEGIN_NAMESPACE(Rewind)
+
+// How many tics back each press of the rewind control goes (at least)
+static constexpr int32_t REWIND_STEP_TICS = 2 * TICRATE;
+
+// Limits on how much history is kept: snapshots older than this are discarded, as are the oldest ones if too much memory is used
+static constexpr int32_t MAX_HISTORY_TICS = 120 * TICRATE;
+static constexpr size_t MAX_MEM_USAGE = 64 * 1024 * 1024;
+
+// The budget for how long snapshots can take, averaged out over each game tic.
+// The cost is averaged over a window of this many snapshots, and the snapshot interval is doubled if over budget (up to a limit).
+static constexpr int64_t SNAPSHOT_BUDGET_USEC_PER_TIC = 250;
+static constexpr uint32_t BUDGET_WINDOW_SNAPSHOTS = 8;
+static constexpr int32_t MAX_SNAPSHOT_INTERVAL = 8 * TICRATE;
+
+// Delta encoding: how many matching bytes in a row are needed to end a run of literal bytes.
+// Very short matches are not worth breaking up a literal run for, due to the overhead of encoding run lengths.
+static constexpr size_t DELTA_MIN_MATCH = 8;
+
+typedef std::chrono::steady_clock rewindtimer_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A snapshot of the game state in the rewind history
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct Snapshot {
+    int32_t                 levelTic;       // The level time (in game tics) this snapshot was taken at
+    std::vector<std::byte>  delta;          // Changes relative to the previous snapshot in the history (empty for the oldest snapshot)
+};
+
+static std::deque<Snapshot>     gSnapshots;             // The rewind history: oldest snapshots first
+static std::vector<std::byte>   gOldestState;           // The fully decoded game state for the oldest snapshot in the history
+static std::vector<std::byte>   gNewestState;           // The fully decoded game state for the newest snapshot in the history
+static std::vector<std::byte>   gDecodeBuffer;          // Temporary buffer used for decoding snapshots
+static ByteVecOutputStream      gSaveOutput;            // Output stream that game state is serialized to (reused to avoid reallocations)
+static size_t                   gDeltasSize;            // Total size of all snapshot deltas in the history (bytes)
+static int32_t                  gLevelTic;              // How many game tics of the current level have been simulated (rewinding moves this back)
+static int32_t                  gNextSnapshotTic;       // The level tic at which to take the next snapshot
+static int32_t                  gSnapshotInterval;      // How many tics between snapshots: may be raised above the configured amount to stay in budget
+static char                     gRewindMsg[64];         // Status bar message for rewinding: must remain valid while displayed
+
+// Stats for the current level, reported when the level ends
+static uint32_t     gNumSnapshotsTaken;
+static int64_t      gTotalSnapshotUsec;
+static int64_t      gMaxSnapshotUsec;
+static uint64_t     gTotalStateBytes;
+static uint64_t     gTotalDeltaBytes;
+static int64_t      gWindowSnapshotUsec;                // Time taken by snapshots in the current budget window
+static uint32_t     gWindowNumSnapshots;                // Number of snapshots in the current budget window
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helpers for reading and writing variable length unsigned integers (LEB128) in the delta encoding
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void writeVarUint(std::vector<std::byte>& out, size_t value) noexcept {
+    while (value >= 0x80) {
+        out.push_back((std::byte)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back((std::byte) value);
+}
+
+static bool readVarUint(const std::byte*& pData, const std::byte* const pDataEnd, size_t& valueOut) noexcept {
+    valueOut = 0;
+
+    for (uint32_t shift = 0; (pData < pDataEnd) && (shift < sizeof(size_t) * 8); shift += 7) {
+        const uint8_t byte = (uint8_t) *pData++;
+        valueOut |= (size_t)(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Encodes the changes needed to transform the given reference game state into the given new game state.
+// The encoding is the size of the new state followed by pairs of runs: a run of bytes unchanged from the reference state, followed by a
+// run of literal bytes from the new state. All run lengths are variable length integers.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void encodeDelta(const std::vector<std::byte>& refState, const std::vector<std::byte>& newState, std::vector<std::byte>& deltaOut) noexcept {
+    const std::byte* const pRef = refState.data();
+    const std::byte* const pNew = newState.data();
+    const size_t newSize = newState.size();
+    const size_t cmpSize = std::min(refState.size(), newSize);
+
+    deltaOut.clear();
+    writeVarUint(deltaOut, newSize);
+
+    for (size_t i = 0; i < newSize;) {
+        // Unchanged bytes: compare in 64-bit chunks where possible since the majority of bytes are normally unchanged
+        const size_t matchBeg = i;
+
+        while ((i + 8 <= cmpSize) && (std::memcmp(pRef + i, pNew + i, 8) == 0)) {
+            i += 8;
+        }
+
+        while ((i < cmpSize) && (pRef[i] == pNew[i])) {
+            ++i;
+        }
+
+        // Changed bytes: keep going until there is a long enough run of unchanged bytes, or the end of the new state
+        const size_t literalBeg = i;
+
+        while (i < newSize) {
+            if ((i < cmpSize) && (pRef[i] == pNew[i])) {
+                size_t matchEnd = i;
+
+                while ((matchEnd < cmpSize) && (matchEnd - i < DELTA_MIN_MATCH) && (pRef[matchEnd] == pNew[matchEnd])) {
+                    ++matchEnd;
+                }
+
+                if ((matchEnd - i >= DELTA_MIN_MATCH) || (matchEnd == newSize))
+                    break;
+
+                i = matchEnd;
+            } else {
+                ++i;
+            }
+        }
+
+        writeVarUint(deltaOut, literalBeg - matchBeg);
+        writeVarUint(deltaOut, i - literalBeg);
+        deltaOut.insert(deltaOut.end(), pNew + literalBeg, pNew + i);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Applies changes encoded by 'encodeDelta' to the given reference state to produce the new state.
+// Returns 'false' if the delta is malformed.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool applyDelta(const std::vector<std::byte>& refState, const std::vector<std::byte>& delta, std::vector<std::byte>& newStateOut) noexcept {
+    const std::byte* pDelta = delta.data();
+    const std::byte* const pDeltaEnd = pDelta + delta.size();
+    size_t newSize = 0;
+
+    if (!readVarUint(pDelta, pDeltaEnd, newSize))
+        return false;
+
+    newStateOut.resize(newSize);
+    std::byte* const pNew = newStateOut.data();
+
+    for (size_t i = 0; i < newSize;) {
+        size_t matchLen = 0;
+        size_t literalLen = 0;
+
+        if ((!readVarUint(pDelta, pDeltaEnd, matchLen)) || (!readVarUint(pDelta, pDeltaEnd, literalLen)))
+            return false;
+
+        if ((matchLen > refState.size() - std::min(i, refState.size())) || (matchLen + literalLen > newSize - i))
+            return false;
+
+        if ((size_t)(pDeltaEnd - pDelta) < literalLen)
+            return false;
+
+        std::memcpy(pNew + i, refState.data() + i, matchLen);
+        i += matchLen;
+        std::memcpy(pNew + i, pDelta, literalLen);
+        i += literalLen;
+        pDelta += literalLen;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the total amount of memory used by the rewind history, in bytes
+//------------------------------------------------------------------------------------------------------------------------------------------
+static size_t getMemUsage() noexcept {
+    return gOldestState.size() + gNewestState.size() + gDeltasSize + gSnapshots.size() * sizeof(Snapshot);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Discards the oldest snapshots in the history while there is too much history or memory being used.
+// The second oldest snapshot becomes the oldest each time, by applying its delta to the current oldest state.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void discardOldSnapshots() noexcept {
+    while (gSnapshots.size() > 1) {
+        const bool bTooOld = (gSnapshots.back().levelTic - gSnapshots.front().levelTic > MAX_HISTORY_TICS);
+        const bool bTooBig = (getMemUsage() > MAX_MEM_USAGE);
+
+        if ((!bTooOld) && (!bTooBig))
+            break;
+
+        Snapshot& nextOldest = gSnapshots[1];
+
+        if (!applyDelta(gOldestState, nextOldest.delta, gDecodeBuffer)) {
+            reset();
+            return;
+        }
+
+        gOldestState.swap(gDecodeBuffer);
+        gDeltasSize -= nextOldest.delta.size();
+        nextOldest.delta = {};
+        gSnapshots.pop_front();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Updates the average snapshot cost for the current budget window and takes snapshots less often if the budget is exceeded
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void updateSnapshotBudget(const int64_t snapshotUsec) noexcept {
+    gWindowSnapshotUsec += snapshotUsec;
+    gWindowNumSnapshots++;
+
+    if (gWindowNumSnapshots < BUDGET_WINDOW_SNAPSHOTS)
+        return;
+
+    const int64_t avgUsecPerTic = gWindowSnapshotUsec / ((int64_t) gWindowNumSnapshots * gSnapshotInterval);
+    gWindowSnapshotUsec = 0;
+    gWindowNumSnapshots = 0;
+
+    if ((avgUsecPerTic > SNAPSHOT_BUDGET_USEC_PER_TIC) && (gSnapshotInterval < MAX_SNAPSHOT_INTERVAL)) {
+        gSnapshotInterval = std::min(gSnapshotInterval * 2, MAX_SNAPSHOT_INTERVAL);
+        std::printf(
+            "Rewind: snapshots cost %lld us per tic (budget %lld us), increasing the snapshot interval to %d tics\n",
+            (long long) avgUsecPerTic,
+            (long long) SNAPSHOT_BUDGET_USEC_PER_TIC,
+            gSnapshotInterval
+        );
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Takes a snapshot of the current game state and adds it to the rewind history, discarding old history if required
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void takeSnapshot() noexcept {
+    const rewindtimer_t::time_point startTime = rewindtimer_t::now();
+    gSaveOutput.reset();
+
+    if (!SaveAndLoad::saveSnapshot(gSaveOutput, false))
+        return;
+
+    std::vector<std::byte>& state = gSaveOutput.getBytes();
+    Snapshot& snapshot = gSnapshots.emplace_back();
+    snapshot.levelTic = gLevelTic;
+
+    if (gSnapshots.size() == 1) {
+        gOldestState = state;
+        gNewestState = state;
+    } else {
+        encodeDelta(gNewestState, state, snapshot.delta);
+        snapshot.delta.shrink_to_fit();
+        gDeltasSize += snapshot.delta.size();
+        gNewestState.swap(state);
+    }
+
+    discardOldSnapshots();
+
+    // Update stats and make sure the cost of snapshotting stays within budget
+    const int64_t snapshotUsec = std::chrono::duration_cast<std::chrono::microseconds>(rewindtimer_t::now() - startTime).count();
+    gNumSnapshotsTaken++;
+    gTotalSnapshotUsec += snapshotUsec;
+    gMaxSnapshotUsec = std::max(gMaxSnapshotUsec, snapshotUsec);
+    gTotalStateBytes += gNewestState.size();
+    gTotalDeltaBytes += (gSnapshots.empty()) ? 0 : gSnapshots.back().delta.size();
+    updateSnapshotBudget(snapshotUsec);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Decodes the game state for the snapshot at the given index in the history to the given output buffer
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool decodeSnapshot(const size_t snapshotIdx, std::vector<std::byte>& stateOut) noexcept {
+    if (snapshotIdx + 1 == gSnapshots.size()) {
+        stateOut = gNewestState;
+        return true;
+    }
+
+    stateOut = gOldestState;
+
+    for (size_t i = 1; i <= snapshotIdx; ++i) {
+        if (!applyDelta(stateOut, gSnapshots[i].delta, gDecodeBuffer))
+            return false;
+
+        stateOut.swap(gDecodeBuffer);
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints stats for the snapshots taken during the current level
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void printStats() noexcept {
+    if (gNumSnapshotsTaken == 0)
+        return;
+
+    const double avgSnapshotUsec = (double) gTotalSnapshotUsec / gNumSnapshotsTaken;
+    const double avgUsecPerTic = (double) gTotalSnapshotUsec / std::max(gLevelTic, 1);
+
+    std::printf(
+        "Rewind: %u snapshots taken, avg %.0f us, max %lld us, avg %.1f us per tic, interval %d tics\n",
+        gNumSnapshotsTaken,
+        avgSnapshotUsec,
+        (long long) gMaxSnapshotUsec,
+        avgUsecPerTic,
+        gSnapshotInterval
+    );
+
+    std::printf(
+        "Rewind: avg state size %.1f KiB, avg delta size %.2f KiB, history uses %.2f MiB for %u snapshots\n",
+        (double) gTotalStateBytes / (gNumSnapshotsTaken * 1024.0),
+        (double) gTotalDeltaBytes / (gNumSnapshotsTaken * 1024.0),
+        (double) getMemUsage() / (1024.0 * 1024.0),
+        (uint32_t) gSnapshots.size()
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if rewinding is currently possible.
+// This requires the feature to be enabled, single player and no demo recording or playback (since rewinding would break demo sync).
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isEnabled() noexcept {
+    return (
+        (Config::gRewindSnapshotInterval > 0) &&
+        (gNetGame == gt_single) &&
+        (!gbDemoPlayback) &&
+        (!gbDemoRecording) &&
+        (!Game::gbIsDemoVersion)
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Clears the rewind history and takes the initial snapshot for the level (if rewinding is enabled)
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onLevelStart() noexcept {
+    reset();
+    gNumSnapshotsTaken = 0;
+    gTotalSnapshotUsec = 0;
+    gMaxSnapshotUsec = 0;
+    gTotalStateBytes = 0;
+    gTotalDeltaBytes = 0;
+    gWindowSnapshotUsec = 0;
+    gWindowNumSnapshots = 0;
+    gSnapshotInterval = std::clamp(Config::gRewindSnapshotInterval, 1, MAX_SNAPSHOT_INTERVAL);
+
+    if (isEnabled()) {
+        takeSnapshot();
+        gNextSnapshotTic = gSnapshotInterval;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reports snapshot stats for the level and frees up all memory used for rewinding
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onLevelEnd() noexcept {
+    printStats();
+    reset();
+    gOldestState = {};
+    gNewestState = {};
+    gDecodeBuffer = {};
+    gSaveOutput.getBytes() = {};
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Discards all rewind history; should be called when the game state is changed by means other than simulation (e.g loading a save).
+// The next snapshot is taken on the next game tic.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void reset() noexcept {
+    gSnapshots.clear();
+    gOldestState.clear();
+    gNewestState.clear();
+    gDeltasSize = 0;
+    gLevelTic = 0;
+    gNextSnapshotTic = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Advances the level time by one game tic and takes a snapshot if it's time.
+// Should be called after each game tic is simulated.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void update() noexcept {
+    if (!isEnabled())
+        return;
+
+    gLevelTic++;
+
+    if (gLevelTic >= gNextSnapshotTic) {
+        takeSnapshot();
+        gNextSnapshotTic = gLevelTic + gSnapshotInterval;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Rewinds the game to the newest snapshot which is at least a few seconds old, or the oldest snapshot if there is none that old.
+// Snapshots newer than the one restored are discarded, so that repeated rewinds go progressively further back.
+// Returns 'false' if restoring the snapshot failed midway, in which case the game state is undefined and the level should be restarted.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool rewind() noexcept {
+    if ((!isEnabled()) || gSnapshots.empty())
+        return true;
+
+    // Find the snapshot to go back to
+    const rewindtimer_t::time_point startTime = rewindtimer_t::now();
+    const int32_t tgtLevelTic = gLevelTic - REWIND_STEP_TICS;
+    size_t snapshotIdx = 0;
+
+    for (size_t i = gSnapshots.size(); i-- > 0;) {
+        if (gSnapshots[i].levelTic <= tgtLevelTic) {
+            snapshotIdx = i;
+            break;
+        }
+    }
+
+    // Decode it and discard all the newer snapshots: that part of the timeline no longer happens
+    if (!decodeSnapshot(snapshotIdx, gDecodeBuffer)) {
+        reset();
+        return true;
+    }
+
+    gNewestState.swap(gDecodeBuffer);
+
+    while (gSnapshots.size() > snapshotIdx + 1) {
+        gDeltasSize -= gSnapshots.back().delta.size();
+        gSnapshots.pop_back();
+    }
+
+    // Restore the game state
+    ByteInputStream gameState(gNewestState.data(), gNewestState.size());
+    const bool bReadOk = (SaveAndLoad::readSnapshot(gameState, false) == ReadSaveResult::OK);
+    const bool bLoadOk = (bReadOk && (SaveAndLoad::load() == LoadSaveResult::OK));
+    SaveAndLoad::clearBufferedSave();
+
+    if (!bLoadOk) {
+        reset();
+        return false;
+    }
+
+    // Move the level time back and report what happened
+    const int32_t rewoundTics = gLevelTic - gSnapshots.back().levelTic;
+    gLevelTic = gSnapshots.back().levelTic;
+    gNextSnapshotTic = gLevelTic + gSnapshotInterval;
+
+    const double rewindMs = std::chrono::duration<double, std::milli>(rewindtimer_t::now() - startTime).count();
+    std::printf("Rewind: went back %d tics in %.1f ms (%u snapshots remaining)\n", rewoundTics, rewindMs, (uint32_t) gSnapshots.size());
+    std::snprintf(gRewindMsg, sizeof(gRewindMsg), "Rewound %.1f seconds", (double) rewoundTics / TICRATE);
+    gPlayers[gCurPlayerIndex].message = gRewindMsg;
+    return true;
+}
+
+END_NAMESPACE(Rewind)
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Macros.h"
+
+BEGIN_NAMESPACE(Rewind)
+
+bool isEnabled() noexcept;
+void onLevelStart() noexcept;
+void onLevelEnd() noexcept;
+void reset() noexcept;
+void update() noexcept;
+bool rewind() noexcept;
+
+END_NAMESPACE(Rewind)
@@ -5,8 +5,10 @@
 #include "SaveAndLoad.h"
 
 #include "Doom/Base/s_sound.h"
+#include "Doom/Base/w_wad.h"
 #include "Doom/Base/z_zone.h"
 #include "Doom/Game/g_game.h"
+#include "Doom/Game/p_blockthings.h"
 #include "Doom/Game/p_ceiling.h"
 #include "Doom/Game/p_floor.h"
 #include "Doom/Game/p_lights.h"
@@ -27,34 +29,36 @@
 #include "ScriptingEngine.h"
 #include "Utils.h"
 
+#include <algorithm>
+
 BEGIN_NAMESPACE(SaveAndLoad)
 
 // Save/load accelerator LUT: maps from a map object to it's index in the global linked list of map objects
-std::unordered_map<mobj_t*, int32_t> gMobjToIdx;
+SIM_TLS std::unordered_map<mobj_t*, int32_t> gMobjToIdx;
 
 // Save/load accelerator LUT: maps from a map object index to it's pointer
-std::vector<mobj_t*> gMobjList;
+SIM_TLS std::vector<mobj_t*> gMobjList;
 
 // Used during loading and saving: keeps track globally which slot is being used
-SaveFileSlot gCurSaveSlot = SaveFileSlot::NONE;
+SIM_TLS SaveFileSlot gCurSaveSlot = SaveFileSlot::NONE;
 
 // LUTS for thinkers of various types: used during saving and loading
-static std::vector<vldoor_t*>           gVlDoors;
-static std::vector<vlcustomdoor_t*>     gVlCustomDoors;
-static std::vector<floormove_t*>        gFloorMovers;
-static std::vector<ceiling_t*>          gCeilings;
-static std::vector<plat_t*>             gPlats;
-static std::vector<fireflicker_t*>      gFireFlickers;
-static std::vector<lightflash_t*>       gLightFlashes;
-static std::vector<strobe_t*>           gStrobes;
-static std::vector<glow_t*>             gGlows;
-static std::vector<delayaction_t*>      gDelayedExits;
+static SIM_TLS std::vector<vldoor_t*>           gVlDoors;
+static SIM_TLS std::vector<vlcustomdoor_t*>     gVlCustomDoors;
+static SIM_TLS std::vector<floormove_t*>        gFloorMovers;
+static SIM_TLS std::vector<ceiling_t*>          gCeilings;
+static SIM_TLS std::vector<plat_t*>             gPlats;
+static SIM_TLS std::vector<fireflicker_t*>      gFireFlickers;
+static SIM_TLS std::vector<lightflash_t*>       gLightFlashes;
+static SIM_TLS std::vector<strobe_t*>           gStrobes;
+static SIM_TLS std::vector<glow_t*>             gGlows;
+static SIM_TLS std::vector<delayaction_t*>      gDelayedExits;
 
 // A list of buttons that are active: used during saving
-static std::vector<button_t*> gActiveButtons;
+static SIM_TLS std::vector<button_t*> gActiveButtons;
 
 // Used during loading, the input save data loaded into memory
-static SaveData gSaveDataIn;
+static SIM_TLS SaveData gSaveDataIn;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Removes all map objects from the game
@@ -72,6 +76,21 @@ static void removeAllMobj() noexcept {
     // Sanity check it all went OK
     ASSERT(gMobjHead.next == &gMobjHead);
     ASSERT(gMobjHead.prev == &gMobjHead);
+
+    // Clear the heads of all sector and blockmap thing lists. Normally they would all be empty by now but in rare cases, which demos rely on,
+    // the original code can leave things in these lists after they are unlinked (see 'p_blockthings.h').
+    const int32_t numSectors = gNumSectors;
+    sector_t* const pSectors = gpSectors;
+
+    for (int32_t i = 0; i < numSectors; ++i) {
+        pSectors[i].thinglist = nullptr;
+    }
+
+    const int32_t numBlockCells = gBlockmapWidth * gBlockmapHeight;
+
+    for (int32_t i = 0; i < numBlockCells; ++i) {
+        gppBlockLinks[i] = nullptr;
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -89,6 +108,7 @@ static void removeAllThinkers() noexcept {
 
     gThinkerCap.next = &gThinkerCap;
     gThinkerCap.prev = &gThinkerCap;
+    P_InvalidateLightThinkerRuns();
 
     // Sectors are no longer associated with any thinkers
     const int32_t numSectors = gNumSectors;
@@ -155,6 +175,7 @@ static void allocMobjsToLoad() noexcept {
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Allocates thinkers of the specified type that are to be loaded and places pointers to them in the specified list.
+// Note: the thinkers are not added to the list of thinkers yet, see 'addThinkersToLoad'.
 //------------------------------------------------------------------------------------------------------------------------------------------
 template <class ThinkerT>
 static void allocThinkersToLoad(std::vector<ThinkerT*>& outputList, const uint32_t amt) noexcept {
@@ -163,11 +184,87 @@ static void allocThinkersToLoad(std::vector<ThinkerT*>& outputList, const uint32
 
     for (uint32_t i = 0; i < amt; ++i) {
         ThinkerT& thinker = *(ThinkerT*) Z_ZeroedMalloc(*gpMainMemZone, sizeof(ThinkerT), PU_LEVSPEC, nullptr);
-        P_AddThinker(thinker.thinker);
         outputList.push_back(&thinker);
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: returns the thinker at the specified index in a list of thinkers to be loaded, or 'nullptr' if the index is out of range
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class ThinkerT>
+static thinker_t* getThinkerAtIdx(const std::vector<ThinkerT*>& thinkers, const uint32_t idx) noexcept {
+    return (idx < thinkers.size()) ? &thinkers[idx]->thinker : nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the thinker that a saved thinker reference refers to, or 'nullptr' if the reference is invalid.
+// Expects the thinkers to be loaded to be allocated.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static thinker_t* getThinkerToLoad(const SavedThinkerRefT& thinkerRef) noexcept {
+    switch (thinkerRef.type) {
+        case SavedThinkerType::VlDoor:          return getThinkerAtIdx(gVlDoors, thinkerRef.idx);
+        case SavedThinkerType::VlCustomDoor:    return getThinkerAtIdx(gVlCustomDoors, thinkerRef.idx);
+        case SavedThinkerType::FloorMover:      return getThinkerAtIdx(gFloorMovers, thinkerRef.idx);
+        case SavedThinkerType::Ceiling:         return getThinkerAtIdx(gCeilings, thinkerRef.idx);
+        case SavedThinkerType::Plat:            return getThinkerAtIdx(gPlats, thinkerRef.idx);
+        case SavedThinkerType::FireFlicker:     return getThinkerAtIdx(gFireFlickers, thinkerRef.idx);
+        case SavedThinkerType::LightFlash:      return getThinkerAtIdx(gLightFlashes, thinkerRef.idx);
+        case SavedThinkerType::Strobe:          return getThinkerAtIdx(gStrobes, thinkerRef.idx);
+        case SavedThinkerType::Glow:            return getThinkerAtIdx(gGlows, thinkerRef.idx);
+        case SavedThinkerType::DelayedExit:     return getThinkerAtIdx(gDelayedExits, thinkerRef.idx);
+        case SavedThinkerType::NUM_TYPES:       break;
+    }
+
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Adds the specified thinkers to the list of thinkers, skipping any that have already been added
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class ThinkerT>
+static void addThinkersNotYetAdded(const std::vector<ThinkerT*>& thinkers) noexcept {
+    for (ThinkerT* const pThinker : thinkers) {
+        if (!pThinker->thinker.next) {
+            P_AddThinker(pThinker->thinker);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Adds all of the allocated thinkers to be loaded to the list of thinkers.
+// If the exact order of the thinker list was saved (snapshots) then that order is restored, otherwise thinkers are grouped by type.
+// Returns 'false' if the saved order of the thinker list has invalid or duplicate references to thinkers.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool addThinkersToLoad(const SavedListOrder* const pListOrder) noexcept {
+    bool bValidOrder = true;
+
+    if (pListOrder) {
+        const uint32_t numThinkers = pListOrder->hdr.numThinkers;
+
+        for (uint32_t i = 0; i < numThinkers; ++i) {
+            thinker_t* const pThinker = getThinkerToLoad(pListOrder->thinkers[i]);
+
+            if (pThinker && (!pThinker->next)) {
+                P_AddThinker(*pThinker);
+            } else {
+                bValidOrder = false;
+            }
+        }
+    }
+
+    addThinkersNotYetAdded(gVlDoors);
+    addThinkersNotYetAdded(gVlCustomDoors);
+    addThinkersNotYetAdded(gFloorMovers);
+    addThinkersNotYetAdded(gCeilings);
+    addThinkersNotYetAdded(gPlats);
+    addThinkersNotYetAdded(gFireFlickers);
+    addThinkersNotYetAdded(gLightFlashes);
+    addThinkersNotYetAdded(gStrobes);
+    addThinkersNotYetAdded(gGlows);
+    addThinkersNotYetAdded(gDelayedExits);
+    return bValidOrder;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Allocates room for all of the buttons to be loaded
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -432,6 +529,124 @@ static void deserializeObjects(const std::unique_ptr<SrcT>& pSrcObjs, const std:
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: records references to all of the thinkers in a list of thinkers of a particular type, keyed by the thinker
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class ThinkerT>
+static void addThinkerRefs(
+    std::unordered_map<const thinker_t*, SavedThinkerRefT>& thinkerRefs,
+    const std::vector<ThinkerT*>& thinkers,
+    const SavedThinkerType type
+) noexcept {
+    const uint32_t numThinkers = (uint32_t) thinkers.size();
+
+    for (uint32_t i = 0; i < numThinkers; ++i) {
+        thinkerRefs[&thinkers[i]->thinker] = SavedThinkerRefT{ type, i };
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: saves the thing at the head of each non-empty thing list in the given array of lists
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class GetListHeadT>
+static void serializeThingListHeads(
+    const int32_t numLists,
+    const GetListHeadT& getListHead,
+    std::unique_ptr<SavedThingListHeadT[]>& dstHeads,
+    uint32_t& numDstHeads
+) noexcept {
+    std::vector<SavedThingListHeadT> heads;
+
+    for (int32_t listIdx = 0; listIdx < numLists; ++listIdx) {
+        // Note: the list head might not be a valid map object in rare cases, see 'removeAllMobj'
+        const auto mobjIter = gMobjToIdx.find(getListHead(listIdx));
+
+        if (mobjIter != gMobjToIdx.end()) {
+            heads.push_back({ listIdx, mobjIter->second });
+        }
+    }
+
+    numDstHeads = (uint32_t) heads.size();
+    dstHeads = std::make_unique<SavedThingListHeadT[]>(numDstHeads);
+    std::copy(heads.begin(), heads.end(), dstHeads.get());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Snapshot helper: saves the exact order of the thinker list along with the links and heads of all sector and blockmap thing lists.
+// Expects the map object LUTs and the lists of thinkers of each type to be built.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void serializeListOrder(SavedListOrder& listOrder) noexcept {
+    // Save a reference to each thinker that is being saved, in thinker list order
+    std::unordered_map<const thinker_t*, SavedThinkerRefT> thinkerRefs;
+    addThinkerRefs(thinkerRefs, gVlDoors, SavedThinkerType::VlDoor);
+    addThinkerRefs(thinkerRefs, gVlCustomDoors, SavedThinkerType::VlCustomDoor);
+    addThinkerRefs(thinkerRefs, gFloorMovers, SavedThinkerType::FloorMover);
+    addThinkerRefs(thinkerRefs, gCeilings, SavedThinkerType::Ceiling);
+    addThinkerRefs(thinkerRefs, gPlats, SavedThinkerType::Plat);
+    addThinkerRefs(thinkerRefs, gFireFlickers, SavedThinkerType::FireFlicker);
+    addThinkerRefs(thinkerRefs, gLightFlashes, SavedThinkerType::LightFlash);
+    addThinkerRefs(thinkerRefs, gStrobes, SavedThinkerType::Strobe);
+    addThinkerRefs(thinkerRefs, gGlows, SavedThinkerType::Glow);
+    addThinkerRefs(thinkerRefs, gDelayedExits, SavedThinkerType::DelayedExit);
+
+    listOrder.thinkers = std::make_unique<SavedThinkerRefT[]>(thinkerRefs.size());
+    uint32_t numThinkers = 0;
+
+    for (thinker_t* pThinker = gThinkerCap.next; pThinker != &gThinkerCap; pThinker = pThinker->next) {
+        const auto refIter = thinkerRefs.find(pThinker);
+
+        if (refIter != thinkerRefs.end()) {
+            listOrder.thinkers[numThinkers++] = refIter->second;
+        }
+    }
+
+    listOrder.hdr.numThinkers = numThinkers;
+
+    // Save the thing list links for each map object and the heads of all the lists
+    serializeObjects(gMobjList, listOrder.mobjLinks);
+
+    serializeThingListHeads(
+        gNumSectors,
+        [](const int32_t sectorIdx) noexcept { return gpSectors[sectorIdx].thinglist; },
+        listOrder.sectorListHeads,
+        listOrder.hdr.numSectorListHeads
+    );
+
+    serializeThingListHeads(
+        gBlockmapWidth * gBlockmapHeight,
+        [](const int32_t cellIdx) noexcept { return gppBlockLinks[cellIdx]; },
+        listOrder.blockListHeads,
+        listOrder.hdr.numBlockListHeads
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Snapshot helper: validates the saved links and heads of all sector and blockmap thing lists.
+// Note: the saved order of the thinker list is validated when adding the thinkers, by 'addThinkersToLoad'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool validateListOrder(const SavedListOrder& listOrder, const uint32_t numMobjs) noexcept {
+    for (uint32_t i = 0; i < numMobjs; ++i) {
+        if (!listOrder.mobjLinks[i].validate())
+            return false;
+    }
+
+    const auto validateListHeads = [=](const SavedThingListHeadT* const pHeads, const uint32_t numHeads, const int32_t numLists) noexcept {
+        for (uint32_t i = 0; i < numHeads; ++i) {
+            const SavedThingListHeadT& head = pHeads[i];
+
+            if ((head.listIdx < 0) || (head.listIdx >= numLists) || (head.mobjIdx < 0) || ((uint32_t) head.mobjIdx >= numMobjs))
+                return false;
+        }
+
+        return true;
+    };
+
+    return (
+        validateListHeads(listOrder.sectorListHeads.get(), listOrder.hdr.numSectorListHeads, gNumSectors) &&
+        validateListHeads(listOrder.blockListHeads.get(), listOrder.hdr.numBlockListHeads, gBlockmapWidth * gBlockmapHeight)
+    );
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Load helper: if the specified CD track is valid, plays it if not already playing.
 // If the CD track given is NOT valid then this function will instead stop any currently playing CD track.
@@ -474,12 +689,32 @@ static void addActiveCeilingsAndPlats() noexcept {
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Load helper: add all map objects into the world (registers with sectors and the blockmap)
+// Load helper: add all map objects into the world (registers with sectors and the blockmap).
+// If the exact links of the sector and blockmap thing lists were saved (snapshots) then those are restored instead of relinking things.
 //------------------------------------------------------------------------------------------------------------------------------------------
-static void addMobjsToSectors() noexcept {
-    for (mobj_t* const pMobj : gMobjList) {
-        P_SetThingPosition(*pMobj);
+static void addMobjsToSectors(const SavedListOrder* const pListOrder) noexcept {
+    if (!pListOrder) {
+        for (mobj_t* const pMobj : gMobjList) {
+            P_SetThingPosition(*pMobj);
+        }
+
+        return;
+    }
+
+    // Note: the subsector for each thing is restored as part of the thing itself
+    deserializeObjects(pListOrder->mobjLinks, gMobjList);
+
+    for (uint32_t i = 0; i < pListOrder->hdr.numSectorListHeads; ++i) {
+        const SavedThingListHeadT& head = pListOrder->sectorListHeads[i];
+        gpSectors[head.listIdx].thinglist = gMobjList[head.mobjIdx];
+    }
+
+    for (uint32_t i = 0; i < pListOrder->hdr.numBlockListHeads; ++i) {
+        const SavedThingListHeadT& head = pListOrder->blockListHeads[i];
+        gppBlockLinks[head.listIdx] = gMobjList[head.mobjIdx];
     }
+
+    P_BlockThingsRebuild();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -512,9 +747,9 @@ static void associateThinkersWithSectors(const std::vector<ThinkerT*>& thinkers)
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Attempts to save the game to the specified output file
+// Saves the game to the specified output stream, optionally including the extra state for in-memory snapshots
 //------------------------------------------------------------------------------------------------------------------------------------------
-bool save(OutputStream& out) noexcept {
+static bool saveImpl(OutputStream& out, const bool bIsSnapshot, const bool bIncludeNetState) noexcept {
     // Build required LUTs
     buildMobjLuts(8192);
     gatherThinkersOfType(T_VerticalDoor, gVlDoors, 128);
@@ -552,11 +787,37 @@ bool save(OutputStream& out) noexcept {
     serializeObjects(gActiveButtons, saveData.buttons);
     serializeObjects(ScriptingEngine::gScheduledActions.data(), saveData.scheduledActions, hdr.numScheduledActions);
 
+    if (bIsSnapshot) {
+        saveData.listOrder = std::make_unique<SavedListOrder>();
+        serializeListOrder(*saveData.listOrder);
+    }
+
+    if (bIncludeNetState) {
+        saveData.netState = std::make_unique<SavedNetState>();
+        saveData.netState->serializeFromGlobals();
+    }
+
     // Cleanup and finish up by writing it all out to a file
     clearTempLuts();
     return saveData.writeTo(out);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Attempts to save the game to the specified output file
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool save(OutputStream& out) noexcept {
+    return saveImpl(out, false, false);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Saves an in-memory snapshot of the game (for rollback, rewind and demo seeking), which is never written to a save file.
+// Unlike a save file the snapshot records the exact order of the thinker list and of the sector and blockmap thing lists, so that
+// the game continues exactly as it would have after restoring it. Extra state for net games can optionally be included.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool saveSnapshot(OutputStream& out, const bool bIncludeNetState) noexcept {
+    return saveImpl(out, true, bIncludeNetState);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Reads a save file from the specified input stream and performs basic validation.
 // This step doesn't actually begin the process of loading the level, just buffers all the data.
@@ -567,7 +828,28 @@ ReadSaveResult read(InputStream& in) noexcept {
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
-// Loads the current save file that has been read into memory, after the map file used by the save has been loaded
+// Reads an in-memory snapshot saved by 'saveSnapshot', in the same way as 'read'.
+// The net game state must be read if and only if it was included when saving.
+//------------------------------------------------------------------------------------------------------------------------------------------
+ReadSaveResult readSnapshot(InputStream& in, const bool bIncludeNetState) noexcept {
+    gSaveDataIn = {};
+    return gSaveDataIn.readFrom(in, true, bIncludeNetState);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the currently buffered save is for the map that is currently loaded and running, judging by both the map number and the hash
+// of the map data. If this is the case then the save can be loaded in-place without reloading the map: only dynamic state (map objects,
+// thinkers, buttons, scheduled actions) is torn down and sectors, lines and sides are updated in-place. Map geometry, the texture cache
+// and sound banks all remain resident, so loading takes a fraction of the time of a full level load.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isBufferedSaveForLoadedMap() noexcept {
+    const SaveFileHdr& hdr = gSaveDataIn.hdr;
+    return (gbIsLevelDataCached && (hdr.mapNum == gGameMap) && hdr.validateMapHash());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Loads the current save file that has been read into memory, after the map file used by the save has been loaded.
+// This can either be done after a full level load or in-place on the currently running map (see 'isBufferedSaveForLoadedMap').
 //------------------------------------------------------------------------------------------------------------------------------------------
 LoadSaveResult load() noexcept {
     // Do some very basic validations first
@@ -598,11 +880,13 @@ LoadSaveResult load() noexcept {
     allocThinkersToLoad(gStrobes, hdr.numStrobes);
     allocThinkersToLoad(gGlows, hdr.numGlows);
     allocThinkersToLoad(gDelayedExits, hdr.numDelayedExits);
+    const bool bValidThinkerOrder = addThinkersToLoad(saveData.listOrder.get());
     allocButtonsToLoad();
     ScriptingEngine::gScheduledActions.resize(hdr.numScheduledActions);
 
     // Validate everything that needs to be validated
     const bool bAllValid = (
+        bValidThinkerOrder &&
         saveData.globals.validate() &&
         validateObjects(saveData.sectors, hdr.numSectors) &&
         validateObjects(saveData.sides, hdr.numSides) &&
@@ -616,7 +900,9 @@ LoadSaveResult load() noexcept {
         validateObjects(saveData.lightFlashes, hdr.numLightFlashes) &&
         validateObjects(saveData.strobes, hdr.numStrobes) &&
         validateObjects(saveData.glows, hdr.numGlows) &&
-        validateObjects(saveData.buttons, hdr.numButtons)
+        validateObjects(saveData.buttons, hdr.numButtons) &&
+        ((!saveData.listOrder) || validateListOrder(*saveData.listOrder, hdr.numMobjs)) &&
+        ((!saveData.netState) || saveData.netState->validate())
     );
 
     if (!bAllValid)
@@ -630,6 +916,11 @@ LoadSaveResult load() noexcept {
     #endif
 
     saveData.globals.deserializeToGlobals();
+
+    if (saveData.netState) {
+        saveData.netState->deserializeToGlobals();
+    }
+
     deserializeObjects(saveData.sectors, gpSectors, hdr.numSectors);
     deserializeObjects(saveData.lines, gpLines, hdr.numLines);
     deserializeObjects(saveData.sides, gpSides, hdr.numSides);
@@ -649,7 +940,7 @@ LoadSaveResult load() noexcept {
 
     // Post load actions: update skill based game settings, adding map objects into the blockmap and sector lists, and associating thinkers with their sectors
     G_UpdateMobjInfoForSkill(gGameSkill);
-    addMobjsToSectors();
+    addMobjsToSectors(saveData.listOrder.get());
     associateThinkersWithSectors(gVlDoors);
     associateThinkersWithSectors(gVlCustomDoors);
     associateThinkersWithSectors(gFloorMovers);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Macros.h"
+#include "Sim/SimTls.h"
 
 #include <string>
 #include <unordered_map>
@@ -38,16 +39,19 @@ enum class SaveFileSlot : uint8_t {
 
 BEGIN_NAMESPACE(SaveAndLoad)
 
-extern std::unordered_map<mobj_t*, int32_t>     gMobjToIdx;
-extern std::vector<mobj_t*>                     gMobjList;
-extern SaveFileSlot                             gCurSaveSlot;
+extern SIM_TLS std::unordered_map<mobj_t*, int32_t>     gMobjToIdx;
+extern SIM_TLS std::vector<mobj_t*>                     gMobjList;
+extern SIM_TLS SaveFileSlot                             gCurSaveSlot;
 
 bool save(OutputStream& out) noexcept;
+bool saveSnapshot(OutputStream& out, const bool bIncludeNetState) noexcept;
 ReadSaveResult read(InputStream& in) noexcept;
+ReadSaveResult readSnapshot(InputStream& in, const bool bIncludeNetState) noexcept;
 LoadSaveResult load() noexcept;
 const char* getSaveFileBaseName(const SaveFileSlot slot) noexcept;
 std::string getSaveFilePath(const SaveFileSlot slot) noexcept;
 void clearBufferedSave() noexcept;
 int32_t getBufferedSaveMapNum() noexcept;
+bool isBufferedSaveForLoadedMap() noexcept;
 
 END_NAMESPACE(SaveAndLoad)
@@ -1417,6 +1417,204 @@ void SavedGlobals::deserializeToGlobals() const noexcept {
     gValidCount = 0;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// SavedNetPlayerT
+//------------------------------------------------------------------------------------------------------------------------------------------
+void SavedNetPlayerT::byteSwap() noexcept {
+    player.byteSwap();
+    byteSwapValue(frags);
+    byteSwapValue(attackdown);
+    byteSwapValue(refire);
+    byteSwapValue(lastsoundsectorIdx);
+    byteSwapValue(automapflags);
+    byteSwapValue(turnheld);
+    byteSwapValue(ticRemainder);
+    byteSwapValue(usedown);
+    byteSwapValue(bInGame);
+}
+
+bool SavedNetPlayerT::validate() const noexcept {
+    // Players not in the game don't have a map object, so there is nothing else to check
+    if (!bInGame)
+        return true;
+
+    return (
+        player.validate() &&
+        (player.mobjIdx >= 0) &&
+        ((lastsoundsectorIdx == -1) || isValidSectorIdx(lastsoundsectorIdx))
+    );
+}
+
+void SavedNetPlayerT::serializeFrom(const int32_t playerIdx) noexcept {
+    const player_t& srcPlayer = gPlayers[playerIdx];
+    player.serializeFrom(srcPlayer);
+    frags = srcPlayer.frags;
+    attackdown = srcPlayer.attackdown;
+    refire = srcPlayer.refire;
+    lastsoundsectorIdx = (srcPlayer.lastsoundsector) ? (int32_t)(srcPlayer.lastsoundsector - gpSectors) : -1;
+    automapflags = srcPlayer.automapflags;
+    turnheld = srcPlayer.turnheld;
+    ticRemainder = gTicRemainder[playerIdx];
+    usedown = srcPlayer.usedown;
+    bInGame = gbPlayerInGame[playerIdx];
+}
+
+void SavedNetPlayerT::deserializeTo(const int32_t playerIdx) const noexcept {
+    player_t& dstPlayer = gPlayers[playerIdx];
+    dstPlayer = {};
+    gTicRemainder[playerIdx] = ticRemainder;
+    gbPlayerInGame[playerIdx] = bInGame;
+
+    if (!bInGame)
+        return;
+
+    player.deserializeTo(dstPlayer);
+    dstPlayer.frags = frags;
+    dstPlayer.attackdown = attackdown;
+    dstPlayer.refire = refire;
+    dstPlayer.lastsoundsector = (lastsoundsectorIdx >= 0) ? &gpSectors[lastsoundsectorIdx] : nullptr;
+    dstPlayer.automapflags = automapflags;
+    dstPlayer.turnheld = turnheld;
+    dstPlayer.usedown = usedown;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// SavedNetState
+//------------------------------------------------------------------------------------------------------------------------------------------
+void SavedNetState::byteSwap() noexcept {
+    byteSwapEnumValue(netGame);
+    byteSwapObjects(players);
+    byteSwapValue(itemRespawnQueueHead);
+    byteSwapValue(itemRespawnQueueTail);
+    byteSwapValueArray(itemRespawnTime);
+
+    for (mapthing_t& mapThing : itemRespawnQueue) {
+        byteSwapValue(mapThing.x);
+        byteSwapValue(mapThing.y);
+        byteSwapValue(mapThing.angle);
+        byteSwapValue(mapThing.type);
+        byteSwapValue(mapThing.options);
+    }
+
+    byteSwapValue(deadPlayerRemovalQueueIdx);
+    byteSwapValueArray(deadPlayerMobjIdxs);
+}
+
+bool SavedNetState::validate() const noexcept {
+    if ((netGame < gt_single) || (netGame >= NUMGAMETYPES))
+        return false;
+
+    if (!validateObjects(players))
+        return false;
+
+    for (const int32_t mobjIdx : deadPlayerMobjIdxs) {
+        if (!isValidMobjIdx(mobjIdx))
+            return false;
+    }
+
+    return true;
+}
+
+void SavedNetState::serializeFromGlobals() noexcept {
+    netGame = gNetGame;
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        players[playerIdx].serializeFrom(playerIdx);
+    }
+
+    itemRespawnQueueHead = gItemRespawnQueueHead;
+    itemRespawnQueueTail = gItemRespawnQueueTail;
+    arrayAssign(itemRespawnTime, gItemRespawnTime);
+    arrayAssign(itemRespawnQueue, gItemRespawnQueue);
+    deadPlayerRemovalQueueIdx = gDeadPlayerRemovalQueueIdx;
+
+    for (uint32_t i = 0; i < MAX_DEAD_PLAYERS; ++i) {
+        deadPlayerMobjIdxs[i] = getMobjIndex(gDeadPlayerMobjRemovalQueue[i]);
+    }
+}
+
+void SavedNetState::deserializeToGlobals() const noexcept {
+    // Note: this is expected to be called after 'SavedGlobals::deserializeToGlobals', which assumes a single player game.
+    // Overwrite the player state and other multiplayer related stuff which that function defaulted.
+    gNetGame = netGame;
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        players[playerIdx].deserializeTo(playerIdx);
+    }
+
+    gItemRespawnQueueHead = itemRespawnQueueHead;
+    gItemRespawnQueueTail = itemRespawnQueueTail;
+    arrayAssign(gItemRespawnTime, itemRespawnTime);
+    arrayAssign(gItemRespawnQueue, itemRespawnQueue);
+    gDeadPlayerRemovalQueueIdx = deadPlayerRemovalQueueIdx;
+
+    for (uint32_t i = 0; i < MAX_DEAD_PLAYERS; ++i) {
+        gDeadPlayerMobjRemovalQueue[i] = getMobjAtIdx(deadPlayerMobjIdxs[i]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// SavedThinkerRefT
+//------------------------------------------------------------------------------------------------------------------------------------------
+void SavedThinkerRefT::byteSwap() noexcept {
+    byteSwapEnumValue(type);
+    byteSwapValue(idx);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// SavedMobjLinksT
+//------------------------------------------------------------------------------------------------------------------------------------------
+void SavedMobjLinksT::byteSwap() noexcept {
+    byteSwapValue(snextIdx);
+    byteSwapValue(sprevIdx);
+    byteSwapValue(bnextIdx);
+    byteSwapValue(bprevIdx);
+    byteSwapValue(blockCellNum);
+}
+
+bool SavedMobjLinksT::validate() const noexcept {
+    return (
+        isValidMobjIdx(snextIdx) &&
+        isValidMobjIdx(sprevIdx) &&
+        isValidMobjIdx(bnextIdx) &&
+        isValidMobjIdx(bprevIdx) &&
+        (blockCellNum <= (uint32_t) gBlockmapWidth * (uint32_t) gBlockmapHeight)
+    );
+}
+
+void SavedMobjLinksT::serializeFrom(const mobj_t& mobj) noexcept {
+    snextIdx = getMobjIndex(mobj.snext);
+    sprevIdx = getMobjIndex(mobj.sprev);
+    bnextIdx = getMobjIndex(mobj.bnext);
+    bprevIdx = getMobjIndex(mobj.bprev);
+    blockCellNum = mobj.blockCellNum;
+}
+
+void SavedMobjLinksT::deserializeTo(mobj_t& mobj) const noexcept {
+    mobj.snext = getMobjAtIdx(snextIdx);
+    mobj.sprev = getMobjAtIdx(sprevIdx);
+    mobj.bnext = getMobjAtIdx(bnextIdx);
+    mobj.bprev = getMobjAtIdx(bprevIdx);
+    mobj.blockCellNum = blockCellNum;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// SavedThingListHeadT
+//------------------------------------------------------------------------------------------------------------------------------------------
+void SavedThingListHeadT::byteSwap() noexcept {
+    byteSwapValue(listIdx);
+    byteSwapValue(mobjIdx);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// SavedListOrderHdr
+//------------------------------------------------------------------------------------------------------------------------------------------
+void SavedListOrderHdr::byteSwap() noexcept {
+    byteSwapValue(numThinkers);
+    byteSwapValue(numSectorListHeads);
+    byteSwapValue(numBlockListHeads);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // SaveFileHdr
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -1503,6 +1701,19 @@ bool SaveData::writeTo(OutputStream& out) const noexcept {
         writeArrayLE(out, delayedExits.get(), hdr.numDelayedExits);
         writeArrayLE(out, buttons.get(), hdr.numButtons);
         writeArrayLE(out, scheduledActions.get(), hdr.numScheduledActions);
+
+        if (listOrder) {
+            writeObjectLE(out, listOrder->hdr);
+            writeArrayLE(out, listOrder->thinkers.get(), listOrder->hdr.numThinkers);
+            writeArrayLE(out, listOrder->mobjLinks.get(), hdr.numMobjs);
+            writeArrayLE(out, listOrder->sectorListHeads.get(), listOrder->hdr.numSectorListHeads);
+            writeArrayLE(out, listOrder->blockListHeads.get(), listOrder->hdr.numBlockListHeads);
+        }
+
+        if (netState) {
+            writeObjectLE(out, *netState);
+        }
+
         return true;
     }
     catch (...) {
@@ -1510,7 +1721,7 @@ bool SaveData::writeTo(OutputStream& out) const noexcept {
     }
 }
 
-ReadSaveResult SaveData::readFrom(InputStream& in) noexcept {
+ReadSaveResult SaveData::readFrom(InputStream& in, const bool bReadListOrder, const bool bReadNetState) noexcept {
     try {
         // Read the header first and do basic validity checks
         readObjectLE(in, hdr);
@@ -1542,6 +1753,21 @@ ReadSaveResult SaveData::readFrom(InputStream& in) noexcept {
         readArrayLE(in, delayedExits, hdr.numDelayedExits);
         readArrayLE(in, buttons, hdr.numButtons);
         readArrayLE(in, scheduledActions, hdr.numScheduledActions);
+
+        if (bReadListOrder) {
+            listOrder = std::make_unique<SavedListOrder>();
+            readObjectLE(in, listOrder->hdr);
+            readArrayLE(in, listOrder->thinkers, listOrder->hdr.numThinkers);
+            readArrayLE(in, listOrder->mobjLinks, hdr.numMobjs);
+            readArrayLE(in, listOrder->sectorListHeads, listOrder->hdr.numSectorListHeads);
+            readArrayLE(in, listOrder->blockListHeads, listOrder->hdr.numBlockListHeads);
+        }
+
+        if (bReadNetState) {
+            netState = std::make_unique<SavedNetState>();
+            readObjectLE(in, *netState);
+        }
+
         return ReadSaveResult::OK;
     }
     catch (...) {
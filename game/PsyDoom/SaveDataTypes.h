@@ -1,7 +1,10 @@
 #pragma once
 
 #include "Doom/doomdef.h"
+#include "Doom/Game/doomdata.h"
 #include "Doom/Game/p_doors.h"
+#include "Doom/Game/p_inter.h"
+#include "Doom/Game/p_mobj.h"
 #include "SmallString.h"
 
 #include <memory>
@@ -484,6 +487,124 @@ struct SavedGlobals {
 
 static_assert(sizeof(SavedGlobals) == 384);
 
+// Saved state for a player in a net game.
+// Also includes player state which regular save files just default initialize, since it must be restored exactly for rollback netcode.
+struct SavedNetPlayerT {
+    SavedPlayerT    player;                     // The basic player state, as saved for single player
+    int32_t         frags;                      // Player's frag count for deathmatch games
+    uint32_t        attackdown;                 // Number of ticks the player has had the fire/attack button pressed
+    uint32_t        refire;                     // The number of times the player has re-fired after firing initially
+    int32_t         lastsoundsectorIdx;         // Index of the last sector the player made noise from ('-1' if none)
+    uint32_t        automapflags;               // Automap related (AF_XXX) flags
+    int32_t         turnheld;                   // How many ticks one of the turn buttons has been pressed: used for turn acceleration
+    int32_t         ticRemainder;               // How many unsimulated player sprite vblanks there are
+    bool            usedown;                    // If true the player has just pressed the use key
+    bool            bInGame;                    // Whether the player is in the game
+
+    void byteSwap() noexcept;
+    bool validate() const noexcept;
+    void serializeFrom(const int32_t playerIdx) noexcept;
+    void deserializeTo(const int32_t playerIdx) const noexcept;
+};
+
+static_assert(sizeof(SavedNetPlayerT) == 240);
+
+// State for a net game which is not part of a regular (single player) save file.
+// This is never written to save files on disk and is only used for in-memory snapshots of the game, for rollback netcode.
+struct SavedNetState {
+    gametype_t          netGame;                                    // What type of net game is being played
+    SavedNetPlayerT     players[MAXPLAYERS];                        // State for all players
+    int32_t             itemRespawnQueueHead;                       // Deathmatch item respawn queue: head and tail of the circular queue
+    int32_t             itemRespawnQueueTail;
+    int32_t             itemRespawnTime[ITEMQUESIZE];               // Deathmatch item respawn queue: when each item was picked up
+    mapthing_t          itemRespawnQueue[ITEMQUESIZE];              // Deathmatch item respawn queue: the things to respawn
+    uint32_t            deadPlayerRemovalQueueIdx;                  // Next slot to use in the dead player removal queue
+    int32_t             deadPlayerMobjIdxs[MAX_DEAD_PLAYERS];       // Dead player map objects queued for removal (by index, '-1' if none)
+
+    void byteSwap() noexcept;
+    bool validate() const noexcept;
+    void serializeFromGlobals() noexcept;
+    void deserializeToGlobals() const noexcept;
+};
+
+static_assert(sizeof(SavedNetState) == 1520);
+
+// Which list of saved thinkers a 'SavedThinkerRefT' refers to
+enum class SavedThinkerType : uint32_t {
+    VlDoor,
+    VlCustomDoor,
+    FloorMover,
+    Ceiling,
+    Plat,
+    FireFlicker,
+    LightFlash,
+    Strobe,
+    Glow,
+    DelayedExit,
+    NUM_TYPES
+};
+
+// Refers to a saved thinker, by it's type and index in the list of saved thinkers of that type
+struct SavedThinkerRefT {
+    SavedThinkerType    type;       // Which list of saved thinkers the thinker is in
+    uint32_t            idx;        // Index of the thinker in the list
+
+    void byteSwap() noexcept;
+};
+
+static_assert(sizeof(SavedThinkerRefT) == 8);
+
+// The blockmap and sector thing list links for a map object, with all map objects referred to by index ('-1' if none).
+// The links are saved as-is since in some cases (which demos rely on) the original code can leave these lists in an inconsistent state.
+struct SavedMobjLinksT {
+    int32_t     snextIdx;           // Next and previous things in the sector thing list
+    int32_t     sprevIdx;
+    int32_t     bnextIdx;           // Next and previous things in the blockmap cell thing list
+    int32_t     bprevIdx;
+    uint32_t    blockCellNum;       // PsyDoom: index + 1 of the blockmap cell the thing was last linked into ('0' if none)
+
+    void byteSwap() noexcept;
+    bool validate() const noexcept;
+    void serializeFrom(const mobj_t& mobj) noexcept;
+    void deserializeTo(mobj_t& mobj) const noexcept;
+};
+
+static_assert(sizeof(SavedMobjLinksT) == 20);
+
+// The thing at the head of a non-empty sector or blockmap cell thing list
+struct SavedThingListHeadT {
+    int32_t     listIdx;            // Index of the sector or blockmap cell
+    int32_t     mobjIdx;            // Index of the thing at the head of the list
+
+    void byteSwap() noexcept;
+};
+
+static_assert(sizeof(SavedThingListHeadT) == 8);
+
+// Header for 'SavedListOrder': says how many of each type of object follows
+struct SavedListOrderHdr {
+    uint32_t    numThinkers;                // Number of 'SavedThinkerRefT'
+    uint32_t    numSectorListHeads;         // Number of 'SavedThingListHeadT' for sector thing lists
+    uint32_t    numBlockListHeads;          // Number of 'SavedThingListHeadT' for blockmap cell thing lists
+
+    void byteSwap() noexcept;
+};
+
+static_assert(sizeof(SavedListOrderHdr) == 12);
+
+// The exact order of the thinker list and of the sector and blockmap thing lists, for in-memory snapshots only (never in save files).
+// A regular load re-creates thinkers grouped by type and re-links things in map object list order, which is fine for save files but
+// changes the order in which thinkers run and things are visited by collision checks. Snapshots must restore the game state exactly,
+// otherwise resuming from one (for rollback, rewind, demo keyframe seeking or joining a relayed game as a spectator) can change the
+// outcome of the game. The per-cell blockmap thing arrays are rebuilt from the restored blockmap lists, so they also come back in order.
+struct SavedListOrder {
+    SavedListOrderHdr                           hdr;
+    std::unique_ptr<SavedThinkerRefT[]>         thinkers;               // All thinkers in the order of the global thinker list
+    std::unique_ptr<SavedMobjLinksT[]>          mobjLinks;              // Thing list links for every map object (same count as map objects)
+    std::unique_ptr<SavedThingListHeadT[]>      sectorListHeads;
+    std::unique_ptr<SavedThingListHeadT[]>      blockListHeads;
+};
+
 // Header for a save file, comes first in the file
 struct SaveFileHdr {
     uint32_t    fileId1;                // Should match 'SAVE_FILE_ID1'
@@ -523,6 +644,7 @@ static_assert(sizeof(SaveFileHdr) == 136);
 
 // Save data for the game in it's entirety, in order of how it appears in the file.
 // Just encapsulates state for a single player game, does NOT support multiplayer.
+// The exception is in-memory snapshots, which append the exact order of thinkers and thing lists and optionally extra state for a net game.
 // 
 // Notes:
 //  (1) The data is always read and written in little endian format.
@@ -549,7 +671,9 @@ struct SaveData {
     std::unique_ptr<SavedDelayedExitT[]>        delayedExits;
     std::unique_ptr<SavedButtonT[]>             buttons;
     std::unique_ptr<SavedScheduledAction[]>     scheduledActions;
+    std::unique_ptr<SavedListOrder>             listOrder;          // Only for in-memory snapshots: never in save files
+    std::unique_ptr<SavedNetState>              netState;           // Only for in-memory snapshots of net games: never in save files
 
     bool writeTo(OutputStream& out) const noexcept;
-    [[nodiscard]] ReadSaveResult readFrom(InputStream& in) noexcept;
+    [[nodiscard]] ReadSaveResult readFrom(InputStream& in, const bool bReadListOrder = false, const bool bReadNetState = false) noexcept;
 };
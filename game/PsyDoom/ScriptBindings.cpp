@@ -47,6 +47,50 @@ static void makeTypeReadOnly(sol::usertype<T>& typeTable) noexcept {
     };
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: visits all sectors with the specified tag, invoking the specified lambda on each one.
+// Returns the number of sectors visited.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class T>
+static int32_t visitSectorsWithTag(const int32_t tag, const T& callback) noexcept {
+    const int32_t numSectors = gNumSectors;
+    sector_t* const pSectors = gpSectors;
+    int32_t numVisited = 0;
+
+    for (int32_t i = 0; i < numSectors; ++i) {
+        sector_t& sector = pSectors[i];
+
+        if (sector.tag == tag) {
+            callback(sector);
+            ++numVisited;
+        }
+    }
+
+    return numVisited;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: visits all lines with the specified tag, invoking the specified lambda on each one.
+// Returns the number of lines visited.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class T>
+static int32_t visitLinesWithTag(const int32_t tag, const T& callback) noexcept {
+    const int32_t numLines = gNumLines;
+    line_t* const pLines = gpLines;
+    int32_t numVisited = 0;
+
+    for (int32_t i = 0; i < numLines; ++i) {
+        line_t& line = pLines[i];
+
+        if (line.tag == tag) {
+            callback(line);
+            ++numVisited;
+        }
+    }
+
+    return numVisited;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Helper: visits sectors surrounding a specified sector, invoking the specified lambda on each one
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -202,6 +246,40 @@ static fixed_t FloatToFixed(const float num) noexcept {
     return (fixed_t)(num * 65536.0f);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helper: visits all things approximately in the rectangular area enclosing the two specified points, using the blockmap.
+// Invokes the specified lambda on each thing found.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class T>
+static void visitMobjsInArea(const float x1, const float y1, const float x2, const float y2, const T& callback) noexcept {
+    // Figure out what cells in the blockmap we will cover
+    const fixed_t xmin = FloatToFixed(std::min(x1, x2));
+    const fixed_t xmax = FloatToFixed(std::max(x1, x2));
+    const fixed_t ymin = FloatToFixed(std::min(y1, y2));
+    const fixed_t ymax = FloatToFixed(std::max(y1, y2));
+
+    const int32_t bmapW = gBlockmapWidth;
+    const int32_t bmapH = gBlockmapHeight;
+
+    const int32_t bmapTy = std::min(d_rshift<MAPBLOCKSHIFT>(ymax - gBlockmapOriginY), bmapH - 1);
+    const int32_t bmapBy = std::max(d_rshift<MAPBLOCKSHIFT>(ymin - gBlockmapOriginY), 0);
+    const int32_t bmapLx = std::max(d_rshift<MAPBLOCKSHIFT>(xmin - gBlockmapOriginX), 0);
+    const int32_t bmapRx = std::min(d_rshift<MAPBLOCKSHIFT>(xmax - gBlockmapOriginX), bmapW - 1);
+
+    // Go through all of the blockmap cells of interest, calling the callback on each thing found
+    for (int32_t bmapY = bmapBy; bmapY <= bmapTy; ++bmapY) {
+        for (int32_t bmapX = bmapLx; bmapX <= bmapRx; ++bmapX) {
+            mobj_t* pmobj = gppBlockLinks[bmapX + bmapY * bmapW];
+
+            while (pmobj) {
+                mobj_t* const pNextMobj = pmobj->bnext;     // Just to be safe
+                callback(*pmobj);
+                pmobj = pNextMobj;
+            }
+        }
+    }
+}
+
 static int32_t Script_R_TextureNumForName(const char* const name) noexcept {
     return (name) ? R_TextureNumForName(name, false) : -1;
 }
@@ -343,6 +421,63 @@ static void ForEachSectorWithTag(const int32_t tag, const std::function<void (se
     }
 }
 
+static sol::table GetSectorsWithTag(const int32_t tag, sol::this_state L) noexcept {
+    sol::table sectors = sol::state_view(L).create_table();
+    int32_t numSectors = 0;
+
+    visitSectorsWithTag(tag, [&](sector_t& sector) noexcept {
+        sectors.raw_set(++numSectors, &sector);
+    });
+
+    return sectors;
+}
+
+static int32_t SetSectorLightLevelForTag(const int32_t tag, const int32_t lightLevel) noexcept {
+    const uint8_t clampedLightLevel = (uint8_t) std::clamp(lightLevel, 0, 255);
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept { sector.lightlevel = clampedLightLevel; });
+}
+
+static int32_t SetSectorColorIdForTag(const int32_t tag, const int32_t colorId) noexcept {
+    const uint8_t clampedColorId = (uint8_t) std::clamp(colorId, 0, 255);
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept { sector.colorid = clampedColorId; });
+}
+
+static int32_t SetSectorFloorPicForTag(const int32_t tag, const int32_t pic) noexcept {
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept { sector.floorpic = pic; });
+}
+
+static int32_t SetSectorCeilingPicForTag(const int32_t tag, const int32_t pic) noexcept {
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept { sector.ceilingpic = pic; });
+}
+
+static int32_t SetSectorSpecialForTag(const int32_t tag, const int32_t special) noexcept {
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept { sector.special = special; });
+}
+
+static int32_t SetSectorFloorHeightForTag(const int32_t tag, const float height) noexcept {
+    const fixed_t fixedHeight = FloatToFixed(height);
+
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept {
+        sector.floorheight = fixedHeight;
+
+        if (!Config::gbInterpolateSectors) {
+            sector.floorheight.snap();
+        }
+    });
+}
+
+static int32_t SetSectorCeilingHeightForTag(const int32_t tag, const float height) noexcept {
+    const fixed_t fixedHeight = FloatToFixed(height);
+
+    return visitSectorsWithTag(tag, [=](sector_t& sector) noexcept {
+        sector.ceilingheight = fixedHeight;
+
+        if (!Config::gbInterpolateSectors) {
+            sector.ceilingheight.snap();
+        }
+    });
+}
+
 static line_t* GetLineInSector(sector_t& sector, const int32_t index) noexcept {
     return ((index >= 0) && (index < sector.linecount)) ? sector.lines[index] : nullptr;
 }
@@ -490,6 +625,27 @@ static void ForEachLineWithTag(const int32_t tag, const std::function<void (line
     }
 }
 
+static sol::table GetLinesWithTag(const int32_t tag, sol::this_state L) noexcept {
+    sol::table lines = sol::state_view(L).create_table();
+    int32_t numLines = 0;
+
+    visitLinesWithTag(tag, [&](line_t& line) noexcept {
+        lines.raw_set(++numLines, &line);
+    });
+
+    return lines;
+}
+
+static int32_t SetLineSpecialForTag(const int32_t tag, const int32_t special) noexcept {
+    return visitLinesWithTag(tag, [=](line_t& line) noexcept { line.special = special; });
+}
+
+static int32_t SetLineFlagsForTag(const int32_t tag, const uint32_t setFlags, const uint32_t clearFlags) noexcept {
+    return visitLinesWithTag(tag, [=](line_t& line) noexcept {
+        line.flags = (line.flags & ~clearFlags) | setFlags;
+    });
+}
+
 int32_t Script_P_PointOnLineSide(const float x, const float y, const line_t& line) noexcept {
     return P_PointOnLineSide(FloatToFixed(x), FloatToFixed(y), line);
 }
@@ -553,32 +709,41 @@ static void ForEachMobjInArea(
     if (!callback)
         return;
 
-    // Figure out what cells in the blockmap we will cover
-    const fixed_t xmin = FloatToFixed(std::min(x1, x2));
-    const fixed_t xmax = FloatToFixed(std::max(x1, x2));
-    const fixed_t ymin = FloatToFixed(std::min(y1, y2));
-    const fixed_t ymax = FloatToFixed(std::max(y1, y2));
+    visitMobjsInArea(x1, y1, x2, y2, callback);
+}
 
-    const int32_t bmapW = gBlockmapWidth;
-    const int32_t bmapH = gBlockmapHeight;
+static sol::table GetMobjs(sol::this_state L) noexcept {
+    sol::table mobjs = sol::state_view(L).create_table();
+    int32_t numMobjs = 0;
 
-    const int32_t bmapTy = std::min(d_rshift<MAPBLOCKSHIFT>(ymax - gBlockmapOriginY), bmapH - 1);
-    const int32_t bmapBy = std::max(d_rshift<MAPBLOCKSHIFT>(ymin - gBlockmapOriginY), 0);
-    const int32_t bmapLx = std::max(d_rshift<MAPBLOCKSHIFT>(xmin - gBlockmapOriginX), 0);
-    const int32_t bmapRx = std::min(d_rshift<MAPBLOCKSHIFT>(xmax - gBlockmapOriginX), bmapW - 1);
+    for (mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
+        mobjs.raw_set(++numMobjs, pMobj);
+    }
 
-    // Go through all of the blockmap cells of interest, calling the callback on each thing found
-    for (int32_t bmapY = bmapBy; bmapY <= bmapTy; ++bmapY) {
-        for (int32_t bmapX = bmapLx; bmapX <= bmapRx; ++bmapX) {
-            mobj_t* pmobj = gppBlockLinks[bmapX + bmapY * bmapW];
+    return mobjs;
+}
 
-            while (pmobj) {
-                mobj_t* const pNextMobj = pmobj->bnext;     // Just to be safe
-                callback(*pmobj);
-                pmobj = pNextMobj;
-            }
+static sol::table GetMobjsInArea(const float x1, const float y1, const float x2, const float y2, sol::this_state L) noexcept {
+    sol::table mobjs = sol::state_view(L).create_table();
+    int32_t numMobjs = 0;
+
+    visitMobjsInArea(x1, y1, x2, y2, [&](mobj_t& mo) noexcept {
+        mobjs.raw_set(++numMobjs, &mo);
+    });
+
+    return mobjs;
+}
+
+static int32_t CountMobjsWithType(const uint32_t type) noexcept {
+    int32_t count = 0;
+
+    for (mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
+        if (pMobj->type == (mobjtype_t) type) {
+            ++count;
         }
     }
+
+    return count;
 }
 
 static int32_t FindMobjTypeForDoomEdNum(const int32_t doomEdNum) noexcept {
@@ -1054,6 +1219,14 @@ static void registerLuaFunctions(sol::state& lua) noexcept {
     lua["FindSectorWithTag"] = FindSectorWithTag;
     lua["ForEachSector"] = ForEachSector;
     lua["ForEachSectorWithTag"] = ForEachSectorWithTag;
+    lua["GetSectorsWithTag"] = GetSectorsWithTag;
+    lua["SetSectorLightLevelForTag"] = SetSectorLightLevelForTag;
+    lua["SetSectorColorIdForTag"] = SetSectorColorIdForTag;
+    lua["SetSectorFloorPicForTag"] = SetSectorFloorPicForTag;
+    lua["SetSectorCeilingPicForTag"] = SetSectorCeilingPicForTag;
+    lua["SetSectorSpecialForTag"] = SetSectorSpecialForTag;
+    lua["SetSectorFloorHeightForTag"] = SetSectorFloorHeightForTag;
+    lua["SetSectorCeilingHeightForTag"] = SetSectorCeilingHeightForTag;
     lua["SectorAtPosition"] = SectorAtPosition;
     
     lua["GetNumLines"] = GetNumLines;
@@ -1061,6 +1234,9 @@ static void registerLuaFunctions(sol::state& lua) noexcept {
     lua["FindLineWithTag"] = FindLineWithTag;
     lua["ForEachLine"] = ForEachLine;
     lua["ForEachLineWithTag"] = ForEachLineWithTag;
+    lua["GetLinesWithTag"] = GetLinesWithTag;
+    lua["SetLineSpecialForTag"] = SetLineSpecialForTag;
+    lua["SetLineFlagsForTag"] = SetLineFlagsForTag;
     lua["P_PointOnLineSide"] = Script_P_PointOnLineSide;
     lua["P_CrossSpecialLine"] = Script_P_CrossSpecialLine;
     lua["P_ShootSpecialLine"] = Script_P_ShootSpecialLine;
@@ -1077,6 +1253,9 @@ static void registerLuaFunctions(sol::state& lua) noexcept {
 
     lua["ForEachMobj"] = ForEachMobj;
     lua["ForEachMobjInArea"] = ForEachMobjInArea;
+    lua["GetMobjs"] = GetMobjs;
+    lua["GetMobjsInArea"] = GetMobjsInArea;
+    lua["CountMobjsWithType"] = CountMobjsWithType;
     lua["FindMobjTypeForDoomEdNum"] = FindMobjTypeForDoomEdNum;
     lua["P_SpawnMobj"] = Script_P_SpawnMobj;
     lua["P_SpawnMissile"] = Script_P_SpawnMissile;
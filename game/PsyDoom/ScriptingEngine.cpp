@@ -10,8 +10,11 @@
 #include "Doom/Game/p_tick.h"
 #include "Doom/UI/st_main.h"
 #include "MapHash.h"
+#include "ProgArgs.h"
 #include "ScriptBindings.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <memory>
 #include <sol/sol.hpp>
@@ -19,39 +22,52 @@
 BEGIN_NAMESPACE(ScriptingEngine)
 
 // The main Lua VM, managed and wrapped by the 'Sol2' library
-static std::unique_ptr<sol::state> gpLuaState;
+static SIM_TLS std::unique_ptr<sol::state> gpLuaState;
 
 // A table of actions registered with the scripting engine.
 // Each action has an integer identifier associated with it that is referenced by line tags.
-static std::unordered_map<int32_t, sol::protected_function> gScriptActions;
+static SIM_TLS std::unordered_map<int32_t, sol::protected_function> gScriptActions;
 
 // How many 'doAction' calls are currently active?
 // Scripts might invoke other scripts, so the 'doAction' calls can be nested.
-static int32_t gNumExecutingScripts = 0;
+static SIM_TLS int32_t gNumExecutingScripts = 0;
 
 // The list of actions scheduled to execute later. This list may contain 'holes' or actions that are done executing.
 // This is so we preserve the relative order of actions scheduled to occur on the same tic - they should happen in the same order they were scheduled in.
-std::vector<ScheduledAction> gScheduledActions;
+SIM_TLS std::vector<ScheduledAction> gScheduledActions;
 
 // Context for the current script action being executed.
 // Which linedef, sector and thing triggered the action, all of which are optional.
 // All, some or none of these might be specified depending on the context in which the script action is executed.
-line_t*     gpCurTriggeringLine;
-sector_t*   gpCurTriggeringSector;
-mobj_t*     gpCurTriggeringMobj;
+SIM_TLS line_t*     gpCurTriggeringLine;
+SIM_TLS sector_t*   gpCurTriggeringSector;
+SIM_TLS mobj_t*     gpCurTriggeringMobj;
 
 // Extra context for the current script action being executed, which is only non-zero for scheduled action.
 // The user/script defined tag for the action and userdata for the action.
-int32_t     gCurActionTag;
-int32_t     gCurActionUserdata;
+SIM_TLS int32_t     gCurActionTag;
+SIM_TLS int32_t     gCurActionUserdata;
 
 // This flag can be set to 'false' by scripts to indicate action is not currently available/allowed.
 // It affects the behavior of switches and whether they can change texture and make a noise or not.
-bool gbCurActionAllowed;
+SIM_TLS bool gbCurActionAllowed;
 
 // A flag set to true if we need to delete things after the current script has finished executing.
 // This will be triggered if scripts do a call to 'P_RemoveMobj()'.
-bool gbNeedMobjGC;
+SIM_TLS bool gbNeedMobjGC;
+
+// Timing stats for a script action, gathered over the course of a level when script profiling is enabled.
+// Times are 'self' times and exclude time spent in any actions invoked by the action.
+struct ActionProfile {
+    uint32_t    numCalls;       // How many times the action was executed
+    int64_t     totalNs;        // Total time spent executing the action
+    int64_t     maxNs;          // Longest single execution of the action
+};
+
+static SIM_TLS std::unordered_map<int32_t, ActionProfile> gActionProfiles;
+
+// Profiling: time spent so far in actions nested within the currently executing action
+static SIM_TLS int64_t gNestedActionNs = 0;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Issues a user facing error message relating to scripting, which is shown on the in-game status bar.
@@ -273,12 +289,45 @@ void init() noexcept {
     setupActionExecuteLuaEnv();
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints the script action timing stats gathered for the level (if any) to standard out, most expensive actions first
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void printActionProfileReport() noexcept {
+    if (gActionProfiles.empty())
+        return;
+
+    std::vector<std::pair<int32_t, ActionProfile>> profiles(gActionProfiles.begin(), gActionProfiles.end());
+
+    std::sort(profiles.begin(), profiles.end(), [](const auto& p1, const auto& p2) noexcept {
+        return (p1.second.totalNs > p2.second.totalNs);
+    });
+
+    std::printf("PsyDoom: script action profile for the level (self time, most expensive first):\n");
+
+    for (const auto& [actionNum, profile] : profiles) {
+        std::printf(
+            "  Action #%-6d calls: %-8u total: %10.3f ms  avg: %10.3f us  max: %10.3f us\n",
+            actionNum,
+            profile.numCalls,
+            (double) profile.totalNs / 1000000.0,
+            (double) profile.totalNs / ((double) profile.numCalls * 1000.0),
+            (double) profile.maxNs / 1000.0
+        );
+    }
+
+    gActionProfiles.clear();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Tears down the scripting engine for the current level
 //------------------------------------------------------------------------------------------------------------------------------------------
 void shutdown() noexcept {
     ASSERT_LOG(gNumExecutingScripts == 0, "Shutdown should only be done when no scripts are executing!");
 
+    if (ProgArgs::gbProfileScripts) {
+        printActionProfileReport();
+    }
+
     gScheduledActions.clear();
     gScriptActions.clear();
     gpLuaState.reset();
@@ -357,9 +406,15 @@ bool doAction(
     // Assume the current action is allowed until scripts indicate otherwise
     gbCurActionAllowed = true;
 
-    // Try and execute the action
+    // Try and execute the action, timing it if profiling.
+    // Save the nested action time for any action which invoked this one, so we can exclude our own nested actions from our time.
     const auto actionIter = gScriptActions.find(actionNum);
 
+    const bool bProfile = ProgArgs::gbProfileScripts;
+    const int64_t outerNestedActionNs = gNestedActionNs;
+    const auto startTime = (bProfile) ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    gNestedActionNs = 0;
+
     if (actionIter != gScriptActions.end()) {
         try {
             const sol::protected_function_result result = actionIter->second();
@@ -379,6 +434,20 @@ bool doAction(
         std::printf("PsyDoom: no scripting action #%d is available to execute!\n", actionNum);
     }
 
+    if (bProfile) {
+        const int64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        const int64_t selfNs = std::max<int64_t>(elapsedNs - gNestedActionNs, 0);
+
+        ActionProfile& profile = gActionProfiles[actionNum];
+        profile.numCalls++;
+        profile.totalNs += selfNs;
+        profile.maxNs = std::max(profile.maxNs, selfNs);
+
+        gNestedActionNs = outerNestedActionNs + elapsedNs;
+    } else {
+        gNestedActionNs = outerNestedActionNs;
+    }
+
     const bool bWasActionAllowed = gbCurActionAllowed;
 
     // Clear script context
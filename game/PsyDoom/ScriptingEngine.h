@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Macros.h"
+#include "Sim/SimTls.h"
 
 #include <cstdint>
 #include <vector>
@@ -24,14 +25,14 @@ struct ScheduledAction {
     bool        bPendingExecute;    // If 'true' then the action is pending execution this frame
 };
 
-extern std::vector<ScheduledAction>     gScheduledActions;
-extern line_t*                          gpCurTriggeringLine;
-extern sector_t*                        gpCurTriggeringSector;
-extern mobj_t*                          gpCurTriggeringMobj;
-extern int32_t                          gCurActionTag;
-extern int32_t                          gCurActionUserdata;
-extern bool                             gbCurActionAllowed;
-extern bool                             gbNeedMobjGC;
+extern SIM_TLS std::vector<ScheduledAction>     gScheduledActions;
+extern SIM_TLS line_t*                          gpCurTriggeringLine;
+extern SIM_TLS sector_t*                        gpCurTriggeringSector;
+extern SIM_TLS mobj_t*                          gpCurTriggeringMobj;
+extern SIM_TLS int32_t                          gCurActionTag;
+extern SIM_TLS int32_t                          gCurActionUserdata;
+extern SIM_TLS bool                             gbCurActionAllowed;
+extern SIM_TLS bool                             gbNeedMobjGC;
 
 void init() noexcept;
 void shutdown() noexcept;
@@ -0,0 +1,361 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Support for running the WESS music and sound sequencer on the audio thread, inside the audio render loop.
+//
+// Normally PsyDoom advances the sequencer from 'Utils::doPlatformUpdates' on the game thread with a variable delta time.
+// That means music timing jitters whenever a frame is slow, and every sequencer update contends with the audio thread for the SPU lock.
+// When this mode is enabled the sequencer instead ticks at exact 120 Hz intervals measured in output samples, just like the
+// original hardware timer interrupt drove it. Sound commands issued by the game thread are pushed onto a lock-free single
+// producer/single consumer queue and executed by the audio thread at the next sequencer tick.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "SeqAudioThread.h"
+
+#include "Asserts.h"
+#include "ProgArgs.h"
+#include "PsxVm.h"
+#include "Wess/wessapi_m.h"
+#include "Wess/wessapi_p.h"
+#include "Wess/wessapi_t.h"
+#include "Wess/wessarc.h"
+#include "Wess/wessseq.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+
+BEGIN_NAMESPACE(SeqAudioThread)
+
+// Maximum number of deferred commands that can be queued: must be a power of two.
+// If the queue fills up the game thread will lock the SPU and execute the commands itself.
+static constexpr uint32_t CMD_QUEUE_SIZE = 1024;
+static_assert((CMD_QUEUE_SIZE & (CMD_QUEUE_SIZE - 1)) == 0);
+
+// How many times a second the sequencer ticks (same rate as the original hardware timer interrupt)
+static constexpr uint32_t SEQ_TICKS_PER_SEC = 120;
+
+static bool                     gbEnabled;                      // True if the sequencer runs on the audio thread (when not suspended)
+static uint32_t                 gSampleRate;                    // Audio output sample rate
+static int32_t                  gSuspendCount;                  // While > 0 the sequencer is handed back to the game thread. Only modified with the SPU locked.
+static uint32_t                 gTickSampleAccum;               // Accumulates 'SEQ_TICKS_PER_SEC' per output sample: a tick occurs every time this passes 'gSampleRate'
+static Cmd                      gCmdQueue[CMD_QUEUE_SIZE];      // Ring buffer of deferred commands
+static std::atomic<uint32_t>    gCmdQueueHead;                  // Where the consumer reads the next command from (only advanced with the SPU locked)
+static std::atomic<uint32_t>    gCmdQueueTail;                  // Where the producer (game thread) writes the next command to
+static uint64_t                 gAudioThreadSampleIdx;          // Index of the current output sample being generated by the audio thread
+static std::atomic<uint64_t>    gNumSamplesRendered;            // Total number of samples fully rendered and handed to the audio device
+
+// True if the current thread is the one which currently owns the sequencer and can execute commands directly
+static thread_local bool tgbIsSequencerThread;
+
+// Jitter measurement state: running statistics computed via Welford's algorithm
+static double       gSeqTicksElapsed;       // Total sequencer time elapsed (in 120 Hz ticks) since measurement began
+static uint64_t     gJitterNumSamples;
+static double       gJitterMean;
+static double       gJitterM2;
+static double       gJitterMin;
+static double       gJitterMax;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Records a sequencer update for jitter measurement.
+// Takes the position in the audio output stream where the update takes effect and compares against where it should be ideally.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void recordSeqUpdate(const uint64_t outputSamplePos, const double num120HzTicks) noexcept {
+    gSeqTicksElapsed += num120HzTicks;
+    const double idealSamplePos = gSeqTicksElapsed * (double) gSampleRate / (double) SEQ_TICKS_PER_SEC;
+    const double err = (double) outputSamplePos - idealSamplePos;
+
+    gJitterNumSamples++;
+    const double delta = err - gJitterMean;
+    gJitterMean += delta / (double) gJitterNumSamples;
+    gJitterM2 += delta * (err - gJitterMean);
+
+    if (gJitterNumSamples == 1) {
+        gJitterMin = err;
+        gJitterMax = err;
+    } else {
+        gJitterMin = std::min(gJitterMin, err);
+        gJitterMax = std::max(gJitterMax, err);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Executes the given deferred command on the thread which currently owns the sequencer
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void executeCmd(const Cmd& cmd) noexcept {
+    ASSERT(tgbIsSequencerThread);
+    const TriggerPlayAttr* const pPlayAttribs = (cmd.bHasPlayAttribs) ? &cmd.playAttribs : nullptr;
+
+    switch (cmd.type) {
+        case CmdType::SeqTriggerType:           wess_seq_trigger_type(cmd.seqIdx, cmd.seqType);                         break;
+        case CmdType::SeqTriggerTypeSpecial:    wess_seq_trigger_type_special(cmd.seqIdx, cmd.seqType, pPlayAttribs);   break;
+        case CmdType::SeqUpdateTypeSpecial:     wess_seq_update_type_special(cmd.seqType, pPlayAttribs);                break;
+        case CmdType::SeqStop:                  wess_seq_stop(cmd.seqIdx);                                              break;
+        case CmdType::SeqStopType:              wess_seq_stoptype(cmd.seqType);                                         break;
+        case CmdType::SeqStopAll:               wess_seq_stopall();                                                     break;
+        case CmdType::SeqPauseAll:              wess_seq_pauseall(cmd.bMute, cmd.pSavedVoices);                         break;
+        case CmdType::SeqRestartAll:            wess_seq_restartall(cmd.pSavedVoices);                                  break;
+        case CmdType::MasterSfxVolSet:          wess_master_sfx_vol_set(cmd.volume);                                    break;
+        case CmdType::MasterMusVolSet:          wess_master_mus_vol_set(cmd.volume);                                    break;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Executes deferred commands in the order they were issued, up until (but not including) the given queue position.
+// The SPU must be locked when calling this, which ensures only one consumer at a time.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void flushCmdsUntil(const uint32_t endPos) noexcept {
+    uint32_t head = gCmdQueueHead.load(std::memory_order_relaxed);
+
+    while (head != endPos) {
+        executeCmd(gCmdQueue[head & (CMD_QUEUE_SIZE - 1)]);
+        ++head;
+        gCmdQueueHead.store(head, std::memory_order_release);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Executes all deferred commands in the queue, in the order they were issued.
+// The SPU must be locked when calling this, which ensures only one consumer at a time.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void flushCmds() noexcept {
+    flushCmdsUntil(gCmdQueueTail.load(std::memory_order_acquire));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the queue position just after the last deferred command which might change the status of the given sequence.
+// Returns the queue head if there is no such command. The SPU must be locked when calling this, so that the audio thread is not
+// consuming commands at the same time.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t getQueuedCmdsAffectingSeqEnd(const int32_t seqIdx) noexcept {
+    const uint32_t head = gCmdQueueHead.load(std::memory_order_relaxed);
+    const uint32_t tail = gCmdQueueTail.load(std::memory_order_acquire);
+    uint32_t endPos = head;
+
+    for (uint32_t pos = head; pos != tail; ++pos) {
+        const Cmd& cmd = gCmdQueue[pos & (CMD_QUEUE_SIZE - 1)];
+
+        switch (cmd.type) {
+            case CmdType::SeqTriggerType:
+            case CmdType::SeqTriggerTypeSpecial:
+            case CmdType::SeqStop:
+                if (cmd.seqIdx == seqIdx) {
+                    endPos = pos + 1;
+                }
+                break;
+
+            // Sequences are stopped, paused or restarted by type or all at once by these
+            case CmdType::SeqStopType:
+            case CmdType::SeqStopAll:
+            case CmdType::SeqPauseAll:
+            case CmdType::SeqRestartAll:
+                endPos = pos + 1;
+                break;
+
+            case CmdType::SeqUpdateTypeSpecial:
+            case CmdType::MasterSfxVolSet:
+            case CmdType::MasterMusVolSet:
+                break;
+        }
+    }
+
+    return endPos;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initialize the audio thread sequencer: if not enabled then the sequencer will run on the game thread as before
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init(const bool bEnable, const uint32_t sampleRate) noexcept {
+    PsxVm::LockSpu spuLock;
+
+    gbEnabled = bEnable;
+    gSampleRate = sampleRate;
+    gSuspendCount = 0;
+    gTickSampleAccum = 0;
+    gCmdQueueHead = 0;
+    gCmdQueueTail = 0;
+    gAudioThreadSampleIdx = 0;
+    gNumSamplesRendered = 0;
+
+    gSeqTicksElapsed = 0.0;
+    gJitterNumSamples = 0;
+    gJitterMean = 0.0;
+    gJitterM2 = 0.0;
+    gJitterMin = 0.0;
+    gJitterMax = 0.0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Shuts down the audio thread sequencer, executing any remaining commands and optionally printing timing stats
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    if (ProgArgs::gbPrintSeqJitterStats) {
+        printJitterStats();
+    }
+
+    PsxVm::LockSpu spuLock;
+    tgbIsSequencerThread = true;
+    flushCmds();
+    tgbIsSequencerThread = false;
+    gbEnabled = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the sequencer is currently being driven by the audio thread, as opposed to the game thread.
+// Note: this should only be called from the game thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isSequencerOnAudioThread() noexcept {
+    return (gbEnabled && (gSuspendCount <= 0));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if a WESS API command issued on the current thread should be deferred to the audio thread, rather than executed directly
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool shouldDeferCmd() noexcept {
+    return (isSequencerOnAudioThread() && (!tgbIsSequencerThread));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Defers the given command to be executed by the audio thread on the next sequencer tick.
+// If the queue is full then the SPU is locked and the queue is flushed on the calling thread, along with the command itself.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void deferCmd(const Cmd& cmd) noexcept {
+    const uint32_t tail = gCmdQueueTail.load(std::memory_order_relaxed);
+    const uint32_t head = gCmdQueueHead.load(std::memory_order_acquire);
+
+    if (tail - head < CMD_QUEUE_SIZE) {
+        gCmdQueue[tail & (CMD_QUEUE_SIZE - 1)] = cmd;
+        gCmdQueueTail.store(tail + 1, std::memory_order_release);
+        return;
+    }
+
+    // Queue is full: this should be very rare, but just take ownership of the sequencer and execute everything now
+    PsxVm::LockSpu spuLock;
+    tgbIsSequencerThread = true;
+    flushCmds();
+    executeCmd(cmd);
+    tgbIsSequencerThread = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called by the audio thread with the SPU locked, before generating a buffer of samples
+//------------------------------------------------------------------------------------------------------------------------------------------
+void beginAudioRender() noexcept {
+    tgbIsSequencerThread = isSequencerOnAudioThread();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called by the audio thread with the SPU locked, before generating each individual output sample.
+// Ticks the sequencer if a 120 Hz interval has elapsed, so all sequencer events land on exact sample boundaries.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void onOutputSample() noexcept {
+    if (!tgbIsSequencerThread)
+        return;
+
+    gAudioThreadSampleIdx++;
+    gTickSampleAccum += SEQ_TICKS_PER_SEC;
+
+    if (gTickSampleAccum < gSampleRate)
+        return;
+
+    gTickSampleAccum -= gSampleRate;
+    flushCmds();
+
+    if (gbWess_SeqOn) {
+        SeqEngine_Advance(1.0);
+        recordSeqUpdate(gAudioThreadSampleIdx, 1.0);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Called by the audio thread with the SPU locked, after generating a buffer of samples
+//------------------------------------------------------------------------------------------------------------------------------------------
+void endAudioRender(const uint32_t numSamples) noexcept {
+    tgbIsSequencerThread = false;
+    gNumSamplesRendered.fetch_add(numSamples, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Records a sequencer update done on the game thread for jitter measurement purposes.
+// The results of the update will be heard at the start of the next audio buffer, which is the current rendered sample count.
+// Updates done while the audio thread sequencer is temporarily suspended are not measured.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void recordGameThreadSeqUpdate(const double num120HzTicks) noexcept {
+    if (gbEnabled)
+        return;
+
+    recordSeqUpdate(gNumSamplesRendered.load(std::memory_order_acquire), num120HzTicks);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns sequencer timing jitter statistics gathered so far
+//------------------------------------------------------------------------------------------------------------------------------------------
+JitterStats getJitterStats() noexcept {
+    PsxVm::LockSpu spuLock;
+
+    JitterStats stats = {};
+    stats.numUpdates = gJitterNumSamples;
+    stats.meanErr = gJitterMean;
+    stats.stdDevErr = (gJitterNumSamples > 1) ? std::sqrt(gJitterM2 / (double)(gJitterNumSamples - 1)) : 0.0;
+    stats.minErr = gJitterMin;
+    stats.maxErr = gJitterMax;
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Prints sequencer timing jitter statistics to standard out
+//------------------------------------------------------------------------------------------------------------------------------------------
+void printJitterStats() noexcept {
+    const JitterStats stats = getJitterStats();
+    const double msPerSample = (gSampleRate > 0) ? 1000.0 / (double) gSampleRate : 0.0;
+
+    std::printf(
+        "PsyDoom: sequencer timing (%s): %llu updates, jitter (std dev) %.2f samples (%.3f MS), peak-to-peak %.2f samples (%.3f MS)\n",
+        (gbEnabled) ? "audio thread" : "game thread",
+        (unsigned long long) stats.numUpdates,
+        stats.stdDevErr,
+        stats.stdDevErr * msPerSample,
+        stats.maxErr - stats.minErr,
+        (stats.maxErr - stats.minErr) * msPerSample
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Hands the sequencer back to the game thread for the lifetime of the scope, executing any deferred commands first
+//------------------------------------------------------------------------------------------------------------------------------------------
+SuspendScope::SuspendScope() noexcept {
+    PsxVm::LockSpu spuLock;
+    tgbIsSequencerThread = true;
+    flushCmds();
+    gSuspendCount++;
+}
+
+SuspendScope::~SuspendScope() noexcept {
+    PsxVm::LockSpu spuLock;
+    ASSERT(gSuspendCount > 0);
+    gSuspendCount--;
+    tgbIsSequencerThread = (gSuspendCount > 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Locks the sequencer for a status query (if it's on the audio thread) and brings the status of the given sequence up to date.
+// Commands are only executed here up until the last one which affects the sequence being queried: any commands issued after that
+// (sound effect triggers etc.) still wait for the audio thread. Earlier commands must be executed too, to preserve the ordering.
+//------------------------------------------------------------------------------------------------------------------------------------------
+QueryScope::QueryScope(const int32_t seqIdx) noexcept : mbLockedSpu(shouldDeferCmd()) {
+    if (!mbLockedSpu)
+        return;
+
+    PsxVm::lockSpu();
+    tgbIsSequencerThread = true;
+
+    flushCmdsUntil(getQueuedCmdsAffectingSeqEnd(seqIdx));
+}
+
+QueryScope::~QueryScope() noexcept {
+    if (!mbLockedSpu)
+        return;
+
+    tgbIsSequencerThread = false;
+    PsxVm::unlockSpu();
+}
+
+END_NAMESPACE(SeqAudioThread)
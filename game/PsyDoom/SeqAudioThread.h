@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Macros.h"
+#include "Wess/wessapi.h"
+
+#include <cstdint>
+
+BEGIN_NAMESPACE(SeqAudioThread)
+
+// Types of sound commands which can be deferred from the game thread to the audio thread
+enum class CmdType : uint8_t {
+    SeqTriggerType,             // wess_seq_trigger_type()
+    SeqTriggerTypeSpecial,      // wess_seq_trigger_type_special()
+    SeqUpdateTypeSpecial,       // wess_seq_update_type_special()
+    SeqStop,                    // wess_seq_stop()
+    SeqStopType,                // wess_seq_stoptype()
+    SeqStopAll,                 // wess_seq_stopall()
+    SeqPauseAll,                // wess_seq_pauseall()
+    SeqRestartAll,              // wess_seq_restartall()
+    MasterSfxVolSet,            // wess_master_sfx_vol_set()
+    MasterMusVolSet,            // wess_master_mus_vol_set()
+};
+
+// Holds the parameters for a sound command which is deferred to the audio thread.
+// Only the fields relevant to the command type are used.
+struct Cmd {
+    CmdType             type;
+    bool                bHasPlayAttribs;    // Whether 'playAttribs' is valid, for commands that take optional trigger attributes
+    bool                bMute;              // Mute flag for 'SeqPauseAll'
+    uint8_t             volume;             // New volume for the volume set commands
+    int32_t             seqIdx;             // Sequence index for trigger and stop commands
+    uintptr_t           seqType;            // Sequence type for the 'type' family of commands
+    SavedVoiceList*     pSavedVoices;       // Saved voice list for pause/restart commands
+    TriggerPlayAttr     playAttribs;        // A copy of the trigger play attributes (if any)
+};
+
+// Timing jitter statistics for the sequencer.
+// Measures the error between where sequencer updates land in the audio output stream versus where they ideally should, in samples.
+struct JitterStats {
+    uint64_t    numUpdates;         // How many sequencer updates were measured
+    double      meanErr;            // Mean error (audio output position vs ideal position) in samples: this is a constant latency
+    double      stdDevErr;          // Standard deviation of the error in samples: this is the jitter
+    double      minErr;             // Smallest error observed in samples
+    double      maxErr;             // Largest error observed in samples
+};
+
+void init(const bool bEnable, const uint32_t sampleRate) noexcept;
+void shutdown() noexcept;
+bool isSequencerOnAudioThread() noexcept;
+bool shouldDeferCmd() noexcept;
+void deferCmd(const Cmd& cmd) noexcept;
+
+// Audio thread hooks: these must be called while the SPU is locked
+void beginAudioRender() noexcept;
+void onOutputSample() noexcept;
+void endAudioRender(const uint32_t numSamples) noexcept;
+
+// Jitter measurement
+void recordGameThreadSeqUpdate(const double num120HzTicks) noexcept;
+JitterStats getJitterStats() noexcept;
+void printJitterStats() noexcept;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Temporarily hands the sequencer back to the game thread for the lifetime of this object.
+// Any deferred commands are executed before the handover, so ordering is preserved.
+// Used while loading sounds and music or doing other heavy sequencer setup on the game thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct SuspendScope {
+    SuspendScope() noexcept;
+    ~SuspendScope() noexcept;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Allows sequencer state to be safely queried from the game thread for the lifetime of this object.
+// If the sequencer is running on the audio thread then the SPU is locked while the object exists, and deferred commands are executed up
+// until the last one which might affect the status of the given sequence. That way the status observed reflects all of the commands
+// issued so far, exactly as if they had been executed immediately. Commands issued after that still wait for the audio thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct QueryScope {
+    explicit QueryScope(const int32_t seqIdx) noexcept;
+    ~QueryScope() noexcept;
+
+private:
+    bool mbLockedSpu;
+};
+
+END_NAMESPACE(SeqAudioThread)
@@ -0,0 +1,313 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoomSim: a headless build of the game logic with no video, audio or input, which plays back a list of demos on several threads at once.
+// Intended for bulk regression testing of demos and for benchmarking the game simulation.
+//
+// All of the global state for a single running game simulation is marked 'SIM_TLS' (see 'SimTls.h'), which makes it thread local in this
+// build. Each sim thread therefore gets its own independent game world, zone memory heap, WAD files and open files. State that is only ever
+// read once the program has started up (config, program arguments, the game disc and its file system, game type etc.) is shared by all
+// threads. Front-end modules such as the renderer, sound, UI and networking are not compiled in; 'SimStubs.cpp' stands in for them.
+//
+// Usage is similar to the '-batchdemos' option of the game, with the addition of '-threads <NUM_THREADS>' to control how many demos are
+// simulated at once (defaults to one thread per logical CPU) and '-checkserial' to play the batch again on one thread afterwards and check
+// that every demo ends in exactly the same game state:
+//
+//      PsyDoomSim -cue <CUE_FILE_PATH> -batchdemos <DEMO_LIST_FILE_PATH> [-threads <NUM_THREADS>] [-checkserial]
+//
+// The outcome of each demo is printed in list order once all demos have finished, followed by overall throughput in demos and tics/sec.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "Doom/Base/w_wad.h"
+#include "Doom/Base/z_zone.h"
+#include "Doom/cdmaptbl.h"
+#include "Doom/d_main.h"
+#include "Doom/Game/g_game.h"
+#include "Doom/Game/p_info.h"
+#include "Doom/Game/p_spec.h"
+#include "Doom/Game/p_switch.h"
+#include "Doom/Game/p_tick.h"
+#include "Doom/Game/sprinfo.h"
+#include "Doom/Renderer/r_main.h"
+#include "Doom/UI/st_main.h"
+#include "FatalErrors.h"
+#include "PsyDoom/Config/Config.h"
+#include "PsyDoom/DemoBatch.h"
+#include "PsyDoom/Game.h"
+#include "PsyDoom/MapInfo/MapInfo.h"
+#include "PsyDoom/ModMgr.h"
+#include "PsyDoom/ProgArgs.h"
+#include "PsyDoom/PsxVm.h"
+#include "PsyDoom/StateHash.h"
+#include "PsyDoom/Utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock simclock_t;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Initializes the game for the calling sim thread.
+// Mirrors what 'D_DoomMain' does on startup, minus sound, video and everything else not needed to play demos.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void initSimThread() noexcept {
+    Z_Init();
+    W_Init();
+    R_Init();
+    P_InitSprites();
+    P_InitMobjInfo();
+    P_InitAnimDefs();
+    P_InitSwitchDefs();
+    MapInfo::init();
+    ST_Init();
+
+    gPrevGameTic = 0;
+    gGameTic = 0;
+    gLastTgtGameTicCount = 0;
+    gTicCon = 0;
+    D_UpdateIsLongGameTick();
+
+    for (uint32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        gTickInputs[playerIdx] = {};
+        gOldTickInputs[playerIdx] = {};
+    }
+
+    gNextTickInputs = {};
+    gTicButtons = 0;
+    gOldTicButtons = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Cleans up the game for the calling sim thread, mirroring the cleanup done by 'D_DoomMain'
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void shutdownSimThread() noexcept {
+    StateHash::shutdown();
+    MapInfo::shutdown();
+    W_Shutdown();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Entry point for a sim thread: plays demos from the batch until there are none left to play.
+// Which demo to play next is decided by atomically incrementing the shared index of the next demo.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void simThreadMain(
+    const std::vector<DemoBatch::BatchEntry>& entries,
+    std::vector<DemoBatch::EntryResult>& results,
+    std::atomic<size_t>& nextEntryIdx
+) noexcept {
+    initSimThread();
+
+    for (size_t entryIdx = nextEntryIdx++; entryIdx < entries.size(); entryIdx = nextEntryIdx++) {
+        results[entryIdx] = DemoBatch::playEntry(entries[entryIdx]);
+    }
+
+    shutdownSimThread();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Decides how many threads to simulate demos on: uses the number requested or one per logical CPU, but no more than there are demos
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t getNumSimThreads(const size_t numEntries) noexcept {
+    const uint32_t numThreadsWanted = (ProgArgs::gNumSimThreads > 0) ? (uint32_t) ProgArgs::gNumSimThreads : std::thread::hardware_concurrency();
+    return (uint32_t) std::clamp<size_t>(std::min<size_t>(numThreadsWanted, numEntries), 1, UINT32_MAX);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Plays all of the demos in the batch across the given number of threads, saving the outcome of each demo to the given list.
+// Returns how long it took to play all of the demos, in seconds.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static double playBatch(
+    const std::vector<DemoBatch::BatchEntry>& entries,
+    const uint32_t numThreads,
+    std::vector<DemoBatch::EntryResult>& results
+) noexcept {
+    results.clear();
+    results.resize(entries.size());
+    std::atomic<size_t> nextEntryIdx = 0;
+
+    const simclock_t::time_point batchStartTime = simclock_t::now();
+
+    {
+        std::vector<std::thread> simThreads;
+        simThreads.reserve(numThreads);
+
+        for (uint32_t i = 0; i < numThreads; ++i) {
+            simThreads.emplace_back(simThreadMain, std::cref(entries), std::ref(results), std::ref(nextEntryIdx));
+        }
+
+        for (std::thread& simThread : simThreads) {
+            simThread.join();
+        }
+    }
+
+    return std::chrono::duration<double>(simclock_t::now() - batchStartTime).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Plays the batch again on a single thread and checks that every demo has the same outcome, length and final game state hash as it did
+// when played on multiple threads. This verifies that the sim threads are fully independent of each other.
+// Prints any differences and the outcome of the check, and returns 'false' if any demo did not match.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool checkMatchesSerialPlayback(
+    const std::vector<DemoBatch::BatchEntry>& entries,
+    const std::vector<DemoBatch::EntryResult>& results,
+    const uint32_t numThreads,
+    const double batchSecs
+) noexcept {
+    std::vector<DemoBatch::EntryResult> serialResults;
+    const double serialSecs = playBatch(entries, 1, serialResults);
+    uint32_t numMatched = 0;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const DemoBatch::EntryResult& result = results[i];
+        const DemoBatch::EntryResult& serialResult = serialResults[i];
+
+        const bool bMatches = (
+            (result.outcome == serialResult.outcome) &&
+            (result.numTics == serialResult.numTics) &&
+            (result.endStateHash == serialResult.endStateHash)
+        );
+
+        if (bMatches) {
+            numMatched++;
+            continue;
+        }
+
+        std::printf(
+            "PsyDoomSim: SERIAL MISMATCH %s: %s, %d tics, state hash %08X on %u threads vs %s, %d tics, state hash %08X on 1 thread\n",
+            entries[i].demoFilePath.c_str(),
+            DemoBatch::getOutcomeName(result.outcome),
+            (int) result.numTics,
+            (unsigned) result.endStateHash,
+            numThreads,
+            DemoBatch::getOutcomeName(serialResult.outcome),
+            (int) serialResult.numTics,
+            (unsigned) serialResult.endStateHash
+        );
+    }
+
+    std::printf(
+        "PsyDoomSim: serial check: %u of %u demos ended in the same state on %u threads as on 1 thread. "
+        "Serial playback took %.3f secs: %.2fx slower\n",
+        numMatched,
+        (unsigned) entries.size(),
+        numThreads,
+        serialSecs,
+        (batchSecs > 0.0) ? serialSecs / batchSecs : 0.0
+    );
+
+    return (numMatched == entries.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Plays all of the demos in the batch across the given number of threads and prints the outcome of each demo and overall throughput.
+// If requested the batch is then played again on a single thread, to check that the results match.
+// Returns 'false' if any demo could not be played, did not produce the expected result or did not match serial playback.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool runBatch(const std::vector<DemoBatch::BatchEntry>& entries, const uint32_t numThreads) noexcept {
+    std::vector<DemoBatch::EntryResult> results;
+    const double batchSecs = playBatch(entries, numThreads, results);
+
+    // Print the outcome of each demo in list order and tally up the results
+    uint32_t numPassed = 0;
+    uint32_t numFailed = 0;
+    uint32_t numUnchecked = 0;
+    uint64_t totalTics = 0;
+    double totalDemoSecs = 0.0;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const DemoBatch::EntryResult& result = results[i];
+        const char* const demoFilePath = entries[i].demoFilePath.c_str();
+
+        if (result.outcome == DemoBatch::Outcome::Missing) {
+            std::printf("PsyDoomSim: MISSING %s\n", demoFilePath);
+            numFailed++;
+            continue;
+        }
+
+        if (result.outcome == DemoBatch::Outcome::Played) {
+            numUnchecked++;
+        } else if (result.outcome == DemoBatch::Outcome::Failed) {
+            numFailed++;
+        } else {
+            numPassed++;
+        }
+
+        totalTics += (uint64_t) result.numTics;
+        totalDemoSecs += result.secs;
+        std::printf(
+            "PsyDoomSim: %s %s (%d tics, %.3f secs, state hash %08X)\n",
+            DemoBatch::getOutcomeName(result.outcome),
+            demoFilePath,
+            (int) result.numTics,
+            result.secs,
+            (unsigned) result.endStateHash
+        );
+    }
+
+    // Overall throughput, plus how much faster that is than simulating the demos one after the other on a single thread
+    std::printf(
+        "PsyDoomSim: %u demos (%u passed, %u failed, %u unchecked) on %u threads, %llu tics in %.3f secs: %.2f demos/sec, %.1f tics/sec, %.2fx speedup\n",
+        (unsigned) entries.size(),
+        numPassed,
+        numFailed,
+        numUnchecked,
+        numThreads,
+        (unsigned long long) totalTics,
+        batchSecs,
+        (batchSecs > 0.0) ? (double) entries.size() / batchSecs : 0.0,
+        (batchSecs > 0.0) ? (double) totalTics / batchSecs : 0.0,
+        (batchSecs > 0.0) ? totalDemoSecs / batchSecs : 0.0
+    );
+
+    const bool bMatchesSerial = ((!ProgArgs::gbSimCheckSerial) || checkMatchesSerialPlayback(entries, results, numThreads, batchSecs));
+    return ((numFailed == 0) && bMatchesSerial);
+}
+
+int main(const int argc, const char* const* const argv) {
+    // Note: the sim is always headless, there is no video, audio or input
+    Utils::installFatalErrorHandler();
+    ProgArgs::init(argc, argv);
+    ProgArgs::gbHeadlessMode = true;
+
+    if (!ProgArgs::gBatchDemosListFilePath[0]) {
+        std::printf("Usage: PsyDoomSim -cue <CUE_FILE_PATH> -batchdemos <DEMO_LIST_FILE_PATH> [-threads <NUM_THREADS>] [-checkserial]\n");
+        ProgArgs::shutdown();
+        Utils::uninstallFatalErrorHandler();
+        return 1;
+    }
+
+    Config::init();
+
+    // Setup the game disc and everything shared by all sim threads
+    const char* const cueFilePath = (ProgArgs::gCueFileOverride) ? ProgArgs::gCueFileOverride : Config::gCueFilePath.c_str();
+
+    if ((!cueFilePath) || (!cueFilePath[0])) {
+        FatalErrors::raise(
+            "The path to the .cue file for the game disc is not specified!\n"
+            "Set the 'CueFilePath' setting in 'game_cfg.ini' or use the '-cue <CUE_FILE_PATH>' program argument to specify the .cue file."
+        );
+    }
+
+    PsxVm::initDisc(cueFilePath);
+    Game::determineGameTypeAndVariant();
+    CdMapTbl_Init();
+    ModMgr::init();
+
+    // Play the demos
+    bool bSuccess = false;
+    std::vector<DemoBatch::BatchEntry> entries;
+
+    if (DemoBatch::readBatchList(ProgArgs::gBatchDemosListFilePath, entries)) {
+        bSuccess = runBatch(entries, getNumSimThreads(entries.size()));
+    } else {
+        std::printf("PsyDoomSim: unable to read the demo list file '%s'!\n", ProgArgs::gBatchDemosListFilePath);
+    }
+
+    ModMgr::shutdown();
+    Config::shutdown();
+    ProgArgs::shutdown();
+    Utils::uninstallFatalErrorHandler();
+    return (bSuccess) ? 0 : 1;
+}
@@ -0,0 +1,445 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoomSim: stand-ins for the parts of the engine which are not compiled into the headless demo simulator.
+// This covers video, audio, input, UI screens, networking and the like. Each stand-in does what the real code does in headless mode
+// (usually nothing), and the globals normally defined by the omitted modules are defined here instead.
+//
+// Note: any global here which is modified while a game is simulated must be 'SIM_TLS' so that each sim thread gets its own copy.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "Doom/Base/i_main.h"
+#include "Doom/Base/i_misc.h"
+#include "Doom/Base/i_texcache.h"
+#include "Doom/Base/s_sound.h"
+#include "Doom/d_main.h"
+#include "Doom/psx_main.h"
+#include "Doom/Renderer/r_bsp.h"
+#include "Doom/Renderer/r_data.h"
+#include "Doom/Renderer/r_draw.h"
+#include "Doom/Renderer/r_sky.h"
+#include "Doom/Renderer/r_things.h"
+#include "Doom/UI/cr_main.h"
+#include "Doom/UI/errormenu_main.h"
+#include "Doom/UI/f_finale.h"
+#include "Doom/UI/in_main.h"
+#include "Doom/UI/loadsave_main.h"
+#include "Doom/UI/o_main.h"
+#include "Doom/UI/pw_main.h"
+#include "PsyDoom/Cheats.h"
+#include "PsyDoom/Controls.h"
+#include "PsyDoom/DemoRecorder.h"
+#include "PsyDoom/DevMapAutoReloader.h"
+#include "PsyDoom/Input.h"
+#include "PsyDoom/LIBGPU_CmdDispatch.h"
+#include "PsyDoom/MobjSpritePrecacher.h"
+#include "PsyDoom/NetRelayClient.h"
+#include "PsyDoom/NetRollback.h"
+#include "PsyDoom/ProgArgs.h"
+#include "PsyDoom/PsxPadButtons.h"
+#include "PsyDoom/Rewind.h"
+#include "PsyDoom/Utils.h"
+#include "PsyDoom/Video.h"
+#include "PsyDoom/WorkerThreads.h"
+#include "PsyQ/LIBGPU.h"
+#include "PsyQ/LIBGTE.h"
+#include "SmallString.h"
+#include "Wess/psxspu.h"
+#include "Wess/wessapi.h"
+
+#if PSYDOOM_VULKAN_RENDERER
+    #include "Doom/RendererVk/rv_automap.h"
+    #include "Doom/RendererVk/rv_data.h"
+    #include "Doom/RendererVk/rv_main.h"
+    #include "PsyDoom/Vulkan/VRenderer.h"
+#endif
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Globals normally defined by modules that are not part of the sim
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+// From 'i_main.cpp': timing, player, controls and temporary buffer state for the game being simulated
+SIM_TLS uint32_t gTotalVBlanks;
+SIM_TLS uint32_t gLastTotalVBlanks;
+SIM_TLS uint32_t gElapsedVBlanks;
+SIM_TLS int32_t gCurPlayerIndex;
+
+SIM_TLS padbuttons_t gCtrlBindings[NUM_CTRL_BINDS] = {
+    PAD_TRIANGLE | PSX_MOUSE_LEFT,
+    PAD_CIRCLE,
+    PAD_CROSS | PSX_MOUSE_RIGHT,
+    PAD_SQUARE,
+    PAD_L1,
+    PAD_R1,
+    PAD_L2,
+    PAD_R2,
+    0,          // Move forward is default unbound
+    0           // Move backward is default unbound
+};
+
+SIM_TLS int32_t gPsxMouseSensitivity = 50;
+SIM_TLS texture_t gTex_STATUS;
+texture_t gTex_LOADING;
+
+#if PSYDOOM_LIMIT_REMOVING
+    SIM_TLS ResizableBuffer gTmpBuffer(1024 * 1024);
+#else
+    SIM_TLS std::byte gTmpBuffer[TMP_BUFFER_SIZE];
+#endif
+
+int32_t gNetTimeAdjustMs;
+bool gbNetIsGameBeingRecorded;
+
+// From 'psx_main.cpp': whether the demo just played did not produce the expected result
+SIM_TLS bool gbCheckDemoResultFailed = false;
+
+// From 's_sound.cpp': CD music tracks and volume (only read by the sim)
+uint32_t gCDTrackNum[NUM_CD_MUSIC_TRACKS] = {
+    2,      // cdmusic_title_screen
+    3,      // cdmusic_main_menu
+    4,      // cdmusic_credits_demo
+    5,      // cdmusic_intermission
+    6,      // cdmusic_club_doom
+    7,      // cdmusic_finale_doom1_final_doom
+    8,      // cdmusic_finale_doom2
+};
+int32_t gCdMusicVol = PSXSPU_MAX_CD_VOL;
+
+// From 'r_sky.cpp', 'in_main.cpp', 'pw_main.cpp' and 'o_main.cpp': UI and sky state touched by the game logic
+SIM_TLS uint16_t gPaletteClutId_CurMapSky;
+SIM_TLS bool gbIntermissionHideNextMap;
+SIM_TLS bool gbUsingAPassword;
+int32_t gNumPasswordCharsEntered;
+uint8_t gPasswordCharBuffer[PW_SEQ_LEN];
+int32_t gOptionsSndVol = S_SND_DEFAULT_VOL;
+int32_t gOptionsMusVol = S_MUS_DEFAULT_VOL;
+bool gbUnpauseAfterOptionsMenu;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// 'i_main.cpp': the sim is always headless, so errors terminate the program and time only advances as demo tics are simulated
+//------------------------------------------------------------------------------------------------------------------------------------------
+[[noreturn]] void I_Error(const char* const fmtMsg, ...) noexcept {
+    char msgBuffer[2048];
+
+    {
+        va_list args;
+        va_start(args, fmtMsg);
+        std::vsnprintf(msgBuffer, sizeof(msgBuffer), fmtMsg, args);
+        va_end(args);
+    }
+
+    std::printf("I_Error: %s", msgBuffer);
+    std::abort();
+}
+
+uint32_t I_ReadGamepad() noexcept { return 0; }
+void I_LoadAndCacheTexLump([[maybe_unused]] texture_t& tex, [[maybe_unused]] const char* const name, [[maybe_unused]] int32_t lumpNum) noexcept {}
+void I_DrawLoadingPlaque([[maybe_unused]] texture_t& tex, [[maybe_unused]] const int16_t xpos, [[maybe_unused]] const int16_t ypos, [[maybe_unused]] const int16_t clutId) noexcept {}
+void I_IncDrawnFrameCount() noexcept {}
+void I_DrawPresent() noexcept {}
+bool I_NetUpdate() noexcept { return false; }
+void I_NetHandshake() noexcept {}
+void I_SubmitGpuCmds() noexcept {}
+int32_t I_GetTotalVBlanks() noexcept { return (int32_t) gTotalVBlanks; }
+
+std::chrono::steady_clock::time_point I_GetVBlankTimepoint([[maybe_unused]] const int32_t vblankIdx) noexcept {
+    return {};
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// 'i_misc.cpp' and 'i_texcache.cpp': nothing is ever drawn or uploaded to VRAM
+//------------------------------------------------------------------------------------------------------------------------------------------
+void I_DrawNumber([[maybe_unused]] const int32_t x, [[maybe_unused]] const int32_t y, [[maybe_unused]] const int32_t value) noexcept {}
+
+void I_DrawStringSmall(
+    [[maybe_unused]] const int32_t x,
+    [[maybe_unused]] const int32_t y,
+    [[maybe_unused]] const char* const str,
+    [[maybe_unused]] const uint16_t clutId,
+    [[maybe_unused]] const uint8_t r,
+    [[maybe_unused]] const uint8_t g,
+    [[maybe_unused]] const uint8_t b,
+    [[maybe_unused]] const bool bSemiTransparent,
+    [[maybe_unused]] const bool bDisableShading
+) noexcept {}
+
+void I_DrawPausedOverlay() noexcept {}
+void I_UpdatePalette() noexcept {}
+uint32_t I_GetNumTexCachePages() noexcept { return 0; }
+uint32_t I_GetCurTexCacheFillPage() noexcept { return 0; }
+void I_SetTexCacheFillPage([[maybe_unused]] const uint32_t pageIdx) noexcept {}
+
+#if PSYDOOM_LIMIT_REMOVING
+    void I_TexCacheUseLoosePacking([[maybe_unused]] const bool bUseLoosePacking) noexcept {}
+    void I_LockAllWallAndFloorTextures([[maybe_unused]] const bool bLock) noexcept {}
+#endif
+
+void I_CacheTex([[maybe_unused]] texture_t& tex) noexcept {}
+void I_PurgeTexCache() noexcept {}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// 'd_main.cpp': there are no performance counters to draw
+//------------------------------------------------------------------------------------------------------------------------------------------
+void I_DrawEnabledPerfCounters() noexcept {}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Renderers: the sim never draws anything
+//------------------------------------------------------------------------------------------------------------------------------------------
+void R_BSP() noexcept {}
+void R_InitDrawBuffers() noexcept {}
+void R_DrawSubsector([[maybe_unused]] subsector_t& subsec) noexcept {}
+void R_DrawSky() noexcept {}
+void R_DrawWeapon() noexcept {}
+
+#if PSYDOOM_VULKAN_RENDERER
+    void RV_DrawAutomap() noexcept {}
+    void RV_InitLevelData() noexcept {}
+    void RV_FreeLevelData() noexcept {}
+    void RV_RenderPlayerView() noexcept {}
+#endif
+
+void LIBGPU_SetTexWindow([[maybe_unused]] DR_TWIN& prim, [[maybe_unused]] const SRECT& texWin) noexcept {}
+
+void LIBGPU_SetDrawMode(
+    [[maybe_unused]] DR_MODE& modePrim,
+    [[maybe_unused]] const bool bCanDrawInDisplayArea,
+    [[maybe_unused]] const bool bDitheringOn,
+    [[maybe_unused]] const uint16_t texPageId,
+    [[maybe_unused]] const SRECT* const pNewTexWindow
+) noexcept {}
+
+int32_t LIBGPU_DrawSync([[maybe_unused]] const int32_t mode) noexcept { return 0; }
+void LIBGPU_LoadImage([[maybe_unused]] const SRECT& dstRect, [[maybe_unused]] const uint16_t* const pImageData) noexcept {}
+uint16_t LIBGPU_GetClut([[maybe_unused]] const int32_t x, [[maybe_unused]] const int32_t y) noexcept { return 0; }
+void LIBGPU_SetSprt([[maybe_unused]] SPRT& sprt) noexcept {}
+void LIBGPU_SetLineF2([[maybe_unused]] LINE_F2& line) noexcept {}
+void LIBGTE_SetRotMatrix([[maybe_unused]] const MATRIX& m) noexcept {}
+void LIBGTE_SetTransMatrix([[maybe_unused]] const MATRIX& m) noexcept {}
+
+BEGIN_NAMESPACE(LIBGPU_CmdDispatch)
+
+void submit([[maybe_unused]] const DR_MODE& drawMode) noexcept {}
+void submit([[maybe_unused]] const DR_TWIN& texWin) noexcept {}
+void submit([[maybe_unused]] const SPRT& sprite) noexcept {}
+void submit([[maybe_unused]] const LINE_F2& line) noexcept {}
+
+END_NAMESPACE(LIBGPU_CmdDispatch)
+
+BEGIN_NAMESPACE(Video)
+
+BackendType gBackendType = BackendType::SDL;
+
+bool isUsingVulkanRenderPath() noexcept { return false; }
+
+END_NAMESPACE(Video)
+
+#if PSYDOOM_VULKAN_RENDERER
+BEGIN_NAMESPACE(VRenderer)
+
+float gPsxCoordsFbX;
+float gPsxCoordsFbW;
+
+END_NAMESPACE(VRenderer)
+#endif
+
+BEGIN_NAMESPACE(MobjSpritePrecacher)
+
+void doPrecaching() noexcept {}
+
+END_NAMESPACE(MobjSpritePrecacher)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Sound and music: there is no audio in the sim, so sequences are never playing and the CD volume never changes
+//------------------------------------------------------------------------------------------------------------------------------------------
+#if PSYDOOM_MODS
+    CdFileId S_GetSoundLcdFileId([[maybe_unused]] const int32_t num) noexcept { return {}; }
+    void S_PreloadMapSoundAndMusic([[maybe_unused]] const int32_t mapNum) noexcept {}
+#endif
+
+void S_StopMusic() noexcept {}
+void S_StartMusic() noexcept {}
+void S_LoadMapSoundAndMusic([[maybe_unused]] const int32_t mapNum) noexcept {}
+void S_Pause() noexcept {}
+void S_Resume() noexcept {}
+void S_StopSound([[maybe_unused]] const mobj_t* pOrigin) noexcept {}
+void S_StartSound([[maybe_unused]] mobj_t* const pOrigin, [[maybe_unused]] const sfxenum_t soundId) noexcept {}
+void S_UpdateSounds() noexcept {}
+
+void psxspu_init() noexcept {}
+void psxspu_setcdmixon() noexcept {}
+void psxspu_set_cd_vol([[maybe_unused]] const int32_t vol) noexcept {}
+int32_t psxspu_get_cd_vol() noexcept { return 0; }
+void psxspu_start_cd_fade([[maybe_unused]] const int32_t fadeTimeMs, [[maybe_unused]] const int32_t destVol) noexcept {}
+void psxspu_stop_cd_fade() noexcept {}
+
+void wess_seq_trigger([[maybe_unused]] const int32_t seqIdx) noexcept {}
+SequenceStatus wess_seq_status([[maybe_unused]] const int32_t seqIdx) noexcept { return SequenceStatus::SEQUENCE_INACTIVE; }
+void wess_seq_stop([[maybe_unused]] const int32_t seqIdx) noexcept {}
+void wess_seq_stopall() noexcept {}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Input and controls: demos supply all of the inputs, there is no input from the user
+//------------------------------------------------------------------------------------------------------------------------------------------
+BEGIN_NAMESPACE(Input)
+
+void update() noexcept {}
+void pumpEvents() noexcept {}
+void consumeEvents() noexcept {}
+void consumeMouseMovements() noexcept {}
+bool isQuitRequested() noexcept { return false; }
+float getMouseXMovement() noexcept { return 0.0f; }
+float getPendingMouseXMovement() noexcept { return 0.0f; }
+
+END_NAMESPACE(Input)
+
+BEGIN_NAMESPACE(Controls)
+
+void parseBinding([[maybe_unused]] const Binding binding, [[maybe_unused]] const char* const str) noexcept {}
+float getFloat([[maybe_unused]] const Binding binding) noexcept { return 0.0f; }
+bool getBool([[maybe_unused]] const Binding binding) noexcept { return false; }
+bool isJustPressed([[maybe_unused]] const Binding binding) noexcept { return false; }
+uint16_t getPSXCheatButtonBits() noexcept { return 0; }
+void bindingToStr([[maybe_unused]] const Binding binding, std::string& outputStr) noexcept { outputStr.clear(); }
+
+END_NAMESPACE(Controls)
+
+BEGIN_NAMESPACE(Cheats)
+
+void update() noexcept {}
+
+END_NAMESPACE(Cheats)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// UI screens: demo playback never shows any of these, and demo errors end playback just like they do in headless mode
+//------------------------------------------------------------------------------------------------------------------------------------------
+void F1_Start() noexcept {}
+void F1_Stop([[maybe_unused]] const gameaction_t exitAction) noexcept {}
+gameaction_t F1_Ticker() noexcept { return ga_exit; }
+void F1_Drawer() noexcept {}
+void F2_Start() noexcept {}
+void F2_Stop([[maybe_unused]] const gameaction_t exitAction) noexcept {}
+gameaction_t F2_Ticker() noexcept { return ga_exit; }
+void F2_Drawer() noexcept {}
+void IN_Start() noexcept {}
+void IN_Stop([[maybe_unused]] const gameaction_t exitAction) noexcept {}
+gameaction_t IN_Ticker() noexcept { return ga_exit; }
+void IN_Drawer() noexcept {}
+void O_Init() noexcept {}
+void O_Shutdown([[maybe_unused]] const gameaction_t exitAction) noexcept {}
+gameaction_t O_Control() noexcept { return ga_exit; }
+void O_Drawer() noexcept {}
+void START_Credits() noexcept {}
+void STOP_Credits([[maybe_unused]] const gameaction_t exitAction) noexcept {}
+gameaction_t TIC_Credits() noexcept { return ga_exit; }
+void DRAW_Credits() noexcept {}
+
+gameaction_t RunLoadGameErrorMenu_BadMapHash() noexcept { return ga_restart; }
+gameaction_t RunLoadGameErrorMenu_BadMapData() noexcept { return ga_restart; }
+gameaction_t RunDemoErrorMenu_UnexpectedEOF() noexcept { return ga_exit; }
+gameaction_t RunDemoErrorMenu_InvalidDemoVersion() noexcept { return ga_exit; }
+gameaction_t RunDemoErrorMenu_InvalidSkill() noexcept { return ga_exit; }
+gameaction_t RunDemoErrorMenu_InvalidMapNumber() noexcept { return ga_exit; }
+gameaction_t RunDemoErrorMenu_InvalidGameType() noexcept { return ga_exit; }
+gameaction_t RunDemoErrorMenu_InvalidPlayerNum() noexcept { return ga_exit; }
+gameaction_t RunDemoErrorMenu_BadMapHash() noexcept { return ga_exit; }
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Saving and loading: never done while simulating demos
+//------------------------------------------------------------------------------------------------------------------------------------------
+void ClearLoadSaveOnLevelStartFlag() noexcept {}
+bool ShouldLoadSaveOnLevelStart() noexcept { return false; }
+void DisplayLoadedHudMessage([[maybe_unused]] const LoadGameContext loadContext, [[maybe_unused]] const bool bSuccess) noexcept {}
+gameaction_t DoQuickload() noexcept { return ga_nothing; }
+void DoQuicksave() noexcept {}
+gameaction_t SaveGameForSlot([[maybe_unused]] const SaveFileSlot slot, [[maybe_unused]] const SaveGameContext saveContext) noexcept { return ga_nothing; }
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Demo recording, rewinding, dev map reloading and networking: none of these are active during demo playback
+//------------------------------------------------------------------------------------------------------------------------------------------
+BEGIN_NAMESPACE(DemoRecorder)
+
+void begin() noexcept {}
+void end() noexcept {}
+bool isRecording() noexcept { return false; }
+void recordTick() noexcept {}
+uint32_t getNumTicksRecorded() noexcept { return 0; }
+
+END_NAMESPACE(DemoRecorder)
+
+BEGIN_NAMESPACE(Rewind)
+
+void onLevelStart() noexcept {}
+void onLevelEnd() noexcept {}
+void update() noexcept {}
+bool rewind() noexcept { return true; }
+
+END_NAMESPACE(Rewind)
+
+BEGIN_NAMESPACE(DevMapAutoReloader)
+
+void init([[maybe_unused]] const CdFileId mapWadFile) noexcept {}
+void shutdown() noexcept {}
+void update() noexcept {}
+
+END_NAMESPACE(DevMapAutoReloader)
+
+BEGIN_NAMESPACE(NetRelayClient)
+
+bool isTapConnected() noexcept { return false; }
+bool isSpectating() noexcept { return false; }
+bool waitForTickData() noexcept { return true; }
+bool checkStateHash([[maybe_unused]] const uint32_t tickIdx) noexcept { return true; }
+bool hasReachedStreamEnd() noexcept { return true; }
+
+const std::vector<std::byte>& getJoinSnapshot() noexcept {
+    static const std::vector<std::byte> NO_SNAPSHOT;
+    return NO_SNAPSHOT;
+}
+
+uint32_t getCatchUpTick() noexcept { return 0; }
+
+END_NAMESPACE(NetRelayClient)
+
+BEGIN_NAMESPACE(NetRollback)
+
+bool isResimulating() noexcept { return false; }
+bool beginLoop() noexcept { return false; }
+void endLoop([[maybe_unused]] const gameaction_t exitAction) noexcept {}
+void onLevelStart() noexcept {}
+gameaction_t confirmGameAction(const gameaction_t action) noexcept { return action; }
+gameaction_t getPendingExitAction() noexcept { return ga_nothing; }
+
+END_NAMESPACE(NetRollback)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Worker threads: each sim thread is already one of many, so jobs are simply run in order on the calling thread.
+// This also keeps jobs on the thread which owns the 'SIM_TLS' game state that they read.
+//------------------------------------------------------------------------------------------------------------------------------------------
+BEGIN_NAMESPACE(WorkerThreads)
+
+uint32_t getNumThreads() noexcept { return 1; }
+
+void runJobs(const uint32_t numJobs, const JobFunc pJobFunc, void* const pUserData) noexcept {
+    for (uint32_t jobIdx = 0; jobIdx < numJobs; ++jobIdx) {
+        pJobFunc(jobIdx, pUserData);
+    }
+}
+
+END_NAMESPACE(WorkerThreads)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// 'Utils.cpp': the platform specific and audio/video parts, in their headless form
+//------------------------------------------------------------------------------------------------------------------------------------------
+BEGIN_NAMESPACE(Utils)
+
+void installFatalErrorHandler() noexcept {}
+void uninstallFatalErrorHandler() noexcept {}
+std::string getOrCreateUserDataFolder() noexcept { return {}; }
+bool waitUntilSeqExitedStatus([[maybe_unused]] const int32_t sequenceIdx, [[maybe_unused]] const SequenceStatus status) noexcept { return false; }
+bool waitForCdAudioFadeOut() noexcept { return false; }
+void checkForRendererToggleInput() noexcept {}
+void checkForProfilerCaptureToggleInput() noexcept {}
+
+END_NAMESPACE(Utils)
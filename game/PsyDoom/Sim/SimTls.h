@@ -0,0 +1,13 @@
+#pragma once
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Marks global state belonging to a single running game simulation.
+//
+// In the headless 'PsyDoomSim' build (see 'SimMain.cpp') this state is thread local, which gives every sim thread its own independent
+// copy of the game world, so that many demos can be simulated at once. In the normal game build this marker expands to nothing.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#if PSYDOOM_SIM
+    #define SIM_TLS thread_local
+#else
+    #define SIM_TLS
+#endif
@@ -0,0 +1,538 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A cheap hash of the game simulation state, used to detect when two copies of the same game diverge.
+// Used by networked games to check both players are in sync, and to trace demo playback tick by tick in order to find the exact tick
+// where playback first diverges from a recording (rather than only finding out at the very end of the demo).
+//
+// The hash only covers state that can change from tick to tick: random number generator indexes, players, map objects (including who they
+// are targeting), the changeable fields of sectors, and the special thinkers which move sectors and change their lighting. It depends only
+// on the current game state, so it is equally valid straight after loading a save or snapshot. Static level geometry is never hashed.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "StateHash.h"
+
+#include "DemoPlayer.h"
+#include "DemoRecorder.h"
+#include "Doom/Base/m_random.h"
+#include "Doom/Game/g_game.h"
+#include "Doom/Game/info.h"
+#include "Doom/Game/p_ceiling.h"
+#include "Doom/Game/p_doors.h"
+#include "Doom/Game/p_floor.h"
+#include "Doom/Game/p_lights.h"
+#include "Doom/Game/p_plats.h"
+#include "Doom/Game/p_setup.h"
+#include "Doom/Game/p_tick.h"
+#include "Doom/Renderer/r_local.h"
+#include "Endian.h"
+#include "FileOutputStream.h"
+#include "FileUtils.h"
+#include "ProgArgs.h"
+#include "Sim/SimTls.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+BEGIN_NAMESPACE(StateHash)
+
+// Identifies a state hash trace file and the format version
+static constexpr uint32_t TRACE_FILE_ID = 0x52544853;       // 'SHTR'
+static constexpr uint32_t TRACE_FILE_VERSION = 2;
+
+// The header for a state hash trace file
+struct TraceFileHdr {
+    uint32_t    fileId;
+    uint32_t    version;
+
+    void byteSwap() noexcept {
+        Endian::byteSwapInPlace(fileId);
+        Endian::byteSwapInPlace(version);
+    }
+};
+
+// One entry in a state hash trace file: the state hash at the start of a particular demo tick
+struct TraceRecord {
+    int32_t     mapNum;
+    uint32_t    tickIdx;
+    TickHash    hash;
+
+    void byteSwap() noexcept {
+        Endian::byteSwapInPlace(mapNum);
+        Endian::byteSwapInPlace(tickIdx);
+        hash.byteSwap();
+    }
+};
+
+static_assert(sizeof(TraceRecord) == 24);
+
+// Index of each map object in the map object list, so that references between map objects can be hashed.
+// Rebuilt on each hash but kept around to avoid reallocating.
+static SIM_TLS std::unordered_map<const mobj_t*, int32_t> gMobjIndexes;
+
+// State for saving or checking a trace of the hash for each demo tick
+static SIM_TLS std::unique_ptr<FileOutputStream>        gpTraceOutFile;         // Trace file being saved (if saving a trace)
+static SIM_TLS bool                                     gbTraceFileFailed;      // True if opening, reading or writing a trace file failed
+static SIM_TLS bool                                     gbLoadedCheckTrace;     // True if the trace to check against was loaded
+static SIM_TLS std::unordered_map<uint64_t, TickHash>   gCheckTrace;            // Trace to check against: indexed by map number and demo tick
+static SIM_TLS int32_t                                  gLastSavedMapNum;       // The map and demo tick last saved to the trace file
+static SIM_TLS uint32_t                                 gLastSavedTickIdx;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Mixes a 32-bit value into the given hash (MurmurHash3 style)
+//------------------------------------------------------------------------------------------------------------------------------------------
+static inline uint32_t rotl(const uint32_t value, const uint32_t shift) noexcept {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+static inline void mix(uint32_t& hash, const uint32_t value) noexcept {
+    uint32_t k = value * 0xCC9E2D51u;
+    k = rotl(k, 15) * 0x1B873593u;
+    hash ^= k;
+    hash = rotl(hash, 13) * 5 + 0xE6546B64u;
+}
+
+static inline void mix(uint32_t& hash, const int32_t value) noexcept {
+    mix(hash, (uint32_t) value);
+}
+
+static inline uint32_t finalize(uint32_t hash) noexcept {
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Combines all the parts of the hash into a single value
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t TickHash::combined() const noexcept {
+    uint32_t hash = 0;
+    mix(hash, rng);
+    mix(hash, players);
+    mix(hash, mobjs);
+    mix(hash, sectors);
+    return finalize(hash);
+}
+
+bool TickHash::operator == (const TickHash& other) const noexcept {
+    return ((rng == other.rng) && (players == other.players) && (mobjs == other.mobjs) && (sectors == other.sectors));
+}
+
+bool TickHash::operator != (const TickHash& other) const noexcept {
+    return (!(*this == other));
+}
+
+void TickHash::byteSwap() noexcept {
+    Endian::byteSwapInPlace(rng);
+    Endian::byteSwapInPlace(players);
+    Endian::byteSwapInPlace(mobjs);
+    Endian::byteSwapInPlace(sectors);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gets the index of a map object in the map object list for hashing references to it, or '-1' if null or not found.
+// The indexes must have been built by 'hashMobjs' beforehand.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static int32_t getMobjIndex(const mobj_t* const pMobj) noexcept {
+    if (!pMobj)
+        return -1;
+
+    const auto iter = gMobjIndexes.find(pMobj);
+    return (iter != gMobjIndexes.end()) ? iter->second : -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Hashes each of the different categories of game state
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t hashRng() noexcept {
+    uint32_t hash = 0;
+    mix(hash, gPRndIndex);
+    mix(hash, gMRndIndex);
+    return finalize(hash);
+}
+
+static uint32_t hashPlayers() noexcept {
+    uint32_t hash = 0;
+
+    for (int32_t playerIdx = 0; playerIdx < MAXPLAYERS; ++playerIdx) {
+        if (!gbPlayerInGame[playerIdx])
+            continue;
+
+        const player_t& player = gPlayers[playerIdx];
+        mix(hash, (int32_t) player.playerstate);
+        mix(hash, player.viewz);
+        mix(hash, player.health);
+        mix(hash, player.armorpoints);
+        mix(hash, player.armortype);
+        mix(hash, (int32_t) player.readyweapon);
+        mix(hash, (int32_t) player.pendingweapon);
+        mix(hash, player.attackdown);
+        mix(hash, player.refire);
+        mix(hash, player.killcount);
+        mix(hash, player.itemcount);
+        mix(hash, player.secretcount);
+        mix(hash, player.frags);
+
+        for (int32_t power : player.powers) {
+            mix(hash, power);
+        }
+
+        for (int32_t ammo : player.ammo) {
+            mix(hash, ammo);
+        }
+
+        for (int32_t maxAmmo : player.maxammo) {
+            mix(hash, maxAmmo);
+        }
+
+        uint32_t ownedBits = (player.backpack) ? 1 : 0;
+
+        for (int32_t i = 0; i < NUMCARDS; ++i) {
+            ownedBits = (ownedBits << 1) | ((player.cards[i]) ? 1 : 0);
+        }
+
+        for (int32_t i = 0; i < NUMWEAPONS; ++i) {
+            ownedBits = (ownedBits << 1) | ((player.weaponowned[i]) ? 1 : 0);
+        }
+
+        mix(hash, ownedBits);
+
+        for (const pspdef_t& psprite : player.psprites) {
+            mix(hash, (psprite.state) ? (int32_t)(psprite.state - gStates) : -1);
+            mix(hash, psprite.tics);
+        }
+    }
+
+    return finalize(hash);
+}
+
+static uint32_t hashMobjs() noexcept {
+    // Number all the map objects first so that the things they target can be hashed by index
+    gMobjIndexes.clear();
+    int32_t numMobjs = 0;
+
+    for (const mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
+        gMobjIndexes[pMobj] = numMobjs++;
+    }
+
+    uint32_t hash = 0;
+
+    for (const mobj_t* pMobj = gMobjHead.next; pMobj != &gMobjHead; pMobj = pMobj->next) {
+        const mobj_t& mobj = *pMobj;
+        mix(hash, (int32_t) mobj.type);
+        mix(hash, mobj.x);
+        mix(hash, mobj.y);
+        mix(hash, mobj.z);
+        mix(hash, mobj.angle);
+        mix(hash, mobj.momx);
+        mix(hash, mobj.momy);
+        mix(hash, mobj.momz);
+        mix(hash, mobj.floorz);
+        mix(hash, mobj.ceilingz);
+        mix(hash, mobj.flags);
+        mix(hash, mobj.health);
+        mix(hash, mobj.tics);
+        mix(hash, (mobj.state) ? (int32_t)(mobj.state - gStates) : -1);
+        mix(hash, (int32_t) mobj.movedir);
+        mix(hash, mobj.movecount);
+        mix(hash, mobj.reactiontime);
+        mix(hash, mobj.threshold);
+        mix(hash, getMobjIndex(mobj.target));
+        mix(hash, getMobjIndex(mobj.tracer));
+    }
+
+    return finalize(hash);
+}
+
+static uint32_t hashSectors() noexcept {
+    uint32_t hash = 0;
+
+    // The changeable fields of all sectors
+    for (int32_t sectorIdx = 0; sectorIdx < gNumSectors; ++sectorIdx) {
+        const sector_t& sector = gpSectors[sectorIdx];
+        mix(hash, (fixed_t) sector.floorheight);
+        mix(hash, (fixed_t) sector.ceilingheight);
+        mix(hash, sector.floorpic);
+        mix(hash, sector.ceilingpic);
+        mix(hash, (int32_t) sector.colorid);
+        mix(hash, (int32_t) sector.lightlevel);
+        mix(hash, sector.special);
+        mix(hash, sector.tag);
+        mix(hash, sector.flags);
+        mix(hash, getMobjIndex(sector.soundtarget));
+        mix(hash, (sector.specialdata) ? 1 : 0);
+
+        #if PSYDOOM_MODS
+            mix(hash, (fixed_t) sector.floorTexOffsetX);
+            mix(hash, (fixed_t) sector.floorTexOffsetY);
+            mix(hash, (fixed_t) sector.ceilTexOffsetX);
+            mix(hash, (fixed_t) sector.ceilTexOffsetY);
+        #endif
+    }
+
+    // The state of the special thinkers which move sectors or change their lighting, in thinker list order.
+    // Note: paused ceilings and platforms have no thinker function, so all of those are hashed separately below.
+    const auto sectorIndex = [](const sector_t* const pSector) noexcept {
+        return (pSector) ? (int32_t)(pSector - gpSectors) : -1;
+    };
+
+    for (const thinker_t* pThinker = gThinkerCap.next; pThinker != &gThinkerCap; pThinker = pThinker->next) {
+        const think_t thinkFn = pThinker->function;
+
+        if (thinkFn == (think_t) &T_VerticalDoor) {
+            const vldoor_t& door = reinterpret_cast<const vldoor_t&>(*pThinker);
+            mix(hash, sectorIndex(door.sector));
+            mix(hash, (int32_t) door.type);
+            mix(hash, door.topheight);
+            mix(hash, door.speed);
+            mix(hash, door.direction);
+            mix(hash, door.topcountdown);
+        }
+        #if PSYDOOM_MODS
+            else if (thinkFn == (think_t) &T_CustomDoor) {
+                const vlcustomdoor_t& door = reinterpret_cast<const vlcustomdoor_t&>(*pThinker);
+                mix(hash, sectorIndex(door.sector));
+                mix(hash, door.direction);
+                mix(hash, door.postWaitDirection);
+                mix(hash, door.countdown);
+            }
+        #endif
+        else if (thinkFn == (think_t) &T_MoveFloor) {
+            const floormove_t& floor = reinterpret_cast<const floormove_t&>(*pThinker);
+            mix(hash, sectorIndex(floor.sector));
+            mix(hash, (int32_t) floor.type);
+            mix(hash, floor.direction);
+            mix(hash, floor.floordestheight);
+            mix(hash, floor.speed);
+        }
+        else if (thinkFn == (think_t) &T_FireFlicker) {
+            const fireflicker_t& light = reinterpret_cast<const fireflicker_t&>(*pThinker);
+            mix(hash, sectorIndex(light.sector));
+            mix(hash, light.count);
+        }
+        else if (thinkFn == (think_t) &T_LightFlash) {
+            const lightflash_t& light = reinterpret_cast<const lightflash_t&>(*pThinker);
+            mix(hash, sectorIndex(light.sector));
+            mix(hash, light.count);
+        }
+        else if (thinkFn == (think_t) &T_StrobeFlash) {
+            const strobe_t& light = reinterpret_cast<const strobe_t&>(*pThinker);
+            mix(hash, sectorIndex(light.sector));
+            mix(hash, light.count);
+        }
+        else if (thinkFn == (think_t) &T_Glow) {
+            const glow_t& light = reinterpret_cast<const glow_t&>(*pThinker);
+            mix(hash, sectorIndex(light.sector));
+            mix(hash, light.direction);
+        }
+    }
+
+    for (const ceiling_t* const pCeiling : gpActiveCeilings) {
+        if (pCeiling) {
+            mix(hash, sectorIndex(pCeiling->sector));
+            mix(hash, (int32_t) pCeiling->type);
+            mix(hash, pCeiling->bottomheight);
+            mix(hash, pCeiling->topheight);
+            mix(hash, pCeiling->speed);
+            mix(hash, pCeiling->direction);
+            mix(hash, pCeiling->olddirection);
+        }
+    }
+
+    for (const plat_t* const pPlat : gpActivePlats) {
+        if (pPlat) {
+            mix(hash, sectorIndex(pPlat->sector));
+            mix(hash, (int32_t) pPlat->type);
+            mix(hash, pPlat->speed);
+            mix(hash, pPlat->low);
+            mix(hash, pPlat->high);
+            mix(hash, pPlat->count);
+            mix(hash, (int32_t) pPlat->status);
+            mix(hash, (int32_t) pPlat->oldstatus);
+        }
+    }
+
+    return finalize(hash);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Cleans up any trace file being saved and frees memory
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    gpTraceOutFile.reset();
+    gbTraceFileFailed = false;
+    gbLoadedCheckTrace = false;
+    gCheckTrace.clear();
+    gLastSavedMapNum = 0;
+    gLastSavedTickIdx = 0;
+    gMobjIndexes.clear();
+    gMobjIndexes.rehash(0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the hash of the current game state
+//------------------------------------------------------------------------------------------------------------------------------------------
+TickHash compute() noexcept {
+    TickHash hash = {};
+    hash.rng = hashRng();
+    hash.players = hashPlayers();
+    hash.mobjs = hashMobjs();
+    hash.sectors = hashSectors();
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if state hashes for each demo tick are being saved or checked
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isTracing() noexcept {
+    return ((ProgArgs::gSaveStateHashesFilePath[0] || ProgArgs::gCheckStateHashesFilePath[0]) && (!gbTraceFileFailed));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Loads the trace of state hashes to check against
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool loadCheckTrace(const char* const filePath) noexcept {
+    const FileData fileData = FileUtils::getContentsOfFile(filePath);
+
+    if ((!fileData.bytes) || (fileData.size < sizeof(TraceFileHdr))) {
+        std::printf("Failed to read the state hash trace file '%s'!\n", filePath);
+        return false;
+    }
+
+    TraceFileHdr hdr;
+    std::memcpy(&hdr, fileData.bytes.get(), sizeof(TraceFileHdr));
+
+    if constexpr (Endian::isBig()) {
+        hdr.byteSwap();
+    }
+
+    if ((hdr.fileId != TRACE_FILE_ID) || (hdr.version != TRACE_FILE_VERSION)) {
+        std::printf("The state hash trace file '%s' is not valid or is for a different version of PsyDoom!\n", filePath);
+        return false;
+    }
+
+    const size_t numRecords = (fileData.size - sizeof(TraceFileHdr)) / sizeof(TraceRecord);
+    gCheckTrace.reserve(numRecords);
+
+    for (size_t i = 0; i < numRecords; ++i) {
+        TraceRecord record;
+        std::memcpy(&record, fileData.bytes.get() + sizeof(TraceFileHdr) + i * sizeof(TraceRecord), sizeof(TraceRecord));
+
+        if constexpr (Endian::isBig()) {
+            record.byteSwap();
+        }
+
+        // Note: if the same tick appears more than once then the last record wins, since that is for the latest attempt at the map
+        gCheckTrace[((uint64_t)(uint32_t) record.mapNum << 32) | record.tickIdx] = record.hash;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Saves the hash for the current demo tick to the trace file, if it was not saved already (can happen when seeking backwards in a demo).
+// The first tick of a map is always saved however, since the map may have been restarted while recording: later records take precedence.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void saveTraceRecord(const int32_t mapNum, const uint32_t tickIdx, const TickHash& hash) THROWS {
+    if (!gpTraceOutFile) {
+        gpTraceOutFile = std::make_unique<FileOutputStream>(ProgArgs::gSaveStateHashesFilePath, false);
+
+        TraceFileHdr hdr = { TRACE_FILE_ID, TRACE_FILE_VERSION };
+
+        if constexpr (Endian::isBig()) {
+            hdr.byteSwap();
+        }
+
+        gpTraceOutFile->write(hdr);
+    }
+    else if ((mapNum == gLastSavedMapNum) && (tickIdx > 1) && (tickIdx <= gLastSavedTickIdx)) {
+        return;
+    }
+
+    TraceRecord record = { mapNum, tickIdx, hash };
+
+    if constexpr (Endian::isBig()) {
+        record.byteSwap();
+    }
+
+    gpTraceOutFile->write(record);
+    gLastSavedMapNum = mapNum;
+    gLastSavedTickIdx = tickIdx;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Checks the hash for the current demo tick against the trace being checked.
+// Returns 'false' if there is a mismatch. Ticks which are not in the trace are not checked.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool checkTraceRecord(const int32_t mapNum, const uint32_t tickIdx, const TickHash& hash) noexcept {
+    const auto iter = gCheckTrace.find(((uint64_t)(uint32_t) mapNum << 32) | tickIdx);
+
+    if ((iter == gCheckTrace.end()) || (iter->second == hash))
+        return true;
+
+    const TickHash& expected = iter->second;
+    std::printf(
+        "State hash mismatch on map %d at demo tick %u! Mismatched state:%s%s%s%s\n",
+        mapNum,
+        tickIdx,
+        (expected.rng != hash.rng) ? " rng" : "",
+        (expected.players != hash.players) ? " players" : "",
+        (expected.mobjs != hash.mobjs) ? " mobjs" : "",
+        (expected.sectors != hash.sectors) ? " sectors" : ""
+    );
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Saves and/or checks the state hash for the demo tick just read or recorded, if tracing is enabled.
+// The hash is of the game state before the tick's inputs are applied. Returns 'false' if the hash does not match the trace being checked.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool traceDemoTick() noexcept {
+    if (!isTracing())
+        return true;
+
+    // Use the number of demo ticks read or recorded so far to identify the tick: this is consistent between recording and playback
+    uint32_t tickIdx;
+
+    if (gbDemoPlayback) {
+        tickIdx = DemoPlayer::getCurTick();
+    } else if (DemoRecorder::isRecording()) {
+        tickIdx = DemoRecorder::getNumTicksRecorded();
+    } else {
+        return true;
+    }
+
+    const TickHash hash = compute();
+
+    if (ProgArgs::gSaveStateHashesFilePath[0]) {
+        try {
+            saveTraceRecord(gGameMap, tickIdx, hash);
+        }
+        catch (...) {
+            std::printf("Failed to write the state hash trace file '%s'!\n", ProgArgs::gSaveStateHashesFilePath);
+            gpTraceOutFile.reset();
+            gbTraceFileFailed = true;
+            return true;
+        }
+    }
+
+    if (ProgArgs::gCheckStateHashesFilePath[0] && gbDemoPlayback) {
+        if (!gbLoadedCheckTrace) {
+            gbLoadedCheckTrace = true;
+
+            if (!loadCheckTrace(ProgArgs::gCheckStateHashesFilePath)) {
+                gbTraceFileFailed = true;
+                return false;
+            }
+        }
+
+        return checkTraceRecord(gGameMap, tickIdx, hash);
+    }
+
+    return true;
+}
+
+END_NAMESPACE(StateHash)
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+
+BEGIN_NAMESPACE(StateHash)
+
+// A hash of the game state at a particular tick, split by category so that the source of a mismatch can be narrowed down
+struct TickHash {
+    uint32_t    rng;            // Random number generator indexes
+    uint32_t    players;        // Player inventory, health and stats
+    uint32_t    mobjs;          // All map objects in the level
+    uint32_t    sectors;        // Sector heights, lighting and specials, and the thinkers (doors, lifts, lights etc.) acting on them
+
+    uint32_t combined() const noexcept;
+    bool operator == (const TickHash& other) const noexcept;
+    bool operator != (const TickHash& other) const noexcept;
+    void byteSwap() noexcept;
+};
+
+static_assert(sizeof(TickHash) == 16);
+
+void shutdown() noexcept;
+TickHash compute() noexcept;
+
+// Per demo tick traces of the hash, for finding the first tick where demo playback diverges
+bool isTracing() noexcept;
+bool traceDemoTick() noexcept;
+
+END_NAMESPACE(StateHash)
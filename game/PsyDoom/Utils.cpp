@@ -7,11 +7,15 @@
 #include "Doom/Game/p_tick.h"
 #include "Doom/UI/st_main.h"
 #include "FatalErrors.h"
+#include "FrameScheduler.h"
 #include "Input.h"
+#include "InputLatencyProbe.h"
 #include "IsoFileSys.h"
 #include "Network.h"
+#include "Profiler.h"
 #include "ProgArgs.h"
 #include "PsxVm.h"
+#include "SeqAudioThread.h"
 #include "Video.h"
 #include "Vulkan/VDrawing.h"
 #include "Vulkan/VRenderer.h"
@@ -28,6 +32,8 @@
 
 BEGIN_NAMESPACE(Utils)
 
+#if !PSYDOOM_SIM
+
 static constexpr const char* const SAVE_FILE_ORG        = "com.codelobster";    // Root folder to save config in (in a OS specific writable prefs location)
 static constexpr const char* const SAVE_FILE_PRODUCT    = "PsyDoom";            // Sub-folder within the root folder to save the config in
 
@@ -37,6 +43,11 @@ typedef std::chrono::high_resolution_clock::time_point timepoint_t;
 // When we last did platform updates
 static timepoint_t gLastPlatformUpdateTime = {};
 
+// How long to idle for in between checks of the condition in 'waitForCond'
+static constexpr auto WAIT_FOR_COND_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+#endif  // #if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Gets the game version string.
 // This is used for the window title.
@@ -49,6 +60,9 @@ const char* getGameVersionString() noexcept {
     #endif
 }
 
+// PsyDoomSim: these platform and front-end utilities are replaced by headless versions in 'Sim/SimStubs.cpp'
+#if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // A custom handler for fatal errors and installing and uninstalling it
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -102,13 +116,19 @@ void doPlatformUpdates() noexcept {
         return;
 
     // Always generate timer events and update the music sequencer.
-    // Note that for PsyDoom the sequencer is now manually updated here and it now uses a delta time rather than a fixed increment
+    // Note that for PsyDoom the sequencer is now manually updated here and it now uses a delta time rather than a fixed increment.
+    // The exception to this is when the sequencer is being driven by the audio thread instead.
     PsxVm::generateTimerEvents();
 
-    if (gbWess_SeqOn) {
+    if (gbWess_SeqOn && (!SeqAudioThread::isSequencerOnAudioThread())) {
         SeqEngine();
     }
 
+    // Receive input events from the OS as soon as possible so they are timestamped accurately and available for late latching.
+    // Also inject input latency probe events, if measuring latency.
+    Input::pumpEvents();
+    InputLatencyProbe::update();
+
     // Only do these updates if enough time has elapsed.
     // Do this to prevent excessive CPU usage in loops that are periodically trying to update sound etc. while waiting for some event.
     const timepoint_t now = std::chrono::high_resolution_clock::now();
@@ -145,6 +165,7 @@ static bool waitForCond(const T& condLamba) noexcept {
         // Ok have to wait for a bit, do platform updates and a refresh of the display.
         // Refreshing the display helps prevent a brief (temporary) stutter issue after long pauses - I'm not sure why, maybe an SDL bug?
         // Doing a vsync'd present also reduces idle CPU usage a lot more than a spinning loop with thread yield.
+        // The frame scheduler is then used to idle for a short while, rather than spinning.
         //
         // Vulkan backend: this causes issues with certain things like crossfade, which rely on previous framebuffers.
         // Don't do this if we are outputting via Vulkan.
@@ -152,7 +173,7 @@ static bool waitForCond(const T& condLamba) noexcept {
             Video::displayFramebuffer();
         }
 
-        Utils::threadYield();
+        FrameScheduler::idleUntil(FrameScheduler::schedclock_t::now() + WAIT_FOR_COND_POLL_INTERVAL);
         doPlatformUpdates();
     }
 
@@ -164,11 +185,14 @@ static bool waitForCond(const T& condLamba) noexcept {
 // Wait for a number of seconds while still doing platform updates; returns 'false' if wait was aborted
 //------------------------------------------------------------------------------------------------------------------------------------------
 bool waitForSeconds(const float seconds) noexcept {
-    const clock_t startTime = clock();
+    // Note: use a steady wall clock rather than 'clock()', since outside of Windows the latter measures CPU time and hardly advances while
+    // waiting idle. The only caller shows a network error for a fixed amount of real time, which is what 'clock()' gave on Windows.
+    // Don't use 'high_resolution_clock' either, since it may be the system clock and jump if the time of day is adjusted.
+    const auto startTime = std::chrono::steady_clock::now();
 
     return waitForCond([&]() noexcept {
-        const clock_t now = clock();
-        const double elapsed = (double)(now - startTime) / (double) CLOCKS_PER_SEC;
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>(now - startTime).count();
         return (elapsed >= seconds);
     });
 }
@@ -282,6 +306,23 @@ void checkForRendererToggleInput() noexcept {
     #endif
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts or stops capturing a profiler trace if the input to do so is just pressed.
+// When the capture is stopped the trace is written to a file in the user data folder.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void checkForProfilerCaptureToggleInput() noexcept {
+    #if PSYDOOM_PROFILER
+        if (!Controls::isJustPressed(Controls::Binding::Toggle_ProfilerCapture))
+            return;
+
+        const bool bStartedCapture = Profiler::toggleCapture();
+        gStatusBar.message = (bStartedCapture) ? "Profiler capture started" : "Profiler trace saved";
+        gStatusBar.messageTicsLeft = 30;
+    #endif
+}
+
+#endif  // #if !PSYDOOM_SIM
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Retrieves data from a specified file on a game disc with the associated file system.
 // Starts reading the file from the specified offset and for the specified number of bytes.
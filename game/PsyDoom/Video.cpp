@@ -6,6 +6,7 @@
 #include "Asserts.h"
 #include "Config/Config.h"
 #include "Gpu.h"
+#include "InputLatencyProbe.h"
 #include "ProgArgs.h"
 #include "PsxVm.h"
 #include "Utils.h"
@@ -303,6 +304,7 @@ void displayFramebuffer() noexcept {
         return;
 
     gpVideoBackend->displayFramebuffer();
+    InputLatencyProbe::onFramePresented();
     Utils::doPlatformUpdates();
 }
 
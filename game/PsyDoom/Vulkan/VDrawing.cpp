@@ -20,12 +20,20 @@
 #include "LogicalDevice.h"
 #include "Pipeline.h"
 #include "PsyDoom/Config/Config.h"
+#include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/Video.h"
+#include "PsyDoom/WorkerThreads.h"
+#include "VGpuProfiler.h"
 #include "VPipelines.h"
 #include "VRenderer.h"
+#include "VTexAtlas.h"
 #include "VTypes.h"
 #include "VVertexBufferSet.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
 BEGIN_NAMESPACE(VDrawing)
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -35,7 +43,8 @@ BEGIN_NAMESPACE(VDrawing)
 enum class DrawCmdType : uint32_t {
     SetPipeline,        // Set the graphics pipeline to use: 1st arg is pipeline type, 2nd arg unused
     SetUniforms,        // Set the uniforms to use: 1st arg is index in the uniforms list
-    Draw                // A command to draw primitives: 1st arg is vertex count, 2nd arg is vertex offset
+    Draw,               // A command to draw primitives: 1st arg is vertex count, 2nd arg is vertex offset
+    Timestamp           // Write a GPU profiler timestamp: 1st arg is the profiler pass, 2nd arg is '1' if it is the end of the pass
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -47,6 +56,49 @@ struct DrawCmd {
     uint32_t        arg2;
 };
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A private buffer of vertices and draw commands which a thread can record drawing into, instead of the frame's vertex buffer.
+// Used to generate geometry on multiple threads: sub-buffers are later appended (in order) to the frame by the main thread.
+// Only pipeline switches and draws can be recorded to a sub-buffer: uniforms must be set on the main thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct DrawSubBuffer {
+    std::vector<VVertex_Draw>   verts;
+    std::vector<DrawCmd>        drawCmds;           // Draw command vertex offsets are relative to the start of 'verts'
+    VPipelineType               curPipelineType;
+    uint32_t                    curBatchStart;
+    uint32_t                    frameVertsOffset;   // Where the vertices go in the frame's vertex buffer: only valid while appending
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A single draw call along with the state it needs, used by the draw command optimizer.
+// Screen bounds are in normalized device coords: they are computed on demand and are only valid if 'bBounded' is set.
+// If 'bIsTimestamp' is set then the item is a GPU profiler timestamp instead of a draw: 'vertexCount' and 'vertexOffset' are then the
+// 1st and 2nd arguments of the timestamp command.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct DrawItem {
+    VPipelineType   pipeline;
+    bool            bBoundsComputed;
+    bool            bBounded;
+    bool            bIsTimestamp;
+    uint32_t        uniformsIdx;
+    uint32_t        vertexCount;
+    uint32_t        vertexOffset;
+    float           lx, rx;
+    float           ty, by;
+};
+
+// How many draws back the optimizer will look for a draw with the same pipeline to move a draw next to
+static constexpr uint32_t DRAW_OPT_LOOKBACK = 32;
+
+// How many pixels to pad the screen bounds of draws by when checking for overlap: guards against rasterization and precision differences
+static constexpr float DRAW_OPT_BOUNDS_PAD_PX = 2.0f;
+
+// Computing screen bounds means reading vertices back from the mapped vertex buffer, which may be uncached memory and slow to read.
+// These limit that work: the most vertices a draw can have to be bounded, and the most vertices that will be read per frame in total.
+// Draws which can't be bounded due to these limits are treated as possibly covering anything, so other draws are not moved past them.
+static constexpr uint32_t DRAW_OPT_MAX_DRAW_BOUNDS_VERTS = 96;
+static constexpr uint32_t DRAW_OPT_MAX_FRAME_BOUNDS_VERTS = 16384;
+
 // Ringbuffer index for the current frame being generated
 static uint32_t gCurRingbufferIdx;
 
@@ -55,6 +107,10 @@ static uint32_t gCurRingbufferIdx;
 static vgl::DescriptorPool  gDescriptorPool;
 static vgl::DescriptorSet*  gpDescriptorSet;
 
+// Descriptor set used by the texture atlas variants of the world pipelines (if the atlas is enabled).
+// Binds the texture atlas to it's combined image sampler in binding 0.
+static vgl::DescriptorSet*  gpAtlasDescriptorSet;
+
 // Vertex buffers: for the 'draw' subpass (VVertex_Draw)
 static VVertexBufferSet gVertexBuffers_Draw;
 
@@ -67,6 +123,296 @@ static std::vector<VShaderUniforms_Draw> gFrameUniforms;
 // Drawing commands for the current frame
 static std::vector<DrawCmd> gFrameDrawCmds;
 
+// Sub-buffers available for recording drawing on other threads, and the sub-buffer (if any) that the current thread is recording to
+static std::vector<DrawSubBuffer>   gSubBuffers;
+static thread_local DrawSubBuffer*  tgpCurSubBuffer;
+
+// Temporary list of draws used by the draw command optimizer
+static std::vector<DrawItem> gFrameDrawItems;
+
+// Draw command stats for the last frame, before and after optimization
+static DrawCmdStats gLastFrameStatsBefore;
+static DrawCmdStats gLastFrameStatsAfter;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Allocates the specified number of vertices for drawing, either in the frame's vertex buffer or the sub-buffer being recorded to.
+// The vertices are added to the current draw batch.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static VVertex_Draw* allocDrawVerts(const uint32_t numVerts) noexcept {
+    DrawSubBuffer* const pSubBuffer = tgpCurSubBuffer;
+
+    if (pSubBuffer) {
+        const size_t oldNumVerts = pSubBuffer->verts.size();
+        pSubBuffer->verts.resize(oldNumVerts + numVerts);
+        return pSubBuffer->verts.data() + oldNumVerts;
+    }
+
+    return gVertexBuffers_Draw.allocVerts<VVertex_Draw>(numVerts);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the specified pipeline blends with what is underneath it.
+// Draws using these pipelines are never reordered, and other draws are never moved past them.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool isBlendedPipeline(const VPipelineType type) noexcept {
+    switch (type) {
+        case VPipelineType::UI_8bpp_Add:
+        case VPipelineType::World_GeomAlpha:
+        case VPipelineType::World_SpriteAlpha:
+        case VPipelineType::World_SpriteAdditive:
+        case VPipelineType::World_SpriteSubtractive:
+        case VPipelineType::World_GeomAlpha_Atlas:
+        case VPipelineType::World_SpriteAlpha_Atlas:
+        case VPipelineType::World_SpriteAdditive_Atlas:
+        case VPipelineType::World_SpriteSubtractive_Atlas:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Counts the pipeline binds, uniform pushes and draws in the current frame's command list
+//------------------------------------------------------------------------------------------------------------------------------------------
+static DrawCmdStats countDrawCmds() noexcept {
+    DrawCmdStats stats = {};
+
+    for (const DrawCmd& drawCmd : gFrameDrawCmds) {
+        switch (drawCmd.type) {
+            case DrawCmdType::SetPipeline:  stats.numPipelineBinds++;   break;
+            case DrawCmdType::SetUniforms:  stats.numUniformPushes++;   break;
+            case DrawCmdType::Draw:         stats.numDraws++;           break;
+            case DrawCmdType::Timestamp:                                break;
+        }
+    }
+
+    return stats;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the screen bounds of a draw in normalized device coords by projecting its vertices, if not already done.
+// If any vertex is on or behind the eye plane then the draw is treated as unbounded, since it could cover anything.
+// Draws are also left unbounded if they have too many vertices, or if the budget of vertices to read for the frame has been used up.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void computeDrawItemBounds(DrawItem& item, uint32_t& vertsBudget) noexcept {
+    if (item.bBoundsComputed)
+        return;
+
+    item.bBoundsComputed = true;
+    item.bBounded = false;
+
+    // Sky vertices are displaced in the vertex shader and can't be bounded on the CPU
+    if ((item.pipeline == VPipelineType::World_Sky) || (item.uniformsIdx >= gFrameUniforms.size()))
+        return;
+
+    if ((item.vertexCount > DRAW_OPT_MAX_DRAW_BOUNDS_VERTS) || (item.vertexCount > vertsBudget))
+        return;
+
+    vertsBudget -= item.vertexCount;
+
+    const VShaderUniforms_Draw& uniforms = gFrameUniforms[item.uniformsIdx];
+    const VVertex_Draw* const pVerts = (const VVertex_Draw*) gVertexBuffers_Draw.pCurVerts + item.vertexOffset;
+
+    float lx = +FLT_MAX;
+    float rx = -FLT_MAX;
+    float ty = +FLT_MAX;
+    float by = -FLT_MAX;
+
+    for (uint32_t i = 0; i < item.vertexCount; ++i) {
+        const float pos[4] = { pVerts[i].x, pVerts[i].y, pVerts[i].z, 1.0f };
+        float clipPos[4];
+        uniforms.mvpMatrix.transform4d(pos, clipPos);
+
+        if (clipPos[3] <= 1e-4f)
+            return;
+
+        const float ndcX = clipPos[0] / clipPos[3];
+        const float ndcY = clipPos[1] / clipPos[3];
+        lx = std::min(lx, ndcX);
+        rx = std::max(rx, ndcX);
+        ty = std::min(ty, ndcY);
+        by = std::max(by, ndcY);
+    }
+
+    // Pad the bounds by a few pixels (1 pixel is '2 * invDrawRes' in normalized device coords)
+    const float padX = DRAW_OPT_BOUNDS_PAD_PX * 2.0f * uniforms.invDrawResX;
+    const float padY = DRAW_OPT_BOUNDS_PAD_PX * 2.0f * uniforms.invDrawResY;
+    item.lx = lx - padX;
+    item.rx = rx + padX;
+    item.ty = ty - padY;
+    item.by = by + padY;
+    item.bBounded = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if two draws might touch the same pixels on screen
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool drawItemsMayOverlap(const DrawItem& item1, const DrawItem& item2) noexcept {
+    if ((!item1.bBounded) || (!item2.bBounded))
+        return true;
+
+    return (
+        (item1.lx <= item2.rx) && (item2.lx <= item1.rx) &&
+        (item1.ty <= item2.by) && (item2.ty <= item1.by)
+    );
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Optimizes the draw commands for the current frame before they are recorded to the Vulkan command buffer:
+//
+//  (1) Redundant pipeline binds and uniform pushes (of identical uniforms) are dropped.
+//  (2) Non-blended draws are moved back to follow the most recent draw using the same pipeline, provided that they don't touch any of the
+//      pixels of the draws they are moved past. There is no depth buffer so draw order matters wherever draws overlap, and blended draws
+//      are treated as barriers which nothing is moved past. Draws are also never moved across a change in uniforms. Screen bounds are
+//      only computed for draws which could actually be moved and the draws they would move past, subject to the limits defined above.
+//  (3) Draws with the same state and contiguous vertex ranges are merged.
+//
+// GPU profiler timestamps are treated as barriers which nothing is moved or merged across, so they still measure the same draws.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void optimizeDrawCmds() noexcept {
+    // Convert the command list into a list of draws with the state they use, dropping pushes of duplicate uniforms
+    gFrameDrawItems.clear();
+    VPipelineType curPipeline = (VPipelineType) -1;
+    uint32_t curUniformsIdx = UINT32_MAX;
+
+    for (const DrawCmd& drawCmd : gFrameDrawCmds) {
+        switch (drawCmd.type) {
+            case DrawCmdType::SetPipeline:
+                curPipeline = (VPipelineType) drawCmd.arg1;
+                break;
+
+            case DrawCmdType::SetUniforms: {
+                const bool bSameUniforms = (
+                    (curUniformsIdx != UINT32_MAX) &&
+                    (std::memcmp(&gFrameUniforms[curUniformsIdx], &gFrameUniforms[drawCmd.arg1], sizeof(VShaderUniforms_Draw)) == 0)
+                );
+
+                if (!bSameUniforms) {
+                    curUniformsIdx = drawCmd.arg1;
+                }
+            }   break;
+
+            case DrawCmdType::Draw: {
+                DrawItem& item = gFrameDrawItems.emplace_back();
+                item.pipeline = curPipeline;
+                item.bBoundsComputed = false;
+                item.bBounded = false;
+                item.bIsTimestamp = false;
+                item.uniformsIdx = curUniformsIdx;
+                item.vertexCount = drawCmd.arg1;
+                item.vertexOffset = drawCmd.arg2;
+            }   break;
+
+            case DrawCmdType::Timestamp: {
+                DrawItem& item = gFrameDrawItems.emplace_back();
+                item.pipeline = curPipeline;
+                item.bBoundsComputed = false;
+                item.bBounded = false;
+                item.bIsTimestamp = true;
+                item.uniformsIdx = curUniformsIdx;
+                item.vertexCount = drawCmd.arg1;
+                item.vertexOffset = drawCmd.arg2;
+            }   break;
+        }
+    }
+
+    // Group non-blended draws by pipeline where it is safe to do so
+    const uint32_t numItems = (uint32_t) gFrameDrawItems.size();
+    uint32_t groupStartIdx = 0;
+    uint32_t boundsVertsBudget = DRAW_OPT_MAX_FRAME_BOUNDS_VERTS;
+
+    for (uint32_t itemIdx = 0; itemIdx < numItems; ++itemIdx) {
+        DrawItem& item = gFrameDrawItems[itemIdx];
+
+        // Blended draws, timestamps and uniform changes start a new group that draws can't be moved out of
+        if (item.bIsTimestamp || isBlendedPipeline(item.pipeline)) {
+            groupStartIdx = itemIdx + 1;
+            continue;
+        }
+
+        if ((itemIdx > 0) && (gFrameDrawItems[itemIdx - 1].uniformsIdx != item.uniformsIdx)) {
+            groupStartIdx = itemIdx;
+        }
+
+        // Search back for a draw with the same pipeline to move this draw next to: nothing to do if there isn't one, or it's the previous draw
+        const uint32_t searchEndIdx = (itemIdx > groupStartIdx + DRAW_OPT_LOOKBACK) ? itemIdx - DRAW_OPT_LOOKBACK : groupStartIdx;
+        uint32_t moveToIdx = itemIdx;
+
+        for (uint32_t otherIdx = itemIdx; otherIdx > searchEndIdx; --otherIdx) {
+            if (gFrameDrawItems[otherIdx - 1].pipeline == item.pipeline) {
+                moveToIdx = otherIdx;
+                break;
+            }
+        }
+
+        if (moveToIdx >= itemIdx)
+            continue;
+
+        // Only move the draw if it doesn't overlap any of the draws it would be moved past
+        computeDrawItemBounds(item, boundsVertsBudget);
+
+        if (!item.bBounded)
+            continue;
+
+        for (uint32_t otherIdx = itemIdx; otherIdx > moveToIdx; --otherIdx) {
+            DrawItem& otherItem = gFrameDrawItems[otherIdx - 1];
+            computeDrawItemBounds(otherItem, boundsVertsBudget);
+
+            if (drawItemsMayOverlap(item, otherItem)) {
+                moveToIdx = itemIdx;
+                break;
+            }
+        }
+
+        if (moveToIdx < itemIdx) {
+            std::rotate(gFrameDrawItems.begin() + moveToIdx, gFrameDrawItems.begin() + itemIdx, gFrameDrawItems.begin() + itemIdx + 1);
+        }
+    }
+
+    // Regenerate the command list, only changing state when needed and merging draws that are contiguous in the vertex buffer
+    gFrameDrawCmds.clear();
+    curPipeline = (VPipelineType) -1;
+    curUniformsIdx = UINT32_MAX;
+    DrawCmd* pPrevDrawCmd = nullptr;
+
+    for (const DrawItem& item : gFrameDrawItems) {
+        if (item.bIsTimestamp) {
+            DrawCmd& drawCmd = gFrameDrawCmds.emplace_back();
+            drawCmd.type = DrawCmdType::Timestamp;
+            drawCmd.arg1 = item.vertexCount;
+            drawCmd.arg2 = item.vertexOffset;
+            pPrevDrawCmd = nullptr;
+            continue;
+        }
+
+        if (item.pipeline != curPipeline) {
+            DrawCmd& drawCmd = gFrameDrawCmds.emplace_back();
+            drawCmd.type = DrawCmdType::SetPipeline;
+            drawCmd.arg1 = (uint32_t) item.pipeline;
+            curPipeline = item.pipeline;
+            pPrevDrawCmd = nullptr;
+        }
+
+        if (item.uniformsIdx != curUniformsIdx) {
+            DrawCmd& drawCmd = gFrameDrawCmds.emplace_back();
+            drawCmd.type = DrawCmdType::SetUniforms;
+            drawCmd.arg1 = item.uniformsIdx;
+            curUniformsIdx = item.uniformsIdx;
+            pPrevDrawCmd = nullptr;
+        }
+
+        if (pPrevDrawCmd && (pPrevDrawCmd->arg2 + pPrevDrawCmd->arg1 == item.vertexOffset)) {
+            pPrevDrawCmd->arg1 += item.vertexCount;
+        } else {
+            pPrevDrawCmd = &gFrameDrawCmds.emplace_back();
+            pPrevDrawCmd->type = DrawCmdType::Draw;
+            pPrevDrawCmd->arg1 = item.vertexCount;
+            pPrevDrawCmd->arg2 = item.vertexOffset;
+        }
+    }
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Records all drawing commands for the current frame to a Vulkan command buffer
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -91,8 +437,12 @@ static void recordCmdBuffer(vgl::CmdBufferRecorder& cmdRec) noexcept {
     // Bind the correct vertex buffer for drawing
     cmdRec.bindVertexBuffer(*gVertexBuffers_Draw.pCurBuffer, 0, 0);
 
-    // Clear this flag once we bind the drawing descriptor set - it only needs to be done once since all draw pipeline layouts are compatible
-    bool bNeedToBindDescriptorSet = true;
+    // Which drawing descriptor set is currently bound: it only needs to be re-bound when switching to or from the texture atlas pipelines,
+    // since all draw pipeline layouts are compatible.
+    vgl::DescriptorSet* pBoundDescriptorSet = nullptr;
+
+    // Time all of the drawing on the GPU, if profiling
+    VGpuProfiler::writeTimestamp(cmdRec, VGpuProfiler::Pass::Draw, false);
 
     // Handle each draw command
     for (const DrawCmd& drawCmd : gFrameDrawCmds) {
@@ -103,10 +453,13 @@ static void recordCmdBuffer(vgl::CmdBufferRecorder& cmdRec) noexcept {
                 vgl::Pipeline& pipeline = VPipelines::gPipelines[drawCmd.arg1];
                 cmdRec.bindPipeline(pipeline);
 
-                // Do we need to bind the draw descriptor set as well, after setting the pipeline?
-                if (bNeedToBindDescriptorSet) {
-                    cmdRec.bindDescriptorSet(*gpDescriptorSet, pipeline, 0, 0, nullptr);
-                    bNeedToBindDescriptorSet = false;
+                // Do we need to bind a different draw descriptor set as well, after setting the pipeline?
+                vgl::DescriptorSet* const pDescriptorSet = (VTexAtlas::isAtlasPipelineType((VPipelineType) drawCmd.arg1)) ? gpAtlasDescriptorSet : gpDescriptorSet;
+                ASSERT(pDescriptorSet);
+
+                if (pDescriptorSet != pBoundDescriptorSet) {
+                    cmdRec.bindDescriptorSet(*pDescriptorSet, pipeline, 0, 0, nullptr);
+                    pBoundDescriptorSet = pDescriptorSet;
                 }
             }   break;
 
@@ -123,23 +476,29 @@ static void recordCmdBuffer(vgl::CmdBufferRecorder& cmdRec) noexcept {
             case DrawCmdType::Draw: {
                 cmdRec.draw(drawCmd.arg1, drawCmd.arg2);
             }   break;
+
+            case DrawCmdType::Timestamp: {
+                VGpuProfiler::writeTimestamp(cmdRec, (VGpuProfiler::Pass) drawCmd.arg1, (drawCmd.arg2 != 0));
+            }   break;
         }
     }
+
+    VGpuProfiler::writeTimestamp(cmdRec, VGpuProfiler::Pass::Draw, true);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Initializes the drawing module and allocates draw vertex buffers etc.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void init(vgl::LogicalDevice& device, vgl::BaseTexture& vramTex) noexcept {
-    // Create the descriptor pool and descriptor set used for rendering.
-    // Only using a single descriptor set which is bound to the PSX VRAM texture.
+    // Create the descriptor pool and descriptor sets used for rendering.
+    // One descriptor set is bound to the PSX VRAM texture and another (optional) one is bound to the texture atlas.
     {
         // Make the descriptor pool
         VkDescriptorPoolSize poolResources[1] = {};
         poolResources[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolResources[0].descriptorCount = vgl::Defines::RINGBUFFER_SIZE;
+        poolResources[0].descriptorCount = vgl::Defines::RINGBUFFER_SIZE * 2;
 
-        if (!gDescriptorPool.init(device, { poolResources[0] }, 1))
+        if (!gDescriptorPool.init(device, { poolResources[0] }, 2))
             FatalErrors::raise("VDrawing: Failed to create a Vulkan descriptor pool!");
 
         // Make the descriptor set and bind the PSX VRAM texture and sampler to slot 0.
@@ -150,6 +509,16 @@ void init(vgl::LogicalDevice& device, vgl::BaseTexture& vramTex) noexcept {
             FatalErrors::raise("VDrawing: Failed to allocate a required Vulkan descriptor set!");
 
         gpDescriptorSet->bindTextureAndSampler(0, vramTex, VPipelines::gSampler_draw);
+
+        // Make the texture atlas descriptor set, if the atlas is being used
+        if (VTexAtlas::isEnabled()) {
+            gpAtlasDescriptorSet = gDescriptorPool.allocDescriptorSet(VPipelines::gDescSetLayout_draw);
+
+            if (!gpAtlasDescriptorSet)
+                FatalErrors::raise("VDrawing: Failed to allocate a required Vulkan descriptor set!");
+
+            gpAtlasDescriptorSet->bindTextureAndSampler(0, VTexAtlas::getTexture(), VPipelines::gSampler_draw);
+        }
     }
 
     // Create the vertex buffers
@@ -162,17 +531,27 @@ void init(vgl::LogicalDevice& device, vgl::BaseTexture& vramTex) noexcept {
     // Prealloc draw buffer memory
     gFrameUniforms.reserve(16);
     gFrameDrawCmds.reserve(4196);
+    gFrameDrawItems.reserve(4196);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Shuts down the drawing module and frees up resources
 //------------------------------------------------------------------------------------------------------------------------------------------
 void shutdown() noexcept {
+    gSubBuffers.clear();
+    gLastFrameStatsBefore = {};
+    gLastFrameStatsAfter = {};
+    gFrameDrawItems.clear();
     gFrameDrawCmds.clear();
     gFrameUniforms.clear();
     gCurDrawPipelineType = {};
     gVertexBuffers_Draw.destroy();
 
+    if (gpAtlasDescriptorSet) {
+        gpAtlasDescriptorSet->free(true);
+        gpAtlasDescriptorSet = nullptr;
+    }
+
     if (gpDescriptorSet) {
         gpDescriptorSet->free(true);
         gpDescriptorSet = nullptr;
@@ -199,6 +578,13 @@ void beginFrame(const uint32_t ringbufferIdx) noexcept {
 void endFrame(vgl::CmdBufferRecorder& cmdRec) noexcept {
     // Finish the current draw batch then record all drawing commands in the Vulkan command buffer
     endCurrentDrawBatch();
+    gLastFrameStatsBefore = countDrawCmds();
+
+    if (!ProgArgs::gbNoDrawCmdOptimizer) {
+        optimizeDrawCmds();
+    }
+
+    gLastFrameStatsAfter = countDrawCmds();
     recordCmdBuffer(cmdRec);
 
     // Upload vertices generated during drawing, so the draw commands can use them
@@ -217,7 +603,9 @@ void endFrame(vgl::CmdBufferRecorder& cmdRec) noexcept {
 void setDrawPipeline(const VPipelineType type) noexcept {
     // Only switch pipelines if we need to
     ASSERT((uint32_t) type < (uint32_t) VPipelineType::NUM_TYPES);
-    const VPipelineType oldPipelineType = gCurDrawPipelineType;
+    DrawSubBuffer* const pSubBuffer = tgpCurSubBuffer;
+    VPipelineType& curPipelineType = (pSubBuffer) ? pSubBuffer->curPipelineType : gCurDrawPipelineType;
+    const VPipelineType oldPipelineType = curPipelineType;
 
     if (oldPipelineType == type)
         return;
@@ -225,9 +613,10 @@ void setDrawPipeline(const VPipelineType type) noexcept {
     // Do the pipeline switch and record the switch draw command.
     // Note that we must end the current draw batch before switching!
     endCurrentDrawBatch();
-    gCurDrawPipelineType = type;
+    curPipelineType = type;
 
-    DrawCmd& drawCmd = gFrameDrawCmds.emplace_back();
+    std::vector<DrawCmd>& drawCmds = (pSubBuffer) ? pSubBuffer->drawCmds : gFrameDrawCmds;
+    DrawCmd& drawCmd = drawCmds.emplace_back();
     drawCmd.type = DrawCmdType::SetPipeline;
     drawCmd.arg1 = (uint32_t) type;
 }
@@ -237,6 +626,7 @@ void setDrawPipeline(const VPipelineType type) noexcept {
 //------------------------------------------------------------------------------------------------------------------------------------------
 void setDrawUniforms(const VShaderUniforms_Draw& uniforms) noexcept {
     // Record the command to set the uniforms and save them for later
+    ASSERT_LOG(!tgpCurSubBuffer, "Uniforms can't be set while recording to a sub-buffer!");
     DrawCmd& drawCmd = gFrameDrawCmds.emplace_back();
     drawCmd.type = DrawCmdType::SetUniforms;
     drawCmd.arg1 = (uint32_t) gFrameUniforms.size();
@@ -299,6 +689,23 @@ Matrix4f computeTransformMatrixFor3D(const float viewX, const float viewY, const
 // The primitives are drawn with whatever pipeline is currently bound.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void endCurrentDrawBatch() noexcept {
+    // If recording to a sub-buffer then end the batch there instead
+    DrawSubBuffer* const pSubBuffer = tgpCurSubBuffer;
+
+    if (pSubBuffer) {
+        const uint32_t numVerts = (uint32_t) pSubBuffer->verts.size();
+
+        if (numVerts > pSubBuffer->curBatchStart) {
+            DrawCmd& drawCmd = pSubBuffer->drawCmds.emplace_back();
+            drawCmd.type = DrawCmdType::Draw;
+            drawCmd.arg1 = numVerts - pSubBuffer->curBatchStart;
+            drawCmd.arg2 = pSubBuffer->curBatchStart;
+            pSubBuffer->curBatchStart = numVerts;
+        }
+
+        return;
+    }
+
     // Ignore if there are no vertices in the current batch
     if (gVertexBuffers_Draw.curBatchSize <= 0)
         return;
@@ -311,6 +718,111 @@ void endCurrentDrawBatch() noexcept {
     gVertexBuffers_Draw.endCurrentDrawBatch();
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Makes sure there are at least the specified number of sub-buffers available for recording drawing on other threads.
+// Must be called on the main thread, while no thread is recording to a sub-buffer.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void ensureNumSubBuffers(const uint32_t numSubBuffers) noexcept {
+    ASSERT(!tgpCurSubBuffer);
+
+    if (gSubBuffers.size() < numSubBuffers) {
+        gSubBuffers.resize(numSubBuffers);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Makes all drawing on the calling thread go to the specified (empty) sub-buffer until 'endSubBuffer' is called.
+// Each sub-buffer must only be recorded to by one thread at a time.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void beginSubBuffer(const uint32_t subBufferIdx) noexcept {
+    ASSERT(!tgpCurSubBuffer);
+    ASSERT(subBufferIdx < gSubBuffers.size());
+
+    DrawSubBuffer& subBuffer = gSubBuffers[subBufferIdx];
+    ASSERT(subBuffer.verts.empty() && subBuffer.drawCmds.empty());
+    subBuffer.curPipelineType = (VPipelineType) -1;
+    subBuffer.curBatchStart = 0;
+    tgpCurSubBuffer = &subBuffer;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Ends recording to the current sub-buffer on the calling thread: drawing goes to the frame's buffers again afterwards
+//------------------------------------------------------------------------------------------------------------------------------------------
+void endSubBuffer() noexcept {
+    ASSERT(tgpCurSubBuffer);
+    endCurrentDrawBatch();
+    tgpCurSubBuffer = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Appends the vertices and drawing commands recorded to the specified number of sub-buffers (in order) to the frame and then clears them.
+// Must be called on the main thread. The result is the same as if the drawing was done directly by the main thread.
+//
+// The draws are added and space for the vertices is allocated first, then the vertices are copied in on the worker threads.
+// Copying is a large part of the cost of appending and would otherwise limit how well generating geometry on multiple threads scales.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void appendSubBuffers(const uint32_t numSubBuffers) noexcept {
+    ASSERT(!tgpCurSubBuffer);
+    ASSERT(numSubBuffers <= gSubBuffers.size());
+
+    // Note: every vertex in a sub-buffer belongs to one of its draws (in order), so each sub-buffer gets a contiguous range of vertices
+    for (uint32_t subBufferIdx = 0; subBufferIdx < numSubBuffers; ++subBufferIdx) {
+        DrawSubBuffer& subBuffer = gSubBuffers[subBufferIdx];
+        subBuffer.frameVertsOffset = gVertexBuffers_Draw.curOffset;
+
+        for (const DrawCmd& drawCmd : subBuffer.drawCmds) {
+            if (drawCmd.type == DrawCmdType::SetPipeline) {
+                setDrawPipeline((VPipelineType) drawCmd.arg1);
+            } else {
+                ASSERT(drawCmd.type == DrawCmdType::Draw);
+                gVertexBuffers_Draw.allocVerts<VVertex_Draw>(drawCmd.arg1);
+            }
+        }
+
+        ASSERT(gVertexBuffers_Draw.curOffset - subBuffer.frameVertsOffset == subBuffer.verts.size());
+    }
+
+    // The vertex buffer won't be resized while copying, so it's safe for the worker threads to write to it
+    VVertex_Draw* const pFrameVerts = (VVertex_Draw*) gVertexBuffers_Draw.pCurVerts;
+
+    WorkerThreads::runJobs(numSubBuffers, [=](const uint32_t subBufferIdx) noexcept {
+        DrawSubBuffer& subBuffer = gSubBuffers[subBufferIdx];
+
+        if (!subBuffer.verts.empty()) {
+            std::memcpy(pFrameVerts + subBuffer.frameVertsOffset, subBuffer.verts.data(), sizeof(VVertex_Draw) * subBuffer.verts.size());
+        }
+
+        subBuffer.verts.clear();
+        subBuffer.drawCmds.clear();
+    });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Adds a command to write the begin or end timestamp for a GPU profiler pass at the current point in the frame's drawing.
+// Does nothing if GPU profiling is not enabled. Must be called on the main thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void addGpuTimestamp(const VGpuProfiler::Pass pass, const bool bPassEnd) noexcept {
+    ASSERT_LOG(!tgpCurSubBuffer, "Timestamps can't be added while recording to a sub-buffer!");
+
+    if (!VGpuProfiler::isEnabled())
+        return;
+
+    endCurrentDrawBatch();
+
+    DrawCmd& drawCmd = gFrameDrawCmds.emplace_back();
+    drawCmd.type = DrawCmdType::Timestamp;
+    drawCmd.arg1 = (uint32_t) pass;
+    drawCmd.arg2 = (bPassEnd) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the number of pipeline binds, uniform pushes and draws issued in the last frame, before and after optimization
+//------------------------------------------------------------------------------------------------------------------------------------------
+void getLastFrameDrawCmdStats(DrawCmdStats& statsBefore, DrawCmdStats& statsAfter) noexcept {
+    statsBefore = gLastFrameStatsBefore;
+    statsAfter = gLastFrameStatsAfter;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 // Add a 2D/UI line to the 'draw' subpass
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -324,7 +836,7 @@ void addUILine(
     const uint8_t b
 ) noexcept {
     // Fill in the vertices, starting first with common parameters
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(2);
+    VVertex_Draw* const pVerts = allocDrawVerts(2);
 
     for (uint32_t i = 0; i < 2; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -360,7 +872,7 @@ void addFlatColoredTriangle(
     const uint8_t g,
     const uint8_t b
 ) noexcept {
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(3);
+    VVertex_Draw* const pVerts = allocDrawVerts(3);
 
     for (uint32_t i = 0; i < 3; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -399,7 +911,7 @@ void addFlatColoredQuad(
     const uint8_t g,
     const uint8_t b
 ) noexcept {
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(6);
+    VVertex_Draw* const pVerts = allocDrawVerts(6);
 
     for (uint32_t i = 0; i < 6; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -443,7 +955,7 @@ void addUISprite(
     const uint16_t texWinH
 ) noexcept {
     // Fill in the vertices, starting first with common parameters
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(6);
+    VVertex_Draw* const pVerts = allocDrawVerts(6);
 
     for (uint32_t i = 0; i < 6; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -530,7 +1042,7 @@ void addWorldTriangle(
     const uint8_t stMulA
 ) noexcept {
     // Fill in the vertices, starting first with common parameters
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(3);
+    VVertex_Draw* const pVerts = allocDrawVerts(3);
 
     for (uint32_t i = 0; i < 3; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -586,7 +1098,7 @@ void addWorldQuad(
     const uint8_t stMulA
 ) noexcept {
     // Fill in the vertices, starting first with the parameters that are the same for all vertices
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(6);
+    VVertex_Draw* const pVerts = allocDrawVerts(6);
 
     for (uint32_t i = 0; i < 6; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -645,7 +1157,7 @@ void addWorldInfiniteSkyWall(
 ) noexcept {
     // Fill in the vertices, starting first with common parameters.
     // Note: we store the sky U offset based on player rotation in the U coordinate.
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(6);
+    VVertex_Draw* const pVerts = allocDrawVerts(6);
 
     for (uint32_t i = 0; i < 6; ++i) {
         VVertex_Draw& vert = pVerts[i];
@@ -723,7 +1235,7 @@ void addWorldSkyQuad(
 ) noexcept {
     // Fill in the vertices, starting first with common parameters.
     // Note: we store the sky U offset based on player rotation in the U coordinate.
-    VVertex_Draw* const pVerts = gVertexBuffers_Draw.allocVerts<VVertex_Draw>(6);
+    VVertex_Draw* const pVerts = allocDrawVerts(6);
 
     for (uint32_t i = 0; i < 6; ++i) {
         VVertex_Draw& vert = pVerts[i];
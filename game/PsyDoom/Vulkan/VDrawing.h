@@ -20,6 +20,10 @@ namespace Gpu {
     enum class TexFmt : uint8_t;
 }
 
+namespace VGpuProfiler {
+    enum class Pass : uint32_t;
+}
+
 enum class VLightDimMode : uint8_t;
 enum class VPipelineType : uint8_t;
 enum class VPipelineType : uint8_t;
@@ -27,6 +31,13 @@ struct VShaderUniforms_Draw;
 
 BEGIN_NAMESPACE(VDrawing)
 
+// Per frame counts of the draw commands issued to Vulkan, before and after the draw command optimizer runs
+struct DrawCmdStats {
+    uint32_t    numPipelineBinds;
+    uint32_t    numUniformPushes;
+    uint32_t    numDraws;
+};
+
 // Attributes which are specified uniquely per vertex for 'addWorldQuad'
 struct AddWorldQuadVert {
     float       x, y, z;
@@ -43,6 +54,12 @@ void setDrawUniforms(const VShaderUniforms_Draw& uniforms) noexcept;
 Matrix4f computeTransformMatrixForUI(const bool bAllowWidescreen) noexcept;
 Matrix4f computeTransformMatrixFor3D(const float viewX, const float viewY, const float viewZ, const float viewAngle) noexcept;
 void endCurrentDrawBatch() noexcept;
+void ensureNumSubBuffers(const uint32_t numSubBuffers) noexcept;
+void beginSubBuffer(const uint32_t subBufferIdx) noexcept;
+void endSubBuffer() noexcept;
+void appendSubBuffers(const uint32_t numSubBuffers) noexcept;
+void addGpuTimestamp(const VGpuProfiler::Pass pass, const bool bPassEnd) noexcept;
+void getLastFrameDrawCmdStats(DrawCmdStats& statsBefore, DrawCmdStats& statsAfter) noexcept;
 
 void addUILine(
     const float x1,
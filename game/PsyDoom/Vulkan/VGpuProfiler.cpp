@@ -0,0 +1,339 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Measures how long the GPU spends on each pass of the frame using timestamp queries, and collects CPU timings for the stages of
+// 'RV_RenderPlayerView' alongside them.
+//
+// There is one query pool per ringbuffer slot. Timestamps are written while the frame's commands are recorded and read back when the
+// ringbuffer slot is next used, at which point the fence for the slot has been waited on and the results are available without stalling.
+// This means that timings are a couple of frames behind. The timings are shown with the performance counters and can also be streamed
+// to a CSV file (one row per frame) using the '-gpuprofilecsv' program argument.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "VGpuProfiler.h"
+
+#if PSYDOOM_VULKAN_RENDERER
+
+#include "Asserts.h"
+#include "CmdBufferRecorder.h"
+#include "Defines.h"
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "PsyDoom/Config/Config.h"
+#include "PsyDoom/ProgArgs.h"
+#include "QueryPool.h"
+
+#include <algorithm>
+#include <cstdio>
+
+BEGIN_NAMESPACE(VGpuProfiler)
+
+static constexpr uint32_t NUM_PASSES = (uint32_t) Pass::NUM_PASSES;
+static constexpr uint32_t NUM_CPU_STAGES = (uint32_t) CpuStage::NUM_STAGES;
+static constexpr uint32_t NUM_QUERIES = NUM_PASSES * 2;     // A begin and end timestamp for each pass
+
+// Names for each pass and CPU stage, as used in the CSV file
+static constexpr const char* PASS_NAMES[NUM_PASSES] = {
+    "frame",
+    "psx",
+    "main",
+    "crossfade",
+    "blit",
+    "draw",
+    "sky",
+    "world",
+    "msaa_resolve"
+};
+
+static constexpr const char* CPU_STAGE_NAMES[NUM_CPU_STAGES] = {
+    "setup",
+    "sprite_frags",
+    "sky",
+    "geom",
+    "weapon"
+};
+
+// Timestamps written for a frame using a ringbuffer slot and the CPU timings for the frame
+struct SlotFrame {
+    bool        bPending;                       // True if the frame's commands were submitted and its timings have yet to be read back
+    uint64_t    frameNum;
+    uint32_t    passBeginMask;                  // Bit mask of the passes which had their begin timestamp written
+    uint32_t    passEndMask;                    // Bit mask of the passes which had their end timestamp written
+    float       cpuStageUsec[NUM_CPU_STAGES];
+};
+
+static bool             gbIsSupported;                                      // True if the device can do timestamp queries on the work queue
+static double           gTimestampPeriodUsec;                               // How many microseconds each timestamp tick is
+static uint64_t         gTimestampMask;                                     // Mask for the bits of the timestamp which are valid
+static vgl::QueryPool   gQueryPools[vgl::Defines::RINGBUFFER_SIZE];
+static SlotFrame        gSlotFrames[vgl::Defines::RINGBUFFER_SIZE];
+static SlotFrame*       gpCurSlotFrame;                                     // The slot for the current frame, if profiling the frame
+static uint64_t         gNextFrameNum;
+static FrameTimings     gLastResolvedTimings;
+static bool             gbHaveResolvedTimings;
+static std::FILE*       gpCsvFile;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Writes the header line for the CSV file
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void writeCsvHeader() noexcept {
+    std::fprintf(gpCsvFile, "frame");
+
+    for (const char* const passName : PASS_NAMES) {
+        std::fprintf(gpCsvFile, ",gpu_%s_us", passName);
+    }
+
+    std::fprintf(gpCsvFile, ",gpu_ui_us");
+
+    for (const char* const stageName : CPU_STAGE_NAMES) {
+        std::fprintf(gpCsvFile, ",cpu_%s_us", stageName);
+    }
+
+    std::fprintf(gpCsvFile, "\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Writes a single CSV field for a timing, leaving the field empty if the timing is not available
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void writeCsvTiming(const float usec) noexcept {
+    if (usec >= 0.0f) {
+        std::fprintf(gpCsvFile, ",%.1f", usec);
+    } else {
+        std::fprintf(gpCsvFile, ",");
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Writes a line to the CSV file for the specified frame's timings
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void writeCsvLine(const FrameTimings& timings) noexcept {
+    std::fprintf(gpCsvFile, "%llu", (unsigned long long) timings.frameNum);
+
+    for (const float usec : timings.passUsec) {
+        writeCsvTiming(usec);
+    }
+
+    writeCsvTiming(timings.uiUsec);
+
+    for (const float usec : timings.cpuStageUsec) {
+        writeCsvTiming(usec);
+    }
+
+    std::fprintf(gpCsvFile, "\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Reads back the timestamps for a submitted frame which has finished executing and computes its timings.
+// The timings become the latest available and are output to the CSV file, if there is one.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void resolveSlotFrame(const uint32_t ringbufferIdx) noexcept {
+    SlotFrame& slotFrame = gSlotFrames[ringbufferIdx];
+    const vgl::QueryPool& queryPool = gQueryPools[ringbufferIdx];
+
+    FrameTimings timings = {};
+    timings.frameNum = slotFrame.frameNum;
+    std::copy(std::begin(slotFrame.cpuStageUsec), std::end(slotFrame.cpuStageUsec), timings.cpuStageUsec);
+
+    // Get the duration of each pass that had both of it's timestamps written.
+    // If the results are somehow not available yet then don't wait for them; just treat the pass as not done.
+    for (uint32_t passIdx = 0; passIdx < NUM_PASSES; ++passIdx) {
+        const uint32_t passBit = 1u << passIdx;
+        const bool bPassWritten = ((slotFrame.passBeginMask & passBit) && (slotFrame.passEndMask & passBit));
+        uint64_t timestamps[2] = {};
+
+        if (bPassWritten && queryPool.getResults(passIdx * 2, 2, timestamps)) {
+            const uint64_t numTicks = (timestamps[1] - timestamps[0]) & gTimestampMask;
+            timings.passUsec[passIdx] = (float)((double) numTicks * gTimestampPeriodUsec);
+        } else {
+            timings.passUsec[passIdx] = -1.0f;
+        }
+    }
+
+    // UI drawing is whatever is drawn that isn't the sky or world
+    const float drawUsec = timings.passUsec[(uint32_t) Pass::Draw];
+
+    if (drawUsec >= 0.0f) {
+        const float skyUsec = std::max(timings.passUsec[(uint32_t) Pass::Sky], 0.0f);
+        const float worldUsec = std::max(timings.passUsec[(uint32_t) Pass::World], 0.0f);
+        timings.uiUsec = std::max(drawUsec - skyUsec - worldUsec, 0.0f);
+    } else {
+        timings.uiUsec = -1.0f;
+    }
+
+    gLastResolvedTimings = timings;
+    gbHaveResolvedTimings = true;
+    slotFrame.bPending = false;
+
+    if (gpCsvFile) {
+        writeCsvLine(timings);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Creates the query pools used for profiling and opens the CSV file to output timings to, if one was specified
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init(vgl::LogicalDevice& device) noexcept {
+    // Timestamps are only supported if the work queue has some valid timestamp bits (lavapipe and most GPUs support them)
+    const vgl::PhysicalDevice& physicalDevice = *device.getPhysicalDevice();
+    const VkQueueFamilyProperties& queueFamilyProps = physicalDevice.getQueueFamilyProps()[device.getWorkQueueFamilyIdx()];
+    const uint32_t timestampValidBits = queueFamilyProps.timestampValidBits;
+    const float timestampPeriodNs = physicalDevice.getProps().limits.timestampPeriod;
+
+    gbIsSupported = ((timestampValidBits > 0) && (timestampPeriodNs > 0.0f));
+    gTimestampPeriodUsec = (double) timestampPeriodNs / 1000.0;
+    gTimestampMask = (timestampValidBits >= 64) ? UINT64_MAX : ((uint64_t) 1 << timestampValidBits) - 1;
+
+    for (vgl::QueryPool& queryPool : gQueryPools) {
+        if (gbIsSupported && (!queryPool.init(device, VK_QUERY_TYPE_TIMESTAMP, NUM_QUERIES))) {
+            gbIsSupported = false;
+        }
+    }
+
+    if (!gbIsSupported) {
+        std::printf("PsyDoom: GPU timestamp queries are not supported by the Vulkan device, GPU profiling will be unavailable!\n");
+    }
+
+    // Open up the CSV file if requested
+    const char* const csvFilePath = ProgArgs::gGpuProfileCsvFilePath;
+
+    if (gbIsSupported && csvFilePath[0]) {
+        gpCsvFile = std::fopen(csvFilePath, "w");
+
+        if (gpCsvFile) {
+            writeCsvHeader();
+        } else {
+            std::printf("PsyDoom: failed to open GPU profile CSV file '%s' for writing!\n", csvFilePath);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Destroys the query pools and closes the CSV file, if open. Expects the device to be idle.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void destroy() noexcept {
+    // Output the timings for any frames which have not been read back yet
+    for (uint32_t ringbufferIdx = 0; ringbufferIdx < vgl::Defines::RINGBUFFER_SIZE; ++ringbufferIdx) {
+        if (gSlotFrames[ringbufferIdx].bPending) {
+            resolveSlotFrame(ringbufferIdx);
+        }
+    }
+
+    if (gpCsvFile) {
+        std::fclose(gpCsvFile);
+        gpCsvFile = nullptr;
+    }
+
+    for (vgl::QueryPool& queryPool : gQueryPools) {
+        queryPool.destroy(true);
+    }
+
+    for (SlotFrame& slotFrame : gSlotFrames) {
+        slotFrame = {};
+    }
+
+    gpCurSlotFrame = nullptr;
+    gNextFrameNum = 0;
+    gLastResolvedTimings = {};
+    gbHaveResolvedTimings = false;
+    gTimestampMask = 0;
+    gTimestampPeriodUsec = 0.0;
+    gbIsSupported = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if profiling is being done: profiling only happens when the timings are shown or being output to a CSV file
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isEnabled() noexcept {
+    return (gbIsSupported && (Config::gbShowPerfCounters || gpCsvFile));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Begins profiling a frame: must be called after the frame's command buffer begins recording and outside of any render pass.
+// Reads back the timings for the previous frame which used the same ringbuffer slot, which must have finished executing.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void beginFrame(vgl::CmdBufferRecorder& cmdRec, const uint32_t ringbufferIdx) noexcept {
+    ASSERT(ringbufferIdx < vgl::Defines::RINGBUFFER_SIZE);
+    ASSERT(!gpCurSlotFrame);
+    const uint64_t frameNum = gNextFrameNum++;
+
+    if (!gbIsSupported)
+        return;
+
+    SlotFrame& slotFrame = gSlotFrames[ringbufferIdx];
+
+    if (slotFrame.bPending) {
+        resolveSlotFrame(ringbufferIdx);
+    }
+
+    if (!isEnabled())
+        return;
+
+    // Reset all the queries for the slot and start timing the frame
+    cmdRec.resetQueryPool(gQueryPools[ringbufferIdx], 0, NUM_QUERIES);
+
+    slotFrame.frameNum = frameNum;
+    slotFrame.passBeginMask = 0;
+    slotFrame.passEndMask = 0;
+    std::fill(std::begin(slotFrame.cpuStageUsec), std::end(slotFrame.cpuStageUsec), -1.0f);
+    gpCurSlotFrame = &slotFrame;
+
+    writeTimestamp(cmdRec, Pass::Frame, false);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Ends profiling for a frame: must be called before the frame's command buffer ends recording and is submitted
+//------------------------------------------------------------------------------------------------------------------------------------------
+void endFrame(vgl::CmdBufferRecorder& cmdRec) noexcept {
+    if (!gpCurSlotFrame)
+        return;
+
+    writeTimestamp(cmdRec, Pass::Frame, true);
+    gpCurSlotFrame->bPending = true;
+    gpCurSlotFrame = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Records a command to write the begin or end timestamp for a pass, if the frame is being profiled.
+// Each timestamp can only be written once per frame: if a pass happens more than once in a frame then only the first time is measured.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void writeTimestamp(vgl::CmdBufferRecorder& cmdRec, const Pass pass, const bool bPassEnd) noexcept {
+    ASSERT(pass < Pass::NUM_PASSES);
+
+    if (!gpCurSlotFrame)
+        return;
+
+    const uint32_t passBit = 1u << (uint32_t) pass;
+    uint32_t& writtenMask = (bPassEnd) ? gpCurSlotFrame->passEndMask : gpCurSlotFrame->passBeginMask;
+
+    if (writtenMask & passBit)
+        return;
+
+    // Can't end a pass that was never begun
+    if (bPassEnd && ((gpCurSlotFrame->passBeginMask & passBit) == 0))
+        return;
+
+    const uint32_t ringbufferIdx = (uint32_t)(gpCurSlotFrame - gSlotFrames);
+    const uint32_t queryIdx = (uint32_t) pass * 2 + (bPassEnd ? 1 : 0);
+    cmdRec.writeTimestamp(gQueryPools[ringbufferIdx], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryIdx);
+    writtenMask |= passBit;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Saves how long a stage of 'RV_RenderPlayerView' took on the CPU for the current frame, if the frame is being profiled
+//------------------------------------------------------------------------------------------------------------------------------------------
+void setCpuStageTime(const CpuStage stage, const float usec) noexcept {
+    ASSERT(stage < CpuStage::NUM_STAGES);
+
+    if (gpCurSlotFrame) {
+        gpCurSlotFrame->cpuStageUsec[(uint32_t) stage] = usec;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Gets the timings for the most recent frame that has been read back, returning 'false' if there are no timings available yet
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool getLastResolvedTimings(FrameTimings& timings) noexcept {
+    timings = gLastResolvedTimings;
+    return gbHaveResolvedTimings;
+}
+
+END_NAMESPACE(VGpuProfiler)
+
+#endif  // #if PSYDOOM_VULKAN_RENDERER
@@ -0,0 +1,60 @@
+#pragma once
+
+#if PSYDOOM_VULKAN_RENDERER
+
+#include "Macros.h"
+
+#include <cstdint>
+
+namespace vgl {
+    class CmdBufferRecorder;
+    class LogicalDevice;
+}
+
+BEGIN_NAMESPACE(VGpuProfiler)
+
+// A section of the frame's GPU work which is timed using a pair of timestamp queries
+enum class Pass : uint32_t {
+    Frame,              // All of the frame's commands
+    PathPsx,            // The classic PSX render path
+    PathMain,           // The main Vulkan render path, including the blit to the swapchain
+    PathCrossfade,      // The crossfade render path
+    PathBlit,           // The blit render path
+    Draw,               // All drawing recorded by 'VDrawing' for the frame
+    Sky,                // The background sky
+    World,              // World geometry (walls, flats and sprites)
+    MsaaResolve,        // The MSAA resolve subpass
+    NUM_PASSES
+};
+
+// A stage of 'RV_RenderPlayerView' which is timed on the CPU
+enum class CpuStage : uint32_t {
+    Setup,              // Determining draw params and BSP traversal
+    SpriteFrags,        // Building the lists of sprite fragments to draw
+    Sky,                // Sky texture caching and drawing the background sky
+    Geom,               // Generating world geometry
+    Weapon,             // Post world cleanup, drawing the status bar letterbox and the player weapon
+    NUM_STAGES
+};
+
+// GPU and CPU timings for a single frame, in microseconds.
+// Timings for passes or stages which did not happen in the frame are negative.
+struct FrameTimings {
+    uint64_t    frameNum;
+    float       passUsec[(uint32_t) Pass::NUM_PASSES];
+    float       uiUsec;                                         // Drawing time which isn't the sky or world: derived from the other passes
+    float       cpuStageUsec[(uint32_t) CpuStage::NUM_STAGES];
+};
+
+void init(vgl::LogicalDevice& device) noexcept;
+void destroy() noexcept;
+bool isEnabled() noexcept;
+void beginFrame(vgl::CmdBufferRecorder& cmdRec, const uint32_t ringbufferIdx) noexcept;
+void endFrame(vgl::CmdBufferRecorder& cmdRec) noexcept;
+void writeTimestamp(vgl::CmdBufferRecorder& cmdRec, const Pass pass, const bool bPassEnd) noexcept;
+void setCpuStageTime(const CpuStage stage, const float usec) noexcept;
+bool getLastResolvedTimings(FrameTimings& timings) noexcept;
+
+END_NAMESPACE(VGpuProfiler)
+
+#endif  // #if PSYDOOM_VULKAN_RENDERER
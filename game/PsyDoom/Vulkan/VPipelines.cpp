@@ -33,6 +33,7 @@ BEGIN_NAMESPACE(VPipelines)
 #include "SPIRV_ui_4bpp_frag.bin.h"
 #include "SPIRV_ui_8bpp_frag.bin.h"
 #include "SPIRV_ui_vert.bin.h"
+#include "SPIRV_world_atlas_frag.bin.h"
 #include "SPIRV_world_frag.bin.h"
 #include "SPIRV_world_vert.bin.h"
 
@@ -70,6 +71,7 @@ static vgl::ShaderModule    gShader_ui_4bpp_frag;
 static vgl::ShaderModule    gShader_ui_8bpp_frag;
 static vgl::ShaderModule    gShader_world_vert;
 static vgl::ShaderModule    gShader_world_frag;
+static vgl::ShaderModule    gShader_world_atlas_frag;
 static vgl::ShaderModule    gShader_sky_vert;
 static vgl::ShaderModule    gShader_sky_frag;
 static vgl::ShaderModule    gShader_ndc_textured_vert;
@@ -84,6 +86,7 @@ vgl::ShaderModule* const gShaders_ui_4bpp[]     = { &gShader_ui_vert, &gShader_u
 vgl::ShaderModule* const gShaders_ui_8bpp[]     = { &gShader_ui_vert, &gShader_ui_8bpp_frag };
 vgl::ShaderModule* const gShaders_ui_16bpp[]    = { &gShader_ui_vert, &gShader_ui_16bpp_frag };
 vgl::ShaderModule* const gShaders_world[]       = { &gShader_world_vert, &gShader_world_frag };
+vgl::ShaderModule* const gShaders_worldAtlas[]  = { &gShader_world_vert, &gShader_world_atlas_frag };
 vgl::ShaderModule* const gShaders_sky[]         = { &gShader_sky_vert, &gShader_sky_frag };
 vgl::ShaderModule* const gShaders_ndcTextured[] = { &gShader_ndc_textured_vert, &gShader_ndc_textured_frag };
 vgl::ShaderModule* const gShaders_crossfade[]   = { &gShader_ndc_textured_vert, &gShader_crossfade_frag };
@@ -163,6 +166,7 @@ static void initShaders(vgl::LogicalDevice& device) noexcept {
     initShader(device, gShader_ui_16bpp_frag, VK_SHADER_STAGE_FRAGMENT_BIT, gSPIRV_ui_16bpp_frag, sizeof(gSPIRV_ui_16bpp_frag), "ui_16bpp_frag");
     initShader(device, gShader_world_vert, VK_SHADER_STAGE_VERTEX_BIT, gSPIRV_world_vert, sizeof(gSPIRV_world_vert), "world_vert");
     initShader(device, gShader_world_frag, VK_SHADER_STAGE_FRAGMENT_BIT, gSPIRV_world_frag, sizeof(gSPIRV_world_frag), "world_frag");
+    initShader(device, gShader_world_atlas_frag, VK_SHADER_STAGE_FRAGMENT_BIT, gSPIRV_world_atlas_frag, sizeof(gSPIRV_world_atlas_frag), "world_atlas_frag");
     initShader(device, gShader_sky_vert, VK_SHADER_STAGE_VERTEX_BIT, gSPIRV_sky_vert, sizeof(gSPIRV_sky_vert), "sky_vert");
     initShader(device, gShader_sky_frag, VK_SHADER_STAGE_FRAGMENT_BIT, gSPIRV_sky_frag, sizeof(gSPIRV_sky_frag), "sky_frag");
     initShader(device, gShader_ndc_textured_vert, VK_SHADER_STAGE_VERTEX_BIT, gSPIRV_ndc_textured_vert, sizeof(gSPIRV_ndc_textured_vert), "ndc_textured_vert");
@@ -576,6 +580,12 @@ void initPipelines(
     initDrawPipeline(VPipelineType::World_SpriteAlpha, mainRPath, gShaders_world, gInputAS_triList, gRasterState_noCull, gBlendState_alpha, gDepthState_disabled, false, false);
     initDrawPipeline(VPipelineType::World_SpriteAdditive, mainRPath, gShaders_world, gInputAS_triList, gRasterState_noCull, gBlendState_additive, gDepthState_disabled, false, false);
     initDrawPipeline(VPipelineType::World_SpriteSubtractive, mainRPath, gShaders_world, gInputAS_triList, gRasterState_noCull, gBlendState_subtractive, gDepthState_disabled, false, false);
+    initDrawPipeline(VPipelineType::World_GeomMasked_Atlas, mainRPath, gShaders_worldAtlas, gInputAS_triList, gRasterState_backFaceCull, gBlendState_noBlend, gDepthState_disabled, true, false);
+    initDrawPipeline(VPipelineType::World_GeomAlpha_Atlas, mainRPath, gShaders_worldAtlas, gInputAS_triList, gRasterState_backFaceCull, gBlendState_alpha, gDepthState_disabled, true, false);
+    initDrawPipeline(VPipelineType::World_SpriteMasked_Atlas, mainRPath, gShaders_worldAtlas, gInputAS_triList, gRasterState_noCull, gBlendState_noBlend, gDepthState_disabled, false, false);
+    initDrawPipeline(VPipelineType::World_SpriteAlpha_Atlas, mainRPath, gShaders_worldAtlas, gInputAS_triList, gRasterState_noCull, gBlendState_alpha, gDepthState_disabled, false, false);
+    initDrawPipeline(VPipelineType::World_SpriteAdditive_Atlas, mainRPath, gShaders_worldAtlas, gInputAS_triList, gRasterState_noCull, gBlendState_additive, gDepthState_disabled, false, false);
+    initDrawPipeline(VPipelineType::World_SpriteSubtractive_Atlas, mainRPath, gShaders_worldAtlas, gInputAS_triList, gRasterState_noCull, gBlendState_subtractive, gDepthState_disabled, false, false);
     initDrawPipeline(VPipelineType::World_Sky, mainRPath, gShaders_sky, gInputAS_triList, gRasterState_backFaceCull, gBlendState_noBlend, gDepthState_disabled, true, true);
 
     // The pipeline to resolve MSAA: only bother creating this if we are doing MSAA.
@@ -661,6 +671,7 @@ void shutdown() noexcept {
     gShader_ndc_textured_vert.destroy(true);
     gShader_sky_frag.destroy(true);
     gShader_sky_vert.destroy(true);
+    gShader_world_atlas_frag.destroy(true);
     gShader_world_frag.destroy(true);
     gShader_world_vert.destroy(true);
     gShader_ui_16bpp_frag.destroy(true);
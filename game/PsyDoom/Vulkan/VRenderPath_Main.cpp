@@ -7,6 +7,7 @@
 #include "RenderPassDef.h"
 #include "Swapchain.h"
 #include "VDrawing.h"
+#include "VGpuProfiler.h"
 #include "VRenderer.h"
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -232,7 +233,9 @@ void VRenderPath_Main::endFrame(vgl::Swapchain& swapchain, vgl::CmdBufferRecorde
     // Do an MSAA resolve subpass if MSAA is enabled
     if (mNumDrawSamples > 1) {
         cmdRec.nextSubpass(VK_SUBPASS_CONTENTS_INLINE);
+        VGpuProfiler::writeTimestamp(cmdRec, VGpuProfiler::Pass::MsaaResolve, false);
         mMsaaResolver.resolve(cmdRec);
+        VGpuProfiler::writeTimestamp(cmdRec, VGpuProfiler::Pass::MsaaResolve, true);
     }
 
     // Done with the render pass now
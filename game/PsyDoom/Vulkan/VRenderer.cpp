@@ -15,6 +15,7 @@
 #include "PhysicalDeviceSelection.h"
 #include "PsyDoom/Config/Config.h"
 #include "PsyDoom/PlayerPrefs.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/PsxVm.h"
 #include "PsyDoom/Video.h"
 #include "Semaphore.h"
@@ -22,6 +23,7 @@
 #include "Texture.h"
 #include "VCrossfader.h"
 #include "VDrawing.h"
+#include "VGpuProfiler.h"
 #include "VkFuncs.h"
 #include "VPipelines.h"
 #include "VPlaqueDrawer.h"
@@ -29,6 +31,7 @@
 #include "VRenderPath_Crossfade.h"
 #include "VRenderPath_Main.h"
 #include "VRenderPath_Psx.h"
+#include "VTexAtlas.h"
 #include "VulkanInstance.h"
 #include "WindowSurface.h"
 
@@ -138,6 +141,9 @@ static vgl::Texture gPsxVramTexture;
 static IVRendererPath* gpCurRenderPath;
 static IVRendererPath* gpNextRenderPath;
 
+// The GPU profiler pass used to time the render path for the current frame
+static VGpuProfiler::Pass gCurRenderPathProfilerPass;
+
 // If true then skip presenting the next frame
 static bool gbSkipNextFramePresent;
 
@@ -626,7 +632,9 @@ void init() noexcept {
         gPsxVramTexture.unlock();
     }
 
-    // Initialize the draw command submission module, crossfader and loading plaque drawer
+    // Initialize the GPU profiler, texture atlas, draw command submission module, crossfader and loading plaque drawer
+    VGpuProfiler::init(gDevice);
+    VTexAtlas::init(gDevice);
     VDrawing::init(gDevice, gPsxVramTexture);
     VCrossfader::init(gDevice);
     VPlaqueDrawer::init(gDevice);
@@ -662,6 +670,8 @@ void destroy() noexcept {
     VPlaqueDrawer::destroy();
     VCrossfader::destroy();
     VDrawing::shutdown();
+    VTexAtlas::destroy();
+    VGpuProfiler::destroy();
 
     gbDidAcquireSwapImageThisFrame = false;
     gbSkipNextFramePresent = false;
@@ -756,6 +766,21 @@ bool beginFrame() noexcept {
         );
     }
 
+    // Start GPU profiling for the frame, if enabled, and time the render path used
+    VGpuProfiler::beginFrame(gCmdBufferRec, ringbufferIdx);
+
+    if (gpCurRenderPath == &gRenderPath_Main) {
+        gCurRenderPathProfilerPass = VGpuProfiler::Pass::PathMain;
+    } else if (gpCurRenderPath == &gRenderPath_Crossfade) {
+        gCurRenderPathProfilerPass = VGpuProfiler::Pass::PathCrossfade;
+    } else if (gpCurRenderPath == &gRenderPath_Blit) {
+        gCurRenderPathProfilerPass = VGpuProfiler::Pass::PathBlit;
+    } else {
+        gCurRenderPathProfilerPass = VGpuProfiler::Pass::PathPsx;
+    }
+
+    VGpuProfiler::writeTimestamp(gCmdBufferRec, gCurRenderPathProfilerPass, false);
+
     // Render path specific frame start
     gpCurRenderPath->beginFrame(gSwapchain, gCmdBufferRec);
     return true;
@@ -775,6 +800,8 @@ bool isRendering() noexcept {
 // End the current frame and present to the screen
 //------------------------------------------------------------------------------------------------------------------------------------------
 void endFrame() noexcept {
+    PROFILE_ZONE("VRenderer_EndFrame");
+
     // Must have begun the frame
     ASSERT(gbDidBeginFrame);
     gbDidBeginFrame = false;
@@ -789,8 +816,10 @@ void endFrame() noexcept {
             }
         #endif
 
-        // Finish up the frame for the render path
+        // Finish up the frame for the render path and GPU profiling
         gpCurRenderPath->endFrame(gSwapchain, gCmdBufferRec);
+        VGpuProfiler::writeTimestamp(gCmdBufferRec, gCurRenderPathProfilerPass, true);
+        VGpuProfiler::endFrame(gCmdBufferRec);
     }
 
     // Begin executing any pending transfers
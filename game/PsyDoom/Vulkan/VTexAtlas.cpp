@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// An optional atlas of pre-decoded world textures for the Vulkan renderer.
+//
+// World textures are 8bpp and normally the world shader has to fetch the palette index from PSX VRAM and then do a dependent fetch of
+// the CLUT to get the actual color, for every fragment. With MSAA and high resolutions that extra fetch can be a big part of the cost of
+// drawing. When the atlas is enabled, textures have the CLUT applied once on the CPU when they are first drawn after being uploaded to VRAM
+// and the result is stored in the atlas. World draws for those textures can then use pipelines which need only a single texture fetch.
+//
+// The atlas mirrors PSX VRAM at 8bpp resolution (twice as wide as VRAM) so textures are found at their usual texture window coordinates.
+// Decoded texels are stored in the same 16-bit PSX color format as VRAM, which preserves the masking and semi-transparency behavior.
+//
+// Which textures are decoded (and with what CLUT) is tracked on each texture, and the renderer falls back to the regular pipelines for
+// any texture that is not decoded. To avoid repeatedly re-decoding textures during palette flashes, textures are only decoded once the
+// 3D view's CLUT has stayed the same for a few frames.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "VTexAtlas.h"
+
+#if PSYDOOM_VULKAN_RENDERER
+
+#include "Asserts.h"
+#include "Gpu.h"
+#include "LogicalDevice.h"
+#include "PhysicalDevice.h"
+#include "PsyDoom/Config/Config.h"
+#include "PsyDoom/PsxVm.h"
+#include "Texture.h"
+#include "VTypes.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+BEGIN_NAMESPACE(VTexAtlas)
+
+// How many frames in a row the 3D view CLUT must be the same before textures are decoded with it
+static constexpr uint32_t STABLE_CLUT_NUM_FRAMES = 8;
+
+// The number of entries in an 8bpp CLUT
+static constexpr uint32_t CLUT_SIZE = 256;
+
+// The atlas texture: only valid if the atlas is enabled
+static vgl::Texture gAtlasTexture;
+
+// The CLUT currently used by the 3D view and how many frames in a row it has been in use for
+static uint16_t gViewClutX;
+static uint16_t gViewClutY;
+static uint32_t gViewClutNumFrames;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Creates the atlas texture if the atlas is enabled in the graphics config and the device can support a texture of the required size
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init(vgl::LogicalDevice& device) noexcept {
+    ASSERT(!gAtlasTexture.isValid());
+
+    if (!Config::gbUseVulkanTextureAtlas)
+        return;
+
+    // The atlas is twice as wide as VRAM so that every 8bpp texel has its own 16bpp texel in the atlas
+    const Gpu::Core& psxGpu = PsxVm::gGpu;
+    const uint32_t atlasW = psxGpu.ramPixelW * 2;
+    const uint32_t atlasH = psxGpu.ramPixelH;
+    const uint32_t vkMaxTexSize = device.getPhysicalDevice()->getProps().limits.maxImageDimension2D;
+
+    if ((atlasW > vkMaxTexSize) || (atlasH > vkMaxTexSize)) {
+        std::printf(
+            "PsyDoom: WARNING: the Vulkan texture atlas has been disabled because the current Vulkan device does not support textures of %ux%u.\n"
+            "Lowering 'VramSizeInMegabytes' in 'graphics_cfg.ini' may allow the texture atlas to be used.\n",
+            atlasW,
+            atlasH
+        );
+
+        return;
+    }
+
+    if (!gAtlasTexture.initAs2dTexture(device, VK_FORMAT_R16_UINT, atlasW, atlasH)) {
+        std::printf("PsyDoom: WARNING: failed to create the Vulkan texture atlas, it will not be used!\n");
+        return;
+    }
+
+    // Start off with all texels being transparent
+    std::byte* const pBytes = gAtlasTexture.lock();
+    std::memset(pBytes, 0, (size_t) gAtlasTexture.getLockedSizeInBytes());
+    gAtlasTexture.unlock();
+
+    gViewClutX = 0;
+    gViewClutY = 0;
+    gViewClutNumFrames = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Frees the atlas texture
+//------------------------------------------------------------------------------------------------------------------------------------------
+void destroy() noexcept {
+    gAtlasTexture.destroy(true);
+    gViewClutNumFrames = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the texture atlas is in use
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isEnabled() noexcept {
+    return gAtlasTexture.isValid();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the atlas texture: only valid to call if the atlas is enabled
+//------------------------------------------------------------------------------------------------------------------------------------------
+vgl::BaseTexture& getTexture() noexcept {
+    ASSERT(gAtlasTexture.isValid());
+    return gAtlasTexture;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Informs the atlas of the CLUT being used to draw the 3D view for this frame; should be called once per frame that the view is drawn
+//------------------------------------------------------------------------------------------------------------------------------------------
+void setViewClut(const uint16_t clutX, const uint16_t clutY) noexcept {
+    if ((clutX == gViewClutX) && (clutY == gViewClutY)) {
+        gViewClutNumFrames = std::min(gViewClutNumFrames + 1, STABLE_CLUT_NUM_FRAMES);
+    } else {
+        gViewClutX = clutX;
+        gViewClutY = clutY;
+        gViewClutNumFrames = 1;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the 3D view CLUT has been the same for long enough that it is worth decoding textures with it
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isViewClutStable() noexcept {
+    return (gViewClutNumFrames >= STABLE_CLUT_NUM_FRAMES);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Decodes the specified 8bpp texture window in PSX VRAM into the same area of the atlas, using the specified CLUT.
+// The area decoded is clipped to the bounds of the atlas.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void decodeTexels(
+    const uint16_t texWinX,
+    const uint16_t texWinY,
+    const uint16_t texWinW,
+    const uint16_t texWinH,
+    const uint16_t clutX,
+    const uint16_t clutY
+) noexcept {
+    ASSERT(gAtlasTexture.isValid());
+
+    const Gpu::Core& psxGpu = PsxVm::gGpu;
+    const uint32_t vramW = psxGpu.ramPixelW;
+    const uint32_t vramH = psxGpu.ramPixelH;
+    const uint32_t atlasW = vramW * 2;
+
+    // Clip the area to be decoded
+    const uint32_t decodeW = std::min<uint32_t>(texWinW, atlasW - std::min<uint32_t>(texWinX, atlasW));
+    const uint32_t decodeH = std::min<uint32_t>(texWinH, vramH - std::min<uint32_t>(texWinY, vramH));
+
+    if ((decodeW == 0) || (decodeH == 0))
+        return;
+
+    // Make a copy of the CLUT, treating entries which are outside of VRAM as transparent (the same as the GPU would read them)
+    uint16_t clut[CLUT_SIZE] = {};
+
+    if ((clutX < vramW) && (clutY < vramH)) {
+        const uint32_t numClutEntries = std::min<uint32_t>(CLUT_SIZE, vramW - clutX);
+        std::memcpy(clut, psxGpu.pRam + clutX + (uintptr_t) clutY * vramW, numClutEntries * sizeof(uint16_t));
+    }
+
+    // Lock the required region of the atlas and decode the texels, row by row.
+    // Note: 8bpp texels are stored in VRAM from the low byte to the high byte of each 16-bit pixel, hence the byte addressing here.
+    uint16_t* pDstTexels = (uint16_t*) gAtlasTexture.lock(texWinX, texWinY, 0, 0, decodeW, decodeH, 1, 1);
+    const uint8_t* pSrcTexels = (const uint8_t*)(psxGpu.pRam + (uintptr_t) texWinY * vramW) + texWinX;
+
+    for (uint32_t y = 0; y < decodeH; ++y) {
+        for (uint32_t x = 0; x < decodeW; ++x) {
+            pDstTexels[x] = clut[pSrcTexels[x]];
+        }
+
+        pDstTexels += decodeW;
+        pSrcTexels += atlasW;
+    }
+
+    // Unlock the atlas to begin uploading the decoded texels
+    gAtlasTexture.unlock();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the variant of the specified world pipeline which reads from the texture atlas.
+// Pipelines which have no atlas variant are returned unchanged.
+//------------------------------------------------------------------------------------------------------------------------------------------
+VPipelineType getAtlasPipelineType(const VPipelineType pipelineType) noexcept {
+    switch (pipelineType) {
+        case VPipelineType::World_GeomMasked:           return VPipelineType::World_GeomMasked_Atlas;
+        case VPipelineType::World_GeomAlpha:            return VPipelineType::World_GeomAlpha_Atlas;
+        case VPipelineType::World_SpriteMasked:         return VPipelineType::World_SpriteMasked_Atlas;
+        case VPipelineType::World_SpriteAlpha:          return VPipelineType::World_SpriteAlpha_Atlas;
+        case VPipelineType::World_SpriteAdditive:       return VPipelineType::World_SpriteAdditive_Atlas;
+        case VPipelineType::World_SpriteSubtractive:    return VPipelineType::World_SpriteSubtractive_Atlas;
+
+        default:
+            return pipelineType;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the specified pipeline reads from the texture atlas rather than PSX VRAM
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isAtlasPipelineType(const VPipelineType pipelineType) noexcept {
+    switch (pipelineType) {
+        case VPipelineType::World_GeomMasked_Atlas:
+        case VPipelineType::World_GeomAlpha_Atlas:
+        case VPipelineType::World_SpriteMasked_Atlas:
+        case VPipelineType::World_SpriteAlpha_Atlas:
+        case VPipelineType::World_SpriteAdditive_Atlas:
+        case VPipelineType::World_SpriteSubtractive_Atlas:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+END_NAMESPACE(VTexAtlas)
+
+#endif  // #if PSYDOOM_VULKAN_RENDERER
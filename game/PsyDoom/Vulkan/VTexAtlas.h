@@ -0,0 +1,30 @@
+#pragma once
+
+#if PSYDOOM_VULKAN_RENDERER
+
+#include "Macros.h"
+
+#include <cstdint>
+
+enum class VPipelineType : uint8_t;
+
+namespace vgl {
+    class BaseTexture;
+    class LogicalDevice;
+}
+
+BEGIN_NAMESPACE(VTexAtlas)
+
+void init(vgl::LogicalDevice& device) noexcept;
+void destroy() noexcept;
+bool isEnabled() noexcept;
+vgl::BaseTexture& getTexture() noexcept;
+void setViewClut(const uint16_t clutX, const uint16_t clutY) noexcept;
+bool isViewClutStable() noexcept;
+void decodeTexels(const uint16_t texWinX, const uint16_t texWinY, const uint16_t texWinW, const uint16_t texWinH, const uint16_t clutX, const uint16_t clutY) noexcept;
+VPipelineType getAtlasPipelineType(const VPipelineType pipelineType) noexcept;
+bool isAtlasPipelineType(const VPipelineType pipelineType) noexcept;
+
+END_NAMESPACE(VTexAtlas)
+
+#endif  // #if PSYDOOM_VULKAN_RENDERER
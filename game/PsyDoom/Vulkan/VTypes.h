@@ -14,23 +14,29 @@
 // Affects the primitive types expected, shaders used, blending mode and so on.
 //------------------------------------------------------------------------------------------------------------------------------------------
 enum class VPipelineType : uint8_t {
-    Lines,                      // Solid colored lines, no blending: can be in either 2D or 3D (for debug use for example)
-    Colored,                    // Solid colored triangles, no blending: can be in either 2D or 3D (for debug use for example)
-    UI_4bpp,                    // 2D/UI: texture mapped with clamping @ 4bpp, masked but no blending
-    UI_8bpp,                    // 2D/UI: texture mapped with clamping @ 8bpp, masked but no blending
-    UI_8bpp_Add,                // 2D/UI: texture mapped with clamping @ 8bpp, masked & additive blended (used for player weapon when partial invisibility is active)
-    UI_16bpp,                   // 2D/UI: texture mapped with clamping @ 16bpp, masked but no blending
-    World_GeomMasked,           // 3D world/view: textured with wrapping @ 8bpp and lit, masked but no blending
-    World_GeomAlpha,            // 3D world/view: textured with wrapping @ 8bpp and lit, masked & alpha blended
-    World_SpriteMasked,         // 3D world/view: textured with clamping @ 8bpp and lit, masked but no blending
-    World_SpriteAlpha,          // 3D world/view: textured with clamping @ 8bpp and lit, masked & alpha blended
-    World_SpriteAdditive,       // 3D world/view: textured with clamping @ 8bpp and lit, masked & additive blended
-    World_SpriteSubtractive,    // 3D world/view: textured with clamping @ 8bpp and lit, masked & subtractive blended
-    World_Sky,                  // 3D world/view: used to draw the sky, masked but no blending
-    Msaa_Resolve,               // Simple shader that resolves MSAA samples
-    Crossfade,                  // Used for doing crossfades
-    LoadingPlaque,              // Used for drawing loading plaques
-    NUM_TYPES                   // Convenience declaration...
+    Lines,                          // Solid colored lines, no blending: can be in either 2D or 3D (for debug use for example)
+    Colored,                        // Solid colored triangles, no blending: can be in either 2D or 3D (for debug use for example)
+    UI_4bpp,                        // 2D/UI: texture mapped with clamping @ 4bpp, masked but no blending
+    UI_8bpp,                        // 2D/UI: texture mapped with clamping @ 8bpp, masked but no blending
+    UI_8bpp_Add,                    // 2D/UI: texture mapped with clamping @ 8bpp, masked & additive blended (used for player weapon when partial invisibility is active)
+    UI_16bpp,                       // 2D/UI: texture mapped with clamping @ 16bpp, masked but no blending
+    World_GeomMasked,               // 3D world/view: textured with wrapping @ 8bpp and lit, masked but no blending
+    World_GeomAlpha,                // 3D world/view: textured with wrapping @ 8bpp and lit, masked & alpha blended
+    World_SpriteMasked,             // 3D world/view: textured with clamping @ 8bpp and lit, masked but no blending
+    World_SpriteAlpha,              // 3D world/view: textured with clamping @ 8bpp and lit, masked & alpha blended
+    World_SpriteAdditive,           // 3D world/view: textured with clamping @ 8bpp and lit, masked & additive blended
+    World_SpriteSubtractive,        // 3D world/view: textured with clamping @ 8bpp and lit, masked & subtractive blended
+    World_GeomMasked_Atlas,         // Same as 'World_GeomMasked' but reads pre-decoded texels from the texture atlas
+    World_GeomAlpha_Atlas,          // Same as 'World_GeomAlpha' but reads pre-decoded texels from the texture atlas
+    World_SpriteMasked_Atlas,       // Same as 'World_SpriteMasked' but reads pre-decoded texels from the texture atlas
+    World_SpriteAlpha_Atlas,        // Same as 'World_SpriteAlpha' but reads pre-decoded texels from the texture atlas
+    World_SpriteAdditive_Atlas,     // Same as 'World_SpriteAdditive' but reads pre-decoded texels from the texture atlas
+    World_SpriteSubtractive_Atlas,  // Same as 'World_SpriteSubtractive' but reads pre-decoded texels from the texture atlas
+    World_Sky,                      // 3D world/view: used to draw the sky, masked but no blending
+    Msaa_Resolve,                   // Simple shader that resolves MSAA samples
+    Crossfade,                      // Used for doing crossfades
+    LoadingPlaque,                  // Used for drawing loading plaques
+    NUM_TYPES                       // Convenience declaration...
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
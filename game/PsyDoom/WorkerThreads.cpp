@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// A small pool of persistent worker threads for splitting up CPU heavy work within a frame.
+//
+// Work is submitted as a number of jobs (identified by index) which are all run to completion before 'runJobs' returns.
+// The calling thread also participates in running the jobs, so with a pool of 'N' threads there are 'N - 1' background workers.
+// Only one batch of jobs can be in flight at a time and jobs must not submit further jobs.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "WorkerThreads.h"
+
+#include "Asserts.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+BEGIN_NAMESPACE(WorkerThreads)
+
+// The maximum number of threads (including the calling thread) that the pool will use
+static constexpr uint32_t MAX_THREADS = 16;
+
+static std::vector<std::thread>     gWorkers;               // The background worker threads
+static std::mutex                   gMutex;                 // Guards the job batch and the wakeup/finish conditions
+static std::condition_variable      gWakeCondVar;           // Signalled when a new batch of jobs is available or on shutdown
+static std::condition_variable      gDoneCondVar;           // Signalled when the last busy worker finishes with the current batch
+static uint64_t                     gBatchNum;              // Incremented for each new batch of jobs: workers use this to detect new work
+static bool                         gbShutdown;             // Set when the workers should exit
+static uint32_t                     gNumBusyWorkers;        // How many workers have not yet finished with the current batch
+static JobFunc                      gpJobFunc;              // The job function and user data for the current batch
+static void*                        gpJobUserData;
+static uint32_t                     gNumJobs;               // Number of jobs in the current batch
+static std::atomic<uint32_t>        gNextJobIdx;            // The next job in the current batch to be claimed by a thread
+
+// True if the current thread is one of the background worker threads
+static thread_local bool tgbIsWorkerThread;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Claims and runs jobs from the current batch until there are none left
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void runAvailableJobs() noexcept {
+    while (true) {
+        const uint32_t jobIdx = gNextJobIdx.fetch_add(1, std::memory_order_relaxed);
+
+        if (jobIdx >= gNumJobs)
+            break;
+
+        gpJobFunc(jobIdx, gpJobUserData);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Main loop for a background worker thread: waits for batches of jobs and helps to run them
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void workerThreadMain() noexcept {
+    PROFILE_THREAD_NAME("Worker");
+    tgbIsWorkerThread = true;
+    uint64_t lastBatchNum = 0;
+
+    while (true) {
+        // Wait for a new batch of jobs or shutdown
+        {
+            std::unique_lock<std::mutex> lock(gMutex);
+            gWakeCondVar.wait(lock, [&]() noexcept { return (gbShutdown || (gBatchNum != lastBatchNum)); });
+
+            if (gbShutdown)
+                break;
+
+            lastBatchNum = gBatchNum;
+        }
+
+        // Help out with the jobs, then let the submitter know if we were the last worker to finish
+        {
+            PROFILE_ZONE("WorkerJobs");
+            runAvailableJobs();
+        }
+
+        std::lock_guard<std::mutex> lock(gMutex);
+        ASSERT(gNumBusyWorkers > 0);
+
+        if (--gNumBusyWorkers == 0) {
+            gDoneCondVar.notify_one();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Starts up the worker threads, using one thread per hardware thread (up to a limit)
+//------------------------------------------------------------------------------------------------------------------------------------------
+void init() noexcept {
+    ASSERT(gWorkers.empty());
+    const uint32_t numThreads = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_THREADS);
+
+    gbShutdown = false;
+    gBatchNum = 0;
+    gNumBusyWorkers = 0;
+    gWorkers.reserve(numThreads - 1);
+
+    for (uint32_t i = 1; i < numThreads; ++i) {
+        gWorkers.emplace_back(workerThreadMain);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Stops and joins all of the worker threads
+//------------------------------------------------------------------------------------------------------------------------------------------
+void shutdown() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        gbShutdown = true;
+    }
+
+    gWakeCondVar.notify_all();
+
+    for (std::thread& worker : gWorkers) {
+        worker.join();
+    }
+
+    gWorkers.clear();
+    gbShutdown = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the number of threads that jobs can run on, including the thread which submits them
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t getNumThreads() noexcept {
+    return (uint32_t) gWorkers.size() + 1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if the calling thread is one of the background worker threads
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool isWorkerThread() noexcept {
+    return tgbIsWorkerThread;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Runs the specified number of jobs across the worker threads and the calling thread, returning once all of them have finished.
+// If there are no background workers (or just one job) then the jobs are simply run in order on the calling thread.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void runJobs(const uint32_t numJobs, const JobFunc pJobFunc, void* const pUserData) noexcept {
+    ASSERT(pJobFunc);
+    ASSERT_LOG(!tgbIsWorkerThread, "Jobs must not submit more jobs!");
+
+    if ((numJobs <= 1) || gWorkers.empty()) {
+        for (uint32_t jobIdx = 0; jobIdx < numJobs; ++jobIdx) {
+            pJobFunc(jobIdx, pUserData);
+        }
+
+        return;
+    }
+
+    // Publish the batch and wake up the workers
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        ASSERT(gNumBusyWorkers == 0);
+
+        gpJobFunc = pJobFunc;
+        gpJobUserData = pUserData;
+        gNumJobs = numJobs;
+        gNextJobIdx.store(0, std::memory_order_relaxed);
+        gNumBusyWorkers = (uint32_t) gWorkers.size();
+        gBatchNum++;
+    }
+
+    gWakeCondVar.notify_all();
+
+    // Help run the jobs on this thread and then wait for all of the workers to be done
+    runAvailableJobs();
+
+    std::unique_lock<std::mutex> lock(gMutex);
+    gDoneCondVar.wait(lock, []() noexcept { return (gNumBusyWorkers == 0); });
+}
+
+END_NAMESPACE(WorkerThreads)
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+
+BEGIN_NAMESPACE(WorkerThreads)
+
+// Signature for a job function: receives the index of the job to run and the user data passed to 'runJobs'
+typedef void (*JobFunc)(const uint32_t jobIdx, void* const pUserData) noexcept;
+
+void init() noexcept;
+void shutdown() noexcept;
+uint32_t getNumThreads() noexcept;
+bool isWorkerThread() noexcept;
+void runJobs(const uint32_t numJobs, const JobFunc pJobFunc, void* const pUserData) noexcept;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Convenience overload of 'runJobs' which takes a lambda or other callable, which is invoked with the job index.
+// Blocks until all the jobs have finished.
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class Callable>
+void runJobs(const uint32_t numJobs, const Callable& callable) noexcept {
+    const JobFunc pJobFunc = [](const uint32_t jobIdx, void* const pUserData) noexcept {
+        (*(const Callable*) pUserData)(jobIdx);
+    };
+
+    runJobs(numJobs, pJobFunc, (void*) &callable);
+}
+
+END_NAMESPACE(WorkerThreads)
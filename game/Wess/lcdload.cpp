@@ -7,8 +7,8 @@
 #include "lcdload.h"
 
 #include "Doom/Game/p_setup.h"
-#include "Finally.h"
 #include "psxspu.h"
+#include "PsyDoom/LcdCache.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyQ/LIBSPU.h"
 #include "wessapi.h"
@@ -249,6 +249,7 @@ int32_t wess_dig_lcd_data_read(
 // PsyDoom: this function has been rewritten to get rid of low level I/O stuff, for the original version see the 'Old' folder.
 // The goal of the rewrite is to enable modding of the game with new .LCD files for custom maps, since the 'psxcd' I/O functions support
 // replacing original game files with alternate versions on the user's computer.
+// The file is now read in full through the 'LcdCache', which may have already loaded it in the background or kept it from a previous load.
 //------------------------------------------------------------------------------------------------------------------------------------------
 #if PSYDOOM_MODS
 int32_t wess_dig_lcd_load(
@@ -264,15 +265,14 @@ int32_t wess_dig_lcd_load(
     // Clear this error flag
     gbWess_lcd_load_abort = false;
 
-    // Open the LCD file firstly and abort if that fails or the file handle returned is invalid
-    PsxCd_File* const pLcdFile = psxcd_open(lcdFileToLoad);
+    // Get the contents of the LCD file firstly and abort if that fails
+    const std::vector<uint8_t>* const pLcdFileData = LcdCache::getFileData(lcdFileToLoad);
 
-    if (!pLcdFile)
+    if (!pLcdFileData)
         return 0;
 
-    auto closeLcdFileOnExit = finally([&]() noexcept {
-        psxcd_close(*pLcdFile);
-    });
+    const uint8_t* const pLcdBytes = pLcdFileData->data();
+    const int32_t lcdFileSize = (int32_t) pLcdFileData->size();
 
     // Read the LCD file header to sector buffer 1
     struct LCDHeader {
@@ -282,9 +282,11 @@ int32_t wess_dig_lcd_load(
 
     LCDHeader* const pLcdHeader = (LCDHeader*) gWess_sectorBuffer1;
 
-    if (psxcd_read(pLcdHeader, sizeof(LCDHeader), *pLcdFile) != sizeof(LCDHeader))
+    if (lcdFileSize < (int32_t) sizeof(LCDHeader))
         return 0;
 
+    std::memcpy(pLcdHeader, pLcdBytes, sizeof(LCDHeader));
+
     // If the number of sounds is not valid then abort
     if (pLcdHeader->numPatchSamples > MAX_LCD_SOUNDS)
         return 0;
@@ -298,20 +300,21 @@ int32_t wess_dig_lcd_load(
     gWess_lcd_load_samplePos = destSpuAddr;
     gWess_lcd_load_soundBytesLeft = 0;
 
-    // Seek to the first sound data sector in the file and continue reading sound data until we are done
-    if (psxcd_seek(*pLcdFile, CDROM_SECTOR_SIZE, PsxCd_SeekMode::SET) != 0)
+    // The sound data starts at the first sector after the header: abort if the file is too small to have it
+    if (lcdFileSize < CDROM_SECTOR_SIZE)
         return 0;
 
-    // Read all of the sound data and upload to the SPU using sector buffer 2 as a temporary.
+    // Copy all of the sound data and upload to the SPU using sector buffer 2 as a temporary.
     // Note: we've already consumed 1 sector from the file, so the byte count left is adjusted accordingly.
-    int32_t lcdBytesLeft = pLcdFile->size - CDROM_SECTOR_SIZE;
+    int32_t lcdBytesLeft = lcdFileSize - CDROM_SECTOR_SIZE;
+    int32_t lcdFileOffset = CDROM_SECTOR_SIZE;
     int32_t numSpuBytesWritten = 0;
 
     while ((lcdBytesLeft > 0) && (!gbWess_lcd_load_abort)) {
-        // Read this sector from the LCD file and the number of bytes left is smaller then read that amount instead
+        // Copy this sector from the LCD file and the number of bytes left is smaller then copy that amount instead
         uint8_t* const sectorBuffer = gWess_sectorBuffer2;
         const int32_t readSize = (lcdBytesLeft < CDROM_SECTOR_SIZE) ? lcdBytesLeft : CDROM_SECTOR_SIZE;
-        psxcd_read(sectorBuffer, readSize, *pLcdFile);
+        std::memcpy(sectorBuffer, pLcdBytes + lcdFileOffset, (size_t) readSize);
 
         if (readSize < CDROM_SECTOR_SIZE) {
             // When we are not filling part of the buffer then zero it out just for consistency
@@ -320,6 +323,7 @@ int32_t wess_dig_lcd_load(
 
         numSpuBytesWritten += wess_dig_lcd_data_read(sectorBuffer, destSpuAddr + numSpuBytesWritten, pSampleBlock, bOverride);
         lcdBytesLeft -= readSize;
+        lcdFileOffset += readSize;
     }
 
     return numSpuBytesWritten;
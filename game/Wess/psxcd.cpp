@@ -13,8 +13,10 @@
 #include "PsyDoom/DiscInfo.h"
 #include "PsyDoom/DiscReader.h"
 #include "PsyDoom/ModMgr.h"
+#include "PsyDoom/Profiler.h"
 #include "PsyDoom/ProgArgs.h"
 #include "PsyDoom/PsxVm.h"
+#include "PsyDoom/Sim/SimTls.h"
 #include "PsyDoom/Utils.h"
 #include "Spu.h"
 
@@ -34,8 +36,13 @@ static constexpr int32_t CDDA_SECTOR_SIZE   = 2352;     // Size of of a CD digit
 // If true then the 'psxcd' module has been initialized
 static bool gbPSXCD_IsCdInit;
 
-// Used to hold a file temporarily after opening
-static PsxCd_File gPSXCD_cdfile;
+// Used to hold a file temporarily after opening.
+// This is thread local so that files can be opened by background loading threads, as well as the game thread.
+static thread_local PsxCd_File tgPSXCD_cdfile;
+
+// Guards the allocation and freeing of open file slots, so that files can be opened and closed from multiple threads.
+// Reads and seeks do not need the lock because each open file has its own disc reader or host file handle.
+static std::mutex gFileSlotsMutex;
 
 // CD audio playback related state.
 // Access to all of this is controlled by the CD player mutex.
@@ -62,7 +69,7 @@ struct LockCdPlayer {
 };
 
 // Disc readers used for each open file
-static DiscReader gFileDiscReaders[MAX_OPEN_FILES] = {
+static SIM_TLS DiscReader gFileDiscReaders[MAX_OPEN_FILES] = {
     PsxVm::gDiscInfo, PsxVm::gDiscInfo, PsxVm::gDiscInfo, PsxVm::gDiscInfo,
     PsxVm::gDiscInfo, PsxVm::gDiscInfo, PsxVm::gDiscInfo, PsxVm::gDiscInfo,
     PsxVm::gDiscInfo, PsxVm::gDiscInfo, PsxVm::gDiscInfo, PsxVm::gDiscInfo,
@@ -180,14 +187,19 @@ void psxcd_exit() noexcept {
 // Open a specified CD file for reading
 //------------------------------------------------------------------------------------------------------------------------------------------
 PsxCd_File* psxcd_open(const CdFileId discFile) noexcept {
-    // Zero init the temporary file structure
-    gPSXCD_cdfile = {};
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("psxcd_open");
+    #endif
+
+    // Zero init the temporary file structure and lock the open file slots
+    tgPSXCD_cdfile = {};
+    std::lock_guard<std::mutex> fileSlotsLock(gFileSlotsMutex);
 
     // Modding mechanism: allow files to be overridden with user files in a specified directory.
     // Note that we do this check BEFORE validating if the file exists on-disc because PsyDoom now allows Doom format maps (.WAD)
     // to override maps in Final Doom (.ROM files). The .WAD map files of course won't exist on-disc in the case of Final Doom.
     if (ModMgr::areOverridesAvailableForFile(discFile))
-        return (ModMgr::openOverridenFile(discFile, gPSXCD_cdfile)) ? &gPSXCD_cdfile : nullptr;
+        return (ModMgr::openOverridenFile(discFile, tgPSXCD_cdfile)) ? &tgPSXCD_cdfile : nullptr;
 
     // Figure out where the file is on disc and sanity check the file is valid
     const PsxCd_MapTblEntry fileTableEntry = CdMapTbl_GetEntry(discFile);
@@ -221,10 +233,10 @@ PsxCd_File* psxcd_open(const CdFileId discFile) noexcept {
         FatalErrors::raise("psxcd_open: failed to seek to the specified file!");
     }
 
-    gPSXCD_cdfile.size = fileTableEntry.size;
-    gPSXCD_cdfile.startSector = fileTableEntry.startSector;
-    gPSXCD_cdfile.fileHandle = discReaderIdx + 1;
-    return &gPSXCD_cdfile;
+    tgPSXCD_cdfile.size = fileTableEntry.size;
+    tgPSXCD_cdfile.startSector = fileTableEntry.startSector;
+    tgPSXCD_cdfile.fileHandle = discReaderIdx + 1;
+    return &tgPSXCD_cdfile;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -236,6 +248,10 @@ bool psxcd_seeking_for_play() noexcept { return false; }
 // Read the specified number of bytes synchronously from the given CD file and returns the number of bytes read
 //------------------------------------------------------------------------------------------------------------------------------------------
 int32_t psxcd_read(void* const pDest, int32_t numBytes, PsxCd_File& file) noexcept {
+    #if PSYDOOM_MODS
+        PROFILE_ZONE("psxcd_read");
+    #endif
+
     // Modding mechanism: allow files to be overriden with user files in a specified directory
     if (ModMgr::isFileOverriden(file))
         return ModMgr::readFromOverridenFile(pDest, numBytes, file);
@@ -324,6 +340,8 @@ int32_t psxcd_tell(const PsxCd_File& file) noexcept {
 // Close a CD file and free up the file slot
 //------------------------------------------------------------------------------------------------------------------------------------------
 void psxcd_close([[maybe_unused]] PsxCd_File& file) noexcept {
+    std::lock_guard<std::mutex> fileSlotsLock(gFileSlotsMutex);
+
     // Modding mechanism: allow files to be overriden with user files in a specified directory
     if (ModMgr::isFileOverriden(file)) {
         ModMgr::closeOverridenFile(file);
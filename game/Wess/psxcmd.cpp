@@ -33,9 +33,6 @@ const WessDriverFunc gWess_drv_cmds[19] = {
     PSX_NoteOff             // 18
 };
 
-static constexpr uint32_t MAX_RELEASE_TIME_MS       = 0x10000000;   // Maximum time something can release for (milliseconds)
-static constexpr uint32_t MAX_FAST_RELEASE_TIME_MS  = 0x05DC0000;   // A scaled version of the maximum release time that faster, used by some voices.
-
 static master_status_structure*     gpWess_drv_mstat;               // Pointer to the master status structure being used by the sequencer
 static sequence_status*             gpWess_drv_sequenceStats;       // Saved reference to the list of sequence statuses (in the master status struct)
 static track_status*                gpWess_drv_trackStats;          // Saved reference to the list of track statuses (in the master status struct)
@@ -112,7 +109,7 @@ void add_music_mute_note(
 void wess_set_mute_release(const uint32_t newReleaseTimeMs) noexcept {
     // Figure out the SPU release rate value to use, it's a power of 2 shift/scale.
     // Note that the max release rate is '31' and minimum is '2' with this code.
-    uint32_t approxReleaseTimeMs = MAX_RELEASE_TIME_MS;
+    uint32_t approxReleaseTimeMs = WESS_MAX_RELEASE_TIME_MS;
     gWess_drv_muteReleaseRate = 31;
 
     while ((approxReleaseTimeMs > newReleaseTimeMs) && (gWess_drv_muteReleaseRate != 0)) {
@@ -164,24 +161,12 @@ void TriggerPSXVoice(const voice_status& voiceStat, [[maybe_unused]] const uint8
     if (gWess_pan_status == PAN_OFF) {
         triggerPan = WESS_PAN_CENTER;
     } else {
-        // Note: deduct 'WESS_PAN_CENTER' since panning should be centered when both these settings are at the center
-        triggerPan = (int16_t) trackStat.pan_cntrl + (int16_t) voiceStat.ppatch_voice->pan - WESS_PAN_CENTER;
-        triggerPan = std::min(triggerPan, (int16_t) WESS_PAN_RIGHT);
-        triggerPan = std::max(triggerPan, (int16_t) WESS_PAN_LEFT);
+        triggerPan = CalcPSXVoicePan(trackStat.pan_cntrl, voiceStat.ppatch_voice->pan);
     }
 
     // Figure out the trigger volume for the note (0-2047)
-    uint32_t triggerVol = voiceVol;
-    triggerVol *= voiceStat.ppatch_voice->volume;
-    triggerVol *= trackStat.volume_cntrl;
-
-    if (trackStat.sound_class == SNDFX_CLASS) {
-        triggerVol *= gWess_master_sfx_volume;
-    } else {
-        triggerVol *= gWess_master_mus_volume;
-    }
-
-    triggerVol >>= 21;
+    const uint8_t masterVol = (trackStat.sound_class == SNDFX_CLASS) ? gWess_master_sfx_volume : gWess_master_mus_volume;
+    const uint32_t triggerVol = CalcPSXVoiceVolume(voiceVol, voiceStat.ppatch_voice->volume, trackStat.volume_cntrl, masterVol);
 
     // Set volume using trigger volume and pan
     if (gWess_pan_status == PAN_OFF) {
@@ -189,8 +174,8 @@ void TriggerPSXVoice(const voice_status& voiceStat, [[maybe_unused]] const uint8
         spuVoiceAttr.volume.left = spuVol;
         spuVoiceAttr.volume.right = spuVol;
     } else {
-        const int16_t spuVolL = (int16_t)(((int32_t) triggerVol * 128 * (128 - triggerPan)) / 128);
-        const int16_t spuVolR = (int16_t)(((int32_t) triggerVol * 128 * (triggerPan + 1  )) / 128);
+        int16_t spuVolL, spuVolR;
+        CalcPSXVoicePanVolume(triggerVol, triggerPan, spuVolL, spuVolR);
 
         if (gWess_pan_status == PAN_ON) {
             spuVoiceAttr.volume.left = spuVolL;
@@ -203,29 +188,7 @@ void TriggerPSXVoice(const voice_status& voiceStat, [[maybe_unused]] const uint8
     }
 
     // Set the note to play and the base note
-    if (trackStat.pitch_cntrl == 0) {
-        // Not doing any pitch shifting
-        spuVoiceAttr.note = (uint16_t) voiceStat.note << 8;
-    } else {
-        if (trackStat.pitch_cntrl >= 1) {
-            // Pitch shifting: up
-            const uint32_t pitchShiftFrac = 32u + trackStat.pitch_cntrl * voiceStat.ppatch_voice->pitchstep_up;
-            const uint32_t pitchShiftNote = pitchShiftFrac >> 13;
-            const uint32_t pitchShiftFine = (pitchShiftFrac & 0x1FFFu) >> 6;
-
-            spuVoiceAttr.note = (uint16_t)((voiceStat.note + pitchShiftNote) << 8);
-            spuVoiceAttr.note |= pitchShiftFine & 0x7Fu;
-        }
-        else {
-            // Pitch shifting: down
-            const uint32_t pitchShiftFrac = 32u - trackStat.pitch_cntrl * voiceStat.ppatch_voice->pitchstep_down;
-            const uint32_t pitchShiftNote = (pitchShiftFrac >> 13) + 1;
-            const uint32_t pitchShiftFine = 128u - ((pitchShiftFrac & 0x1FFFu) >> 6);
-
-            spuVoiceAttr.note = (uint16_t)((voiceStat.note - pitchShiftNote) << 8);
-            spuVoiceAttr.note |= pitchShiftFine & 0x7Fu;
-        }
-    }
+    spuVoiceAttr.note = CalcPSXVoiceNote(voiceStat.note, trackStat.pitch_cntrl, voiceStat.ppatch_voice->pitchstep_up, voiceStat.ppatch_voice->pitchstep_down);
 
     spuVoiceAttr.sample_note = ((uint16_t) voiceStat.ppatch_voice->base_note << 8) | voiceStat.ppatch_voice->base_note_frac;
 
@@ -484,7 +447,7 @@ void PSX_TrkMute(track_status& trackStat) noexcept {
 
         // Begin releasing the voice and figure out how long it will take to fade based on the release rate.
         // The release rate is exponential, hence the shifts here:
-        voiceStat.release_time_ms = MAX_RELEASE_TIME_MS >> (31 - (gWess_drv_muteReleaseRate % 32));
+        voiceStat.release_time_ms = WESS_MAX_RELEASE_TIME_MS >> (31 - (gWess_drv_muteReleaseRate % 32));
         PSX_voicerelease(voiceStat);
 
         #if PSYDOOM_LIMIT_REMOVING
@@ -545,29 +508,7 @@ void PSX_PitchMod(track_status& trackStat) noexcept {
             continue;
 
         // Set the note to play
-        if (trackStat.pitch_cntrl == 0) {
-            // Not doing any pitch shifting
-            spuVoiceAttr.note = (uint16_t) voiceStat.note << 8;
-        } else {
-            if (trackStat.pitch_cntrl >= 1) {
-                // Pitch shifting: up
-                const uint32_t pitchShiftFrac = 32u + trackStat.pitch_cntrl * voiceStat.ppatch_voice->pitchstep_up;
-                const uint32_t pitchShiftNote = pitchShiftFrac >> 13;
-                const uint32_t pitchShiftFine = (pitchShiftFrac & 0x1FFFu) >> 6;
-
-                spuVoiceAttr.note = (uint16_t)((voiceStat.note + pitchShiftNote) << 8);
-                spuVoiceAttr.note |= pitchShiftFine & 0x7Fu;
-            }
-            else {
-                // Pitch shifting: down
-                const uint32_t pitchShiftFrac = 32u - trackStat.pitch_cntrl * voiceStat.ppatch_voice->pitchstep_down;
-                const uint32_t pitchShiftNote = (pitchShiftFrac >> 13) + 1;
-                const uint32_t pitchShiftFine = 128u - ((pitchShiftFrac & 0x1FFFu) >> 6);
-
-                spuVoiceAttr.note = (uint16_t)((voiceStat.note - pitchShiftNote) << 8);
-                spuVoiceAttr.note |= pitchShiftFine & 0x7Fu;
-            }
-        }
+        spuVoiceAttr.note = CalcPSXVoiceNote(voiceStat.note, trackStat.pitch_cntrl, voiceStat.ppatch_voice->pitchstep_up, voiceStat.ppatch_voice->pitchstep_down);
 
         // These are the attributes and voices to update on the SPU
         spuVoiceAttr.attr_mask = SPU_VOICE_NOTE;
@@ -630,24 +571,12 @@ void PSX_VolumeMod(track_status& trackStat) noexcept {
         if (gWess_pan_status == PAN_OFF) {
             currentPan = WESS_PAN_CENTER;
         } else {
-            // Note: deduct 'WESS_PAN_CENTER' since panning should be centered when both these settings are at the center
-            currentPan = (int16_t) trackStat.pan_cntrl + (int16_t) voiceStat.ppatch_voice->pan - WESS_PAN_CENTER;
-            currentPan = std::min(currentPan, (int16_t) WESS_PAN_RIGHT);
-            currentPan = std::max(currentPan, (int16_t) WESS_PAN_LEFT);
+            currentPan = CalcPSXVoicePan(trackStat.pan_cntrl, voiceStat.ppatch_voice->pan);
         }
 
         // Figure out the updated volume level (0-2047)
-        uint32_t updatedVol = (uint32_t) voiceStat.volume;
-        updatedVol *= voiceStat.ppatch_voice->volume;
-        updatedVol *= trackStat.volume_cntrl;
-
-        if (trackStat.sound_class == SNDFX_CLASS) {
-            updatedVol *= gWess_master_sfx_volume;
-        } else {
-            updatedVol *= gWess_master_mus_volume;
-        }
-
-        updatedVol >>= 21;
+        const uint8_t masterVol = (trackStat.sound_class == SNDFX_CLASS) ? gWess_master_sfx_volume : gWess_master_mus_volume;
+        const uint32_t updatedVol = CalcPSXVoiceVolume(voiceStat.volume, voiceStat.ppatch_voice->volume, trackStat.volume_cntrl, masterVol);
 
         // Figure out the left/right volume using the computed volume and pan
         if (gWess_pan_status == PAN_OFF) {
@@ -655,8 +584,8 @@ void PSX_VolumeMod(track_status& trackStat) noexcept {
             spuVoiceAttr.volume.left = spuVol;
             spuVoiceAttr.volume.right = spuVol;
         } else {
-            const int16_t spuVolL = (int16_t)(((int32_t) updatedVol * 128 * (128 - currentPan)) / 128);
-            const int16_t spuVolR = (int16_t)(((int32_t) updatedVol * 128 * (currentPan + 1  )) / 128);
+            int16_t spuVolL, spuVolR;
+            CalcPSXVoicePanVolume(updatedVol, currentPan, spuVolL, spuVolR);
 
             if (gWess_pan_status == PAN_ON) {
                 spuVoiceAttr.volume.left = spuVolL;
@@ -718,26 +647,15 @@ void PSX_PanMod(track_status& trackStat) noexcept {
             continue;
 
         // Figure out the updated pan amount (0-127)
-        int16_t updatedPan = (int16_t) trackStat.pan_cntrl + (int16_t) voiceStat.ppatch_voice->pan - WESS_PAN_CENTER;
-        updatedPan = std::min(updatedPan, (int16_t) WESS_PAN_RIGHT);
-        updatedPan = std::max(updatedPan, (int16_t) WESS_PAN_LEFT);
+        const int16_t updatedPan = CalcPSXVoicePan(trackStat.pan_cntrl, voiceStat.ppatch_voice->pan);
 
         // Figure out the current volume level (0-2047)
-        uint32_t currentVol = (uint32_t) voiceStat.volume;
-        currentVol *= voiceStat.ppatch_voice->volume;
-        currentVol *= trackStat.volume_cntrl;
-
-        if (trackStat.sound_class == SNDFX_CLASS) {
-            currentVol *= gWess_master_sfx_volume;
-        } else {
-            currentVol *= gWess_master_mus_volume;
-        }
-
-        currentVol >>= 21;
+        const uint8_t masterVol = (trackStat.sound_class == SNDFX_CLASS) ? gWess_master_sfx_volume : gWess_master_mus_volume;
+        const uint32_t currentVol = CalcPSXVoiceVolume(voiceStat.volume, voiceStat.ppatch_voice->volume, trackStat.volume_cntrl, masterVol);
 
         // Figure out the left/right volume using the computed volume and pan
-        const int16_t spuVolL = (int16_t)(((int32_t) currentVol * 128 * (128 - updatedPan)) / 128);
-        const int16_t spuVolR = (int16_t)(((int32_t) currentVol * 128 * (updatedPan + 1  )) / 128);
+        int16_t spuVolL, spuVolR;
+        CalcPSXVoicePanVolume(currentVol, updatedPan, spuVolL, spuVolR);
 
         if (gWess_pan_status == PAN_ON) {
             spuVoiceAttr.volume.left = spuVolL;
@@ -815,11 +733,8 @@ void PSX_voiceon(
     voiceStat.ppatch_sample = &patchSample;
     voiceStat.onoff_abstime_ms = *gpWess_drv_cur_abstime_ms;
 
-    // Figure out how long it takes for the voice to fade out.
-    // The low 5 bits affect the exponential falloff, the 6th bit controls how that falloff is scaled.
-    const uint32_t adsr = (patchVoice.adsr2 & 0x20) ? MAX_RELEASE_TIME_MS : MAX_FAST_RELEASE_TIME_MS;
-    const uint32_t adsrShift = 31 - (patchVoice.adsr2 % 32);
-    voiceStat.release_time_ms = adsr >> adsrShift;
+    // Figure out how long it takes for the voice to fade out
+    voiceStat.release_time_ms = CalcPSXVoiceReleaseTimeMs(patchVoice.adsr2);
 
     // Increment voice count stats
     WESS_ASSERT(trackStat.num_active_voices < UINT8_MAX);
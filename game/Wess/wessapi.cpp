@@ -5,6 +5,7 @@
 
 #include "Asserts.h"
 #include "Endian.h"
+#include "PsyDoom/SeqAudioThread.h"
 #include "wessapi_t.h"
 #include "wessseq.h"
 
@@ -1005,6 +1006,20 @@ void wess_seq_trigger(const int32_t seqIdx) noexcept {
 // The sequence is assigned the type number '0'.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_trigger_special(const int32_t seqIdx, const TriggerPlayAttr* const pPlayAttribs) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqTriggerTypeSpecial;
+            cmd.bHasPlayAttribs = (pPlayAttribs != nullptr);
+            cmd.seqIdx = seqIdx;
+            cmd.seqType = 0;
+            cmd.playAttribs = (pPlayAttribs) ? *pPlayAttribs : TriggerPlayAttr{};
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     master_status_structure& mstat = *gpWess_pm_stat;
     wess_seq_structrig(mstat.pmodule->psequences[seqIdx], seqIdx, 0, false, pPlayAttribs);
 }
@@ -1017,6 +1032,12 @@ SequenceStatus wess_seq_status(const int32_t seqIdx) noexcept {
     if (!Is_Seq_Num_Valid(seqIdx))
         return SEQUENCE_INVALID;
 
+    // PsyDoom: if the sequencer is running on the audio thread then lock it while reading the sequence status.
+    // This also executes any deferred commands for the sequence first, so a trigger that has been issued but not yet executed counts.
+    #if PSYDOOM_MODS
+        SeqAudioThread::QueryScope seqQueryScope(seqIdx);
+    #endif
+
     // Try to find the specified sequence number among all the sequences
     master_status_structure& mstat = *gpWess_pm_stat;
     const int32_t maxSeqs = mstat.pmodule->hdr.max_active_sequences;
@@ -1046,6 +1067,17 @@ SequenceStatus wess_seq_status(const int32_t seqIdx) noexcept {
 // Stops the specified sequence number
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_stop(const int32_t seqIdx) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqStop;
+            cmd.seqIdx = seqIdx;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // Don't bother if the sequence number is not valid
     if (!Is_Seq_Num_Valid(seqIdx))
         return;
@@ -1107,6 +1139,16 @@ void wess_seq_stop(const int32_t seqIdx) noexcept {
 // Stops all active sound sequences
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_stopall() noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqStopAll;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // Don't bother if there is no module loaded
     if (!Is_Module_Loaded())
         return;
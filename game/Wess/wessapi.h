@@ -2,6 +2,7 @@
 
 #include "Asserts.h"
 #include "PsyQ/LIBSPU.h"
+#include "wesscalc.h"
 
 #include <cstddef>
 
@@ -24,11 +25,6 @@ struct track_status;
 // Maximum volume level that should be used for voices
 static constexpr uint8_t WESS_MAX_MASTER_VOL = 127;
 
-// Pan levels
-static constexpr uint8_t WESS_PAN_LEFT      = 0;
-static constexpr uint8_t WESS_PAN_CENTER    = 64;
-static constexpr uint8_t WESS_PAN_RIGHT     = 127;
-
 // Maximum reverb depth that should be applied to voices
 static constexpr uint8_t WESS_MAX_REVERB_DEPTH = 127;
 
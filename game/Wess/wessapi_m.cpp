@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------------------------------------------------------------------
 #include "wessapi_m.h"
 
+#include "PsyDoom/SeqAudioThread.h"
 #include "wessapi.h"
 #include "wessseq.h"
 
@@ -25,6 +26,17 @@ uint8_t wess_master_mus_volume_get() noexcept {
 // Set the master volume for sound effects
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_master_sfx_vol_set(const uint8_t vol) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::MasterSfxVolSet;
+            cmd.volume = vol;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     if (Is_Module_Loaded()) {
         gWess_master_sfx_volume = vol;
     }
@@ -34,6 +46,17 @@ void wess_master_sfx_vol_set(const uint8_t vol) noexcept {
 // Set the master music volume
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_master_mus_vol_set(const uint8_t musicVol) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::MasterMusVolSet;
+            cmd.volume = musicVol;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // Don't bother if there is no module loaded
     if (!Is_Module_Loaded())
         return;
@@ -5,6 +5,7 @@
 #include "wessapi_p.h"
 
 #include "psxcmd.h"
+#include "PsyDoom/SeqAudioThread.h"
 #include "wessapi.h"
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -174,6 +175,18 @@ void wess_seq_restart(const int32_t seqIdx) noexcept {
 // If muting completely, the current state for all voices can optionally be recorded to the given state struct for later restoration.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_pauseall(const bool bMute, SavedVoiceList* const pSavedVoices) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqPauseAll;
+            cmd.bMute = bMute;
+            cmd.pSavedVoices = pSavedVoices;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // Don't bother if there is no module loaded
     if (!Is_Module_Loaded())
         return;
@@ -252,6 +265,17 @@ void wess_seq_pauseall(const bool bMute, SavedVoiceList* const pSavedVoices) noe
 // Individual voices can also be restored to their previous states using the saved voice state struct.
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_restartall(SavedVoiceList* const pSavedVoices) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqRestartAll;
+            cmd.pSavedVoices = pSavedVoices;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // Don't bother if there is no module loaded
     if (!Is_Module_Loaded())
         return;
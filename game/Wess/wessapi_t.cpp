@@ -4,6 +4,7 @@
 //------------------------------------------------------------------------------------------------------------------------------------------
 #include "wessapi_t.h"
 
+#include "PsyDoom/SeqAudioThread.h"
 #include "wessapi.h"
 #include "wessarc.h"
 
@@ -126,6 +127,18 @@ void updatetrackstat(track_status& trackStat, const TriggerPlayAttr* const pPlay
 // Trigger the specified sequence number and assign it the given type number
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_trigger_type(const int32_t seqIdx, const uintptr_t seqType) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqTriggerType;
+            cmd.seqIdx = seqIdx;
+            cmd.seqType = seqType;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     master_status_structure& mstat = *gpWess_pm_stat;
     wess_seq_structrig(mstat.pmodule->psequences[seqIdx], seqIdx, seqType, false, nullptr);
 }
@@ -134,6 +147,20 @@ void wess_seq_trigger_type(const int32_t seqIdx, const uintptr_t seqType) noexce
 // Trigger the specified sequence number with custom play attributes and assign it the given type number
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_trigger_type_special(const int32_t seqIdx, const uintptr_t seqType, const TriggerPlayAttr* const pPlayAttribs) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqTriggerTypeSpecial;
+            cmd.bHasPlayAttribs = (pPlayAttribs != nullptr);
+            cmd.seqIdx = seqIdx;
+            cmd.seqType = seqType;
+            cmd.playAttribs = (pPlayAttribs) ? *pPlayAttribs : TriggerPlayAttr{};
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     master_status_structure& mstat = *gpWess_pm_stat;
     wess_seq_structrig(mstat.pmodule->psequences[seqIdx], seqIdx, seqType, false, pPlayAttribs);
 }
@@ -142,6 +169,19 @@ void wess_seq_trigger_type_special(const int32_t seqIdx, const uintptr_t seqType
 // Update sequences of the specified type with the given play attributes
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_update_type_special(const uintptr_t seqType, const TriggerPlayAttr* const pPlayAttribs) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqUpdateTypeSpecial;
+            cmd.bHasPlayAttribs = (pPlayAttribs != nullptr);
+            cmd.seqType = seqType;
+            cmd.playAttribs = (pPlayAttribs) ? *pPlayAttribs : TriggerPlayAttr{};
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // Don't bother if there is no module loaded
     if (!Is_Module_Loaded())
         return;
@@ -207,6 +247,17 @@ void wess_seq_update_type_special(const uintptr_t seqType, const TriggerPlayAttr
 // Stop music sequences with the specified type number
 //------------------------------------------------------------------------------------------------------------------------------------------
 void wess_seq_stoptype(const uintptr_t seqType) noexcept {
+    // PsyDoom: if the sequencer is running on the audio thread then hand this command off to it
+    #if PSYDOOM_MODS
+        if (SeqAudioThread::shouldDeferCmd()) {
+            SeqAudioThread::Cmd cmd = {};
+            cmd.type = SeqAudioThread::CmdType::SeqStopType;
+            cmd.seqType = seqType;
+            SeqAudioThread::deferCmd(cmd);
+            return;
+        }
+    #endif
+
     // If the module is not loaded then there is nothing to do
     if (!Is_Module_Loaded())
         return;
@@ -53,24 +53,6 @@ int16_t GetIntsPerSec() noexcept {
     return 120;
 }
 
-//------------------------------------------------------------------------------------------------------------------------------------------
-// Calculates the number of quarter note per hardware timer interrupt, in 16.16 fixed point format.
-// This is used to determine how fast to pace/advance the sequencer.
-//
-// Params:
-//  intsPerSec      :   How many hardware interrupts happen a second. Approx '120' for PSX DOOM.
-//  partsPerQNote   :   How many parts to subdivide each quarter note into. Affects timing precision.
-//  qnotesPerMin    :   Track tempo in quarter notes per minute. This typically known as 'beats per minute'.
-//------------------------------------------------------------------------------------------------------------------------------------------
-uint32_t CalcPartsPerInt(const int16_t intsPerSec, const int16_t partsPerQNote, const int16_t qnotesPerMin) noexcept {
-    const uint32_t intsPerMin = intsPerSec * 60;                                                // Number of interrupts per minute
-    const uint32_t qnotePerMinFrac = (uint32_t) qnotesPerMin << 16;                             // Number of quarter notes per minute in 16.16 format
-    const uint32_t qnotesPerIntRoundUp = intsPerSec * 30 + 30;                                  // Helps round up the number of quarter notes per interrupt (ceil)
-    const uint32_t qnotesPerIntFrac = (qnotePerMinFrac + qnotesPerIntRoundUp) / intsPerMin;     // Number of quarter notes per interrupt (16.16)
-    const uint32_t partsPerInt = qnotesPerIntFrac * partsPerQNote;                              // Number of quarter note 'parts' per interrupt (16.16)
-    return partsPerInt;
-}
-
 //------------------------------------------------------------------------------------------------------------------------------------------
 // This is the root update/step function for the music and sound sequencer.
 // Originally on the actual PlayStation this would have been triggered via hardware timer interrupts at approximately 121.9284 Hz.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "psxcd.h"
+#include "wesscalc.h"
 
 // Setting ids for sound hardware
 enum SoundHardwareTags : int32_t {
@@ -389,7 +390,6 @@ struct WessDriverFunc {
 extern const WessDriverFunc* const gWess_CmdFuncArr[10];
 
 int16_t GetIntsPerSec() noexcept;
-uint32_t CalcPartsPerInt(const int16_t intsPerSec, const int16_t partsPerQNote, const int16_t qnotesPerMin) noexcept;
 int32_t WessInterruptHandler() noexcept;
 void init_WessTimer() noexcept;
 void exit_WessTimer() noexcept;
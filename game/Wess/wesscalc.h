@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Calculations used by the WESS sequencer and PlayStation sound driver for timing, voice pitch, volume and panning.
+// These have no dependencies on the rest of the game so that they can also be used by tools that emulate the game's sound driver.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Pan levels
+static constexpr uint8_t WESS_PAN_LEFT      = 0;
+static constexpr uint8_t WESS_PAN_CENTER    = 64;
+static constexpr uint8_t WESS_PAN_RIGHT     = 127;
+
+// Release times used by the PlayStation sound driver
+static constexpr uint32_t WESS_MAX_RELEASE_TIME_MS      = 0x10000000;   // Maximum time something can release for (milliseconds)
+static constexpr uint32_t WESS_MAX_FAST_RELEASE_TIME_MS = 0x05DC0000;   // A scaled version of the maximum release time that faster, used by some voices.
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Calculates the number of quarter note per hardware timer interrupt, in 16.16 fixed point format.
+// This is used to determine how fast to pace/advance the sequencer.
+//
+// Params:
+//  intsPerSec      :   How many hardware interrupts happen a second. Approx '120' for PSX DOOM.
+//  partsPerQNote   :   How many parts to subdivide each quarter note into. Affects timing precision.
+//  qnotesPerMin    :   Track tempo in quarter notes per minute. This typically known as 'beats per minute'.
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline uint32_t CalcPartsPerInt(const int16_t intsPerSec, const int16_t partsPerQNote, const int16_t qnotesPerMin) noexcept {
+    const uint32_t intsPerMin = intsPerSec * 60;                                                // Number of interrupts per minute
+    const uint32_t qnotePerMinFrac = (uint32_t) qnotesPerMin << 16;                             // Number of quarter notes per minute in 16.16 format
+    const uint32_t qnotesPerIntRoundUp = intsPerSec * 30 + 30;                                  // Helps round up the number of quarter notes per interrupt (ceil)
+    const uint32_t qnotesPerIntFrac = (qnotePerMinFrac + qnotesPerIntRoundUp) / intsPerMin;     // Number of quarter notes per interrupt (16.16)
+    const uint32_t partsPerInt = qnotesPerIntFrac * partsPerQNote;                              // Number of quarter note 'parts' per interrupt (16.16)
+    return partsPerInt;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the note to set on a PSX hardware voice (in LIBSPU 8.8 format) for a note being played, given the track's pitch bend amount.
+// The pitch step amounts are how many semitones the pitch bend wheel covers when bending up or down, for the patch voice being played.
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline uint16_t CalcPSXVoiceNote(
+    const uint8_t note,
+    const int16_t pitchCntrl,
+    const uint8_t pitchstepUp,
+    const uint8_t pitchstepDown
+) noexcept {
+    if (pitchCntrl == 0) {
+        // Not doing any pitch shifting
+        return (uint16_t) note << 8;
+    }
+
+    if (pitchCntrl >= 1) {
+        // Pitch shifting: up
+        const uint32_t pitchShiftFrac = 32u + pitchCntrl * pitchstepUp;
+        const uint32_t pitchShiftNote = pitchShiftFrac >> 13;
+        const uint32_t pitchShiftFine = (pitchShiftFrac & 0x1FFFu) >> 6;
+        return (uint16_t)(((note + pitchShiftNote) << 8) | (pitchShiftFine & 0x7Fu));
+    } else {
+        // Pitch shifting: down
+        const uint32_t pitchShiftFrac = 32u - pitchCntrl * pitchstepDown;
+        const uint32_t pitchShiftNote = (pitchShiftFrac >> 13) + 1;
+        const uint32_t pitchShiftFine = 128u - ((pitchShiftFrac & 0x1FFFu) >> 6);
+        return (uint16_t)(((note - pitchShiftNote) << 8) | (pitchShiftFine & 0x7Fu));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the pan (0-127) for a PSX hardware voice from the track and patch voice pan settings, when panning is enabled
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline int16_t CalcPSXVoicePan(const uint8_t trackPan, const uint8_t patchVoicePan) noexcept {
+    // Note: deduct 'WESS_PAN_CENTER' since panning should be centered when both these settings are at the center
+    const int16_t pan = (int16_t) trackPan + (int16_t) patchVoicePan - WESS_PAN_CENTER;
+    return std::clamp(pan, (int16_t) WESS_PAN_LEFT, (int16_t) WESS_PAN_RIGHT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the volume level (0-2047) for a PSX hardware voice from the note, patch voice, track and master volumes (all 0-127)
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline uint32_t CalcPSXVoiceVolume(
+    const uint8_t noteVol,
+    const uint8_t patchVoiceVol,
+    const uint8_t trackVol,
+    const uint8_t masterVol
+) noexcept {
+    uint32_t vol = noteVol;
+    vol *= patchVoiceVol;
+    vol *= trackVol;
+    vol *= masterVol;
+    return vol >> 21;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes the left and right SPU volume for a PSX hardware voice with the given volume level and pan, when panning is enabled
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline void CalcPSXVoicePanVolume(const uint32_t vol, const int16_t pan, int16_t& volL, int16_t& volR) noexcept {
+    volL = (int16_t)(((int32_t) vol * 128 * (128 - pan)) / 128);
+    volR = (int16_t)(((int32_t) vol * 128 * (pan + 1  )) / 128);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Computes how long it takes for a PSX hardware voice to fade out once released, given the patch voice's 'adsr2' envelope settings.
+// The low 5 bits affect the exponential falloff, the 6th bit controls how that falloff is scaled.
+//------------------------------------------------------------------------------------------------------------------------------------------
+inline uint32_t CalcPSXVoiceReleaseTimeMs(const uint16_t adsr2) noexcept {
+    const uint32_t adsr = (adsr2 & 0x20) ? WESS_MAX_RELEASE_TIME_MS : WESS_MAX_FAST_RELEASE_TIME_MS;
+    const uint32_t adsrShift = 31 - (adsr2 % 32);
+    return adsr >> adsrShift;
+}
@@ -5,6 +5,8 @@
 #include "wessseq.h"
 
 #include "Macros.h"
+#include "PsyDoom/Profiler.h"
+#include "PsyDoom/SeqAudioThread.h"
 #include "wessapi.h"
 
 #include <algorithm>
@@ -814,17 +816,33 @@ void Eng_NullEvent([[maybe_unused]] track_status& trackStat) noexcept {
 // This is what drives sequencer timing and executes sequencer commands.
 // Originally this was driven via interrupts coming from the PlayStation's hardware timers.
 //------------------------------------------------------------------------------------------------------------------------------------------
+#if PSYDOOM_MODS
 void SeqEngine() noexcept {
+    PROFILE_ZONE("SeqEngine");
+
     // PsyDoom: this can now be invoked at any time rather than at fixed 120 Hz intervals, so the delta time which can pass is variable.
     // Restrict the maximum number of time that can be simulated however to 0.5 seconds.
     // Compute the fractional number of 120Hz ticks/interrupts elapsed here:
-    #if PSYDOOM_MODS
-        const timepoint_t now = std::chrono::high_resolution_clock::now();
-        const double deltaTime = std::clamp(std::chrono::duration<double>(now - gLastSequencerUpdateTime).count(), 0.0, 0.5);
-        const double deltaTime120HzTicks = std::min(deltaTime * 120.0, 8.0);
-        gLastSequencerUpdateTime = now;
-    #endif
+    const timepoint_t now = std::chrono::high_resolution_clock::now();
+    const double deltaTime = std::clamp(std::chrono::duration<double>(now - gLastSequencerUpdateTime).count(), 0.0, 0.5);
+    const double deltaTime120HzTicks = std::min(deltaTime * 120.0, 8.0);
+    gLastSequencerUpdateTime = now;
+
+    SeqEngine_Advance(deltaTime120HzTicks);
+    SeqAudioThread::recordGameThreadSeqUpdate(deltaTime120HzTicks);
+}
+#endif
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// PsyDoom: advances the sequencer by the specified (possibly fractional) number of 120 Hz ticks.
+// This is called by 'SeqEngine' with a variable delta time on the game thread, or with exactly '1.0' tick by the audio thread when the
+// sequencer is driven at sample granularity from the audio render loop.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#if PSYDOOM_MODS
+void SeqEngine_Advance(const double deltaTime120HzTicks) noexcept {
+#else
+void SeqEngine() noexcept {
+#endif
     // Some helper variables for the loop
     master_status_structure& mstat = *gpWess_eng_mstat;
     track_status* const pTrackStats = gpWess_eng_trackStats;
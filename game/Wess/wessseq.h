@@ -61,3 +61,7 @@ void Eng_TrkRet(track_status& trackStat) noexcept;
 void Eng_TrkEnd(track_status& trackStat) noexcept;
 void Eng_NullEvent(track_status& trackStat) noexcept;
 void SeqEngine() noexcept;
+
+#if PSYDOOM_MODS
+    void SeqEngine_Advance(const double deltaTime120HzTicks) noexcept;
+#endif
@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// WmdRenderTool: stand-ins for the parts of PsyDoom which the game's sound code (WESS and LIBSPU) calls into, but which are not compiled
+// into this tool. This covers the emulated PlayStation, CD file access, the LCD cache, timer events and the audio thread sequencer.
+// Each stand-in does what the real code does when the sequencer is driven on the calling thread, and CD files are served from memory.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "GameStubs.h"
+
+#include "Doom/Game/p_setup.h"
+#include "PsyDoom/LcdCache.h"
+#include "PsyDoom/ProgArgs.h"
+#include "PsyDoom/PsxVm.h"
+#include "PsyDoom/SeqAudioThread.h"
+#include "PsyQ/LIBAPI.h"
+#include "SmallString.h"
+#include "Spu.h"
+#include "Wess/psxcd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// A file which can be opened through the 'psxcd' functions or read through the LCD cache
+struct MemFile {
+    CdFileId                fileId;
+    std::vector<uint8_t>    data;
+};
+
+// An open file slot for the 'psxcd' functions
+struct OpenFileSlot {
+    int32_t     memFileIdx;     // Which file is open in this slot, or '-1' if the slot is free
+    int32_t     offset;         // Current IO offset within the file
+};
+
+static constexpr int32_t MAX_OPEN_FILES = 4;
+
+static std::vector<MemFile>     gMemFiles;
+static OpenFileSlot             gOpenFileSlots[MAX_OPEN_FILES] = { { -1, 0 }, { -1, 0 }, { -1, 0 }, { -1, 0 } };
+static PsxCd_File               gPsxCdFile;     // Returned by 'psxcd_open': the caller copies it
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Globals normally defined by modules that are not part of the tool
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+// From 'p_setup.cpp': warnings about problems loading sounds are written here
+char gLevelStartupWarning[64];
+
+BEGIN_NAMESPACE(ProgArgs)
+    bool gbHeadlessMode = false;
+END_NAMESPACE(ProgArgs)
+
+BEGIN_NAMESPACE(PsxVm)
+    Spu::Core gSpu = {};
+
+    // Only one thread ever uses the SPU in this tool
+    void lockSpu() noexcept {}
+    void unlockSpu() noexcept {}
+END_NAMESPACE(PsxVm)
+
+BEGIN_NAMESPACE(GameStubs)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Makes the given data available as a file which can be opened via 'psxcd_open' or read via 'LcdCache::getFileData'
+//------------------------------------------------------------------------------------------------------------------------------------------
+void addFile(const CdFileId fileId, const std::byte* const pData, const size_t size) noexcept {
+    MemFile& file = gMemFiles.emplace_back();
+    file.fileId = fileId;
+    file.data.resize(size);
+
+    if (size > 0) {
+        std::memcpy(file.data.data(), pData, size);
+    }
+}
+
+END_NAMESPACE(GameStubs)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the index of the file with the given id, or '-1' if not found
+//------------------------------------------------------------------------------------------------------------------------------------------
+static int32_t findMemFile(const CdFileId fileId) noexcept {
+    for (int32_t i = 0; i < (int32_t) gMemFiles.size(); ++i) {
+        if (gMemFiles[i].fileId == fileId)
+            return i;
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Returns the open file slot for the given 'psxcd' file, or 'nullptr' if the file is not open
+//------------------------------------------------------------------------------------------------------------------------------------------
+static OpenFileSlot* getOpenFileSlot(const PsxCd_File& file) noexcept {
+    if ((file.fileHandle <= 0) || (file.fileHandle > MAX_OPEN_FILES))
+        return nullptr;
+
+    OpenFileSlot& slot = gOpenFileSlots[file.fileHandle - 1];
+    return (slot.memFileIdx >= 0) ? &slot : nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// CD file access: files are read from memory rather than from a game disc
+//------------------------------------------------------------------------------------------------------------------------------------------
+PsxCd_File* psxcd_open(const CdFileId discFile) noexcept {
+    const int32_t memFileIdx = findMemFile(discFile);
+
+    if (memFileIdx < 0)
+        return nullptr;
+
+    for (int32_t slotIdx = 0; slotIdx < MAX_OPEN_FILES; ++slotIdx) {
+        OpenFileSlot& slot = gOpenFileSlots[slotIdx];
+
+        if (slot.memFileIdx >= 0)
+            continue;
+
+        slot.memFileIdx = memFileIdx;
+        slot.offset = 0;
+
+        gPsxCdFile = {};
+        gPsxCdFile.size = (int32_t) gMemFiles[memFileIdx].data.size();
+        gPsxCdFile.fileHandle = slotIdx + 1;
+        return &gPsxCdFile;
+    }
+
+    return nullptr;
+}
+
+int32_t psxcd_read(void* const pDest, int32_t numBytes, PsxCd_File& file) noexcept {
+    OpenFileSlot* const pSlot = getOpenFileSlot(file);
+
+    if ((!pSlot) || (numBytes < 0) || (pSlot->offset + numBytes > file.size))
+        return -1;
+
+    std::memcpy(pDest, gMemFiles[pSlot->memFileIdx].data.data() + pSlot->offset, (size_t) numBytes);
+    pSlot->offset += numBytes;
+    return numBytes;
+}
+
+int32_t psxcd_seek(PsxCd_File& file, int32_t offset, const PsxCd_SeekMode mode) noexcept {
+    OpenFileSlot* const pSlot = getOpenFileSlot(file);
+
+    if (!pSlot)
+        return -1;
+
+    int32_t newOffset = {};
+
+    if (mode == PsxCd_SeekMode::SET) {
+        newOffset = offset;
+    } else if (mode == PsxCd_SeekMode::CUR) {
+        newOffset = pSlot->offset + offset;
+    } else if (mode == PsxCd_SeekMode::END) {
+        newOffset = file.size - offset;
+    } else {
+        return -1;  // Bad seek mode!
+    }
+
+    if ((newOffset < 0) || (newOffset > file.size))
+        return -1;
+
+    pSlot->offset = newOffset;
+    return 0;
+}
+
+int32_t psxcd_tell(const PsxCd_File& file) noexcept {
+    const OpenFileSlot* const pSlot = getOpenFileSlot(file);
+    return (pSlot) ? pSlot->offset : -1;
+}
+
+void psxcd_close(PsxCd_File& file) noexcept {
+    OpenFileSlot* const pSlot = getOpenFileSlot(file);
+
+    if (pSlot) {
+        pSlot->memFileIdx = -1;
+        pSlot->offset = 0;
+    }
+
+    file = {};
+}
+
+BEGIN_NAMESPACE(LcdCache)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// LCD files are always in memory
+//------------------------------------------------------------------------------------------------------------------------------------------
+const std::vector<uint8_t>* getFileData(const CdFileId fileId) noexcept {
+    const int32_t memFileIdx = findMemFile(fileId);
+    return (memFileIdx >= 0) ? &gMemFiles[memFileIdx].data : nullptr;
+}
+
+END_NAMESPACE(LcdCache)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Timer events: the tool calls 'WessInterruptHandler' itself at exact 120 Hz intervals in the output, so these do nothing
+//------------------------------------------------------------------------------------------------------------------------------------------
+void LIBAPI_EnterCriticalSection() noexcept {}
+void LIBAPI_ExitCriticalSection() noexcept {}
+
+int32_t LIBAPI_OpenEvent(
+    [[maybe_unused]] const int32_t cause,
+    [[maybe_unused]] const int32_t type,
+    [[maybe_unused]] const int32_t mode,
+    [[maybe_unused]] int32_t (* const pHandler)()
+) noexcept {
+    return 1;
+}
+
+bool LIBAPI_EnableEvent([[maybe_unused]] const int32_t event) noexcept { return true; }
+bool LIBAPI_DisableEvent([[maybe_unused]] const int32_t event) noexcept { return true; }
+bool LIBAPI_CloseEvent([[maybe_unused]] const int32_t event) noexcept { return true; }
+
+bool LIBAPI_SetRCnt(
+    [[maybe_unused]] const int32_t cntType,
+    [[maybe_unused]] const uint16_t target,
+    [[maybe_unused]] const int32_t mode
+) noexcept {
+    return true;
+}
+
+bool LIBAPI_StartRCnt([[maybe_unused]] const int32_t cntType) noexcept { return true; }
+
+BEGIN_NAMESPACE(SeqAudioThread)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Audio thread sequencer: the sequencer always runs on the thread issuing commands in this tool, so nothing is deferred
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool shouldDeferCmd() noexcept { return false; }
+void deferCmd([[maybe_unused]] const Cmd& cmd) noexcept {}
+void recordGameThreadSeqUpdate([[maybe_unused]] const double num120HzTicks) noexcept {}
+
+QueryScope::QueryScope([[maybe_unused]] const int32_t seqIdx) noexcept : mbLockedSpu(false) {}
+QueryScope::~QueryScope() noexcept {}
+
+END_NAMESPACE(SeqAudioThread)
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstddef>
+
+struct String16;
+typedef String16 CdFileId;
+
+BEGIN_NAMESPACE(GameStubs)
+
+void addFile(const CdFileId fileId, const std::byte* const pData, const size_t size) noexcept;
+
+END_NAMESPACE(GameStubs)
@@ -0,0 +1,305 @@
+#include "SeqRenderer.h"
+
+#include "EngineLimits.h"
+#include "GameStubs.h"
+#include "Doom/Game/p_setup.h"
+#include "PsyDoom/AudioCompressor.h"
+#include "PsyDoom/PsxVm.h"
+#include "PsyQ/LIBSPU.h"
+#include "SmallString.h"
+#include "Spu.h"
+#include "Wess/lcdload.h"
+#include "Wess/psxcmd.h"
+#include "Wess/psxspu.h"
+#include "Wess/seqload.h"
+#include "Wess/wessapi.h"
+#include "Wess/wessapi_m.h"
+#include "Wess/wessarc.h"
+#include "Wess/wessseq.h"
+
+#include <algorithm>
+#include <memory>
+
+BEGIN_NAMESPACE(AudioTools)
+
+// How many times a second the sequencer is ticked: the rate of the original PlayStation timer interrupts
+static constexpr uint32_t SEQ_TICKS_PER_SEC = 120;
+
+// When reverb is enabled, how many samples of silent output signal that the reverb has died away.
+// This is a generous amount so that silent gaps between echoes (for the 'echo' and 'delay' modes) are not mistaken for the end.
+static constexpr uint32_t REVERB_SILENCE_SAMPLES = RENDER_SAMPLE_RATE;
+
+// SPU RAM size and voice count: the same as PsyDoom uses by default
+#if PSYDOOM_LIMIT_REMOVING
+    static constexpr uint32_t SPU_RAM_SIZE = 16 * 1024 * 1024;
+    static constexpr uint32_t SPU_VOICE_COUNT = 64;
+#else
+    static constexpr uint32_t SPU_RAM_SIZE = 512 * 1024;
+    static constexpr uint32_t SPU_VOICE_COUNT = 24;
+#endif
+
+// The file names that the module and LCD files are made available to the game's sound code as
+static constexpr CdFileId WMD_FILE_ID = "DOOMSND.WMD";
+
+// Sound settings for the WESS PSX sound driver: the same as PsyDoom uses
+static const int32_t gPSXSettings[SNDHW_TAG_MAX * 2] = {
+    SNDHW_TAG_DRIVER_ID,        PSX_ID,
+    SNDHW_TAG_SOUND_EFFECTS,    1,
+    SNDHW_TAG_MUSIC,            1,
+    SNDHW_TAG_DRUMS,            1,
+    SNDHW_TAG_END,              0
+};
+
+static const int32_t* gSettingsLists[2] = {
+    gPSXSettings,
+    nullptr
+};
+
+// Set once a sequence has been rendered: the sound engine can't be reset so only one render is possible per process
+static bool gbDidRender = false;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tells if any SPU voice is still producing sound.
+// Note: an exponential release can stall at an envelope level of '0' without ever switching the voice off, so treat that case as silent.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool areAnySpuVoicesPlaying(const Spu::Core& spu) noexcept {
+    for (uint32_t i = 0; i < spu.numVoices; ++i) {
+        const Spu::Voice& voice = spu.pVoices[i];
+
+        if (voice.envPhase == Spu::EnvPhase::Off)
+            continue;
+
+        if ((voice.envPhase == Spu::EnvPhase::Release) && (voice.envLevel == 0))
+            continue;
+
+        return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Tracks how many times each track of the playing sequence has jumped backwards in its command stream (looped).
+// Jumps made while inside a subroutine (track location stack not empty) don't count.
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct LoopCounter {
+    std::vector<const uint8_t*>     prevCmdPtrs;        // Where each track status's command stream was at, or 'nullptr' if inactive
+    std::vector<uint32_t>           trackLoops;         // How many times each track status has looped
+    uint32_t                        maxLoops;           // Most loops done by any track so far
+
+    void update(const master_status_structure& mstat) noexcept {
+        const uint32_t numTrackStats = mstat.pmodule->hdr.max_active_tracks;
+        prevCmdPtrs.resize(numTrackStats);
+        trackLoops.resize(numTrackStats);
+
+        for (uint32_t i = 0; i < numTrackStats; ++i) {
+            const track_status& trackStat = mstat.ptrack_stats[i];
+            const uint8_t*& pPrevCmd = prevCmdPtrs[i];
+
+            if (!trackStat.active) {
+                pPrevCmd = nullptr;
+                continue;
+            }
+
+            const bool bInSubroutine = (trackStat.ploc_stack_cur != trackStat.ploc_stack);
+
+            if (pPrevCmd && (trackStat.pcur_cmd < pPrevCmd) && (!bInSubroutine)) {
+                trackLoops[i]++;
+                maxLoops = std::max(maxLoops, trackLoops[i]);
+            }
+
+            pPrevCmd = trackStat.pcur_cmd;
+        }
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Loads the module and samples and sets up the sound engine and SPU the same way that PsyDoom does when starting up and loading a map.
+// Returns 'false' on failure.
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool initSoundEngine(
+    const std::vector<std::byte>& wmdFileData,
+    const std::vector<std::vector<std::byte>>& lcdFilesData,
+    const uint32_t seqIdx,
+    const SeqRenderSettings& settings,
+    std::unique_ptr<uint8_t[]>& wmdMemOut,
+    std::unique_ptr<uint8_t[]>& seqMemOut,
+    std::string& errorMsgOut
+) noexcept {
+    // Make the files available to the game's sound code
+    GameStubs::addFile(WMD_FILE_ID, wmdFileData.data(), wmdFileData.size());
+
+    for (size_t i = 0; i < lcdFilesData.size(); ++i) {
+        const std::string lcdFileName = "LCD" + std::to_string(i) + ".LCD";
+        GameStubs::addFile(CdFileId(lcdFileName.c_str()), lcdFilesData[i].data(), lcdFilesData[i].size());
+    }
+
+    // Initialize the SPU and the sound engine, and load the module.
+    // This follows what 'PsxVm::init' and 'PsxSoundInit' in the game do.
+    Spu::initCore(PsxVm::gSpu, SPU_RAM_SIZE, SPU_VOICE_COUNT);
+
+    wess_init();
+    wess_set_mute_release(256);
+
+    const uint32_t wmdMemSize = std::max<uint32_t>(WMD_MIN_MEM_SIZE, (uint32_t) wmdFileData.size() * 2);
+    wmdMemOut.reset(new uint8_t[wmdMemSize]);
+
+    if (!wess_load_module(wmdFileData.data(), wmdMemOut.get(), (int32_t) wmdMemSize, gSettingsLists)) {
+        errorMsgOut = "Failed to load the module!";
+        return false;
+    }
+
+    master_status_structure& mstat = *wess_get_master_status();
+    wess_dig_lcd_loader_init(&mstat);
+    wess_seq_loader_init(&mstat, WMD_FILE_ID, true);
+
+    // Load the sequence to render
+    if (!Is_Seq_Seq_Num_Valid((int32_t) seqIdx)) {
+        errorMsgOut = "Invalid sequence index ";
+        errorMsgOut += std::to_string(seqIdx);
+        return false;
+    }
+
+    const int32_t seqSize = wess_seq_sizeof((int32_t) seqIdx);
+    seqMemOut.reset(new uint8_t[std::max(seqSize, 1)]);
+
+    if ((seqSize > 0) && (wess_seq_load((int32_t) seqIdx, seqMemOut.get()) <= 0)) {
+        errorMsgOut = "Failed to load the sequence!";
+        return false;
+    }
+
+    // Set the master volumes and setup reverb like the game does for each map, before uploading the samples.
+    // Note: enabling reverb reserves a work area at the end of SPU RAM, which reduces the amount available for samples.
+    wess_master_sfx_vol_set(settings.masterSfxVol);
+    wess_master_mus_vol_set(settings.masterMusVol);
+    psxspu_init_reverb(
+        (SpuReverbMode) settings.reverbMode,
+        settings.reverbDepth,
+        settings.reverbDepth,
+        settings.reverbDelay,
+        settings.reverbFeedback
+    );
+
+    // Upload the samples from all of the LCD files, one after the other.
+    // If a sample is in more than one LCD file then the first one is used.
+    uint32_t destSpuAddr = SPU_RAM_APP_BASE;
+    gLevelStartupWarning[0] = 0;
+
+    for (size_t i = 0; i < lcdFilesData.size(); ++i) {
+        const std::string lcdFileName = "LCD" + std::to_string(i) + ".LCD";
+        destSpuAddr += wess_dig_lcd_load(CdFileId(lcdFileName.c_str()), destSpuAddr, nullptr, false);
+
+        if (gLevelStartupWarning[0]) {
+            errorMsgOut = "Failed to load LCD file " + std::to_string(i + 1) + ": " + gLevelStartupWarning;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Render the specified sequence to 16-bit interleaved stereo samples at 44,100 Hz.
+// The module and LCD files are given as the contents of .WMD and .LCD files.
+// This can only be called once per process, since the game's sound engine state can't be reset.
+//------------------------------------------------------------------------------------------------------------------------------------------
+bool renderSequence(
+    const std::vector<std::byte>& wmdFileData,
+    const std::vector<std::vector<std::byte>>& lcdFilesData,
+    const uint32_t seqIdx,
+    const SeqRenderSettings& settings,
+    std::vector<int16_t>& samplesOut,
+    std::string& errorMsgOut
+) noexcept {
+    samplesOut.clear();
+
+    if (gbDidRender) {
+        errorMsgOut = "Only one sequence can be rendered per process!";
+        return false;
+    }
+
+    gbDidRender = true;
+
+    // Setup the sound engine and start the sequence playing
+    std::unique_ptr<uint8_t[]> wmdMem;
+    std::unique_ptr<uint8_t[]> seqMem;
+
+    if (!initSoundEngine(wmdFileData, lcdFilesData, seqIdx, settings, wmdMem, seqMem, errorMsgOut))
+        return false;
+
+    wess_seq_trigger((int32_t) seqIdx);
+
+    #if SIMPLE_SPU_FLOAT_SPU
+        AudioCompressor::State audioCompState = {};
+        AudioCompressor::initWithGameSettings(audioCompState);
+    #endif
+
+    // Render until the sequence is done and all voices have faded out, or until limits are reached.
+    // The sequencer is ticked at 120 Hz, at sample accurate intervals in the output stream.
+    samplesOut.reserve((size_t) RENDER_SAMPLE_RATE * 2 * 30);
+
+    const master_status_structure& mstat = *wess_get_master_status();
+    const uint32_t maxTotalSamples = settings.maxSamples + settings.maxTailSamples;
+    uint32_t tickAccum = 0;
+    uint32_t numSilentSamples = 0;
+    bool bSeqStopped = false;
+    LoopCounter loopCounter = {};
+
+    for (uint32_t sampleIdx = 0; sampleIdx < maxTotalSamples; ++sampleIdx) {
+        tickAccum += SEQ_TICKS_PER_SEC;
+
+        if (tickAccum >= RENDER_SAMPLE_RATE) {
+            tickAccum -= RENDER_SAMPLE_RATE;
+            WessInterruptHandler();
+
+            if (gbWess_SeqOn) {
+                SeqEngine_Advance(1.0);
+            }
+
+            // Stop the sequence if it has looped enough or the length limit is reached
+            if (!bSeqStopped) {
+                loopCounter.update(mstat);
+                const bool bLoopedEnough = ((settings.maxLoops > 0) && (loopCounter.maxLoops >= settings.maxLoops));
+
+                if (bLoopedEnough || (sampleIdx >= settings.maxSamples)) {
+                    wess_seq_stop((int32_t) seqIdx);
+                    bSeqStopped = true;
+                }
+            }
+
+            // All done when there is nothing more to play, all voices have faded out and any reverb has died away
+            const bool bReverbDone = ((settings.reverbMode == SPU_REV_MODE_OFF) || (numSilentSamples >= REVERB_SILENCE_SAMPLES));
+
+            if ((mstat.num_active_tracks == 0) && (!areAnySpuVoicesPlaying(PsxVm::gSpu)) && bReverbDone)
+                break;
+        }
+
+        // Generate the sample and apply the same processing as the game does to it
+        const Spu::StereoSample sample = Spu::stepCore(PsxVm::gSpu);
+
+        #if SIMPLE_SPU_FLOAT_SPU
+            float sampleL = sample.left;
+            float sampleR = sample.right;
+            AudioCompressor::compress(audioCompState, sampleL, sampleR);
+
+            const int16_t outSampleL = Spu::toInt16Sample(sampleL);
+            const int16_t outSampleR = Spu::toInt16Sample(sampleR);
+        #else
+            const int16_t outSampleL = sample.left;
+            const int16_t outSampleR = sample.right;
+        #endif
+
+        samplesOut.push_back(outSampleL);
+        samplesOut.push_back(outSampleR);
+        numSilentSamples = ((outSampleL == 0) && (outSampleR == 0)) ? numSilentSamples + 1 : 0;
+    }
+
+    // Don't keep the silence that was rendered while waiting for reverb to die away
+    if (settings.reverbMode != SPU_REV_MODE_OFF) {
+        samplesOut.resize(samplesOut.size() - (size_t) numSilentSamples * 2);
+    }
+
+    return true;
+}
+
+END_NAMESPACE(AudioTools)
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Headless sequence renderer:
+//      Renders a sequence by running PsyDoom's own WESS sound driver and LIBSPU code (compiled into this tool from the game's sources)
+//      against the 'SimpleSpu' core, driving the sequencer at 120 Hz on exact sample boundaries like the game's audio thread does.
+//      The same audio compression that PsyDoom applies to its output is applied to the rendered audio.
+//
+//      The game's sound code keeps all of its state in globals, so only one sequence can be rendered per process.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+BEGIN_NAMESPACE(AudioTools)
+
+// Sample rate of all rendered audio: this is the native rate of the PlayStation SPU
+static constexpr uint32_t RENDER_SAMPLE_RATE = 44100;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Settings controlling how a sequence is rendered
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct SeqRenderSettings {
+    uint32_t    maxLoops;           // Stop the sequence after any track jumps backwards this many times (music loop count): '0' means no limit
+    uint32_t    maxSamples;         // Stop the sequence after this many stereo samples have been rendered
+    uint32_t    maxTailSamples;     // After stopping the sequence, how many more samples to render at most while voices fade out
+    uint8_t     masterSfxVol;       // Master volume for sound effect tracks (0-127)
+    uint8_t     masterMusVol;       // Master volume for music tracks (0-127)
+    int32_t     reverbMode;         // LIBSPU reverb mode (0-9) as for 'ReverbMode' in MAPINFO: '0' means no reverb
+    int16_t     reverbDepth;        // Reverb depth for both the left and right channels
+    int32_t     reverbDelay;        // Reverb delay: only used by the 'echo' and 'delay' reverb modes
+    int32_t     reverbFeedback;     // Reverb feedback: only used by the 'echo' and 'delay' reverb modes
+};
+
+bool renderSequence(
+    const std::vector<std::byte>& wmdFileData,
+    const std::vector<std::vector<std::byte>>& lcdFilesData,
+    const uint32_t seqIdx,
+    const SeqRenderSettings& settings,
+    std::vector<int16_t>& samplesOut,
+    std::string& errorMsgOut
+) noexcept;
+
+END_NAMESPACE(AudioTools)
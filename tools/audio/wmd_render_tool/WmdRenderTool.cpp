@@ -0,0 +1,497 @@
+//------------------------------------------------------------------------------------------------------------------------------------------
+// WmdRenderTool:
+//      Renders sequences (music and sounds) in a module file (.WMD file) to .wav files, using the samples from one or more .LCD files.
+//      Rendering is done headlessly and as fast as possible by running PsyDoom's own sound driver code against the 'SimpleSpu' core.
+//      The game's sound code keeps its state in globals, so each sequence is rendered by a separate process: when multiple sequences are
+//      requested the tool re-launches itself once per sequence, running several of these child processes in parallel.
+//------------------------------------------------------------------------------------------------------------------------------------------
+#include "ByteVecOutputStream.h"
+#include "FileUtils.h"
+#include "Module.h"
+#include "ModuleFileUtils.h"
+#include "SeqRenderer.h"
+#include "WavUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+    #include <sys/wait.h>
+#endif
+
+using namespace AudioTools;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Help/usage printing
+//------------------------------------------------------------------------------------------------------------------------------------------
+static const char* const HELP_STR =
+R"(Usage: WmdRenderTool <INPUT JSON OR WMD FILE PATH> <OUTPUT DIRECTORY> [OPTIONS...]
+
+Renders sequences in the given module to 16-bit stereo .wav files at 44,100 Hz, named 'SEQ_<INDEX>.wav'.
+Rendering runs PsyDoom's own WESS sound driver and LIBSPU code, with the same SPU emulation and audio compression as the game.
+Rendering happens faster than realtime and sequences are rendered in parallel, one process per sequence.
+
+Options:
+    -lcd <LCD FILE PATH>
+        Load sound samples from the given .LCD file. Can be specified multiple times: if a sample is in multiple .LCD
+        files then the first one specified is used. At least one .LCD file is required.
+        Note: the original game splits samples between 'DOOMSFX.LCD' and the music and map .LCD files.
+
+    -seq <SEQUENCE INDEX>
+        Render the given sequence. Can be specified multiple times. If not specified then all sequences are rendered.
+
+    -threads <COUNT>
+        How many sequences to render at once. Defaults to the number of hardware threads.
+
+    -loops <COUNT>
+        Stop looping sequences (music) after they loop this many times. Defaults to '1'. Specify '0' for no limit.
+
+    -max-seconds <SECONDS>
+        Stop sequences after this many seconds. Defaults to '600'.
+
+    -reverb-mode <MODE>
+        LIBSPU reverb mode to use, from '0' (off) to '9'. Same as 'ReverbMode' in MAPINFO. Defaults to '0'.
+
+    -reverb-depth <DEPTH>
+        Reverb depth to use for both channels. Same as 'ReverbDepth' in MAPINFO. Defaults to '0'.
+
+    -reverb-delay <DELAY>
+    -reverb-feedback <FEEDBACK>
+        Reverb delay and feedback, for the 'echo' and 'delay' reverb modes. Same as in MAPINFO. Both default to '0'.
+
+    -hash
+        Print a 64-bit FNV-1a hash of the rendered audio samples for each sequence.
+        Useful for checking whether changes to the SPU emulation or sound driver alter the output.
+
+    -no-wav
+        Don't write any .wav files; useful in combination with '-hash'. The output directory must still be specified.
+
+Example:
+    WmdRenderTool DOOMSND.WMD OUT -lcd DOOMSFX.LCD -lcd MUSLEV1.LCD -seq 90 -reverb-mode 5 -reverb-depth 10000 -hash
+)";
+
+static void printHelp() noexcept {
+    std::printf("%s\n", HELP_STR);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Options parsed from the command line
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct RenderToolArgs {
+    const char*                 programPath;
+    const char*                 moduleFilePath;
+    const char*                 outputDirPath;
+    std::vector<const char*>    lcdFilePaths;
+    std::vector<uint32_t>       seqIndexes;
+    uint32_t                    numThreads;
+    uint32_t                    maxLoops;
+    uint32_t                    maxSeconds;
+    int32_t                     reverbMode;
+    int32_t                     reverbDepth;
+    int32_t                     reverbDelay;
+    int32_t                     reverbFeedback;
+    bool                        bPrintHash;
+    bool                        bWriteWav;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// The result of rendering a single sequence in a child process
+//------------------------------------------------------------------------------------------------------------------------------------------
+struct RenderJobResult {
+    bool            bSuccess;
+    std::string     output;     // Everything that the child process printed
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Parse an integer command line argument in the given range, returning 'false' on failure
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool parseIntArg(const char* const str, const int64_t minValue, const int64_t maxValue, int64_t& valueOut) noexcept {
+    try {
+        size_t numCharsParsed = 0;
+        const int64_t value = std::stoll(str, &numCharsParsed);
+
+        if ((numCharsParsed != std::strlen(str)) || (value < minValue) || (value > maxValue))
+            return false;
+
+        valueOut = value;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Parse the program's command line arguments, returning 'false' on failure
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool parseArgs(const int argc, const char* const argv[], RenderToolArgs& args) noexcept {
+    if (argc < 3)
+        return false;
+
+    args.programPath = argv[0];
+    args.moduleFilePath = argv[1];
+    args.outputDirPath = argv[2];
+    args.numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    args.maxLoops = 1;
+    args.maxSeconds = 600;
+    args.bPrintHash = false;
+    args.bWriteWav = true;
+
+    for (int argIdx = 3; argIdx < argc; ++argIdx) {
+        const char* const arg = argv[argIdx];
+        const char* const nextArg = (argIdx + 1 < argc) ? argv[argIdx + 1] : nullptr;
+
+        if (std::strcmp(arg, "-hash") == 0) {
+            args.bPrintHash = true;
+        }
+        else if (std::strcmp(arg, "-no-wav") == 0) {
+            args.bWriteWav = false;
+        }
+        else if (nextArg) {
+            int64_t value = {};
+            argIdx++;
+
+            if (std::strcmp(arg, "-lcd") == 0) {
+                args.lcdFilePaths.push_back(nextArg);
+            }
+            else if (std::strcmp(arg, "-seq") == 0) {
+                if (!parseIntArg(nextArg, 0, UINT8_MAX, value))
+                    return false;
+
+                args.seqIndexes.push_back((uint32_t) value);
+            }
+            else if (std::strcmp(arg, "-threads") == 0) {
+                if (!parseIntArg(nextArg, 1, 1024, value))
+                    return false;
+
+                args.numThreads = (uint32_t) value;
+            }
+            else if (std::strcmp(arg, "-loops") == 0) {
+                if (!parseIntArg(nextArg, 0, UINT32_MAX, value))
+                    return false;
+
+                args.maxLoops = (uint32_t) value;
+            }
+            else if (std::strcmp(arg, "-max-seconds") == 0) {
+                if (!parseIntArg(nextArg, 1, UINT32_MAX / RENDER_SAMPLE_RATE / 2, value))
+                    return false;
+
+                args.maxSeconds = (uint32_t) value;
+            }
+            else if (std::strcmp(arg, "-reverb-mode") == 0) {
+                if (!parseIntArg(nextArg, 0, 9, value))
+                    return false;
+
+                args.reverbMode = (int32_t) value;
+            }
+            else if (std::strcmp(arg, "-reverb-depth") == 0) {
+                if (!parseIntArg(nextArg, INT16_MIN, INT16_MAX, value))
+                    return false;
+
+                args.reverbDepth = (int32_t) value;
+            }
+            else if (std::strcmp(arg, "-reverb-delay") == 0) {
+                if (!parseIntArg(nextArg, 0, INT16_MAX, value))
+                    return false;
+
+                args.reverbDelay = (int32_t) value;
+            }
+            else if (std::strcmp(arg, "-reverb-feedback") == 0) {
+                if (!parseIntArg(nextArg, INT16_MIN, INT16_MAX, value))
+                    return false;
+
+                args.reverbFeedback = (int32_t) value;
+            }
+            else {
+                return false;
+            }
+        }
+        else {
+            return false;
+        }
+    }
+
+    return (!args.lcdFilePaths.empty());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Compute a 64-bit FNV-1a hash of the given samples, in little endian byte order
+//------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t hashSamples(const std::vector<int16_t>& samples) noexcept {
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (const int16_t sample : samples) {
+        const uint16_t sampleBits = (uint16_t) sample;
+        hash = (hash ^ (sampleBits & 0xFFu)) * 0x100000001B3ull;
+        hash = (hash ^ (sampleBits >> 8)) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Quote a command line argument so that it is passed as-is through the system shell
+//------------------------------------------------------------------------------------------------------------------------------------------
+static std::string quoteShellArg(const char* const arg) noexcept {
+    #if _WIN32
+        return std::string("\"") + arg + "\"";
+    #else
+        std::string quoted = "'";
+
+        for (const char* pChar = arg; *pChar; ++pChar) {
+            if (*pChar == '\'') {
+                quoted += "'\\''";
+            } else {
+                quoted += *pChar;
+            }
+        }
+
+        quoted += "'";
+        return quoted;
+    #endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Makes the command line to render a single sequence in a child process, using the same options as this process
+//------------------------------------------------------------------------------------------------------------------------------------------
+static std::string makeChildCmdLine(const RenderToolArgs& args, const uint32_t seqIdx) noexcept {
+    std::string cmdLine = quoteShellArg(args.programPath);
+    cmdLine += " ";
+    cmdLine += quoteShellArg(args.moduleFilePath);
+    cmdLine += " ";
+    cmdLine += quoteShellArg(args.outputDirPath);
+
+    for (const char* const lcdFilePath : args.lcdFilePaths) {
+        cmdLine += " -lcd ";
+        cmdLine += quoteShellArg(lcdFilePath);
+    }
+
+    cmdLine += " -seq " + std::to_string(seqIdx);
+    cmdLine += " -loops " + std::to_string(args.maxLoops);
+    cmdLine += " -max-seconds " + std::to_string(args.maxSeconds);
+    cmdLine += " -reverb-mode " + std::to_string(args.reverbMode);
+    cmdLine += " -reverb-depth " + std::to_string(args.reverbDepth);
+    cmdLine += " -reverb-delay " + std::to_string(args.reverbDelay);
+    cmdLine += " -reverb-feedback " + std::to_string(args.reverbFeedback);
+
+    if (args.bPrintHash) {
+        cmdLine += " -hash";
+    }
+
+    if (!args.bWriteWav) {
+        cmdLine += " -no-wav";
+    }
+
+    // Capture errors as well as normal output
+    cmdLine += " 2>&1";
+
+    // Note: on Windows the shell strips the outermost quotes from the command, so the whole command needs to be wrapped in another set
+    #if _WIN32
+        cmdLine = "\"" + cmdLine + "\"";
+    #endif
+
+    return cmdLine;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Runs the given command and captures its output, returning 'true' if the command ran and exited successfully
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool runChildProcess(const std::string& cmdLine, std::string& outputOut) noexcept {
+    #if _WIN32
+        FILE* const pPipe = _popen(cmdLine.c_str(), "r");
+    #else
+        FILE* const pPipe = popen(cmdLine.c_str(), "r");
+    #endif
+
+    if (!pPipe)
+        return false;
+
+    char buffer[1024];
+
+    while (const size_t numBytesRead = std::fread(buffer, 1, sizeof(buffer), pPipe)) {
+        outputOut.append(buffer, numBytesRead);
+    }
+
+    #if _WIN32
+        const int exitCode = _pclose(pPipe);
+        return (exitCode == 0);
+    #else
+        const int status = pclose(pPipe);
+        return (WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+    #endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Render a single sequence in this process and save the result
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool renderSequenceInProcess(const RenderToolArgs& args, const Module& module, const uint32_t seqIdx) noexcept {
+    // Serialize the module to the .WMD format (the input might be .json) and read the .LCD files
+    std::vector<std::byte> wmdFileData;
+
+    try {
+        ByteVecOutputStream wmdOut;
+        module.writeToWmdFile(wmdOut);
+        wmdOut.padAlign(2048, std::byte(0));
+        wmdFileData = std::move(wmdOut.getBytes());
+    } catch (...) {
+        std::printf("SEQ %u: Failed to convert the module to .WMD format!\n", seqIdx);
+        return false;
+    }
+
+    std::vector<std::vector<std::byte>> lcdFilesData(args.lcdFilePaths.size());
+
+    for (size_t i = 0; i < lcdFilesData.size(); ++i) {
+        const FileData fileData = FileUtils::getContentsOfFile(args.lcdFilePaths[i]);
+
+        if (!fileData.bytes) {
+            std::printf("Failed to read the .LCD file '%s'! It may not exist.\n", args.lcdFilePaths[i]);
+            return false;
+        }
+
+        lcdFilesData[i].assign(fileData.bytes.get(), fileData.bytes.get() + fileData.size);
+    }
+
+    // Render the sequence
+    SeqRenderSettings settings = {};
+    settings.maxLoops = args.maxLoops;
+    settings.maxSamples = args.maxSeconds * RENDER_SAMPLE_RATE;
+    settings.maxTailSamples = RENDER_SAMPLE_RATE * 10;
+    settings.masterSfxVol = 127;
+    settings.masterMusVol = 127;
+    settings.reverbMode = args.reverbMode;
+    settings.reverbDepth = (int16_t) args.reverbDepth;
+    settings.reverbDelay = args.reverbDelay;
+    settings.reverbFeedback = args.reverbFeedback;
+
+    std::vector<int16_t> samples;
+    std::string errorMsg;
+
+    if (!renderSequence(wmdFileData, lcdFilesData, seqIdx, settings, samples, errorMsg)) {
+        std::printf("SEQ %u: %s\n", seqIdx, errorMsg.c_str());
+        return false;
+    }
+
+    // Note: a sequence with no output at all (no PSX tracks) can't be saved as a .wav file, so skip it
+    if (args.bWriteWav && (!samples.empty())) {
+        const std::string wavFilePath = std::string(args.outputDirPath) + "/SEQ_" + std::to_string(seqIdx) + ".wav";
+        const bool bWroteWav = WavUtils::writePcmSoundToWavFile(
+            wavFilePath.c_str(),
+            samples.data(),
+            (uint32_t) samples.size(),
+            2,
+            RENDER_SAMPLE_RATE,
+            0,
+            0
+        );
+
+        if (!bWroteWav) {
+            std::printf("SEQ %u: Failed to write the file '%s'!\n", seqIdx, wavFilePath.c_str());
+            return false;
+        }
+    }
+
+    if (args.bPrintHash) {
+        std::printf("SEQ %u: %u samples, hash %016llX\n", seqIdx, (uint32_t) samples.size() / 2, (unsigned long long) hashSamples(samples));
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Render the requested sequences in parallel (one child process per sequence) and save the results
+//------------------------------------------------------------------------------------------------------------------------------------------
+static bool renderSequences(const RenderToolArgs& args) noexcept {
+    // Read the module
+    Module module = {};
+    std::string errorMsg;
+
+    if ((!ModuleFileUtils::readWmdFile(args.moduleFilePath, module, errorMsg)) &&
+        (!ModuleFileUtils::readJsonFile(args.moduleFilePath, module, errorMsg))
+    ) {
+        std::printf("%s\n", errorMsg.c_str());
+        return false;
+    }
+
+    // Figure out what sequences to render
+    std::vector<uint32_t> seqIndexes = args.seqIndexes;
+
+    if (seqIndexes.empty()) {
+        for (uint32_t i = 0; i < (uint32_t) module.sequences.size(); ++i) {
+            seqIndexes.push_back(i);
+        }
+    }
+
+    // Make the output directory if required
+    if (args.bWriteWav) {
+        try {
+            std::filesystem::create_directories(args.outputDirPath);
+        } catch (...) {
+            std::printf("Failed to create the output directory '%s'!\n", args.outputDirPath);
+            return false;
+        }
+    }
+
+    // A single sequence can be rendered directly in this process
+    if (seqIndexes.size() == 1)
+        return renderSequenceInProcess(args, module, seqIndexes[0]);
+
+    // Otherwise render each sequence in a child process, with a pool of worker threads each waiting on one child at a time.
+    // Workers grab the next sequence to render from a shared counter.
+    std::vector<RenderJobResult> results(seqIndexes.size());
+    std::atomic<uint32_t> nextJobIdx = 0;
+
+    const auto workerFunc = [&]() noexcept {
+        for (uint32_t jobIdx = nextJobIdx++; jobIdx < (uint32_t) seqIndexes.size(); jobIdx = nextJobIdx++) {
+            RenderJobResult& result = results[jobIdx];
+            result.bSuccess = runChildProcess(makeChildCmdLine(args, seqIndexes[jobIdx]), result.output);
+        }
+    };
+
+    const uint32_t numThreads = std::min<uint32_t>(args.numThreads, std::max<uint32_t>((uint32_t) seqIndexes.size(), 1));
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        workers.emplace_back(workerFunc);
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Report the results in sequence order
+    bool bAllSucceeded = true;
+
+    for (size_t jobIdx = 0; jobIdx < seqIndexes.size(); ++jobIdx) {
+        const RenderJobResult& result = results[jobIdx];
+        std::printf("%s", result.output.c_str());
+
+        if (!result.bSuccess) {
+            if (result.output.empty()) {
+                std::printf("SEQ %u: The render process failed!\n", seqIndexes[jobIdx]);
+            }
+
+            bAllSucceeded = false;
+        }
+    }
+
+    return bAllSucceeded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Program entrypoint
+//------------------------------------------------------------------------------------------------------------------------------------------
+int main(int argc, const char* const argv[]) noexcept {
+    RenderToolArgs args = {};
+
+    if (!parseArgs(argc, argv, args)) {
+        printHelp();
+        return 1;
+    }
+
+    return (renderSequences(args)) ? 0 : 1;
+}
@@ -1,10 +1,15 @@
 #include "DisassemblyPrinter.h"
 #include "ExeFile.h"
 #include "FatalErrors.h"
+#include "FuncOutputCache.h"
+#include "ParallelJobs.h"
 #include "ProgElems.h"
 #include "PseudoCppPrinter.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -31,19 +36,62 @@
 //
 //  The program will attempt to output to whatever directory is the current working directory.
 //------------------------------------------------------------------------------------------------------------------------------------------
+// Caching:
+//
+//  Functions are analyzed and printed in parallel, and the output for each function is cached in '.cache' files alongside the output.
+//  On subsequent runs only the functions affected by changes to the program elements are re-analyzed. Options:
+//
+//      -nocache        Don't read or write the function output caches.
+//      -threads <N>    Use at most 'N' threads for analysis (default: one per CPU core).
+//------------------------------------------------------------------------------------------------------------------------------------------
 
 // Number of 32-bit words in the above versions of PSX DOOM and Final DOOM.
 // Used for very basic verification and also to tell whether we are dealing with DOOM or Final DOOM.
 static constexpr uint32_t DOOM_NUM_PROG_WORDS = 106496;
 static constexpr uint32_t FINAL_DOOM_NUM_PROG_WORDS = 107008;
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Runs the given printing function with a function output cache loaded from (and saved back to) the given file, if caching is enabled
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class PrintFunc>
+static void printWithCache(const ExeFile& exe, const char* const cacheFilePath, const bool bUseCache, const PrintFunc& printFunc) {
+    if (!bUseCache) {
+        printFunc(nullptr);
+        return;
+    }
+
+    FuncOutputCache cache;
+    cache.loadFromFile(cacheFilePath, exe);
+    printFunc(&cache);
+    std::printf("%s: %u functions reused, %u re-analyzed\n", cacheFilePath, cache.getNumHits(), cache.getNumMisses());
+
+    if (!cache.saveToFile(cacheFilePath, exe)) {
+        std::printf("Warning: failed to save the function output cache '%s'!\n", cacheFilePath);
+    }
+}
+
 int main(int argc, char* argv[]) noexcept {
     // *MUST* specify the path to PSXDOOM.EXE!
-    if (argc != 2) {
-        std::printf("Usage: DoomDisassemble <Path to the US/NTSC Playstation DOOM or Final Doom .EXE>\n");
+    if (argc < 2) {
+        std::printf("Usage: DoomDisassemble <Path to the US/NTSC Playstation DOOM or Final Doom .EXE> [-nocache] [-threads <N>]\n");
         return 1;
     }
 
+    // Parse any options following the .EXE path
+    bool bUseCache = true;
+
+    for (int argIdx = 2; argIdx < argc; ++argIdx) {
+        if (std::strcmp(argv[argIdx], "-nocache") == 0) {
+            bUseCache = false;
+        } else if ((std::strcmp(argv[argIdx], "-threads") == 0) && (argIdx + 1 < argc)) {
+            ParallelJobs::setMaxThreads((uint32_t) std::max(std::atoi(argv[argIdx + 1]), 0));
+            ++argIdx;
+        } else {
+            std::printf("Unknown or incomplete option '%s'!\n", argv[argIdx]);
+            return 1;
+        }
+    }
+
     // Disasemble the Japanese version of Destruction Derby if specified.
     // Using this to try and figure out some PSYQ functions, since it comes with debug symbols and was released around a similar time.
     const bool bIsDestructionDerby = (std::strstr(argv[1], "DEMOLISH.EXE") != 0);
@@ -82,8 +130,9 @@ int main(int argc, char* argv[]) noexcept {
     try {
         std::fstream fileOut;
         const char* const pFileName = (bIsDestructionDerby) ? "disasm_dd_disasm.txt" : "disasm_doom_disasm.txt";
+        const char* const pCacheFileName = (bIsDestructionDerby) ? "disasm_dd_disasm.cache" : "disasm_doom_disasm.cache";
         fileOut.open(pFileName, std::fstream::out);
-        DisassemblyPrinter::printExe(exe, fileOut);
+        printWithCache(exe, pCacheFileName, bUseCache, [&](FuncOutputCache* const pCache) { DisassemblyPrinter::printExe(exe, fileOut, pCache); });
     } catch (...) {
         FATAL_ERROR("Failed writing the disassembly to the output file!");
     }
@@ -91,8 +140,9 @@ int main(int argc, char* argv[]) noexcept {
     // Start printing the .cpp file
     try {
         std::fstream fileOut;
+        const char* const pCacheFileName = (bIsDestructionDerby) ? "disasm_dd_cpp.cache" : "disasm_doom_cpp.cache";
         fileOut.open("disasm_doom.cpp", std::fstream::out);
-        PseudoCppPrinter::printCpp(exe, fileOut);
+        printWithCache(exe, pCacheFileName, bUseCache, [&](FuncOutputCache* const pCache) { PseudoCppPrinter::printCpp(exe, fileOut, pCache); });
     } catch (...) {
         FATAL_ERROR("Failed writing the pseudo c++ code to the output file!");
     }
@@ -4,12 +4,11 @@
 #include "CpuInstruction.h"
 #include "ExeFile.h"
 #include "FatalErrors.h"
+#include "FuncOutputCache.h"
 #include "InstructionCommenter.h"
 #include "PrintUtils.h"
 #include <algorithm>
 
-static ConstInstructionEvaluator gConstInstructionEvaluator;
-
 static void prefixInstructionComment(const uint32_t lineCol, std::ostream& out) {
     // Figure out the start column for the comment
     constexpr uint32_t minCommentStartCol = 32u;
@@ -87,7 +86,14 @@ static void printProgElemName(const ProgElem& progElem, const char* const defaul
     }
 }
 
-static void printProgInstruction(const ExeFile& exe, const ProgElem* const pParentFunc, const uint32_t instAddr, const uint32_t instWord, std::ostream& out) {
+static void printProgInstruction(
+    const ExeFile& exe,
+    const ProgElem* const pParentFunc,
+    const ConstInstructionEvaluator* const pConstInstEvaluator,
+    const uint32_t instAddr,
+    const uint32_t instWord,
+    std::ostream& out
+) {
     // Log where we are in the stream (so we can tell how long the instruction was when printed)
     const int64_t instructionStartStreamPos = out.tellp();
 
@@ -116,11 +122,12 @@ static void printProgInstruction(const ExeFile& exe, const ProgElem* const pPare
 
     // Comment on the instruction if there is a parent function
     if (pParentFunc) {
+        assert(pConstInstEvaluator);
         InstructionCommenter::tryCommentInstruction(
             inst,
             instAddr,
             exe,
-            gConstInstructionEvaluator,
+            *pConstInstEvaluator,
             prefixInstructionComment,
             instructionPrintedLen,
             out
@@ -151,13 +158,16 @@ static void printFunction(const ExeFile& exe, const ProgElem& progElem, std::ost
         FATAL_ERROR("Invalid function program element! The ranges of addresses specified are NOT 32-bit aligned or the function size is zero!");
     }
 
-    // Do constant evaluation for the function
+    // Do constant evaluation for the function.
+    // Note: each function gets it's own evaluator, since functions may be printed in parallel.
+    ConstInstructionEvaluator constInstEvaluator;
+
     {
         ConstEvalRegState constEvalRegState;
         constEvalRegState.clear();
         constEvalRegState.setGpr(CpuGpr::GP, exe.assumedGpRegisterValue);
 
-        gConstInstructionEvaluator.constEvalFunction(exe, progElem, constEvalRegState);
+        constInstEvaluator.constEvalFunction(exe, progElem, constEvalRegState);
     }
 
     // Figure out the start and end word for the function in the .EXE
@@ -175,7 +185,7 @@ static void printFunction(const ExeFile& exe, const ProgElem& progElem, std::ost
         printProgWordReferences(exeWord, &progElem, out);
 
         // Print the instruction itself
-        printProgInstruction(exe, &progElem, instAddr, exeWord.value, out);
+        printProgInstruction(exe, &progElem, &constInstEvaluator, instAddr, exeWord.value, out);
         out.put('\n');
     }
 
@@ -527,10 +537,11 @@ static void validateProgElemRange(const ExeFile& exe, const ProgElem& progElem)
     }
 }
 
-static void printProgElem(const ExeFile& exe, const ProgElem& progElem, std::ostream& out) {
+static void printProgElem(const ExeFile& exe, const ProgElem& progElem, const std::string& funcOutput, std::ostream& out) {
     switch (progElem.type) {
+        // Functions are printed ahead of time
         case ProgElemType::FUNCTION:
-            printFunction(exe, progElem, out);
+            out << funcOutput;
             break;
 
         case ProgElemType::INT32:
@@ -618,7 +629,7 @@ static void printUncategorizedProgramRegion(
         // Lastly, if we have 4 bytes then try to decode a program instruction and then move onto a new line
         if (numBytesToPrint == 4) {
             out << "      ";
-            printProgInstruction(exe, nullptr, exe.baseAddress + curByteIdx, exeWord.value, out);
+            printProgInstruction(exe, nullptr, nullptr, exe.baseAddress + curByteIdx, exeWord.value, out);
         }
 
         out.put('\n');
@@ -628,12 +639,16 @@ static void printUncategorizedProgramRegion(
     out << "\n";
 }
 
-void DisassemblyPrinter::printExe(const ExeFile& exe, std::ostream& out) {
+void DisassemblyPrinter::printExe(const ExeFile& exe, std::ostream& out, FuncOutputCache* const pFuncOutputCache) {
     // Firstly make sure all program elements are valid and in range for the exe
     for (const ProgElem& progElem : exe.progElems) {
         validateProgElemRange(exe, progElem);
     }
 
+    // Disassemble all of the functions in parallel, since that is the most expensive part.
+    // The output for each function is then printed in order below, along with everything else.
+    const std::vector<std::string> funcOutputs = FuncOutputCache::printAllFunctions(exe, printFunction, pFuncOutputCache);
+
     // Continue until we have printed all program words
     uint32_t curProgByteIdx = 0;
     uint32_t curProgElemIdx = 0;
@@ -651,7 +666,7 @@ void DisassemblyPrinter::printExe(const ExeFile& exe, std::ostream& out) {
 
             if (progElem.containsByteAtAddr(curByteAddr) || progElem.endAddr <= curByteAddr) {
                 // Time to print this program element
-                printProgElem(exe, progElem, out);
+                printProgElem(exe, progElem, funcOutputs[curProgElemIdx], out);
                 ++curProgElemIdx;
 
                 // Move on in the program bytes and ensure we don't go backwards
@@ -692,7 +707,7 @@ void DisassemblyPrinter::printExe(const ExeFile& exe, std::ostream& out) {
 
         while (curProgElemIdx < numProgElems) {
             const ProgElem& progElem = exe.progElems[curProgElemIdx];
-            printProgElem(exe, progElem, out);
+            printProgElem(exe, progElem, funcOutputs[curProgElemIdx], out);
             ++curProgElemIdx;
         }
     }
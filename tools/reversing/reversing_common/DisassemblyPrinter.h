@@ -7,8 +7,11 @@
 // Module that prints the disassembly for a module.
 // Uses the program elements defined, which identify what particular regions of the .EXE mean.
 //------------------------------------------------------------------------------------------------------------------------------------------
+class FuncOutputCache;
 struct ExeFile;
 
 namespace DisassemblyPrinter {
-    void printExe(const ExeFile& exe, std::ostream& out);
+    // Print the disassembly for the given exe.
+    // Functions are disassembled in parallel, and the given cache (if any) is used to skip functions which have not changed.
+    void printExe(const ExeFile& exe, std::ostream& out, FuncOutputCache* const pFuncOutputCache = nullptr);
 }
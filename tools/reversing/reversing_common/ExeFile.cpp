@@ -2,9 +2,29 @@
 
 #include "CpuInstruction.h"
 #include "FatalErrors.h"
+#include "ParallelJobs.h"
 #include "PrintUtils.h"
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+
+thread_local std::vector<uint32_t>* ExeFile::tgpElemLookupLog = nullptr;
+
+// How many words each job processes when determining word references
+static constexpr uint32_t WORD_REFS_JOB_SIZE = 4096;
+
+// A reference from one program word to another, found when determining word references
+struct WordRef {
+    enum class Type : uint8_t {
+        DATA,
+        BRANCH,
+        JUMP
+    };
+
+    uint32_t    referencedWordIdx;      // Which word is referenced
+    uint32_t    referencingAddr;        // Address of the word making the reference
+    Type        type;
+};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // The header for a playstation EXE, exactly 2048 bytes in size.
@@ -213,6 +233,10 @@ void ExeFile::setJRInstHandlers(const JRInstHandler* const pHandlers, const uint
 }
 
 const ProgElem* ExeFile::findProgElemAtAddr(const uint32_t addr) const noexcept {
+    if (tgpElemLookupLog) {
+        tgpElemLookupLog->push_back(addr);
+    }
+
     auto iter = std::lower_bound(
         progElems.begin(),
         progElems.end(),
@@ -245,15 +269,24 @@ bool ExeFile::printNameOfElemAtAddr(const uint32_t addr, std::ostream& out) cons
     }
 }
 
-void ExeFile::determineWordReferences() noexcept {
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Find the references made by the specified range of program words to other words and append them to the given list
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void findWordReferences(
+    const ExeFile& exe,
+    const uint32_t startWordIdx,
+    const uint32_t endWordIdx,
+    std::vector<WordRef>& wordRefs
+) noexcept {
+    const uint32_t baseAddress = exe.baseAddress;
     const uint32_t exeStartAddr = baseAddress;
-    const uint32_t exeEndAddr = baseAddress + sizeInWords * 4;
+    const uint32_t exeEndAddr = baseAddress + exe.sizeInWords * 4;
 
-    for (uint32_t wordIdx = 0; wordIdx < sizeInWords; ++wordIdx) {
+    for (uint32_t wordIdx = startWordIdx; wordIdx < endWordIdx; ++wordIdx) {
         // Grab the program element at this word and the word itself
-        const uint32_t word = words[wordIdx].value;
+        const uint32_t word = exe.words[wordIdx].value;
         const uint32_t wordAddr = baseAddress + wordIdx * 4;
-        const ProgElem* const pProgElem = findProgElemAtAddr(wordAddr);
+        const ProgElem* const pProgElem = exe.findProgElemAtAddr(wordAddr);
 
         // See if the word can have a data or instruction reference
         bool bCanHaveDataRef = false;
@@ -291,9 +324,7 @@ void ExeFile::determineWordReferences() noexcept {
         if (bCanHaveDataRef) {
             if (word % 4 == 0) {
                 if (word >= exeStartAddr && word < exeEndAddr) {
-                    ExeWord& referencedWord = words[(word - baseAddress) / 4];
-                    referencedWord.bIsDataReferenced = true;
-                    referencedWord.addReferencingWord(thisWordAddr);
+                    wordRefs.push_back({ (word - baseAddress) / 4, thisWordAddr, WordRef::Type::DATA });
                 }
             }
         }
@@ -309,9 +340,7 @@ void ExeFile::determineWordReferences() noexcept {
                     const uint32_t branchTgtAddr = inst.getBranchInstTargetAddr(thisWordAddr);
 
                     if (branchTgtAddr >= exeStartAddr && branchTgtAddr < exeEndAddr) {
-                        ExeWord& referencedWord = words[(branchTgtAddr - baseAddress) / 4];
-                        referencedWord.bIsBranchTarget = true;
-                        referencedWord.addReferencingWord(thisWordAddr);
+                        wordRefs.push_back({ (branchTgtAddr - baseAddress) / 4, thisWordAddr, WordRef::Type::BRANCH });
                     }
                 }
                 else if (CpuOpcodeUtils::isFixedJumpOpcode(inst.opcode)) {
@@ -319,12 +348,41 @@ void ExeFile::determineWordReferences() noexcept {
                     const uint32_t jumpTgtAddr = inst.getFixedJumpInstTargetAddr(thisWordAddr);
 
                     if (jumpTgtAddr >= exeStartAddr && jumpTgtAddr < exeEndAddr) {
-                        ExeWord& referencedWord = words[(jumpTgtAddr - baseAddress) / 4];
-                        referencedWord.bIsJumpTarget = true;
-                        referencedWord.addReferencingWord(thisWordAddr);
+                        wordRefs.push_back({ (jumpTgtAddr - baseAddress) / 4, thisWordAddr, WordRef::Type::JUMP });
                     }
                 }
             }
         }
     }
 }
+
+void ExeFile::determineWordReferences() noexcept {
+    // Find the references made by each range of words in parallel.
+    // Each job only reads the program words and records the references it finds into its own list.
+    const uint32_t numJobs = (sizeInWords + WORD_REFS_JOB_SIZE - 1) / WORD_REFS_JOB_SIZE;
+    std::vector<std::vector<WordRef>> jobWordRefs(numJobs);
+
+    ParallelJobs::runJobs(
+        numJobs,
+        [&](const uint32_t jobIdx) noexcept {
+            const uint32_t startWordIdx = jobIdx * WORD_REFS_JOB_SIZE;
+            const uint32_t endWordIdx = std::min(startWordIdx + WORD_REFS_JOB_SIZE, sizeInWords);
+            findWordReferences(*this, startWordIdx, endWordIdx, jobWordRefs[jobIdx]);
+        }
+    );
+
+    // Mark all of the referenced words, in the same order as the references would be found serially
+    for (const std::vector<WordRef>& wordRefs : jobWordRefs) {
+        for (const WordRef& wordRef : wordRefs) {
+            ExeWord& referencedWord = words[wordRef.referencedWordIdx];
+
+            switch (wordRef.type) {
+                case WordRef::Type::DATA:   referencedWord.bIsDataReferenced = true;    break;
+                case WordRef::Type::BRANCH: referencedWord.bIsBranchTarget = true;      break;
+                case WordRef::Type::JUMP:   referencedWord.bIsJumpTarget = true;        break;
+            }
+
+            referencedWord.addReferencingWord(wordRef.referencingAddr);
+        }
+    }
+}
@@ -61,4 +61,8 @@ struct ExeFile {
     // Determine which words are referenced by jump instructions, data etc.
     // Useful in the disassembly to be able to quickly see branch targets and references to specific memory locations.
     void determineWordReferences() noexcept;
+
+    // If set then the address given to every 'findProgElemAtAddr' call on the current thread is appended to this list.
+    // Used to discover which program elements the printed output for a function depends on, so cached output can be invalidated.
+    static thread_local std::vector<uint32_t>* tgpElemLookupLog;
 };
@@ -0,0 +1,321 @@
+#include "FuncOutputCache.h"
+
+#include "ExeFile.h"
+#include "FileUtils.h"
+#include "ParallelJobs.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+// Identifies a cache file and it's format: must be changed whenever the format of the cache or the printed output changes
+static constexpr char CACHE_FILE_MAGIC[8] = { 'F', 'N', 'C', 'A', 'C', 'H', 'E', '1' };
+
+// Constants for the 64-bit FNV-1a hash
+static constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+static constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Add the given bytes to a 64-bit FNV-1a hash
+//------------------------------------------------------------------------------------------------------------------------------------------
+static void hashBytes(uint64_t& hash, const void* const pData, const size_t size) noexcept {
+    const uint8_t* const pBytes = (const uint8_t*) pData;
+
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= pBytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+template <class T>
+static void hashValue(uint64_t& hash, const T value) noexcept {
+    hashBytes(hash, &value, sizeof(T));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Helpers for reading and writing the cache file
+//------------------------------------------------------------------------------------------------------------------------------------------
+template <class T>
+static bool readValue(const std::string& data, size_t& offset, T& value) noexcept {
+    if (data.size() - offset < sizeof(T))
+        return false;
+
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+template <class T>
+static bool writeValue(std::FILE* const pFile, const T value) noexcept {
+    return (std::fwrite(&value, sizeof(T), 1, pFile) == 1);
+}
+
+FuncOutputCache::FuncOutputCache() noexcept
+    : mEntries()
+    , mNumHits(0)
+    , mNumMisses(0)
+{
+}
+
+FuncOutputCache::~FuncOutputCache() noexcept = default;
+
+void FuncOutputCache::loadFromFile(const char* const path, const ExeFile& exe) noexcept {
+    mEntries.clear();
+    std::string data;
+
+    if (!FileUtils::readFileAsString(path, data))
+        return;
+
+    // Verify the header: the cache is only usable if it is for the same format, exe base address and '$gp' register value
+    size_t offset = 0;
+    char magic[sizeof(CACHE_FILE_MAGIC)] = {};
+    uint32_t baseAddress = {};
+    uint32_t gpRegisterValue = {};
+    uint32_t numEntries = {};
+
+    const bool bValidHeader = (
+        readValue(data, offset, magic) &&
+        readValue(data, offset, baseAddress) &&
+        readValue(data, offset, gpRegisterValue) &&
+        readValue(data, offset, numEntries) &&
+        (std::memcmp(magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) == 0) &&
+        (baseAddress == exe.baseAddress) &&
+        (gpRegisterValue == exe.assumedGpRegisterValue)
+    );
+
+    if (!bValidHeader)
+        return;
+
+    // Read all of the entries, discarding everything if the file is truncated or otherwise corrupt
+    for (uint32_t entryIdx = 0; entryIdx < numEntries; ++entryIdx) {
+        uint64_t funcKey = {};
+        uint32_t numElemDependencies = {};
+
+        if ((!readValue(data, offset, funcKey)) || (!readValue(data, offset, numElemDependencies)))
+            break;
+
+        Entry entry;
+        bool bReadOk = true;
+
+        for (uint32_t depIdx = 0; (depIdx < numElemDependencies) && bReadOk; ++depIdx) {
+            ElemDependency& dependency = entry.elemDependencies.emplace_back();
+            bReadOk = (readValue(data, offset, dependency.addr) && readValue(data, offset, dependency.elemHash));
+        }
+
+        uint32_t outputSize = {};
+        bReadOk = (bReadOk && readValue(data, offset, outputSize) && (data.size() - offset >= outputSize));
+
+        if (!bReadOk) {
+            std::printf("Warning: the function output cache '%s' is corrupt and will be ignored!\n", path);
+            mEntries.clear();
+            return;
+        }
+
+        entry.output.assign(data, offset, outputSize);
+        offset += outputSize;
+        mEntries[funcKey] = std::move(entry);
+    }
+}
+
+bool FuncOutputCache::saveToFile(const char* const path, const ExeFile& exe) const noexcept {
+    std::FILE* const pFile = std::fopen(path, "wb");
+
+    if (!pFile)
+        return false;
+
+    bool bWriteOk = (
+        (std::fwrite(CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC), 1, pFile) == 1) &&
+        writeValue(pFile, exe.baseAddress) &&
+        writeValue(pFile, exe.assumedGpRegisterValue) &&
+        writeValue(pFile, (uint32_t) mEntries.size())
+    );
+
+    for (auto iter = mEntries.begin(); (iter != mEntries.end()) && bWriteOk; ++iter) {
+        const Entry& entry = iter->second;
+        bWriteOk = (writeValue(pFile, iter->first) && writeValue(pFile, (uint32_t) entry.elemDependencies.size()));
+
+        for (const ElemDependency& dependency : entry.elemDependencies) {
+            bWriteOk = (bWriteOk && writeValue(pFile, dependency.addr) && writeValue(pFile, dependency.elemHash));
+        }
+
+        bWriteOk = (
+            bWriteOk &&
+            writeValue(pFile, (uint32_t) entry.output.size()) &&
+            (entry.output.empty() || (std::fwrite(entry.output.data(), entry.output.size(), 1, pFile) == 1))
+        );
+    }
+
+    bWriteOk = ((std::fclose(pFile) == 0) && bWriteOk);
+    return bWriteOk;
+}
+
+std::vector<std::string> FuncOutputCache::printAllFunctions(const ExeFile& exe, const PrintFuncFunc printFunc, FuncOutputCache* const pCache) {
+    // Print each function as a separate job, saving the output (and the cache key and dependencies) by program element index
+    const uint32_t numElems = (uint32_t) exe.progElems.size();
+
+    std::vector<std::string> outputs(numElems);
+    std::vector<uint64_t> funcKeys(numElems);
+    std::vector<uint8_t> bCacheHits(numElems);
+    std::vector<std::vector<ElemDependency>> elemDependencies(numElems);
+
+    ParallelJobs::runJobs(
+        numElems,
+        [&](const uint32_t elemIdx) {
+            const ProgElem& progElem = exe.progElems[elemIdx];
+
+            if (progElem.type != ProgElemType::FUNCTION)
+                return;
+
+            // Use the cached output for the function if still valid
+            if (pCache) {
+                funcKeys[elemIdx] = getFuncKey(exe, progElem);
+                const Entry* const pEntry = pCache->findValidEntry(exe, funcKeys[elemIdx]);
+
+                if (pEntry) {
+                    outputs[elemIdx] = pEntry->output;
+                    bCacheHits[elemIdx] = true;
+                    return;
+                }
+            }
+
+            // Otherwise print the function, making a note of all the program elements looked up if caching
+            std::vector<uint32_t> elemLookupAddrs;
+            std::ostringstream out;
+            ExeFile::tgpElemLookupLog = (pCache) ? &elemLookupAddrs : nullptr;
+
+            try {
+                printFunc(exe, progElem, out);
+            } catch (...) {
+                ExeFile::tgpElemLookupLog = nullptr;
+                throw;
+            }
+
+            ExeFile::tgpElemLookupLog = nullptr;
+            outputs[elemIdx] = out.str();
+
+            if (pCache) {
+                std::sort(elemLookupAddrs.begin(), elemLookupAddrs.end());
+                elemLookupAddrs.erase(std::unique(elemLookupAddrs.begin(), elemLookupAddrs.end()), elemLookupAddrs.end());
+
+                for (const uint32_t addr : elemLookupAddrs) {
+                    elemDependencies[elemIdx].push_back({ addr, getElemHash(exe, exe.findProgElemAtAddr(addr)) });
+                }
+            }
+        }
+    );
+
+    // Rebuild the cache so it contains only the output for the functions in this exe
+    if (pCache) {
+        std::unordered_map<uint64_t, Entry> newEntries;
+        pCache->mNumHits = 0;
+        pCache->mNumMisses = 0;
+
+        for (uint32_t elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            if (exe.progElems[elemIdx].type != ProgElemType::FUNCTION)
+                continue;
+
+            const uint64_t funcKey = funcKeys[elemIdx];
+
+            if (bCacheHits[elemIdx]) {
+                newEntries[funcKey] = std::move(pCache->mEntries[funcKey]);
+                pCache->mNumHits++;
+            } else {
+                Entry& entry = newEntries[funcKey];
+                entry.elemDependencies = std::move(elemDependencies[elemIdx]);
+                entry.output = outputs[elemIdx];
+                pCache->mNumMisses++;
+            }
+        }
+
+        pCache->mEntries = std::move(newEntries);
+    }
+
+    return outputs;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Compute the key used to lookup the cached output for a function.
+// Covers everything about the function itself that can affect the output, but not the other program elements that it references.
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t FuncOutputCache::getFuncKey(const ExeFile& exe, const ProgElem& progElem) noexcept {
+    uint64_t hash = getElemHash(exe, &progElem);
+
+    // Hash the words of the function and the references to them
+    const uint32_t exeEndAddr = exe.baseAddress + exe.sizeInWords * 4;
+    const uint32_t startAddr = std::clamp(progElem.startAddr, exe.baseAddress, exeEndAddr);
+    const uint32_t endAddr = std::clamp(progElem.endAddr, startAddr, exeEndAddr);
+
+    for (uint32_t wordIdx = (startAddr - exe.baseAddress) / 4; wordIdx < (endAddr - exe.baseAddress) / 4; ++wordIdx) {
+        const ExeWord& word = exe.words[wordIdx];
+        hashValue(hash, word.value);
+        hashValue(hash, word.bIsJumpTarget);
+        hashValue(hash, word.bIsBranchTarget);
+        hashValue(hash, word.bIsDataReferenced);
+        hashValue(hash, word.startReferencingAddr);
+        hashValue(hash, word.endReferencingAddr);
+    }
+
+    // Hash the handlers for any 'jr' instructions in the function
+    for (const JRInstHandler& handler : exe.jrInstHandlers) {
+        if ((handler.instAddress >= progElem.startAddr) && (handler.instAddress < progElem.endAddr)) {
+            hashValue(hash, handler.instAddress);
+            hashValue(hash, handler.type);
+            hashValue(hash, handler.jumpTableAddr);
+        }
+    }
+
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Compute a hash of the given program element definition, which may be null.
+// The hash for arrays of pointers (jump tables) includes the contents of the array, since switch statements are printed using them.
+//------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t FuncOutputCache::getElemHash(const ExeFile& exe, const ProgElem* const pElem) noexcept {
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    if (!pElem) {
+        hashValue(hash, (uint8_t) 0);
+        return hash;
+    }
+
+    const char* const name = (pElem->name) ? pElem->name : "";
+    hashValue(hash, (uint8_t) 1);
+    hashValue(hash, pElem->startAddr);
+    hashValue(hash, pElem->endAddr);
+    hashBytes(hash, name, std::strlen(name) + 1);
+    hashValue(hash, pElem->type);
+    hashValue(hash, pElem->arrayElemType);
+    hashValue(hash, pElem->arrayElemsPerLine);
+
+    if ((pElem->type == ProgElemType::ARRAY) && (pElem->arrayElemType == ProgElemType::PTR32)) {
+        const uint32_t exeEndAddr = exe.baseAddress + exe.sizeInWords * 4;
+        const uint32_t startAddr = std::clamp(pElem->startAddr, exe.baseAddress, exeEndAddr);
+        const uint32_t endAddr = std::clamp(pElem->endAddr, startAddr, exeEndAddr);
+
+        for (uint32_t wordIdx = (startAddr - exe.baseAddress) / 4; wordIdx < (endAddr - exe.baseAddress) / 4; ++wordIdx) {
+            hashValue(hash, exe.words[wordIdx].value);
+        }
+    }
+
+    return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Find the cache entry for the function with the given key, provided none of the program elements it depends on have changed
+//------------------------------------------------------------------------------------------------------------------------------------------
+const FuncOutputCache::Entry* FuncOutputCache::findValidEntry(const ExeFile& exe, const uint64_t funcKey) const noexcept {
+    const auto iter = mEntries.find(funcKey);
+
+    if (iter == mEntries.end())
+        return nullptr;
+
+    const Entry& entry = iter->second;
+
+    for (const ElemDependency& dependency : entry.elemDependencies) {
+        if (getElemHash(exe, exe.findProgElemAtAddr(dependency.addr)) != dependency.elemHash)
+            return nullptr;
+    }
+
+    return &entry;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ExeFile;
+struct ProgElem;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Module that prints the output for every function in an exe in parallel, optionally with an on-disk cache of the output for each function.
+//
+// The cache lets iterative reverse engineering sessions (where only a few program elements are changed between runs) skip re-analysing
+// and re-printing the functions that were not affected. The output for a function is reused only if all of the following are unchanged:
+//
+//  (1) The function's program element definition.
+//  (2) The words of the function, including which of them are referenced and from where.
+//  (3) The 'jr' instruction handlers for the function.
+//  (4) Every program element that was looked up while printing the function, such as call targets and globals referenced in comments.
+//      For jump tables this also includes the words of the table.
+//
+// The cache is discarded entirely if the exe base address, '$gp' register value or the cache format changes.
+//------------------------------------------------------------------------------------------------------------------------------------------
+class FuncOutputCache {
+public:
+    // A function which prints the output for the given function program element
+    typedef void (*PrintFuncFunc)(const ExeFile& exe, const ProgElem& progElem, std::ostream& out);
+
+    FuncOutputCache() noexcept;
+    ~FuncOutputCache() noexcept;
+
+    // Load or save the cache from/to the given file.
+    // Loading fails silently (leaving the cache empty) if the file does not exist, is invalid, or is for a different exe.
+    void loadFromFile(const char* const path, const ExeFile& exe) noexcept;
+    bool saveToFile(const char* const path, const ExeFile& exe) const noexcept;
+
+    // Print the output for every function in the exe in parallel, returning the output for each program element.
+    // The output for elements which are not functions will be empty.
+    // If a cache is given then cached output is used where possible, and the cache is updated to contain only the output for this exe.
+    static std::vector<std::string> printAllFunctions(const ExeFile& exe, const PrintFuncFunc printFunc, FuncOutputCache* const pCache);
+
+    // Stats for the last call to 'printAllFunctions' with this cache
+    uint32_t getNumHits() const noexcept { return mNumHits; }
+    uint32_t getNumMisses() const noexcept { return mNumMisses; }
+
+private:
+    // A program element which a function's output depends on: the address it was looked up at and a hash of the element found
+    struct ElemDependency {
+        uint32_t    addr;
+        uint64_t    elemHash;
+    };
+
+    // The cached output for one function
+    struct Entry {
+        std::vector<ElemDependency>     elemDependencies;
+        std::string                     output;
+    };
+
+    static uint64_t getFuncKey(const ExeFile& exe, const ProgElem& progElem) noexcept;
+    static uint64_t getElemHash(const ExeFile& exe, const ProgElem* const pElem) noexcept;
+    const Entry* findValidEntry(const ExeFile& exe, const uint64_t funcKey) const noexcept;
+
+    std::unordered_map<uint64_t, Entry>     mEntries;       // Cached output for each function, keyed by function key
+    uint32_t                                mNumHits;
+    uint32_t                                mNumMisses;
+};
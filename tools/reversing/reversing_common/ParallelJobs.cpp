@@ -0,0 +1,59 @@
+#include "ParallelJobs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static uint32_t gMaxThreads = 0;
+
+void ParallelJobs::setMaxThreads(const uint32_t maxThreads) noexcept {
+    gMaxThreads = maxThreads;
+}
+
+uint32_t ParallelJobs::getNumThreads() noexcept {
+    const uint32_t numCores = std::max(std::thread::hardware_concurrency(), 1u);
+    return (gMaxThreads > 0) ? std::min(gMaxThreads, numCores) : numCores;
+}
+
+void ParallelJobs::runJobs(const uint32_t numJobs, const JobFunc& jobFunc) {
+    // Each thread keeps grabbing the next job until there are none left.
+    // Remember the first exception thrown by any job, so it can be rethrown on this thread afterwards.
+    std::atomic<uint32_t> nextJobIdx = 0;
+    std::exception_ptr pFirstException;
+    std::mutex exceptionMutex;
+
+    const auto doJobs = [&]() noexcept {
+        for (uint32_t jobIdx = nextJobIdx++; jobIdx < numJobs; jobIdx = nextJobIdx++) {
+            try {
+                jobFunc(jobIdx);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+
+                if (!pFirstException) {
+                    pFirstException = std::current_exception();
+                }
+            }
+        }
+    };
+
+    // Run the jobs on this thread and as many helper threads as are useful
+    const uint32_t numThreads = std::min(getNumThreads(), numJobs);
+    std::vector<std::thread> helperThreads;
+
+    for (uint32_t i = 1; i < numThreads; ++i) {
+        helperThreads.emplace_back(doJobs);
+    }
+
+    doJobs();
+
+    for (std::thread& thread : helperThreads) {
+        thread.join();
+    }
+
+    if (pFirstException) {
+        std::rethrow_exception(pFirstException);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Module that runs a batch of independent jobs across all of the CPU cores available.
+// Jobs are handed out in index order but may complete in any order, so callers must store results by job index if order matters.
+//------------------------------------------------------------------------------------------------------------------------------------------
+namespace ParallelJobs {
+    // A job to run: receives the index of the job to do
+    typedef std::function<void (const uint32_t jobIdx)> JobFunc;
+
+    // Limit the number of threads used to run jobs: '0' means use one thread per CPU core (the default)
+    void setMaxThreads(const uint32_t maxThreads) noexcept;
+
+    // Get the number of threads that jobs will be run on
+    uint32_t getNumThreads() noexcept;
+
+    // Run the specified number of jobs and wait for them all to finish.
+    // If any job throws then the first exception thrown is rethrown on the calling thread once all jobs are done.
+    void runJobs(const uint32_t numJobs, const JobFunc& jobFunc);
+}
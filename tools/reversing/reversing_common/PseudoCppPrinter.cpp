@@ -4,14 +4,14 @@
 #include "CpuInstruction.h"
 #include "ExeFile.h"
 #include "FatalErrors.h"
+#include "FuncOutputCache.h"
 #include "InstructionCommenter.h"
 #include "PrintUtils.h"
 #include "PseudoCppPrinter_InstPrint.h"
 #include <algorithm>
+#include <cstring>
 #include <set>
 
-static ConstInstructionEvaluator gConstInstructionEvaluator;
-
 using namespace PseudoCppPrinter;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -243,6 +243,7 @@ static const ProgElem& getJumpTableProgElem(const ExeFile& exe, const uint32_t a
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void printNonBranchOrJumpInstruction(
     const ExeFile& exe,
+    const ConstInstructionEvaluator& constInstEvaluator,
     const CpuInstruction inst,
     const uint32_t instAddr,
     const uint32_t indent,
@@ -407,7 +408,7 @@ static void printNonBranchOrJumpInstruction(
         inst,
         instAddr,
         exe,
-        gConstInstructionEvaluator,
+        constInstEvaluator,
         prefixInstructionComment,
         instructionPrintedLen,
         out
@@ -422,6 +423,7 @@ static void printNonBranchOrJumpInstruction(
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void printBranchOrJumpInstruction(
     const ExeFile& exe,
+    const ConstInstructionEvaluator& constInstEvaluator,
     const CpuInstruction branchInst,
     const uint32_t branchInstAddr,
     const CpuInstruction nextInst,
@@ -488,7 +490,7 @@ static void printBranchOrJumpInstruction(
     }
 
     // Print the instruction that follows the branch
-    printNonBranchOrJumpInstruction(exe, nextInst, nextInstAddr, instIndent, out);
+    printNonBranchOrJumpInstruction(exe, constInstEvaluator, nextInst, nextInstAddr, instIndent, out);
 
     // Handle the branch or jump itself
     indentByNumChars(instIndent, out);
@@ -616,13 +618,16 @@ static void printBranchOrJumpInstruction(
 // Print the C++ code for the specified function
 //------------------------------------------------------------------------------------------------------------------------------------------
 static void printFunction(const ExeFile& exe, const ProgElem& progElem, std::ostream& out) {
-    // Do constant evaluation for the function so we can comment some lines
+    // Do constant evaluation for the function so we can comment some lines.
+    // Note: each function gets it's own evaluator, since functions may be printed in parallel.
+    ConstInstructionEvaluator constInstEvaluator;
+
     {
         ConstEvalRegState constEvalRegState;
         constEvalRegState.clear();
         constEvalRegState.setGpr(CpuGpr::GP, exe.assumedGpRegisterValue);
 
-        gConstInstructionEvaluator.constEvalFunction(exe, progElem, constEvalRegState);
+        constInstEvaluator.constEvalFunction(exe, progElem, constEvalRegState);
     }
 
     // Start of the function
@@ -659,11 +664,11 @@ static void printFunction(const ExeFile& exe, const ProgElem& progElem, std::ost
         // See if we are dealing with a branch or jump or just an ordinary instruction.
         // For branches/jumps we need to reorder instructions to account for the branch delay slot:
         if (CpuOpcodeUtils::isBranchOrJumpOpcode(thisInst.opcode)) {
-            printBranchOrJumpInstruction(exe, thisInst, thisInstAddr, nextInst, nextInstAddr, 4, out);
+            printBranchOrJumpInstruction(exe, constInstEvaluator, thisInst, thisInstAddr, nextInst, nextInstAddr, 4, out);
             wordIdx += 2;
         } else {
             // Simple case, print a single instruction and move along by 1 instruction
-            printNonBranchOrJumpInstruction(exe, thisInst, thisInstAddr, 4, out);
+            printNonBranchOrJumpInstruction(exe, constInstEvaluator, thisInst, thisInstAddr, 4, out);
             wordIdx += 1;
         }
     }
@@ -705,7 +710,7 @@ static void validateFuncElemRange(const ExeFile& exe, const ProgElem& progElem)
     }
 }
 
-void PseudoCppPrinter::printCpp(const ExeFile& exe, std::ostream& out) {
+void PseudoCppPrinter::printCpp(const ExeFile& exe, std::ostream& out, FuncOutputCache* const pFuncOutputCache) {
     // The app must define this header with all of the required macros
     out << "#include \"PsxVm.h\"\n";
     out << "\n";
@@ -720,11 +725,11 @@ void PseudoCppPrinter::printCpp(const ExeFile& exe, std::ostream& out) {
 
     out << "\n";
 
-    // Print all of the functions
-    for (const ProgElem& progElem : exe.progElems) {        
-        if (progElem.type == ProgElemType::FUNCTION) {
-            printFunction(exe, progElem, out);
-        }
+    // Print all of the functions in parallel and then output them in order
+    const std::vector<std::string> funcOutputs = FuncOutputCache::printAllFunctions(exe, printFunction, pFuncOutputCache);
+
+    for (const std::string& funcOutput : funcOutputs) {
+        out << funcOutput;
     }
 }
 
@@ -11,11 +11,13 @@
 // output generated by the disassembler. These macros are to be defined by the host C++ program to perform the equivalent
 // operations natively in the host environment.
 //------------------------------------------------------------------------------------------------------------------------------------------
+class FuncOutputCache;
 struct ExeFile;
 
 namespace PseudoCppPrinter {
-    // Print out the pseudo C++ code for the given exe
-    void printCpp(const ExeFile& exe, std::ostream& out);
+    // Print out the pseudo C++ code for the given exe.
+    // Functions are printed in parallel, and the given cache (if any) is used to skip functions which have not changed.
+    void printCpp(const ExeFile& exe, std::ostream& out, FuncOutputCache* const pFuncOutputCache = nullptr);
 
     // Printing C++ literals of various integer types
     void printHexCppInt16Literal(const int16_t valI16, bool bZeroPad, std::ostream& out);
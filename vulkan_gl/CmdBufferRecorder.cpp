@@ -8,6 +8,7 @@
 #include "LogicalDevice.h"
 #include "Pipeline.h"
 #include "PipelineLayout.h"
+#include "QueryPool.h"
 #include "RenderPass.h"
 #include "VkFuncs.h"
 
@@ -394,4 +395,30 @@ void CmdBufferRecorder::dispatchWorkgroups(
     mVkFuncs.vkCmdDispatch(mVkCommandBuffer, numWorkgroupsX, numWorkgroupsY, numWorkgroupsZ);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Recorded command: reset a range of queries in a query pool so they can be written to again.
+// Must be done outside of a renderpass.
+//------------------------------------------------------------------------------------------------------------------------------------------
+void CmdBufferRecorder::resetQueryPool(const QueryPool& queryPool, const uint32_t firstQuery, const uint32_t numQueries) noexcept {
+    ASSERT(isRecording());
+    ASSERT(queryPool.isValid());
+    ASSERT(firstQuery + numQueries <= queryPool.getNumQueries());
+    mVkFuncs.vkCmdResetQueryPool(mVkCommandBuffer, queryPool.getVkQueryPool(), firstQuery, numQueries);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Recorded command: write the device timestamp to the specified query once all previous commands reach the given pipeline stage
+//------------------------------------------------------------------------------------------------------------------------------------------
+void CmdBufferRecorder::writeTimestamp(
+    const QueryPool& queryPool,
+    const VkPipelineStageFlagBits pipelineStage,
+    const uint32_t queryIdx
+) noexcept {
+    ASSERT(isRecording());
+    ASSERT(queryPool.isValid());
+    ASSERT(queryPool.getQueryType() == VK_QUERY_TYPE_TIMESTAMP);
+    ASSERT(queryIdx < queryPool.getNumQueries());
+    mVkFuncs.vkCmdWriteTimestamp(mVkCommandBuffer, pipelineStage, queryPool.getVkQueryPool(), queryIdx);
+}
+
 END_NAMESPACE(vgl)
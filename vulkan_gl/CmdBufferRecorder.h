@@ -12,6 +12,7 @@ class DescriptorSet;
 class Framebuffer;
 class Pipeline;
 class PipelineLayout;
+class QueryPool;
 class RenderPass;
 struct VkFuncs;
 
@@ -136,6 +137,9 @@ public:
         const uint32_t numWorkgroupsZ = 1
     ) noexcept;
 
+    void resetQueryPool(const QueryPool& queryPool, const uint32_t firstQuery, const uint32_t numQueries) noexcept;
+    void writeTimestamp(const QueryPool& queryPool, const VkPipelineStageFlagBits pipelineStage, const uint32_t queryIdx) noexcept;
+
 private:
     // Copy and move are disallowed
     CmdBufferRecorder(const CmdBufferRecorder& other) = delete;
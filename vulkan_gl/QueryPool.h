@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <vulkan/vulkan.h>
+
+BEGIN_NAMESPACE(vgl)
+
+class LogicalDevice;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+// Represents a pool of Vulkan queries, such as timestamp queries.
+// Queries must be reset by a command buffer before they are written to, and results can be read back by the host once the commands
+// writing them have executed. Reading results never blocks; if some of the requested queries are not yet available then the read fails.
+//------------------------------------------------------------------------------------------------------------------------------------------
+class QueryPool {
+public:
+    QueryPool() noexcept;
+    QueryPool(QueryPool&& other) noexcept;
+    ~QueryPool() noexcept;
+
+    bool init(LogicalDevice& device, const VkQueryType queryType, const uint32_t numQueries) noexcept;
+    void destroy(const bool bForceIfInvalid = false) noexcept;
+    bool getResults(const uint32_t firstQuery, const uint32_t numQueries, uint64_t* const pResults) const noexcept;
+
+    inline bool isValid() const noexcept { return mbIsValid; }
+    inline LogicalDevice* getDevice() const noexcept { return mpDevice; }
+    inline VkQueryType getQueryType() const noexcept { return mQueryType; }
+    inline uint32_t getNumQueries() const noexcept { return mNumQueries; }
+    inline VkQueryPool getVkQueryPool() const noexcept { return mVkQueryPool; }
+
+private:
+    // Copy and move assign disallowed
+    QueryPool(const QueryPool& other) = delete;
+    QueryPool& operator = (const QueryPool& other) = delete;
+    QueryPool& operator = (QueryPool&& other) = delete;
+
+    bool            mbIsValid;
+    LogicalDevice*  mpDevice;
+    VkQueryType     mQueryType;
+    uint32_t        mNumQueries;
+    VkQueryPool     mVkQueryPool;
+};
+
+END_NAMESPACE(vgl)
@@ -30,6 +30,7 @@ files_to_compile = [
     [ "ui_4bpp.frag",       "compiled/SPIRV_ui_4bpp_frag.bin.h",        "frag", "gSPIRV_ui_4bpp_frag"       ],
     [ "ui_8bpp.frag",       "compiled/SPIRV_ui_8bpp_frag.bin.h",        "frag", "gSPIRV_ui_8bpp_frag"       ],
     [ "world.frag",         "compiled/SPIRV_world_frag.bin.h",          "frag", "gSPIRV_world_frag"         ],
+    [ "world_atlas.frag",   "compiled/SPIRV_world_atlas_frag.bin.h",    "frag", "gSPIRV_world_atlas_frag"   ],
     [ "world.vert",         "compiled/SPIRV_world_vert.bin.h",          "vert", "gSPIRV_world_vert"         ],
 ]
 